@@ -8,6 +8,8 @@
 
 #include "FST.h"
 #include "KeyCache.h"
+#include "config/CemuConfig.h"
+#include "util/ThreadPool/ThreadPool.h"
 
 #include "boost/range/adaptor/reversed.hpp"
 
@@ -542,6 +544,8 @@ FSTVolume* FSTVolume::OpenFST(FSTDataSource* dataSource, uint64 fstOffset, uint3
 	fstVolume->m_offsetFactor = fstHeader->offsetFactor;
 	fstVolume->m_sectorSize = DISC_SECTOR_SIZE;
 	fstVolume->m_partitionTitlekey = *partitionTitleKey;
+	fstVolume->m_partitionDecryptionKey.Expand(partitionTitleKey->b);
+	fstVolume->m_cacheCapacity = (size_t)GetConfig().fst_cache_size.GetValue() * 1024 * 1024;
 	fstVolume->m_hashIsDisabled = fstHeader->hashIsDisabled != 0;
 	fstVolume->m_cluster = std::move(clusterTable);
 	fstVolume->m_entries = std::move(fstEntries);
@@ -867,57 +871,154 @@ struct FSTHashedBlock
 
 static_assert(sizeof(FSTHashedBlock) == BLOCK_SIZE);
 
-struct FSTCachedRawBlock
+constexpr uint32 FST_READ_AHEAD_BLOCKS = 8; // number of hashed blocks that are prefetched ahead of the current read position
+constexpr uint32 FST_READ_AHEAD_MIN_SEQUENTIAL = 2; // number of consecutive block accesses before read-ahead kicks in
+
+struct FSTCachedBlock
+{
+	uint64 cacheBlockId;
+	uint32 cacheSize; // memory used by this cache entry
+	bool isHashed;
+	FSTCachedBlock* lruPrev{};
+	FSTCachedBlock* lruNext{};
+};
+
+struct FSTCachedRawBlock : FSTCachedBlock
 {
 	FSTRawBlock blockData;
 	NCrypto::AesIv ivForNextBlock;
-	uint64 lastAccess;
 };
 
-struct FSTCachedHashedBlock 
+struct FSTCachedHashedBlock : FSTCachedBlock
 {
 	FSTHashedBlock blockData;
-	uint64 lastAccess;
 };
 
-// Checks cache fill state and if necessary drops least recently accessed block from the cache. Optionally allows to recycle the released cache entry to cut down cost of memory allocation and clearing
-void FSTVolume::TrimCacheIfRequired(FSTCachedRawBlock** droppedRawBlock, FSTCachedHashedBlock** droppedHashedBlock)
+static bool FSTDecryptAndVerifyHashedBlock(FSTHashedBlock& block, uint32 blockIndex, const AES128DecryptionKey& key);
+
+// shared between the volume and the queued worker task. Whichever side claims the job first decrypts the block
+// the volume claims jobs that haven't started yet and runs them itself, so it never waits on a task that sits in a worker queue
+struct FSTReadAheadJob
 {
-	// calculate size used by cache
-	size_t cacheSize = 0;
-	for (auto& itr : m_cacheDecryptedRawBlocks)
-		cacheSize += itr.second->blockData.rawData.size();
-	for (auto& itr : m_cacheDecryptedHashedBlocks)
-		cacheSize += sizeof(FSTCachedHashedBlock) + sizeof(FSTHashedBlock);
-	// only trim if cache is full (larger than 2MB)
-	if (cacheSize < 2*1024*1024) // 2MB
-		return;
-	// scan both cache lists to find least recently accessed block to drop
-	auto dropRawItr = std::min_element(m_cacheDecryptedRawBlocks.begin(), m_cacheDecryptedRawBlocks.end(), [](const auto& a, const auto& b) -> bool
-										{ return a.second->lastAccess < b.second->lastAccess; });
-	auto dropHashedItr = std::min_element(m_cacheDecryptedHashedBlocks.begin(), m_cacheDecryptedHashedBlocks.end(), [](const auto& a, const auto& b) -> bool
-										{ return a.second->lastAccess < b.second->lastAccess; });
-	uint64 lastAccess = std::numeric_limits<uint64>::max();
-	if(dropRawItr != m_cacheDecryptedRawBlocks.end())
-		lastAccess = dropRawItr->second->lastAccess;
-	if(dropHashedItr != m_cacheDecryptedHashedBlocks.end())
-		lastAccess = std::min<uint64>(lastAccess, dropHashedItr->second->lastAccess);
-	if(dropRawItr != m_cacheDecryptedRawBlocks.end() && dropRawItr->second->lastAccess == lastAccess)
-	{
-		if (droppedRawBlock)
-			*droppedRawBlock = dropRawItr->second;
+	enum class STATE : uint8
+	{
+		QUEUED,
+		RUNNING,
+		DONE,
+	};
+
+	uint32 clusterIndex;
+	uint32 blockIndex;
+	FSTCachedHashedBlock* block;
+	const AES128DecryptionKey* key;
+	std::atomic<STATE> state{STATE::QUEUED};
+	bool isValid{false};
+
+	bool TryClaim()
+	{
+		STATE expected = STATE::QUEUED;
+		return state.compare_exchange_strong(expected, STATE::RUNNING);
+	}
+
+	void Run()
+	{
+		isValid = FSTDecryptAndVerifyHashedBlock(block->blockData, blockIndex, *key);
+		state.store(STATE::DONE, std::memory_order::release);
+		state.notify_all();
+	}
+
+	// returns once the block is decrypted. If no worker picked up the job yet it runs on the calling thread
+	bool Finish()
+	{
+		if (TryClaim())
+			Run();
 		else
-			delete dropRawItr->second;
-		m_cacheDecryptedRawBlocks.erase(dropRawItr);
-		return;
+			state.wait(STATE::RUNNING, std::memory_order::acquire);
+		return isValid;
 	}
-	else if(dropHashedItr != m_cacheDecryptedHashedBlocks.end() && dropHashedItr->second->lastAccess == lastAccess)
+};
+
+static uint64 FSTGetCacheBlockId(uint32 clusterIndex, uint32 blockIndex)
+{
+	return ((uint64)clusterIndex << (64 - 16)) | (uint64)blockIndex;
+}
+
+// decrypts hash and file data of a hashed block in-place and verifies the file data against its H0 hash
+// does not touch any volume state so it can run on any thread
+static bool FSTDecryptAndVerifyHashedBlock(FSTHashedBlock& block, uint32 blockIndex, const AES128DecryptionKey& key)
+{
+	// decrypt hash data
+	uint8 iv[16]{};
+	AES128_CBC_decryptWithKey(block.getHashData(), block.getHashData(), BLOCK_HASH_SIZE, key, iv);
+	// decrypt file data
+	AES128_CBC_decryptWithKey(block.getFileData(), block.getFileData(), BLOCK_FILE_SIZE, key, block.getH0Hash(blockIndex%16));
+	// compare with H0 to verify data integrity
+	NCrypto::CHash160 h0;
+	SHA1(block.getFileData(), BLOCK_FILE_SIZE, h0.b);
+	uint32 h0Index = (blockIndex % 4096);
+	return memcmp(h0.b, block.getH0Hash(h0Index & 0xF), sizeof(h0.b)) == 0;
+}
+
+void FSTVolume::CacheInsert(FSTCachedBlock* block)
+{
+	block->lruPrev = nullptr;
+	block->lruNext = m_cacheLruHead;
+	if (m_cacheLruHead)
+		m_cacheLruHead->lruPrev = block;
+	else
+		m_cacheLruTail = block;
+	m_cacheLruHead = block;
+	m_cacheSize += block->cacheSize;
+}
+
+void FSTVolume::CacheUnlink(FSTCachedBlock* block)
+{
+	if (block->lruPrev)
+		block->lruPrev->lruNext = block->lruNext;
+	else
+		m_cacheLruHead = block->lruNext;
+	if (block->lruNext)
+		block->lruNext->lruPrev = block->lruPrev;
+	else
+		m_cacheLruTail = block->lruPrev;
+	block->lruPrev = nullptr;
+	block->lruNext = nullptr;
+	m_cacheSize -= block->cacheSize;
+}
+
+void FSTVolume::CacheTouch(FSTCachedBlock* block)
+{
+	if (m_cacheLruHead == block)
+		return;
+	CacheUnlink(block);
+	CacheInsert(block);
+}
+
+// Drops least recently used blocks until there is room for incomingSize bytes. Optionally allows to recycle a released cache entry to cut down cost of memory allocation and clearing
+void FSTVolume::TrimCacheIfRequired(size_t incomingSize, FSTCachedRawBlock** droppedRawBlock, FSTCachedHashedBlock** droppedHashedBlock)
+{
+	while (m_cacheLruTail && (m_cacheSize + incomingSize) > m_cacheCapacity)
 	{
-		if (droppedHashedBlock)
-			*droppedHashedBlock = dropHashedItr->second;
+		FSTCachedBlock* block = m_cacheLruTail;
+		CacheUnlink(block);
+		if (block->isHashed)
+		{
+			FSTCachedHashedBlock* hashedBlock = static_cast<FSTCachedHashedBlock*>(block);
+			m_cacheDecryptedHashedBlocks.erase(block->cacheBlockId);
+			if (droppedHashedBlock && !*droppedHashedBlock)
+				*droppedHashedBlock = hashedBlock;
+			else
+				delete hashedBlock;
+		}
 		else
-			delete dropHashedItr->second;
-		m_cacheDecryptedHashedBlocks.erase(dropHashedItr);
+		{
+			FSTCachedRawBlock* rawBlock = static_cast<FSTCachedRawBlock*>(block);
+			m_cacheDecryptedRawBlocks.erase(block->cacheBlockId);
+			if (droppedRawBlock && !*droppedRawBlock)
+				*droppedRawBlock = rawBlock;
+			else
+				delete rawBlock;
+		}
 	}
 }
 
@@ -961,23 +1062,26 @@ FSTCachedRawBlock* FSTVolume::GetDecryptedRawBlock(uint32 clusterIndex, uint32 b
 	FSTCluster& cluster = m_cluster[clusterIndex];
 	uint64 clusterOffset = (uint64)cluster.offset * m_sectorSize;
 	// generate id for cache
-	uint64 cacheBlockId = ((uint64)clusterIndex << (64 - 16)) | (uint64)blockIndex;
+	uint64 cacheBlockId = FSTGetCacheBlockId(clusterIndex, blockIndex);
 	// lookup block in cache
 	FSTCachedRawBlock* block = nullptr;
 	auto itr = m_cacheDecryptedRawBlocks.find(cacheBlockId);
 	if (itr != m_cacheDecryptedRawBlocks.end())
 	{
 		block = itr->second;
-		block->lastAccess = ++m_cacheAccessCounter;
+		CacheTouch(block);
 		return block;
 	}
-	// if cache already full, drop least recently accessed block and recycle FSTCachedRawBlock object if possible
-	TrimCacheIfRequired(&block, nullptr);
+	// if cache already full, drop least recently accessed blocks and recycle FSTCachedRawBlock object if possible
+	const uint32 blockCacheSize = (uint32)sizeof(FSTCachedRawBlock) + m_sectorSize;
+	TrimCacheIfRequired(blockCacheSize, &block, nullptr);
 	if (!block)
 		block = new FSTCachedRawBlock();
+	block->cacheBlockId = cacheBlockId;
+	block->cacheSize = blockCacheSize;
+	block->isHashed = false;
 	block->blockData.rawData.resize(m_sectorSize);
 	// block not cached, read new
-	block->lastAccess = ++m_cacheAccessCounter;
 	if (m_dataSource->readData(clusterIndex, clusterOffset, blockIndex * m_sectorSize, block->blockData.rawData.data(), m_sectorSize) != m_sectorSize)
 	{
 		cemuLog_log(LogType::Force, "Failed to read raw FST block");
@@ -989,7 +1093,7 @@ FSTCachedRawBlock* FSTVolume::GetDecryptedRawBlock(uint32 clusterIndex, uint32 b
 	NCrypto::AesIv iv{};
 	DetermineUnhashedBlockIV(clusterIndex, blockIndex, iv);
 	std::copy(block->blockData.rawData.data() + m_sectorSize - NCrypto::AesIv::SIZE, block->blockData.rawData.data() + m_sectorSize, block->ivForNextBlock.iv);
-	AES128_CBC_decrypt(block->blockData.rawData.data(), block->blockData.rawData.data(), m_sectorSize, m_partitionTitlekey.b, iv.iv);
+	AES128_CBC_decryptWithKey(block->blockData.rawData.data(), block->blockData.rawData.data(), m_sectorSize, m_partitionDecryptionKey, iv.iv);
 	// if this is the next block, then hash it
 	if(cluster.hasContentHash)
 	{
@@ -1018,30 +1122,133 @@ FSTCachedRawBlock* FSTVolume::GetDecryptedRawBlock(uint32 clusterIndex, uint32 b
 	}
 	// register in cache
 	m_cacheDecryptedRawBlocks.emplace(cacheBlockId, block);
+	CacheInsert(block);
 	return block;
 }
 
+// waits for the job to finish and moves the block into the cache. Returns nullptr if the block failed verification
+FSTCachedHashedBlock* FSTVolume::RetireReadAheadJob(std::shared_ptr<FSTReadAheadJob> job)
+{
+	bool isValid = job->Finish();
+	FSTCachedHashedBlock* block = job->block;
+	if (!isValid)
+	{
+		// the regular read path will retry and report the error if the block is actually requested
+		delete block;
+		return nullptr;
+	}
+	TrimCacheIfRequired(block->cacheSize, nullptr, nullptr);
+	m_cacheDecryptedHashedBlocks.emplace(block->cacheBlockId, block);
+	CacheInsert(block);
+	return block;
+}
+
+void FSTVolume::RetireAllReadAheadJobs()
+{
+	for (auto& itr : m_readAheadJobs)
+	{
+		// jobs that haven't started are dropped without decrypting
+		if (!itr.second->TryClaim())
+			itr.second->state.wait(FSTReadAheadJob::STATE::RUNNING, std::memory_order::acquire);
+		delete itr.second->block;
+	}
+	m_readAheadJobs.clear();
+}
+
+// tracks the access pattern and, if blocks are read sequentially, keeps the next FST_READ_AHEAD_BLOCKS blocks in flight on the worker threads
+void FSTVolume::UpdateHashedReadAhead(uint32 clusterIndex, uint32 blockIndex)
+{
+	if (clusterIndex == m_lastHashedClusterIndex && blockIndex == m_lastHashedBlockIndex + 1)
+		m_sequentialHashedReadCount++;
+	else if (clusterIndex != m_lastHashedClusterIndex || blockIndex != m_lastHashedBlockIndex)
+		m_sequentialHashedReadCount = 0;
+	m_lastHashedClusterIndex = clusterIndex;
+	m_lastHashedBlockIndex = blockIndex;
+	if (m_sequentialHashedReadCount < FST_READ_AHEAD_MIN_SEQUENTIAL)
+		return;
+	// move finished blocks which are no longer ahead of the read position into the cache
+	for (auto itr = m_readAheadJobs.begin(); itr != m_readAheadJobs.end();)
+	{
+		std::shared_ptr<FSTReadAheadJob> job = itr->second;
+		if (job->clusterIndex == clusterIndex && job->blockIndex > blockIndex && job->blockIndex <= blockIndex + FST_READ_AHEAD_BLOCKS)
+		{
+			++itr;
+			continue;
+		}
+		itr = m_readAheadJobs.erase(itr);
+		RetireReadAheadJob(std::move(job));
+	}
+	// queue blocks that are neither cached nor in flight. Never read past the end of the cluster
+	const FSTCluster& cluster = m_cluster[clusterIndex];
+	uint64 clusterOffset = (uint64)cluster.offset * m_sectorSize;
+	uint64 clusterBlockCount = (uint64)cluster.size * m_sectorSize / BLOCK_SIZE;
+	for (uint32 i = 1; i <= FST_READ_AHEAD_BLOCKS; i++)
+	{
+		uint32 aheadBlockIndex = blockIndex + i;
+		if (aheadBlockIndex >= clusterBlockCount)
+			break;
+		uint64 cacheBlockId = FSTGetCacheBlockId(clusterIndex, aheadBlockIndex);
+		if (m_cacheDecryptedHashedBlocks.contains(cacheBlockId) || m_readAheadJobs.contains(cacheBlockId))
+			continue;
+		FSTCachedHashedBlock* block = new FSTCachedHashedBlock();
+		block->cacheBlockId = cacheBlockId;
+		block->cacheSize = sizeof(FSTCachedHashedBlock);
+		block->isHashed = true;
+		if (m_dataSource->readData(clusterIndex, clusterOffset, (uint64)aheadBlockIndex * BLOCK_SIZE, block->blockData.rawData, BLOCK_SIZE) != BLOCK_SIZE)
+		{
+			// most likely reached the end of the data. Not an error since the block may never be requested
+			delete block;
+			break;
+		}
+		auto job = std::make_shared<FSTReadAheadJob>();
+		job->clusterIndex = clusterIndex;
+		job->blockIndex = aheadBlockIndex;
+		job->block = block;
+		job->key = &m_partitionDecryptionKey;
+		m_readAheadJobs.emplace(cacheBlockId, job);
+		// workers only decrypt and verify, reading from the data source always happens on the thread that owns the volume
+		ThreadPool::Submit(ThreadPool::Priority::High, [job]() {
+			if (job->TryClaim())
+				job->Run();
+		});
+	}
+}
+
 FSTCachedHashedBlock* FSTVolume::GetDecryptedHashedBlock(uint32 clusterIndex, uint32 blockIndex)
 {
+	// this may move blocks into the cache, so it needs to happen before we hand out any cached block
+	UpdateHashedReadAhead(clusterIndex, blockIndex);
 	const FSTCluster& cluster = m_cluster[clusterIndex];
 	uint64 clusterOffset = (uint64)cluster.offset * m_sectorSize;
 	// generate id for cache
-	uint64 cacheBlockId = ((uint64)clusterIndex << (64 - 16)) | (uint64)blockIndex;
+	uint64 cacheBlockId = FSTGetCacheBlockId(clusterIndex, blockIndex);
 	// lookup block in cache
 	FSTCachedHashedBlock* block = nullptr;
 	auto itr = m_cacheDecryptedHashedBlocks.find(cacheBlockId);
 	if (itr != m_cacheDecryptedHashedBlocks.end())
 	{
 		block = itr->second;
-		block->lastAccess = ++m_cacheAccessCounter;
+		CacheTouch(block);
 		return block;
 	}
-	// if cache already full, drop least recently accessed block and recycle FSTCachedHashedBlock object if possible
-	TrimCacheIfRequired(nullptr, &block);
+	// check if the block is currently being prefetched
+	auto readAheadItr = m_readAheadJobs.find(cacheBlockId);
+	if (readAheadItr != m_readAheadJobs.end())
+	{
+		std::shared_ptr<FSTReadAheadJob> job = std::move(readAheadItr->second);
+		m_readAheadJobs.erase(readAheadItr);
+		block = RetireReadAheadJob(std::move(job));
+		if (block)
+			return block;
+	}
+	// if cache already full, drop least recently accessed blocks and recycle FSTCachedHashedBlock object if possible
+	TrimCacheIfRequired(sizeof(FSTCachedHashedBlock), nullptr, &block);
 	if (!block)
 		block = new FSTCachedHashedBlock();
+	block->cacheBlockId = cacheBlockId;
+	block->cacheSize = sizeof(FSTCachedHashedBlock);
+	block->isHashed = true;
 	// block not cached, read new
-	block->lastAccess = ++m_cacheAccessCounter;
 	if (m_dataSource->readData(clusterIndex, clusterOffset, blockIndex * BLOCK_SIZE, block->blockData.rawData, BLOCK_SIZE) != BLOCK_SIZE)
 	{
 		cemuLog_log(LogType::Force, "Failed to read hashed FST block");
@@ -1049,16 +1256,7 @@ FSTCachedHashedBlock* FSTVolume::GetDecryptedHashedBlock(uint32 clusterIndex, ui
 		m_detectedCorruption = true;
 		return nullptr;
 	}
-	// decrypt hash data
-	uint8 iv[16]{};
-	AES128_CBC_decrypt(block->blockData.getHashData(), block->blockData.getHashData(), BLOCK_HASH_SIZE, m_partitionTitlekey.b, iv);
-	// decrypt file data
-	AES128_CBC_decrypt(block->blockData.getFileData(), block->blockData.getFileData(), BLOCK_FILE_SIZE, m_partitionTitlekey.b, block->blockData.getH0Hash(blockIndex%16));
-	// compare with H0 to verify data integrity
-	NCrypto::CHash160 h0;
-	SHA1(block->blockData.getFileData(), BLOCK_FILE_SIZE, h0.b);
-	uint32 h0Index = (blockIndex % 4096);
-	if (memcmp(h0.b, block->blockData.getH0Hash(h0Index & 0xF), sizeof(h0.b)) != 0)
+	if (!FSTDecryptAndVerifyHashedBlock(block->blockData, blockIndex, m_partitionDecryptionKey))
 	{
 		cemuLog_log(LogType::Force, "FST: Hash H0 mismatch in hashed block (section {} index {})", clusterIndex, blockIndex);
 		delete block;
@@ -1067,6 +1265,7 @@ FSTCachedHashedBlock* FSTVolume::GetDecryptedHashedBlock(uint32 clusterIndex, ui
 	}
 	// register in cache
 	m_cacheDecryptedHashedBlocks.emplace(cacheBlockId, block);
+	CacheInsert(block);
 	return block;
 }
 
@@ -1176,6 +1375,7 @@ bool FSTVolume::Next(FSTDirectoryIterator& directoryIterator, FSTFileHandle& fil
 
 FSTVolume::~FSTVolume()
 {
+	RetireAllReadAheadJobs();
 	for (auto& itr : m_cacheDecryptedRawBlocks)
 		delete itr.second;
 	for (auto& itr : m_cacheDecryptedHashedBlocks)
@@ -1232,6 +1432,7 @@ bool FSTVerifier::VerifyHashedContentFile(FileStream* fileContent, const NCrypto
 	fileContent->SetPosition(0);
 
 	std::vector<NCrypto::CHash160> h0List(4096);
+	AES128DecryptionKey decryptionKey(key->b);
 
 	FSTHashedBlock block;
 	uint32 numBlocks = contentSize / sizeof(FSTHashedBlock);
@@ -1242,8 +1443,8 @@ bool FSTVerifier::VerifyHashedContentFile(FileStream* fileContent, const NCrypto
 		uint32 h0Index = (blockIndex % 4096);
 		// decrypt hash data and file data
 		uint8 iv[16]{};
-		AES128_CBC_decrypt(block.getHashData(), block.getHashData(), BLOCK_HASH_SIZE, key->b, iv);
-		AES128_CBC_decrypt(block.getFileData(), block.getFileData(), BLOCK_FILE_SIZE, key->b, block.getH0Hash(blockIndex % 16));
+		AES128_CBC_decryptWithKey(block.getHashData(), block.getHashData(), BLOCK_HASH_SIZE, decryptionKey, iv);
+		AES128_CBC_decryptWithKey(block.getFileData(), block.getFileData(), BLOCK_FILE_SIZE, decryptionKey, block.getH0Hash(blockIndex % 16));
 
 		// generate H0 hash and compare
 		NCrypto::CHash160 h0;
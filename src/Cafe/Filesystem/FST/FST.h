@@ -2,6 +2,7 @@
 #include "Cemu/ncrypto/ncrypto.h"
 #include "Common/FileStream.h"
 #include "openssl/evp.h"
+#include "util/crypto/aes128.h"
 
 struct FSTFileHandle
 {
@@ -181,6 +182,7 @@ private:
 	std::vector<FSTEntry> m_entries;
 	std::vector<char> m_nameStringTable;
 	NCrypto::AesKey m_partitionTitlekey;
+	AES128DecryptionKey m_partitionDecryptionKey; // expanded once so the round keys aren't recomputed for every sector
 	bool m_detectedCorruption{false};
 
 	bool HashIsDisabled() const
@@ -191,14 +193,32 @@ private:
 	/* Cache for decrypted raw and hashed blocks */
 	std::unordered_map<uint64, struct FSTCachedRawBlock*> m_cacheDecryptedRawBlocks;
 	std::unordered_map<uint64, struct FSTCachedHashedBlock*> m_cacheDecryptedHashedBlocks;
-	uint64 m_cacheAccessCounter{};
+	// both block types share one LRU list. Head is the most recently used block
+	struct FSTCachedBlock* m_cacheLruHead{};
+	struct FSTCachedBlock* m_cacheLruTail{};
+	size_t m_cacheSize{};
+	size_t m_cacheCapacity{};
+
+	/* Read-ahead for hashed blocks */
+	// when sequential access is detected the upcoming blocks are read on the calling thread and then decrypted and verified by worker threads
+	std::unordered_map<uint64, std::shared_ptr<struct FSTReadAheadJob>> m_readAheadJobs;
+	uint32 m_lastHashedClusterIndex{};
+	uint32 m_lastHashedBlockIndex{};
+	uint32 m_sequentialHashedReadCount{};
 
 	void DetermineUnhashedBlockIV(uint32 clusterIndex, uint32 blockIndex, NCrypto::AesIv& ivOut);
 
 	struct FSTCachedRawBlock* GetDecryptedRawBlock(uint32 clusterIndex, uint32 blockIndex);
 	struct FSTCachedHashedBlock* GetDecryptedHashedBlock(uint32 clusterIndex, uint32 blockIndex);
 
-	void TrimCacheIfRequired(struct FSTCachedRawBlock** droppedRawBlock, struct FSTCachedHashedBlock** droppedHashedBlock);
+	void CacheInsert(struct FSTCachedBlock* block);
+	void CacheTouch(struct FSTCachedBlock* block);
+	void CacheUnlink(struct FSTCachedBlock* block);
+	void TrimCacheIfRequired(size_t incomingSize, struct FSTCachedRawBlock** droppedRawBlock, struct FSTCachedHashedBlock** droppedHashedBlock);
+
+	void UpdateHashedReadAhead(uint32 clusterIndex, uint32 blockIndex);
+	struct FSTCachedHashedBlock* RetireReadAheadJob(std::shared_ptr<struct FSTReadAheadJob> job);
+	void RetireAllReadAheadJobs();
 
 	/* File reading */
 	uint32 ReadFile_HashModeRaw(uint32 clusterIndex, FSTEntry& entry, uint32 readOffset, uint32 readSize, void* dataOut);
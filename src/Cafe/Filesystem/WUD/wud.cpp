@@ -3,6 +3,99 @@
 #include <stdlib.h>
 #include "wud.h"
 #include "Common/FileStream.h"
+#include "Common/ExceptionHandler/ExceptionHandler.h"
+
+#if BOOST_OS_LINUX || BOOST_OS_MACOS
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+/*
+ * Map the whole image into memory (read-only)
+ * Reads from a mapped image are plain memcpys which avoid a syscall per read and are safe to do from multiple threads
+ */
+static void wud_mapFile(wud_t* wud, const fs::path& path)
+{
+	wud->mappedData = nullptr;
+	wud->mappedSize = 0;
+#if BOOST_PLAT_ANDROID
+	// files may be provided through content URIs which cannot be mapped
+#elif BOOST_OS_WINDOWS
+	HANDLE hFile = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (hFile == INVALID_HANDLE_VALUE)
+		return;
+	LARGE_INTEGER fileSize;
+	if (!GetFileSizeEx(hFile, &fileSize) || fileSize.QuadPart == 0)
+	{
+		CloseHandle(hFile);
+		return;
+	}
+	HANDLE hMapping = CreateFileMappingW(hFile, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	CloseHandle(hFile);
+	if (!hMapping)
+		return;
+	void* view = MapViewOfFile(hMapping, FILE_MAP_READ, 0, 0, 0);
+	CloseHandle(hMapping); // the view keeps the mapping alive
+	if (!view)
+		return;
+	wud->mappedData = (const uint8*)view;
+	wud->mappedSize = (unsigned long long)fileSize.QuadPart;
+#elif BOOST_OS_LINUX || BOOST_OS_MACOS
+	int fd = open(path.c_str(), O_RDONLY);
+	if (fd < 0)
+		return;
+	struct stat fileStats;
+	if (fstat(fd, &fileStats) != 0 || fileStats.st_size <= 0)
+	{
+		close(fd);
+		return;
+	}
+	void* view = mmap(nullptr, (size_t)fileStats.st_size, PROT_READ, MAP_SHARED, fd, 0);
+	close(fd); // the mapping stays valid after closing the descriptor
+	if (view == MAP_FAILED)
+		return;
+	wud->mappedData = (const uint8*)view;
+	wud->mappedSize = (unsigned long long)fileStats.st_size;
+#endif
+}
+
+static void wud_unmapFile(wud_t* wud)
+{
+	if (!wud->mappedData)
+		return;
+#if BOOST_OS_WINDOWS
+	UnmapViewOfFile(wud->mappedData);
+#elif BOOST_OS_LINUX || BOOST_OS_MACOS
+	munmap((void*)wud->mappedData, (size_t)wud->mappedSize);
+#endif
+	wud->mappedData = nullptr;
+	wud->mappedSize = 0;
+}
+
+/*
+ * Read a physically contiguous range of the image file
+ */
+static unsigned int wud_readPhysical(wud_t* wud, void* buffer, unsigned int length, long long physicalOffset)
+{
+	if (wud->mappedData)
+	{
+		if (physicalOffset < 0 || (unsigned long long)physicalOffset >= wud->mappedSize)
+			return 0;
+		unsigned long long bytesAvailable = wud->mappedSize - (unsigned long long)physicalOffset;
+		if (bytesAvailable < length)
+			length = (unsigned int)bytesAvailable;
+		if (ExceptionHandler_CopyFromMappedFile(buffer, wud->mappedData + physicalOffset, length))
+			return length;
+		// the file became unreadable (e.g. removable or network media was disconnected)
+		// stop using the mapping and let the stream read report the error
+		cemuLog_log(LogType::Force, "WUD: Failed to read from memory mapped image, falling back to buffered reads");
+		wud_unmapFile(wud);
+	}
+	wud->fs->SetPosition(physicalOffset);
+	return (unsigned int)wud->fs->readData(buffer, length);
+}
 
 wud_t* wud_open(const fs::path& path)
 {
@@ -58,11 +151,13 @@ wud_t* wud_open(const fs::path& path)
 		// uncompressed file
 		wud->uncompressedSize = inputFileSize;
 	}
+	wud_mapFile(wud, path);
 	return wud;
 }
 
 void wud_close(wud_t* wud)
 {
+	wud_unmapFile(wud);
 	delete wud->fs;
 	if( wud->indexTable )
 		free(wud->indexTable);
@@ -91,27 +186,35 @@ unsigned int wud_readData(wud_t* wud, void* buffer, unsigned int length, long lo
 	if( wud->isCompressed == false )
 	{
 		// uncompressed read is straight forward
-		wud->fs->SetPosition(offset);
-		readBytes = (unsigned int)wud->fs->readData(buffer, length);
+		readBytes = wud_readPhysical(wud, buffer, length, offset);
 	}
 	else
 	{
 		// compressed read must be handled on a per-sector level
+		// consecutive logical sectors which are also stored consecutively in the file are merged into a single read
 		while( length > 0 )
 		{
 			unsigned int sectorOffset = (unsigned int)(offset % (long long)wud->sectorSize);
-			unsigned int remainingSectorBytes = wud->sectorSize - sectorOffset;
 			unsigned int sectorIndex = (unsigned int)(offset / (long long)wud->sectorSize);
-			unsigned int bytesToRead = (remainingSectorBytes<length)?remainingSectorBytes:length; // read only up to the end of the current sector
-			// look up real sector index
-			sectorIndex = wud->indexTable[sectorIndex];
-			wud->fs->SetPosition(wud->offsetSectorArray + (long long)sectorIndex * (long long)wud->sectorSize + (long long)sectorOffset);
-			readBytes += (unsigned int)wud->fs->readData(buffer, bytesToRead);
+			unsigned int physicalSectorIndex = wud->indexTable[sectorIndex];
+			unsigned int bytesToRead = wud->sectorSize - sectorOffset;
+			while( bytesToRead < length )
+			{
+				sectorIndex++;
+				if( sectorIndex >= wud->indexTableEntryCount || wud->indexTable[sectorIndex] != physicalSectorIndex + (sectorIndex - (unsigned int)(offset / (long long)wud->sectorSize)) )
+					break;
+				bytesToRead += wud->sectorSize;
+			}
+			if( bytesToRead > length )
+				bytesToRead = length; // read only up to the end of the requested range
+			unsigned int bytesRead = wud_readPhysical(wud, buffer, bytesToRead, wud->offsetSectorArray + (long long)physicalSectorIndex * (long long)wud->sectorSize + (long long)sectorOffset);
+			readBytes += bytesRead;
+			if( bytesRead != bytesToRead )
+				break;
 			// progress read offset, write pointer and decrease length
 			buffer = (void*)((char*)buffer + bytesToRead);
 			length -= bytesToRead;
 			offset += bytesToRead;
-
 		}
 	}
 	return readBytes;
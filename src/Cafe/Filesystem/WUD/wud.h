@@ -22,6 +22,9 @@ struct wud_t
 	unsigned int*	indexTable;
 	long long		offsetIndexTable;
 	long long		offsetSectorArray;
+	// read-only memory mapping of the whole file, null if the platform or file doesn't support it
+	const uint8*	mappedData;
+	unsigned long long	mappedSize;
 };
 
 #define WUX_MAGIC_0	'0XUW' // "WUX0"
@@ -33,4 +36,7 @@ void wud_close(wud_t* wud);
 
 bool wud_isWUXCompressed(wud_t* wud);
 unsigned int wud_readData(wud_t* wud, void* buffer, unsigned int length, long long offset);
-long long wud_getWUDSize(wud_t* wud);
\ No newline at end of file
+long long wud_getWUDSize(wud_t* wud);
+
+// compares wud_readData() against a per-sector reader. Uses a synthetic WUX image if the path is empty
+bool wud_runReadCheck(const fs::path& imagePath);
\ No newline at end of file
@@ -0,0 +1,174 @@
+#include "wud.h"
+#include "Common/FileStream.h"
+
+/* WUD/WUX read check
+ * Reads random ranges through wud_readData() and compares them against a plain per-sector reader which does one seek and read per sector, like wud_readData() used to
+ * Ranges are up to a few hundred sectors long and a part of them starts near or crosses the end of the image. Every range is read with and without the memory mapping
+ * Without an image path, a synthetic WUX image with deduplicated sectors and a size which isn't sector aligned is generated in the temp directory
+ */
+
+constexpr uint32 WUD_CHECK_ITERATIONS = 4000;
+constexpr uint32 WUD_CHECK_SYNTHETIC_SECTOR_SIZE = 0x8000;
+constexpr uint32 WUD_CHECK_SYNTHETIC_SECTOR_COUNT = 1024;
+
+class WUDCheckRNG
+{
+public:
+	WUDCheckRNG(uint32 seed) : m_state(seed * 0x9E3779B9u + 0x6D2B79F5u) {}
+
+	uint32 Next()
+	{
+		m_state ^= m_state << 13;
+		m_state ^= m_state >> 17;
+		m_state ^= m_state << 5;
+		return m_state;
+	}
+
+	uint64 Range(uint64 minValue, uint64 maxValue)
+	{
+		uint64 value = ((uint64)Next() << 32) | Next();
+		return minValue + value % (maxValue - minValue + 1);
+	}
+
+private:
+	uint32 m_state;
+};
+
+// the read path before sector runs were coalesced, always goes through the file stream
+static unsigned int wudCheck_readPerSector(wud_t* wud, uint8* buffer, unsigned int length, long long offset)
+{
+	long long fileBytesLeft = wud->uncompressedSize - offset;
+	if (fileBytesLeft <= 0)
+		return 0;
+	if (fileBytesLeft < (long long)length)
+		length = (unsigned int)fileBytesLeft;
+	if (!wud->isCompressed)
+	{
+		wud->fs->SetPosition(offset);
+		return (unsigned int)wud->fs->readData(buffer, length);
+	}
+	unsigned int readBytes = 0;
+	while (length > 0)
+	{
+		unsigned int sectorOffset = (unsigned int)(offset % (long long)wud->sectorSize);
+		unsigned int sectorIndex = (unsigned int)(offset / (long long)wud->sectorSize);
+		unsigned int bytesToRead = std::min(wud->sectorSize - sectorOffset, length);
+		wud->fs->SetPosition(wud->offsetSectorArray + (long long)wud->indexTable[sectorIndex] * (long long)wud->sectorSize + (long long)sectorOffset);
+		unsigned int bytesRead = (unsigned int)wud->fs->readData(buffer, bytesToRead);
+		readBytes += bytesRead;
+		if (bytesRead != bytesToRead)
+			break;
+		buffer += bytesToRead;
+		length -= bytesToRead;
+		offset += bytesToRead;
+	}
+	return readBytes;
+}
+
+static bool wudCheck_writeSyntheticImage(const fs::path& path, WUDCheckRNG& rng)
+{
+	const uint32 sectorSize = WUD_CHECK_SYNTHETIC_SECTOR_SIZE;
+	wuxHeader_t header{};
+	header.magic0 = WUX_MAGIC_0;
+	header.magic1 = WUX_MAGIC_1;
+	header.sectorSize = sectorSize;
+	header.uncompressedSize = (unsigned long long)WUD_CHECK_SYNTHETIC_SECTOR_COUNT * sectorSize - 0x1234; // the last sector is partial
+	// about a fifth of the sectors are duplicates of earlier ones, the rest is stored in order
+	std::vector<uint32> indexTable(WUD_CHECK_SYNTHETIC_SECTOR_COUNT);
+	uint32 physicalSectorCount = 0;
+	for (uint32 i = 0; i < WUD_CHECK_SYNTHETIC_SECTOR_COUNT; i++)
+		indexTable[i] = (physicalSectorCount > 0 && rng.Range(0, 4) == 0) ? (uint32)rng.Range(0, physicalSectorCount - 1) : physicalSectorCount++;
+	std::vector<uint8> data(sizeof(header) + indexTable.size() * sizeof(uint32));
+	memcpy(data.data(), &header, sizeof(header));
+	memcpy(data.data() + sizeof(header), indexTable.data(), indexTable.size() * sizeof(uint32));
+	data.resize((data.size() + sectorSize - 1) / sectorSize * sectorSize + (size_t)physicalSectorCount * sectorSize);
+	for (size_t i = data.size() - (size_t)physicalSectorCount * sectorSize; i < data.size(); i += 4)
+	{
+		uint32 value = rng.Next();
+		memcpy(data.data() + i, &value, 4);
+	}
+	std::unique_ptr<FileStream> file(FileStream::createFile2(path));
+	if (!file)
+		return false;
+	return file->writeData(data.data(), data.size()) == data.size();
+}
+
+bool wud_runReadCheck(const fs::path& imagePath)
+{
+	WUDCheckRNG rng(1);
+	fs::path path = imagePath;
+	bool isSynthetic = path.empty();
+	if (isSynthetic)
+	{
+		std::error_code ec;
+		path = fs::temp_directory_path(ec) / "cemu_wux_read_check.wux";
+		if (ec || !wudCheck_writeSyntheticImage(path, rng))
+		{
+			fmt::print("Unable to write synthetic image {}\n", _pathToUtf8(path));
+			return false;
+		}
+	}
+	wud_t* wud = wud_open(path);
+	if (!wud)
+	{
+		fmt::print("Unable to open {}\n", _pathToUtf8(path));
+		return false;
+	}
+	const long long imageSize = wud_getWUDSize(wud);
+	const unsigned int sectorSize = wud->isCompressed ? wud->sectorSize : 0x8000;
+	fmt::print("WUD read check: {} ({}), {} bytes, {} ranges\n", _pathToUtf8(path), wud->isCompressed ? "wux" : "wud", imageSize, WUD_CHECK_ITERATIONS);
+
+	const uint8* mappedData = wud->mappedData;
+	const unsigned long long mappedSize = wud->mappedSize;
+	std::vector<uint8> expected;
+	std::vector<uint8> actual;
+	std::chrono::steady_clock::duration perSectorTime{};
+	std::chrono::steady_clock::duration coalescedTime[2]{};
+	uint32 failedCount = 0;
+	for (uint32 i = 0; i < WUD_CHECK_ITERATIONS; i++)
+	{
+		// a quarter of the ranges start close to the end of the image, most of those cross it
+		const long long maxLength = (long long)sectorSize * 256;
+		long long offset = (i % 4) == 0 ? imageSize - (long long)rng.Range(0, std::min<long long>(imageSize, maxLength)) : (long long)rng.Range(0, imageSize - 1);
+		if ((i % 16) == 0)
+			offset = offset / sectorSize * sectorSize; // sector aligned
+		unsigned int length = (unsigned int)rng.Range(1, maxLength);
+		expected.assign(length, 0xCC);
+		auto startTime = std::chrono::steady_clock::now();
+		unsigned int expectedBytes = wudCheck_readPerSector(wud, expected.data(), length, offset);
+		perSectorTime += std::chrono::steady_clock::now() - startTime;
+		// once through the memory mapping (if available) and once through the file stream
+		for (uint32 pass = 0; pass < 2; pass++)
+		{
+			if (pass == 0 && !mappedData)
+				continue;
+			wud->mappedData = pass == 0 ? mappedData : nullptr;
+			wud->mappedSize = pass == 0 ? mappedSize : 0;
+			actual.assign(length, 0xCC);
+			startTime = std::chrono::steady_clock::now();
+			unsigned int actualBytes = wud_readData(wud, actual.data(), length, offset);
+			coalescedTime[pass] += std::chrono::steady_clock::now() - startTime;
+			if (actualBytes != expectedBytes || actual != expected)
+			{
+				fmt::print("MISMATCH: {} read at 0x{:x} length 0x{:x}, {} bytes read, {} expected\n", pass == 0 ? "mapped" : "stream", offset, length, actualBytes, expectedBytes);
+				failedCount++;
+			}
+		}
+		wud->mappedData = mappedData;
+		wud->mappedSize = mappedSize;
+	}
+	wud_close(wud);
+	if (isSynthetic)
+	{
+		std::error_code ec;
+		fs::remove(path, ec);
+	}
+
+	auto toMs = [](std::chrono::steady_clock::duration d) { return std::chrono::duration<double, std::milli>(d).count(); };
+	fmt::print("{:<20} {:10.2f}ms\n", "per sector", toMs(perSectorTime));
+	if (mappedData)
+		fmt::print("{:<20} {:10.2f}ms\n", "coalesced (mapped)", toMs(coalescedTime[0]));
+	fmt::print("{:<20} {:10.2f}ms\n", "coalesced (stream)", toMs(coalescedTime[1]));
+	fmt::print("{}\n", failedCount == 0 ? "All reads match" : fmt::format("{} reads do NOT match", failedCount));
+	return failedCount == 0;
+}
@@ -606,6 +606,8 @@ bool fsc_isWritable(FSCVirtualFile* fscFile)
  */
 uint32 fsc_readFile(FSCVirtualFile* fscFile, void* buffer, uint32 size)
 {
+	if (fscFile->fscIsStandalone())
+		return fscFile->fscReadData(buffer, size);
 	fscEnter();
 	uint32 fscStatus = fscFile->fscReadData(buffer, size);
 	fscLeave();
@@ -618,6 +620,14 @@ uint32 fsc_readFile(FSCVirtualFile* fscFile, void* buffer, uint32 size)
  */
 uint32 fsc_writeFile(FSCVirtualFile* fscFile, void* buffer, uint32 size)
 {
+	if (fscFile->fscIsStandalone())
+	{
+		if (fsc_isWritable(fscFile) == false)
+			return 0;
+		if (fscFile->m_isAppend)
+			fscFile->fscSetSeek(fsc_getFileSize(fscFile));
+		return fscFile->fscWriteData(buffer, size);
+	}
 	fscEnter();
 	if (fsc_isWritable(fscFile) == false)
 	{
@@ -158,6 +158,13 @@ struct FSCVirtualFile
 		return false;
 	}
 
+	// returns true if the file does not share any state with other open files
+	// reads and writes to such files don't need to hold the global FSC lock, which allows multiple files to be accessed in parallel
+	virtual bool fscIsStandalone()
+	{
+		return false;
+	}
+
 	FSCDirIteratorState* dirIterator{};
 
 	bool m_isAppend{ false };
@@ -4,6 +4,7 @@
 #include "Cafe/OS/RPL/rpl.h"
 #include "Cemu/PPCAssembler/ppcAssembler.h"
 #include "Cafe/HW/Espresso/Recompiler/PPCRecompiler.h"
+#include "Cafe/HW/Espresso/Debugger/MemoryWatchpoints.h"
 #include "Cemu/ExpressionParser/ExpressionParser.h"
 
 #include "Cafe/OS/libs/coreinit/coreinit.h"
@@ -139,95 +140,57 @@ void debugger_createCodeBreakpoint(uint32 address, uint8 bpType)
 	debugger_updateExecutionBreakpoint(address);
 }
 
-namespace coreinit
+// reported from the PPC scheduler after the access, the PPC state is the one captured when the access happened
+static void debugger_handleMemoryBreakpointHit(const MemoryWatchpoints::Hit& hit)
 {
-	std::vector<std::thread::native_handle_type>& OSGetSchedulerThreads();
-}
-
-void debugger_updateMemoryBreakpoint(DebuggerBreakpoint* bp)
-{
-	std::vector<std::thread::native_handle_type> schedulerThreadHandles = coreinit::OSGetSchedulerThreads();
-
-#if BOOST_OS_WINDOWS
-	debuggerState.activeMemoryBreakpoint = bp;
-	for (auto& hThreadNH : schedulerThreadHandles)
+	const MemoryWatchpoints::Watchpoint& watchpoint = hit.watchpoint;
+	if (debuggerState.logOnlyMemoryBreakpoints || !hit.hasPPCContext)
 	{
-		HANDLE hThread = (HANDLE)hThreadNH;
-		CONTEXT ctx{};
-		ctx.ContextFlags = CONTEXT_DEBUG_REGISTERS;
-		SuspendThread(hThread);
-		GetThreadContext(hThread, &ctx);
-		if (debuggerState.activeMemoryBreakpoint)
-		{
-			ctx.Dr0 = (DWORD64)memory_getPointerFromVirtualOffset(bp->address);
-			ctx.Dr1 = (DWORD64)memory_getPointerFromVirtualOffset(bp->address);
-			// breakpoint 0
-			SetBits(ctx.Dr7, 0, 1, 1);  // breakpoint #0 enabled: true
-			SetBits(ctx.Dr7, 16, 2, 1); // breakpoint #0 condition: 1 (write)
-			SetBits(ctx.Dr7, 18, 2, 3); // breakpoint #0 length: 3 (4 bytes)
-			// breakpoint 1
-			SetBits(ctx.Dr7, 2, 1, 1);  // breakpoint #1 enabled: true
-			SetBits(ctx.Dr7, 20, 2, 3); // breakpoint #1 condition: 3 (read & write)
-			SetBits(ctx.Dr7, 22, 2, 3); // breakpoint #1 length: 3 (4 bytes)
-		}
-		else
+		float memValueF = memory_readFloat(watchpoint.address);
+		uint32 memValue = memory_readU32(watchpoint.address);
+		if (!hit.hasPPCContext)
 		{
-			// breakpoint 0
-			SetBits(ctx.Dr7, 0, 1, 0);  // breakpoint #0 enabled: false
-			SetBits(ctx.Dr7, 16, 2, 0); // breakpoint #0 condition: 1 (write)
-			SetBits(ctx.Dr7, 18, 2, 0); // breakpoint #0 length: 3 (4 bytes)
-			// breakpoint 1
-			SetBits(ctx.Dr7, 2, 1, 0);  // breakpoint #1 enabled: false
-			SetBits(ctx.Dr7, 20, 2, 0); // breakpoint #1 condition: 3 (read & write)
-			SetBits(ctx.Dr7, 22, 2, 0); // breakpoint #1 length: 3 (4 bytes)
+			// accessed by another host thread
+			cemuLog_log(LogType::Force, "[Debugger] 0x{:08X} was {} by the host! New Value: 0x{:08X} (float {})", watchpoint.address, hit.isWrite ? "written" : "read", memValue, memValueF);
+			return;
 		}
-		SetThreadContext(hThread, &ctx);
-		ResumeThread(hThread);
+		cemuLog_log(LogType::Force, "[Debugger] 0x{:08X} was {}! New Value: 0x{:08X} (float {}) IP: {:08X} LR: {:08X}",
+			watchpoint.address,
+			hit.isWrite ? "written" : "read",
+			memValue,
+			memValueF,
+			hit.instructionPointer,
+			hit.linkRegister
+		);
+		if (cemuLog_advancedPPCLoggingEnabled() && hit.ppcThread != MPTR_NULL)
+			DebugLogStackTrace((OSThread_t*)memory_getPointerFromVirtualOffset(hit.ppcThread), hit.stackPointer);
+	}
+	else
+	{
+		debugger_createCodeBreakpoint(hit.instructionPointer + 4, DEBUGGER_BP_T_ONE_SHOT);
 	}
-	#else
-	cemuLog_log(LogType::Force, "Debugger breakpoints are not supported");
-	#endif
 }
 
-void debugger_handleSingleStepException(uint64 dr6)
+// passes all enabled memory breakpoints to the page protection based watchpoint engine
+static void debugger_updateMemoryBreakpoints()
 {
-	bool triggeredDR0 = GetBits(dr6, 0, 1); // write
-	bool triggeredDR1 = GetBits(dr6, 1, 1); // read and write
-	bool catchBP = false;
-	if (triggeredDR0 && triggeredDR1)
-	{
-		// write (and read) access
-		if (debuggerState.activeMemoryBreakpoint && debuggerState.activeMemoryBreakpoint->bpType == DEBUGGER_BP_T_MEMORY_WRITE)
-			catchBP = true;
-	}
-	else
+	if (!MemoryWatchpoints::IsSupported())
 	{
-		// read access
-		if (debuggerState.activeMemoryBreakpoint && debuggerState.activeMemoryBreakpoint->bpType == DEBUGGER_BP_T_MEMORY_READ)
-			catchBP = true;
+		cemuLog_log(LogType::Force, "Debugger memory breakpoints are not supported");
+		return;
 	}
-	if (catchBP)
+	std::vector<MemoryWatchpoints::Watchpoint> watchpoints;
+	for (auto& it : debuggerState.breakpoints)
 	{
-		PPCInterpreter_t* hCPU = PPCInterpreter_getCurrentInstance();
-		if (debuggerState.logOnlyMemoryBreakpoints)
+		for (DebuggerBreakpoint* bpItr = it; bpItr; bpItr = bpItr->next)
 		{
-			float memValueF = memory_readFloat(debuggerState.activeMemoryBreakpoint->address);
-			uint32 memValue = memory_readU32(debuggerState.activeMemoryBreakpoint->address);
-			cemuLog_log(LogType::Force, "[Debugger] 0x{:08X} was read/written! New Value: 0x{:08X} (float {}) IP: {:08X} LR: {:08X}",
-				debuggerState.activeMemoryBreakpoint->address,
-				memValue,
-				memValueF,
-				hCPU->instructionPointer,
-				hCPU->spr.LR
-			);
-			if (cemuLog_advancedPPCLoggingEnabled())
-				DebugLogStackTrace(coreinit::OSGetCurrentThread(), hCPU->gpr[1]);
-		}
-		else
-		{
-			debugger_createCodeBreakpoint(hCPU->instructionPointer + 4, DEBUGGER_BP_T_ONE_SHOT);
+			if (!bpItr->isMemBP() || !bpItr->enabled)
+				continue;
+			watchpoints.push_back({bpItr->address, 4, bpItr->bpType == DEBUGGER_BP_T_MEMORY_READ, bpItr->bpType == DEBUGGER_BP_T_MEMORY_WRITE});
 		}
 	}
+	MemoryWatchpoints::SetHitCallback(debugger_handleMemoryBreakpointHit);
+	MemoryWatchpoints::SetWatchpoints(std::move(watchpoints));
 }
 
 void debugger_createMemoryBreakpoint(uint32 address, bool onRead, bool onWrite)
@@ -243,14 +206,7 @@ void debugger_createMemoryBreakpoint(uint32 address, bool onRead, bool onWrite)
 
 	DebuggerBreakpoint* bp = new DebuggerBreakpoint(address, 0xFFFFFFFF, bpType, true);
 	debuggerBPChain_add(address, bp);
-	// disable any already existing memory breakpoint
-	if (debuggerState.activeMemoryBreakpoint)
-	{
-		debuggerState.activeMemoryBreakpoint->enabled = false;
-		debuggerState.activeMemoryBreakpoint = nullptr;
-	}
-	// activate new breakpoint
-	debugger_updateMemoryBreakpoint(bp);
+	debugger_updateMemoryBreakpoints();
 }
 
 void debugger_handleEntryBreakpoint(uint32 address)
@@ -293,7 +249,10 @@ void debugger_deleteBreakpoint(DebuggerBreakpoint* bp)
 				cemu_assert_debug(bpItr->next != bp);
 				bpItr->next = bp->next;
 			}
+			bool isMemBP = bp->isMemBP();
 			delete bp;
+			if (isMemBP)
+				debugger_updateMemoryBreakpoints();
 			return;
 		}
 	}
@@ -360,24 +319,8 @@ void debugger_toggleBreakpoint(uint32 address, bool state, DebuggerBreakpoint* b
 			}
 			else if (bpItr->isMemBP())
 			{
-				// disable other memory breakpoints
-				for (auto& it : debuggerState.breakpoints)
-				{
-					DebuggerBreakpoint* bpItr2 = it;
-					while (bpItr2)
-					{
-						if (bpItr2->isMemBP() && bpItr2 != bp)
-						{ 
-							bpItr2->enabled = false;
-						}
-						bpItr2 = bpItr2->next;
-					}
-				}
 				bpItr->enabled = state;
-				if (state)
-					debugger_updateMemoryBreakpoint(bpItr);
-				else
-					debugger_updateMemoryBreakpoint(nullptr);
+				debugger_updateMemoryBreakpoints();
 				g_debuggerDispatcher.UpdateViewThreadsafe();
 			}
 			return;
@@ -146,7 +146,6 @@ typedef struct
 	// breakpoints
 	std::vector<DebuggerBreakpoint*> breakpoints;
 	std::vector<DebuggerPatch*> patches;
-	DebuggerBreakpoint* activeMemoryBreakpoint;
 	// debugging state
 	struct  
 	{
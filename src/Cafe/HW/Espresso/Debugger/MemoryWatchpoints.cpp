@@ -0,0 +1,460 @@
+#include "Cafe/HW/Espresso/Debugger/MemoryWatchpoints.h"
+#include "Cafe/HW/Espresso/PPCState.h"
+#include "Cafe/OS/libs/coreinit/coreinit_Thread.h"
+#include "Cafe/HW/MMU/MMU.h"
+#include "util/MemMapper/MemMapper.h"
+#include "util/helpers/fspinlock.h"
+
+enum class WatchedPageState : uint8
+{
+	None = 0,
+	WatchWrite = 1, // page is read-only
+	WatchReadWrite = 2, // page is not accessible
+	Released = 3, // page was watched before. Faults on it can be caused by a thread which raced with the removal and are retried
+};
+
+struct SteppingPage
+{
+	uint32 pageIndex;
+	uint32 stepCount; // number of threads currently single stepping an access to this page
+};
+
+struct WatchpointThreadState
+{
+	uint32 pendingPages[4]; // an instruction can touch multiple watched pages (page crossing accesses, string instructions)
+	uint32 pendingPageCount;
+	MemoryWatchpoints::Hit pendingHits[8];
+	uint32 pendingHitCount;
+	bool isSingleStepping;
+	bool isReporting; // set while the hit callback runs, accesses by the callback itself are not reported
+};
+
+// hits are passed from the exception handlers to ReportPendingHits() through a bounded lock-free queue, since the handlers can't lock or allocate
+struct QueuedHit
+{
+	std::atomic<uint32> sequence;
+	MemoryWatchpoints::Hit hit;
+};
+
+// used if the faulting host instruction can't be decoded
+static constexpr uint32 WATCHPOINT_FALLBACK_ACCESS_SIZE = 8;
+static constexpr size_t WATCHPOINT_MAX_STEPPING_PAGES = 64;
+static constexpr uint32 WATCHPOINT_HIT_QUEUE_SIZE = 256; // must be a power of two
+
+static FSpinlock s_watchpointLock;
+static std::vector<MemoryWatchpoints::Watchpoint> s_watchpoints; // sorted by address
+static uint32 s_maxWatchpointSize = 0;
+static std::vector<uint32> s_watchedPages;
+static std::array<SteppingPage, WATCHPOINT_MAX_STEPPING_PAGES> s_steppingPages{};
+static uint32 s_steppingPageCount = 0;
+// per-page filter which lets the fault handler reject unrelated faults without taking the lock
+static std::unique_ptr<std::atomic<WatchedPageState>[]> s_pageFilter;
+static uint32 s_pageShift = 0;
+static MemoryWatchpoints::HitCallback s_hitCallback = nullptr;
+static std::array<QueuedHit, WATCHPOINT_HIT_QUEUE_SIZE> s_hitQueue;
+static std::atomic<uint32> s_hitQueueWritePos{0};
+static std::atomic<uint32> s_hitQueueReadPos{0};
+static std::atomic<uint32> s_droppedHitCount{0};
+
+thread_local WatchpointThreadState t_watchpointState{};
+
+bool MemoryWatchpoints::IsSupported()
+{
+#if defined(ARCH_X86_64) && (BOOST_OS_WINDOWS || BOOST_OS_LINUX)
+	return true;
+#else
+	return false;
+#endif
+}
+
+void MemoryWatchpoints::SetHitCallback(HitCallback callback)
+{
+	s_hitCallback = callback;
+}
+
+static bool MemoryWatchpoints_protectPage(uint32 pageIndex, WatchedPageState state)
+{
+	MemMapper::PAGE_PERMISSION permission = MemMapper::PAGE_PERMISSION::P_RW;
+	if (state == WatchedPageState::WatchWrite)
+		permission = MemMapper::PAGE_PERMISSION::P_READ;
+	else if (state == WatchedPageState::WatchReadWrite)
+		permission = MemMapper::PAGE_PERMISSION::P_NONE;
+	return MemMapper::ProtectMemory(memory_base + ((size_t)pageIndex << s_pageShift), (size_t)1 << s_pageShift, permission);
+}
+
+static SteppingPage* MemoryWatchpoints_findSteppingPage(uint32 pageIndex)
+{
+	for (uint32 i = 0; i < s_steppingPageCount; i++)
+	{
+		if (s_steppingPages[i].pageIndex == pageIndex)
+			return s_steppingPages.data() + i;
+	}
+	return nullptr;
+}
+
+void MemoryWatchpoints::SetWatchpoints(std::vector<Watchpoint> watchpoints)
+{
+	std::unique_lock _l(s_watchpointLock);
+	if (!s_pageFilter)
+	{
+		s_pageShift = std::countr_zero((uint64)MemMapper::GetPageSize());
+		const size_t pageCount = (size_t)0x100000000 >> s_pageShift;
+		s_pageFilter = std::make_unique<std::atomic<WatchedPageState>[]>(pageCount);
+		for (size_t i = 0; i < pageCount; i++)
+			s_pageFilter[i].store(WatchedPageState::None, std::memory_order::relaxed);
+		for (uint32 i = 0; i < WATCHPOINT_HIT_QUEUE_SIZE; i++)
+			s_hitQueue[i].sequence.store(i, std::memory_order::relaxed);
+	}
+	// collect the pages and their required protection
+	std::unordered_map<uint32, WatchedPageState> newPages;
+	std::erase_if(watchpoints, [](const Watchpoint& wp) {
+		if (wp.size == 0 || (uint64)wp.address + wp.size > 0x100000000ull || !memory_isAddressRangeAccessible(wp.address, wp.size))
+		{
+			cemuLog_log(LogType::Force, "MemoryWatchpoints: Cannot watch inaccessible memory at 0x{:08x}", wp.address);
+			return true;
+		}
+		return false;
+	});
+	s_maxWatchpointSize = 0;
+	for (auto& wp : watchpoints)
+	{
+		s_maxWatchpointSize = std::max(s_maxWatchpointSize, wp.size);
+		const WatchedPageState state = wp.onRead ? WatchedPageState::WatchReadWrite : WatchedPageState::WatchWrite;
+		for (uint32 pageIndex = wp.address >> s_pageShift; pageIndex <= (wp.address + wp.size - 1) >> s_pageShift; pageIndex++)
+		{
+			auto& pageState = newPages[pageIndex];
+			pageState = std::max(pageState, state);
+		}
+	}
+	// release pages which are no longer watched. Pages which are being single stepped are updated when the step completes
+	for (uint32 pageIndex : s_watchedPages)
+	{
+		if (newPages.contains(pageIndex))
+			continue;
+		if (!MemoryWatchpoints_findSteppingPage(pageIndex))
+			MemoryWatchpoints_protectPage(pageIndex, WatchedPageState::None);
+		s_pageFilter[pageIndex].store(WatchedPageState::Released, std::memory_order::relaxed);
+	}
+	s_watchedPages.clear();
+	for (auto& [pageIndex, state] : newPages)
+	{
+		s_pageFilter[pageIndex].store(state, std::memory_order::relaxed);
+		if (!MemoryWatchpoints_findSteppingPage(pageIndex) && !MemoryWatchpoints_protectPage(pageIndex, state))
+			cemuLog_log(LogType::Force, "MemoryWatchpoints: Failed to protect page at 0x{:08x}", pageIndex << s_pageShift);
+		s_watchedPages.emplace_back(pageIndex);
+	}
+	std::sort(watchpoints.begin(), watchpoints.end(), [](const Watchpoint& a, const Watchpoint& b) { return a.address < b.address; });
+	s_watchpoints = std::move(watchpoints);
+}
+
+// returns the number of bytes accessed through the memory operand of a x86-64 instruction, or 0 if the encoding is not known
+// covers the instructions emitted by the recompiler and compilers for HLE code (integer moves and ALU ops, string ops, SSE/AVX moves and scalar/packed arithmetic)
+static uint32 MemoryWatchpoints_decodeAccessSize(const uint8* code)
+{
+	bool hasOperandSizePrefix = false;
+	uint8 repPrefix = 0;
+	bool isRexW = false;
+	// legacy prefixes
+	for (sint32 i = 0; i < 14; i++, code++)
+	{
+		uint8 prefix = *code;
+		if (prefix == 0x66)
+			hasOperandSizePrefix = true;
+		else if (prefix == 0xF2 || prefix == 0xF3)
+			repPrefix = prefix;
+		else if (prefix != 0xF0 && prefix != 0x2E && prefix != 0x36 && prefix != 0x3E && prefix != 0x26 && prefix != 0x64 && prefix != 0x65 && prefix != 0x67)
+			break;
+	}
+	// VEX encoded SSE/AVX instructions
+	if (*code == 0xC4 || *code == 0xC5)
+	{
+		uint8 map = 1;
+		uint8 vexByte = code[1];
+		if (*code == 0xC4)
+		{
+			map = code[1] & 0x1F;
+			isRexW = (code[2] & 0x80) != 0;
+			vexByte = code[2];
+			code += 3;
+		}
+		else
+			code += 2;
+		const uint32 vectorSize = (vexByte & 4) ? 32 : 16;
+		const uint8 pp = vexByte & 3; // 0: none, 1: 66, 2: F3, 3: F2
+		if (map != 1)
+			return vectorSize;
+		switch (*code)
+		{
+		case 0x10: case 0x11: // vmovss, vmovsd, vmovups, vmovupd
+		case 0x51: case 0x58: case 0x59: case 0x5C: case 0x5D: case 0x5E: case 0x5F:
+			return pp == 2 ? 4 : (pp == 3 ? 8 : vectorSize);
+		case 0x12: case 0x13: case 0x16: case 0x17: case 0xD6:
+			return 8;
+		case 0x6E: case 0x7E:
+			return (pp == 2 && *code == 0x7E) ? 8 : (isRexW ? 8 : 4);
+		case 0x2E: case 0x2F:
+			return pp == 1 ? 8 : 4;
+		default:
+			return vectorSize;
+		}
+	}
+	if ((*code & 0xF0) == 0x40)
+	{
+		isRexW = (*code & 8) != 0;
+		code++;
+	}
+	const uint32 operandSize = isRexW ? 8 : (hasOperandSizePrefix ? 2 : 4);
+	const uint8 opcode = *code;
+	if (opcode != 0x0F)
+	{
+		// integer ALU ops 00-3F, the low bit selects between byte and full operand size
+		if (opcode < 0x40 && (opcode & 7) < 4)
+			return (opcode & 1) ? operandSize : 1;
+		switch (opcode)
+		{
+		case 0x80: case 0x84: case 0x86: case 0x88: case 0x8A: case 0xC0: case 0xC6: case 0xD0: case 0xD2: case 0xF6: case 0xFE:
+			return 1;
+		case 0x81: case 0x83: case 0x85: case 0x87: case 0x89: case 0x8B: case 0x69: case 0x6B: case 0xC1: case 0xC7: case 0xD1: case 0xD3: case 0xF7: case 0xFF:
+			return operandSize;
+		case 0xA4: case 0xA6: case 0xAA: case 0xAC: case 0xAE: // string ops, with TF set every iteration of a rep prefixed op traps separately
+			return 1;
+		case 0xA5: case 0xA7: case 0xAB: case 0xAD: case 0xAF:
+			return operandSize;
+		}
+		return 0;
+	}
+	// two and three byte opcodes
+	const uint8 opcode2 = code[1];
+	if ((opcode2 & 0xF0) == 0x40) // cmovcc
+		return operandSize;
+	switch (opcode2)
+	{
+	case 0xB6: case 0xBE: // movzx, movsx
+	case 0xB0: case 0xC0: // cmpxchg, xadd
+		return 1;
+	case 0xB7: case 0xBF:
+		return 2;
+	case 0xAF: case 0xB1: case 0xC1: case 0xA3: case 0xAB: case 0xB3: case 0xBB:
+		return operandSize;
+	case 0x38:
+		if (code[2] == 0xF0 || code[2] == 0xF1) // movbe
+			return operandSize;
+		return 16;
+	case 0x3A:
+		return 16;
+	case 0xC7: // cmpxchg8b/16b
+		return isRexW ? 16 : 8;
+	// SSE, the mandatory prefix selects between packed (16 bytes), scalar single (F3) and scalar double (F2)
+	case 0x10: case 0x11: case 0x51: case 0x58: case 0x59: case 0x5C: case 0x5D: case 0x5E: case 0x5F:
+		return repPrefix == 0xF3 ? 4 : (repPrefix == 0xF2 ? 8 : 16);
+	case 0x12: case 0x13: case 0x16: case 0x17: case 0xD6:
+		return 8;
+	case 0x28: case 0x29: case 0x2B: case 0x54: case 0x55: case 0x56: case 0x57: case 0xE7:
+		return 16;
+	case 0x2A:
+		return isRexW ? 8 : 4;
+	case 0x2C: case 0x2D:
+		return repPrefix == 0xF2 ? 8 : 4;
+	case 0x2E: case 0x2F:
+		return hasOperandSizePrefix ? 8 : 4;
+	case 0x5A:
+		return repPrefix == 0xF3 ? 4 : 8;
+	case 0x6E: case 0x7E:
+		if (repPrefix == 0xF3 && opcode2 == 0x7E) // movq xmm, m64
+			return 8;
+		return isRexW ? 8 : 4;
+	case 0x6F: case 0x7F:
+		return (hasOperandSizePrefix || repPrefix == 0xF3) ? 16 : 8;
+	}
+	return 0;
+}
+
+// runs inside the exception handler, must not block or allocate
+static void MemoryWatchpoints_queueHit(const MemoryWatchpoints::Hit& hit)
+{
+	uint32 pos = s_hitQueueWritePos.load(std::memory_order::relaxed);
+	while (true)
+	{
+		QueuedHit& entry = s_hitQueue[pos % WATCHPOINT_HIT_QUEUE_SIZE];
+		sint32 diff = (sint32)(entry.sequence.load(std::memory_order::acquire) - pos);
+		if (diff == 0)
+		{
+			if (s_hitQueueWritePos.compare_exchange_weak(pos, pos + 1, std::memory_order::relaxed))
+			{
+				entry.hit = hit;
+				entry.sequence.store(pos + 1, std::memory_order::release);
+				return;
+			}
+		}
+		else if (diff < 0)
+		{
+			// queue is full
+			s_droppedHitCount.fetch_add(1, std::memory_order::relaxed);
+			return;
+		}
+		else
+			pos = s_hitQueueWritePos.load(std::memory_order::relaxed);
+	}
+}
+
+static bool MemoryWatchpoints_dequeueHit(MemoryWatchpoints::Hit& hitOut)
+{
+	uint32 pos = s_hitQueueReadPos.load(std::memory_order::relaxed);
+	while (true)
+	{
+		QueuedHit& entry = s_hitQueue[pos % WATCHPOINT_HIT_QUEUE_SIZE];
+		sint32 diff = (sint32)(entry.sequence.load(std::memory_order::acquire) - (pos + 1));
+		if (diff == 0)
+		{
+			if (s_hitQueueReadPos.compare_exchange_weak(pos, pos + 1, std::memory_order::relaxed))
+			{
+				hitOut = entry.hit;
+				entry.sequence.store(pos + WATCHPOINT_HIT_QUEUE_SIZE, std::memory_order::release);
+				return true;
+			}
+		}
+		else if (diff < 0)
+			return false; // empty
+		else
+			pos = s_hitQueueReadPos.load(std::memory_order::relaxed);
+	}
+}
+
+void MemoryWatchpoints::ReportPendingHits()
+{
+	if (s_hitQueueReadPos.load(std::memory_order::relaxed) == s_hitQueueWritePos.load(std::memory_order::relaxed))
+		return;
+	WatchpointThreadState& threadState = t_watchpointState;
+	if (threadState.isReporting)
+		return;
+	threadState.isReporting = true;
+	HitCallback callback = s_hitCallback;
+	Hit hit;
+	while (MemoryWatchpoints_dequeueHit(hit))
+	{
+		if (callback)
+			callback(hit);
+	}
+	if (uint32 droppedHitCount = s_droppedHitCount.exchange(0, std::memory_order::relaxed))
+		cemuLog_log(LogType::Force, "MemoryWatchpoints: {} hits were dropped because they were not reported in time", droppedHitCount);
+	threadState.isReporting = false;
+}
+
+bool MemoryWatchpoints::HandleAccessFault(void* hostAddress, bool isWrite, const void* hostInstruction)
+{
+	if (!s_pageFilter || !MMU_IsInPPCMemorySpace(hostAddress))
+		return false;
+	const MPTR accessAddress = (MPTR)((uint8*)hostAddress - memory_base);
+	const uint32 pageIndex = accessAddress >> s_pageShift;
+	if (s_pageFilter[pageIndex].load(std::memory_order::relaxed) == WatchedPageState::None)
+		return false;
+	WatchpointThreadState& threadState = t_watchpointState;
+	std::unique_lock _l(s_watchpointLock);
+	WatchedPageState state = s_pageFilter[pageIndex].load(std::memory_order::relaxed);
+	if (state == WatchedPageState::Released)
+	{
+		// the page got unprotected after the fault was raised, retry the access unless the memory got unmapped in the meantime
+		if (!memory_isAddressRangeAccessible(accessAddress, 1))
+			return false;
+		threadState.isSingleStepping = true;
+		return true;
+	}
+	// make the page accessible for the duration of the single step
+	// if other threads occupy all stepping slots, leave the page protected and let the access fault again until a slot is free
+	SteppingPage* steppingPage = MemoryWatchpoints_findSteppingPage(pageIndex);
+	if (threadState.pendingPageCount >= std::size(threadState.pendingPages))
+	{
+		// a single instruction touching more pages than there are per-thread slots, should never happen
+		cemu_assert_debug(false);
+		return false;
+	}
+	if (!steppingPage)
+	{
+		if (s_steppingPageCount >= s_steppingPages.size())
+		{
+			// the trap flag is set either way. If the page gets unprotected meanwhile the retried access completes and traps without faulting, so the step has to be claimed
+			threadState.isSingleStepping = true;
+			_l.unlock();
+			std::this_thread::yield();
+			return true;
+		}
+		steppingPage = s_steppingPages.data() + s_steppingPageCount;
+		s_steppingPageCount++;
+		steppingPage->pageIndex = pageIndex;
+		steppingPage->stepCount = 0;
+		MemoryWatchpoints_protectPage(pageIndex, WatchedPageState::None);
+	}
+	steppingPage->stepCount++;
+	threadState.pendingPages[threadState.pendingPageCount] = pageIndex;
+	threadState.pendingPageCount++;
+	threadState.isSingleStepping = true;
+	if (threadState.isReporting)
+		return true;
+	// the fault address is the first accessed byte, unless the access started on the previous page and crossed into this one
+	uint32 accessSize = MemoryWatchpoints_decodeAccessSize((const uint8*)hostInstruction);
+	if (accessSize == 0)
+		accessSize = WATCHPOINT_FALLBACK_ACCESS_SIZE;
+	MPTR accessStart = accessAddress;
+	if ((accessAddress & (((uint32)1 << s_pageShift) - 1)) == 0)
+		accessStart = accessAddress - std::min(accessAddress, accessSize - 1);
+	const uint64 accessEnd = (uint64)accessAddress + accessSize;
+	// record hits, they are queued for reporting once the access completed
+	PPCInterpreter_t* hCPU = PPCInterpreter_getCurrentInstance();
+	OSThread_t* ppcThread = hCPU ? coreinit::OSGetCurrentThread() : nullptr;
+	const MPTR minAddress = accessStart - std::min(accessStart, s_maxWatchpointSize);
+	auto it = std::lower_bound(s_watchpoints.begin(), s_watchpoints.end(), minAddress, [](const Watchpoint& wp, MPTR address) { return wp.address < address; });
+	for (; it != s_watchpoints.end() && (uint64)it->address < accessEnd; ++it)
+	{
+		if ((uint64)it->address + it->size <= accessStart)
+			continue;
+		if (!(isWrite ? it->onWrite : it->onRead))
+			continue;
+		if (threadState.pendingHitCount >= std::size(threadState.pendingHits))
+			break;
+		Hit& hit = threadState.pendingHits[threadState.pendingHitCount];
+		hit.watchpoint = *it;
+		hit.accessAddress = accessStart;
+		hit.isWrite = isWrite;
+		hit.hasPPCContext = hCPU != nullptr;
+		hit.ppcThread = ppcThread ? memory_getVirtualOffsetFromPointer(ppcThread) : MPTR_NULL;
+		hit.instructionPointer = hCPU ? hCPU->instructionPointer : 0;
+		hit.linkRegister = hCPU ? hCPU->spr.LR : 0;
+		hit.stackPointer = hCPU ? hCPU->gpr[1] : 0;
+		threadState.pendingHitCount++;
+	}
+	// end the time slice early so the hit is reported close to the access
+	if (hCPU && threadState.pendingHitCount > 0)
+		PPCInterpreter_relinquishTimeslice();
+	return true;
+}
+
+bool MemoryWatchpoints::HandleSingleStep()
+{
+	WatchpointThreadState& threadState = t_watchpointState;
+	if (!threadState.isSingleStepping)
+		return false;
+	threadState.isSingleStepping = false;
+	// the callback can't run in here since it isn't async-signal-safe
+	for (uint32 i = 0; i < threadState.pendingHitCount; i++)
+		MemoryWatchpoints_queueHit(threadState.pendingHits[i]);
+	threadState.pendingHitCount = 0;
+	// protect the pages again
+	std::unique_lock _l(s_watchpointLock);
+	for (uint32 i = 0; i < threadState.pendingPageCount; i++)
+	{
+		SteppingPage* steppingPage = MemoryWatchpoints_findSteppingPage(threadState.pendingPages[i]);
+		cemu_assert_debug(steppingPage);
+		if (!steppingPage)
+			continue;
+		steppingPage->stepCount--;
+		if (steppingPage->stepCount > 0)
+			continue;
+		WatchedPageState state = s_pageFilter[steppingPage->pageIndex].load(std::memory_order::relaxed);
+		if (state == WatchedPageState::WatchWrite || state == WatchedPageState::WatchReadWrite)
+			MemoryWatchpoints_protectPage(steppingPage->pageIndex, state);
+		s_steppingPageCount--;
+		*steppingPage = s_steppingPages[s_steppingPageCount];
+	}
+	threadState.pendingPageCount = 0;
+	return true;
+}
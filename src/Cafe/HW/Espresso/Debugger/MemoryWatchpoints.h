@@ -0,0 +1,51 @@
+#pragma once
+
+// watchpoints on guest memory implemented via host page protection, there is no limit on the number of active watchpoints
+// pages containing a watched range are protected so that any access from the interpreter, recompiled code or HLE code raises an access violation
+// the fault handler unprotects the page, single steps the faulting host instruction and then protects the page again
+// accesses to unwatched bytes on a watched page only pay for the fault. Pages with only write watchpoints stay readable
+// limitations: while a page is unprotected for single stepping, accesses from other threads go unnoticed
+// and syscalls which access a watched page (e.g. file reads into guest memory) fail instead of faulting
+class MemoryWatchpoints
+{
+public:
+	struct Watchpoint
+	{
+		MPTR address;
+		uint32 size;
+		bool onRead;
+		bool onWrite;
+	};
+
+	struct Hit
+	{
+		Watchpoint watchpoint;
+		MPTR accessAddress;
+		bool isWrite;
+		// PPC state of the accessing thread at the time of the access. Not set if the access came from a host thread without a PPC context
+		bool hasPPCContext;
+		MPTR ppcThread;
+		uint32 instructionPointer;
+		uint32 linkRegister;
+		uint32 stackPointer;
+	};
+
+	// hits are recorded by the exception handlers and reported later from normal thread context, see ReportPendingHits()
+	using HitCallback = void(*)(const Hit& hit);
+
+	static bool IsSupported();
+	static void SetHitCallback(HitCallback callback);
+	// replaces the set of active watchpoints
+	static void SetWatchpoints(std::vector<Watchpoint> watchpoints);
+
+	// invokes the hit callback for all hits recorded since the last call. Must not be called from a signal or exception handler
+	// called by the PPC core threads on every time slice switch
+	static void ReportPendingHits();
+
+	// called from the platform exception handlers. Only async-signal-safe work happens in here
+	// returns true if the fault was caused by a watchpoint. The caller then has to resume execution with the trap flag set
+	// hostInstruction is the faulting host instruction, it is decoded to determine the width of the access
+	static bool HandleAccessFault(void* hostAddress, bool isWrite, const void* hostInstruction);
+	// returns true if the single step was requested by HandleAccessFault(). The caller then has to clear the trap flag and resume execution
+	static bool HandleSingleStep();
+};
@@ -0,0 +1,454 @@
+#include "Cafe/HW/Espresso/Debugger/PPCSamplingProfiler.h"
+#include "Cafe/HW/Espresso/PPCState.h"
+#include "Cafe/HW/Espresso/Recompiler/PPCRecompiler.h"
+#include "Cafe/OS/libs/coreinit/coreinit_Thread.h"
+#include "Cafe/OS/RPL/rpl_symbol_storage.h"
+#include "Common/FileStream.h"
+#include "util/helpers/helpers.h"
+#include "util/highresolutiontimer/HighResolutionTimer.h"
+
+#if !BOOST_OS_WINDOWS
+#include <signal.h>
+#include <pthread.h>
+#endif
+
+constexpr uint32 PPC_SAMPLE_MAX_FRAMES = 32;
+
+struct PPCCoreSample
+{
+	uint32 requestId; // capture request which wrote the sample
+	bool isValid;
+	MPTR thread;
+	uint32 instructionPointer;
+	uint32 linkRegister;
+	uintptr_t hostPC;
+	// return addresses saved along the guest back chain, innermost first
+	uint32 returnAddresses[PPC_SAMPLE_MAX_FRAMES];
+	uint32 returnAddressCount;
+};
+
+struct PPCThreadProfile
+{
+	std::string name;
+	uint32 sampleCount{};
+	std::map<std::vector<MPTR>, uint32> stacks; // call stack (outermost first) -> number of samples
+};
+
+static std::atomic_bool s_isRunning{false};
+static std::atomic_bool s_stopRequested{false};
+static std::thread s_samplerThread;
+static uint32 s_intervalMicroseconds;
+static HRTick s_startTick;
+
+// only accessed by the sampler thread while running
+static std::unordered_map<MPTR, PPCThreadProfile> s_threadProfiles;
+static uint32 s_idleSampleCount;
+static uint32 s_missedSampleCount;
+
+// written by the interrupted thread (POSIX) or by the sampler thread while the core thread is suspended (Windows)
+// must not lock or allocate since the interrupted thread could be holding any lock
+static PPCCoreSample s_coreSamples[Espresso::CORE_COUNT];
+// a signal can arrive after the sampler gave up on it. The request id, core range and target thread are published together as one request so a late handler can tell that it is stale
+struct PPCCaptureRequest
+{
+	uint32 requestId;
+	uint8 firstCoreIndex;
+	uint8 coreCount;
+};
+static std::atomic<PPCCaptureRequest> s_captureRequest;
+static std::atomic<uint32> s_captureClaimedId;
+static std::atomic<uint32> s_captureDoneId;
+#if !BOOST_OS_WINDOWS
+static std::atomic<pthread_t> s_captureTargetThread;
+#endif
+
+// follows the back chain of the guest stack. Every frame stores the caller's stack pointer at +0 and the callee saves its return address at +4 of that frame
+// only reads guest memory within the bounds of the thread's stack, so a corrupt or half constructed chain can't fault
+static void PPCSamplingProfiler_walkBackChain(PPCCoreSample& sample, OSThread_t* thread, uint32 stackPointer)
+{
+	MPTR stackLow = thread->stackEnd.GetMPTR();
+	MPTR stackHigh = thread->stackBase.GetMPTR();
+	sample.returnAddressCount = 0;
+	while (sample.returnAddressCount < PPC_SAMPLE_MAX_FRAMES)
+	{
+		if ((stackPointer & 3) != 0 || stackPointer < stackLow || stackPointer + 4 > stackHigh)
+			break;
+		uint32 backChain = memory_readU32(stackPointer);
+		// frames are strictly ascending towards the stack base, anything else ends the walk
+		if (backChain <= stackPointer || (backChain & 3) != 0 || backChain + 8 > stackHigh)
+			break;
+		uint32 returnAddress = memory_readU32(backChain + 4);
+		if (returnAddress < 4)
+			break;
+		sample.returnAddresses[sample.returnAddressCount++] = returnAddress;
+		stackPointer = backChain;
+	}
+}
+
+static void PPCSamplingProfiler_captureCores(uint32 requestId, uint32 firstCoreIndex, uint32 coreCount, uintptr_t hostPC)
+{
+	for (uint32 i = firstCoreIndex; i < firstCoreIndex + coreCount; i++)
+	{
+		PPCCoreSample& sample = s_coreSamples[i];
+		PPCInterpreter_t* hCPU = coreinit::__OSGetCoreInstance(i);
+		OSThread_t* thread = coreinit::__OSGetCoreThread(i);
+		sample.requestId = requestId;
+		sample.isValid = hCPU && thread;
+		if (!sample.isValid)
+			continue;
+		sample.thread = memory_getVirtualOffsetFromPointer(thread);
+		sample.instructionPointer = hCPU->instructionPointer;
+		sample.linkRegister = hCPU->spr.LR;
+		sample.hostPC = hostPC;
+		PPCSamplingProfiler_walkBackChain(sample, thread, hCPU->gpr[1]);
+	}
+}
+
+#if !BOOST_OS_WINDOWS
+static uintptr_t PPCSamplingProfiler_getHostPC(void* context)
+{
+	ucontext_t* uc = (ucontext_t*)context;
+#if BOOST_OS_LINUX && defined(ARCH_X86_64)
+	return (uintptr_t)uc->uc_mcontext.gregs[REG_RIP];
+#elif BOOST_OS_LINUX && defined(__aarch64__)
+	return (uintptr_t)uc->uc_mcontext.pc;
+#elif BOOST_OS_MACOS && defined(ARCH_X86_64)
+	return (uintptr_t)uc->uc_mcontext->__ss.__rip;
+#elif BOOST_OS_MACOS && defined(__aarch64__)
+	return (uintptr_t)uc->uc_mcontext->__ss.__pc;
+#else
+	return 0;
+#endif
+}
+
+static void PPCSamplingProfiler_signalHandler(int sig, siginfo_t* info, void* context)
+{
+	PPCCaptureRequest request = s_captureRequest.load(std::memory_order::acquire);
+	// drop signals which were meant for a previous request to another thread, and duplicates for a request which is already served
+	if (!pthread_equal(s_captureTargetThread.load(std::memory_order::acquire), pthread_self()))
+		return;
+	if (s_captureClaimedId.exchange(request.requestId, std::memory_order::acq_rel) == request.requestId)
+		return;
+	PPCSamplingProfiler_captureCores(request.requestId, request.firstCoreIndex, request.coreCount, PPCSamplingProfiler_getHostPC(context));
+	s_captureDoneId.store(request.requestId, std::memory_order::release);
+}
+#endif
+
+// interrupts the host thread and captures the state of the cores it emulates
+// requestIdOut receives the id of the request, samples which carry a different id are stale
+static bool PPCSamplingProfiler_captureHostThread(std::thread::native_handle_type handle, uint32 firstCoreIndex, uint32 coreCount, uint32& requestIdOut)
+{
+	static uint32 s_nextRequestId = 0;
+	uint32 requestId = ++s_nextRequestId;
+	requestIdOut = requestId;
+#if BOOST_OS_WINDOWS
+	HANDLE hThread = (HANDLE)handle;
+	if (SuspendThread(hThread) == (DWORD)-1)
+		return false;
+	CONTEXT ctx{};
+	ctx.ContextFlags = CONTEXT_CONTROL;
+	bool success = GetThreadContext(hThread, &ctx) != FALSE;
+	if (success)
+	{
+#if defined(ARCH_X86_64)
+		PPCSamplingProfiler_captureCores(requestId, firstCoreIndex, coreCount, (uintptr_t)ctx.Rip);
+#else
+		PPCSamplingProfiler_captureCores(requestId, firstCoreIndex, coreCount, (uintptr_t)ctx.Pc);
+#endif
+	}
+	ResumeThread(hThread);
+	return success;
+#else
+	s_captureTargetThread.store(handle, std::memory_order::release);
+	s_captureRequest.store({requestId, (uint8)firstCoreIndex, (uint8)coreCount}, std::memory_order::release);
+	if (pthread_kill(handle, SIGPROF) != 0)
+		return false;
+	// the thread is normally interrupted within microseconds, give up if it doesn't respond in time
+	HRTick timeout = HighResolutionTimer::now().getTick() + HighResolutionTimer::microsecondsToTicks(10000);
+	while (s_captureDoneId.load(std::memory_order::acquire) != requestId)
+	{
+		if (HighResolutionTimer::now().getTick() >= timeout)
+			return false;
+		std::this_thread::yield();
+	}
+	return true;
+#endif
+}
+
+// maps addresses to the closest preceding RPL symbol
+class PPCSamplingProfilerSymbolizer
+{
+public:
+	PPCSamplingProfilerSymbolizer()
+	{
+		auto& symbolMap = rplSymbolStorage_lockSymbolMap();
+		for (auto& it : symbolMap)
+		{
+			if (it.second)
+				m_symbols.emplace(it.first, fmt::format("{}::{}", (const char*)it.second->libName, (const char*)it.second->symbolName));
+		}
+		rplSymbolStorage_unlockSymbolMap();
+	}
+
+	// returns the address of the closest symbol at or before address, or 0 if there is none within maxDistance bytes
+	MPTR GetPrecedingSymbol(MPTR address, uint32 maxDistance) const
+	{
+		auto itr = m_symbols.upper_bound(address);
+		if (itr == m_symbols.begin())
+			return 0;
+		--itr;
+		return (address - itr->first) <= maxDistance ? itr->first : 0;
+	}
+
+	std::string GetName(MPTR address) const
+	{
+		if (address == 0)
+			return "<unknown>";
+		auto itr = m_symbols.upper_bound(address);
+		if (itr != m_symbols.begin())
+		{
+			--itr;
+			uint32 offset = address - itr->first;
+			if (offset == 0)
+				return itr->second;
+			if (offset < MAX_SYMBOL_DISTANCE)
+				return fmt::format("{}+0x{:x}", itr->second, offset);
+		}
+		return fmt::format("ppc_{:08x}", address);
+	}
+
+private:
+	static constexpr uint32 MAX_SYMBOL_DISTANCE = 0x1000; // most functions are smaller. Beyond this the symbol most likely belongs to unrelated code
+
+	std::map<MPTR, std::string> m_symbols;
+};
+
+// used by the sampler thread to bound the prologue search. Symbols of modules loaded while sampling are only known to the final symbolizer
+static std::unique_ptr<PPCSamplingProfilerSymbolizer> s_samplerSymbols;
+static std::unordered_map<MPTR, MPTR> s_functionStartCache;
+
+// guesses the start of the interpreted function containing the address by scanning backwards for the stack frame setup (stwu r1, -x(r1))
+// the search stops at the closest preceding symbol since exported symbols always mark a function start
+static MPTR PPCSamplingProfiler_findFunctionStart(MPTR address)
+{
+	constexpr uint32 MAX_SCAN_DISTANCE = 0x2000;
+	address &= ~3;
+	if (auto itr = s_functionStartCache.find(address); itr != s_functionStartCache.end())
+		return itr->second;
+	MPTR symbolAddress = s_samplerSymbols->GetPrecedingSymbol(address, MAX_SCAN_DISTANCE);
+	MPTR scanEnd = symbolAddress != 0 ? symbolAddress : (address >= MAX_SCAN_DISTANCE ? address - MAX_SCAN_DISTANCE : 0);
+	MPTR functionStart = symbolAddress != 0 ? symbolAddress : address;
+	if (memory_isAddressRangeAccessible(scanEnd, address - scanEnd + 4))
+	{
+		for (MPTR addr = address; addr > scanEnd; addr -= 4)
+		{
+			if ((memory_readU32(addr) & 0xFFFF8000) == 0x94218000) // stwu r1 with negative displacement
+			{
+				functionStart = addr;
+				break;
+			}
+		}
+	}
+	s_functionStartCache.emplace(address, functionStart);
+	return functionStart;
+}
+
+// returns the entry address of the function which contains the address
+// recompiled functions are exact, for interpreted code the start is a guess. Falls back to the address itself
+static MPTR PPCSamplingProfiler_resolveFunction(MPTR address)
+{
+	ppcRecompilerFuncRange_t ranges[4];
+	size_t rangeCount = 4;
+	PPCRecompiler_findFuncRanges(address, ranges, &rangeCount);
+	ppcRecompilerFuncRange_t funcRange;
+	if (rangeCount > 0 && PPCRecompiler_findFuncByHostAddress(ranges[0].x86Start, funcRange))
+		return funcRange.ppcStart;
+	return PPCSamplingProfiler_findFunctionStart(address);
+}
+
+static std::string PPCSamplingProfiler_readThreadName(MPTR threadAddr)
+{
+	OSThread_t* thread = (OSThread_t*)memory_getPointerFromVirtualOffset(threadAddr);
+	std::string name;
+	if (const char* guestName = thread->threadName.GetPtr())
+	{
+		for (size_t i = 0; i < 64 && guestName[i] != '\0'; i++)
+			name.push_back((guestName[i] == ';' || (uint8)guestName[i] < 0x20) ? '_' : guestName[i]);
+	}
+	if (name.empty())
+		name = "Thread";
+	return fmt::format("{} [{:08x}]", name, threadAddr);
+}
+
+static void PPCSamplingProfiler_processSample(const PPCCoreSample& sample)
+{
+	if (!sample.isValid)
+	{
+		s_idleSampleCount++;
+		return;
+	}
+	MPTR function;
+	ppcRecompilerFuncRange_t funcRange;
+	if (sample.hostPC != 0 && PPCRecompiler_findFuncByHostAddress((const void*)sample.hostPC, funcRange))
+		function = funcRange.ppcStart;
+	else
+		function = PPCSamplingProfiler_resolveFunction(sample.instructionPointer);
+	// return addresses point behind the branch, step back so that the address is inside the calling function
+	std::vector<MPTR> stack;
+	stack.reserve(sample.returnAddressCount + 2);
+	stack.emplace_back(function);
+	// the first return address on the back chain belongs to the caller of the sampled function, unless it is a leaf function which never set up a frame or saved LR
+	// in that case LR is the only record of the caller. If LR resolves to the sampled function itself it is stale from an earlier call and is ignored
+	MPTR firstChainCaller = sample.returnAddressCount > 0 ? PPCSamplingProfiler_resolveFunction(sample.returnAddresses[0] - 4) : 0;
+	if (sample.linkRegister >= 4)
+	{
+		MPTR lrCaller = PPCSamplingProfiler_resolveFunction(sample.linkRegister - 4);
+		if (lrCaller != function && lrCaller != firstChainCaller)
+			stack.emplace_back(lrCaller);
+	}
+	for (uint32 i = 0; i < sample.returnAddressCount; i++)
+		stack.emplace_back(i == 0 ? firstChainCaller : PPCSamplingProfiler_resolveFunction(sample.returnAddresses[i] - 4));
+	std::reverse(stack.begin(), stack.end());
+	auto itr = s_threadProfiles.find(sample.thread);
+	if (itr == s_threadProfiles.end())
+	{
+		itr = s_threadProfiles.try_emplace(sample.thread).first;
+		itr->second.name = PPCSamplingProfiler_readThreadName(sample.thread);
+	}
+	PPCThreadProfile& profile = itr->second;
+	profile.sampleCount++;
+	profile.stacks[std::move(stack)]++;
+}
+
+static void PPCSamplingProfiler_samplerThread()
+{
+	SetThreadName("PPCSampler");
+	PPCCoreSample samples[Espresso::CORE_COUNT];
+	while (!s_stopRequested.load())
+	{
+		std::this_thread::sleep_for(std::chrono::microseconds(s_intervalMicroseconds));
+		uint32 capturedCoreMask = 0;
+		coreinit::__OSForEachSchedulerHostThread([&](std::thread::native_handle_type handle, uint32 firstCoreIndex, uint32 coreCount) {
+			uint32 requestId;
+			if (!PPCSamplingProfiler_captureHostThread(handle, firstCoreIndex, coreCount, requestId))
+			{
+				s_missedSampleCount++;
+				return;
+			}
+			for (uint32 i = firstCoreIndex; i < firstCoreIndex + coreCount; i++)
+			{
+				samples[i] = s_coreSamples[i];
+				if (samples[i].requestId != requestId)
+				{
+					s_missedSampleCount++;
+					continue;
+				}
+				capturedCoreMask |= (1 << i);
+			}
+		});
+		// symbol and recompiler lookups take locks, so they only happen after all threads are running again
+		for (uint32 i = 0; i < Espresso::CORE_COUNT; i++)
+		{
+			if (capturedCoreMask & (1 << i))
+				PPCSamplingProfiler_processSample(samples[i]);
+		}
+	}
+}
+
+bool PPCSamplingProfiler::IsRunning()
+{
+	return s_isRunning.load();
+}
+
+void PPCSamplingProfiler::Start(uint32 intervalMicroseconds)
+{
+	if (s_isRunning.exchange(true))
+		return;
+	s_threadProfiles.clear();
+	s_idleSampleCount = 0;
+	s_missedSampleCount = 0;
+	s_samplerSymbols = std::make_unique<PPCSamplingProfilerSymbolizer>();
+	s_functionStartCache.clear();
+	s_intervalMicroseconds = std::max<uint32>(intervalMicroseconds, 100);
+	s_startTick = HighResolutionTimer::now().getTick();
+#if !BOOST_OS_WINDOWS
+	struct sigaction sa{};
+	sa.sa_sigaction = PPCSamplingProfiler_signalHandler;
+	sa.sa_flags = SA_SIGINFO | SA_RESTART;
+	sigemptyset(&sa.sa_mask);
+	sigaction(SIGPROF, &sa, nullptr);
+#endif
+	s_stopRequested = false;
+	s_samplerThread = std::thread(PPCSamplingProfiler_samplerThread);
+}
+
+bool PPCSamplingProfiler::Stop(const fs::path& basePath)
+{
+	if (!s_isRunning.load())
+		return false;
+	s_stopRequested = true;
+	s_samplerThread.join();
+#if !BOOST_OS_WINDOWS
+	// a signal for a request which timed out can still be pending. The default action would terminate the process, ignoring it also discards any pending one
+	struct sigaction sa{};
+	sa.sa_handler = SIG_IGN;
+	sigemptyset(&sa.sa_mask);
+	sigaction(SIGPROF, &sa, nullptr);
+#endif
+	s_isRunning = false;
+	s_samplerSymbols.reset();
+	s_functionStartCache.clear();
+	double duration = HighResolutionTimer::getTimeDiff(s_startTick, HighResolutionTimer::now().getTick());
+
+	PPCSamplingProfilerSymbolizer symbolizer;
+	std::vector<std::pair<MPTR, PPCThreadProfile*>> threads;
+	uint32 totalSampleCount = 0;
+	for (auto& it : s_threadProfiles)
+	{
+		threads.emplace_back(it.first, &it.second);
+		totalSampleCount += it.second.sampleCount;
+	}
+	std::sort(threads.begin(), threads.end(), [](const auto& a, const auto& b) { return a.second->sampleCount > b.second->sampleCount; });
+
+	fs::path foldedPath = basePath;
+	foldedPath.replace_extension(".folded");
+	fs::path flatPath = basePath;
+	flatPath.replace_extension(".txt");
+	std::unique_ptr<FileStream> foldedFile(FileStream::createFile2(foldedPath));
+	std::unique_ptr<FileStream> flatFile(FileStream::createFile2(flatPath));
+	if (!foldedFile || !flatFile)
+	{
+		cemuLog_log(LogType::Force, "PPCSamplingProfiler: Unable to create {}", _pathToUtf8(basePath));
+		return false;
+	}
+
+	std::string flat = fmt::format("PPC sampling profile: {} samples in {:.1f}s ({}us interval), {} idle, {} missed\n", totalSampleCount, duration, s_intervalMicroseconds, s_idleSampleCount, s_missedSampleCount);
+	for (auto& [threadAddr, profile] : threads)
+	{
+		// collapsed stacks: thread;outermost;...;function count
+		std::unordered_map<MPTR, uint32> selfSamples;
+		std::string folded;
+		for (auto& [stack, count] : profile->stacks)
+		{
+			selfSamples[stack.back()] += count;
+			folded.append(profile->name);
+			for (MPTR function : stack)
+			{
+				folded.push_back(';');
+				folded.append(symbolizer.GetName(function));
+			}
+			folded.append(fmt::format(" {}\n", count));
+		}
+		foldedFile->writeData(folded.data(), (sint32)folded.size());
+		// flat profile, sorted by samples
+		std::vector<std::pair<MPTR, uint32>> functions(selfSamples.begin(), selfSamples.end());
+		std::sort(functions.begin(), functions.end(), [](const auto& a, const auto& b) { return a.second > b.second; });
+		flat.append(fmt::format("\n{}: {} samples ({:.1f}%)\n", profile->name, profile->sampleCount, totalSampleCount ? profile->sampleCount * 100.0 / totalSampleCount : 0.0));
+		for (size_t i = 0; i < functions.size() && i < 50; i++)
+			flat.append(fmt::format("  {:6.2f}% {:8} {}\n", functions[i].second * 100.0 / profile->sampleCount, functions[i].second, symbolizer.GetName(functions[i].first)));
+	}
+	flatFile->writeData(flat.data(), (sint32)flat.size());
+	s_threadProfiles.clear();
+	cemuLog_log(LogType::Force, "PPCSamplingProfiler: Wrote {} samples to {}", totalSampleCount, _pathToUtf8(foldedPath));
+	return true;
+}
@@ -0,0 +1,14 @@
+#pragma once
+
+// periodically interrupts the host threads emulating the PPC cores and records the instruction pointer and LR of the loaded guest thread
+// recompiled code is attributed via the host PC of the interrupted thread, interpreted code via the PPC instruction pointer
+// samples are aggregated per OSThread_t into a flat profile and caller -> function pairs (the caller is derived from LR and therefore approximate)
+class PPCSamplingProfiler
+{
+public:
+	static bool IsRunning();
+
+	static void Start(uint32 intervalMicroseconds = 1000);
+	// stops sampling and writes <basePath>.folded (collapsed stacks, can be fed to flamegraph tools) and <basePath>.txt (flat profile per thread)
+	static bool Stop(const fs::path& basePath);
+};
@@ -3,6 +3,7 @@
 #include "PPCRecompiler.h"
 #include "PPCRecompilerIml.h"
 #include "Cafe/OS/RPL/rpl.h"
+#include "Cafe/OS/RPL/rpl_symbol_storage.h"
 #include "util/containers/RangeStore.h"
 #include "Cafe/OS/libs/coreinit/coreinit_CodeGen.h"
 #include "config/ActiveSettings.h"
@@ -12,6 +13,8 @@
 #include "util/helpers/fspinlock.h"
 #include "util/helpers/helpers.h"
 #include "util/MemMapper/MemMapper.h"
+#include "util/ThreadPool/ThreadPool.h"
+#include "util/TraceRecorder/TraceRecorder.h"
 
 #include "IML/IML.h"
 #include "IML/IMLRegisterAllocator.h"
@@ -40,6 +43,8 @@ struct
 }PPCRecompilerState;
 
 RangeStore<PPCRecFunction_t*, uint32, 7703, 0x2000> rangeStore_ppcRanges;
+// active functions by the start of their host code, protected by recompilerSpinlock
+static std::map<uintptr_t, PPCRecFunction_t*> s_ppcFunctionsByHostCode;
 
 void ATTR_MS_ABI (*PPCRecompiler_enterRecompilerCode)(uint64 codeMem, uint64 ppcInterpreterInstance);
 void ATTR_MS_ABI (*PPCRecompiler_leaveRecompilerCode_visited)();
@@ -51,9 +56,46 @@ PPCRecompilerInstanceData_t* ppcRecompilerInstanceData;
 static std::mutex s_singleRecompilationMutex;
 #endif
 
+#if BOOST_OS_LINUX
+// perf map (/tmp/perf-<pid>.map) which lets Linux perf symbolize samples in recompiled code
+// only written if enabled via --perf-map. The file stays open for the lifetime of the process since perf reads it after the process exited
+static std::mutex s_perfMapMutex;
+static FileStream* s_perfMapFile{};
+
+static void PPCRecompiler_perfMapInit()
+{
+	std::unique_lock _l(s_perfMapMutex);
+	if (s_perfMapFile)
+		return;
+	fs::path path = fmt::format("/tmp/perf-{}.map", getpid());
+	s_perfMapFile = FileStream::createFile2(path);
+	if (!s_perfMapFile)
+		cemuLog_log(LogType::Force, "Recompiler: Unable to create perf map {}", _pathToUtf8(path));
+}
+
+static void PPCRecompiler_perfMapAddFunction(PPCRecFunction_t* ppcRecFunc)
+{
+	// name functions after their RPL export where possible
+	std::string name;
+	auto& symbolMap = rplSymbolStorage_lockSymbolMap();
+	auto itr = symbolMap.find(ppcRecFunc->ppcAddress);
+	if (itr != symbolMap.end() && itr->second)
+		name = fmt::format("{}::{} [ppc_{:08x}]", (const char*)itr->second->libName, (const char*)itr->second->symbolName, ppcRecFunc->ppcAddress);
+	else
+		name = fmt::format("ppc_{:08x}", ppcRecFunc->ppcAddress);
+	rplSymbolStorage_unlockSymbolMap();
+	// the perf map format can't express unloading, so entries of functions which get invalidated later are left behind
+	std::string line = fmt::format("{:x} {:x} {}\n", (uintptr_t)ppcRecFunc->x86Code, ppcRecFunc->x86Size, name);
+	std::unique_lock _l(s_perfMapMutex);
+	s_perfMapFile->writeData(line.data(), (sint32)line.size());
+	s_perfMapFile->Flush();
+}
+#endif
+
 bool ppcRecompilerEnabled = false;
 
 void PPCRecompiler_recompileAtAddress(uint32 address);
+void PPCRecompiler_queueRecompilerTask();
 
 // this function does never block and can fail if the recompiler lock cannot be acquired immediately
 void PPCRecompiler_visitAddressNoBlock(uint32 enterAddress)
@@ -95,6 +137,7 @@ void PPCRecompiler_visitAddressNoBlock(uint32 enterAddress)
 	ppcRecompilerInstanceData->ppcRecompilerDirectJumpTable[enterAddress / 4] = PPCRecompiler_leaveRecompilerCode_visited;
 
 	PPCRecompilerState.recompilerSpinlock.unlock();
+	PPCRecompiler_queueRecompilerTask();
 }
 
 void PPCRecompiler_recompileIfUnvisited(uint32 enterAddress)
@@ -407,8 +450,13 @@ bool PPCRecompiler_makeRecompiledFunctionActive(uint32 initialEntryPoint, PPCFun
 	{
 		r.storedRange = rangeStore_ppcRanges.storeRange(ppcRecFunc, r.ppcAddress, r.ppcAddress + r.ppcSize);
 	}
+	s_ppcFunctionsByHostCode[(uintptr_t)ppcRecFunc->x86Code] = ppcRecFunc;
 	PPCRecompilerState.recompilerSpinlock.unlock();
 
+#if BOOST_OS_LINUX
+	if (s_perfMapFile)
+		PPCRecompiler_perfMapAddFunction(ppcRecFunc);
+#endif
 
 	return true;
 }
@@ -416,6 +464,7 @@ bool PPCRecompiler_makeRecompiledFunctionActive(uint32 initialEntryPoint, PPCFun
 void PPCRecompiler_recompileAtAddress(uint32 address)
 {
 	cemu_assert_debug(ppcRecompilerInstanceData->ppcRecompilerDirectJumpTable[address / 4] == PPCRecompiler_leaveRecompilerCode_visited);
+	TraceRecorder::Scope traceScope("recompiler", "RecompileFunction", "address", address, TraceRecorder::ArgFormat::Hex);
 
 	// get size
 	PPCFunctionBoundaryTracker funcBoundaries;
@@ -448,27 +497,23 @@ void PPCRecompiler_recompileAtAddress(uint32 address)
 	bool r = PPCRecompiler_makeRecompiledFunctionActive(address, range, func, functionEntryPoints);
 }
 
-std::thread s_threadRecompiler;
-std::atomic_bool s_recompilerThreadStopSignal{false};
+ThreadPool::TaskGroup s_recompilerTaskGroup;
+std::atomic_bool s_recompilerTaskQueued{false};
+std::atomic_bool s_recompilerStopSignal{false};
 
-void PPCRecompiler_thread()
+// asynchronous recompilation:
+// 1) take address from queue
+// 2) check if address is still marked as visited
+// 3) if yes -> calculate size, gather all entry points, recompile and update jump table
+// only one task is queued at a time, so functions are never recompiled concurrently
+void PPCRecompiler_recompilerTask()
 {
-	SetThreadName("PPCRecompiler");
-#if PPCREC_FORCE_SYNCHRONOUS_COMPILATION
-	return;
-#endif
-
 	while (true)
 	{
-        if(s_recompilerThreadStopSignal)
-            return;
-		std::this_thread::sleep_for(std::chrono::milliseconds(10));
-		// asynchronous recompilation:
-		// 1) take address from queue
-		// 2) check if address is still marked as visited
-		// 3) if yes -> calculate size, gather all entry points, recompile and update jump table
 		while (true)
 		{
+			if (s_recompilerStopSignal)
+				return;
 			PPCRecompilerState.recompilerSpinlock.lock();
 			if (PPCRecompilerState.targetQueue.empty())
 			{
@@ -488,12 +533,25 @@ void PPCRecompiler_thread()
 			PPCRecompilerState.recompilerSpinlock.unlock();
 
 			PPCRecompiler_recompileAtAddress(enterAddress);
-			if(s_recompilerThreadStopSignal)
-				return;
 		}
+		s_recompilerTaskQueued = false;
+		// an address may have been queued after the queue was seen empty but before the flag was cleared
+		PPCRecompilerState.recompilerSpinlock.lock();
+		bool hasPendingAddresses = !PPCRecompilerState.targetQueue.empty();
+		PPCRecompilerState.recompilerSpinlock.unlock();
+		if (!hasPendingAddresses || s_recompilerTaskQueued.exchange(true))
+			return;
 	}
 }
 
+void PPCRecompiler_queueRecompilerTask()
+{
+	if (s_recompilerTaskQueued.exchange(true))
+		return;
+	// give the emulated cores a moment to visit more entry points so they are handled in one batch
+	ThreadPool::SubmitDelayed(ThreadPool::Priority::High, std::chrono::milliseconds(10), PPCRecompiler_recompilerTask, &s_recompilerTaskGroup);
+}
+
 #define PPC_REC_ALLOC_BLOCK_SIZE	(4*1024*1024) // 4MB
 
 constexpr uint32 PPCRecompiler_GetNumAddressSpaceBlocks()
@@ -540,14 +598,6 @@ void PPCRecompiler_allocateRange(uint32 startAddress, uint32 size)
 	}
 }
 
-struct ppcRecompilerFuncRange_t
-{
-	MPTR	ppcStart;
-	uint32  ppcSize;
-	void*   x86Start;
-	size_t  x86Size;
-};
-
 bool PPCRecompiler_findFuncRanges(uint32 addr, ppcRecompilerFuncRange_t* rangesOut, size_t* countInOut)
 {
 	PPCRecompilerState.recompilerSpinlock.lock();
@@ -573,6 +623,30 @@ bool PPCRecompiler_findFuncRanges(uint32 addr, ppcRecompilerFuncRange_t* rangesO
 	return true;
 }
 
+bool PPCRecompiler_findFuncByHostAddress(const void* hostAddr, ppcRecompilerFuncRange_t& rangeOut)
+{
+	PPCRecompilerState.recompilerSpinlock.lock();
+	auto itr = s_ppcFunctionsByHostCode.upper_bound((uintptr_t)hostAddr);
+	if (itr == s_ppcFunctionsByHostCode.begin())
+	{
+		PPCRecompilerState.recompilerSpinlock.unlock();
+		return false;
+	}
+	--itr;
+	PPCRecFunction_t* func = itr->second;
+	if ((uintptr_t)hostAddr >= (uintptr_t)func->x86Code + func->x86Size)
+	{
+		PPCRecompilerState.recompilerSpinlock.unlock();
+		return false;
+	}
+	rangeOut.ppcStart = func->ppcAddress;
+	rangeOut.ppcSize = func->ppcSize;
+	rangeOut.x86Start = func->x86Code;
+	rangeOut.x86Size = func->x86Size;
+	PPCRecompilerState.recompilerSpinlock.unlock();
+	return true;
+}
+
 extern "C" DLLEXPORT uintptr_t * PPCRecompiler_getJumpTableBase()
 {
 	if (ppcRecompilerInstanceData == nullptr)
@@ -602,6 +676,7 @@ void PPCRecompiler_deleteFunction(PPCRecFunction_t* func)
 			rangeStore_ppcRanges.deleteRange(r.storedRange);
 		r.storedRange = nullptr;
 	}
+	s_ppcFunctionsByHostCode.erase((uintptr_t)func->x86Code);
 	// todo - free x86 code
 }
 
@@ -714,28 +789,33 @@ void PPCRecompiler_init()
     PPCRecompiler_allocateRange(mmuRange_CODECAVE.getBase(), mmuRange_CODECAVE.getSize());
 
     PPCRecompiler_initPlatform();
+
+#if BOOST_OS_LINUX
+	if (LaunchSettings::PerfMapEnabled())
+		PPCRecompiler_perfMapInit();
+#endif
     
 	cemuLog_log(LogType::Force, "Recompiler initialized");
 
 	ppcRecompilerEnabled = true;
 
-	// launch recompilation thread
-    s_recompilerThreadStopSignal = false;
-    s_threadRecompiler = std::thread(PPCRecompiler_thread);
+	// recompilation runs as a task on the shared thread pool, queued once the first address is visited
+	s_recompilerStopSignal = false;
 }
 
 void PPCRecompiler_Shutdown()
 {
-    // shut down recompiler thread
-    s_recompilerThreadStopSignal = true;
-    if(s_threadRecompiler.joinable())
-        s_threadRecompiler.join();
+    // wait for the recompiler task to exit
+    s_recompilerStopSignal = true;
+    s_recompilerTaskGroup.Wait();
+    s_recompilerTaskQueued = false;
     // clean up queues
     while(!PPCRecompilerState.targetQueue.empty())
         PPCRecompilerState.targetQueue.pop();
     PPCRecompilerState.invalidationRanges.clear();
     // clean range store
     rangeStore_ppcRanges.clear();
+    s_ppcFunctionsByHostCode.clear();
     // clean up memory
     uint32 numBlocks = PPCRecompiler_GetNumAddressSpaceBlocks();
     for(uint32 i=0; i<numBlocks; i++)
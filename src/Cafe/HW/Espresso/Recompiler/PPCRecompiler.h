@@ -151,6 +151,18 @@ void PPCRecompiler_allocateRange(uint32 startAddress, uint32 size);
 
 void PPCRecompiler_invalidateRange(uint32 startAddr, uint32 endAddr);
 
+struct ppcRecompilerFuncRange_t
+{
+	MPTR	ppcStart;
+	uint32  ppcSize;
+	void*   x86Start;
+	size_t  x86Size;
+};
+
+bool PPCRecompiler_findFuncRanges(uint32 addr, ppcRecompilerFuncRange_t* rangesOut, size_t* countInOut);
+// looks up the active function which contains the given host code address. ppcStart is set to the function's entry address
+bool PPCRecompiler_findFuncByHostAddress(const void* hostAddr, ppcRecompilerFuncRange_t& rangeOut);
+
 extern void ATTR_MS_ABI (*PPCRecompiler_enterRecompilerCode)(uint64 codeMem, uint64 ppcInterpreterInstance);
 extern void ATTR_MS_ABI (*PPCRecompiler_leaveRecompilerCode_visited)();
 extern void ATTR_MS_ABI (*PPCRecompiler_leaveRecompilerCode_unvisited)();
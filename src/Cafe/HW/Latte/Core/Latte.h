@@ -14,6 +14,13 @@ struct gx2GPUSharedArea_t
 	volatile uint32 swapInterval; // vsync swap interval (0 means vsync is deactivated)
 };
 
+// groups of registers for which modifications are tracked, see LatteGPUState_t::dirtyRegisterGroups
+#define LATTE_DIRTY_PIPELINE_STATE		(1 << 0) // context and config registers which are hashed into host pipeline state
+#define LATTE_DIRTY_VERTEX_STRIDE		(1 << 1) // stride word of the vertex attribute buffer resources
+#define LATTE_DIRTY_TEXTURE_SWIZZLE		(1 << 2) // word4 (swizzle and base level) of the texture resources
+#define LATTE_DIRTY_SAMPLER				(1 << 3) // sampler registers
+#define LATTE_DIRTY_ALL					(0xFFFFFFFF)
+
 struct LatteGPUState_t
 {
 	union
@@ -25,6 +32,8 @@ struct LatteGPUState_t
 	// context control
 	uint32 contextControl0;
 	uint32 contextControl1;
+	// set by register writes which change the value of a register in one of the LATTE_DIRTY_* groups. Renderers clear it once they invalidated their derived state
+	uint32 dirtyRegisterGroups;
 	// optional features
 	bool allowFramebufferSizeOptimization{false}; // allow using scissor box as size hint to determine non-padded rendertarget size
 	// stats
@@ -53,6 +62,7 @@ struct LatteGPUState_t
 	float drcGamma = 0.0f;
 	// draw state
 	bool activeShaderHasError; // if try, at least one currently bound shader stage has an error and cannot be used for drawing
+	bool activeShaderIsPending; // if true, at least one shader stage is still being decompiled asynchronously and drawing has to be skipped
 	bool repeatTextureInitialization; // if set during rendertarget or texture initialization, repeat the process (textures likely have been invalidated)
 	bool requiresTextureBarrier; // set if glTextureBarrier should be called
 	// OSScreen
@@ -117,6 +127,7 @@ void LatteTC_ResetTextureChangeTracker(LatteTexture* hostTexture, bool force = f
 
 void LatteTC_MarkTextureStillInUse(LatteTexture* texture); // lets the texture garbage collector know the texture is still in use at the time of this function call
 void LatteTC_CleanupUnusedTextures();
+void LatteTC_GetMemoryBudgetStats(uint64& usage, uint64& budget, uint32& evictionCount); // sizes in bytes, budget is 0 if unlimited
 
 std::vector<LatteTexture*> LatteTC_GetDeleteableTextures();
 
@@ -129,6 +140,9 @@ void LatteTextureReadback_StartTransfer(LatteTextureView* textureView);
 bool LatteTextureReadback_Update(bool forceStart = false);
 void LatteTextureReadback_NotifyTextureDeletion(LatteTexture* texture);
 void LatteTextureReadback_UpdateFinishedTransfers(bool forceFinish);
+void LatteTextureReadback_RetirePendingWrites(bool waitForAll);
+void LatteTextureReadback_WaitForPendingWrites(MPTR physAddress, uint32 size);
+bool LatteTextureReadback_RetireOldest();
 
 // query
 
@@ -937,6 +937,7 @@ BufferCacheNode* LatteBufferCache_reserveRange(MPTR physAddress, uint32 size)
 
 uint32 LatteBufferCache_retrieveDataInCache(MPTR physAddress, uint32 size)
 {
+	LatteTextureReadback_WaitForPendingWrites(physAddress, size);
 	auto range = LatteBufferCache_reserveRange(physAddress, size);
 	range->flagInUse();
 
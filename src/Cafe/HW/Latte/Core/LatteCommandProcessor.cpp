@@ -288,17 +288,40 @@ void LatteCP_itSetRegistersGeneric_handleSpecialRanges(uint32 registerStartIndex
 	}
 }
 
+// maps every register to the LATTE_DIRTY_* groups it belongs to
+// must cover every register which is read when the renderers hash pipeline or descriptor state (e.g. VulkanRenderer::draw_calculateGraphicsPipelineHash)
+static const std::array<uint8, LATTE_MAX_REGISTER> s_registerDirtyGroups = []()
+{
+	std::array<uint8, LATTE_MAX_REGISTER> groups{};
+	for (uint32 reg : {(uint32)mmVGT_PRIMITIVE_TYPE, (uint32)mmVGT_STRMOUT_EN, (uint32)Latte::REGADDR::PA_SU_SC_MODE_CNTL, (uint32)Latte::REGADDR::PA_CL_CLIP_CNTL,
+		(uint32)Latte::REGADDR::CB_COLOR_CONTROL, (uint32)Latte::REGADDR::CB_TARGET_MASK, (uint32)Latte::REGADDR::DB_DEPTH_CONTROL, (uint32)mmDB_STENCILREFMASK, (uint32)mmDB_STENCILREFMASK_BF})
+		groups[reg] |= LATTE_DIRTY_PIPELINE_STATE;
+	for (uint32 i = 0; i < 8; i++)
+		groups[Latte::REGADDR::CB_BLEND0_CONTROL + i] |= LATTE_DIRTY_PIPELINE_STATE;
+	for (uint32 reg = mmSQ_VTX_ATTRIBUTE_BLOCK_START; reg < mmSQ_VTX_ATTRIBUTE_BLOCK_END; reg += 7)
+		groups[reg + 2] |= LATTE_DIRTY_VERTEX_STRIDE;
+	for (uint32 stageBase : {(uint32)Latte::REGADDR::SQ_TEX_RESOURCE_WORD0_N_PS, (uint32)Latte::REGADDR::SQ_TEX_RESOURCE_WORD0_N_VS, (uint32)Latte::REGADDR::SQ_TEX_RESOURCE_WORD0_N_GS})
+	{
+		for (uint32 i = 0; i < Latte::GPU_LIMITS::NUM_TEXTURES_PER_STAGE; i++)
+			groups[stageBase + i * 7 + 4] |= LATTE_DIRTY_TEXTURE_SWIZZLE;
+	}
+	for (uint32 reg = LATTE_REG_BASE_SAMPLER; reg < LATTE_REG_BASE_LOOP_CONST; reg++)
+		groups[reg] |= LATTE_DIRTY_SAMPLER;
+	return groups;
+}();
+
+// uniform and control constants are never part of hashed state, skip the tracking for them
 template<uint32 TRegisterBase>
-LatteCMDPtr LatteCP_itSetRegistersGeneric(LatteCMDPtr cmd, uint32 nWords)
+constexpr bool LatteCP_hasDirtyTrackedRegisters()
+{
+	return TRegisterBase == LATTE_REG_BASE_CONTEXT || TRegisterBase == LATTE_REG_BASE_CONFIG || TRegisterBase == LATTE_REG_BASE_RESOURCE || TRegisterBase == LATTE_REG_BASE_SAMPLER;
+}
+
+template<uint32 TRegisterBase>
+LatteCMDPtr LatteCP_itSetRegistersGeneric_writeRegisters(LatteCMDPtr cmd, uint32 registerIndex, uint32 nWords)
 {
-	uint32 registerOffset = LatteReadCMD();
-	uint32 registerIndex = TRegisterBase + registerOffset;
-	uint32 registerStartIndex = registerIndex;
-	uint32 registerEndIndex = registerStartIndex + nWords;
-#ifdef CEMU_DEBUG_ASSERT
-	cemu_assert_debug((registerIndex + nWords) <= LATTE_MAX_REGISTER);
-#endif
 	uint32* outputReg = (uint32*)(LatteGPUState.contextRegister + registerIndex);
+	uint32 dirtyGroups = 0;
 	if (LatteGPUState.contextControl0 == 0x80000077)
 	{
 		// state shadowing enabled
@@ -310,6 +333,11 @@ LatteCMDPtr LatteCP_itSetRegistersGeneric(LatteCMDPtr cmd, uint32 nWords)
 			MPTR regShadowAddr = shadowAddrs[indexCounter];
 			if (regShadowAddr)
 				*(uint32*)(memory_base + regShadowAddr) = _swapEndianU32(dataWord);
+			if constexpr (LatteCP_hasDirtyTrackedRegisters<TRegisterBase>())
+			{
+				if (outputReg[indexCounter] != dataWord)
+					dirtyGroups |= s_registerDirtyGroups[registerIndex + indexCounter];
+			}
 			outputReg[indexCounter] = dataWord;
 			indexCounter++;
 		}
@@ -320,10 +348,31 @@ LatteCMDPtr LatteCP_itSetRegistersGeneric(LatteCMDPtr cmd, uint32 nWords)
 		sint32 indexCounter = 0;
 		while (--nWords)
 		{
-			*outputReg = LatteReadCMD();
-			outputReg++;
+			uint32 dataWord = LatteReadCMD();
+			if constexpr (LatteCP_hasDirtyTrackedRegisters<TRegisterBase>())
+			{
+				if (outputReg[indexCounter] != dataWord)
+					dirtyGroups |= s_registerDirtyGroups[registerIndex + indexCounter];
+			}
+			outputReg[indexCounter] = dataWord;
+			indexCounter++;
 		}
 	}
+	LatteGPUState.dirtyRegisterGroups |= dirtyGroups;
+	return cmd;
+}
+
+template<uint32 TRegisterBase>
+LatteCMDPtr LatteCP_itSetRegistersGeneric(LatteCMDPtr cmd, uint32 nWords)
+{
+	uint32 registerOffset = LatteReadCMD();
+	uint32 registerIndex = TRegisterBase + registerOffset;
+	uint32 registerStartIndex = registerIndex;
+	uint32 registerEndIndex = registerStartIndex + nWords;
+#ifdef CEMU_DEBUG_ASSERT
+	cemu_assert_debug((registerIndex + nWords) <= LATTE_MAX_REGISTER);
+#endif
+	cmd = LatteCP_itSetRegistersGeneric_writeRegisters<TRegisterBase>(cmd, registerIndex, nWords);
 	// some register writes trigger special behavior
 	LatteCP_itSetRegistersGeneric_handleSpecialRanges<TRegisterBase>(registerStartIndex, registerEndIndex);
 	return cmd;
@@ -341,32 +390,7 @@ LatteCMDPtr LatteCP_itSetRegistersGeneric(LatteCMDPtr cmd, uint32 nWords, TRegRa
 #endif
 	cbRegRange(registerStartIndex, registerEndIndex);
 
-	uint32* outputReg = (uint32*)(LatteGPUState.contextRegister + registerIndex);
-	if (LatteGPUState.contextControl0 == 0x80000077)
-	{
-		// state shadowing enabled
-		uint32* shadowAddrs = LatteGPUState.contextRegisterShadowAddr + registerIndex;
-		sint32 indexCounter = 0;
-		while (--nWords)
-		{
-			uint32 dataWord = LatteReadCMD();
-			MPTR regShadowAddr = shadowAddrs[indexCounter];
-			if (regShadowAddr)
-				*(uint32*)(memory_base + regShadowAddr) = _swapEndianU32(dataWord);
-			outputReg[indexCounter] = dataWord;
-			indexCounter++;
-		}
-	}
-	else
-	{
-		// state shadowing disabled
-		sint32 indexCounter = 0;
-		while (--nWords)
-		{
-			*outputReg = LatteReadCMD();
-			outputReg++;
-		}
-	}
+	cmd = LatteCP_itSetRegistersGeneric_writeRegisters<TRegisterBase>(cmd, registerIndex, nWords);
 	// some register writes trigger special behavior
 	LatteCP_itSetRegistersGeneric_handleSpecialRanges<TRegisterBase>(registerStartIndex, registerEndIndex);
 	return cmd;
@@ -633,6 +657,8 @@ LatteCMDPtr LatteCP_itLoadReg(LatteCMDPtr cmd, uint32 nWords, uint32 regBase)
 			regShadowMemAddr += 4;
 		}
 	}
+	// not worth tracking per register, loads happen rarely and usually restore a large part of the state
+	LatteGPUState.dirtyRegisterGroups = LATTE_DIRTY_ALL;
 	return cmd;
 }
 
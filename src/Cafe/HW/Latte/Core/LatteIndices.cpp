@@ -139,6 +139,590 @@ uint32 LatteIndices_calculateIndexOutputSize(LattePrimitiveMode primitiveMode, L
 	return 0;
 }
 
+// cleared by the self check to get the results of the scalar loops
+static bool s_useSIMDKernels = true;
+
+void LatteIndices_setSIMDEnabled(bool isEnabled)
+{
+	s_useSIMDKernels = isEnabled;
+}
+
+static bool LatteIndices_useSIMD()
+{
+#if defined(ARCH_X86_64)
+	return s_useSIMDKernels && g_CPUFeatures.x86.sse4_1 && g_CPUFeatures.x86.ssse3;
+#elif defined(__aarch64__)
+	return s_useSIMDKernels;
+#else
+	return false;
+#endif
+}
+
+// SIMD kernels (SSE4.1 or NEON) for the primitive modes which need their indices reordered and for the primitive restart aware min/max scan
+// they only process whole blocks and return how much they processed, the scalar loops of the callers handle the remainder
+// indices are byte swapped right after loading, the reordering is done with shuffles on the swapped data
+#if defined(ARCH_X86_64)
+// gathers eight U16 lanes, -1 writes zero
+ATTRIBUTE_SSE41
+inline __m128i LatteIndices_shuffleMaskU16(sint8 w0, sint8 w1, sint8 w2, sint8 w3, sint8 w4, sint8 w5, sint8 w6, sint8 w7)
+{
+	return _mm_setr_epi8(w0 * 2, w0 * 2 + 1, w1 * 2, w1 * 2 + 1, w2 * 2, w2 * 2 + 1, w3 * 2, w3 * 2 + 1,
+		w4 * 2, w4 * 2 + 1, w5 * 2, w5 * 2 + 1, w6 * 2, w6 * 2 + 1, w7 * 2, w7 * 2 + 1);
+}
+
+template<typename T>
+ATTRIBUTE_SSE41
+inline __m128i LatteIndices_loadSwappedSSE41(const betype<T>* src)
+{
+	__m128i v = _mm_loadu_si128((const __m128i*)src);
+	if constexpr (sizeof(T) == 2)
+		return _mm_shuffle_epi8(v, _mm_setr_epi8(1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14));
+	else
+		return _mm_shuffle_epi8(v, _mm_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12));
+}
+
+template<typename T>
+ATTRIBUTE_SSE41
+inline __m128i LatteIndices_minSSE41(__m128i a, __m128i b)
+{
+	if constexpr (sizeof(T) == 2)
+		return _mm_min_epu16(a, b);
+	else
+		return _mm_min_epu32(a, b);
+}
+
+template<typename T>
+ATTRIBUTE_SSE41
+inline __m128i LatteIndices_maxSSE41(__m128i a, __m128i b)
+{
+	if constexpr (sizeof(T) == 2)
+		return _mm_max_epu16(a, b);
+	else
+		return _mm_max_epu32(a, b);
+}
+
+template<typename T>
+ATTRIBUTE_SSE41
+inline void LatteIndices_reduceMinMaxSSE41(__m128i vMin, __m128i vMax, uint32& indexMin, uint32& indexMax)
+{
+	if constexpr (sizeof(T) == 2)
+	{
+		indexMin = std::min(indexMin, (uint32)_mm_extract_epi16(_mm_minpos_epu16(vMin), 0));
+		indexMax = std::max(indexMax, 0xFFFF - (uint32)_mm_extract_epi16(_mm_minpos_epu16(_mm_xor_si128(vMax, _mm_set1_epi32(-1))), 0));
+	}
+	else
+	{
+		vMin = _mm_min_epu32(vMin, _mm_shuffle_epi32(vMin, _MM_SHUFFLE(1, 0, 3, 2)));
+		vMin = _mm_min_epu32(vMin, _mm_shuffle_epi32(vMin, _MM_SHUFFLE(2, 3, 0, 1)));
+		vMax = _mm_max_epu32(vMax, _mm_shuffle_epi32(vMax, _MM_SHUFFLE(1, 0, 3, 2)));
+		vMax = _mm_max_epu32(vMax, _mm_shuffle_epi32(vMax, _MM_SHUFFLE(2, 3, 0, 1)));
+		indexMin = std::min(indexMin, (uint32)_mm_cvtsi128_si32(vMin));
+		indexMax = std::max(indexMax, (uint32)_mm_cvtsi128_si32(vMax));
+	}
+}
+
+// a block is two input vectors (4 quads of U16 or 2 quads of U32) and three output vectors
+template<typename T>
+ATTRIBUTE_SSE41
+sint32 LatteIndices_unpackQuadsAndConvert_SSE41(const betype<T>* src, T* dst, sint32 numQuads, uint32& indexMin, uint32& indexMax)
+{
+	constexpr sint32 indicesPerVector = 16 / sizeof(T);
+	constexpr sint32 quadsPerBlock = indicesPerVector / 2;
+	sint32 numBlocks = numQuads / quadsPerBlock;
+	if (numBlocks == 0)
+		return 0;
+	__m128i vMin = _mm_set1_epi32(-1);
+	__m128i vMax = _mm_setzero_si128();
+	for (sint32 i = 0; i < numBlocks; i++)
+	{
+		__m128i a = LatteIndices_loadSwappedSSE41<T>(src);
+		__m128i b = LatteIndices_loadSwappedSSE41<T>(src + indicesPerVector);
+		vMin = LatteIndices_minSSE41<T>(vMin, LatteIndices_minSSE41<T>(a, b));
+		vMax = LatteIndices_maxSSE41<T>(vMax, LatteIndices_maxSSE41<T>(a, b));
+		__m128i o0, o1, o2;
+		if constexpr (sizeof(T) == 2)
+		{
+			o0 = _mm_shuffle_epi8(a, LatteIndices_shuffleMaskU16(0, 1, 2, 0, 2, 3, 4, 5));
+			o1 = _mm_or_si128(_mm_shuffle_epi8(a, LatteIndices_shuffleMaskU16(6, 4, 6, 7, -1, -1, -1, -1)), _mm_shuffle_epi8(b, LatteIndices_shuffleMaskU16(-1, -1, -1, -1, 0, 1, 2, 0)));
+			o2 = _mm_shuffle_epi8(b, LatteIndices_shuffleMaskU16(2, 3, 4, 5, 6, 4, 6, 7));
+		}
+		else
+		{
+			o0 = _mm_shuffle_epi32(a, _MM_SHUFFLE(0, 2, 1, 0));
+			o1 = _mm_alignr_epi8(b, a, 8);
+			o2 = _mm_shuffle_epi32(b, _MM_SHUFFLE(3, 2, 0, 2));
+		}
+		_mm_storeu_si128((__m128i*)dst + 0, o0);
+		_mm_storeu_si128((__m128i*)dst + 1, o1);
+		_mm_storeu_si128((__m128i*)dst + 2, o2);
+		src += indicesPerVector * 2;
+		dst += indicesPerVector * 3;
+	}
+	LatteIndices_reduceMinMaxSSE41<T>(vMin, vMax, indexMin, indexMax);
+	return numBlocks * quadsPerBlock;
+}
+
+// quads in a strip share two indices, a block advances by one input vector but also reads the first two indices of the next one
+template<typename T>
+ATTRIBUTE_SSE41
+sint32 LatteIndices_unpackQuadStripAndConvert_SSE41(const betype<T>* src, T* dst, uint32 count, sint32 numQuads, uint32& indexMin, uint32& indexMax)
+{
+	constexpr sint32 indicesPerVector = 16 / sizeof(T);
+	constexpr sint32 quadsPerBlock = indicesPerVector / 2;
+	// the second load must not read past the end of the index data
+	sint32 numBlocks = std::min(numQuads / quadsPerBlock, (sint32)(count / indicesPerVector) - 1);
+	if (numBlocks <= 0)
+		return 0;
+	__m128i vMin = _mm_set1_epi32(-1);
+	__m128i vMax = _mm_setzero_si128();
+	for (sint32 i = 0; i < numBlocks; i++)
+	{
+		__m128i a = LatteIndices_loadSwappedSSE41<T>(src);
+		__m128i b = LatteIndices_loadSwappedSSE41<T>(src + indicesPerVector);
+		__m128i o0, o1, o2;
+		__m128i bUsed; // only the first two indices of b belong to this block, the rest is replaced with lanes of a
+		if constexpr (sizeof(T) == 2)
+		{
+			o0 = _mm_shuffle_epi8(a, LatteIndices_shuffleMaskU16(0, 1, 2, 2, 1, 3, 2, 3));
+			o1 = _mm_shuffle_epi8(a, LatteIndices_shuffleMaskU16(4, 4, 3, 5, 4, 5, 6, 6));
+			o2 = _mm_or_si128(_mm_shuffle_epi8(a, LatteIndices_shuffleMaskU16(5, 7, 6, 7, -1, -1, 7, -1)), _mm_shuffle_epi8(b, LatteIndices_shuffleMaskU16(-1, -1, -1, -1, 0, 0, -1, 1)));
+			bUsed = _mm_blend_epi16(b, a, 0xFC);
+		}
+		else
+		{
+			o0 = _mm_shuffle_epi32(a, _MM_SHUFFLE(2, 2, 1, 0));
+			o1 = _mm_shuffle_epi32(a, _MM_SHUFFLE(3, 2, 3, 1));
+			o2 = _mm_shuffle_epi32(_mm_alignr_epi8(b, a, 12), _MM_SHUFFLE(2, 0, 1, 1));
+			bUsed = _mm_blend_epi16(b, a, 0xF0);
+		}
+		vMin = LatteIndices_minSSE41<T>(vMin, LatteIndices_minSSE41<T>(a, bUsed));
+		vMax = LatteIndices_maxSSE41<T>(vMax, LatteIndices_maxSSE41<T>(a, bUsed));
+		_mm_storeu_si128((__m128i*)dst + 0, o0);
+		_mm_storeu_si128((__m128i*)dst + 1, o1);
+		_mm_storeu_si128((__m128i*)dst + 2, o2);
+		src += indicesPerVector;
+		dst += indicesPerVector * 3;
+	}
+	LatteIndices_reduceMinMaxSSE41<T>(vMin, vMax, indexMin, indexMax);
+	return numBlocks * quadsPerBlock;
+}
+
+// the fan is emitted as alternating indices from the front and the back of the input. Returns the number of emitted index pairs
+template<typename T>
+ATTRIBUTE_SSE41
+sint32 LatteIndices_unpackTriangleFanAndConvert_SSE41(const betype<T>* src, T* dst, uint32 count, uint32& indexMin, uint32& indexMax)
+{
+	constexpr sint32 indicesPerVector = 16 / sizeof(T);
+	sint32 numBlocks = (sint32)(count / 2) / indicesPerVector;
+	if (numBlocks == 0)
+		return 0;
+	__m128i vMin = _mm_set1_epi32(-1);
+	__m128i vMax = _mm_setzero_si128();
+	const betype<T>* srcBack = src + count;
+	for (sint32 i = 0; i < numBlocks; i++)
+	{
+		srcBack -= indicesPerVector;
+		__m128i front = LatteIndices_loadSwappedSSE41<T>(src);
+		__m128i back = LatteIndices_loadSwappedSSE41<T>(srcBack);
+		vMin = LatteIndices_minSSE41<T>(vMin, LatteIndices_minSSE41<T>(front, back));
+		vMax = LatteIndices_maxSSE41<T>(vMax, LatteIndices_maxSSE41<T>(front, back));
+		if constexpr (sizeof(T) == 2)
+		{
+			back = _mm_shuffle_epi8(back, LatteIndices_shuffleMaskU16(7, 6, 5, 4, 3, 2, 1, 0));
+			_mm_storeu_si128((__m128i*)dst + 0, _mm_unpacklo_epi16(front, back));
+			_mm_storeu_si128((__m128i*)dst + 1, _mm_unpackhi_epi16(front, back));
+		}
+		else
+		{
+			back = _mm_shuffle_epi32(back, _MM_SHUFFLE(0, 1, 2, 3));
+			_mm_storeu_si128((__m128i*)dst + 0, _mm_unpacklo_epi32(front, back));
+			_mm_storeu_si128((__m128i*)dst + 1, _mm_unpackhi_epi32(front, back));
+		}
+		src += indicesPerVector;
+		dst += indicesPerVector * 2;
+	}
+	LatteIndices_reduceMinMaxSSE41<T>(vMin, vMax, indexMin, indexMax);
+	return numBlocks * indicesPerVector;
+}
+
+template<typename T>
+ATTRIBUTE_SSE41
+inline __m128i LatteIndices_addSSE41(__m128i a, __m128i b)
+{
+	if constexpr (sizeof(T) == 2)
+		return _mm_add_epi16(a, b);
+	else
+		return _mm_add_epi32(a, b);
+}
+
+// writes blockCount blocks of generated indices. getIndex(i) returns the i-th index of the sequence, which has to increase by a fixed amount per lane from one block to the next
+template<typename T, sint32 TVectorsPerBlock, typename TFunc>
+ATTRIBUTE_SSE41
+void LatteIndices_generateIndices_SSE41(T* dst, sint32 blockCount, TFunc getIndex)
+{
+	static_assert(TVectorsPerBlock == 1 || TVectorsPerBlock == 3);
+	constexpr sint32 indicesPerBlock = TVectorsPerBlock * 16 / sizeof(T);
+	T firstBlock[indicesPerBlock];
+	T blockIncrement[indicesPerBlock];
+	for (sint32 i = 0; i < indicesPerBlock; i++)
+	{
+		firstBlock[i] = (T)getIndex((uint32)i);
+		blockIncrement[i] = (T)(getIndex((uint32)(i + indicesPerBlock)) - getIndex((uint32)i));
+	}
+	// the vectors are kept in named variables so they stay in registers even without loop unrolling
+	__m128i v0 = _mm_loadu_si128((const __m128i*)firstBlock + 0);
+	__m128i increment0 = _mm_loadu_si128((const __m128i*)blockIncrement + 0);
+	if constexpr (TVectorsPerBlock == 1)
+	{
+		while (blockCount--)
+		{
+			_mm_storeu_si128((__m128i*)dst, v0);
+			v0 = LatteIndices_addSSE41<T>(v0, increment0);
+			dst += indicesPerBlock;
+		}
+	}
+	else
+	{
+		__m128i v1 = _mm_loadu_si128((const __m128i*)firstBlock + 1);
+		__m128i v2 = _mm_loadu_si128((const __m128i*)firstBlock + 2);
+		__m128i increment1 = _mm_loadu_si128((const __m128i*)blockIncrement + 1);
+		__m128i increment2 = _mm_loadu_si128((const __m128i*)blockIncrement + 2);
+		while (blockCount--)
+		{
+			_mm_storeu_si128((__m128i*)dst + 0, v0);
+			_mm_storeu_si128((__m128i*)dst + 1, v1);
+			_mm_storeu_si128((__m128i*)dst + 2, v2);
+			v0 = LatteIndices_addSSE41<T>(v0, increment0);
+			v1 = LatteIndices_addSSE41<T>(v1, increment1);
+			v2 = LatteIndices_addSSE41<T>(v2, increment2);
+			dst += indicesPerBlock;
+		}
+	}
+}
+
+// restart indices are replaced with the neutral element of min and max respectively
+template<typename T>
+ATTRIBUTE_SSE41
+uint32 LatteIndices_calculateIndexMinMaxRestart_SSE41(const betype<T>* src, uint32 count, T restartIndex, uint32& indexMin, uint32& indexMax)
+{
+	constexpr uint32 indicesPerVector = 16 / sizeof(T);
+	uint32 numVectors = count / indicesPerVector;
+	if (numVectors == 0)
+		return 0;
+	__m128i vMin = _mm_set1_epi32(-1);
+	__m128i vMax = _mm_setzero_si128();
+	__m128i vRestart = (sizeof(T) == 2) ? _mm_set1_epi16((sint16)restartIndex) : _mm_set1_epi32((sint32)restartIndex);
+	for (uint32 i = 0; i < numVectors; i++)
+	{
+		__m128i v = LatteIndices_loadSwappedSSE41<T>(src);
+		__m128i isRestart;
+		if constexpr (sizeof(T) == 2)
+			isRestart = _mm_cmpeq_epi16(v, vRestart);
+		else
+			isRestart = _mm_cmpeq_epi32(v, vRestart);
+		vMin = LatteIndices_minSSE41<T>(vMin, _mm_or_si128(v, isRestart));
+		vMax = LatteIndices_maxSSE41<T>(vMax, _mm_andnot_si128(isRestart, v));
+		src += indicesPerVector;
+	}
+	LatteIndices_reduceMinMaxSSE41<T>(vMin, vMax, indexMin, indexMax);
+	return numVectors * indicesPerVector;
+}
+#elif defined(__aarch64__)
+// same block layouts as the SSE4.1 kernels, vqtbl1q_u8 takes the place of pshufb. Out of range table indices write zero
+
+// gathers eight U16 lanes, -1 writes zero
+inline uint8x16_t LatteIndices_shuffleTableU16(sint8 w0, sint8 w1, sint8 w2, sint8 w3, sint8 w4, sint8 w5, sint8 w6, sint8 w7)
+{
+	const sint8 lanes[8] = { w0, w1, w2, w3, w4, w5, w6, w7 };
+	uint8 table[16];
+	for (sint32 i = 0; i < 8; i++)
+	{
+		table[i * 2 + 0] = lanes[i] < 0 ? 0xFF : (uint8)(lanes[i] * 2 + 0);
+		table[i * 2 + 1] = lanes[i] < 0 ? 0xFF : (uint8)(lanes[i] * 2 + 1);
+	}
+	return vld1q_u8(table);
+}
+
+// gathers four U32 lanes
+inline uint8x16_t LatteIndices_shuffleTableU32(uint8 w0, uint8 w1, uint8 w2, uint8 w3)
+{
+	const uint8 lanes[4] = { w0, w1, w2, w3 };
+	uint8 table[16];
+	for (sint32 i = 0; i < 16; i++)
+		table[i] = (uint8)(lanes[i / 4] * 4 + (i % 4));
+	return vld1q_u8(table);
+}
+
+template<typename T>
+inline uint8x16_t LatteIndices_loadSwappedNEON(const betype<T>* src)
+{
+	uint8x16_t v = vld1q_u8((const uint8*)src);
+	if constexpr (sizeof(T) == 2)
+		return vrev16q_u8(v);
+	else
+		return vrev32q_u8(v);
+}
+
+template<typename T>
+inline uint8x16_t LatteIndices_minNEON(uint8x16_t a, uint8x16_t b)
+{
+	if constexpr (sizeof(T) == 2)
+		return vreinterpretq_u8_u16(vminq_u16(vreinterpretq_u16_u8(a), vreinterpretq_u16_u8(b)));
+	else
+		return vreinterpretq_u8_u32(vminq_u32(vreinterpretq_u32_u8(a), vreinterpretq_u32_u8(b)));
+}
+
+template<typename T>
+inline uint8x16_t LatteIndices_maxNEON(uint8x16_t a, uint8x16_t b)
+{
+	if constexpr (sizeof(T) == 2)
+		return vreinterpretq_u8_u16(vmaxq_u16(vreinterpretq_u16_u8(a), vreinterpretq_u16_u8(b)));
+	else
+		return vreinterpretq_u8_u32(vmaxq_u32(vreinterpretq_u32_u8(a), vreinterpretq_u32_u8(b)));
+}
+
+template<typename T>
+inline void LatteIndices_reduceMinMaxNEON(uint8x16_t vMin, uint8x16_t vMax, uint32& indexMin, uint32& indexMax)
+{
+	if constexpr (sizeof(T) == 2)
+	{
+		indexMin = std::min(indexMin, (uint32)vminvq_u16(vreinterpretq_u16_u8(vMin)));
+		indexMax = std::max(indexMax, (uint32)vmaxvq_u16(vreinterpretq_u16_u8(vMax)));
+	}
+	else
+	{
+		indexMin = std::min(indexMin, vminvq_u32(vreinterpretq_u32_u8(vMin)));
+		indexMax = std::max(indexMax, vmaxvq_u32(vreinterpretq_u32_u8(vMax)));
+	}
+}
+
+template<typename T>
+sint32 LatteIndices_unpackQuadsAndConvert_NEON(const betype<T>* src, T* dst, sint32 numQuads, uint32& indexMin, uint32& indexMax)
+{
+	constexpr sint32 indicesPerVector = 16 / sizeof(T);
+	constexpr sint32 quadsPerBlock = indicesPerVector / 2;
+	sint32 numBlocks = numQuads / quadsPerBlock;
+	if (numBlocks == 0)
+		return 0;
+	uint8x16_t table0{}, table1a{}, table1b{}, table2{};
+	if constexpr (sizeof(T) == 2)
+	{
+		table0 = LatteIndices_shuffleTableU16(0, 1, 2, 0, 2, 3, 4, 5);
+		table1a = LatteIndices_shuffleTableU16(6, 4, 6, 7, -1, -1, -1, -1);
+		table1b = LatteIndices_shuffleTableU16(-1, -1, -1, -1, 0, 1, 2, 0);
+		table2 = LatteIndices_shuffleTableU16(2, 3, 4, 5, 6, 4, 6, 7);
+	}
+	else
+	{
+		table0 = LatteIndices_shuffleTableU32(0, 1, 2, 0);
+		table2 = LatteIndices_shuffleTableU32(2, 0, 2, 3);
+	}
+	uint8x16_t vMin = vdupq_n_u8(0xFF);
+	uint8x16_t vMax = vdupq_n_u8(0);
+	for (sint32 i = 0; i < numBlocks; i++)
+	{
+		uint8x16_t a = LatteIndices_loadSwappedNEON<T>(src);
+		uint8x16_t b = LatteIndices_loadSwappedNEON<T>(src + indicesPerVector);
+		vMin = LatteIndices_minNEON<T>(vMin, LatteIndices_minNEON<T>(a, b));
+		vMax = LatteIndices_maxNEON<T>(vMax, LatteIndices_maxNEON<T>(a, b));
+		uint8x16_t o0, o1, o2;
+		if constexpr (sizeof(T) == 2)
+		{
+			o0 = vqtbl1q_u8(a, table0);
+			o1 = vorrq_u8(vqtbl1q_u8(a, table1a), vqtbl1q_u8(b, table1b));
+			o2 = vqtbl1q_u8(b, table2);
+		}
+		else
+		{
+			o0 = vqtbl1q_u8(a, table0);
+			o1 = vextq_u8(a, b, 8);
+			o2 = vqtbl1q_u8(b, table2);
+		}
+		vst1q_u8((uint8*)dst + 0, o0);
+		vst1q_u8((uint8*)dst + 16, o1);
+		vst1q_u8((uint8*)dst + 32, o2);
+		src += indicesPerVector * 2;
+		dst += indicesPerVector * 3;
+	}
+	LatteIndices_reduceMinMaxNEON<T>(vMin, vMax, indexMin, indexMax);
+	return numBlocks * quadsPerBlock;
+}
+
+template<typename T>
+sint32 LatteIndices_unpackQuadStripAndConvert_NEON(const betype<T>* src, T* dst, uint32 count, sint32 numQuads, uint32& indexMin, uint32& indexMax)
+{
+	constexpr sint32 indicesPerVector = 16 / sizeof(T);
+	constexpr sint32 quadsPerBlock = indicesPerVector / 2;
+	// the second load must not read past the end of the index data
+	sint32 numBlocks = std::min(numQuads / quadsPerBlock, (sint32)(count / indicesPerVector) - 1);
+	if (numBlocks <= 0)
+		return 0;
+	uint8x16_t table0{}, table1{}, table2a{}, table2b{};
+	if constexpr (sizeof(T) == 2)
+	{
+		table0 = LatteIndices_shuffleTableU16(0, 1, 2, 2, 1, 3, 2, 3);
+		table1 = LatteIndices_shuffleTableU16(4, 4, 3, 5, 4, 5, 6, 6);
+		table2a = LatteIndices_shuffleTableU16(5, 7, 6, 7, -1, -1, 7, -1);
+		table2b = LatteIndices_shuffleTableU16(-1, -1, -1, -1, 0, 0, -1, 1);
+	}
+	else
+	{
+		table0 = LatteIndices_shuffleTableU32(0, 1, 2, 2);
+		table1 = LatteIndices_shuffleTableU32(1, 3, 2, 3);
+		table2a = LatteIndices_shuffleTableU32(1, 1, 0, 2);
+	}
+	// selects the first two indices of b, the rest is taken from a
+	const uint8x16_t bUsedMask = vreinterpretq_u8_u64(vcombine_u64(vcreate_u64(sizeof(T) == 2 ? 0xFFFFFFFFull : ~0ull), vcreate_u64(0)));
+	uint8x16_t vMin = vdupq_n_u8(0xFF);
+	uint8x16_t vMax = vdupq_n_u8(0);
+	for (sint32 i = 0; i < numBlocks; i++)
+	{
+		uint8x16_t a = LatteIndices_loadSwappedNEON<T>(src);
+		uint8x16_t b = LatteIndices_loadSwappedNEON<T>(src + indicesPerVector);
+		uint8x16_t o0, o1, o2;
+		if constexpr (sizeof(T) == 2)
+		{
+			o0 = vqtbl1q_u8(a, table0);
+			o1 = vqtbl1q_u8(a, table1);
+			o2 = vorrq_u8(vqtbl1q_u8(a, table2a), vqtbl1q_u8(b, table2b));
+		}
+		else
+		{
+			o0 = vqtbl1q_u8(a, table0);
+			o1 = vqtbl1q_u8(a, table1);
+			o2 = vqtbl1q_u8(vextq_u8(a, b, 12), table2a);
+		}
+		uint8x16_t bUsed = vbslq_u8(bUsedMask, b, a);
+		vMin = LatteIndices_minNEON<T>(vMin, LatteIndices_minNEON<T>(a, bUsed));
+		vMax = LatteIndices_maxNEON<T>(vMax, LatteIndices_maxNEON<T>(a, bUsed));
+		vst1q_u8((uint8*)dst + 0, o0);
+		vst1q_u8((uint8*)dst + 16, o1);
+		vst1q_u8((uint8*)dst + 32, o2);
+		src += indicesPerVector;
+		dst += indicesPerVector * 3;
+	}
+	LatteIndices_reduceMinMaxNEON<T>(vMin, vMax, indexMin, indexMax);
+	return numBlocks * quadsPerBlock;
+}
+
+template<typename T>
+sint32 LatteIndices_unpackTriangleFanAndConvert_NEON(const betype<T>* src, T* dst, uint32 count, uint32& indexMin, uint32& indexMax)
+{
+	constexpr sint32 indicesPerVector = 16 / sizeof(T);
+	sint32 numBlocks = (sint32)(count / 2) / indicesPerVector;
+	if (numBlocks == 0)
+		return 0;
+	const uint8x16_t reverseTable = (sizeof(T) == 2) ? LatteIndices_shuffleTableU16(7, 6, 5, 4, 3, 2, 1, 0) : LatteIndices_shuffleTableU32(3, 2, 1, 0);
+	uint8x16_t vMin = vdupq_n_u8(0xFF);
+	uint8x16_t vMax = vdupq_n_u8(0);
+	const betype<T>* srcBack = src + count;
+	for (sint32 i = 0; i < numBlocks; i++)
+	{
+		srcBack -= indicesPerVector;
+		uint8x16_t front = LatteIndices_loadSwappedNEON<T>(src);
+		uint8x16_t back = LatteIndices_loadSwappedNEON<T>(srcBack);
+		vMin = LatteIndices_minNEON<T>(vMin, LatteIndices_minNEON<T>(front, back));
+		vMax = LatteIndices_maxNEON<T>(vMax, LatteIndices_maxNEON<T>(front, back));
+		back = vqtbl1q_u8(back, reverseTable);
+		if constexpr (sizeof(T) == 2)
+		{
+			vst1q_u16((uint16*)dst + 0, vzip1q_u16(vreinterpretq_u16_u8(front), vreinterpretq_u16_u8(back)));
+			vst1q_u16((uint16*)dst + 8, vzip2q_u16(vreinterpretq_u16_u8(front), vreinterpretq_u16_u8(back)));
+		}
+		else
+		{
+			vst1q_u32((uint32*)dst + 0, vzip1q_u32(vreinterpretq_u32_u8(front), vreinterpretq_u32_u8(back)));
+			vst1q_u32((uint32*)dst + 4, vzip2q_u32(vreinterpretq_u32_u8(front), vreinterpretq_u32_u8(back)));
+		}
+		src += indicesPerVector;
+		dst += indicesPerVector * 2;
+	}
+	LatteIndices_reduceMinMaxNEON<T>(vMin, vMax, indexMin, indexMax);
+	return numBlocks * indicesPerVector;
+}
+
+template<typename T>
+inline uint8x16_t LatteIndices_addNEON(uint8x16_t a, uint8x16_t b)
+{
+	if constexpr (sizeof(T) == 2)
+		return vreinterpretq_u8_u16(vaddq_u16(vreinterpretq_u16_u8(a), vreinterpretq_u16_u8(b)));
+	else
+		return vreinterpretq_u8_u32(vaddq_u32(vreinterpretq_u32_u8(a), vreinterpretq_u32_u8(b)));
+}
+
+template<typename T, sint32 TVectorsPerBlock, typename TFunc>
+void LatteIndices_generateIndices_NEON(T* dst, sint32 blockCount, TFunc getIndex)
+{
+	static_assert(TVectorsPerBlock == 1 || TVectorsPerBlock == 3);
+	constexpr sint32 indicesPerBlock = TVectorsPerBlock * 16 / sizeof(T);
+	T firstBlock[indicesPerBlock];
+	T blockIncrement[indicesPerBlock];
+	for (sint32 i = 0; i < indicesPerBlock; i++)
+	{
+		firstBlock[i] = (T)getIndex((uint32)i);
+		blockIncrement[i] = (T)(getIndex((uint32)(i + indicesPerBlock)) - getIndex((uint32)i));
+	}
+	uint8x16_t v0 = vld1q_u8((const uint8*)firstBlock + 0);
+	uint8x16_t increment0 = vld1q_u8((const uint8*)blockIncrement + 0);
+	if constexpr (TVectorsPerBlock == 1)
+	{
+		while (blockCount--)
+		{
+			vst1q_u8((uint8*)dst, v0);
+			v0 = LatteIndices_addNEON<T>(v0, increment0);
+			dst += indicesPerBlock;
+		}
+	}
+	else
+	{
+		uint8x16_t v1 = vld1q_u8((const uint8*)firstBlock + 16);
+		uint8x16_t v2 = vld1q_u8((const uint8*)firstBlock + 32);
+		uint8x16_t increment1 = vld1q_u8((const uint8*)blockIncrement + 16);
+		uint8x16_t increment2 = vld1q_u8((const uint8*)blockIncrement + 32);
+		while (blockCount--)
+		{
+			vst1q_u8((uint8*)dst + 0, v0);
+			vst1q_u8((uint8*)dst + 16, v1);
+			vst1q_u8((uint8*)dst + 32, v2);
+			v0 = LatteIndices_addNEON<T>(v0, increment0);
+			v1 = LatteIndices_addNEON<T>(v1, increment1);
+			v2 = LatteIndices_addNEON<T>(v2, increment2);
+			dst += indicesPerBlock;
+		}
+	}
+}
+
+template<typename T>
+uint32 LatteIndices_calculateIndexMinMaxRestart_NEON(const betype<T>* src, uint32 count, T restartIndex, uint32& indexMin, uint32& indexMax)
+{
+	constexpr uint32 indicesPerVector = 16 / sizeof(T);
+	uint32 numVectors = count / indicesPerVector;
+	if (numVectors == 0)
+		return 0;
+	uint8x16_t vMin = vdupq_n_u8(0xFF);
+	uint8x16_t vMax = vdupq_n_u8(0);
+	uint8x16_t vRestart = (sizeof(T) == 2) ? vreinterpretq_u8_u16(vdupq_n_u16((uint16)restartIndex)) : vreinterpretq_u8_u32(vdupq_n_u32((uint32)restartIndex));
+	for (uint32 i = 0; i < numVectors; i++)
+	{
+		uint8x16_t v = LatteIndices_loadSwappedNEON<T>(src);
+		uint8x16_t isRestart;
+		if constexpr (sizeof(T) == 2)
+			isRestart = vreinterpretq_u8_u16(vceqq_u16(vreinterpretq_u16_u8(v), vreinterpretq_u16_u8(vRestart)));
+		else
+			isRestart = vreinterpretq_u8_u32(vceqq_u32(vreinterpretq_u32_u8(v), vreinterpretq_u32_u8(vRestart)));
+		vMin = LatteIndices_minNEON<T>(vMin, vorrq_u8(v, isRestart));
+		vMax = LatteIndices_maxNEON<T>(vMax, vbicq_u8(v, isRestart));
+		src += indicesPerVector;
+	}
+	LatteIndices_reduceMinMaxNEON<T>(vMin, vMax, indexMin, indexMax);
+	return numVectors * indicesPerVector;
+}
+#endif
+
+// plain U16/U32 big endian conversion, picks the fastest available implementation
+void LatteIndices_fastConvertU16(const void* indexDataInput, void* indexDataOutput, uint32 count, uint32& indexMin, uint32& indexMax);
+void LatteIndices_fastConvertU32(const void* indexDataInput, void* indexDataOutput, uint32 count, uint32& indexMin, uint32& indexMax);
+
 template<typename T>
 void LatteIndices_convertBE(const void* indexDataInput, void* indexDataOutput, uint32 count, uint32& indexMin, uint32& indexMax)
 {
@@ -177,7 +761,18 @@ void LatteIndices_unpackQuadsAndConvert(const void* indexDataInput, void* indexD
 	sint32 numQuads = count / 4;
 	const betype<T>* src = (betype<T>*)indexDataInput;
 	T* dst = (T*)indexDataOutput;
-	for (sint32 i = 0; i < numQuads; i++)
+	sint32 i = 0;
+	if (LatteIndices_useSIMD())
+	{
+#if defined(ARCH_X86_64)
+		i = LatteIndices_unpackQuadsAndConvert_SSE41<T>(src, dst, numQuads, indexMin, indexMax);
+#elif defined(__aarch64__)
+		i = LatteIndices_unpackQuadsAndConvert_NEON<T>(src, dst, numQuads, indexMin, indexMax);
+#endif
+		src += i * 4;
+		dst += i * 6;
+	}
+	for (; i < numQuads; i++)
 	{
 		T idx0 = src[0];
 		T idx1 = src[1];
@@ -206,9 +801,21 @@ template<typename T>
 void LatteIndices_generateAutoQuadIndices(const void* indexDataInput, void* indexDataOutput, uint32 count, uint32& indexMin, uint32& indexMax)
 {
 	sint32 numQuads = count / 4;
-	const betype<T>* src = (betype<T>*)indexDataInput;
 	T* dst = (T*)indexDataOutput;
-	for (sint32 i = 0; i < numQuads; i++)
+	sint32 i = 0;
+	if (LatteIndices_useSIMD())
+	{
+		constexpr sint32 quadsPerBlock = 8 / sizeof(T);
+		auto getIndex = [](uint32 n) { const uint32 pattern[6] = { 0, 1, 2, 0, 2, 3 }; return (n / 6) * 4 + pattern[n % 6]; };
+#if defined(ARCH_X86_64)
+		LatteIndices_generateIndices_SSE41<T, 3>(dst, numQuads / quadsPerBlock, getIndex);
+#elif defined(__aarch64__)
+		LatteIndices_generateIndices_NEON<T, 3>(dst, numQuads / quadsPerBlock, getIndex);
+#endif
+		i = numQuads / quadsPerBlock * quadsPerBlock;
+		dst += i * 6;
+	}
+	for (; i < numQuads; i++)
 	{
 		T idx0 = i * 4 + 0;
 		T idx1 = i * 4 + 1;
@@ -220,7 +827,6 @@ void LatteIndices_generateAutoQuadIndices(const void* indexDataInput, void* inde
 		dst[3] = idx0;
 		dst[4] = idx2;
 		dst[5] = idx3;
-		src += 4;
 		dst += 6;
 	}
 	indexMin = 0;
@@ -235,7 +841,18 @@ void LatteIndices_unpackQuadStripAndConvert(const void* indexDataInput, void* in
 	sint32 numQuads = (count - 2) / 2;
 	const betype<T>* src = (betype<T>*)indexDataInput;
 	T* dst = (T*)indexDataOutput;
-	for (sint32 i = 0; i < numQuads; i++)
+	sint32 i = 0;
+	if (LatteIndices_useSIMD())
+	{
+#if defined(ARCH_X86_64)
+		i = LatteIndices_unpackQuadStripAndConvert_SSE41<T>(src, dst, count, numQuads, indexMin, indexMax);
+#elif defined(__aarch64__)
+		i = LatteIndices_unpackQuadStripAndConvert_NEON<T>(src, dst, count, numQuads, indexMin, indexMax);
+#endif
+		src += i * 2;
+		dst += i * 6;
+	}
+	for (; i < numQuads; i++)
 	{
 		T idx0 = src[0];
 		T idx1 = src[1];
@@ -268,16 +885,12 @@ void LatteIndices_unpackLineLoopAndConvert(const void* indexDataInput, void* ind
 	const betype<T>* src = (betype<T>*)indexDataInput;
 	T firstIndex = *src;
 	T* dst = (T*)indexDataOutput;
-	for (sint32 i = 0; i < (sint32)count; i++)
-	{
-		T idx = *src;
-		indexMin = std::min(indexMin, (uint32)idx);
-		indexMax = std::max(indexMax, (uint32)idx);
-		*dst = idx;
-		src++;
-		dst++;
-	}
-	*dst = firstIndex;
+	// same as a line strip plus the reconnecting index
+	if constexpr (sizeof(T) == 2)
+		LatteIndices_fastConvertU16(indexDataInput, indexDataOutput, count, indexMin, indexMax);
+	else
+		LatteIndices_fastConvertU32(indexDataInput, indexDataOutput, count, indexMin, indexMax);
+	dst[count] = firstIndex;
 }
 
 template<typename T>
@@ -287,7 +900,20 @@ void LatteIndices_generateAutoQuadStripIndices(void* indexDataOutput, uint32 cou
 		return;
 	sint32 numQuads = (count - 2) / 2;
 	T* dst = (T*)indexDataOutput;
-	for (sint32 i = 0; i < numQuads; i++)
+	sint32 i = 0;
+	if (LatteIndices_useSIMD())
+	{
+		constexpr sint32 quadsPerBlock = 8 / sizeof(T);
+		auto getIndex = [](uint32 n) { const uint32 pattern[6] = { 0, 1, 2, 2, 1, 3 }; return (n / 6) * 2 + pattern[n % 6]; };
+#if defined(ARCH_X86_64)
+		LatteIndices_generateIndices_SSE41<T, 3>(dst, numQuads / quadsPerBlock, getIndex);
+#elif defined(__aarch64__)
+		LatteIndices_generateIndices_NEON<T, 3>(dst, numQuads / quadsPerBlock, getIndex);
+#endif
+		i = numQuads / quadsPerBlock * quadsPerBlock;
+		dst += i * 6;
+	}
+	for (; i < numQuads; i++)
 	{
 		T idx0 = i * 2 + 0;
 		T idx1 = i * 2 + 1;
@@ -312,7 +938,20 @@ void LatteIndices_generateAutoLineLoopIndices(void* indexDataOutput, uint32 coun
 	if (count == 0)
 		return;
 	T* dst = (T*)indexDataOutput;
-	for (sint32 i = 0; i < (sint32)count; i++)
+	sint32 i = 0;
+	if (LatteIndices_useSIMD())
+	{
+		constexpr sint32 indicesPerVector = 16 / sizeof(T);
+		auto getIndex = [](uint32 n) { return n; };
+#if defined(ARCH_X86_64)
+		LatteIndices_generateIndices_SSE41<T, 1>(dst, (sint32)count / indicesPerVector, getIndex);
+#elif defined(__aarch64__)
+		LatteIndices_generateIndices_NEON<T, 1>(dst, (sint32)count / indicesPerVector, getIndex);
+#endif
+		i = (sint32)count / indicesPerVector * indicesPerVector;
+		dst += i;
+	}
+	for (; i < (sint32)count; i++)
 	{
 		*dst = (T)i;
 		dst++;
@@ -328,8 +967,17 @@ void LatteIndices_unpackTriangleFanAndConvert(const void* indexDataInput, void*
 {
 	const betype<T>* src = (betype<T>*)indexDataInput;
 	T* dst = (T*)indexDataOutput;
+	sint32 i = 0;
+	if (LatteIndices_useSIMD())
+	{
+#if defined(ARCH_X86_64)
+		i = LatteIndices_unpackTriangleFanAndConvert_SSE41<T>(src, dst, count, indexMin, indexMax) * 2;
+#elif defined(__aarch64__)
+		i = LatteIndices_unpackTriangleFanAndConvert_NEON<T>(src, dst, count, indexMin, indexMax) * 2;
+#endif
+	}
 	// TODO: check this
-	for (sint32 i = 0; i < count; i++)
+	for (; i < count; i++)
 	{
 	    uint32 i0;
 		if (i % 2 == 0)
@@ -348,7 +996,19 @@ void LatteIndices_generateAutoTriangleFanIndices(const void* indexDataInput, voi
 {
 	const betype<T>* src = (betype<T>*)indexDataInput;
 	T* dst = (T*)indexDataOutput;
-	for (sint32 i = 0; i < count; i++)
+	sint32 i = 0;
+	if (LatteIndices_useSIMD())
+	{
+		constexpr sint32 indicesPerVector = 16 / sizeof(T);
+		auto getIndex = [count](uint32 n) { return (n % 2) == 0 ? (n / 2) : (count - 1 - n / 2); };
+#if defined(ARCH_X86_64)
+		LatteIndices_generateIndices_SSE41<T, 1>(dst, (sint32)count / indicesPerVector, getIndex);
+#elif defined(__aarch64__)
+		LatteIndices_generateIndices_NEON<T, 1>(dst, (sint32)count / indicesPerVector, getIndex);
+#endif
+		i = (sint32)count / indicesPerVector * indicesPerVector;
+	}
+	for (; i < count; i++)
 	{
 		T idx = i;
 		if (idx % 2 == 0)
@@ -667,6 +1327,46 @@ void LatteIndices_fastConvertU32_NEON(const void* indexDataInput, void* indexDat
 
 #endif
 
+void LatteIndices_fastConvertU16(const void* indexDataInput, void* indexDataOutput, uint32 count, uint32& indexMin, uint32& indexMax)
+{
+	if (!s_useSIMDKernels)
+	{
+		LatteIndices_convertBE<uint16>(indexDataInput, indexDataOutput, count, indexMin, indexMax);
+		return;
+	}
+#if defined(ARCH_X86_64)
+	if (g_CPUFeatures.x86.avx2)
+		LatteIndices_fastConvertU16_AVX2(indexDataInput, indexDataOutput, count, indexMin, indexMax);
+	else if (g_CPUFeatures.x86.sse4_1 && g_CPUFeatures.x86.ssse3)
+		LatteIndices_fastConvertU16_SSE41(indexDataInput, indexDataOutput, count, indexMin, indexMax);
+	else
+		LatteIndices_convertBE<uint16>(indexDataInput, indexDataOutput, count, indexMin, indexMax);
+#elif defined(__aarch64__)
+	LatteIndices_fastConvertU16_NEON(indexDataInput, indexDataOutput, count, indexMin, indexMax);
+#else
+	LatteIndices_convertBE<uint16>(indexDataInput, indexDataOutput, count, indexMin, indexMax);
+#endif
+}
+
+void LatteIndices_fastConvertU32(const void* indexDataInput, void* indexDataOutput, uint32 count, uint32& indexMin, uint32& indexMax)
+{
+	if (!s_useSIMDKernels)
+	{
+		LatteIndices_convertBE<uint32>(indexDataInput, indexDataOutput, count, indexMin, indexMax);
+		return;
+	}
+#if defined(ARCH_X86_64)
+	if (g_CPUFeatures.x86.avx2)
+		LatteIndices_fastConvertU32_AVX2(indexDataInput, indexDataOutput, count, indexMin, indexMax);
+	else
+		LatteIndices_convertBE<uint32>(indexDataInput, indexDataOutput, count, indexMin, indexMax);
+#elif defined(__aarch64__)
+	LatteIndices_fastConvertU32_NEON(indexDataInput, indexDataOutput, count, indexMin, indexMax);
+#else
+	LatteIndices_convertBE<uint32>(indexDataInput, indexDataOutput, count, indexMin, indexMax);
+#endif
+}
+
 template<typename T>
 void _LatteIndices_alternativeCalculateIndexMinMax(const void* indexData, uint32 count, uint32 primitiveRestartIndex, uint32& indexMin, uint32& indexMax)
 {
@@ -676,6 +1376,21 @@ void _LatteIndices_alternativeCalculateIndexMinMax(const void* indexData, uint32
 	T _indexMax = *idxPtrT;
 	cemu_assert_debug(primitiveRestartIndex <= std::numeric_limits<T>::max());
 	T restartIndexT = (T)primitiveRestartIndex;
+	if (LatteIndices_useSIMD())
+	{
+		uint32 vectorIndexMin = _indexMin;
+		uint32 vectorIndexMax = _indexMax;
+		uint32 processedCount = 0;
+#if defined(ARCH_X86_64)
+		processedCount = LatteIndices_calculateIndexMinMaxRestart_SSE41<T>(idxPtrT, count, restartIndexT, vectorIndexMin, vectorIndexMax);
+#elif defined(__aarch64__)
+		processedCount = LatteIndices_calculateIndexMinMaxRestart_NEON<T>(idxPtrT, count, restartIndexT, vectorIndexMin, vectorIndexMax);
+#endif
+		_indexMin = (T)vectorIndexMin;
+		_indexMax = (T)vectorIndexMax;
+		idxPtrT += processedCount;
+		count -= processedCount;
+	}
 	while (count)
 	{
 		T idx = *idxPtrT;
@@ -693,7 +1408,7 @@ void _LatteIndices_alternativeCalculateIndexMinMax(const void* indexData, uint32
 
 // calculate min and max index while taking primitive restart into account
 // fallback implementation in case the fast path gives us invalid results
-void LatteIndices_alternativeCalculateIndexMinMax(const void* indexData, LatteIndexType indexType, uint32 count, uint32& indexMin, uint32& indexMax)
+void LatteIndices_alternativeCalculateIndexMinMax(const void* indexData, LatteIndexType indexType, uint32 count, uint32 primitiveRestartIndex, uint32& indexMin, uint32& indexMax)
 {
 	if (count == 0)
 	{
@@ -701,7 +1416,6 @@ void LatteIndices_alternativeCalculateIndexMinMax(const void* indexData, LatteIn
 		indexMax = 0;
 		return;
 	}
-	uint32 primitiveRestartIndex = LatteGPUState.contextNew.VGT_MULTI_PRIM_IB_RESET_INDX.get_RESTART_INDEX();
 
 	if (indexType == LatteIndexType::U16_BE)
 	{
@@ -717,31 +1431,8 @@ void LatteIndices_alternativeCalculateIndexMinMax(const void* indexData, LatteIn
 	}
 }
 
-void LatteIndices_decode(const void* indexData, LatteIndexType indexType, uint32 count, LattePrimitiveMode primitiveMode, uint32& indexMin, uint32& indexMax, Renderer::INDEX_TYPE& renderIndexType, uint32& outputCount, Renderer::IndexAllocation& indexAllocation)
+void LatteIndices_decodeToBuffer(const void* indexData, LatteIndexType indexType, uint32 count, LattePrimitiveMode primitiveMode, bool unpackTriangleFans, uint32 primitiveRestartIndex, void* indexOutputPtr, uint32& indexMin, uint32& indexMax, Renderer::INDEX_TYPE& renderIndexType, uint32& outputCount)
 {
-	// what this should do:
-	// [x] use fast SIMD-based index decoding
-	// [x] unpack QUAD indices to triangle indices
-	// [x] calculate min and max index, be careful about primitive restart index
-	// [x] decode data directly into coherent memory buffer?
-	// [ ] better cache implementation, allow to cache across frames
-
-	// reuse from cache if data didn't change
-	auto cacheEntry = std::find_if(LatteIndexCache.entry.begin(), LatteIndexCache.entry.end(), [indexData, count, primitiveMode, indexType](const auto& entry)
-	{
-		return entry.lastPtr == indexData && entry.lastCount == count && entry.lastPrimitiveMode == primitiveMode && entry.lastIndexType == indexType;
-	});
-	if (cacheEntry != LatteIndexCache.entry.end())
-	{
-		indexMin = cacheEntry->indexMin;
-		indexMax = cacheEntry->indexMax;
-		renderIndexType = cacheEntry->renderIndexType;
-		outputCount = cacheEntry->outputCount;
-		indexAllocation = cacheEntry->indexAllocation;
-		cacheEntry->lastUsed = LatteIndices_GetNextUsageIndex();
-		return;
-	}
-
 	outputCount = 0;
 	if (indexType == LatteIndexType::AUTO)
 		renderIndexType = Renderer::INDEX_TYPE::NONE;
@@ -752,23 +1443,6 @@ void LatteIndices_decode(const void* indexData, LatteIndexType indexType, uint32
 	else
 		cemu_assert_debug(false);
 
-	uint32 primitiveRestartIndex = LatteGPUState.contextNew.VGT_MULTI_PRIM_IB_RESET_INDX.get_RESTART_INDEX();
-
-	// calculate index output size
-	uint32 indexOutputSize = LatteIndices_calculateIndexOutputSize(primitiveMode, indexType, count);
-	if (indexOutputSize == 0)
-	{
-		outputCount = count;
-		indexMin = 0;
-		indexMax = std::max(count, 1u)-1;
-		renderIndexType = Renderer::INDEX_TYPE::NONE;
-		indexAllocation = {};
-		return; // no indices
-	}
-	// query index buffer from renderer
-	indexAllocation = g_renderer->indexData_reserveIndexMemory(indexOutputSize);
-	void* indexOutputPtr = indexAllocation.mem;
-
 	// decode indices
 	indexMin = std::numeric_limits<uint32>::max();
 	indexMax = std::numeric_limits<uint32>::min();
@@ -847,7 +1521,7 @@ void LatteIndices_decode(const void* indexData, LatteIndexType indexType, uint32
 			cemu_assert_debug(false);
 		outputCount = count + 1;
 	}
-	else if (primitiveMode == LattePrimitiveMode::TRIANGLE_FAN && g_renderer->GetType() == RendererAPI::Metal)
+	else if (primitiveMode == LattePrimitiveMode::TRIANGLE_FAN && unpackTriangleFans)
 	{
         if (indexType == LatteIndexType::AUTO)
     	{
@@ -874,31 +1548,11 @@ void LatteIndices_decode(const void* indexData, LatteIndexType indexType, uint32
 	{
 		if (indexType == LatteIndexType::U16_BE)
 		{
-#if defined(ARCH_X86_64)
-			if (g_CPUFeatures.x86.avx2)
-				LatteIndices_fastConvertU16_AVX2(indexData, indexOutputPtr, count, indexMin, indexMax);
-			else if (g_CPUFeatures.x86.sse4_1 && g_CPUFeatures.x86.ssse3)
-				LatteIndices_fastConvertU16_SSE41(indexData, indexOutputPtr, count, indexMin, indexMax);
-			else
-				LatteIndices_convertBE<uint16>(indexData, indexOutputPtr, count, indexMin, indexMax);
-#elif defined(__aarch64__)
-			LatteIndices_fastConvertU16_NEON(indexData, indexOutputPtr, count, indexMin, indexMax);
-#else
-			LatteIndices_convertBE<uint16>(indexData, indexOutputPtr, count, indexMin, indexMax);            
-#endif
+			LatteIndices_fastConvertU16(indexData, indexOutputPtr, count, indexMin, indexMax);
 		}
 		else if (indexType == LatteIndexType::U32_BE)
 		{
-#if defined(ARCH_X86_64)
-			if (g_CPUFeatures.x86.avx2)
-				LatteIndices_fastConvertU32_AVX2(indexData, indexOutputPtr, count, indexMin, indexMax);
-			else
-				LatteIndices_convertBE<uint32>(indexData, indexOutputPtr, count, indexMin, indexMax);
-#elif defined(__aarch64__)
-			LatteIndices_fastConvertU32_NEON(indexData, indexOutputPtr, count, indexMin, indexMax);
-#else
-			LatteIndices_convertBE<uint32>(indexData, indexOutputPtr, count, indexMin, indexMax);            
-#endif
+			LatteIndices_fastConvertU32(indexData, indexOutputPtr, count, indexMin, indexMax);
 		}
 		else if (indexType == LatteIndexType::U16_LE)
 		{
@@ -917,8 +1571,52 @@ void LatteIndices_decode(const void* indexData, LatteIndexType indexType, uint32
 	if (primitiveRestartIndex == indexMin || primitiveRestartIndex == indexMax)
 	{
 		// recalculate index range but filter out primitive restart index
-		LatteIndices_alternativeCalculateIndexMinMax(indexData, indexType, count, indexMin, indexMax);
+		LatteIndices_alternativeCalculateIndexMinMax(indexData, indexType, count, primitiveRestartIndex, indexMin, indexMax);
+	}
+}
+
+void LatteIndices_decode(const void* indexData, LatteIndexType indexType, uint32 count, LattePrimitiveMode primitiveMode, uint32& indexMin, uint32& indexMax, Renderer::INDEX_TYPE& renderIndexType, uint32& outputCount, Renderer::IndexAllocation& indexAllocation)
+{
+	// what this should do:
+	// [x] use fast SIMD-based index decoding
+	// [x] unpack QUAD indices to triangle indices
+	// [x] calculate min and max index, be careful about primitive restart index
+	// [x] decode data directly into coherent memory buffer?
+	// [ ] better cache implementation, allow to cache across frames
+
+	// reuse from cache if data didn't change
+	auto cacheEntry = std::find_if(LatteIndexCache.entry.begin(), LatteIndexCache.entry.end(), [indexData, count, primitiveMode, indexType](const auto& entry)
+	{
+		return entry.lastPtr == indexData && entry.lastCount == count && entry.lastPrimitiveMode == primitiveMode && entry.lastIndexType == indexType;
+	});
+	if (cacheEntry != LatteIndexCache.entry.end())
+	{
+		indexMin = cacheEntry->indexMin;
+		indexMax = cacheEntry->indexMax;
+		renderIndexType = cacheEntry->renderIndexType;
+		outputCount = cacheEntry->outputCount;
+		indexAllocation = cacheEntry->indexAllocation;
+		cacheEntry->lastUsed = LatteIndices_GetNextUsageIndex();
+		return;
+	}
+
+	uint32 primitiveRestartIndex = LatteGPUState.contextNew.VGT_MULTI_PRIM_IB_RESET_INDX.get_RESTART_INDEX();
+
+	// calculate index output size
+	uint32 indexOutputSize = LatteIndices_calculateIndexOutputSize(primitiveMode, indexType, count);
+	if (indexOutputSize == 0)
+	{
+		outputCount = count;
+		indexMin = 0;
+		indexMax = std::max(count, 1u)-1;
+		renderIndexType = Renderer::INDEX_TYPE::NONE;
+		indexAllocation = {};
+		return; // no indices
 	}
+	// query index buffer from renderer
+	indexAllocation = g_renderer->indexData_reserveIndexMemory(indexOutputSize);
+	void* indexOutputPtr = indexAllocation.mem;
+	LatteIndices_decodeToBuffer(indexData, indexType, count, primitiveMode, g_renderer->GetType() == RendererAPI::Metal, primitiveRestartIndex, indexOutputPtr, indexMin, indexMax, renderIndexType, outputCount);
 	g_renderer->indexData_uploadIndexMemory(indexAllocation);
 	performanceMonitor.cycle[performanceMonitor.cycleIndex].indexDataUploaded += indexOutputSize;
 	// get least recently used cache entry
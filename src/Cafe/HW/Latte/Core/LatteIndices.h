@@ -1,7 +1,14 @@
 #pragma once
 #include "Cafe/HW/Latte/Core/LatteConst.h"
 #include "Cafe/HW/Latte/ISA/LatteReg.h"
+#include "Cafe/HW/Latte/Renderer/Renderer.h"
 
 void LatteIndices_invalidate(const void* memPtr, uint32 size);
 void LatteIndices_invalidateAll();
-void LatteIndices_decode(const void* indexData, LatteIndexType indexType, uint32 count, LattePrimitiveMode primitiveMode, uint32& indexMin, uint32& indexMax, Renderer::INDEX_TYPE& renderIndexType, uint32& outputCount, Renderer::IndexAllocation& indexAllocation);
\ No newline at end of file
+void LatteIndices_decode(const void* indexData, LatteIndexType indexType, uint32 count, LattePrimitiveMode primitiveMode, uint32& indexMin, uint32& indexMax, Renderer::INDEX_TYPE& renderIndexType, uint32& outputCount, Renderer::IndexAllocation& indexAllocation);
+
+// decodes into a caller provided buffer, bypassing the cache and the renderer. Triangle fans are only reordered if unpackTriangleFans is set
+void LatteIndices_decodeToBuffer(const void* indexData, LatteIndexType indexType, uint32 count, LattePrimitiveMode primitiveMode, bool unpackTriangleFans, uint32 primitiveRestartIndex, void* indexOutputPtr, uint32& indexMin, uint32& indexMax, Renderer::INDEX_TYPE& renderIndexType, uint32& outputCount);
+void LatteIndices_setSIMDEnabled(bool isEnabled);
+
+bool LatteIndices_RunSelfCheck();
@@ -0,0 +1,184 @@
+#include "Cafe/HW/Latte/Core/LatteIndices.h"
+
+/* Index decoding self check
+ * Decodes random index data once with the SIMD kernels (SSE4.1/AVX2 or NEON) and once with only the scalar loops, then compares the output indices, the index range, the index type and the output count
+ * Quads, quad strips, line loops, triangle fans and plain triangles are combined with AUTO, U16 and U32 indices. All counts up to a few blocks are covered, so every remainder of the kernels is hit
+ * Half of the U16/U32 cases contain primitive restart indices, which sends the index range through the restart aware min/max scan. Afterwards the decoding time of both paths is measured on a large draw per case
+ */
+
+constexpr uint32 INDEX_CHECK_SHORT_COUNT = 96; // every count up to this is checked
+constexpr uint32 INDEX_CHECK_RANDOM_ITERATIONS = 200;
+constexpr uint32 INDEX_CHECK_RANDOM_MAX_COUNT = 5000;
+constexpr uint32 INDEX_CHECK_BENCHMARK_COUNT = 1024 * 1024;
+constexpr uint32 INDEX_CHECK_BENCHMARK_RUNS = 20;
+
+class IndexCheckRNG
+{
+public:
+	IndexCheckRNG(uint32 seed) : m_state(seed * 0x9E3779B9u + 0x6D2B79F5u) {}
+
+	uint32 Next()
+	{
+		m_state ^= m_state << 13;
+		m_state ^= m_state >> 17;
+		m_state ^= m_state << 5;
+		return m_state;
+	}
+
+	uint32 Range(uint32 minValue, uint32 maxValue)
+	{
+		return minValue + (uint32)(Next() % ((uint64)maxValue - minValue + 1));
+	}
+
+private:
+	uint32 m_state;
+};
+
+struct IndexCheckCase
+{
+	std::string name;
+	LattePrimitiveMode primitiveMode;
+	LatteIndexType indexType;
+	uint32 minCount; // AUTO only switches to U32 output above 0xFFFF indices
+	uint32 maxCount;
+	bool hasRestartIndices;
+};
+
+struct IndexCheckOutput
+{
+	std::vector<uint8> storage;
+	uint8* indices;
+	uint32 indexMin;
+	uint32 indexMax;
+	Renderer::INDEX_TYPE renderIndexType;
+	uint32 outputCount;
+};
+
+// the plain conversion kernels use aligned stores, the renderer's index buffers are aligned as well
+static void IndexCheck_decode(const IndexCheckCase& checkCase, const void* indexData, uint32 count, uint32 restartIndex, IndexCheckOutput& output)
+{
+	const size_t outputSize = ((size_t)count * 3 + 16) * sizeof(uint32);
+	output.storage.assign(outputSize + 64, 0xCC);
+	output.indices = (uint8*)(((uintptr_t)output.storage.data() + 63) & ~(uintptr_t)63);
+	LatteIndices_decodeToBuffer(indexData, checkCase.indexType, count, checkCase.primitiveMode, true, restartIndex, output.indices, output.indexMin, output.indexMax, output.renderIndexType, output.outputCount);
+}
+
+static uint32 IndexCheck_getRestartIndex(const IndexCheckCase& checkCase)
+{
+	return checkCase.indexType == LatteIndexType::U16_BE ? 0xFFFF : 0xFFFFFFFF;
+}
+
+static void IndexCheck_generateIndexData(IndexCheckRNG& rng, const IndexCheckCase& checkCase, uint32 count, std::vector<uint8>& indexData)
+{
+	indexData.resize((size_t)count * sizeof(uint32) + 16);
+	if (checkCase.indexType == LatteIndexType::AUTO)
+		return;
+	const uint32 restartIndex = IndexCheck_getRestartIndex(checkCase);
+	// a narrow range makes the restart index the only candidate for the minimum or maximum more often
+	const uint32 maxIndex = rng.Range(0, 3) == 0 ? 64 : restartIndex - 1;
+	for (uint32 i = 0; i < count; i++)
+	{
+		uint32 index = (checkCase.hasRestartIndices && rng.Range(0, 7) == 0) ? restartIndex : rng.Range(0, maxIndex);
+		if (checkCase.indexType == LatteIndexType::U16_BE)
+			((uint16be*)indexData.data())[i] = (uint16)index;
+		else
+			((uint32be*)indexData.data())[i] = index;
+	}
+}
+
+// returns false and prints the case if the SIMD and the scalar path disagree
+static bool IndexCheck_runCase(IndexCheckRNG& rng, const IndexCheckCase& checkCase, uint32 count)
+{
+	std::vector<uint8> indexData;
+	IndexCheck_generateIndexData(rng, checkCase, count, indexData);
+	const uint32 restartIndex = IndexCheck_getRestartIndex(checkCase);
+	IndexCheckOutput expected, actual;
+	LatteIndices_setSIMDEnabled(false);
+	IndexCheck_decode(checkCase, indexData.data(), count, restartIndex, expected);
+	LatteIndices_setSIMDEnabled(true);
+	IndexCheck_decode(checkCase, indexData.data(), count, restartIndex, actual);
+	const size_t outputSize = expected.storage.size() - 64;
+	const char* mismatch = nullptr;
+	if (memcmp(actual.indices, expected.indices, outputSize) != 0)
+		mismatch = "indices";
+	else if (actual.indexMin != expected.indexMin || actual.indexMax != expected.indexMax)
+		mismatch = "index range";
+	else if (actual.renderIndexType != expected.renderIndexType)
+		mismatch = "index type";
+	else if (actual.outputCount != expected.outputCount)
+		mismatch = "output count";
+	if (!mismatch)
+		return true;
+	fmt::print("MISMATCH: {} with {} indices, {} differs (range {}-{}, expected {}-{})\n", checkCase.name, count, mismatch, actual.indexMin, actual.indexMax, expected.indexMin, expected.indexMax);
+	return false;
+}
+
+static double IndexCheck_measure(const IndexCheckCase& checkCase, const std::vector<uint8>& indexData, uint32 count, bool useSIMD)
+{
+	IndexCheckOutput output;
+	const uint32 restartIndex = IndexCheck_getRestartIndex(checkCase);
+	LatteIndices_setSIMDEnabled(useSIMD);
+	IndexCheck_decode(checkCase, indexData.data(), count, restartIndex, output); // warm up, also allocates the output
+	auto startTime = std::chrono::steady_clock::now();
+	for (uint32 i = 0; i < INDEX_CHECK_BENCHMARK_RUNS; i++)
+		LatteIndices_decodeToBuffer(indexData.data(), checkCase.indexType, count, checkCase.primitiveMode, true, restartIndex, output.indices, output.indexMin, output.indexMax, output.renderIndexType, output.outputCount);
+	double elapsedMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+	LatteIndices_setSIMDEnabled(true);
+	return elapsedMs;
+}
+
+static std::vector<IndexCheckCase> IndexCheck_getCases()
+{
+	const std::pair<LattePrimitiveMode, const char*> primitiveModes[] = {
+		{LattePrimitiveMode::QUADS, "quads"},
+		{LattePrimitiveMode::QUAD_STRIP, "quad strip"},
+		{LattePrimitiveMode::LINE_LOOP, "line loop"},
+		{LattePrimitiveMode::TRIANGLE_FAN, "triangle fan"},
+		{LattePrimitiveMode::TRIANGLES, "triangles"},
+	};
+	std::vector<IndexCheckCase> cases;
+	for (auto& [primitiveMode, modeName] : primitiveModes)
+	{
+		// AUTO triangles are drawn without an index buffer
+		if (primitiveMode != LattePrimitiveMode::TRIANGLES)
+		{
+			cases.push_back({fmt::format("{} auto u16", modeName), primitiveMode, LatteIndexType::AUTO, 0, 0xFFFF, false});
+			cases.push_back({fmt::format("{} auto u32", modeName), primitiveMode, LatteIndexType::AUTO, 0x10000, 0xFFFFFFFF, false});
+		}
+		for (bool hasRestartIndices : {false, true})
+		{
+			cases.push_back({fmt::format("{} u16{}", modeName, hasRestartIndices ? " restart" : ""), primitiveMode, LatteIndexType::U16_BE, 0, 0xFFFFFFFF, hasRestartIndices});
+			cases.push_back({fmt::format("{} u32{}", modeName, hasRestartIndices ? " restart" : ""), primitiveMode, LatteIndexType::U32_BE, 0, 0xFFFFFFFF, hasRestartIndices});
+		}
+	}
+	return cases;
+}
+
+bool LatteIndices_RunSelfCheck()
+{
+	IndexCheckRNG rng(1);
+	const std::vector<IndexCheckCase> cases = IndexCheck_getCases();
+	uint32 caseCount = 0;
+	uint32 failedCount = 0;
+	for (const IndexCheckCase& checkCase : cases)
+	{
+		for (uint32 count = 1; count <= INDEX_CHECK_SHORT_COUNT; count++, caseCount++)
+			failedCount += IndexCheck_runCase(rng, checkCase, checkCase.minCount + count) ? 0 : 1;
+		const uint32 maxCount = std::min(checkCase.maxCount, checkCase.minCount + INDEX_CHECK_RANDOM_MAX_COUNT);
+		for (uint32 i = 0; i < INDEX_CHECK_RANDOM_ITERATIONS; i++, caseCount++)
+			failedCount += IndexCheck_runCase(rng, checkCase, rng.Range(checkCase.minCount + 1, maxCount)) ? 0 : 1;
+	}
+	fmt::print("Index decoding self check: {} of {} cases passed\n", caseCount - failedCount, caseCount);
+
+	fmt::print("{:<28} {:>12} {:>12}\n", "", "scalar", "SIMD");
+	std::vector<uint8> indexData;
+	for (const IndexCheckCase& checkCase : cases)
+	{
+		const uint32 count = std::min(checkCase.maxCount, checkCase.minCount + INDEX_CHECK_BENCHMARK_COUNT);
+		IndexCheck_generateIndexData(rng, checkCase, count, indexData);
+		double scalarMs = IndexCheck_measure(checkCase, indexData, count, false);
+		double simdMs = IndexCheck_measure(checkCase, indexData, count, true);
+		fmt::print("{:<28} {:10.2f}ms {:10.2f}ms\n", checkCase.name, scalarMs, simdMs);
+	}
+	return failedCount == 0;
+}
@@ -1,5 +1,6 @@
 #include "Cafe/HW/Latte/Core/LatteOverlay.h"
 #include "Cafe/HW/Latte/Core/LattePerformanceMonitor.h"
+#include "Cafe/HW/Latte/Core/Latte.h"
 #include "Cafe/HW/Latte/Renderer/Renderer.h"
 #include "Cafe/Account/Account.h"
 #include "config/CemuConfig.h"
@@ -105,11 +106,26 @@ void LatteOverlay_renderOverlay(ImVec2& position, ImVec2& pivot, sint32 directio
 			if(config.overlay.vram_usage && g_state.vramUsage != -1 && g_state.vramTotal != -1)
 				ImGui::Text("VRAM: %dMB / %dMB", g_state.vramUsage, g_state.vramTotal);
 
+			if (config.overlay.vram_usage)
+			{
+				uint64 textureMemoryUsage, textureMemoryBudget;
+				uint32 textureEvictionCount;
+				LatteTC_GetMemoryBudgetStats(textureMemoryUsage, textureMemoryBudget, textureEvictionCount);
+				if (textureMemoryBudget != 0)
+					ImGui::Text("Textures: %dMB / %dMB (evicted: %u)", (int)(textureMemoryUsage / 1024 / 1024), (int)(textureMemoryBudget / 1024 / 1024), textureEvictionCount);
+				else
+					ImGui::Text("Textures: %dMB", (int)(textureMemoryUsage / 1024 / 1024));
+			}
+
 			if (config.overlay.debug)
 			{
 				// general debug info
 				ImGui::Text("--- Debug info ---");
 				ImGui::Text("IndexUploadPerFrame: %dKB", (performanceMonitor.stats.indexDataUploadPerFrame+1023)/1024);
+				LatteTextureViewLookupCache::LookupStats viewLookupStats = LatteTextureViewLookupCache::GetStats();
+				if (viewLookupStats.lookupCount != 0)
+					ImGui::Text("ViewLookup: %.1f%% hits, avg probe %.2f, max probe %u", (double)viewLookupStats.hitCount * 100.0 / (double)viewLookupStats.lookupCount, (double)viewLookupStats.probeCount / (double)viewLookupStats.lookupCount, viewLookupStats.maxProbeLength);
+				ImGui::Text("ViewLookupGroups: %u / %u", viewLookupStats.groupCount, viewLookupStats.capacity);
 				// backend specific info
 				g_renderer->AppendOverlayDebugInfo();
 			}
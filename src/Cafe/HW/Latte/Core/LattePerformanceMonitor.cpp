@@ -120,4 +120,8 @@ void LattePerformanceMonitor_frameBegin()
 {
 	performanceMonitor.vk.numDrawBarriersPerFrame.reset();
 	performanceMonitor.vk.numBeginRenderpassPerFrame.reset();
+	performanceMonitor.vk.numPipelineLookupsPerFrame.reset();
+	performanceMonitor.vk.numPipelineFastLookupsPerFrame.reset();
+	performanceMonitor.vk.numDescriptorSetLookupsPerFrame.reset();
+	performanceMonitor.vk.numDescriptorSetFastLookupsPerFrame.reset();
 }
@@ -1,4 +1,5 @@
 #pragma once
+#include "util/TraceRecorder/TraceRecorder.h"
 
 #define PERFORMANCE_MONITOR_TRACK_CYCLES	(5) // one cycle lasts one second
 
@@ -9,15 +10,25 @@ uint64 PPCTimer_tscToMicroseconds(uint64 us);
 class LattePerfStatTimer
 {
 public:
+	// traceName is used for the measured spans while the trace recorder is active
+	LattePerfStatTimer(const char* traceName) : m_traceName(traceName) {};
+
 	void beginMeasuring()
 	{
 		timerStart = PPCTimer_getRawTsc();
+		if (TraceRecorder::IsRecording())
+			m_traceBegin = HighResolutionTimer::now().getTick();
 	}
 
 	void endMeasuring()
 	{
 		uint64 dif = PPCTimer_getRawTsc() - timerStart;
 		currentSum += dif;
+		if (m_traceBegin != 0)
+		{
+			TraceRecorder::CompleteEvent("gpu", m_traceName, m_traceBegin, HighResolutionTimer::now().getTick());
+			m_traceBegin = 0;
+		}
 	}
 
 	void frameFinished()
@@ -35,6 +46,8 @@ private:
 	uint64 currentSum{};
 	uint64 previousFrame{};
 	uint64 timerStart{};
+	const char* m_traceName;
+	HRTick m_traceBegin{};
 };
 
 class LattePerfStatCounter
@@ -95,19 +108,19 @@ typedef struct
 	}cycle[PERFORMANCE_MONITOR_TRACK_CYCLES];
 	sint32 cycleIndex;
 	// new stats
-	LattePerfStatTimer gpuTime_frameTime;
-	LattePerfStatTimer gpuTime_shaderCreate;
-	LattePerfStatTimer gpuTime_idleTime; // time spent waiting for new commands from CPU
-	LattePerfStatTimer gpuTime_fenceTime; // time spent waiting for fence condition
+	LattePerfStatTimer gpuTime_frameTime{"Frame"};
+	LattePerfStatTimer gpuTime_shaderCreate{"ShaderCreate"};
+	LattePerfStatTimer gpuTime_idleTime{"Idle"}; // time spent waiting for new commands from CPU
+	LattePerfStatTimer gpuTime_fenceTime{"WaitFence"}; // time spent waiting for fence condition
 
-	LattePerfStatTimer gpuTime_dcStageTextures; // drawcall texture/mrt setup
-	LattePerfStatTimer gpuTime_dcStageVertexMgr; // drawcall vertex setup and upload
-	LattePerfStatTimer gpuTime_dcStageShaderAndUniformMgr; // drawcall shader setup and uniform management/upload
-	LattePerfStatTimer gpuTime_dcStageIndexMgr; // drawcall index data setup and upload
-	LattePerfStatTimer gpuTime_dcStageMRT; // drawcall render target API
+	LattePerfStatTimer gpuTime_dcStageTextures{"DrawTextures"}; // drawcall texture/mrt setup
+	LattePerfStatTimer gpuTime_dcStageVertexMgr{"DrawVertexMgr"}; // drawcall vertex setup and upload
+	LattePerfStatTimer gpuTime_dcStageShaderAndUniformMgr{"DrawShaderAndUniformMgr"}; // drawcall shader setup and uniform management/upload
+	LattePerfStatTimer gpuTime_dcStageIndexMgr{"DrawIndexMgr"}; // drawcall index data setup and upload
+	LattePerfStatTimer gpuTime_dcStageMRT{"DrawMRT"}; // drawcall render target API
 
-	LattePerfStatTimer gpuTime_dcStageDrawcallAPI; // drawcall api call
-	LattePerfStatTimer gpuTime_waitForAsync; // waiting for operations to complete (e.g. GX2DrawDone or force texture readback) Also includes texture readback and occlusion query polling logic
+	LattePerfStatTimer gpuTime_dcStageDrawcallAPI{"DrawAPI"}; // drawcall api call
+	LattePerfStatTimer gpuTime_waitForAsync{"WaitForAsync"}; // waiting for operations to complete (e.g. GX2DrawDone or force texture readback) Also includes texture readback and occlusion query polling logic
 
 	// generic
 	uint32 numCompiledVS; // number of compiled vertex shader programs
@@ -131,6 +144,10 @@ typedef struct
 		// per frame
 		LattePerfStatCounter numDrawBarriersPerFrame;
 		LattePerfStatCounter numBeginRenderpassPerFrame;
+		LattePerfStatCounter numPipelineLookupsPerFrame;
+		LattePerfStatCounter numPipelineFastLookupsPerFrame; // lookups which reused the previous pipeline because no hashed register changed
+		LattePerfStatCounter numDescriptorSetLookupsPerFrame;
+		LattePerfStatCounter numDescriptorSetFastLookupsPerFrame; // lookups which reused the previous descriptor set of the stage
 	}vk;
 
 	// calculated stats (per frame)
@@ -3,6 +3,7 @@
 #include "Cafe/HW/Latte/ISA/RegDefines.h"
 #include "Cafe/HW/Latte/ISA/LatteReg.h"
 #include "Cafe/HW/Latte/Core/LatteShader.h"
+#include "Cafe/HW/Latte/Core/LatteShaderDecompileJob.h"
 #include "Cafe/HW/Latte/LegacyShaderDecompiler/LatteDecompiler.h"
 #include "Cafe/HW/Latte/Core/FetchShader.h"
 #include "Cafe/HW/Latte/Core/LattePerformanceMonitor.h"
@@ -13,6 +14,7 @@
 #include "HW/Latte/Renderer/Renderer.h"
 #include "util/helpers/StringParser.h"
 #include "config/ActiveSettings.h"
+#include "config/LaunchSettings.h"
 #include "Cafe/GameProfile/GameProfile.h"
 #include "util/containers/flat_hash_map.hpp"
 #if ENABLE_METAL
@@ -22,6 +24,7 @@
 
 // experimental new decompiler (WIP)
 #include "util/Zir/EmitterGLSL/ZpIREmitGLSL.h"
+#include "util/Zir/EmitterSPIRV/ZpIREmitSPIRV.h"
 #include "util/Zir/Core/ZpIRDebug.h"
 #include "Cafe/HW/Latte/Transcompiler/LatteTC.h"
 #include "Cafe/HW/Latte/ShaderInfo/ShaderInfo.h"
@@ -360,7 +363,10 @@ void LatteShader_CreateRendererShader(LatteDecompilerShader* shader, bool compil
 	}
 
 	// create shader
-	shader->shader = g_renderer->shader_create(shaderType, shader->baseHash, shader->auxHash, shaderSrc, true, shader->isCustomShader);
+	if (!shader->spirvFromIR.empty() && !shader->isCustomShader)
+		shader->shader = VulkanRenderer::GetInstance()->shader_create(shaderType, shader->baseHash, shader->auxHash, shaderSrc, std::move(shader->spirvFromIR));
+	else
+		shader->shader = g_renderer->shader_create(shaderType, shader->baseHash, shader->auxHash, shaderSrc, true, shader->isCustomShader);
 	if (shader->shader == nullptr)
 		shader->hasError = true;
 	// after renderer shader creation we can throw away any intermediate info
@@ -447,6 +453,8 @@ void LatteShader_CleanupAfterCompile(LatteDecompilerShader* shader)
 		delete shader->strBuf_shaderSource;
 		shader->strBuf_shaderSource = nullptr;
 	}
+	shader->spirvFromIR.clear();
+	shader->spirvFromIR.shrink_to_fit();
 }
 
 void LatteShader_DumpShader(uint64 baseHash, uint64 auxHash, LatteDecompilerShader* shader)
@@ -764,6 +772,7 @@ LatteDecompilerShader* LatteShader_CreateShaderFromDecompilerOutput(LatteDecompi
 void LatteShader_GetDecompilerOptions(LatteDecompilerOptions& options, LatteConst::ShaderType shaderType, bool geometryShaderEnabled)
 {
 	options.usesGeometryShader = geometryShaderEnabled;
+	options.psInputTable = LatteSHRC_GetPSInputTable();
 	options.spirvInstrinsics.hasRoundingModeRTEFloat32 = false;
 	options.useTFViaSSBO = g_renderer->UseTFViaSSBO();
 	if (g_renderer->GetType() == RendererAPI::Vulkan)
@@ -820,28 +829,152 @@ LatteDecompilerShader* LatteShader_CompileSeparableVertexShader2(uint64 baseHash
 	return nullptr;
 }
 
-// compile new vertex shader (relies partially on current state)
-LatteDecompilerShader* LatteShader_CompileSeparableVertexShader(uint64 baseHash, uint64& vsAuxHash, uint8* vertexShaderPtr, uint32 vertexShaderSize, bool usesGeometryShader, LatteFetchShader* fetchShader)
+// experimental: translate the vertex shader via the IR and emit SPIR-V directly, skipping the GLSL + glslang round trip
+// only a small subset of shaders is supported so far, everything else keeps using the GLSL from the legacy decompiler
+// the legacy decompiler output still determines the resource layout, we only generate a module which matches it
+void LatteShader_EmitVertexShaderSPIRVFromIR(LatteDecompilerShader* vertexShader, LatteShaderDecompileJob* job)
+{
+	if (g_renderer->GetType() != RendererAPI::Vulkan || !LaunchSettings::ZirSPIRVEnabled())
+		return;
+	if (vertexShader->hasError || job->usesGeometryShader || vertexShader->hasStreamoutBufferWrite || vertexShader->textureUnitListCount != 0)
+		return;
+	if (vertexShader->uniformMode != LATTE_DECOMPILER_UNIFORM_MODE_NONE && vertexShader->uniformMode != LATTE_DECOMPILER_UNIFORM_MODE_REMAPPED)
+		return;
+	// special uniforms are not known to the IR
+	if (vertexShader->uniform.loc_windowSpaceToClipSpaceTransform >= 0 || vertexShader->uniform.loc_pointSize >= 0 || vertexShader->uniform.loc_verticesPerInstance >= 0)
+		return;
+	uint32* contextRegisters = job->GetContextRegisters();
+
+	LatteTCGenIR genIR;
+	genIR.setVertexShaderContext(job->fetchShader, contextRegisters + mmSQ_VTX_SEMANTIC_0);
+	ZpIR::ZpIRFunction* irFunction = genIR.transcompileLatteToIR(job->programData.data(), (uint32)job->programData.size(), LatteTCGenIR::VERTEX);
+	if (!irFunction)
+	{
+		cemuLog_logDebug(LogType::Force, "Vertex shader {:016x}_{:016x} not supported by IR generator: {}", vertexShader->baseHash, vertexShader->auxHash, genIR.getErrorMessage());
+		return;
+	}
+
+	auto& resourceMapping = vertexShader->resourceMapping;
+	ZirEmitter::SPIRV::VertexShaderInterface shaderInterface;
+	shaderInterface.descriptorSet = resourceMapping.setIndex;
+	shaderInterface.uniformBinding = resourceMapping.uniformVarsBufferBindingPoint;
+	if (vertexShader->uniformMode == LATTE_DECOMPILER_UNIFORM_MODE_REMAPPED)
+	{
+		shaderInterface.uniformArrayOffset = vertexShader->uniform.loc_remapped;
+		shaderInterface.uniformArraySize = (uint32)vertexShader->list_remappedUniformEntries.size();
+		for (auto& entry : vertexShader->list_remappedUniformEntries)
+		{
+			if (!entry.isRegister)
+				continue;
+			if (shaderInterface.uniformRemap.size() <= entry.index)
+				shaderInterface.uniformRemap.resize(entry.index + 1, -1);
+			shaderInterface.uniformRemap[entry.index] = (sint32)entry.mappedIndex;
+		}
+	}
+	if (shaderInterface.uniformRemap.empty())
+		shaderInterface.uniformRemap.emplace_back(-1); // no uniforms available
+	shaderInterface.attributeLocation.assign(std::begin(resourceMapping.attributeMapping), std::end(resourceMapping.attributeMapping));
+	// parameter index -> semantic id -> PS input index, same as _emitVSExports() in the GLSL emitter
+	LatteShaderPSInputTable* psInputTable = &job->psInputTable;
+	shaderInterface.outputLocation.resize(32);
+	shaderInterface.zeroedOutputLocationMask = 0xFFFFFFFF;
+	for (sint32 i = 0; i < 32; i++)
+	{
+		sint32 vsSemanticId = LatteShaderPSInputTable::getVertexShaderOutParamSemanticId(contextRegisters, i);
+		if (vsSemanticId > LATTE_ANALYZER_IMPORT_INDEX_PARAM_MAX)
+			continue;
+		for (sint32 f = 0; f < psInputTable->count; f++)
+		{
+			if (psInputTable->import[f].semanticId != (uint32)vsSemanticId)
+				continue;
+			auto& output = shaderInterface.outputLocation[i];
+			output.location = f;
+			output.isFlat = psInputTable->import[f].isFlat;
+			output.isNoPerspective = psInputTable->import[f].isNoPerspective;
+			break;
+		}
+	}
+	shaderInterface.remapDepthToVulkan = !job->contextRegister->PA_CL_CLIP_CNTL.get_DX_CLIP_SPACE_DEF();
+
+	ZirEmitter::SPIRV spirvEmitter(shaderInterface);
+	if (!spirvEmitter.Emit(irFunction, vertexShader->spirvFromIR))
+		cemuLog_logDebug(LogType::Force, "Vertex shader {:016x}_{:016x} not supported by SPIR-V emitter: {}", vertexShader->baseHash, vertexShader->auxHash, spirvEmitter.GetErrorMessage());
+	delete irFunction;
+}
+
+// shaders which are decompiled in the background. They are finalized on the GPU thread once they are done and requested again
+std::vector<LatteShaderDecompileJob*> sPendingDecompileJobs;
+
+LatteShaderDecompileJob* LatteSHRC_FindPendingJob(LatteConst::ShaderType shaderType, uint64 baseHash, bool hasAuxHash, uint64 auxHash)
+{
+	for (auto& it : sPendingDecompileJobs)
+	{
+		if (it->shaderType != shaderType || it->baseHash != baseHash)
+			continue;
+		// a job without aux hash was queued for a shader with unknown base hash and covers all variants until it is finalized
+		if (!it->hasAuxHash || !hasAuxHash || it->auxHash == auxHash)
+			return it;
+	}
+	return nullptr;
+}
+
+LatteShaderDecompileJob* LatteShader_CreateVertexShaderJob(uint64 baseHash, bool hasAuxHash, uint64 vsAuxHash, uint8* vertexShaderPtr, uint32 vertexShaderSize, bool usesGeometryShader, LatteFetchShader* fetchShader)
 {
 	// new decompiler test
 	//LatteShader_CompileSeparableVertexShader2(baseHash, vsAuxHash, vertexShaderPtr, vertexShaderSize, usesGeometryShader, fetchShader);
 
-	// legacy decompiler
-	LatteDecompilerOptions options;
-	LatteShader_GetDecompilerOptions(options, LatteConst::ShaderType::Vertex, usesGeometryShader);
+	LatteShaderDecompileJob* job = new LatteShaderDecompileJob(LatteConst::ShaderType::Vertex, baseHash, std::make_unique<LatteContextRegister>(LatteGPUState.contextNew));
+	job->hasAuxHash = hasAuxHash;
+	job->auxHash = vsAuxHash;
+	LatteShader_GetDecompilerOptions(job->options, LatteConst::ShaderType::Vertex, usesGeometryShader);
+	job->psInputTable = *LatteSHRC_GetPSInputTable();
+	job->programData.assign(vertexShaderPtr, vertexShaderPtr + vertexShaderSize);
+	uint8* fsProgramCode = (uint8*)memory_getPointerFromPhysicalOffset(LatteGPUState.contextRegister[mmSQ_PGM_START_FS + 0] << 8);
+	uint32 fsProgramSize = LatteGPUState.contextRegister[mmSQ_PGM_START_FS + 1] << 3;
+	job->fetchShaderData.assign(fsProgramCode, fsProgramCode + fsProgramSize);
+	job->fetchShader = fetchShader;
+	job->usesGeometryShader = usesGeometryShader;
+	return job;
+}
 
-	LatteDecompilerOutput_t decompilerOutput{};
-	LatteDecompiler_DecompileVertexShader(_shaderBaseHash_vs, LatteGPUState.contextRegister, vertexShaderPtr, vertexShaderSize, fetchShader, options, &decompilerOutput);
-	LatteDecompilerShader* vertexShader = LatteShader_CreateShaderFromDecompilerOutput(decompilerOutput, baseHash, true, 0, LatteGPUState.contextRegister);
-	vsAuxHash = vertexShader->auxHash;
+LatteShaderDecompileJob* LatteShader_CreateGeometryShaderJob(uint64 baseHash, uint8* geometryShaderPtr, uint32 geometryShaderSize, uint8* geometryCopyShader, uint32 geometryCopyShaderSize)
+{
+	LatteShaderDecompileJob* job = new LatteShaderDecompileJob(LatteConst::ShaderType::Geometry, baseHash, std::make_unique<LatteContextRegister>(LatteGPUState.contextNew));
+	LatteShader_GetDecompilerOptions(job->options, LatteConst::ShaderType::Geometry, true);
+	job->psInputTable = *LatteSHRC_GetPSInputTable();
+	job->programData.assign(geometryShaderPtr, geometryShaderPtr + geometryShaderSize);
+	if (geometryCopyShader)
+		job->gsCopyProgramData.assign(geometryCopyShader, geometryCopyShader + geometryCopyShaderSize);
+	job->vsRingParameterCount = _activeVertexShader->ringParameterCount;
+	job->usesGeometryShader = true;
+	return job;
+}
+
+LatteShaderDecompileJob* LatteShader_CreatePixelShaderJob(uint64 baseHash, bool hasAuxHash, uint64 psAuxHash, uint8* pixelShaderPtr, uint32 pixelShaderSize, bool usesGeometryShader)
+{
+	LatteShaderDecompileJob* job = new LatteShaderDecompileJob(LatteConst::ShaderType::Pixel, baseHash, std::make_unique<LatteContextRegister>(LatteGPUState.contextNew));
+	job->hasAuxHash = hasAuxHash;
+	job->auxHash = psAuxHash;
+	LatteShader_GetDecompilerOptions(job->options, LatteConst::ShaderType::Pixel, usesGeometryShader);
+	job->psInputTable = *LatteSHRC_GetPSInputTable();
+	job->programData.assign(pixelShaderPtr, pixelShaderPtr + pixelShaderSize);
+	job->usesGeometryShader = usesGeometryShader;
+	return job;
+}
+
+// create and register the shader from a finished decompile job. Uses the state captured by the job rather than the current GPU state
+LatteDecompilerShader* LatteShader_FinishVertexShaderJob(LatteShaderDecompileJob* job)
+{
+	uint32* contextRegisters = job->GetContextRegisters();
+	LatteDecompilerShader* vertexShader = LatteShader_CreateShaderFromDecompilerOutput(job->output, job->baseHash, true, 0, contextRegisters);
 	if (vertexShader->hasError == false)
 	{
-		uint8* fsProgramCode = (uint8*)memory_getPointerFromPhysicalOffset(LatteGPUState.contextRegister[mmSQ_PGM_START_FS + 0] << 8);
-		uint32 fsProgramSize = LatteGPUState.contextRegister[mmSQ_PGM_START_FS + 1] << 3;
-		LatteShaderCache_writeSeparableVertexShader(vertexShader->baseHash, vertexShader->auxHash, fsProgramCode, fsProgramSize, vertexShaderPtr, vertexShaderSize, LatteGPUState.contextRegister, usesGeometryShader);
+		LatteShaderCache_writeSeparableVertexShader(vertexShader->baseHash, vertexShader->auxHash, job->fetchShaderData.data(), job->fetchShaderData.size(), job->programData.data(), job->programData.size(), contextRegisters, job->usesGeometryShader);
 	}
 	LatteShader_DumpShader(vertexShader->baseHash, vertexShader->auxHash, vertexShader);
-	LatteShader_DumpRawShader(vertexShader->baseHash, vertexShader->auxHash, SHADER_DUMP_TYPE_VERTEX, vertexShaderPtr, vertexShaderSize);
+	LatteShader_DumpRawShader(vertexShader->baseHash, vertexShader->auxHash, SHADER_DUMP_TYPE_VERTEX, job->programData.data(), job->programData.size());
+	LatteShader_DumpRawShader(vertexShader->baseHash, vertexShader->auxHash, SHADER_DUMP_TYPE_FETCH, job->fetchShaderData.data(), job->fetchShaderData.size());
+	LatteShader_EmitVertexShaderSPIRVFromIR(vertexShader, job);
 	LatteShader_CreateRendererShader(vertexShader, false);
 	performanceMonitor.numCompiledVS++;
 
@@ -856,21 +989,18 @@ LatteDecompilerShader* LatteShader_CompileSeparableVertexShader(uint64 baseHash,
 	return vertexShader;
 }
 
-LatteDecompilerShader* LatteShader_CompileSeparableGeometryShader(uint64 baseHash, uint8* geometryShaderPtr, uint32 geometryShaderSize, uint8* geometryCopyShader, uint32 geometryCopyShaderSize)
+LatteDecompilerShader* LatteShader_FinishGeometryShaderJob(LatteShaderDecompileJob* job)
 {
-	LatteDecompilerOptions options;
-	LatteShader_GetDecompilerOptions(options, LatteConst::ShaderType::Geometry, true);
-
-	LatteDecompilerOutput_t decompilerOutput{};
-	LatteDecompiler_DecompileGeometryShader(_shaderBaseHash_gs, LatteGPUState.contextRegister, geometryShaderPtr, geometryShaderSize, geometryCopyShader, geometryCopyShaderSize, _activeVertexShader->ringParameterCount, options, &decompilerOutput);
-	LatteDecompilerShader* geometryShader = LatteShader_CreateShaderFromDecompilerOutput(decompilerOutput, baseHash, true, 0, LatteGPUState.contextRegister);
+	uint32* contextRegisters = job->GetContextRegisters();
+	LatteDecompilerShader* geometryShader = LatteShader_CreateShaderFromDecompilerOutput(job->output, job->baseHash, true, 0, contextRegisters);
+	uint8* gsCopyProgram = job->gsCopyProgramData.empty() ? nullptr : job->gsCopyProgramData.data();
 	if (geometryShader->hasError == false)
 	{
-		LatteShaderCache_writeSeparableGeometryShader(geometryShader->baseHash, geometryShader->auxHash, geometryShaderPtr, geometryShaderSize, geometryCopyShader, geometryCopyShaderSize, LatteGPUState.contextRegister, LatteGPUState.contextNew.GetSpecialStateValues(), _activeVertexShader->ringParameterCount);
+		LatteShaderCache_writeSeparableGeometryShader(geometryShader->baseHash, geometryShader->auxHash, job->programData.data(), job->programData.size(), gsCopyProgram, job->gsCopyProgramData.size(), contextRegisters, job->contextRegister->GetSpecialStateValues(), job->vsRingParameterCount);
 	}
 	LatteShader_DumpShader(geometryShader->baseHash, geometryShader->auxHash, geometryShader);
-	LatteShader_DumpRawShader(geometryShader->baseHash, geometryShader->auxHash, SHADER_DUMP_TYPE_GEOMETRY, geometryShaderPtr, geometryShaderSize);
-	LatteShader_DumpRawShader(geometryShader->baseHash, geometryShader->auxHash, SHADER_DUMP_TYPE_COPY, geometryCopyShader, geometryCopyShaderSize);
+	LatteShader_DumpRawShader(geometryShader->baseHash, geometryShader->auxHash, SHADER_DUMP_TYPE_GEOMETRY, job->programData.data(), job->programData.size());
+	LatteShader_DumpRawShader(geometryShader->baseHash, geometryShader->auxHash, SHADER_DUMP_TYPE_COPY, gsCopyProgram, job->gsCopyProgramData.size());
 	LatteShader_CreateRendererShader(geometryShader, false);
 	performanceMonitor.numCompiledGS++;
 
@@ -885,22 +1015,18 @@ LatteDecompilerShader* LatteShader_CompileSeparableGeometryShader(uint64 baseHas
 	return geometryShader;
 }
 
-LatteDecompilerShader* LatteShader_CompileSeparablePixelShader(uint64 baseHash, uint64& psAuxHash, uint8* pixelShaderPtr, uint32 pixelShaderSize, bool usesGeometryShader)
+LatteDecompilerShader* LatteShader_FinishPixelShaderJob(LatteShaderDecompileJob* job)
 {
-	LatteDecompilerOptions options;
-	LatteShader_GetDecompilerOptions(options, LatteConst::ShaderType::Pixel, usesGeometryShader);
-
-	LatteDecompilerOutput_t decompilerOutput{};
-	LatteDecompiler_DecompilePixelShader(baseHash, LatteGPUState.contextRegister, pixelShaderPtr, pixelShaderSize, options, &decompilerOutput);
-	LatteDecompilerShader* pixelShader = LatteShader_CreateShaderFromDecompilerOutput(decompilerOutput, baseHash, true, 0, LatteGPUState.contextRegister);
-	psAuxHash = pixelShader->auxHash;
-	LatteShader_DumpShader(_shaderBaseHash_ps, psAuxHash, pixelShader);
-	LatteShader_DumpRawShader(_shaderBaseHash_ps, psAuxHash, SHADER_DUMP_TYPE_PIXEL, pixelShaderPtr, pixelShaderSize);
+	uint32* contextRegisters = job->GetContextRegisters();
+	LatteDecompilerShader* pixelShader = LatteShader_CreateShaderFromDecompilerOutput(job->output, job->baseHash, true, 0, contextRegisters);
+	uint64 psAuxHash = pixelShader->auxHash;
+	LatteShader_DumpShader(job->baseHash, psAuxHash, pixelShader);
+	LatteShader_DumpRawShader(job->baseHash, psAuxHash, SHADER_DUMP_TYPE_PIXEL, job->programData.data(), job->programData.size());
 	LatteShader_CreateRendererShader(pixelShader, false);
 	performanceMonitor.numCompiledPS++;
 	if (pixelShader->hasError == false)
 	{
-		LatteShaderCache_writeSeparablePixelShader(_shaderBaseHash_ps, psAuxHash, pixelShaderPtr, pixelShaderSize, LatteGPUState.contextRegister, usesGeometryShader);
+		LatteShaderCache_writeSeparablePixelShader(job->baseHash, psAuxHash, job->programData.data(), job->programData.size(), contextRegisters, job->usesGeometryShader);
 	}
 
 	if (g_renderer->GetType() == RendererAPI::OpenGL)
@@ -910,24 +1036,77 @@ LatteDecompilerShader* LatteShader_CompileSeparablePixelShader(uint64 baseHash,
 		LatteShader_FinishCompilation(pixelShader);
 	}
 
-	LatteSHRC_RegisterShader(pixelShader, _shaderBaseHash_ps, psAuxHash);
+	LatteSHRC_RegisterShader(pixelShader, job->baseHash, psAuxHash);
 	return pixelShader;
 }
 
-void LatteSHRC_UpdateVertexShader(uint8* vertexShaderPtr, uint32 vertexShaderSize, bool usesGeometryShader)
+LatteDecompilerShader* LatteShader_FinishJob(LatteShaderDecompileJob* job)
+{
+	if (job->shaderType == LatteConst::ShaderType::Vertex)
+		return LatteShader_FinishVertexShaderJob(job);
+	else if (job->shaderType == LatteConst::ShaderType::Geometry)
+		return LatteShader_FinishGeometryShaderJob(job);
+	cemu_assert_debug(job->shaderType == LatteConst::ShaderType::Pixel);
+	return LatteShader_FinishPixelShaderJob(job);
+}
+
+// decompiles the job on the GPU thread or, if allowAsync is set, hands it to the decompiler threads
+// returns the new shader or nullptr if it is still being decompiled
+LatteDecompilerShader* LatteSHRC_SubmitJob(LatteShaderDecompileJob* job, bool allowAsync)
+{
+	if (!allowAsync)
+	{
+		job->DecompileSync();
+		LatteDecompilerShader* shader = LatteShader_FinishJob(job);
+		delete job;
+		return shader;
+	}
+	job->QueueAsync();
+	sPendingDecompileJobs.emplace_back(job);
+	return nullptr;
+}
+
+// returns false if the job is still running and allowAsync is set. Otherwise the shader is registered and can be looked up
+bool LatteSHRC_TryFinishPendingJob(LatteShaderDecompileJob* job, bool allowAsync)
+{
+	if (allowAsync && !job->IsDone())
+		return false;
+	job->WaitForCompletion();
+	sPendingDecompileJobs.erase(std::find(sPendingDecompileJobs.begin(), sPendingDecompileJobs.end(), job));
+	LatteShader_FinishJob(job);
+	delete job;
+	return true;
+}
+
+void LatteSHRC_UpdateVertexShader(uint8* vertexShaderPtr, uint32 vertexShaderSize, bool usesGeometryShader, bool allowAsync)
 {
 	// todo - should include VTX_SEMANTIC table in state
 	LatteSHRC_UpdateVSBaseHash(vertexShaderPtr, vertexShaderSize, usesGeometryShader);
-	uint64 vsAuxHash = 0;
-	auto itBaseShader = sVertexShaders.find(_shaderBaseHash_vs);
 	LatteDecompilerShader* vertexShader = nullptr;
-	if (itBaseShader != sVertexShaders.end())
+	while (true)
 	{
-		vsAuxHash = LatteSHRC_CalcVSAuxHash(itBaseShader->second, LatteGPUState.contextRegister);
-		vertexShader = LatteSHRC_GetFromChain(itBaseShader->second, _shaderBaseHash_vs, vsAuxHash);
+		uint64 vsAuxHash = 0;
+		auto itBaseShader = sVertexShaders.find(_shaderBaseHash_vs);
+		bool hasBaseShader = itBaseShader != sVertexShaders.end();
+		if (hasBaseShader)
+		{
+			vsAuxHash = LatteSHRC_CalcVSAuxHash(itBaseShader->second, LatteGPUState.contextRegister);
+			vertexShader = LatteSHRC_GetFromChain(itBaseShader->second, _shaderBaseHash_vs, vsAuxHash);
+			if (vertexShader)
+				break;
+		}
+		LatteShaderDecompileJob* job = LatteSHRC_FindPendingJob(LatteConst::ShaderType::Vertex, _shaderBaseHash_vs, hasBaseShader, vsAuxHash);
+		if (!job)
+		{
+			vertexShader = LatteSHRC_SubmitJob(LatteShader_CreateVertexShaderJob(_shaderBaseHash_vs, hasBaseShader, vsAuxHash, vertexShaderPtr, vertexShaderSize, usesGeometryShader, _activeFetchShader), allowAsync);
+			if (vertexShader)
+				break;
+		}
+		else if (LatteSHRC_TryFinishPendingJob(job, allowAsync))
+			continue; // the finished job may have been decompiled with a different state, look up again
+		LatteGPUState.activeShaderIsPending = true;
+		return;
 	}
-	if (!vertexShader)
-		vertexShader = LatteShader_CompileSeparableVertexShader(_shaderBaseHash_vs, vsAuxHash, vertexShaderPtr, vertexShaderSize, usesGeometryShader, _activeFetchShader);
 	if (vertexShader->hasError)
 	{
 		LatteGPUState.activeShaderHasError = true;
@@ -936,7 +1115,7 @@ void LatteSHRC_UpdateVertexShader(uint8* vertexShaderPtr, uint32 vertexShaderSiz
 	_activeVertexShader = vertexShader;
 }
 
-void LatteSHRC_UpdateGeometryShader(bool usesGeometryShader, uint8* geometryShaderPtr, uint32 geometryShaderSize, uint8* geometryCopyShader, uint32 geometryCopyShaderSize)
+void LatteSHRC_UpdateGeometryShader(bool usesGeometryShader, uint8* geometryShaderPtr, uint32 geometryShaderSize, uint8* geometryCopyShader, uint32 geometryCopyShaderSize, bool allowAsync)
 {
 	if (!usesGeometryShader || !_activeVertexShader)
 	{
@@ -945,18 +1124,29 @@ void LatteSHRC_UpdateGeometryShader(bool usesGeometryShader, uint8* geometryShad
 		return;
 	}
 	LatteSHRC_UpdateGSBaseHash(geometryShaderPtr, geometryShaderSize, geometryCopyShader, geometryCopyShaderSize);
-	auto itBaseShader = sGeometryShaders.find(_shaderBaseHash_gs);
-	LatteDecompilerShader* geometryShader;
-	if (itBaseShader != sGeometryShaders.end())
+	LatteDecompilerShader* geometryShader = nullptr;
+	while (true)
 	{
-		// geometry shader already known
-		geometryShader = itBaseShader->second;
-		cemu_assert_debug(LatteSHRC_CalcGSAuxHash(geometryShader) == 0);
-	}
-	else
-	{
-		// decompile geometry shader
-		geometryShader = LatteShader_CompileSeparableGeometryShader(_shaderBaseHash_gs, geometryShaderPtr, geometryShaderSize, geometryCopyShader, geometryCopyShaderSize);
+		auto itBaseShader = sGeometryShaders.find(_shaderBaseHash_gs);
+		if (itBaseShader != sGeometryShaders.end())
+		{
+			// geometry shader already known
+			geometryShader = itBaseShader->second;
+			cemu_assert_debug(LatteSHRC_CalcGSAuxHash(geometryShader) == 0);
+			break;
+		}
+		LatteShaderDecompileJob* job = LatteSHRC_FindPendingJob(LatteConst::ShaderType::Geometry, _shaderBaseHash_gs, false, 0);
+		if (!job)
+		{
+			// decompile geometry shader
+			geometryShader = LatteSHRC_SubmitJob(LatteShader_CreateGeometryShaderJob(_shaderBaseHash_gs, geometryShaderPtr, geometryShaderSize, geometryCopyShader, geometryCopyShaderSize), allowAsync);
+			if (geometryShader)
+				break;
+		}
+		else if (LatteSHRC_TryFinishPendingJob(job, allowAsync))
+			continue;
+		LatteGPUState.activeShaderIsPending = true;
+		return;
 	}
 	if (geometryShader->hasError)
 	{
@@ -966,19 +1156,34 @@ void LatteSHRC_UpdateGeometryShader(bool usesGeometryShader, uint8* geometryShad
 	_activeGeometryShader = geometryShader;
 }
 
-void LatteSHRC_UpdatePixelShader(uint8* pixelShaderPtr, uint32 pixelShaderSize, bool usesGeometryShader)
+void LatteSHRC_UpdatePixelShader(uint8* pixelShaderPtr, uint32 pixelShaderSize, bool usesGeometryShader, bool allowAsync)
 {
 	LatteSHRC_UpdatePSBaseHash(pixelShaderPtr, pixelShaderSize, usesGeometryShader);
-	uint64 psAuxHash = 0;
-	auto itBaseShader = sPixelShaders.find(_shaderBaseHash_ps);
 	LatteDecompilerShader* pixelShader = nullptr;
-	if (itBaseShader != sPixelShaders.end())
+	while (true)
 	{
-		psAuxHash = LatteSHRC_CalcPSAuxHash(itBaseShader->second, LatteGPUState.contextRegister);
-		pixelShader = LatteSHRC_GetFromChain(itBaseShader->second, _shaderBaseHash_ps, psAuxHash);
+		uint64 psAuxHash = 0;
+		auto itBaseShader = sPixelShaders.find(_shaderBaseHash_ps);
+		bool hasBaseShader = itBaseShader != sPixelShaders.end();
+		if (hasBaseShader)
+		{
+			psAuxHash = LatteSHRC_CalcPSAuxHash(itBaseShader->second, LatteGPUState.contextRegister);
+			pixelShader = LatteSHRC_GetFromChain(itBaseShader->second, _shaderBaseHash_ps, psAuxHash);
+			if (pixelShader)
+				break;
+		}
+		LatteShaderDecompileJob* job = LatteSHRC_FindPendingJob(LatteConst::ShaderType::Pixel, _shaderBaseHash_ps, hasBaseShader, psAuxHash);
+		if (!job)
+		{
+			pixelShader = LatteSHRC_SubmitJob(LatteShader_CreatePixelShaderJob(_shaderBaseHash_ps, hasBaseShader, psAuxHash, pixelShaderPtr, pixelShaderSize, usesGeometryShader), allowAsync);
+			if (pixelShader)
+				break;
+		}
+		else if (LatteSHRC_TryFinishPendingJob(job, allowAsync))
+			continue;
+		LatteGPUState.activeShaderIsPending = true;
+		return;
 	}
-	if (!pixelShader)
-		pixelShader = LatteShader_CompileSeparablePixelShader(_shaderBaseHash_ps, psAuxHash, pixelShaderPtr, pixelShaderSize, usesGeometryShader);
 	if (pixelShader->hasError)
 	{
 		LatteGPUState.activeShaderHasError = true;
@@ -987,7 +1192,18 @@ void LatteSHRC_UpdatePixelShader(uint8* pixelShaderPtr, uint32 pixelShaderSize,
 	_activePixelShader = pixelShader;
 }
 
-void LatteSHRC_UpdateActiveShaders()
+void LatteSHRC_DiscardPendingJobs()
+{
+	for (auto& job : sPendingDecompileJobs)
+	{
+		job->WaitForCompletion();
+		delete job->output.shader;
+		delete job;
+	}
+	sPendingDecompileJobs.clear();
+}
+
+void LatteSHRC_UpdateActiveShaders(bool allowAsyncDecompile)
 {
 	// check if geometry shader is used
 	auto gsMode = LatteGPUState.contextNew.VGT_GS_MODE.get_MODE();
@@ -1044,15 +1260,22 @@ void LatteSHRC_UpdateActiveShaders()
 	}
 	// set new shaders
 	LatteGPUState.activeShaderHasError = false;
+	LatteGPUState.activeShaderIsPending = false;
 	LatteShader_UpdatePSInputs(LatteGPUState.contextRegister);
 	LatteShaderSHRC_UpdateFetchShader();
-	LatteSHRC_UpdateVertexShader(vsProgramCode, vsProgramSize, geometryShaderUsed);
+	LatteSHRC_UpdateVertexShader(vsProgramCode, vsProgramSize, geometryShaderUsed, allowAsyncDecompile);
 	if (LatteGPUState.activeShaderHasError)
 		return;
-	LatteSHRC_UpdateGeometryShader(geometryShaderUsed, gsProgramCode, gsProgramSize, copyProgramCode, copyProgramSize);
-	if (LatteGPUState.activeShaderHasError)
-		return;
-	LatteSHRC_UpdatePixelShader(psProgramCode, psProgramSize, geometryShaderUsed);
+	if (LatteGPUState.activeShaderIsPending && geometryShaderUsed)
+		return; // geometry shader and pixel shader hash depend on the vertex shader
+	if (!LatteGPUState.activeShaderIsPending)
+	{
+		LatteSHRC_UpdateGeometryShader(geometryShaderUsed, gsProgramCode, gsProgramSize, copyProgramCode, copyProgramSize, allowAsyncDecompile);
+		if (LatteGPUState.activeShaderHasError)
+			return;
+	}
+	// the pixel shader does not depend on the vertex shader so it can be decompiled in parallel
+	LatteSHRC_UpdatePixelShader(psProgramCode, psProgramSize, geometryShaderUsed, allowAsyncDecompile);
 	if (LatteGPUState.activeShaderHasError)
 		return;
 }
@@ -1081,6 +1304,8 @@ void LatteSHRC_Init()
 
 void LatteSHRC_UnloadAll()
 {
+	// the renderer is already shut down at this point, so shaders which are still being decompiled are dropped
+	LatteSHRC_DiscardPendingJobs();
     while(!sVertexShaders.empty())
         LatteShader_free(sVertexShaders.begin()->second);
     cemu_assert_debug(sVertexShaders.empty());
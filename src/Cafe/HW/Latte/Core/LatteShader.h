@@ -8,7 +8,7 @@ void LatteSHRC_UnloadAll();
 void LatteSHRC_ResetCachedShaderHash();
 void LatteShaderSHRC_UpdateFetchShader();
 
-void LatteSHRC_UpdateActiveShaders();
+void LatteSHRC_UpdateActiveShaders(bool allowAsyncDecompile = false); // if allowAsyncDecompile is set, new shaders are decompiled in the background and activeShaderIsPending is set until they are ready
 
 struct LatteFetchShader* LatteSHRC_GetActiveFetchShader();
 LatteDecompilerShader* LatteSHRC_GetActiveVertexShader();
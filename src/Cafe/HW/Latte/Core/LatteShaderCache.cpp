@@ -2,6 +2,7 @@
 #include "Cafe/HW/Latte/Core/LatteConst.h"
 #include "Cafe/HW/Latte/Core/Latte.h"
 #include "Cafe/HW/Latte/Core/LatteShader.h"
+#include "Cafe/HW/Latte/Core/LatteShaderDecompileJob.h"
 #include "Cafe/HW/Latte/LegacyShaderDecompiler/LatteDecompiler.h"
 #include "Cafe/HW/Latte/Core/FetchShader.h"
 #include "Cemu/FileCache/FileCache.h"
@@ -67,7 +68,8 @@ FileCache* s_shaderCacheGeneric = nullptr;	// contains hardware and version inde
 #define SHADER_CACHE_TYPE_GEOMETRY				(1)
 #define SHADER_CACHE_TYPE_PIXEL					(2)
 
-bool LatteShaderCache_readSeparableShader(uint8* shaderInfoData, sint32 shaderInfoSize);
+LatteShaderDecompileJob* LatteShaderCache_readSeparableShader(uint8* shaderInfoData, sint32 shaderInfoSize);
+void LatteShaderCache_finishSeparableShader(LatteShaderDecompileJob* job);
 void LatteShaderCache_LoadPipelineCache(uint64 cacheTitleId);
 bool LatteShaderCache_updatePipelineLoadingProgress();
 void LatteShaderCache_ShowProgress(const std::function <bool(void)>& loadUpdateFunc, bool isPipelines);
@@ -431,10 +433,27 @@ void LatteShaderCache_Load()
 	sint32 numLoadedShaders = 0;
 	uint32 loadIndex = 0;
 
+	// shaders are parsed on this thread, decompiled on the background workers of the thread pool and then compiled in load order on this thread again
+	// the number of jobs in flight is limited since each holds a full copy of the register state
+	const size_t maxPendingJobs = 32;
+	std::deque<LatteShaderDecompileJob*> pendingJobs;
+
 	auto LoadShadersUpdate = [&]() -> bool
 	{
+		// finish decompiled shaders in order
+		while (!pendingJobs.empty() && (pendingJobs.size() >= maxPendingJobs || pendingJobs.front()->IsDone()))
+		{
+			LatteShaderCache_finishSeparableShader(pendingJobs.front());
+			pendingJobs.pop_front();
+		}
 		if (loadIndex >= (uint32)s_shaderCacheGeneric->GetMaximumFileIndex())
-			return false;
+		{
+			if (pendingJobs.empty())
+				return false;
+			LatteShaderCache_finishSeparableShader(pendingJobs.front());
+			pendingJobs.pop_front();
+			return true;
+		}
 		LatteShaderCache_updateCompileQueue(SHADER_CACHE_COMPILE_QUEUE_SIZE - 2);
 		uint64 name1;
 		uint64 name2;
@@ -445,18 +464,30 @@ void LatteShaderCache_Load()
 			return true;
 		}
 		g_shaderCacheLoaderState.loadedShaderFiles++;
-		if (LatteShaderCache_readSeparableShader(fileData.data(), fileData.size()) == false)
+		LatteShaderDecompileJob* job = LatteShaderCache_readSeparableShader(fileData.data(), fileData.size());
+		if (!job)
 		{
 			// something is wrong with the stored shader, remove entry from shader cache files
 			cemuLog_log(LogType::Force, "Shader cache entry {} invalid, deleting...", loadIndex);
 			s_shaderCacheGeneric->DeleteFile({name1, name2 });
 		}
+		else
+		{
+			job->QueueAsync();
+			pendingJobs.emplace_back(job);
+		}
 		numLoadedShaders++;
 		loadIndex++;
 		return true;
 	};
 
 	LatteShaderCache_ShowProgress(LoadShadersUpdate, false);
+	// loading can be cancelled with jobs still in flight
+	while (!pendingJobs.empty())
+	{
+		LatteShaderCache_finishSeparableShader(pendingJobs.front());
+		pendingJobs.pop_front();
+	}
 
 	LatteShaderCache_updateCompileQueue(0);
 	// write load time and RAM usage to log file (in dev build)
@@ -766,57 +797,52 @@ void LatteShaderCache_loadOrCompileSeparableShader(LatteDecompilerShader* shader
 	LatteShaderCache_addToCompileQueue(shader);
 }
 
-bool LatteShaderCache_readSeparableVertexShader(MemStreamReader& streamReader, uint8 version)
+LatteShaderDecompileJob* LatteShaderCache_readSeparableVertexShader(MemStreamReader& streamReader, uint8 version)
 {
 	auto lcr = std::make_unique<LatteContextRegister>();
 	if (version != 1)
-		return false;
+		return nullptr;
 	uint64 shaderBaseHash = streamReader.readBE<uint64>();
 	uint64 shaderAuxHash = streamReader.readBE<uint64>();
 	bool usesGeometryShader = streamReader.readBE<uint8>() != 0;
 	// context registers
 	Latte::GPUCompactedRegisterState regState;
 	if (!Latte::DeserializeRegisterState(regState, streamReader))
-		return false;
+		return nullptr;
 	Latte::LoadGPURegisterState(*lcr, regState);
 	if (streamReader.hasError())
-		return false;
+		return nullptr;
 	// fetch shader
 	std::vector<uint8> fetchShaderData;
 	if (!Latte::DeserializeShaderProgram(fetchShaderData, streamReader))
-		return false;
+		return nullptr;
 	if (streamReader.hasError())
-		return false;
+		return nullptr;
 	// vertex shader
 	std::vector<uint8> vertexShaderData;
 	if (!Latte::DeserializeShaderProgram(vertexShaderData, streamReader))
-		return false;
+		return nullptr;
 	if (streamReader.hasError() || !streamReader.isEndOfStream())
-		return false;
-	// update PS inputs (affects VS shader outputs)
-	LatteShader_UpdatePSInputs(lcr->GetRawView());
-	// get fetch shader
+		return nullptr;
+	LatteShaderDecompileJob* job = new LatteShaderDecompileJob(LatteConst::ShaderType::Vertex, shaderBaseHash, std::move(lcr));
+	job->hasAuxHash = true;
+	job->auxHash = shaderAuxHash;
+	job->usesGeometryShader = usesGeometryShader;
+	// PS inputs affect VS shader outputs
+	LatteShader_CreatePSInputTable(&job->psInputTable, job->GetContextRegisters());
+	// get fetch shader. Creating it modifies the fetch shader cache so this is not done by the decompiler threads
 	LatteFetchShader::CacheHash fsHash = LatteFetchShader::CalculateCacheHash((uint32*)fetchShaderData.data(), fetchShaderData.size());
-	LatteFetchShader* fetchShader = LatteShaderRecompiler_createFetchShader(fsHash, lcr->GetRawView(), (uint32*)fetchShaderData.data(), fetchShaderData.size());
+	job->fetchShader = LatteShaderRecompiler_createFetchShader(fsHash, job->GetContextRegisters(), (uint32*)fetchShaderData.data(), fetchShaderData.size());
 	// determine decompiler options
-	LatteDecompilerOptions options;
-	LatteShader_GetDecompilerOptions(options, LatteConst::ShaderType::Vertex, usesGeometryShader);
-	// decompile vertex shader
-	LatteDecompilerOutput_t decompilerOutput{};
-	LatteDecompiler_DecompileVertexShader(shaderBaseHash, lcr->GetRawView(), vertexShaderData.data(), vertexShaderData.size(), fetchShader, options, &decompilerOutput);
-	LatteDecompilerShader* vertexShader = LatteShader_CreateShaderFromDecompilerOutput(decompilerOutput, shaderBaseHash, false, shaderAuxHash, lcr->GetRawView());
-	// compile
-	LatteShader_DumpShader(shaderBaseHash, shaderAuxHash, vertexShader);
-	LatteShader_DumpRawShader(shaderBaseHash, shaderAuxHash, SHADER_DUMP_TYPE_VERTEX, vertexShaderData.data(), vertexShaderData.size());
-	LatteShaderCache_loadOrCompileSeparableShader(vertexShader, shaderBaseHash, shaderAuxHash);
-	LatteSHRC_RegisterShader(vertexShader, shaderBaseHash, shaderAuxHash);
-	return true;
+	LatteShader_GetDecompilerOptions(job->options, LatteConst::ShaderType::Vertex, usesGeometryShader);
+	job->programData = std::move(vertexShaderData);
+	return job;
 }
 
-bool LatteShaderCache_readSeparableGeometryShader(MemStreamReader& streamReader, uint8 version)
+LatteShaderDecompileJob* LatteShaderCache_readSeparableGeometryShader(MemStreamReader& streamReader, uint8 version)
 {
 	if (version != 1)
-		return false;
+		return nullptr;
 	auto lcr = std::make_unique<LatteContextRegister>();
 	uint64 shaderBaseHash = streamReader.readBE<uint64>();
 	uint64 shaderAuxHash = streamReader.readBE<uint64>();
@@ -824,41 +850,37 @@ bool LatteShaderCache_readSeparableGeometryShader(MemStreamReader& streamReader,
 	// context registers
 	Latte::GPUCompactedRegisterState regState;
 	if (!Latte::DeserializeRegisterState(regState, streamReader))
-		return false;
+		return nullptr;
 	Latte::LoadGPURegisterState(*lcr, regState);
 	if (streamReader.hasError())
-		return false;
+		return nullptr;
 	// geometry copy shader
 	std::vector<uint8> geometryCopyShaderData;
 	if (!Latte::DeserializeShaderProgram(geometryCopyShaderData, streamReader))
-		return false;
+		return nullptr;
 	// geometry shader
 	std::vector<uint8> geometryShaderData;
 	if (!Latte::DeserializeShaderProgram(geometryShaderData, streamReader))
-		return false;
+		return nullptr;
 	if (streamReader.hasError() || !streamReader.isEndOfStream())
-		return false;
-	// update PS inputs
-	LatteShader_UpdatePSInputs(lcr->GetRawView());
+		return nullptr;
+	LatteShaderDecompileJob* job = new LatteShaderDecompileJob(LatteConst::ShaderType::Geometry, shaderBaseHash, std::move(lcr));
+	job->hasAuxHash = true;
+	job->auxHash = shaderAuxHash;
+	job->usesGeometryShader = true;
+	job->vsRingParameterCount = vsRingParameterCount;
+	LatteShader_CreatePSInputTable(&job->psInputTable, job->GetContextRegisters());
 	// determine decompiler options
-	LatteDecompilerOptions options;
-	LatteShader_GetDecompilerOptions(options, LatteConst::ShaderType::Geometry, true);
-	// decompile geometry shader
-	LatteDecompilerOutput_t decompilerOutput{};
-	LatteDecompiler_DecompileGeometryShader(shaderBaseHash, lcr->GetRawView(), geometryShaderData.data(), geometryShaderData.size(), geometryCopyShaderData.data(), geometryCopyShaderData.size(), vsRingParameterCount, options, &decompilerOutput);
-	LatteDecompilerShader* geometryShader = LatteShader_CreateShaderFromDecompilerOutput(decompilerOutput, shaderBaseHash, false, shaderAuxHash, lcr->GetRawView());
-	// compile
-	LatteShader_DumpShader(shaderBaseHash, shaderAuxHash, geometryShader);
-	LatteShader_DumpRawShader(shaderBaseHash, shaderAuxHash, SHADER_DUMP_TYPE_GEOMETRY, geometryShaderData.data(), geometryShaderData.size());
-	LatteShaderCache_loadOrCompileSeparableShader(geometryShader, shaderBaseHash, shaderAuxHash);
-	LatteSHRC_RegisterShader(geometryShader, shaderBaseHash, shaderAuxHash);
-	return true;
+	LatteShader_GetDecompilerOptions(job->options, LatteConst::ShaderType::Geometry, true);
+	job->programData = std::move(geometryShaderData);
+	job->gsCopyProgramData = std::move(geometryCopyShaderData);
+	return job;
 }
 
-bool LatteShaderCache_readSeparablePixelShader(MemStreamReader& streamReader, uint8 version)
+LatteShaderDecompileJob* LatteShaderCache_readSeparablePixelShader(MemStreamReader& streamReader, uint8 version)
 {
 	if (version != 1)
-		return false;
+		return nullptr;
 	auto lcr = std::make_unique<LatteContextRegister>();
 	uint64 shaderBaseHash = streamReader.readBE<uint64>();
 	uint64 shaderAuxHash = streamReader.readBE<uint64>();
@@ -866,38 +888,33 @@ bool LatteShaderCache_readSeparablePixelShader(MemStreamReader& streamReader, ui
 	// context registers
 	Latte::GPUCompactedRegisterState regState;
 	if (!Latte::DeserializeRegisterState(regState, streamReader))
-		return false;
+		return nullptr;
 	Latte::LoadGPURegisterState(*lcr, regState);
 	if (streamReader.hasError())
-		return false;
+		return nullptr;
 	// pixel shader
 	std::vector<uint8> pixelShaderData;
 	if (!Latte::DeserializeShaderProgram(pixelShaderData, streamReader))
-		return false;
+		return nullptr;
 	if (streamReader.hasError() || !streamReader.isEndOfStream())
-		return false;
-	// update PS inputs
-	LatteShader_UpdatePSInputs(lcr->GetRawView());
+		return nullptr;
+	LatteShaderDecompileJob* job = new LatteShaderDecompileJob(LatteConst::ShaderType::Pixel, shaderBaseHash, std::move(lcr));
+	job->hasAuxHash = true;
+	job->auxHash = shaderAuxHash;
+	job->usesGeometryShader = usesGeometryShader;
+	LatteShader_CreatePSInputTable(&job->psInputTable, job->GetContextRegisters());
 	// determine decompiler options
-	LatteDecompilerOptions options;
-	LatteShader_GetDecompilerOptions(options, LatteConst::ShaderType::Pixel, usesGeometryShader);
-	// decompile pixel shader
-	LatteDecompilerOutput_t decompilerOutput{};
-	LatteDecompiler_DecompilePixelShader(shaderBaseHash, lcr->GetRawView(), pixelShaderData.data(), pixelShaderData.size(), options, &decompilerOutput);
-	LatteDecompilerShader* pixelShader = LatteShader_CreateShaderFromDecompilerOutput(decompilerOutput, shaderBaseHash, false, shaderAuxHash, lcr->GetRawView());
-	// compile
-	LatteShader_DumpShader(shaderBaseHash, shaderAuxHash, pixelShader);
-	LatteShader_DumpRawShader(shaderBaseHash, shaderAuxHash, SHADER_DUMP_TYPE_PIXEL, pixelShaderData.data(), pixelShaderData.size());
-	LatteShaderCache_loadOrCompileSeparableShader(pixelShader, shaderBaseHash, shaderAuxHash);
-	LatteSHRC_RegisterShader(pixelShader, shaderBaseHash, shaderAuxHash);
-	return true;
+	LatteShader_GetDecompilerOptions(job->options, LatteConst::ShaderType::Pixel, usesGeometryShader);
+	job->programData = std::move(pixelShaderData);
+	return job;
 }
 
-// read shader info from shader cache
-bool LatteShaderCache_readSeparableShader(uint8* shaderInfoData, sint32 shaderInfoSize)
+// parse shader info from shader cache
+// returns a decompile job for the stored shader or nullptr if the entry is invalid
+LatteShaderDecompileJob* LatteShaderCache_readSeparableShader(uint8* shaderInfoData, sint32 shaderInfoSize)
 {
 	if (shaderInfoSize < 8)
-		return false;
+		return nullptr;
 	MemStreamReader streamReader(shaderInfoData, shaderInfoSize);
 	uint8 versionAndType = streamReader.readBE<uint8>();
 	uint8 version = versionAndType & 0xF;
@@ -908,7 +925,27 @@ bool LatteShaderCache_readSeparableShader(uint8* shaderInfoData, sint32 shaderIn
 		return LatteShaderCache_readSeparableGeometryShader(streamReader, version);
 	else if (type == SHADER_CACHE_TYPE_PIXEL)
 		return LatteShaderCache_readSeparablePixelShader(streamReader, version);
-	return false;
+	return nullptr;
+}
+
+// wait for the decompiled shader and compile and register it. Jobs are finished in the order they were read so the result is the same as with serial loading
+void LatteShaderCache_finishSeparableShader(LatteShaderDecompileJob* job)
+{
+	job->WaitForCompletion();
+	uint64 shaderBaseHash = job->baseHash;
+	uint64 shaderAuxHash = job->auxHash;
+	LatteDecompilerShader* shader = LatteShader_CreateShaderFromDecompilerOutput(job->output, shaderBaseHash, false, shaderAuxHash, job->GetContextRegisters());
+	uint32 dumpType = SHADER_DUMP_TYPE_VERTEX;
+	if (job->shaderType == LatteConst::ShaderType::Geometry)
+		dumpType = SHADER_DUMP_TYPE_GEOMETRY;
+	else if (job->shaderType == LatteConst::ShaderType::Pixel)
+		dumpType = SHADER_DUMP_TYPE_PIXEL;
+	// compile
+	LatteShader_DumpShader(shaderBaseHash, shaderAuxHash, shader);
+	LatteShader_DumpRawShader(shaderBaseHash, shaderAuxHash, dumpType, job->programData.data(), job->programData.size());
+	LatteShaderCache_loadOrCompileSeparableShader(shader, shaderBaseHash, shaderAuxHash);
+	LatteSHRC_RegisterShader(shader, shaderBaseHash, shaderAuxHash);
+	delete job;
 }
 
 void LatteShaderCache_Close()
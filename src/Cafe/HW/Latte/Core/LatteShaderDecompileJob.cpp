@@ -0,0 +1,70 @@
+#include "Cafe/HW/Latte/Core/LatteShaderDecompileJob.h"
+#include "Cafe/HW/Latte/Core/LattePerformanceMonitor.h"
+#include "util/ThreadPool/ThreadPool.h"
+
+LatteShaderDecompileJob::LatteShaderDecompileJob(LatteConst::ShaderType shaderType, uint64 baseHash, std::unique_ptr<LatteContextRegister> lcr)
+	: shaderType(shaderType), baseHash(baseHash), contextRegister(std::move(lcr))
+{
+}
+
+void LatteShaderDecompileJob::QueueAsync()
+{
+	m_state.setValue(STATE::QUEUED);
+	// the task only dereferences the job after claiming it. Once claimed by WaitForCompletion() the job may already be deleted
+	ThreadPool::Submit(ThreadPool::Priority::Background, [this, isClaimed = m_isClaimed]() {
+		if (isClaimed->exchange(true))
+			return;
+		m_state.setValue(STATE::DECOMPILING);
+		Decompile();
+		m_state.setValue(STATE::DONE);
+	});
+}
+
+bool LatteShaderDecompileJob::IsDone()
+{
+	return m_state.hasState(STATE::DONE);
+}
+
+void LatteShaderDecompileJob::WaitForCompletion()
+{
+	if (m_isClaimed->exchange(true))
+	{
+		// picked up by a pool worker or already decompiled synchronously
+		m_state.waitUntilValue(STATE::DONE);
+		return;
+	}
+	m_state.setValue(STATE::DECOMPILING);
+	DecompileSync();
+}
+
+void LatteShaderDecompileJob::DecompileSync()
+{
+	m_isClaimed->store(true);
+	// only decompilation which stalls the calling (GPU) thread is tracked
+	performanceMonitor.gpuTime_shaderCreate.beginMeasuring();
+	Decompile();
+	performanceMonitor.gpuTime_shaderCreate.endMeasuring();
+	m_state.setValue(STATE::DONE);
+}
+
+void LatteShaderDecompileJob::Decompile()
+{
+	TraceRecorder::Scope traceScope("shader", "DecompileShader", "baseHash", baseHash, TraceRecorder::ArgFormat::Hex);
+	options.psInputTable = &psInputTable;
+	uint32* contextRegisters = GetContextRegisters();
+	if (shaderType == LatteConst::ShaderType::Vertex)
+	{
+		LatteDecompiler_DecompileVertexShader(baseHash, contextRegisters, programData.data(), programData.size(), fetchShader, options, &output);
+	}
+	else if (shaderType == LatteConst::ShaderType::Geometry)
+	{
+		uint8* gsCopyProgram = gsCopyProgramData.empty() ? nullptr : gsCopyProgramData.data();
+		LatteDecompiler_DecompileGeometryShader(baseHash, contextRegisters, programData.data(), programData.size(), gsCopyProgram, gsCopyProgramData.size(), vsRingParameterCount, options, &output);
+	}
+	else if (shaderType == LatteConst::ShaderType::Pixel)
+	{
+		LatteDecompiler_DecompilePixelShader(baseHash, contextRegisters, programData.data(), programData.size(), options, &output);
+	}
+	else
+		cemu_assert_debug(false);
+}
@@ -0,0 +1,53 @@
+#pragma once
+#include "Cafe/HW/Latte/Core/LatteShader.h"
+#include "Cafe/HW/Latte/ISA/LatteReg.h"
+#include "util/helpers/Semaphore.h"
+
+// decompilation of a single vertex, geometry or pixel shader
+// the job owns a copy of all inputs (registers, program code, PS input table) so it can run on a worker thread while the GPU state moves on
+// finalizing the shader (registering it, creating the renderer shader, writing the cache entry) is left to the GPU thread
+class LatteShaderDecompileJob
+{
+public:
+	enum class STATE
+	{
+		QUEUED,
+		DECOMPILING,
+		DONE,
+	};
+
+	LatteShaderDecompileJob(LatteConst::ShaderType shaderType, uint64 baseHash, std::unique_ptr<LatteContextRegister> lcr);
+
+	// decompile on a background worker of the shared thread pool
+	void QueueAsync();
+	bool IsDone();
+	// if the job is still queued it is decompiled on the calling thread, otherwise waits for the worker to finish it
+	void WaitForCompletion();
+	// decompile on the calling thread
+	void DecompileSync();
+
+	uint32* GetContextRegisters() { return contextRegister->GetRawView(); }
+
+	LatteConst::ShaderType shaderType;
+	uint64 baseHash;
+	std::unique_ptr<LatteContextRegister> contextRegister;
+	LatteShaderPSInputTable psInputTable{};
+	LatteDecompilerOptions options;
+	std::vector<uint8> programData;
+	std::vector<uint8> gsCopyProgramData; // geometry shader only
+	std::vector<uint8> fetchShaderData; // vertex shader only, stored alongside the vertex shader in the shader cache
+	LatteFetchShader* fetchShader{}; // vertex shader only
+	uint32 vsRingParameterCount{}; // geometry shader only
+	bool usesGeometryShader{};
+	// for runtime jobs this is the aux hash the shader was requested with. Shader cache entries store their aux hash
+	bool hasAuxHash{};
+	uint64 auxHash{};
+
+	LatteDecompilerOutput_t output{};
+
+private:
+	void Decompile();
+
+	StateSemaphore<STATE> m_state{STATE::QUEUED};
+	std::shared_ptr<std::atomic_bool> m_isClaimed{std::make_shared<std::atomic_bool>(false)}; // set by whoever decompiles the job
+};
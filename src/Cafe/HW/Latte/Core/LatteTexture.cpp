@@ -8,21 +8,70 @@
 
 #include "Cafe/GraphicPack/GraphicPack2.h"
 
+#include "util/containers/IntervalTree.h"
+#include "config/LaunchSettings.h"
+#include "Common/FileStream.h"
+
 #include <boost/container/small_vector.hpp>
 
-struct TexMemOccupancyEntry
-{
-	uint32 addrStart;
-	uint32 addrEnd;
-	LatteTextureSliceMipInfo* sliceMipInfo;
-};
+// memory ranges occupied by the slices and mips of all cached textures
+using TexMemOccupancyTree = IntervalTree<uint32, LatteTextureSliceMipInfo*>;
+using TexMemOccupancyEntry = TexMemOccupancyTree::Interval;
 
-#define TEX_OCCUPANCY_BUCKET_COUNT		(0x800) // each bucket covers a range of 2MB
-#define TEX_OCCUPANCY_BUCKET_SIZE		(0x100000000/TEX_OCCUPANCY_BUCKET_COUNT)
+TexMemOccupancyTree s_texMemOccupancy;
 
-#define loopItrMemOccupancyBuckets(__startAddr, __endAddr)		for(sint32 startBucketIndex = ((__startAddr)/TEX_OCCUPANCY_BUCKET_SIZE), bucketIndex=startBucketIndex; bucketIndex<=((__endAddr-1)/TEX_OCCUPANCY_BUCKET_SIZE); bucketIndex++)
+// optional trace of all occupancy operations (--texmem-trace), see LatteTexture_ReplayMemOccupancyTrace
+struct
+{
+	bool isChecked{};
+	std::unique_ptr<FileStream> file;
+	std::vector<LatteTexMemTraceRecord> records;
+	std::unordered_map<LatteTexture*, uint32> textureIds; // texture pointers are reused, so every registration gets a new id
+	uint32 nextTextureId{};
+} s_texMemTrace;
+
+void LatteTexture_FlushTexMemOccupancyTrace()
+{
+	if (!s_texMemTrace.file || s_texMemTrace.records.empty())
+		return;
+	s_texMemTrace.file->writeData(s_texMemTrace.records.data(), (sint32)(s_texMemTrace.records.size() * sizeof(LatteTexMemTraceRecord)));
+	s_texMemTrace.records.clear();
+}
 
-std::vector<TexMemOccupancyEntry> list_texMemOccupancyBucket[TEX_OCCUPANCY_BUCKET_COUNT];
+static void LatteTexture_TraceTexMemOccupancy(LatteTexMemTraceRecord::OP op, uint32 start, uint32 end, LatteTexture* texture)
+{
+	if (!s_texMemTrace.isChecked)
+	{
+		s_texMemTrace.isChecked = true;
+		if (auto tracePath = LaunchSettings::GetTexMemTracePath())
+		{
+			s_texMemTrace.file.reset(FileStream::createFile2(*tracePath));
+			if (!s_texMemTrace.file)
+				cemuLog_log(LogType::Force, "Unable to create texture memory trace {}", _pathToUtf8(*tracePath));
+		}
+	}
+	if (!s_texMemTrace.file)
+		return;
+	uint32 textureId = 0;
+	if (op == LatteTexMemTraceRecord::OP::INSERT)
+	{
+		auto [it, isNew] = s_texMemTrace.textureIds.try_emplace(texture, s_texMemTrace.nextTextureId);
+		if (isNew)
+			s_texMemTrace.nextTextureId++;
+		textureId = it->second;
+	}
+	else if (op == LatteTexMemTraceRecord::OP::REMOVE)
+	{
+		auto it = s_texMemTrace.textureIds.find(texture);
+		if (it == s_texMemTrace.textureIds.end())
+			return;
+		textureId = it->second;
+		s_texMemTrace.textureIds.erase(it);
+	}
+	s_texMemTrace.records.push_back({op, start, end, textureId});
+	if (s_texMemTrace.records.size() >= 0x10000)
+		LatteTexture_FlushTexMemOccupancyTrace();
+}
 
 std::atomic_bool s_refreshTextureQueryList;
 std::vector<LatteTextureInformation> s_cacheInfoList;
@@ -107,12 +156,8 @@ void LatteTexture_RefreshInfoCache()
 
 void LatteTexture_AddTexMemOccupancyInterval(LatteTextureSliceMipInfo* sliceMipInfo)
 {
-	TexMemOccupancyEntry entry;
-	entry.addrStart = sliceMipInfo->addrStart;
-	entry.addrEnd = sliceMipInfo->addrEnd;
-	entry.sliceMipInfo = sliceMipInfo;
-	loopItrMemOccupancyBuckets(entry.addrStart, entry.addrEnd)
-		list_texMemOccupancyBucket[bucketIndex].push_back(entry);
+	s_texMemOccupancy.Insert(sliceMipInfo->addrStart, sliceMipInfo->addrEnd, sliceMipInfo);
+	LatteTexture_TraceTexMemOccupancy(LatteTexMemTraceRecord::OP::INSERT, sliceMipInfo->addrStart, sliceMipInfo->addrEnd, sliceMipInfo->texture);
 }
 
 void LatteTexture_RegisterTextureMemoryOccupancy(LatteTexture* texture)
@@ -134,39 +179,11 @@ void LatteTexture_RegisterTextureMemoryOccupancy(LatteTexture* texture)
 	}
 }
 
-void LatteTexture_RemoveTexMemOccupancyInterval(LatteTexture* texture, LatteTextureSliceMipInfo* sliceMipInfo)
-{
-	loopItrMemOccupancyBuckets(sliceMipInfo->addrStart, sliceMipInfo->addrEnd)
-	{
-		for (sint32 i = 0; i < list_texMemOccupancyBucket[bucketIndex].size(); i++)
-		{
-			if (list_texMemOccupancyBucket[bucketIndex][i].sliceMipInfo->texture == texture)
-			{
-				list_texMemOccupancyBucket[bucketIndex].erase(list_texMemOccupancyBucket[bucketIndex].begin() + i);
-				i--;
-				continue;
-			}
-		}
-	}
-}
-
 void LatteTexture_UnregisterTextureMemoryOccupancy(LatteTexture* texture)
 {
-	sint32 mipLevels = texture->mipLevels;
-	sint32 sliceCount = texture->depth;
-	for (sint32 mipIndex = 0; mipIndex < mipLevels; mipIndex++)
-	{
-		sint32 mipSliceCount;
-		if (texture->Is3DTexture())
-			mipSliceCount = std::max(1, sliceCount >> mipIndex);
-		else
-			mipSliceCount = sliceCount;
-		for (sint32 sliceIndex = 0; sliceIndex < mipSliceCount; sliceIndex++)
-		{
-			LatteTextureSliceMipInfo* sliceMipInfo = texture->sliceMipInfo + texture->GetSliceMipArrayIndex(sliceIndex, mipIndex);
-			LatteTexture_RemoveTexMemOccupancyInterval(texture, sliceMipInfo);
-		}
-	}
+	// removes the intervals of all slices and mips in a single pass
+	s_texMemOccupancy.RemoveIf([texture](const TexMemOccupancyEntry& occupancy) { return occupancy.data->texture == texture; });
+	LatteTexture_TraceTexMemOccupancy(LatteTexMemTraceRecord::OP::REMOVE, 0, 0, texture);
 }
 
 // calculate the actually accessed data range
@@ -660,12 +677,12 @@ void LatteTexture_TrackTextureRelation(LatteTexture* texture1, LatteTexture* tex
 	}
 }
 
-void LatteTexture_TrackDataOverlap(LatteTexture* texture, LatteTextureSliceMipInfo* sliceMipInfo, TexMemOccupancyEntry& occupancy)
+void LatteTexture_TrackDataOverlap(LatteTexture* texture, LatteTextureSliceMipInfo* sliceMipInfo, const TexMemOccupancyEntry& occupancy)
 {
 	// todo - handle tile thickness and z offset
 
 	// todo - check address range overlap
-	auto& occMipSliceInfo = occupancy.sliceMipInfo;
+	LatteTextureSliceMipInfo* occMipSliceInfo = occupancy.data;
 
 	if ((sliceMipInfo->addrEnd > occMipSliceInfo->addrStart && sliceMipInfo->addrStart < occMipSliceInfo->addrEnd) == false)
 		return;
@@ -673,19 +690,19 @@ void LatteTexture_TrackDataOverlap(LatteTexture* texture, LatteTextureSliceMipIn
 	// check if this overlap is already tracked
 	for (auto& it : sliceMipInfo->list_dataOverlap)
 	{
-		if (it.destMipSliceInfo == occupancy.sliceMipInfo)
+		if (it.destMipSliceInfo == occMipSliceInfo)
 			return;
 	}
 	// register texture->dest
 	LatteTextureSliceMipDataOverlap_t overlapEntry;
-	overlapEntry.destMipSliceInfo = occupancy.sliceMipInfo;
-	overlapEntry.destTexture = occupancy.sliceMipInfo->texture;
+	overlapEntry.destMipSliceInfo = occMipSliceInfo;
+	overlapEntry.destTexture = occMipSliceInfo->texture;
 	sliceMipInfo->list_dataOverlap.push_back(overlapEntry);
 	// register dest->texture
 	LatteTextureSliceMipDataOverlap_t overlapEntry2;
 	overlapEntry2.destMipSliceInfo = sliceMipInfo;
 	overlapEntry2.destTexture = sliceMipInfo->texture;
-	occupancy.sliceMipInfo->list_dataOverlap.push_back(overlapEntry2);
+	occMipSliceInfo->list_dataOverlap.push_back(overlapEntry2);
 }
 
 void _LatteTexture_RemoveDataOverlapTracking(LatteTexture* texture, LatteTextureSliceMipInfo* sliceMipInfo, LatteTextureSliceMipDataOverlap_t& dataOverlap)
@@ -742,36 +759,31 @@ void LatteTexture_GatherTextureRelations(LatteTexture* texture)
 		for (sint32 sliceIndex = 0; sliceIndex < mipSliceCount; sliceIndex++)
 		{
 			LatteTextureSliceMipInfo* sliceMipInfo = texture->sliceMipInfo + texture->GetSliceMipArrayIndex(sliceIndex, mipIndex);
-			loopItrMemOccupancyBuckets(sliceMipInfo->addrStart, sliceMipInfo->addrEnd)
+			LatteTexture_TraceTexMemOccupancy(LatteTexMemTraceRecord::OP::QUERY_OVERLAP, sliceMipInfo->addrStart, sliceMipInfo->addrEnd, nullptr);
+			s_texMemOccupancy.ForEachOverlap(sliceMipInfo->addrStart, sliceMipInfo->addrEnd, [&](const TexMemOccupancyEntry& occupancy)
 			{
-				for (auto& occupancy : list_texMemOccupancyBucket[bucketIndex])
+				LatteTexture* itrTexture = occupancy.data->texture;
+				if (itrTexture == texture)
+					return; // ignore self
+				if (sliceMipInfo->addrStart == occupancy.start && sliceMipInfo->subIndex == occupancy.data->subIndex)
 				{
-					LatteTexture* itrTexture = occupancy.sliceMipInfo->texture;
-					if (itrTexture == texture)
-						continue; // ignore self
-					if (sliceMipInfo->addrEnd >= occupancy.addrStart && sliceMipInfo->addrStart < occupancy.addrEnd)
+					// overlapping with zero x/y offset
+					if (sliceMipInfo->pitch == occupancy.data->pitch && LatteTexture_IsTexelSizeCompatibleFormat(texture->format, itrTexture->format)
+						&& sliceMipInfo->tileMode == occupancy.data->tileMode &&
+						LatteTexture_IsFormatViewCompatible(texture->format, itrTexture->format))
+					{
+						LatteTexture_TrackTextureRelation(texture, itrTexture);
+					}
+					else
 					{
-						if (sliceMipInfo->addrStart == occupancy.addrStart && sliceMipInfo->subIndex == occupancy.sliceMipInfo->subIndex)
-						{
-							// overlapping with zero x/y offset
-							if (sliceMipInfo->pitch == occupancy.sliceMipInfo->pitch && LatteTexture_IsTexelSizeCompatibleFormat(texture->format, itrTexture->format)
-								&& sliceMipInfo->tileMode == occupancy.sliceMipInfo->tileMode &&
-								LatteTexture_IsFormatViewCompatible(texture->format, itrTexture->format))
-							{
-								LatteTexture_TrackTextureRelation(texture, itrTexture);
-							}
-							else
-							{
-								// pitch not compatible or format not compatible
-							}
-						}
-						else
-						{
-							LatteTexture_TrackDataOverlap(texture, sliceMipInfo, occupancy);
-						}
+						// pitch not compatible or format not compatible
 					}
 				}
-			}
+				else
+				{
+					LatteTexture_TrackDataOverlap(texture, sliceMipInfo, occupancy);
+				}
+			});
 		}
 	}
 }
@@ -994,28 +1006,23 @@ LatteTextureView* LatteTexture_CreateMapping(MPTR physAddr, MPTR physMipAddr, si
 		LatteAddrLib::CalculateMipAndSliceAddr(physAddr, physMipAddr, format, width, height, depth, dimBase, tileMode, swizzle, 0, mipIndex, sliceIndex, &calcSliceAddrStart, &calcSliceSize, &calcSubSliceIndex);
 		uint32 calcSliceAddrEnd = calcSliceAddrStart + calcSliceSize;
 		// attempt to create view in already existing texture first (we may have to recreate the texture with new specifications)
-		loopItrMemOccupancyBuckets(calcSliceAddrStart, calcSliceAddrEnd)
+		LatteTexture_TraceTexMemOccupancy(LatteTexMemTraceRecord::OP::QUERY_OVERLAP, calcSliceAddrStart, calcSliceAddrEnd, nullptr);
+		s_texMemOccupancy.ForEachOverlap(calcSliceAddrStart, calcSliceAddrEnd, [&](const TexMemOccupancyEntry& occupancy)
 		{
-			for (auto& occupancy : list_texMemOccupancyBucket[bucketIndex])
+			if (calcSliceAddrStart == occupancy.start)
 			{
-				if (calcSliceAddrEnd >= occupancy.addrStart && calcSliceAddrStart < occupancy.addrEnd)
+				// overlapping with zero x/y offset
+				if (std::find(list_overlappingTextures.begin(), list_overlappingTextures.end(), occupancy.data->texture) == list_overlappingTextures.end())
 				{
-					if (calcSliceAddrStart == occupancy.addrStart)
-					{
-						// overlapping with zero x/y offset
-						if (std::find(list_overlappingTextures.begin(), list_overlappingTextures.end(), occupancy.sliceMipInfo->texture) == list_overlappingTextures.end())
-						{
-							list_overlappingTextures.push_back(occupancy.sliceMipInfo->texture);
-						}
-					}
-					else
-					{
-						// overlapping but not matching directly
-						// todo - check if they match with a y offset
-					}
+					list_overlappingTextures.push_back(occupancy.data->texture);
 				}
 			}
-		}
+			else
+			{
+				// overlapping but not matching directly
+				// todo - check if they match with a y offset
+			}
+		});
 	}
 	// try to merge textures if possible
 	for (auto& tex : list_overlappingTextures)
@@ -1092,50 +1099,41 @@ LatteTextureView* LatteTC_LookupTextureByData(MPTR physAddr, sint32 width, sint3
 {
 	cemu_assert_debug(firstMip == 0);
 	sint32 cSearchIndex = 0;
-	loopItrMemOccupancyBuckets(physAddr, physAddr+1)
+	LatteTextureView* foundView = nullptr;
+	LatteTexture_TraceTexMemOccupancy(LatteTexMemTraceRecord::OP::QUERY_START, physAddr, 0, nullptr);
+	s_texMemOccupancy.ForEachStartingAt(physAddr, [&](const TexMemOccupancyEntry& occupancy)
 	{
-		auto& bucket = list_texMemOccupancyBucket[bucketIndex];
-		for (sint32 i = 0; i < bucket.size(); i++)
+		if (foundView)
+			return;
+		LatteTexture* tex = occupancy.data->texture;
+		if (tex->physAddress == physAddr && tex->pitch == pitch)
 		{
-			if (bucket[i].addrStart == physAddr)
+			if (firstSlice >= 0 && firstSlice < (tex->depth))
 			{
-				LatteTexture* tex = bucket[i].sliceMipInfo->texture;
-				if (tex->physAddress == physAddr && tex->pitch == pitch)
+				if (cSearchIndex >= *searchIndex)
 				{
-					if (firstSlice >= 0 && firstSlice < (tex->depth))
-					{
-						if (cSearchIndex >= *searchIndex)
-						{
-							(*searchIndex)++;
-							return tex->baseView;
-						}
-						cSearchIndex++;
-					}
+					(*searchIndex)++;
+					foundView = tex->baseView;
+					return;
 				}
+				cSearchIndex++;
 			}
 		}
-	}
-
-	return nullptr;
+	});
+	return foundView;
 }
 
 void LatteTC_LookupTexturesByPhysAddr(MPTR physAddr, std::vector<LatteTexture*>& list_textures)
 {
-	sint32 cSearchIndex = 0;
-	loopItrMemOccupancyBuckets(physAddr, physAddr + 1)
+	LatteTexture_TraceTexMemOccupancy(LatteTexMemTraceRecord::OP::QUERY_START, physAddr, 0, nullptr);
+	s_texMemOccupancy.ForEachStartingAt(physAddr, [&](const TexMemOccupancyEntry& occupancy)
 	{
-		for (sint32 i = 0; i < list_texMemOccupancyBucket[bucketIndex].size(); i++)
+		LatteTexture* tex = occupancy.data->texture;
+		if (tex->physAddress == physAddr)
 		{
-			if (list_texMemOccupancyBucket[bucketIndex][i].addrStart == physAddr)
-			{
-				LatteTexture* tex = list_texMemOccupancyBucket[bucketIndex][i].sliceMipInfo->texture;
-				if (tex->physAddress == physAddr)
-				{
-					vectorAppendUnique(list_textures, tex);
-				}
-			}
+			vectorAppendUnique(list_textures, tex);
 		}
-	}
+	});
 }
 
 LatteTextureView* LatteTC_GetTextureSliceViewOrTryCreate(MPTR srcImagePtr, MPTR srcMipPtr, Latte::E_GX2SURFFMT srcFormat, Latte::E_HWTILEMODE srcTileMode, uint32 srcWidth, uint32 srcHeight, uint32 srcDepth, uint32 srcPitch, uint32 srcSwizzle, uint32 srcSlice, uint32 srcMip, const bool requireExactResolution)
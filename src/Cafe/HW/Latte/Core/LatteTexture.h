@@ -152,6 +152,7 @@ public:
 	// state
 	bool isUpdatedOnGPU{ false }; // set if any GPU-side operation modified this texture and strict one-way RAM->VRAM memory mirroring no longer applies
 	bool enableReadback{ false }; // if true, texture will be mirrored back to CPU RAM under specific circumstances
+	uint32 pendingReadbackWriteCount{}; // number of readbacks of this texture which are currently being written to RAM by a worker thread
 	// invalidation
 	bool forceInvalidate{};
 	// cache control
@@ -191,6 +192,7 @@ public:
 	// usage
 	uint32 lastAccessTick{};
 	uint32 lastAccessFrameCount{};
+	uint64 hostMemorySize{}; // estimated size of the host texture including all mips and slices, used for the texture cache budget
 	// detection of render feedback loops (see OpenGL 4.5 spec, 9.3)
 	uint32 lastUnflushedRTDrawcallIndex{};
 	// views
@@ -330,6 +332,7 @@ std::vector<LatteTextureInformation> LatteTexture_QueryCacheInfo();
 
 float* LatteTexture_getEffectiveTextureScale(LatteConst::ShaderType shaderType, sint32 texUnit);
 
+uint64 LatteTexture_EstimateHostMemorySize(LatteTexture* tex);
 LatteTextureView* LatteTexture_CreateTexture(Latte::E_DIM dim, MPTR physAddress, MPTR physMipAddress, Latte::E_GX2SURFFMT format, uint32 width, uint32 height, uint32 depth, uint32 pitch, uint32 mipLevels, uint32 swizzle, Latte::E_HWTILEMODE tileMode, bool isDepth);
 void LatteTexture_Delete(LatteTexture* texture);
 
@@ -348,6 +351,25 @@ void LatteTexture_InitSliceAndMipInfo(LatteTexture* texture);
 void LatteTexture_RegisterTextureMemoryOccupancy(LatteTexture* texture);
 void LatteTexture_UnregisterTextureMemoryOccupancy(LatteTexture* texture);
 
+// memory occupancy trace, recorded with --texmem-trace and replayed with --texmem-replay
+struct LatteTexMemTraceRecord
+{
+	enum class OP : uint32
+	{
+		INSERT, // interval [start, end) of a texture
+		REMOVE, // all intervals of a texture
+		QUERY_OVERLAP, // intervals overlapping [start, end)
+		QUERY_START, // intervals starting at start
+	};
+	OP op;
+	uint32 start;
+	uint32 end;
+	uint32 textureId;
+};
+
+void LatteTexture_FlushTexMemOccupancyTrace();
+bool LatteTexture_ReplayMemOccupancyTrace(const fs::path& tracePath);
+
 void LatteTexture_DeleteTextureRelations(LatteTexture* texture);
 void LatteTexture_DeleteDataOverlapTracking(LatteTexture* texture);
 
@@ -3,9 +3,25 @@
 #include "Cafe/HW/Latte/Core/LatteTexture.h"
 #include "Cafe/HW/Latte/Renderer/Renderer.h"
 #include "Common/cpu_features.h"
+#include "config/CemuConfig.h"
 
 std::unordered_set<LatteTexture*> g_allTextures;
 
+// memory budget
+static uint64 s_textureMemoryUsage = 0; // sum of LatteTexture::hostMemorySize of all registered textures
+static uint64 s_textureMemoryBudget = 0;
+static uint32 s_textureEvictionCount = 0;
+static uint32 s_textureSetGeneration = 0; // changes whenever a texture is registered or unregistered
+// set when the budget could not be reached because there was nothing left to evict. Avoids rescanning all textures every frame until something changes
+static struct
+{
+	bool isActive{false};
+	uint32 textureSetGeneration;
+	uint32 frameCount;
+	uint64 budget;
+}s_budgetBackoff;
+
+
 void LatteTC_Init()
 {
 	cemu_assert_debug(g_allTextures.empty());
@@ -13,12 +29,20 @@ void LatteTC_Init()
 
 void LatteTC_RegisterTexture(LatteTexture* tex)
 {
-	g_allTextures.emplace(tex);
+	if (g_allTextures.emplace(tex).second)
+	{
+		s_textureMemoryUsage += tex->hostMemorySize;
+		s_textureSetGeneration++;
+	}
 }
 
 void LatteTC_UnregisterTexture(LatteTexture* tex)
 {
-	g_allTextures.erase(tex);
+	if (g_allTextures.erase(tex) != 0)
+	{
+		s_textureMemoryUsage -= tex->hostMemorySize;
+		s_textureSetGeneration++;
+	}
 }
 
 // sample few uint64s uniformly over memory range
@@ -45,6 +69,7 @@ uint32 LatteTexture_CalculateTextureDataHash(LatteTexture* hostTexture)
 	{
 		return 0;
 	}
+	LatteTextureReadback_WaitForPendingWrites(hostTexture->texDataPtrLow, hostTexture->texDataPtrHigh - hostTexture->texDataPtrLow);
 	if (hostTexture->format == Latte::E_GX2SURFFMT::R11_G11_B10_FLOAT)
 	{
 		// this is an exotic format that usually isn't generated or updated CPU-side
@@ -200,6 +225,9 @@ uint64 _botwLargeTexHax = 0;
 
 bool LatteTC_HasTextureChanged(LatteTexture* hostTexture, bool force)
 {
+	// RAM is being updated from this texture's own data, the change tracker is reset once the write completes
+	if (hostTexture->pendingReadbackWriteCount != 0)
+		return false;
 	if (hostTexture->forceInvalidate)
 	{
 		force = true;
@@ -362,6 +390,71 @@ bool LatteTC_CleanupCheckTexture(LatteTexture* texture, uint32 currentTick)
 
 void LatteTexture_RefreshInfoCache();
 
+/*
+ * Evicts textures while the estimated memory usage exceeds the budget set in the config
+ * Only textures whose content is either backed by RAM or overwritten by other textures are considered
+ */
+static void LatteTC_EnforceMemoryBudget()
+{
+	s_textureMemoryBudget = (uint64)GetConfig().texture_cache_budget.GetValue() * 1024 * 1024;
+	if (s_textureMemoryBudget == 0 || s_textureMemoryUsage <= s_textureMemoryBudget)
+		return;
+	uint32 currentFrameCount = LatteGPUState.frameCounter;
+	// textures only become candidates a few frames after their last access, so check again from time to time even if the set is unchanged
+	if (s_budgetBackoff.isActive && s_budgetBackoff.textureSetGeneration == s_textureSetGeneration && s_budgetBackoff.budget == s_textureMemoryBudget && (currentFrameCount - s_budgetBackoff.frameCount) < 60)
+		return;
+	s_budgetBackoff.isActive = false;
+	struct EvictionCandidate
+	{
+		LatteTexture* texture;
+		uint64 score;
+		bool isReloadable;
+	};
+	std::vector<EvictionCandidate> candidates;
+	for (auto& itr : g_allTextures)
+	{
+		if (itr->lastAccessFrameCount == 0)
+			continue; // not initialized
+		uint32 framesSinceLastAccess = currentFrameCount - itr->lastAccessFrameCount;
+		if (framesSinceLastAccess < 3)
+			continue;
+		if (itr->isUpdatedOnGPU && !LatteTC_IsTextureDataOverwritten(itr))
+			continue; // the texture holds the only copy of its data
+		candidates.push_back({itr, (uint64)framesSinceLastAccess * std::max<uint64>(itr->hostMemorySize, 1), !itr->isUpdatedOnGPU});
+	}
+	// textures with overwritten data are never needed again and go first, RAM backed textures cost a reload
+	// within each group old and large textures are evicted first
+	std::sort(candidates.begin(), candidates.end(), [](const EvictionCandidate& a, const EvictionCandidate& b) {
+		if (a.isReloadable != b.isReloadable)
+			return !a.isReloadable;
+		return a.score > b.score;
+	});
+	sint32 maxDelete = 16; // limit the per-frame cost, the remaining overshoot is handled over the next frames
+	for (auto& candidate : candidates)
+	{
+		if (s_textureMemoryUsage <= s_textureMemoryBudget || maxDelete <= 0)
+			break;
+		LatteTexture_Delete(candidate.texture);
+		s_textureEvictionCount++;
+		maxDelete--;
+	}
+	if (s_textureMemoryUsage > s_textureMemoryBudget && maxDelete > 0)
+	{
+		// ran out of candidates
+		s_budgetBackoff.isActive = true;
+		s_budgetBackoff.textureSetGeneration = s_textureSetGeneration;
+		s_budgetBackoff.frameCount = currentFrameCount;
+		s_budgetBackoff.budget = s_textureMemoryBudget;
+	}
+}
+
+void LatteTC_GetMemoryBudgetStats(uint64& usage, uint64& budget, uint32& evictionCount)
+{
+	usage = s_textureMemoryUsage;
+	budget = s_textureMemoryBudget;
+	evictionCount = s_textureEvictionCount;
+}
+
 /*
  * Scans for unused textures and deletes them
  * Called at the end of every frame
@@ -392,6 +485,7 @@ void LatteTC_CleanupUnusedTextures()
 			}
 		}
 	}
+	LatteTC_EnforceMemoryBudget();
 	LatteTexture_RefreshInfoCache(); // find a better place to call this from?
 }
 
@@ -430,4 +524,5 @@ void LatteTC_UnloadAllTextures()
 			LatteTexture_Delete(itr);
 	}
 	LatteRenderTarget_unloadAll();
+	LatteTexture_FlushTexMemOccupancyTrace();
 }
\ No newline at end of file
@@ -70,6 +70,25 @@ void LatteTexture_ReloadData(LatteTexture* tex)
 	tex->lastUpdateEventCounter = LatteTexture_getNextUpdateEventCounter();
 }
 
+uint64 LatteTexture_EstimateHostMemorySize(LatteTexture* tex)
+{
+	// based on the guest format, host formats can differ slightly in size (e.g. D24 is often stored as D32)
+	const uint64 formatBits = tex->GetBPP();
+	uint64 size = 0;
+	for (sint32 mip = 0; mip < tex->mipLevels; mip++)
+	{
+		sint32 width, height;
+		tex->GetEffectiveSize(width, height, mip);
+		uint64 texelCount;
+		if (tex->IsCompressedFormat())
+			texelCount = (uint64)((width + 3) / 4) * (uint64)((height + 3) / 4); // bits are per 4x4 block
+		else
+			texelCount = (uint64)width * (uint64)height;
+		size += texelCount * (uint64)tex->GetMipDepth(mip) * formatBits / 8;
+	}
+	return size;
+}
+
 LatteTextureView* LatteTexture_CreateTexture(Latte::E_DIM dim, MPTR physAddress, MPTR physMipAddress, Latte::E_GX2SURFFMT format, uint32 width, uint32 height, uint32 depth, uint32 pitch, uint32 mipLevels, uint32 swizzle, Latte::E_HWTILEMODE tileMode, bool isDepth)
 {
 	const auto tex = g_renderer->texture_createTextureEx(dim, physAddress, physMipAddress, format, width, height, depth, pitch, mipLevels, swizzle, tileMode, isDepth);
@@ -81,6 +100,7 @@ LatteTextureView* LatteTexture_CreateTexture(Latte::E_DIM dim, MPTR physAddress,
 
 	LatteTexture_ReloadData(tex);
 	LatteTC_MarkTextureStillInUse(tex);
+	tex->hostMemorySize = LatteTexture_EstimateHostMemorySize(tex);
 	LatteTC_RegisterTexture(tex);
 
 	// create initial view that maps to the whole texture
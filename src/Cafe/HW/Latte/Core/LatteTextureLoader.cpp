@@ -634,6 +634,9 @@ void LatteTextureLoader_UpdateTextureSliceData(LatteTexture* tex, uint32 sliceIn
 	uint32 imageSize = texDecoder->calculateImageSize(&textureLoader);
 
 	uint8* pixelData = (uint8*)g_renderer->texture_acquireTextureUploadBuffer(imageSize);
+	// a readback may still be retiling data into this range
+	MPTR inputAddress = (mipIndex == 0) ? textureLoader.physAddress : (textureLoader.physMipAddress + textureLoader.levelOffset);
+	LatteTextureReadback_WaitForPendingWrites(inputAddress, (uint32)textureLoader.maxOffsetOutdated);
 	// decode texture (if data is required)
 #ifdef BENCHMARK_TEXTURE_DECODING
 	LARGE_INTEGER benchmark_begin;
@@ -0,0 +1,222 @@
+#include "Cafe/HW/Latte/Core/LatteTexture.h"
+#include "util/containers/IntervalTree.h"
+#include "Common/FileStream.h"
+
+/* Texture memory occupancy replay
+ * Replays a trace recorded with --texmem-trace against the interval tree before and after modifications were batched and reports the time each one took
+ * The result of every query (number of intervals and a hash of them) is compared between both trees, intervals reported by a query are hashed independent of their order
+ */
+
+constexpr uint32 TEXMEM_REPLAY_RUNS = 5; // the fastest run is reported
+
+// the interval tree as originally introduced. Every modification invalidates the index and the next overlap query rebuilds it in O(n)
+template<typename TAddr, typename TData>
+class LegacyIntervalTree
+{
+public:
+	struct Interval
+	{
+		TAddr start;
+		TAddr end;
+		TData data;
+		TAddr subtreeMaxEnd;
+	};
+
+	void Insert(TAddr start, TAddr end, TData data)
+	{
+		auto it = std::upper_bound(m_intervals.begin(), m_intervals.end(), start, [](TAddr addr, const Interval& interval) { return addr < interval.start; });
+		m_intervals.insert(it, Interval{start, end, data, end});
+		m_isIndexed = false;
+	}
+
+	template<typename TPred>
+	size_t RemoveIf(TPred pred)
+	{
+		size_t removedCount = std::erase_if(m_intervals, [&](const Interval& interval) { return pred(interval); });
+		if (removedCount != 0)
+			m_isIndexed = false;
+		return removedCount;
+	}
+
+	template<typename TFunc>
+	void ForEachOverlap(TAddr start, TAddr end, TFunc f)
+	{
+		if (m_intervals.empty() || start >= end)
+			return;
+		if (!m_isIndexed)
+			BuildIndex();
+		struct StackEntry
+		{
+			sint64 index;
+			sint32 level;
+			bool isLeftVisited;
+		};
+		const sint64 count = (sint64)m_intervals.size();
+		StackEntry stack[64];
+		sint32 stackSize = 0;
+		stack[stackSize++] = {((sint64)1 << m_rootLevel) - 1, m_rootLevel, false};
+		while (stackSize > 0)
+		{
+			StackEntry node = stack[--stackSize];
+			if (node.level <= 3)
+			{
+				sint64 first = node.index >> node.level << node.level;
+				sint64 last = std::min(first + ((sint64)1 << (node.level + 1)) - 1, count);
+				for (sint64 i = first; i < last && m_intervals[i].start < end; i++)
+				{
+					if (m_intervals[i].end > start)
+						f(std::as_const(m_intervals[i]));
+				}
+			}
+			else if (!node.isLeftVisited)
+			{
+				sint64 leftIndex = node.index - ((sint64)1 << (node.level - 1));
+				stack[stackSize++] = {node.index, node.level, true};
+				if (leftIndex >= count || m_intervals[leftIndex].subtreeMaxEnd > start)
+					stack[stackSize++] = {leftIndex, node.level - 1, false};
+			}
+			else if (node.index < count && m_intervals[node.index].start < end)
+			{
+				if (m_intervals[node.index].end > start)
+					f(std::as_const(m_intervals[node.index]));
+				stack[stackSize++] = {node.index + ((sint64)1 << (node.level - 1)), node.level - 1, false};
+			}
+		}
+	}
+
+	template<typename TFunc>
+	void ForEachStartingAt(TAddr addr, TFunc f)
+	{
+		auto first = std::lower_bound(m_intervals.begin(), m_intervals.end(), addr, [](const Interval& interval, TAddr addr) { return interval.start < addr; });
+		for (auto it = first; it != m_intervals.end() && it->start == addr; ++it)
+			f(std::as_const(*it));
+	}
+
+private:
+	void BuildIndex()
+	{
+		const sint64 count = (sint64)m_intervals.size();
+		sint64 lastIndex = 0;
+		TAddr lastMaxEnd{};
+		for (sint64 i = 0; i < count; i += 2)
+		{
+			lastIndex = i;
+			lastMaxEnd = m_intervals[i].subtreeMaxEnd = m_intervals[i].end;
+		}
+		sint32 level;
+		for (level = 1; ((sint64)1 << level) <= count; level++)
+		{
+			const sint64 childOffset = (sint64)1 << (level - 1);
+			for (sint64 i = (childOffset << 1) - 1; i < count; i += childOffset << 2)
+			{
+				TAddr maxEnd = std::max(m_intervals[i].end, m_intervals[i - childOffset].subtreeMaxEnd);
+				maxEnd = std::max(maxEnd, (i + childOffset) < count ? m_intervals[i + childOffset].subtreeMaxEnd : lastMaxEnd);
+				m_intervals[i].subtreeMaxEnd = maxEnd;
+			}
+			lastIndex = ((lastIndex >> level) & 1) ? (lastIndex - childOffset) : (lastIndex + childOffset);
+			if (lastIndex < count)
+				lastMaxEnd = std::max(lastMaxEnd, m_intervals[lastIndex].subtreeMaxEnd);
+		}
+		m_rootLevel = level - 1;
+		m_isIndexed = true;
+	}
+
+	std::vector<Interval> m_intervals;
+	sint32 m_rootLevel{0};
+	bool m_isIndexed{false};
+};
+
+struct TexMemReplayQueryResult
+{
+	uint32 count;
+	uint64 hash;
+
+	bool operator==(const TexMemReplayQueryResult&) const = default;
+};
+
+static uint64 TexMemReplay_hashInterval(uint32 start, uint32 end, uint32 textureId)
+{
+	uint64 h = ((uint64)start << 32 | end) * 0x9E3779B97F4A7C15ull;
+	h ^= (uint64)textureId * 0xC2B2AE3D27D4EB4Full;
+	return h ^ (h >> 29);
+}
+
+// runs the trace once and returns the elapsed time. The query results are written to results
+template<typename TTree>
+static double TexMemReplay_run(std::span<const LatteTexMemTraceRecord> records, std::vector<TexMemReplayQueryResult>& results)
+{
+	TTree tree;
+	results.clear();
+	results.reserve(records.size());
+	auto startTime = std::chrono::steady_clock::now();
+	for (const LatteTexMemTraceRecord& record : records)
+	{
+		TexMemReplayQueryResult result{};
+		auto collect = [&](const auto& interval) {
+			result.count++;
+			result.hash += TexMemReplay_hashInterval(interval.start, interval.end, interval.data);
+		};
+		switch (record.op)
+		{
+		case LatteTexMemTraceRecord::OP::INSERT:
+			tree.Insert(record.start, record.end, record.textureId);
+			break;
+		case LatteTexMemTraceRecord::OP::REMOVE:
+			tree.RemoveIf([&](const auto& interval) { return interval.data == record.textureId; });
+			break;
+		case LatteTexMemTraceRecord::OP::QUERY_OVERLAP:
+			tree.ForEachOverlap(record.start, record.end, collect);
+			results.emplace_back(result);
+			break;
+		case LatteTexMemTraceRecord::OP::QUERY_START:
+			tree.ForEachStartingAt(record.start, collect);
+			results.emplace_back(result);
+			break;
+		}
+	}
+	return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+}
+
+bool LatteTexture_ReplayMemOccupancyTrace(const fs::path& tracePath)
+{
+	std::optional<std::vector<uint8>> traceData = FileStream::LoadIntoMemory(tracePath);
+	if (!traceData || (traceData->size() % sizeof(LatteTexMemTraceRecord)) != 0)
+	{
+		fmt::print("Unable to load texture memory trace {}\n", _pathToUtf8(tracePath));
+		return false;
+	}
+	std::vector<LatteTexMemTraceRecord> records(traceData->size() / sizeof(LatteTexMemTraceRecord));
+	memcpy(records.data(), traceData->data(), traceData->size());
+	uint32 opCount[4]{};
+	for (const LatteTexMemTraceRecord& record : records)
+	{
+		if ((uint32)record.op >= std::size(opCount))
+		{
+			fmt::print("Invalid record in texture memory trace\n");
+			return false;
+		}
+		opCount[(uint32)record.op]++;
+	}
+	fmt::print("Texture memory occupancy replay: {} inserts, {} removals, {} overlap queries, {} start queries\n", opCount[0], opCount[1], opCount[2], opCount[3]);
+
+	std::vector<TexMemReplayQueryResult> legacyResults;
+	std::vector<TexMemReplayQueryResult> currentResults;
+	double legacyMs = std::numeric_limits<double>::max();
+	double currentMs = std::numeric_limits<double>::max();
+	for (uint32 i = 0; i < TEXMEM_REPLAY_RUNS; i++)
+	{
+		legacyMs = std::min(legacyMs, TexMemReplay_run<LegacyIntervalTree<uint32, uint32>>(records, legacyResults));
+		currentMs = std::min(currentMs, TexMemReplay_run<IntervalTree<uint32, uint32>>(records, currentResults));
+	}
+	fmt::print("{:<20} {:10.2f}ms\n", "rebuild per insert", legacyMs);
+	fmt::print("{:<20} {:10.2f}ms\n", "batched", currentMs);
+
+	size_t mismatchCount = 0;
+	for (size_t i = 0; i < legacyResults.size(); i++)
+	{
+		if (legacyResults[i] != currentResults[i])
+			mismatchCount++;
+	}
+	fmt::print("{}\n", mismatchCount == 0 ? "All query results match" : fmt::format("{} query results do NOT match", mismatchCount));
+	return mismatchCount == 0;
+}
@@ -6,7 +6,9 @@
 
 #include "Cafe/HW/Latte/Renderer/Renderer.h"
 #include "Cafe/HW/Latte/Core/LatteTexture.h"
+#include "Cafe/HW/Latte/LatteAddrLib/LatteAddrLib.h"
 #include "Cafe/HW/Latte/Renderer/OpenGL/LatteTextureViewGL.h"
+#include "util/ThreadPool/ThreadPool.h"
 
 #define LOG_READBACK_TIME
 
@@ -15,10 +17,39 @@ struct LatteTextureReadbackQueueEntry
 	HRTick initiateTime;
 	uint32 lastUpdateDrawcallIndex;
 	LatteTextureView* textureView;
+	bool isPredictedLastWrite; // start the transfer without waiting for further drawcalls
+};
+
+// finished transfers which are being retiled into RAM on a worker thread
+// if the GPU thread needs the data before a worker got to it, it claims the write and does it itself
+struct LatteTextureReadbackPendingWrite
+{
+	LatteTextureReadbackInfo* readbackInfo;
+	LatteTexture* sourceTexture; // nullptr if the texture was deleted in the meantime
+	MPTR rangeBegin; // guest memory written by the worker
+	MPTR rangeEnd;
+	uint8* pixelData;
+	bool isClaimed{ false }; // protected by sTextureReadbackWriteMutex
+	std::atomic_bool isWritten{ false };
+};
+
+// per-texture history used to predict the last write of a frame for textures which are read back every frame
+struct LatteTextureReadbackHistory
+{
+	uint32 lastFrame;
+	uint32 frameStreak; // number of consecutive frames with a readback
+	uint32 writeCountCurrentFrame;
+	uint32 writeCountLastFrame;
 };
 
 std::vector<LatteTextureReadbackQueueEntry> sTextureScheduledReadbacks; // readbacks that have been queued but the actual transfer has not yet been started
 std::queue<LatteTextureReadbackInfo*> sTextureActiveReadbackQueue; // readbacks in flight
+std::deque<std::shared_ptr<LatteTextureReadbackPendingWrite>> sTextureReadbackPendingWrites; // in submission order, shared with the queued worker tasks
+std::unordered_map<LatteTexture*, LatteTextureReadbackHistory> sTextureReadbackHistory;
+// a single serial queue keeps writes to the same memory in order
+ThreadPool::SerialQueue sTextureReadbackWriteQueue{ ThreadPool::Priority::High };
+// held for the duration of each write. Writes are claimed and done in submission order, either by the worker or by the GPU thread
+std::mutex sTextureReadbackWriteMutex;
 
 void LatteTextureReadback_StartTransfer(LatteTextureView* textureView)
 {
@@ -43,11 +74,11 @@ bool LatteTextureReadback_Update(bool forceStart)
 	{
 		LatteTextureReadbackQueueEntry& entry = sTextureScheduledReadbacks[i];
 		uint32 numElapsedDrawcalls = LatteGPUState.drawCallCounter - entry.lastUpdateDrawcallIndex;
-		if (forceStart || numElapsedDrawcalls >= 5)
+		if (forceStart || entry.isPredictedLastWrite || numElapsedDrawcalls >= 5)
 		{
 #ifdef LOG_READBACK_TIME
 			double elapsedSecondsSinceInitiate = HighResolutionTimer::getTimeDiff(entry.initiateTime, HighResolutionTimer().now().getTick());
-			cemuLog_log(LogType::TextureReadback, "[TextureReadback-Update] Starting transfer for {:08x} after {} elapsed drawcalls. Time since initiate: {:.4} Force-start: {}", entry.textureView->baseTexture->physAddress, numElapsedDrawcalls, elapsedSecondsSinceInitiate, forceStart?"yes":"no");
+			cemuLog_log(LogType::TextureReadback, "[TextureReadback-Update] Starting transfer for {:08x} after {} elapsed drawcalls. Time since initiate: {:.4} Force-start: {} Predicted: {}", entry.textureView->baseTexture->physAddress, numElapsedDrawcalls, elapsedSecondsSinceInitiate, forceStart?"yes":"no", entry.isPredictedLastWrite?"yes":"no");
 #endif
 			LatteTextureReadback_StartTransfer(entry.textureView);
 			// remove element
@@ -74,6 +105,32 @@ void LatteTextureReadback_NotifyTextureDeletion(LatteTexture* texture)
 			break;
 		}
 	}
+	for (auto& pendingWrite : sTextureReadbackPendingWrites)
+	{
+		if (pendingWrite->sourceTexture == texture)
+			pendingWrite->sourceTexture = nullptr;
+	}
+	sTextureReadbackHistory.erase(texture);
+}
+
+/*
+ * Tracks how often the texture is written per frame
+ * Returns true if the texture was read back in the previous frames and this write is likely the last one of the current frame
+ */
+bool LatteTextureReadback_PredictLastWrite(LatteTexture* texture)
+{
+	LatteTextureReadbackHistory& history = sTextureReadbackHistory[texture];
+	uint32 currentFrame = LatteGPUState.frameCounter;
+	if (history.lastFrame != currentFrame)
+	{
+		history.frameStreak = (history.frameStreak > 0 && history.lastFrame + 1 == currentFrame) ? (history.frameStreak + 1) : 1;
+		history.writeCountLastFrame = history.writeCountCurrentFrame;
+		history.writeCountCurrentFrame = 0;
+		history.lastFrame = currentFrame;
+	}
+	history.writeCountCurrentFrame++;
+	// a misprediction costs one extra transfer, since any further write queues the readback again
+	return history.frameStreak >= 3 && history.writeCountCurrentFrame >= history.writeCountLastFrame;
 }
 
 void LatteTextureReadback_Initate(LatteTextureView* textureView)
@@ -84,6 +141,7 @@ void LatteTextureReadback_Initate(LatteTextureView* textureView)
 		cemuLog_log(LogType::Force, "Texture readback is not supported for textures with modified resolution. Texture: {:08x} {}x{}", textureView->baseTexture->physAddress, textureView->baseTexture->width, textureView->baseTexture->height);
 		return;
 	}
+	bool isPredictedLastWrite = LatteTextureReadback_PredictLastWrite(textureView->baseTexture);
 	// check if texture isn't already queued for transfer
 	for (size_t i = 0; i < sTextureScheduledReadbacks.size(); i++)
 	{
@@ -91,6 +149,7 @@ void LatteTextureReadback_Initate(LatteTextureView* textureView)
 		if (entry.textureView == textureView)
 		{
 			entry.lastUpdateDrawcallIndex = LatteGPUState.drawCallCounter;
+			entry.isPredictedLastWrite = isPredictedLastWrite;
 			return;
 		}
 	}
@@ -99,9 +158,117 @@ void LatteTextureReadback_Initate(LatteTextureView* textureView)
 	queueEntry.initiateTime = HighResolutionTimer().now().getTick();
 	queueEntry.textureView = textureView;
 	queueEntry.lastUpdateDrawcallIndex = LatteGPUState.drawCallCounter;
+	queueEntry.isPredictedLastWrite = isPredictedLastWrite;
 	sTextureScheduledReadbacks.emplace_back(queueEntry);
 }
 
+// does the write unless it was already claimed. Claiming and writing happen under the same lock, so when this returns the write is done
+void LatteTextureReadback_RunPendingWrite(LatteTextureReadbackPendingWrite& pendingWrite)
+{
+	std::unique_lock _l(sTextureReadbackWriteMutex);
+	if (pendingWrite.isClaimed)
+		return;
+	pendingWrite.isClaimed = true;
+	LatteTextureLoader_writeReadbackTextureToMemory(&pendingWrite.readbackInfo->hostTextureCopy, 0, 0, pendingWrite.pixelData);
+	pendingWrite.isWritten.store(true, std::memory_order::release);
+}
+
+/*
+ * Makes sure the first writeCount pending writes are done, in order
+ * Writes no worker has started yet are done on the calling thread, so this only ever waits for the write currently in progress
+ */
+void LatteTextureReadback_FinishPendingWrites(size_t writeCount)
+{
+	for (size_t i = 0; i < writeCount; i++)
+	{
+		LatteTextureReadbackPendingWrite& pendingWrite = *sTextureReadbackPendingWrites[i];
+		if (!pendingWrite.isWritten.load(std::memory_order::acquire))
+			LatteTextureReadback_RunPendingWrite(pendingWrite);
+	}
+}
+
+/*
+ * Blocks until all pending writes which overlap the given guest memory range are done
+ * Has to be called before the GPU thread reads memory which may be the target of a readback
+ */
+void LatteTextureReadback_WaitForPendingWrites(MPTR physAddress, uint32 size)
+{
+	if (sTextureReadbackPendingWrites.empty())
+		return;
+	MPTR rangeEnd = physAddress + size;
+	size_t writeCount = 0;
+	for (size_t i = 0; i < sTextureReadbackPendingWrites.size(); i++)
+	{
+		LatteTextureReadbackPendingWrite& pendingWrite = *sTextureReadbackPendingWrites[i];
+		if (pendingWrite.rangeBegin < rangeEnd && pendingWrite.rangeEnd > physAddress && !pendingWrite.isWritten.load(std::memory_order::acquire))
+			writeCount = i + 1;
+	}
+	// earlier writes may overlap with the ones we need, so they have to finish first
+	LatteTextureReadback_FinishPendingWrites(writeCount);
+}
+
+void LatteTextureReadback_RetireFrontPendingWrite()
+{
+	LatteTextureReadbackPendingWrite& pendingWrite = *sTextureReadbackPendingWrites.front();
+	cemu_assert_debug(pendingWrite.isWritten.load(std::memory_order::acquire));
+	pendingWrite.readbackInfo->ReleaseData();
+	// the RAM now matches the texture, reset the change tracker so it doesn't get reloaded
+	if (pendingWrite.sourceTexture)
+	{
+		cemu_assert_debug(pendingWrite.sourceTexture->pendingReadbackWriteCount > 0);
+		pendingWrite.sourceTexture->pendingReadbackWriteCount--;
+		LatteTC_ResetTextureChangeTracker(pendingWrite.sourceTexture, true);
+	}
+	delete pendingWrite.readbackInfo;
+	sTextureReadbackPendingWrites.pop_front();
+}
+
+/*
+ * Releases the readbacks whose data has been written to RAM
+ * If waitForAll is set, blocks until all pending writes are done
+ */
+void LatteTextureReadback_RetirePendingWrites(bool waitForAll)
+{
+	while (!sTextureReadbackPendingWrites.empty())
+	{
+		LatteTextureReadbackPendingWrite& pendingWrite = *sTextureReadbackPendingWrites.front();
+		if (!pendingWrite.isWritten.load(std::memory_order::acquire))
+		{
+			if (!waitForAll)
+				break;
+			LatteTextureReadback_FinishPendingWrites(1);
+		}
+		LatteTextureReadback_RetireFrontPendingWrite();
+	}
+}
+
+/*
+ * Finishes and releases the oldest readback that is still alive, regardless of whether it is in flight or being written to RAM
+ * Used by the renderer to reclaim staging memory. Readbacks which are currently being created are not affected
+ * Returns false if there is no readback left
+ */
+bool LatteTextureReadback_RetireOldest()
+{
+	if (sTextureReadbackPendingWrites.empty())
+	{
+		if (sTextureActiveReadbackQueue.empty())
+			return false;
+		LatteTextureReadbackInfo* readbackInfo = sTextureActiveReadbackQueue.front();
+		if (!readbackInfo->IsFinished())
+		{
+			readbackInfo->forceFinish = true;
+			readbackInfo->ForceFinish();
+		}
+		// hands the finished transfer to the worker. ForceFinish() may already have done this and retired the write
+		LatteTextureReadback_UpdateFinishedTransfers(false);
+		if (sTextureReadbackPendingWrites.empty())
+			return true;
+	}
+	LatteTextureReadback_FinishPendingWrites(1);
+	LatteTextureReadback_RetireFrontPendingWrite();
+	return true;
+}
+
 void LatteTextureReadback_UpdateFinishedTransfers(bool forceFinish)
 {
 	if (forceFinish)
@@ -147,18 +314,30 @@ void LatteTextureReadback_UpdateFinishedTransfers(bool forceFinish)
 			cemuLog_log(LogType::TextureReadback, "[Texture-Readback] {:08x} Res {}/{} TM {} FMT {:04x} ReadbackLatency: {:6.3}ms WaitTime: {:6.3}ms ForcedWait {}", readbackInfo->hostTextureCopy.physAddress, readbackInfo->hostTextureCopy.width, readbackInfo->hostTextureCopy.height, readbackInfo->hostTextureCopy.tileMode, (uint32)readbackInfo->hostTextureCopy.format, elapsedSecondsTransfer * 1000.0, elapsedSecondsWaiting * 1000.0, readbackInfo->forceFinish ? "yes" : "no");
 		}
 #endif
-		uint8* pixelData = readbackInfo->GetData();
-		LatteTextureLoader_writeReadbackTextureToMemory(&readbackInfo->hostTextureCopy, 0, 0, pixelData);
-		readbackInfo->ReleaseData();
-		// get the original texture if it still exists and invalidate the current data hash
+		// hand the data to a worker thread for retiling into RAM. The readback is released once the write is done
+		auto pendingWrite = std::make_shared<LatteTextureReadbackPendingWrite>();
+		pendingWrite->readbackInfo = readbackInfo;
+		// get the original texture if it still exists, its change tracker is suspended until the write is done
 		LatteTextureView* origTexView = LatteTextureViewLookupCache::lookupSlice(readbackInfo->hostTextureCopy.physAddress, readbackInfo->hostTextureCopy.width, readbackInfo->hostTextureCopy.height, readbackInfo->hostTextureCopy.pitch, 0, 0, readbackInfo->hostTextureCopy.format);
-		if (origTexView)
-			LatteTC_ResetTextureChangeTracker(origTexView->baseTexture, true);
-		delete readbackInfo;
+		pendingWrite->sourceTexture = origTexView ? origTexView->baseTexture : nullptr;
+		if (pendingWrite->sourceTexture)
+			pendingWrite->sourceTexture->pendingReadbackWriteCount++;
+		// the GPU thread waits for the write before it reads anything in this range, see LatteTextureReadback_WaitForPendingWrites()
+		const LatteTextureDefinition& texDef = readbackInfo->hostTextureCopy;
+		LatteAddrLib::AddrSurfaceInfo_OUT surfaceInfo;
+		LatteAddrLib::GX2CalculateSurfaceInfo(texDef.format, texDef.width, texDef.height, texDef.depth, texDef.dim, Latte::MakeGX2TileMode(texDef.tileMode), 0, 0, &surfaceInfo);
+		pendingWrite->rangeBegin = texDef.physAddress;
+		pendingWrite->rangeEnd = texDef.physAddress + (uint32)surfaceInfo.surfSize;
+		pendingWrite->pixelData = readbackInfo->GetData();
+		// the task only touches the readback if it claims the write, otherwise the GPU thread may already have released it
+		sTextureReadbackWriteQueue.Submit([pendingWrite]() { LatteTextureReadback_RunPendingWrite(*pendingWrite); });
+		sTextureReadbackPendingWrites.emplace_back(std::move(pendingWrite));
 		// remove from queue
 		cemu_assert_debug(!sTextureActiveReadbackQueue.empty());
 		cemu_assert_debug(readbackInfo == sTextureActiveReadbackQueue.front());
 		sTextureActiveReadbackQueue.pop();
 	}
+	// the guest may access the data after a forced finish, so all writes have to be done by then
+	LatteTextureReadback_RetirePendingWrites(forceFinish);
 	performanceMonitor.gpuTime_waitForAsync.endMeasuring();
 }
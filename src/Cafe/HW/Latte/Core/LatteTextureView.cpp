@@ -76,6 +76,11 @@ struct LatteTexViewLookupDesc
 		firstSlice -= baseSlice;
 	}
 
+	LatteTextureViewLookupKey GetLookupKey() const
+	{
+		return { physAddr, pitch, format, firstMip, firstSlice };
+	}
+
 	// key data for looking up views
 	MPTR physAddr;
 	MPTR physMipAddr;
@@ -93,70 +98,279 @@ struct LatteTexViewLookupDesc
 	LatteTextureView* view;
 };
 
-struct LatteTexViewBucket
+// views are grouped by the parameters which all lookup variants compare, see LatteTextureViewLookupKey
+// groups live in an open addressing hash table with linear probing that grows as needed
+// the keys are stored as separate arrays and are preceded by a one byte tag derived from the hash, so probing mostly touches only the tag array
+class LatteTexViewLookupTable
 {
-	std::vector<LatteTexViewLookupDesc> list;
-};
+public:
+	LatteTexViewLookupTable()
+	{
+		Allocate(1024);
+	}
 
-#define TEXTURE_VIEW_BUCKETS	(1061)
+	std::vector<LatteTexViewLookupDesc>* Find(const LatteTextureViewLookupKey& key)
+	{
+		uint32 probeLength;
+		uint32 slotIndex = FindSlot(key, probeLength);
+		StatAdd(m_stats.lookupCount, 1);
+		StatAdd(m_stats.probeCount, probeLength);
+		if (probeLength > m_stats.maxProbeLength.load(std::memory_order::relaxed))
+			m_stats.maxProbeLength.store(probeLength, std::memory_order::relaxed);
+		if (m_tags[slotIndex] == SLOT_EMPTY)
+			return nullptr;
+		return &m_groups[slotIndex];
+	}
 
-inline uint32 _getViewBucketKey(MPTR physAddress, uint32 width, uint32 height, uint32 pitch)
-{
-	return (physAddress + width * 7 + height * 11 + pitch * 13) % TEXTURE_VIEW_BUCKETS;
-}
+	std::vector<LatteTexViewLookupDesc>& GetOrCreate(const LatteTextureViewLookupKey& key)
+	{
+		uint32 probeLength;
+		uint32 slotIndex = FindSlot(key, probeLength);
+		if (m_tags[slotIndex] != SLOT_EMPTY)
+			return m_groups[slotIndex];
+		// keep the load factor at or below 1/2
+		if ((m_groupCount + 1) * 2 > (uint32)m_tags.size())
+		{
+			Grow();
+			slotIndex = FindSlot(key, probeLength);
+		}
+		m_tags[slotIndex] = GetTag(GetHash(key));
+		m_keyPhysAddr[slotIndex] = key.physAddr;
+		m_keyPitch[slotIndex] = key.pitch;
+		m_keyFormat[slotIndex] = key.format;
+		m_keyFirstMip[slotIndex] = key.firstMip;
+		m_keyFirstSlice[slotIndex] = key.firstSlice;
+		m_groupCount++;
+		PublishSizeStats();
+		return m_groups[slotIndex];
+	}
 
-inline uint32 _getViewBucketKeyNoRes(MPTR physAddress, uint32 pitch)
-{
-	return (physAddress + pitch * 13) % TEXTURE_VIEW_BUCKETS;
-}
+	void Remove(const LatteTextureViewLookupKey& key, LatteTextureView* view)
+	{
+		uint32 probeLength;
+		uint32 slotIndex = FindSlot(key, probeLength);
+		if (m_tags[slotIndex] == SLOT_EMPTY)
+			return;
+		auto& group = m_groups[slotIndex];
+		group.erase(std::remove_if(group.begin(), group.end(), [view](const LatteTexViewLookupDesc& v) {
+			return v.view == view; }), group.end());
+		if (group.empty())
+			EraseSlot(slotIndex);
+	}
+
+	template<typename TFunc>
+	void ForEachGroup(TFunc f)
+	{
+		for (size_t i = 0; i < m_tags.size(); i++)
+		{
+			if (m_tags[i] != SLOT_EMPTY)
+				f(m_groups[i]);
+		}
+	}
+
+	void RecordHit()
+	{
+		StatAdd(m_stats.hitCount, 1);
+	}
+
+	// called from the overlay on the UI thread while the GPU thread keeps updating the counters
+	LatteTextureViewLookupCache::LookupStats GetStats() const
+	{
+		LatteTextureViewLookupCache::LookupStats stats;
+		stats.lookupCount = m_stats.lookupCount.load(std::memory_order::relaxed);
+		stats.hitCount = m_stats.hitCount.load(std::memory_order::relaxed);
+		stats.probeCount = m_stats.probeCount.load(std::memory_order::relaxed);
+		stats.maxProbeLength = m_stats.maxProbeLength.load(std::memory_order::relaxed);
+		stats.groupCount = m_stats.groupCount.load(std::memory_order::relaxed);
+		stats.capacity = m_stats.capacity.load(std::memory_order::relaxed);
+		return stats;
+	}
+
+private:
+	static constexpr uint8 SLOT_EMPTY = 0;
+
+	// the counters are only written by the GPU thread, so a relaxed load and store is enough and avoids a locked add on the lookup path
+	template<typename T>
+	static void StatAdd(std::atomic<T>& counter, std::type_identity_t<T> value)
+	{
+		counter.store(counter.load(std::memory_order::relaxed) + value, std::memory_order::relaxed);
+	}
+
+	void PublishSizeStats()
+	{
+		m_stats.groupCount.store(m_groupCount, std::memory_order::relaxed);
+		m_stats.capacity.store((uint32)m_tags.size(), std::memory_order::relaxed);
+	}
+
+	static uint32 GetHash(const LatteTextureViewLookupKey& key)
+	{
+		uint64 h = (uint64)key.physAddr * 0x9E3779B97F4A7C15ull;
+		h ^= ((uint64)(uint32)key.pitch | ((uint64)(uint32)key.format << 32)) * 0xC2B2AE3D27D4EB4Full;
+		h ^= ((uint64)(uint32)key.firstMip | ((uint64)(uint32)key.firstSlice << 32)) * 0x165667B19E3779F9ull;
+		h ^= h >> 29;
+		return (uint32)(h >> 32);
+	}
+
+	// the slot index is taken from the low bits, the tag from the high bits. The top bit marks the slot as used
+	static uint8 GetTag(uint32 hash)
+	{
+		return (uint8)(hash >> 25) | 0x80;
+	}
+
+	bool IsKeyInSlot(uint32 slotIndex, const LatteTextureViewLookupKey& key) const
+	{
+		return m_keyPhysAddr[slotIndex] == key.physAddr && m_keyPitch[slotIndex] == key.pitch && m_keyFormat[slotIndex] == key.format &&
+			m_keyFirstMip[slotIndex] == key.firstMip && m_keyFirstSlice[slotIndex] == key.firstSlice;
+	}
+
+	LatteTextureViewLookupKey GetKeyInSlot(uint32 slotIndex) const
+	{
+		return { m_keyPhysAddr[slotIndex], m_keyPitch[slotIndex], m_keyFormat[slotIndex], m_keyFirstMip[slotIndex], m_keyFirstSlice[slotIndex] };
+	}
+
+	// returns the slot holding the key or the empty slot where it would be inserted
+	uint32 FindSlot(const LatteTextureViewLookupKey& key, uint32& probeLength) const
+	{
+		const uint32 hash = GetHash(key);
+		const uint8 tag = GetTag(hash);
+		uint32 slotIndex = hash & m_slotMask;
+		probeLength = 1;
+		while (m_tags[slotIndex] != SLOT_EMPTY)
+		{
+			if (m_tags[slotIndex] == tag && IsKeyInSlot(slotIndex, key))
+				break;
+			slotIndex = (slotIndex + 1) & m_slotMask;
+			probeLength++;
+		}
+		return slotIndex;
+	}
+
+	void MoveSlot(uint32 dstIndex, uint32 srcIndex)
+	{
+		m_tags[dstIndex] = m_tags[srcIndex];
+		m_keyPhysAddr[dstIndex] = m_keyPhysAddr[srcIndex];
+		m_keyPitch[dstIndex] = m_keyPitch[srcIndex];
+		m_keyFormat[dstIndex] = m_keyFormat[srcIndex];
+		m_keyFirstMip[dstIndex] = m_keyFirstMip[srcIndex];
+		m_keyFirstSlice[dstIndex] = m_keyFirstSlice[srcIndex];
+		m_groups[dstIndex] = std::move(m_groups[srcIndex]);
+	}
 
-LatteTexViewBucket texViewBucket[TEXTURE_VIEW_BUCKETS] = { };
-LatteTexViewBucket texViewBucket_nores[TEXTURE_VIEW_BUCKETS] = { };
+	// backward shift deletion, keeps probe sequences intact without tombstones
+	void EraseSlot(uint32 slotIndex)
+	{
+		uint32 holeIndex = slotIndex;
+		uint32 nextIndex = (holeIndex + 1) & m_slotMask;
+		while (m_tags[nextIndex] != SLOT_EMPTY)
+		{
+			uint32 homeIndex = GetHash(GetKeyInSlot(nextIndex)) & m_slotMask;
+			// the entry can only move back if the hole is not located before its home slot
+			if (((nextIndex - homeIndex) & m_slotMask) >= ((nextIndex - holeIndex) & m_slotMask))
+			{
+				MoveSlot(holeIndex, nextIndex);
+				holeIndex = nextIndex;
+			}
+			nextIndex = (nextIndex + 1) & m_slotMask;
+		}
+		m_tags[holeIndex] = SLOT_EMPTY;
+		m_groups[holeIndex].clear();
+		m_groupCount--;
+		PublishSizeStats();
+	}
+
+	void Allocate(uint32 capacity)
+	{
+		cemu_assert_debug(std::has_single_bit(capacity));
+		m_tags.assign(capacity, SLOT_EMPTY);
+		m_keyPhysAddr.assign(capacity, 0);
+		m_keyPitch.assign(capacity, 0);
+		m_keyFormat.assign(capacity, Latte::E_GX2SURFFMT::INVALID_FORMAT);
+		m_keyFirstMip.assign(capacity, 0);
+		m_keyFirstSlice.assign(capacity, 0);
+		m_groups.clear();
+		m_groups.resize(capacity);
+		m_slotMask = capacity - 1;
+		m_groupCount = 0;
+		PublishSizeStats();
+	}
+
+	void Grow()
+	{
+		std::vector<uint8> oldTags = std::move(m_tags);
+		std::vector<MPTR> oldKeyPhysAddr = std::move(m_keyPhysAddr);
+		std::vector<sint32> oldKeyPitch = std::move(m_keyPitch);
+		std::vector<Latte::E_GX2SURFFMT> oldKeyFormat = std::move(m_keyFormat);
+		std::vector<sint32> oldKeyFirstMip = std::move(m_keyFirstMip);
+		std::vector<sint32> oldKeyFirstSlice = std::move(m_keyFirstSlice);
+		std::vector<std::vector<LatteTexViewLookupDesc>> oldGroups = std::move(m_groups);
+		Allocate((uint32)oldTags.size() * 2);
+		for (size_t i = 0; i < oldTags.size(); i++)
+		{
+			if (oldTags[i] == SLOT_EMPTY)
+				continue;
+			LatteTextureViewLookupKey key{ oldKeyPhysAddr[i], oldKeyPitch[i], oldKeyFormat[i], oldKeyFirstMip[i], oldKeyFirstSlice[i] };
+			uint32 probeLength;
+			uint32 slotIndex = FindSlot(key, probeLength);
+			m_tags[slotIndex] = oldTags[i];
+			m_keyPhysAddr[slotIndex] = key.physAddr;
+			m_keyPitch[slotIndex] = key.pitch;
+			m_keyFormat[slotIndex] = key.format;
+			m_keyFirstMip[slotIndex] = key.firstMip;
+			m_keyFirstSlice[slotIndex] = key.firstSlice;
+			m_groups[slotIndex] = std::move(oldGroups[i]);
+			m_groupCount++;
+		}
+	}
+
+	std::vector<uint8> m_tags;
+	std::vector<MPTR> m_keyPhysAddr;
+	std::vector<sint32> m_keyPitch;
+	std::vector<Latte::E_GX2SURFFMT> m_keyFormat;
+	std::vector<sint32> m_keyFirstMip;
+	std::vector<sint32> m_keyFirstSlice;
+	std::vector<std::vector<LatteTexViewLookupDesc>> m_groups;
+	uint32 m_slotMask{};
+	uint32 m_groupCount{};
+	struct
+	{
+		std::atomic<uint64> lookupCount{};
+		std::atomic<uint64> hitCount{};
+		std::atomic<uint64> probeCount{};
+		std::atomic<uint32> maxProbeLength{};
+		std::atomic<uint32> groupCount{};
+		std::atomic<uint32> capacity{};
+	} m_stats;
+};
+
+LatteTexViewLookupTable s_texViewLookupTable;
 
 void LatteTextureViewLookupCache::Add(LatteTextureView* view, uint32 baseMip, uint32 baseSlice)
 {
 	LatteTexViewLookupDesc desc(view);
 	if (baseMip != 0 || baseSlice != 0)
 		desc.SetParametersForSubTexture(baseMip, baseSlice);
-	// generic bucket
-	uint32 key = _getViewBucketKey(desc.physAddr, desc.width, desc.height, desc.pitch);
-	texViewBucket[key].list.emplace_back(desc);
+	LatteTextureViewLookupKey key = desc.GetLookupKey();
+	s_texViewLookupTable.GetOrCreate(key).emplace_back(desc);
 	vectorAppendUnique(view->viewLookUpCacheKeys, key);
-	// resolution-independent bucket
-	key = _getViewBucketKeyNoRes(desc.physAddr, desc.pitch);
-	texViewBucket_nores[key].list.push_back(desc);
-	vectorAppendUnique(view->viewLookUpCacheKeysNoRes, key);
 }
 
 void LatteTextureViewLookupCache::RemoveAll(LatteTextureView* view)
 {
 	for (auto& key : view->viewLookUpCacheKeys)
-	{
-		auto& bucket = texViewBucket[key].list;
-		bucket.erase(std::remove_if(bucket.begin(), bucket.end(), [view](const LatteTexViewLookupDesc& v) {
-			return v.view == view; }), bucket.end());
-	}
-	for (auto& key : view->viewLookUpCacheKeysNoRes)
-	{
-		auto& bucket = texViewBucket_nores[key].list;
-		bucket.erase(std::remove_if(bucket.begin(), bucket.end(), [view](const LatteTexViewLookupDesc& v) {
-			return v.view == view; }), bucket.end());
-	}
+		s_texViewLookupTable.Remove(key, view);
 }
 
 LatteTextureView* LatteTextureViewLookupCache::lookup(MPTR physAddr, sint32 width, sint32 height, sint32 depth, sint32 pitch, sint32 firstMip, sint32 numMip, sint32 firstSlice, sint32 numSlice, Latte::E_GX2SURFFMT format, Latte::E_DIM dim)
 {
 	// todo - add tileMode param to this and the other lookup functions?
-	uint32 key = _getViewBucketKey(physAddr, width, height, pitch);
-	key %= TEXTURE_VIEW_BUCKETS;
-	for (auto& it : texViewBucket[key].list)
-	{
-		if (it.format == format && it.dim == dim &&
-			it.width == width && it.height == height && it.pitch == pitch && it.physAddr == physAddr
-			&& it.firstMip == firstMip && it.numMip == numMip
-			&& it.firstSlice == firstSlice && it.numSlice == numSlice
-			)
+	auto group = s_texViewLookupTable.Find({ physAddr, pitch, format, firstMip, firstSlice });
+	if (!group)
+		return nullptr;
+	for (auto& it : *group)
+	{
+		if (it.dim == dim && it.width == width && it.height == height && it.numMip == numMip && it.numSlice == numSlice)
 		{
+			s_texViewLookupTable.RecordHit();
 			return it.view;
 		}
 	}
@@ -166,16 +380,14 @@ LatteTextureView* LatteTextureViewLookupCache::lookup(MPTR physAddr, sint32 widt
 LatteTextureView* LatteTextureViewLookupCache::lookupWithColorOrDepthType(MPTR physAddr, sint32 width, sint32 height, sint32 depth, sint32 pitch, sint32 firstMip, sint32 numMip, sint32 firstSlice, sint32 numSlice, Latte::E_GX2SURFFMT format, Latte::E_DIM dim, bool isDepth)
 {
 	cemu_assert_debug(firstSlice == 0);
-	uint32 key = _getViewBucketKey(physAddr, width, height, pitch);
-	key %= TEXTURE_VIEW_BUCKETS;
-	for (auto& it : texViewBucket[key].list)
-	{
-		if (it.format == format && it.dim == dim && it.width == width && it.height == height && it.pitch == pitch && it.physAddr == physAddr
-			&& it.firstMip == firstMip && it.numMip == numMip
-			&& it.firstSlice == firstSlice && it.numSlice == numSlice &&
-			it.isDepth == isDepth
-			)
+	auto group = s_texViewLookupTable.Find({ physAddr, pitch, format, firstMip, firstSlice });
+	if (!group)
+		return nullptr;
+	for (auto& it : *group)
+	{
+		if (it.dim == dim && it.width == width && it.height == height && it.numMip == numMip && it.numSlice == numSlice && it.isDepth == isDepth)
 		{
+			s_texViewLookupTable.RecordHit();
 			return it.view;
 		}
 	}
@@ -185,14 +397,15 @@ LatteTextureView* LatteTextureViewLookupCache::lookupWithColorOrDepthType(MPTR p
 // look up view with unspecified mipCount and sliceCount
 LatteTextureView* LatteTextureViewLookupCache::lookupSlice(MPTR physAddr, sint32 width, sint32 height, sint32 pitch, sint32 firstMip, sint32 firstSlice, Latte::E_GX2SURFFMT format)
 {
-	uint32 key = _getViewBucketKey(physAddr, width, height, pitch);
-	key %= TEXTURE_VIEW_BUCKETS;
-	for (auto& it : texViewBucket[key].list)
+	auto group = s_texViewLookupTable.Find({ physAddr, pitch, format, firstMip, firstSlice });
+	if (!group)
+		return nullptr;
+	for (auto& it : *group)
 	{
-		if (it.width == width && it.height == height && it.pitch == pitch && it.physAddr == physAddr && it.format == format)
+		if (it.width == width && it.height == height)
 		{
-			if (firstSlice == it.firstSlice && firstMip == it.firstMip)
-				return it.view;
+			s_texViewLookupTable.RecordHit();
+			return it.view;
 		}
 	}
 	return nullptr;
@@ -201,14 +414,15 @@ LatteTextureView* LatteTextureViewLookupCache::lookupSlice(MPTR physAddr, sint32
 // look up view with unspecified mipCount/sliceCount and only minimum width and height given
 LatteTextureView* LatteTextureViewLookupCache::lookupSliceMinSize(MPTR physAddr, sint32 minWidth, sint32 minHeight, sint32 pitch, sint32 firstMip, sint32 firstSlice, Latte::E_GX2SURFFMT format)
 {
-	uint32 key = _getViewBucketKeyNoRes(physAddr, pitch);
-	key %= TEXTURE_VIEW_BUCKETS;
-	for (auto& it : texViewBucket_nores[key].list)
+	auto group = s_texViewLookupTable.Find({ physAddr, pitch, format, firstMip, firstSlice });
+	if (!group)
+		return nullptr;
+	for (auto& it : *group)
 	{
-		if (it.width >= minWidth && it.height >= minHeight && it.pitch == pitch && it.physAddr == physAddr && it.format == format)
+		if (it.width >= minWidth && it.height >= minHeight)
 		{
-			if (firstSlice == it.firstSlice && firstMip == it.firstMip)
-				return it.view;
+			s_texViewLookupTable.RecordHit();
+			return it.view;
 		}
 	}
 	return nullptr;
@@ -218,14 +432,15 @@ LatteTextureView* LatteTextureViewLookupCache::lookupSliceMinSize(MPTR physAddr,
 LatteTextureView* LatteTextureViewLookupCache::lookupSliceEx(MPTR physAddr, sint32 width, sint32 height, sint32 pitch, sint32 firstMip, sint32 firstSlice, Latte::E_GX2SURFFMT format, bool isDepth)
 {
 	cemu_assert_debug(firstMip == 0);
-	uint32 key = _getViewBucketKey(physAddr, width, height, pitch);
-	key %= TEXTURE_VIEW_BUCKETS;
-	for (auto& it : texViewBucket[key].list)
+	auto group = s_texViewLookupTable.Find({ physAddr, pitch, format, firstMip, firstSlice });
+	if (!group)
+		return nullptr;
+	for (auto& it : *group)
 	{
-		if (it.width == width && it.height == height && it.pitch == pitch && it.physAddr == physAddr && it.format == format && it.isDepth == isDepth)
+		if (it.width == width && it.height == height && it.isDepth == isDepth)
 		{
-			if (firstSlice == it.firstSlice && firstMip == it.firstMip)
-				return it.view;
+			s_texViewLookupTable.RecordHit();
+			return it.view;
 		}
 	}
 	return nullptr;
@@ -234,10 +449,15 @@ LatteTextureView* LatteTextureViewLookupCache::lookupSliceEx(MPTR physAddr, sint
 std::unordered_set<LatteTextureView*> LatteTextureViewLookupCache::GetAllViews()
 {
 	std::unordered_set<LatteTextureView*> viewSet;
-	for (uint32 i = 0; i < TEXTURE_VIEW_BUCKETS; i++)
+	s_texViewLookupTable.ForEachGroup([&](const std::vector<LatteTexViewLookupDesc>& group)
 	{
-		for (auto& it : texViewBucket[i].list)
+		for (auto& it : group)
 			viewSet.emplace(it.view);
-	}
+	});
 	return viewSet;
-}
\ No newline at end of file
+}
+
+LatteTextureViewLookupCache::LookupStats LatteTextureViewLookupCache::GetStats()
+{
+	return s_texViewLookupTable.GetStats();
+}
@@ -1,5 +1,17 @@
 #pragma once
 
+// parameters which are compared by every view lookup variant
+struct LatteTextureViewLookupKey
+{
+	MPTR physAddr;
+	sint32 pitch;
+	Latte::E_GX2SURFFMT format;
+	sint32 firstMip;
+	sint32 firstSlice;
+
+	bool operator==(const LatteTextureViewLookupKey& other) const = default;
+};
+
 class LatteTextureView
 {
 public:
@@ -30,8 +42,7 @@ public:
 	std::vector<class LatteCachedFBO*> list_fboLookup; // only set for the first color texture of each FBO, or the depth texture if no color textures are present
 	std::vector<class LatteCachedFBO*> list_associatedFbo; // list of cached fbos that reference this texture view
 	// view lookup cache
-	std::vector<uint32> viewLookUpCacheKeys;
-	std::vector<uint32> viewLookUpCacheKeysNoRes;
+	std::vector<LatteTextureViewLookupKey> viewLookUpCacheKeys;
 };
 
 class LatteTextureViewLookupCache
@@ -48,5 +59,14 @@ public:
 
 	static std::unordered_set<LatteTextureView*> GetAllViews();
 
-	
+	struct LookupStats
+	{
+		uint64 lookupCount;
+		uint64 hitCount;
+		uint64 probeCount; // total number of hash table slots inspected by all lookups
+		uint32 maxProbeLength;
+		uint32 groupCount; // number of distinct lookup keys
+		uint32 capacity;
+	};
+	static LookupStats GetStats();
 };
\ No newline at end of file
@@ -33,6 +33,7 @@ void Latte_LoadInitialRegisters()
 	LatteGPUState.contextNew.VGT_DMA_NUM_INSTANCES.set_NUM_INSTANCES(1);
 	LatteGPUState.contextRegister[Latte::REGADDR::PA_CL_CLIP_CNTL] = 0;
 	*(float*)&LatteGPUState.contextRegister[mmDB_DEPTH_CLEAR] = 1.0f;
+	LatteGPUState.dirtyRegisterGroups = LATTE_DIRTY_ALL;
 }
 
 extern bool gx2WriteGatherInited;
@@ -248,6 +249,8 @@ bool Latte_GetStopSignal()
 
 void LatteThread_Exit()
 {
+	// let readback writes to RAM finish while the renderer still exists
+	LatteTextureReadback_RetirePendingWrites(true);
 	if (g_renderer)
 		g_renderer->Shutdown();
     // clean up vertex/uniform cache
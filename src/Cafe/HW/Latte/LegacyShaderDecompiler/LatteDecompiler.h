@@ -197,6 +197,7 @@ struct LatteDecompilerShader
 	bool hasStreamoutBufferWrite{ false };
 	// output code
 	class StringBuf* strBuf_shaderSource{ nullptr };
+	std::vector<uint32> spirvFromIR; // Vulkan only, experimental. If set it is used instead of compiling the GLSL source
 	// separable shaders
 	RendererShader* shader{ nullptr };
 	bool isCustomShader{ false };
@@ -265,6 +266,8 @@ struct LatteDecompilerOutputUniformOffsets
 struct LatteDecompilerOptions
 {
 	bool usesGeometryShader{ false };
+	// pixel shader inputs, also determines which vertex/geometry shader outputs are exported
+	struct LatteShaderPSInputTable* psInputTable{ nullptr };
 	// floating point math
 	bool strictMul{}; // if true, 0*anything=0 rule is emulated
 	// Vulkan-specific
@@ -989,7 +989,7 @@ void LatteDecompiler_analyze(LatteDecompilerShaderContext* shaderContext, LatteD
 	else if (shaderContext->analyzer.usesRelativeGPRRead && shader->shaderType == LatteConst::ShaderType::Pixel)
 	{
 		// mark pixel shader inputs as used if there is any relative GPR access
-		LatteShaderPSInputTable* psInputTable = LatteSHRC_GetPSInputTable();
+		LatteShaderPSInputTable* psInputTable = shaderContext->options->psInputTable;
 		for (sint32 i = 0; i < psInputTable->count; i++)
 		{
 			shaderContext->analyzer.gprUseMask[i / 8] |= (1 << (i % 8));
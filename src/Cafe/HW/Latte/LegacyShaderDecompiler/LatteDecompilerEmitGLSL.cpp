@@ -98,8 +98,9 @@ const char* _getElementStrByIndex(uint32 channel)
 	return "UNDEFINED";
 }
 
-char _tempGenString[64][256];
-uint32 _tempGenStringIndex = 0;
+// per thread since shaders can be decompiled on multiple threads at once
+thread_local char _tempGenString[64][256];
+thread_local uint32 _tempGenStringIndex = 0;
 
 char* _getTempString()
 {
@@ -447,11 +448,11 @@ private:
 	boost::container::small_vector<GPRTemporary, 4> m_gprTemporaries;
 };
 
-sint32 _getVertexShaderOutParamSemanticId(uint32* contextRegisters, sint32 index) // deprecated - move to LatteShaderPSInputTable
+sint32 _getVertexShaderOutParamSemanticId(LatteDecompilerShaderContext* shaderContext, sint32 index) // deprecated - move to LatteShaderPSInputTable
 {
-	uint32 vsSemanticId = (contextRegisters[mmSPI_VS_OUT_ID_0 + (index / 4)] >> (8 * (index % 4))) & 0xFF;
+	uint32 vsSemanticId = (shaderContext->contextRegisters[mmSPI_VS_OUT_ID_0 + (index / 4)] >> (8 * (index % 4))) & 0xFF;
 	// check if export exists since exports are generated based on PS inputs
-	LatteShaderPSInputTable* psInputTable = LatteSHRC_GetPSInputTable();
+	LatteShaderPSInputTable* psInputTable = shaderContext->options->psInputTable;
 	for (sint32 i = 0; i < psInputTable->count; i++)
 	{
 		if(psInputTable->import[i].semanticId == vsSemanticId)
@@ -3255,7 +3256,7 @@ void _emitExportCode(LatteDecompilerShaderContext* shaderContext, LatteDecompile
 		{
 			// export parameter
 			sint32 paramIndex = cfInstruction->exportArrayBase;
-			uint32 vsSemanticId = _getVertexShaderOutParamSemanticId(shaderContext->contextRegisters, paramIndex);
+			uint32 vsSemanticId = _getVertexShaderOutParamSemanticId(shaderContext, paramIndex);
 			if (vsSemanticId != 0xFF)
 			{
 				src->addFmt("passParameterSem{} = ", vsSemanticId);
@@ -4120,7 +4121,7 @@ void LatteDecompiler_emitGLSLShader(LatteDecompilerShaderContext* shaderContext,
 	}
 	else if (shader->shaderType == LatteConst::ShaderType::Pixel)
 	{
-		LatteShaderPSInputTable* psInputTable = LatteSHRC_GetPSInputTable();
+		LatteShaderPSInputTable* psInputTable = shaderContext->options->psInputTable;
 
 		uint32 psControl0 = shaderContext->contextRegisters[mmSPI_PS_IN_CONTROL_0];
 		uint32 psControl1 = shaderContext->contextRegisters[mmSPI_PS_IN_CONTROL_1];
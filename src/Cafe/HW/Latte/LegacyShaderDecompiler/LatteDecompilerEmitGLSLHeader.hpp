@@ -358,13 +358,13 @@ namespace LatteDecompiler
 		std::array<bool, 32> activePassParams{};
 
 		auto* src = shaderContext->shaderSource;
-		LatteShaderPSInputTable* psInputTable = LatteSHRC_GetPSInputTable();
+		LatteShaderPSInputTable* psInputTable = shaderContext->options->psInputTable;
 		auto parameterMask = shaderContext->shader->outputParameterMask;
 		for (uint32 i = 0; i < 32; i++)
 		{
 			if ((parameterMask&(1 << i)) == 0)
 				continue;
-			uint32 vsSemanticId = _getVertexShaderOutParamSemanticId(shaderContext->contextRegisters, i);
+			uint32 vsSemanticId = _getVertexShaderOutParamSemanticId(shaderContext, i);
 			if (vsSemanticId > LATTE_ANALYZER_IMPORT_INDEX_PARAM_MAX)
 				continue;
 			// get import based on semanticId
@@ -410,7 +410,7 @@ namespace LatteDecompiler
 	void _emitPSImports(LatteDecompilerShaderContext* shaderContext)
 	{
 		auto* src = shaderContext->shaderSource;
-		LatteShaderPSInputTable* psInputTable = LatteSHRC_GetPSInputTable();
+		LatteShaderPSInputTable* psInputTable = shaderContext->options->psInputTable;
 		for (sint32 i = 0; i < psInputTable->count; i++)
 		{
 			if (psInputTable->import[i].semanticId > LATTE_ANALYZER_IMPORT_INDEX_PARAM_MAX)
@@ -498,7 +498,7 @@ namespace LatteDecompiler
 			else if (decompilerContext->shaderType == LatteConst::ShaderType::Pixel)
 			{
 				// pixel shader with geometry shader
-				LatteShaderPSInputTable* psInputTable = LatteSHRC_GetPSInputTable();
+				LatteShaderPSInputTable* psInputTable = decompilerContext->options->psInputTable;
 				for (sint32 i = 0; i < psInputTable->count; i++)
 				{
 					if (psInputTable->import[i].semanticId > LATTE_ANALYZER_IMPORT_INDEX_PARAM_MAX)
@@ -51,8 +51,8 @@ static const char* _getElementStrByIndex(uint32 channel)
 	return "UNDEFINED";
 }
 
-static char _tempGenString[64][256];
-static uint32 _tempGenStringIndex = 0;
+static thread_local char _tempGenString[64][256];
+static thread_local uint32 _tempGenStringIndex = 0;
 
 static char* _getTempString()
 {
@@ -400,7 +400,7 @@ private:
 	boost::container::small_vector<GPRTemporary, 4> m_gprTemporaries;
 };
 
-sint32 _getVertexShaderOutParamSemanticId(uint32* contextRegisters, sint32 index);
+sint32 _getVertexShaderOutParamSemanticId(LatteDecompilerShaderContext* shaderContext, sint32 index);
 sint32 _getInputRegisterDataType(LatteDecompilerShaderContext* shaderContext, LatteDecompilerALUInstruction* aluInstruction, sint32 operandIndex);
 sint32 _getALUInstructionOutputDataType(LatteDecompilerShaderContext* shaderContext, LatteDecompilerALUInstruction* aluInstruction);
 bool _isReductionInstruction(LatteDecompilerALUInstruction* aluInstruction);
@@ -3232,7 +3232,7 @@ static void _emitExportCode(LatteDecompilerShaderContext* shaderContext, LatteDe
 		{
 			// export parameter
 			sint32 paramIndex = cfInstruction->exportArrayBase;
-			uint32 vsSemanticId = _getVertexShaderOutParamSemanticId(shaderContext->contextRegisters, paramIndex);
+			uint32 vsSemanticId = _getVertexShaderOutParamSemanticId(shaderContext, paramIndex);
 			if (vsSemanticId != 0xFF)
 			{
 				src->addFmt("out.passParameterSem{} = ", vsSemanticId);
@@ -4323,7 +4323,7 @@ void LatteDecompiler_emitMSLShader(LatteDecompilerShaderContext* shaderContext,
 	}
 	else if (shader->shaderType == LatteConst::ShaderType::Pixel)
 	{
-		LatteShaderPSInputTable* psInputTable = LatteSHRC_GetPSInputTable();
+		LatteShaderPSInputTable* psInputTable = shaderContext->options->psInputTable;
 
 		uint32 psControl0 = shaderContext->contextRegisters[mmSPI_PS_IN_CONTROL_0];
 		uint32 psControl1 = shaderContext->contextRegisters[mmSPI_PS_IN_CONTROL_1];
@@ -184,14 +184,14 @@ namespace LatteDecompiler
 		if (shaderContext->analyzer.outputPointSize)
 		    src->add("float pointSize [[point_size]];" _CRLF);
 
-		LatteShaderPSInputTable* psInputTable = LatteSHRC_GetPSInputTable();
+		LatteShaderPSInputTable* psInputTable = shaderContext->options->psInputTable;
 		auto parameterMask = shaderContext->shader->outputParameterMask;
 		bool psInputsWritten[GPU7_PS_MAX_INPUTS] = {false};
 		for (uint32 i = 0; i < 32; i++)
 		{
 			if ((parameterMask&(1 << i)) == 0)
 				continue;
-			uint32 vsSemanticId = _getVertexShaderOutParamSemanticId(shaderContext->contextRegisters, i);
+			uint32 vsSemanticId = _getVertexShaderOutParamSemanticId(shaderContext, i);
 			if (vsSemanticId > LATTE_ANALYZER_IMPORT_INDEX_PARAM_MAX)
 				continue;
 			// get import based on semanticId
@@ -253,7 +253,7 @@ namespace LatteDecompiler
 		src->add("struct FragmentIn {" _CRLF);
 		src->add("float4 position [[position]];" _CRLF);
 
-		LatteShaderPSInputTable* psInputTable = LatteSHRC_GetPSInputTable();
+		LatteShaderPSInputTable* psInputTable = shaderContext->options->psInputTable;
 		for (sint32 i = 0; i < psInputTable->count; i++)
 		{
 			if (psInputTable->import[i].semanticId > LATTE_ANALYZER_IMPORT_INDEX_PARAM_MAX)
@@ -7,6 +7,8 @@ LatteTextureReadbackInfoMtl::~LatteTextureReadbackInfoMtl()
 {
     if (m_commandBuffer)
         m_commandBuffer->release();
+    // the data has been written to RAM, the staging region can be reused
+    m_mtlr->texture_releaseReadbackRegion(m_bufferOffset);
 }
 
 void LatteTextureReadbackInfoMtl::StartTransfer()
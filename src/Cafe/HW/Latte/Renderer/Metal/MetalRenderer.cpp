@@ -940,12 +940,41 @@ LatteTextureReadbackInfo* MetalRenderer::texture_createReadback(LatteTextureView
 		m_readbackBufferWriteOffset = 0;
 	}
 
-    auto* result = new LatteTextureReadbackInfoMtl(this, textureView, m_readbackBufferWriteOffset);
+    const uint32 bufferOffset = m_readbackBufferWriteOffset;
     m_readbackBufferWriteOffset += uploadSize;
 
+    // retire the oldest readbacks until the region no longer holds data which hasn't been written to RAM yet
+    auto isRegionInUse = [&]() {
+        for (auto& region : m_readbackBufferRegions)
+        {
+            if (region.first < (bufferOffset + uploadSize) && (region.first + region.second) > bufferOffset)
+                return true;
+        }
+        return false;
+    };
+    while (isRegionInUse())
+    {
+        if (!LatteTextureReadback_RetireOldest())
+        {
+            cemu_assert_suspicious(); // region is owned by a readback that is no longer tracked
+            m_readbackBufferRegions.clear();
+        }
+    }
+    m_readbackBufferRegions.emplace_back(bufferOffset, (uint32)uploadSize);
+
+    auto* result = new LatteTextureReadbackInfoMtl(this, textureView, bufferOffset);
+
 	return result;
 }
 
+void MetalRenderer::texture_releaseReadbackRegion(uint32 bufferOffset)
+{
+    auto it = std::find_if(m_readbackBufferRegions.begin(), m_readbackBufferRegions.end(), [bufferOffset](const auto& region) { return region.first == bufferOffset; });
+    cemu_assert_debug(it == m_readbackBufferRegions.begin()); // readbacks are retired in order
+    if (it != m_readbackBufferRegions.end())
+        m_readbackBufferRegions.erase(it);
+}
+
 void MetalRenderer::surfaceCopy_copySurfaceWithFormatConversion(LatteTexture* sourceTexture, sint32 srcMip, sint32 srcSlice, LatteTexture* destinationTexture, sint32 dstMip, sint32 dstSlice, sint32 width, sint32 height)
 {
     // scale copy size to effective size
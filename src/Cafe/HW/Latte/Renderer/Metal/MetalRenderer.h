@@ -227,6 +227,7 @@ public:
 	void texture_copyImageSubData(LatteTexture* src, sint32 srcMip, sint32 effectiveSrcX, sint32 effectiveSrcY, sint32 srcSlice, LatteTexture* dst, sint32 dstMip, sint32 effectiveDstX, sint32 effectiveDstY, sint32 dstSlice, sint32 effectiveCopyWidth, sint32 effectiveCopyHeight, sint32 srcDepth) override;
 
 	LatteTextureReadbackInfo* texture_createReadback(LatteTextureView* textureView) override;
+	void texture_releaseReadbackRegion(uint32 bufferOffset);
 
 	// surface copy
 	void surfaceCopy_copySurfaceWithFormatConversion(LatteTexture* sourceTexture, sint32 srcMip, sint32 srcSlice, LatteTexture* destinationTexture, sint32 dstMip, sint32 dstSlice, sint32 width, sint32 height) override;
@@ -520,6 +521,7 @@ private:
 	// Texture readback
 	MTL::Buffer* m_readbackBuffer = nullptr;
 	uint32 m_readbackBufferWriteOffset = 0;
+	std::deque<std::pair<uint32, uint32>> m_readbackBufferRegions; // offset and size of the regions still used by readbacks, in allocation order
 
 	// Transform feedback
 	MTL::Buffer* m_xfbRingBuffer = nullptr;
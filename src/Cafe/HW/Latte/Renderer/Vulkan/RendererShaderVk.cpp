@@ -9,6 +9,8 @@
 #include <glslang/Public/ShaderLang.h>
 #include <glslang/SPIRV/GlslangToSpv.h>
 #include "util/helpers/helpers.h"
+#include "util/ThreadPool/ThreadPool.h"
+#include "util/TraceRecorder/TraceRecorder.h"
 
 bool s_isLoadingShadersVk{ false };
 class FileCache* s_spirvCache{nullptr};
@@ -125,90 +127,33 @@ consteval TBuiltInResource GetDefaultBuiltInResource()
 	return defaultResource;
 };
 
-class _ShaderVkThreadPool
-{
-public:
-	void StartThreads()
-	{
-		if (m_threadsActive.exchange(true))
-			return;
-		// create thread pool
-		const uint32 threadCount = 2;
-		for (uint32 i = 0; i < threadCount; ++i)
-			s_threads.emplace_back(&_ShaderVkThreadPool::CompilerThreadFunc, this);
-	}
-
-	void StopThreads()
-	{
-		if (!m_threadsActive.exchange(false))
-			return;
-		for (uint32 i = 0; i < s_threads.size(); ++i)
-			s_compilationQueueCount.increment();
-		for (auto& it : s_threads)
-			it.join();
-		s_threads.clear();
-	}
-
-	~_ShaderVkThreadPool()
-	{
-		StopThreads();
-	}
-
-	void CompilerThreadFunc()
-	{
-		SetThreadName("vkShaderComp");
-		while (m_threadsActive.load(std::memory_order::relaxed))
-		{
-			s_compilationQueueCount.decrementWithWait();
-			s_compilationQueueMutex.lock();
-			if (s_compilationQueue.empty())
-			{
-				// queue empty again, shaders compiled synchronously via PreponeCompilation()
-				s_compilationQueueMutex.unlock();
-				continue;
-			}
-			RendererShaderVk* job = s_compilationQueue.front();
-			s_compilationQueue.pop_front();
-			// set compilation state
-			cemu_assert_debug(job->m_compilationState.getValue() == RendererShaderVk::COMPILATION_STATE::QUEUED);
-			job->m_compilationState.setValue(RendererShaderVk::COMPILATION_STATE::COMPILING);
-			s_compilationQueueMutex.unlock();
-			// compile
-			job->CompileInternal(false);
-			++g_compiled_shaders_async;
-			// mark as compiled
-			cemu_assert_debug(job->m_compilationState.getValue() == RendererShaderVk::COMPILATION_STATE::COMPILING);
-			job->m_compilationState.setValue(RendererShaderVk::COMPILATION_STATE::DONE);
-		}
-	}
+// shaders are compiled on the background workers of the shared thread pool
+// the group is used to drop shaders which are still queued when the renderer shuts down
+static std::unique_ptr<ThreadPool::TaskGroup> s_compilationTaskGroup;
 
-	bool HasThreadsRunning() const { return m_threadsActive; }
-
-public:
-	std::vector<std::thread> s_threads;
-
-	std::deque<RendererShaderVk*> s_compilationQueue;
-	CounterSemaphore s_compilationQueueCount;
-	std::mutex s_compilationQueueMutex;
-
-private:
-	std::atomic<bool> m_threadsActive;
-}ShaderVkThreadPool;
-
-RendererShaderVk::RendererShaderVk(ShaderType type, uint64 baseHash, uint64 auxHash, bool isGameShader, bool isGfxPackShader, const std::string& glslCode)
-	: RendererShader(type, baseHash, auxHash, isGameShader, isGfxPackShader), m_glslCode(glslCode)
+RendererShaderVk::RendererShaderVk(ShaderType type, uint64 baseHash, uint64 auxHash, bool isGameShader, bool isGfxPackShader, const std::string& glslCode, std::vector<uint32> spirvCode)
+	: RendererShader(type, baseHash, auxHash, isGameShader, isGfxPackShader), m_glslCode(glslCode), m_spirvCode(std::move(spirvCode))
 {
 	// start async compilation
-	ShaderVkThreadPool.s_compilationQueueMutex.lock();
+	cemu_assert_debug(s_compilationTaskGroup); // make sure Init() was called
 	m_compilationState.setValue(COMPILATION_STATE::QUEUED);
-	ShaderVkThreadPool.s_compilationQueue.push_back(this);
-	ShaderVkThreadPool.s_compilationQueueCount.increment();
-	ShaderVkThreadPool.s_compilationQueueMutex.unlock();
-	cemu_assert_debug(ShaderVkThreadPool.HasThreadsRunning()); // make sure .StartThreads() was called
+	// the task only dereferences the shader after claiming it. Once claimed by anyone else the shader may already be deleted
+	ThreadPool::Submit(ThreadPool::Priority::Background, [this, isClaimed = m_isClaimed]() {
+		if (isClaimed->exchange(true))
+			return;
+		m_compilationState.setValue(COMPILATION_STATE::COMPILING);
+		CompileInternal(false);
+		++g_compiled_shaders_async;
+		m_compilationState.setValue(COMPILATION_STATE::DONE);
+	}, s_compilationTaskGroup.get());
 }
 
 RendererShaderVk::~RendererShaderVk()
 {
+	// make sure a pool worker doesn't pick up the shader after it got deleted
+	if (m_isClaimed->exchange(true))
+		m_compilationState.waitUntilValue(COMPILATION_STATE::DONE);
+
 	while (!list_pipelineInfo.empty())
 		delete list_pipelineInfo[0];
 
@@ -218,12 +163,14 @@ RendererShaderVk::~RendererShaderVk()
 
 void RendererShaderVk::Init()
 {
-	ShaderVkThreadPool.StartThreads();
+	s_compilationTaskGroup = std::make_unique<ThreadPool::TaskGroup>();
 }
 
 void RendererShaderVk::Shutdown()
 {
-	ShaderVkThreadPool.StopThreads();
+	s_compilationTaskGroup->Cancel();
+	s_compilationTaskGroup->Wait();
+	s_compilationTaskGroup.reset();
 }
 
 void RendererShaderVk::CreateVkShaderModule(std::span<uint32> spirvBuffer)
@@ -262,12 +209,32 @@ void RendererShaderVk::FinishCompilation()
 {
 	m_glslCode.clear();
 	m_glslCode.shrink_to_fit();
+	m_spirvCode.clear();
+	m_spirvCode.shrink_to_fit();
 }
 
 void RendererShaderVk::CompileInternal(bool isRenderThread)
 {
+	TraceRecorder::Scope traceScope("shader", "CompileShaderVk", "baseHash", m_baseHash, TraceRecorder::ArgFormat::Hex);
 	const bool compileWithDebugInfo = ((VulkanRenderer*)g_renderer.get())->IsTracingToolEnabled();
 
+	// SPIR-V generated from the IR. Not stored in the cache so that the cache only ever holds glslang output
+	if (!m_spirvCode.empty() && !compileWithDebugInfo)
+	{
+		try
+		{
+			CreateVkShaderModule(m_spirvCode);
+			if (!s_isLoadingShadersVk && m_isGameShader)
+				++g_compiled_shaders_total;
+			FinishCompilation();
+			return;
+		}
+		catch (const std::exception& ex)
+		{
+			cemuLog_log(LogType::Force, "Vulkan: SPIR-V from IR rejected for {:016x}_{:016x}, using GLSL instead: {}", m_baseHash, m_auxHash, ex.what());
+		}
+	}
+
 	// try to retrieve SPIR-V module from cache
 	if (s_isLoadingShadersVk && (m_isGameShader && !m_isGfxPackShader) && s_spirvCache && !compileWithDebugInfo)
 	{
@@ -393,29 +360,67 @@ void RendererShaderVk::CompileInternal(bool isRenderThread)
 	FinishCompilation();
 }
 
-void RendererShaderVk::PreponeCompilation(bool isRenderThread)
+bool RendererShaderVk::CompileGLSLToSPIRV(ShaderType type, const std::string& glslCode, std::vector<uint32>& spirvOut, std::string& errorLog)
 {
-	ShaderVkThreadPool.s_compilationQueueMutex.lock();
-	bool isStillQueued = m_compilationState.hasState(COMPILATION_STATE::QUEUED);
-	if (isStillQueued)
+	EShLanguage state;
+	switch (type)
 	{
-		// remove from queue
-		ShaderVkThreadPool.s_compilationQueue.erase(std::remove(ShaderVkThreadPool.s_compilationQueue.begin(), ShaderVkThreadPool.s_compilationQueue.end(), this), ShaderVkThreadPool.s_compilationQueue.end());
-		m_compilationState.setValue(COMPILATION_STATE::COMPILING);
+	case ShaderType::kVertex:
+		state = EShLangVertex;
+		break;
+	case ShaderType::kFragment:
+		state = EShLangFragment;
+		break;
+	case ShaderType::kGeometry:
+		state = EShLangGeometry;
+		break;
+	default:
+		cemu_assert_debug(false);
+		return false;
 	}
-	ShaderVkThreadPool.s_compilationQueueMutex.unlock();
-	if (!isStillQueued)
+	glslang::TShader shader(state);
+	const char* cstr = glslCode.c_str();
+	shader.setStrings(&cstr, 1);
+	shader.setEnvInput(glslang::EShSourceGlsl, state, glslang::EShClientVulkan, 100);
+	shader.setEnvClient(glslang::EShClientVulkan, glslang::EShTargetClientVersion::EShTargetVulkan_1_1);
+	shader.setEnvTarget(glslang::EShTargetSpv, glslang::EShTargetLanguageVersion::EShTargetSpv_1_3);
+	TBuiltInResource resources = GetDefaultBuiltInResource();
+	EShMessages messages = (EShMessages)(EShMsgSpvRules | EShMsgVulkanRules);
+	if (!shader.parse(&resources, 450, ENoProfile, false, false, messages))
 	{
+		errorLog = shader.getInfoLog();
+		return false;
+	}
+	glslang::TProgram program;
+	program.addShader(&shader);
+	if (!program.link(messages) || !program.mapIO())
+	{
+		errorLog = program.getInfoLog();
+		return false;
+	}
+	// keep unused interface variables so the result can be compared against other compilers
+	glslang::SpvOptions spvOptions;
+	spvOptions.disableOptimizer = true;
+	spvOptions.validate = false;
+	spv::SpvBuildLogger logger;
+	spirvOut.clear();
+	GlslangToSpv(*program.getIntermediate(state), spirvOut, &logger, &spvOptions);
+	return true;
+}
+
+void RendererShaderVk::PreponeCompilation(bool isRenderThread)
+{
+	if (m_isClaimed->exchange(true))
+	{
+		// already picked up by a pool worker
 		m_compilationState.waitUntilValue(COMPILATION_STATE::DONE);
 		--g_compiled_shaders_async; // compilation caused a stall so we don't consider this one async
 		return;
 	}
-	else
-	{
-		// compile synchronously
-		CompileInternal(isRenderThread);
-		m_compilationState.setValue(COMPILATION_STATE::DONE);
-	}
+	// compile synchronously
+	m_compilationState.setValue(COMPILATION_STATE::COMPILING);
+	CompileInternal(isRenderThread);
+	m_compilationState.setValue(COMPILATION_STATE::DONE);
 }
 
 bool RendererShaderVk::IsCompiled()
@@ -10,7 +10,6 @@
 class RendererShaderVk : public RendererShader
 {
 	friend class VulkanRenderer;
-	friend class _ShaderVkThreadPool;
 
 	enum class COMPILATION_STATE : uint32
 	{
@@ -25,12 +24,16 @@ public:
     static void ShaderCacheLoading_end();
     static void ShaderCacheLoading_Close();
 
-	RendererShaderVk(ShaderType type, uint64 baseHash, uint64 auxHash, bool isGameShader, bool isGfxPackShader, const std::string& glslCode);
+	// if spirvCode is set it is used instead of compiling glslCode. glslCode is the fallback if the module cannot be created
+	RendererShaderVk(ShaderType type, uint64 baseHash, uint64 auxHash, bool isGameShader, bool isGfxPackShader, const std::string& glslCode, std::vector<uint32> spirvCode = {});
 	virtual ~RendererShaderVk();
 
 	static void Init();
 	static void Shutdown();
 
+	// translate GLSL to SPIR-V without creating a shader module, for offline tools. glslang::InitializeProcess() needs to be called first
+	static bool CompileGLSLToSPIRV(ShaderType type, const std::string& glslCode, std::vector<uint32>& spirvOut, std::string& errorLog);
+
 	VkShaderModule& GetShaderModule() { return m_shader_module; }
 
 	static inline FSpinlock s_dependencyLock;
@@ -61,8 +64,10 @@ private:
 	VkShaderModule m_shader_module = nullptr;
 
 	StateSemaphore<COMPILATION_STATE> m_compilationState{ COMPILATION_STATE::NONE };
+	std::shared_ptr<std::atomic_bool> m_isClaimed{ std::make_shared<std::atomic_bool>(false) }; // set by whoever compiles the shader, either a pool worker or PreponeCompilation()
 
 	std::string m_glslCode;
+	std::vector<uint32> m_spirvCode; // generated directly from the IR (experimental)
 
 	void CreateVkShaderModule(std::span<uint32> spirvBuffer);
 
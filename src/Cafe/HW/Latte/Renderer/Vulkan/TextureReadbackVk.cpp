@@ -10,6 +10,9 @@ LatteTextureReadbackInfoVk::LatteTextureReadbackInfoVk(VkDevice device, LatteTex
 
 LatteTextureReadbackInfoVk::~LatteTextureReadbackInfoVk()
 {
+	// the data has been written to RAM, the staging region can be reused
+	if (m_buffer)
+		VulkanRenderer::GetInstance()->texture_releaseReadbackRegion(m_buffer_offset);
 }
 
 uint32 LatteTextureReadbackInfoVk::GetImageSize(LatteTextureView* textureView)
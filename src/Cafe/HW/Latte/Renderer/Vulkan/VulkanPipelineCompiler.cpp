@@ -8,6 +8,7 @@
 #include "config/ActiveSettings.h"
 #include "util/helpers/helpers.h"
 #include "util/helpers/Serializer.h"
+#include "util/ThreadPool/ThreadPool.h"
 #include "Cafe/HW/Latte/Common/RegisterSerializer.h"
 
 /* rects emulation */
@@ -971,6 +972,8 @@ bool PipelineCompiler::Compile(bool forceCompile, bool isRenderThread, bool show
 			m_vkGeometryShader->PreponeCompilation(isRenderThread);
 	}
 
+	TraceRecorder::Scope traceScope("pipeline", isRenderThread ? "CompilePipelineSync" : "CompilePipelineAsync");
+
 	if (shaderStages.empty())
 	{
 		if (!InitShaderStages(vkRenderer, m_vkVertexShader, m_vkPixelShader, m_vkGeometryShader))
@@ -1120,70 +1123,26 @@ bool PipelineCompiler::CalcRobustBufferAccessRequirement(LatteDecompilerShader*
 	return requiresRobustBufferAcces;
 }
 
-static std::vector<std::thread> s_compileThreads;
-static std::atomic_bool s_compileThreadsShutdownSignal{};
-static ConcurrentQueue<PipelineCompiler*> s_pipelineCompileRequests;
-
-static void compilePipeline_thread(sint32 threadIndex)
-{
-	SetThreadName("compilePl");
-#ifdef _WIN32
-	// to avoid starving the main cpu and render threads the pipeline compile threads run at lower priority
-	// except for one thread which we always run at normal priority to prevent the opposite scenario where all compile threads are starved
-	if(threadIndex != 0)
-		SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_BELOW_NORMAL);
-#endif
-	while (!s_compileThreadsShutdownSignal)
-	{
-		PipelineCompiler* request = s_pipelineCompileRequests.pop();
-		if (!request)
-			continue;
-		request->Compile(true, false, true);
-		delete request;
-	}
-}
+// pipelines are compiled on the background workers of the shared thread pool
+static std::unique_ptr<ThreadPool::TaskGroup> s_compileTaskGroup;
 
 void PipelineCompiler::CompileThreadPool_Start()
 {
-	cemu_assert_debug(s_compileThreads.empty());
-	s_compileThreadsShutdownSignal = false;
-	uint32 numCompileThreads;
-
-	uint32 cpuCoreCount = GetPhysicalCoreCount();
-	if (cpuCoreCount <= 2)
-		numCompileThreads = 1;
-	else
-		numCompileThreads = 2 + (cpuCoreCount - 3); // 2 plus one additionally for every extra core above 3
-
-	numCompileThreads = std::min(numCompileThreads, 8u); // cap at 8
-
-	for (uint32_t i = 0; i < numCompileThreads; i++)
-	{
-		s_compileThreads.emplace_back(compilePipeline_thread, i);
-	}
+	cemu_assert_debug(!s_compileTaskGroup);
+	s_compileTaskGroup = std::make_unique<ThreadPool::TaskGroup>();
 }
 
 void PipelineCompiler::CompileThreadPool_Stop()
 {
-	s_compileThreadsShutdownSignal = true;
-	{
-		// push one empty workload for each thread
-		// this way we can make sure that each waiting thread is woken up to see the shutdown signal
-		for (auto& thread : s_compileThreads)
-			s_pipelineCompileRequests.push(nullptr);
-	}
-	for (auto& thread : s_compileThreads)
-		thread.join();
-	while (!s_pipelineCompileRequests.empty())
-	{
-		PipelineCompiler* pipelineCompiler = s_pipelineCompileRequests.pop();
-		if (pipelineCompiler)
-			delete pipelineCompiler;
-	}
-	s_compileThreads.clear();
+	// requests which did not start compiling yet are dropped and deleted along with their task
+	s_compileTaskGroup->Cancel();
+	s_compileTaskGroup->Wait();
+	s_compileTaskGroup.reset();
 }
 
 void PipelineCompiler::CompileThreadPool_QueueCompilation(PipelineCompiler* v)
 {
-	s_pipelineCompileRequests.push(v);
+	ThreadPool::Submit(ThreadPool::Priority::Background, [request = std::unique_ptr<PipelineCompiler>(v)]() {
+		request->Compile(true, false, true);
+	}, s_compileTaskGroup.get());
 }
\ No newline at end of file
@@ -41,21 +41,9 @@ uint32 VulkanPipelineStableCache::BeginLoading(uint64 cacheTitleId)
 	g_vkCacheState.pipelinesLoaded = 0;
 	g_vkCacheState.pipelinesQueued = 0;
 	
-	// start async compilation threads
+	// pipelines are compiled asynchronously on the background workers of the shared thread pool
 	m_compilationCount.store(0);	
-	m_compilationQueue.clear();
-
-	// get core count
-	uint32 cpuCoreCount = GetPhysicalCoreCount();
-	m_numCompilationThreads = std::clamp(cpuCoreCount, 1u, 8u);
-	if (VulkanRenderer::GetInstance()->GetDisableMultithreadedCompilation())
-		m_numCompilationThreads = 1;
-
-	for (uint32 i = 0; i < m_numCompilationThreads; i++)
-	{
-		std::thread compileThread(&VulkanPipelineStableCache::CompilerThread, this);
-		compileThread.detach();
-	}
+	m_compileSerially = VulkanRenderer::GetInstance()->GetDisableMultithreadedCompilation();
 
 	// open cache file or create it
 	cemu_assert_debug(s_cache == nullptr);
@@ -79,7 +67,7 @@ bool VulkanPipelineStableCache::UpdateLoading(uint32& pipelinesLoadedTotal, uint
 	pipelinesMissingShaders = 0;
 	while (g_vkCacheState.pipelineLoadIndex <= g_vkCacheState.pipelineMaxFileIndex)
 	{
-		if (m_compilationQueue.size() >= 50)
+		if (g_vkCacheState.pipelinesQueued - g_vkCacheState.pipelinesLoaded >= 50)
 		{
 			std::this_thread::sleep_for(std::chrono::milliseconds(10));
 			return true; // queue up to 50 entries at a time
@@ -91,7 +79,14 @@ bool VulkanPipelineStableCache::UpdateLoading(uint32& pipelinesLoadedTotal, uint
 		{
 			// queue for async compilation
 			g_vkCacheState.pipelinesQueued++;
-			m_compilationQueue.push(std::move(fileData));
+			auto compileTask = [this, pipelineData = std::move(fileData)]() mutable {
+				LoadPipelineFromCache(pipelineData);
+				++g_vkCacheState.pipelinesLoaded;
+			};
+			if (m_compileSerially)
+				m_serialCompilationQueue.Submit(std::move(compileTask));
+			else
+				ThreadPool::Submit(ThreadPool::Priority::Background, std::move(compileTask), &m_compilationTaskGroup);
 			g_vkCacheState.pipelineLoadIndex++;
 			return true;
 		}
@@ -107,13 +102,9 @@ bool VulkanPipelineStableCache::UpdateLoading(uint32& pipelinesLoadedTotal, uint
 
 void VulkanPipelineStableCache::EndLoading()
 {
-	// shut down compilation threads
-	uint32 threadCount = m_numCompilationThreads;
-	m_numCompilationThreads = 0; // signal thread shutdown
-	for (uint32 i = 0; i < threadCount; i++)
-	{
-		m_compilationQueue.push({}); // push empty workload for every thread. Threads then will shutdown after checking for m_numCompilationThreads == 0
-	}
+	// wait for pipelines which are still compiling, in case loading was aborted early
+	m_compilationTaskGroup.Wait();
+	m_serialCompilationQueue.Wait();
 	// keep cache file open for writing of new pipelines
 }
 
@@ -406,20 +397,6 @@ bool VulkanPipelineStableCache::DeserializePipeline(MemStreamReader& memReader,
 	return true;
 }
 
-int VulkanPipelineStableCache::CompilerThread()
-{
-	SetThreadName("plCacheCompiler");
-	while (m_numCompilationThreads != 0)
-	{
-		std::vector<uint8> pipelineData = m_compilationQueue.pop();
-		if(pipelineData.empty())
-			continue;
-		LoadPipelineFromCache(pipelineData);
-		++g_vkCacheState.pipelinesLoaded;
-	}
-	return 0;
-}
-
 void VulkanPipelineStableCache::WorkerThread()
 {
 	SetThreadName("plCacheWriter");
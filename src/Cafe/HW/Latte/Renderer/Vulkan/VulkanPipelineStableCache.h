@@ -1,5 +1,6 @@
 #pragma once
 #include "util/helpers/fspinlock.h"
+#include "util/ThreadPool/ThreadPool.h"
 
 struct VulkanPipelineHash
 {
@@ -51,7 +52,6 @@ public:
 	bool DeserializePipeline(class MemStreamReader& memReader, struct CachedPipeline& cachedPipeline);
 
 private:
-	int CompilerThread();
 	void WorkerThread();
 
 	std::thread* m_pipelineCacheStoreThread;
@@ -60,7 +60,8 @@ private:
 	FSpinlock m_pipelineIsCachedLock;
 	class FileCache* s_cache;
 
-	std::atomic_uint32_t m_numCompilationThreads{ 0 };
-	ConcurrentQueue<std::vector<uint8>> m_compilationQueue;
+	bool m_compileSerially{}; // set if multithreaded compilation is disabled
+	ThreadPool::TaskGroup m_compilationTaskGroup;
+	ThreadPool::SerialQueue m_serialCompilationQueue{ ThreadPool::Priority::Background };
 	std::atomic_uint32_t m_compilationCount;
 };
\ No newline at end of file
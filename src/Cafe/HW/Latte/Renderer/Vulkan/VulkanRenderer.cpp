@@ -1313,6 +1313,11 @@ RendererShader* VulkanRenderer::shader_create(RendererShader::ShaderType type, u
 	return new RendererShaderVk(type, baseHash, auxHash, isGameShader, isGfxPackShader, source);
 }
 
+RendererShader* VulkanRenderer::shader_create(RendererShader::ShaderType type, uint64 baseHash, uint64 auxHash, const std::string& source, std::vector<uint32> spirvCode)
+{
+	return new RendererShaderVk(type, baseHash, auxHash, true, false, source, std::move(spirvCode));
+}
+
 VulkanRenderer::QueueFamilyIndices VulkanRenderer::FindQueueFamilies(VkSurfaceKHR surface, VkPhysicalDevice device)
 {
 	uint32_t queueFamilyCount = 0;
@@ -3555,6 +3560,7 @@ VkDescriptorSetInfo::~VkDescriptorSetInfo()
 	performanceMonitor.vk.numDescriptorStorageBuffers.decrement(statsNumStorageBuffers);
 
 	auto renderer = VulkanRenderer::GetInstance();
+	renderer->unregisterDescriptorSet(this);
 	renderer->ReleaseDestructibleObject(m_vkObjDescriptorSet);
 	m_vkObjDescriptorSet = nullptr;
 }
@@ -3734,7 +3740,10 @@ LatteTexture* VulkanRenderer::texture_createTextureEx(Latte::E_DIM dim, MPTR phy
 
 void VulkanRenderer::texture_setLatteTexture(LatteTextureView* textureView, uint32 textureUnit)
 {
+	if (m_state.boundTexture[textureUnit] == textureView)
+		return;
 	m_state.boundTexture[textureUnit] = static_cast<LatteTextureViewVk*>(textureView);
+	m_state.boundTexturesChanged = true;
 }
 
 void VulkanRenderer::texture_copyImageSubData(LatteTexture* src, sint32 srcMip, sint32 effectiveSrcX, sint32 effectiveSrcY, sint32 srcSlice, LatteTexture* dst, sint32 dstMip, sint32 effectiveDstX, sint32 effectiveDstY, sint32 dstSlice, sint32 effectiveCopyWidth, sint32 effectiveCopyHeight, sint32 srcDepth)
@@ -3843,11 +3852,39 @@ LatteTextureReadbackInfo* VulkanRenderer::texture_createReadback(LatteTextureVie
 	const uint32 uploadBufferOffset = m_textureReadbackBufferWriteIndex;
 	m_textureReadbackBufferWriteIndex += uploadSize;
 
+	// the region may still hold data of older readbacks which hasn't been written to RAM yet
+	// regions are released in allocation order, so retire the oldest readbacks until there is no more overlap
+	auto isRegionInUse = [&]() {
+		for (auto& region : m_textureReadbackBufferRegions)
+		{
+			if (region.first < (uploadBufferOffset + uploadSize) && (region.first + region.second) > uploadBufferOffset)
+				return true;
+		}
+		return false;
+	};
+	while (isRegionInUse())
+	{
+		if (!LatteTextureReadback_RetireOldest())
+		{
+			cemu_assert_suspicious(); // region is owned by a readback that is no longer tracked
+			m_textureReadbackBufferRegions.clear();
+		}
+	}
+	m_textureReadbackBufferRegions.emplace_back(uploadBufferOffset, uploadSize);
+
 	result->SetBuffer(m_textureReadbackBuffer, m_textureReadbackBufferPtr, uploadBufferOffset);
 
 	return result;
 }
 
+void VulkanRenderer::texture_releaseReadbackRegion(uint32 bufferOffset)
+{
+	auto it = std::find_if(m_textureReadbackBufferRegions.begin(), m_textureReadbackBufferRegions.end(), [bufferOffset](const auto& region) { return region.first == bufferOffset; });
+	cemu_assert_debug(it == m_textureReadbackBufferRegions.begin()); // readbacks are retired in order
+	if (it != m_textureReadbackBufferRegions.end())
+		m_textureReadbackBufferRegions.erase(it);
+}
+
 uint32 s_vkCurrentUniqueId = 0;
 
 uint64 VulkanRenderer::GenUniqueId()
@@ -4083,6 +4120,8 @@ void VulkanRenderer::AppendOverlayDebugInfo()
 
 	ImGui::Text("BeginRP/f      %u", performanceMonitor.vk.numBeginRenderpassPerFrame.get());
 	ImGui::Text("Barriers/f     %u", performanceMonitor.vk.numDrawBarriersPerFrame.get());
+	ImGui::Text("PipeReuse/f    %u/%u", performanceMonitor.vk.numPipelineFastLookupsPerFrame.get(), performanceMonitor.vk.numPipelineLookupsPerFrame.get());
+	ImGui::Text("DSReuse/f      %u/%u", performanceMonitor.vk.numDescriptorSetFastLookupsPerFrame.get(), performanceMonitor.vk.numDescriptorSetLookupsPerFrame.get());
 	ImGui::Text("--- Cache debug info ---");
 
 	uint32 bufferCacheHeapSize = 0;
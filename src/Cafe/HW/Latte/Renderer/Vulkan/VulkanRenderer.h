@@ -307,6 +307,7 @@ public:
 
 	void texture_copyImageSubData(LatteTexture* src, sint32 srcMip, sint32 effectiveSrcX, sint32 effectiveSrcY, sint32 srcSlice, LatteTexture* dst, sint32 dstMip, sint32 effectiveDstX, sint32 effectiveDstY, sint32 dstSlice, sint32 effectiveCopyWidth, sint32 effectiveCopyHeight, sint32 srcDepth) override;
 	LatteTextureReadbackInfo* texture_createReadback(LatteTextureView* textureView) override;
+	void texture_releaseReadbackRegion(uint32 bufferOffset);
 
 	// surface copy
 	void surfaceCopy_copySurfaceWithFormatConversion(LatteTexture* sourceTexture, sint32 srcMip, sint32 srcSlice, LatteTexture* destinationTexture, sint32 dstMip, sint32 dstSlice, sint32 width, sint32 height) override;
@@ -341,6 +342,8 @@ public:
 	void buffer_bindUniformBuffer(LatteConst::ShaderType shaderType, uint32 bufferIndex, uint32 offset, uint32 size) override;
 
 	RendererShader* shader_create(RendererShader::ShaderType type, uint64 baseHash, uint64 auxHash, const std::string& source, bool isGameShader, bool isGfxPackShader) override;
+	// game shader with a SPIR-V module generated from the IR. source is compiled instead if the module is rejected
+	RendererShader* shader_create(RendererShader::ShaderType type, uint64 baseHash, uint64 auxHash, const std::string& source, std::vector<uint32> spirvCode);
 
 	IndexAllocation indexData_reserveIndexMemory(uint32 size) override;
 	void indexData_releaseIndexMemory(IndexAllocation& allocation) override;
@@ -349,6 +352,7 @@ public:
 	// externally callable
 	void GetTextureFormatInfoVK(Latte::E_GX2SURFFMT format, bool isDepth, Latte::E_DIM dim, sint32 width, sint32 height, FormatInfoVK* formatInfoOut);
 	void unregisterGraphicsPipeline(PipelineInfo* pipelineInfo);
+	void unregisterDescriptorSet(VkDescriptorSetInfo* descriptorSetInfo);
 
 private:
 	struct VkRendererState
@@ -380,6 +384,26 @@ private:
 		bool descriptorSetsChanged{ false };
 		bool hasRenderSelfDependency{ false }; // set if current drawcall samples textures which are also output as a rendertarget
 
+		// result of the previous pipeline and descriptor set lookups
+		// reused without recalculating the state hash as long as none of the registers in the hashed LATTE_DIRTY_* groups changed
+		struct
+		{
+			PipelineInfo* pipelineInfo{};
+			const LatteFetchShader* fetchShader{};
+			uint64 fetchShaderKey{};
+			const LatteDecompilerShader* vertexShader{};
+			const LatteDecompilerShader* geometryShader{};
+			const LatteDecompilerShader* pixelShader{};
+			uint64 renderPassHash{};
+		}lastPipelineLookup;
+		struct
+		{
+			PipelineInfo* pipelineInfo{};
+			const LatteDecompilerShader* shader{};
+			VkDescriptorSetInfo* descriptorSet{};
+		}lastDescriptorSetLookup[VulkanRendererConst::SHADER_STAGE_INDEX_COUNT];
+		bool boundTexturesChanged{ true }; // set when texture_setLatteTexture() binds a different view
+
 		// viewport and scissor box
 		VkViewport currentViewport{};
 		VkRect2D currentScissorRect{};
@@ -530,6 +554,7 @@ private:
 	// shader
 
 	bool IsAsyncPipelineAllowed(uint32 numIndices);
+	bool IsAsyncShaderDecompileAllowed();
 
 	uint64 GetDescriptorSetStateHash(LatteDecompilerShader* shader);
 
@@ -546,6 +571,7 @@ private:
 	// drawcall emulation
 	PipelineInfo* draw_createGraphicsPipeline(uint32 indexCount);
 	PipelineInfo* draw_getOrCreateGraphicsPipeline(uint32 indexCount);
+	void draw_handleDirtyRegisterGroups();
 
 	void draw_updateVkBlendConstants();
 	void draw_updateDepthBias(bool forceUpdate);
@@ -639,6 +665,7 @@ private:
 	VkDeviceMemory m_textureReadbackBufferMemory = VK_NULL_HANDLE;
 	uint8* m_textureReadbackBufferPtr = nullptr;
 	uint32 m_textureReadbackBufferWriteIndex = 0;
+	std::deque<std::pair<uint32, uint32>> m_textureReadbackBufferRegions; // offset and size of the regions still used by readbacks, in allocation order
 
 	// placeholder objects to simulate NULL buffers and textures
 	struct NullTexture
@@ -164,6 +164,8 @@ PipelineInfo* VulkanRenderer::draw_getCachedPipeline()
 
 void VulkanRenderer::unregisterGraphicsPipeline(PipelineInfo* pipelineInfo)
 {
+	if (m_state.lastPipelineLookup.pipelineInfo == pipelineInfo)
+		m_state.lastPipelineLookup.pipelineInfo = nullptr;
 	bool removedFromCache = false;
 	for (auto& topMapItr : m_pipeline_info_cache)
 	{
@@ -183,6 +185,30 @@ void VulkanRenderer::unregisterGraphicsPipeline(PipelineInfo* pipelineInfo)
 	}
 }
 
+void VulkanRenderer::unregisterDescriptorSet(VkDescriptorSetInfo* descriptorSetInfo)
+{
+	for (auto& lastLookup : m_state.lastDescriptorSetLookup)
+	{
+		if (lastLookup.descriptorSet == descriptorSetInfo)
+			lastLookup.descriptorSet = nullptr;
+	}
+}
+
+// invalidate the previous lookup results if any state they were derived from changed since
+void VulkanRenderer::draw_handleDirtyRegisterGroups()
+{
+	const uint32 dirtyGroups = LatteGPUState.dirtyRegisterGroups;
+	LatteGPUState.dirtyRegisterGroups = 0;
+	if (dirtyGroups & (LATTE_DIRTY_PIPELINE_STATE | LATTE_DIRTY_VERTEX_STRIDE))
+		m_state.lastPipelineLookup.pipelineInfo = nullptr;
+	if ((dirtyGroups & (LATTE_DIRTY_TEXTURE_SWIZZLE | LATTE_DIRTY_SAMPLER)) || m_state.boundTexturesChanged)
+	{
+		for (auto& lastLookup : m_state.lastDescriptorSetLookup)
+			lastLookup.descriptorSet = nullptr;
+		m_state.boundTexturesChanged = false;
+	}
+}
+
 // make a guess if a pipeline is not essential
 // non-essential means that skipping these drawcalls shouldn't lead to permanently corrupted graphics
 bool VulkanRenderer::IsAsyncPipelineAllowed(uint32 numIndices)
@@ -210,6 +236,17 @@ bool VulkanRenderer::IsAsyncPipelineAllowed(uint32 numIndices)
 	return true;
 }
 
+// same idea as IsAsyncPipelineAllowed() but evaluated before the render targets are set up
+// only drawcalls which render with a depth buffer are skipped while their shaders are decompiled, everything else waits for the decompiler
+bool VulkanRenderer::IsAsyncShaderDecompileAllowed()
+{
+	if (!GetConfig().async_compile)
+		return false;
+	if (IsTracingToolEnabled())
+		return false;
+	return LatteMRT::GetActiveDepthBufferMask(LatteGPUState.contextNew);
+}
+
 // create graphics pipeline for current state
 PipelineInfo* VulkanRenderer::draw_createGraphicsPipeline(uint32 indexCount)
 {
@@ -269,6 +306,28 @@ PipelineInfo* VulkanRenderer::draw_createGraphicsPipeline(uint32 indexCount)
 
 PipelineInfo* VulkanRenderer::draw_getOrCreateGraphicsPipeline(uint32 indexCount)
 {
+	draw_handleDirtyRegisterGroups();
+	performanceMonitor.vk.numPipelineLookupsPerFrame.increment();
+
+	const auto fetchShader = LatteSHRC_GetActiveFetchShader();
+	const auto vertexShader = LatteSHRC_GetActiveVertexShader();
+	const auto geometryShader = LatteSHRC_GetActiveGeometryShader();
+	const auto pixelShader = LatteSHRC_GetActivePixelShader();
+	const uint64 renderPassHash = ((CachedFBOVk*)m_state.activeFBO)->GetRenderPassObj()->m_hashForPipeline;
+
+	// all other inputs of the pipeline hash are registers. If none of them changed we can skip hashing and the cache lookup
+	auto& lastLookup = m_state.lastPipelineLookup;
+	if (lastLookup.pipelineInfo && lastLookup.fetchShader == fetchShader && lastLookup.fetchShaderKey == fetchShader->key &&
+		lastLookup.vertexShader == vertexShader && lastLookup.geometryShader == geometryShader && lastLookup.pixelShader == pixelShader &&
+		lastLookup.renderPassHash == renderPassHash)
+	{
+#ifdef CEMU_DEBUG_ASSERT
+		cemu_assert_debug(draw_getCachedPipeline() == lastLookup.pipelineInfo);
+#endif
+		performanceMonitor.vk.numPipelineFastLookupsPerFrame.increment();
+		return lastLookup.pipelineInfo;
+	}
+
 	auto cache_object = draw_getCachedPipeline();
 	if (cache_object != nullptr)
 	{
@@ -288,11 +347,21 @@ PipelineInfo* VulkanRenderer::draw_getOrCreateGraphicsPipeline(uint32 indexCount
 		cemu_assert_debug(cache_object->primitiveMode == currentPrimitiveMode);
 		cemu_assert_debug(cache_object->minimalStateHash == calcMinimalHash);
 #endif
-		return cache_object;
 	}
-	//draw_debugPipelineHashState();
+	else
+	{
+		//draw_debugPipelineHashState();
+		cache_object = draw_createGraphicsPipeline(indexCount);
+	}
 
-	return draw_createGraphicsPipeline(indexCount);
+	lastLookup.pipelineInfo = cache_object;
+	lastLookup.fetchShader = fetchShader;
+	lastLookup.fetchShaderKey = fetchShader->key;
+	lastLookup.vertexShader = vertexShader;
+	lastLookup.geometryShader = geometryShader;
+	lastLookup.pixelShader = pixelShader;
+	lastLookup.renderPassHash = renderPassHash;
+	return cache_object;
 }
 
 Renderer::IndexAllocation VulkanRenderer::indexData_reserveIndexMemory(uint32 size)
@@ -1105,17 +1174,37 @@ void VulkanRenderer::draw_prepareDescriptorSets(PipelineInfo* pipeline_info, VkD
 	const auto geometryShader = LatteSHRC_GetActiveGeometryShader();
 	const auto pixelShader = LatteSHRC_GetActivePixelShader();
 
-	auto prepareShaderDescriptors = [this, &pipeline_info](LatteDecompilerShader* shader) -> VkDescriptorSetInfo* {
+	draw_handleDirtyRegisterGroups();
+
+	auto prepareShaderDescriptors = [this, &pipeline_info](LatteDecompilerShader* shader, uint32 shaderStageIndex) -> VkDescriptorSetInfo* {
 		if (!shader)
 			return nullptr;
-		auto descriptorSetInfo = draw_getOrCreateDescriptorSet(pipeline_info, shader);
+		performanceMonitor.vk.numDescriptorSetLookupsPerFrame.increment();
+		auto& lastLookup = m_state.lastDescriptorSetLookup[shaderStageIndex];
+		VkDescriptorSetInfo* descriptorSetInfo;
+		if (lastLookup.descriptorSet && lastLookup.pipelineInfo == pipeline_info && lastLookup.shader == shader)
+		{
+			// no texture binding, texture swizzle or sampler register changed since the descriptor set was looked up
+			descriptorSetInfo = lastLookup.descriptorSet;
+#ifdef CEMU_DEBUG_ASSERT
+			cemu_assert_debug(descriptorSetInfo->stateHash == GetDescriptorSetStateHash(shader));
+#endif
+			performanceMonitor.vk.numDescriptorSetFastLookupsPerFrame.increment();
+		}
+		else
+		{
+			descriptorSetInfo = draw_getOrCreateDescriptorSet(pipeline_info, shader);
+			lastLookup.pipelineInfo = pipeline_info;
+			lastLookup.shader = shader;
+			lastLookup.descriptorSet = descriptorSetInfo;
+		}
 		descriptorSetInfo->m_vkObjDescriptorSet->flagForCurrentCommandBuffer();
 		return descriptorSetInfo;
 	};
 
-	vertexDS = prepareShaderDescriptors(vertexShader);
-	pixelDS = prepareShaderDescriptors(pixelShader);
-	geometryDS = prepareShaderDescriptors(geometryShader);
+	vertexDS = prepareShaderDescriptors(vertexShader, VulkanRendererConst::SHADER_STAGE_INDEX_VERTEX);
+	pixelDS = prepareShaderDescriptors(pixelShader, VulkanRendererConst::SHADER_STAGE_INDEX_FRAGMENT);
+	geometryDS = prepareShaderDescriptors(geometryShader, VulkanRendererConst::SHADER_STAGE_INDEX_GEOMETRY);
 }
 
 void VulkanRenderer::draw_updateVkBlendConstants()
@@ -1248,7 +1337,7 @@ void VulkanRenderer::draw_beginSequence()
 	bool streamoutEnable = LatteGPUState.contextRegister[mmVGT_STRMOUT_EN] != 0;
 
 	// update shader state
-	LatteSHRC_UpdateActiveShaders();
+	LatteSHRC_UpdateActiveShaders(IsAsyncShaderDecompileAllowed());
 	if (LatteGPUState.activeShaderHasError)
 	{
 		cemuLog_logDebugOnce(LogType::Force, "Skipping drawcalls due to shader error");
@@ -1256,6 +1345,12 @@ void VulkanRenderer::draw_beginSequence()
 		cemu_assert_debug(false);
 		return;
 	}
+	if (LatteGPUState.activeShaderIsPending)
+	{
+		// shaders are still being decompiled in the background
+		m_state.drawSequenceSkip = true;
+		return;
+	}
 
 	// update render target and texture state
 	LatteGPUState.requiresTextureBarrier = false;
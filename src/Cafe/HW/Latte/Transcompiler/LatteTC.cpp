@@ -39,52 +39,26 @@ private:
 void LatteTCGenIR::genIRForNode(CFBlockNode& node)
 {
 	m_irGenContext.reset();
+	delete m_irGenContext.irBuilder;
 	m_irGenContext.irBuilder = new ZpIR::BasicBlockBuilder(node.irBasicBlock);
 	m_irGenContext.isEntryBasicBlock = (&node == m_ctx.mainFunctionDAG.GetEntryNode());
 
-	// for vertex shaders add initialization code to main()
-	if (&node == m_ctx.mainFunctionDAG.GetEntryNode() && m_ctx.shaderType == SHADER_TYPE::VERTEX)
-	{
-		for (uint32 channel = 0; channel < 4; channel++)
-		{
-			ZpIR::IRReg irReg = m_irGenContext.irBuilder->createReg(ZpIR::DataType::U32);
-			m_irGenContext.irBuilder->emit_RR(ZpIR::IR::OpCode::MOV, irReg, m_irGenContext.irBuilder->createConstU32(0));
-			this->m_irGenContext.activeVars.set(0, channel, irReg);
-		}
-		// todo - correctly init R0 based on currently set context register state
-	}
-
+	// for vertex shaders R0 holds the vertex and instance id on entry
+	// todo - correctly init R0 based on currently set context register state. Until then reading it before it is written is reported as unsupported by getIRRegFromGPRElement()
 
 	for (auto& itr : node.m_cfInstructions)
 	{
 		const auto opcode = itr.getField_Opcode();
-		if (const auto cfInstr = itr.getParserIfOpcodeMatch<LatteCFInstruction_DEFAULT>())
-		{
-			if(opcode == LatteCFInstruction::OPCODE::INST_CALL_FS)
-				processCF_CALL_FS(*cfInstr);
-			else
-				assert_dbg();
-		}
-		else if (const auto cfInstr = itr.getParserIfOpcodeMatch<LatteCFInstruction_ALU>())
-		{
-			if (opcode == LatteCFInstruction::OPCODE::INST_ALU)
-				processCF_ALU(*cfInstr);
-			else
-				assert_dbg();
-		}
-		else if (const auto cfInstr = itr.getParserIfOpcodeMatch<LatteCFInstruction_EXPORT_IMPORT>())
-		{
-			if (opcode == LatteCFInstruction::OPCODE::INST_EXPORT || 
-				opcode == LatteCFInstruction::OPCODE::INST_EXPORT_DONE)
-				processCF_EXPORT(*cfInstr);
-			else
-				assert_dbg();
-		}
+		if (const auto cfInstr = itr.getParserIfOpcodeMatch<LatteCFInstruction_DEFAULT>(); cfInstr && opcode == LatteCFInstruction::OPCODE::INST_CALL_FS)
+			processCF_CALL_FS(*cfInstr);
+		else if (const auto cfInstr = itr.getParserIfOpcodeMatch<LatteCFInstruction_ALU>(); cfInstr && opcode == LatteCFInstruction::OPCODE::INST_ALU)
+			processCF_ALU(*cfInstr);
+		else if (const auto cfInstr = itr.getParserIfOpcodeMatch<LatteCFInstruction_EXPORT_IMPORT>(); cfInstr && (opcode == LatteCFInstruction::OPCODE::INST_EXPORT || opcode == LatteCFInstruction::OPCODE::INST_EXPORT_DONE))
+			processCF_EXPORT(*cfInstr);
 		else
-		{
-			debug_printf("Missing implementation for CF opcode 0x%02x\n", itr.getField_Opcode());
-			assert_dbg(); // todo
-		}
+			setUnsupported(fmt::format("CF instruction 0x{:02x}", (uint32)opcode));
+		if (hasError())
+			return;
 	}
 }
 
@@ -105,7 +79,11 @@ void LatteTCGenIR::parseCF_createNodes(NodeDAG& nodeDAG)
 	// 2.2) Otherwise finalize active node, add it to node list. Then create new CFBlockNode node from CF instruction and make it active node
 	// 3) Finalize active node and add to node list
 
-	cemu_assert_debug(cfMaxCount != 0); // zero not allowed
+	if (cfMaxCount == 0)
+	{
+		setUnsupported("empty program");
+		return;
+	}
 
 	CFBlockNode* activeNode = new CFBlockNode(0, cfCode[0]); // first instruction becomes the initial node
 	size_t cfIndex = 1;
@@ -114,19 +92,14 @@ void LatteTCGenIR::parseCF_createNodes(NodeDAG& nodeDAG)
 	{
 		const LatteCFInstruction* baseInstr = cfCode + cfIndex;
 		cfIndex++;
-		bool canMerge;
+		bool canMerge = false;
 		bool isALU = false;
 		if (const auto cfInstr = baseInstr->getParserIfOpcodeMatch<LatteCFInstruction_DEFAULT>())
 		{
-			cemu_assert_debug(cfInstr->getField_WHOLE_QUAD_MODE() == 0);
-
-			cemu_assert_debug(cfInstr->getField_CALL_COUNT() == 0); // todo
-			cemu_assert_debug(cfInstr->getField_POP_COUNT() == 0); // todo
-
-			auto cond = cfInstr->getField_COND();
-
-			assert_dbg();
-			//cfInstr->getField_COND() == LatteCFInstruction::CF_COND::CF_COND_ACTIVE;
+			// branches, loops and subroutines are not supported yet
+			// todo - once multiple basic blocks are supported use getField_COND(), getField_CALL_COUNT() and getField_POP_COUNT() to split the nodes
+			setUnsupported(fmt::format("CF instruction 0x{:02x}", (uint32)baseInstr->getField_Opcode()));
+			break;
 		}
 		else if (const auto cfInstr = baseInstr->getParserIfOpcodeMatch<LatteCFInstruction_ALU>())
 		{
@@ -142,8 +115,8 @@ void LatteTCGenIR::parseCF_createNodes(NodeDAG& nodeDAG)
 		}
 		else
 		{
-			debug_printf("Missing implementation for CF opcode 0x%02x\n", baseInstr->getField_Opcode());
-			assert_dbg(); // todo
+			setUnsupported(fmt::format("CF instruction 0x{:02x}", (uint32)baseInstr->getField_Opcode()));
+			break;
 		}
 
 		if (canMerge)
@@ -170,12 +143,15 @@ void LatteTCGenIR::parseCFToDAG()
 {
 	// parse CF and create preliminary node DAG
 	parseCF_createNodes(m_ctx.mainFunctionDAG);
-	// link up the nodes
-	cemu_assert_debug(m_ctx.mainFunctionDAG.m_nodes.size() == 1);
-	// assign to ir object
+	if (m_ctx.mainFunctionDAG.m_nodes.empty())
+		return;
+	// assign to ir object, which takes ownership of the basic blocks
 	for (auto& itr : m_ctx.mainFunctionDAG.m_nodes)
 		m_ctx.irObject->m_basicBlocks.emplace_back(itr->irBasicBlock);
 	m_ctx.irObject->m_entryBlocks.emplace_back(m_ctx.mainFunctionDAG.m_nodes[0]->irBasicBlock);
+	// link up the nodes
+	if (m_ctx.mainFunctionDAG.m_nodes.size() != 1)
+		setUnsupported("multiple basic blocks"); // todo
 }
 
 void LatteTCGenIR::emitIR()
@@ -185,16 +161,26 @@ void LatteTCGenIR::emitIR()
 	for (auto& itr : m_ctx.mainFunctionDAG.m_nodes)
 	{
 		genIRForNode(*itr);
+		if (hasError())
+			return;
 	}
 
 }
 
 void LatteTCGenIR::cleanup()
 {
-	// clean up
-	//for (auto itr : m_ctx.list_irNodesCtx)
-	//	delete itr;
-	//m_ctx.list_irNodesCtx.clear();
+	for (auto& itr : m_ctx.mainFunctionDAG.m_nodes)
+		delete itr;
+	m_ctx.mainFunctionDAG.m_nodes.clear();
+	delete m_irGenContext.irBuilder;
+	m_irGenContext.irBuilder = nullptr;
+}
+
+void LatteTCGenIR::setUnsupported(std::string_view reason)
+{
+	// only the first error is kept, everything after it is likely a consequence
+	if (m_errorMessage.empty())
+		m_errorMessage.assign(reason);
 }
 
 void LatteTCGenIR::setVertexShaderContext(const LatteFetchShader* parsedFetchShader, const uint32* vtxSemanticTable)
@@ -206,11 +192,11 @@ void LatteTCGenIR::setVertexShaderContext(const LatteFetchShader* parsedFetchSha
 
 ZpIR::ZpIRFunction* LatteTCGenIR::transcompileLatteToIR(const void* programData, uint32 programSize, SHADER_TYPE shaderType)
 {
-	//return nullptr;
 	ZpIR::ZpIRFunction* irObject = new ZpIR::ZpIRFunction();
 
 	// init context
 	m_ctx = {};
+	m_errorMessage.clear();
 	m_ctx.programData = (const uint32*)programData;
 	m_ctx.programSize = programSize;
 	m_ctx.irObject = irObject;
@@ -220,8 +206,14 @@ ZpIR::ZpIRFunction* LatteTCGenIR::transcompileLatteToIR(const void* programData,
 	// each node is a single IR basic block, consisting of one or multiple CF instructions
 	parseCFToDAG();
 	// process clauses and emit IR nodes
-	emitIR();
+	if (!hasError())
+		emitIR();
 	// cleanup
 	cleanup();
+	if (hasError())
+	{
+		delete irObject;
+		return nullptr;
+	}
 	return irObject;
 }
\ No newline at end of file
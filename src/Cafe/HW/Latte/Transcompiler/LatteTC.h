@@ -40,9 +40,15 @@ public:
 
 	void setVertexShaderContext(const LatteFetchShader* parsedFetchShader, const uint32* vtxSemanticTable);
 
+	// returns nullptr if the shader uses anything the IR generator does not support yet. getErrorMessage() describes the first unsupported feature
 	ZpIR::ZpIRFunction* transcompileLatteToIR(const void* programData, uint32 programSize, SHADER_TYPE shaderType);
 
+	const std::string& getErrorMessage() const { return m_errorMessage; }
+
 private:
+	void setUnsupported(std::string_view reason);
+	bool hasError() const { return !m_errorMessage.empty(); }
+
 	ZpIR::IRReg getIRRegFromGPRElement(uint32 gprIndex, uint32 channel, ZpIR::DataType typeHint);
 	ZpIR::IRReg getTypedIRRegFromGPRElement(uint32 gprIndex, uint32 channel, ZpIR::DataType type);
 
@@ -166,7 +172,7 @@ private:
 	struct
 	{
 		IREmitterActiveVars activeVars;
-		ZpIR::BasicBlockBuilder* irBuilder;
+		ZpIR::BasicBlockBuilder* irBuilder{};
 		bool isEntryBasicBlock{};
 
 		void reset()
@@ -197,4 +203,9 @@ private:
 		const LatteFetchShader* parsedFetchShader{};
 		const uint32* vtxSemanticTable{};
 	}m_vertexShaderCtx{};
+
+	std::string m_errorMessage;
 };
+
+// offline tool: emit SPIR-V for all vertex shaders in a raw shader dump folder and check the modules against glslang (see LatteTCSPIRVCheck.cpp)
+bool LatteTC_RunSPIRVCheck(const fs::path& dumpPath);
@@ -53,9 +53,13 @@ void LatteTCGenIR::CF_CALL_FS_emitFetchAttribute(LatteParsedFetchShaderAttribute
 					cemu_assert_debug(false);
 				}
 
-				cemu_assert_debug(attribute.endianSwap == LatteConst::VertexFetchEndianMode::SWAP_U32);
 				cemu_assert_debug(nfa == LatteClauseInstruction_VTX::NUM_FORMAT_ALL::NUM_FORMAT_SCALED);
 				cemu_assert_debug(channelIndex < numComp);
+				if (attribute.endianSwap != LatteConst::VertexFetchEndianMode::SWAP_U32)
+				{
+					setUnsupported("float attribute without 32bit endian swap");
+					return;
+				}
 
 				ZpIR::IRReg elementResult;
 				irBuilder->emit_RR(ZpIR::IR::OpCode::BITCAST, irBuilder->createReg(elementResult, ZpIR::DataType::F32), resultHolder);
@@ -80,16 +84,21 @@ void LatteTCGenIR::CF_CALL_FS_emitFetchAttribute(LatteParsedFetchShaderAttribute
 					break;
 				}
 
-				cemu_assert_debug(attribute.endianSwap == LatteConst::VertexFetchEndianMode::SWAP_NONE);
 				cemu_assert_debug(channelIndex < numComp);
+				if (attribute.endianSwap != LatteConst::VertexFetchEndianMode::SWAP_NONE)
+				{
+					setUnsupported("8bit attribute with endian swap");
+					return;
+				}
 
 				if (nfa == LatteClauseInstruction_VTX::NUM_FORMAT_ALL::NUM_FORMAT_NORM)
 				{
 					// scaled
 					if (isSigned)
 					{
-						assert_dbg();
 						// we can fake sign extend by subtracting 128? Would be faster than the AND + Conditional OR
+						setUnsupported("signed normalized 8bit attribute");
+						return;
 					}
 					else
 					{
@@ -99,12 +108,14 @@ void LatteTCGenIR::CF_CALL_FS_emitFetchAttribute(LatteParsedFetchShaderAttribute
 				}
 				else
 				{
-					assert_dbg();
+					setUnsupported(::fmt::format("8bit attribute with number format {}", (uint32)nfa));
+					return;
 				}
 			}
 			else
 			{
-				assert_dbg();
+				setUnsupported(::fmt::format("attribute format 0x{:02x}", (uint32)fmt));
+				return;
 			}
 
 			// todo - we need a sign-extend instruction for this which should take arbitrary bit count
@@ -129,7 +140,8 @@ void LatteTCGenIR::CF_CALL_FS_emitFetchAttribute(LatteParsedFetchShaderAttribute
 			break;
 		}
 		default:
-			assert_dbg();
+			setUnsupported(fmt::format("attribute dst sel {}", (uint32)ds));
+			return;
 		}
 	}
 }
@@ -139,8 +151,18 @@ void LatteTCGenIR::processCF_CALL_FS(const LatteCFInstruction_DEFAULT& cfInstruc
 	auto fetchShader = m_vertexShaderCtx.parsedFetchShader;
 	auto semanticTable = m_vertexShaderCtx.vtxSemanticTable;
 
+	if (!fetchShader || !semanticTable)
+	{
+		setUnsupported("vertex shader without fetch shader context");
+		return;
+	}
+	if (!fetchShader->bufferGroupsInvalid.empty())
+	{
+		setUnsupported("fetch shader with invalid buffer groups"); // todo
+		return;
+	}
+
 	// generate IR to decode vertex attributes
-	cemu_assert_debug(fetchShader->bufferGroupsInvalid.size() == 0); // todo
 	for(auto& bufferGroup : fetchShader->bufferGroups)
 	{
 		for (sint32 i = 0; i < bufferGroup.attribCount; i++)
@@ -164,6 +186,8 @@ void LatteTCGenIR::processCF_CALL_FS(const LatteCFInstruction_DEFAULT& cfInstruc
 
 			// emit IR code for attribute import (decode into GPR)
 			CF_CALL_FS_emitFetchAttribute(attribute, dstGPR);
+			if (hasError())
+				return;
 		}
 	}
 }
@@ -181,6 +205,9 @@ ZpIR::IRReg LatteTCGenIR::getIRRegFromGPRElement(uint32 gprIndex, uint32 channel
 	// in the entry basic block we can assume a value of zero because there is nowhere to import from
 	if (m_irGenContext.isEntryBasicBlock)
 	{
+		// except for the vertex and instance id which the hardware stores in R0 of vertex shaders
+		if (gprIndex == 0 && m_ctx.shaderType == SHADER_TYPE::VERTEX)
+			setUnsupported("vertex shader reads R0");
 		if (typeHint == ZpIR::DataType::F32)
 			return m_irGenContext.irBuilder->createConstF32(0.0f);
 		else if (typeHint == ZpIR::DataType::U32)
@@ -227,7 +254,10 @@ ZpIR::IRReg LatteTCGenIR::loadALUOperand(LatteALUSrcSel srcSel, uint8 srcChan, b
 	{
 		//LatteTCGenIR::GPRElement gprElement = srcSel.getGPR() * 4 + srcChan;
 		if (isRel)
-			assert_dbg();
+		{
+			setUnsupported("relative GPR access");
+			return m_irGenContext.irBuilder->createTypedConst(0, typeHint);
+		}
 
 		ZpIR::IRReg reg;
 		
@@ -241,7 +271,7 @@ ZpIR::IRReg LatteTCGenIR::loadALUOperand(LatteALUSrcSel srcSel, uint8 srcChan, b
 		if (isAbs || isNeg)
 		{
 			// create new var and apply transformation
-			assert_dbg();
+			setUnsupported("ALU operand with abs or neg modifier");
 		}
 
 		return reg;
@@ -252,8 +282,8 @@ ZpIR::IRReg LatteTCGenIR::loadALUOperand(LatteALUSrcSel srcSel, uint8 srcChan, b
 		{
 			return m_irGenContext.irBuilder->createConstF32(0.0f); // todo - could also be integer type constant? Try to find a way to predict the type correctly
 		}
-		else
-			assert_dbg();
+		setUnsupported("ALU constant operand");
+		return m_irGenContext.irBuilder->createTypedConst(0, typeHint);
 	}
 	else if (srcSel.isLiteral())
 	{
@@ -270,10 +300,8 @@ ZpIR::IRReg LatteTCGenIR::loadALUOperand(LatteALUSrcSel srcSel, uint8 srcChan, b
 		m_irGenContext.irBuilder->emit_IMPORT(importSource, newReg);
 		return newReg;
 	}
-	else
-		assert_dbg();
-
-	return 0;
+	setUnsupported("ALU operand source");
+	return m_irGenContext.irBuilder->createTypedConst(0, typeHint);
 }
 
 void LatteTCGenIR::emitALUGroup(const LatteClauseInstruction_ALU* aluUnit[5], const uint32* literalData)
@@ -307,8 +335,7 @@ void LatteTCGenIR::emitALUGroup(const LatteClauseInstruction_ALU* aluUnit[5], co
 		{
 			return _guessTypeFromConstantValue(literalData[instrOP2->getSrc0Chan()]);
 		}
-		else
-			assert_dbg();
+		setUnsupported("MOV source");
 		return ZpIR::DataType::S32;
 	};
 
@@ -335,9 +362,8 @@ void LatteTCGenIR::emitALUGroup(const LatteClauseInstruction_ALU* aluUnit[5], co
 		// create output register
 		ZpIR::IRReg r = m_irGenContext.irBuilder->createReg(type);
 
-		cemu_assert_debug(instrOP2->getDestClamp() == 0); // todo
-		cemu_assert_debug(instrOP2->getDestRel() == 0); // todo
-		cemu_assert_debug(instrOP2->getOMod() == 0); // todo
+		if (instrOP2->getDestClamp() || instrOP2->getDestRel() || instrOP2->getOMod())
+			setUnsupported("ALU result with clamp, relative destination or output modifier"); // todo
 
 		if (instrOP2->getWriteMask())
 		{
@@ -347,7 +373,7 @@ void LatteTCGenIR::emitALUGroup(const LatteClauseInstruction_ALU* aluUnit[5], co
 		else
 		{
 			// output only to PV/PS
-			assert_dbg();
+			setUnsupported("ALU result only written to PV/PS");
 		}
 		// output to PV/PS
 		// todo
@@ -370,12 +396,15 @@ void LatteTCGenIR::emitALUGroup(const LatteClauseInstruction_ALU* aluUnit[5], co
 
 	for (sint32 aluUnitIndex = 0; aluUnitIndex < 5; aluUnitIndex++)
 	{
+		if (hasError())
+			return;
 		const LatteClauseInstruction_ALU* instr = aluUnit[aluUnitIndex];
 		if (instr == nullptr)
 			continue;
 		if (instr->isOP3())
 		{
-			assert_dbg();
+			setUnsupported("OP3 ALU instruction");
+			return;
 		}
 		else
 		{
@@ -407,19 +436,26 @@ void LatteTCGenIR::emitALUGroup(const LatteClauseInstruction_ALU* aluUnit[5], co
 			{
 				// reduction opcode
 				// must be mirrored to .xyzw units
-				cemu_assert_debug(aluUnitIndex == 0);
-				cemu_assert_debug(aluUnit[0]->getOP2Code() == aluUnit[1]->getOP2Code());
-				cemu_assert_debug(aluUnit[1]->getOP2Code() == aluUnit[2]->getOP2Code());
-				cemu_assert_debug(aluUnit[2]->getOP2Code() == aluUnit[3]->getOP2Code());
+				if (aluUnitIndex != 0 || !aluUnit[1] || !aluUnit[2] || !aluUnit[3] ||
+					aluUnit[1]->isOP3() || aluUnit[2]->isOP3() || aluUnit[3]->isOP3() ||
+					aluUnit[0]->getOP2Code() != aluUnit[1]->getOP2Code() ||
+					aluUnit[1]->getOP2Code() != aluUnit[2]->getOP2Code() ||
+					aluUnit[2]->getOP2Code() != aluUnit[3]->getOP2Code())
+				{
+					setUnsupported("DOT4 not mirrored to xyzw units");
+					return;
+				}
 
 				auto unit_x = instrOP2;
 				auto unit_y = aluUnit[1]->getOP2Instruction();
 				auto unit_z = aluUnit[2]->getOP2Instruction();
 				auto unit_w = aluUnit[3]->getOP2Instruction();
 
-				cemu_assert_debug(unit_x->getDestClamp() == false);
-				cemu_assert_debug(unit_x->getOMod() == 0);
-				cemu_assert_debug(unit_x->getDestRel() == false);
+				if (unit_x->getDestClamp() || unit_x->getOMod() || unit_x->getDestRel())
+				{
+					setUnsupported("DOT4 with clamp, output modifier or relative destination");
+					return;
+				}
 
 				ZpIR::IRReg productX = irBuilder->emit_RRR(ZpIR::IR::OpCode::MUL, ZpIR::DataType::F32, getOp0Reg(unit_x, ZpIR::DataType::F32), getOp1Reg(unit_x, ZpIR::DataType::F32));
 				ZpIR::IRReg productY = irBuilder->emit_RRR(ZpIR::IR::OpCode::MUL, ZpIR::DataType::F32, getOp0Reg(unit_y, ZpIR::DataType::F32), getOp1Reg(unit_y, ZpIR::DataType::F32));
@@ -448,13 +484,8 @@ void LatteTCGenIR::emitALUGroup(const LatteClauseInstruction_ALU* aluUnit[5], co
 				continue;;
 			}
 			default:
-				assert_dbg();
-			}
-
-			// handle dest clamp
-			if (instrOP2->getDestClamp())
-			{
-				assert_dbg();
+				setUnsupported(fmt::format("ALU OP2 opcode 0x{:02x}", (uint32)opcode2));
+				return;
 			}
 
 			//uint32 src0Sel = (aluWord0 >> 0) & 0x1FF; // source selection
@@ -491,6 +522,12 @@ void LatteTCGenIR::processCF_ALU(const LatteCFInstruction_ALU& cfInstruction)
 	uint32 aluAddr = cfInstruction.getField_ADDR();
 	uint32 aluCount = cfInstruction.getField_COUNT();
 
+	if ((uint64)(aluAddr + aluCount) * 8 > m_ctx.programSize)
+	{
+		setUnsupported("ALU clause out of bounds");
+		return;
+	}
+
 	const uint32* clauseCode = m_ctx.programData + aluAddr * 2;
 	uint32 clauseLength = aluCount;
 	
@@ -507,7 +544,8 @@ void LatteTCGenIR::processCF_ALU(const LatteCFInstruction_ALU& cfInstruction)
 	{
 		if (instr->isOP3())
 		{
-			assert_dbg();
+			setUnsupported("OP3 ALU instruction");
+			return;
 		}
 		else
 		{
@@ -522,7 +560,11 @@ void LatteTCGenIR::processCF_ALU(const LatteCFInstruction_ALU& cfInstruction)
 				if (aluUnit[unitIndex]) // unit already occupied, use transcendental unit instead
 					unitIndex = 4;
 			}
-			cemu_assert_debug(!aluUnit[unitIndex]); // unit already used
+			if (aluUnit[unitIndex])
+			{
+				setUnsupported("ALU group with more instructions than units");
+				return;
+			}
 			aluUnit[unitIndex] = op;
 	
 			// check for literal access
@@ -545,10 +587,15 @@ void LatteTCGenIR::processCF_ALU(const LatteCFInstruction_ALU& cfInstruction)
 				else
 					instr += 1;
 				if ((instr + 1) > instrLast)
-					assert_dbg(); // out of bounds
+				{
+					setUnsupported("ALU literal out of bounds");
+					return;
+				}
 			}
 			// generate code for group
 			emitALUGroup(aluUnit, literalData);
+			if (hasError())
+				return;
 			// reset group
 			std::fill(aluUnit, aluUnit + 5, nullptr);
 			literalMask = 0;
@@ -556,18 +603,20 @@ void LatteTCGenIR::processCF_ALU(const LatteCFInstruction_ALU& cfInstruction)
 		instr++;
 	}
 	if (aluUnit[0] || aluUnit[1] || aluUnit[2] || aluUnit[3] || aluUnit[4])
-		assert_dbg();
+		setUnsupported("unterminated ALU group");
 }
 
 void LatteTCGenIR::processCF_EXPORT(const LatteCFInstruction_EXPORT_IMPORT& cfInstruction)
 {
 	auto exportType = cfInstruction.getField_TYPE();
 
-	cemu_assert_debug(cfInstruction.getField_BURST_COUNT() == 1); // todo
-
 	uint32 arrayBase = cfInstruction.getField_ARRAY_BASE();
 
-	cemu_assert_debug(cfInstruction.isEncodingBUF() == false); // todo
+	if (cfInstruction.getField_BURST_COUNT() != 1 || cfInstruction.isEncodingBUF())
+	{
+		setUnsupported("burst or buffer export"); // todo
+		return;
+	}
 
 	LatteCFInstruction_EXPORT_IMPORT::COMPSEL sel[4];
 	sel[0] = cfInstruction.getSwizField_SEL_X();
@@ -579,14 +628,25 @@ void LatteTCGenIR::processCF_EXPORT(const LatteCFInstruction_EXPORT_IMPORT& cfIn
 
 	ZpIR::DataType typeHint;
 	if (exportType == LatteCFInstruction_EXPORT_IMPORT::EXPORT_TYPE::POSITION)
+	{
+		// array base 60 is the position, the following entries are point size and clip distances
+		if (arrayBase != 60)
+		{
+			setUnsupported(fmt::format("position export with array base {}", arrayBase));
+			return;
+		}
 		typeHint = ZpIR::DataType::F32;
+	}
 	else if (exportType == LatteCFInstruction_EXPORT_IMPORT::EXPORT_TYPE::PARAMETER)
 	{
 		// todo - determine correct type for parameter
 		typeHint = ZpIR::DataType::F32;
 	}
 	else
-		assert_dbg();
+	{
+		setUnsupported(fmt::format("export type {}", (uint32)exportType));
+		return;
+	}
 
 	// get xyzw registers
 	ZpIR::IRReg regArray[4];
@@ -607,8 +667,8 @@ void LatteTCGenIR::processCF_EXPORT(const LatteCFInstruction_EXPORT_IMPORT& cfIn
 		}
 		default:
 		{
-			assert_dbg();
-			break;
+			setUnsupported("export with masked or constant channels"); // todo
+			return;
 		}
 		}
 		//ZpIR::IRReg r;
@@ -628,11 +688,6 @@ void LatteTCGenIR::processCF_EXPORT(const LatteCFInstruction_EXPORT_IMPORT& cfIn
 		loc.SetOutputAttribute(arrayBase);
 		//exportSymbolName = 0x20000 + arrayBase;
 	}
-	else
-	{
-		// todo
-		assert_dbg();
-	}
 
 	cemu_assert_debug(regExportCount == 4); // todo - encode channel mask (e.g. xyz, xw, w, etc.) into export symbol name
 
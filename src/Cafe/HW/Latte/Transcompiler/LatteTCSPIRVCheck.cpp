@@ -0,0 +1,293 @@
+#include "Cafe/HW/Latte/Transcompiler/LatteTC.h"
+#include "Cafe/HW/Latte/Core/FetchShader.h"
+#include "Cafe/HW/Latte/Renderer/Vulkan/RendererShaderVk.h"
+#include "util/Zir/Core/ZpIRPasses.h"
+#include "util/Zir/EmitterGLSL/ZpIREmitGLSL.h"
+#include "util/Zir/EmitterSPIRV/ZpIREmitSPIRV.h"
+#include "util/helpers/StringBuf.h"
+#include "Common/FileStream.h"
+
+#include <glslang/Public/ShaderLang.h>
+
+// offline check for the IR to SPIR-V path (--zir-spirv-check <folder>)
+// every vertex shader of a raw shader dump (dump/shaders/*_vs.bin + *_fs.bin, see LatteShader_DumpRawShader) is translated to IR and emitted as SPIR-V
+// the modules are validated with spirv-val if it is installed, and their interface is compared against the module glslang generates from the GLSL emitter output for the same IR
+// the dumps don't include the context registers, so vertex attributes are assumed to be mapped to R1, R2, ... in fetch order
+
+namespace
+{
+	// the parts of a vertex shader module which have to match the pipeline it is used with
+	struct SPIRVInterface
+	{
+		std::set<uint32> inputLocations;
+		std::map<uint32, uint32> outputLocations; // location -> interpolation flags (1 = flat, 2 = noperspective)
+		bool writesPosition{};
+		uint32 uniformArraySize{};
+
+		bool operator==(const SPIRVInterface&) const = default;
+
+		std::string ToString() const
+		{
+			std::string s = "in:";
+			for (auto& location : inputLocations)
+				s.append(fmt::format(" {}", location));
+			s.append(" out:");
+			for (auto& [location, flags] : outputLocations)
+				s.append(fmt::format(" {}{}{}", location, (flags & 1) ? "f" : "", (flags & 2) ? "n" : ""));
+			s.append(fmt::format(" position: {} uniforms: {}", writesPosition, uniformArraySize));
+			return s;
+		}
+	};
+
+	bool SPIRVCheck_ParseInterface(std::span<const uint32> words, SPIRVInterface& spirvInterface)
+	{
+		if (words.size() < 5 || words[0] != 0x07230203)
+			return false;
+		std::unordered_map<uint32, uint32> location, builtin, interpolationFlags, constantValue, arrayLength, structFirstMember, pointee, variableType, storageClass;
+		std::unordered_set<uint32> blockTypes, positionStructs;
+		for (size_t i = 5; i < words.size();)
+		{
+			uint32 wordCount = words[i] >> 16;
+			uint32 opcode = words[i] & 0xFFFF;
+			if (wordCount == 0 || i + wordCount > words.size())
+				return false;
+			const uint32* ins = words.data() + i;
+			switch (opcode)
+			{
+			case 71: // OpDecorate
+				if (wordCount >= 4 && ins[2] == 30) // Location
+					location[ins[1]] = ins[3];
+				else if (wordCount >= 4 && ins[2] == 11) // BuiltIn
+					builtin[ins[1]] = ins[3];
+				else if (ins[2] == 14) // Flat
+					interpolationFlags[ins[1]] |= 1;
+				else if (ins[2] == 13) // NoPerspective
+					interpolationFlags[ins[1]] |= 2;
+				else if (ins[2] == 2) // Block
+					blockTypes.emplace(ins[1]);
+				break;
+			case 72: // OpMemberDecorate
+				if (wordCount >= 5 && ins[3] == 11 && ins[4] == 0) // BuiltIn Position (gl_PerVertex)
+					positionStructs.emplace(ins[1]);
+				break;
+			case 43: // OpConstant
+				if (wordCount >= 4)
+					constantValue[ins[2]] = ins[3];
+				break;
+			case 28: // OpTypeArray
+				arrayLength[ins[1]] = ins[3];
+				break;
+			case 30: // OpTypeStruct
+				if (wordCount >= 3)
+					structFirstMember[ins[1]] = ins[2];
+				break;
+			case 32: // OpTypePointer
+				pointee[ins[1]] = ins[3];
+				break;
+			case 59: // OpVariable
+				variableType[ins[2]] = ins[1];
+				storageClass[ins[2]] = ins[3];
+				break;
+			}
+			i += wordCount;
+		}
+		for (auto& [variable, sc] : storageClass)
+		{
+			uint32 type = pointee[variableType[variable]];
+			if (sc == 1) // Input
+			{
+				if (location.contains(variable))
+					spirvInterface.inputLocations.emplace(location[variable]);
+			}
+			else if (sc == 3) // Output
+			{
+				if ((builtin.contains(variable) && builtin[variable] == 0) || positionStructs.contains(type))
+					spirvInterface.writesPosition = true;
+				else if (location.contains(variable))
+					spirvInterface.outputLocations[location[variable]] = interpolationFlags[variable];
+			}
+			else if (sc == 2 && blockTypes.contains(type)) // Uniform
+			{
+				auto it = arrayLength.find(structFirstMember[type]);
+				if (it != arrayLength.end())
+					spirvInterface.uniformArraySize = constantValue[it->second];
+			}
+		}
+		return true;
+	}
+
+	// declarations for the GLSL emitter output which match the default (1:1) interface of ZirEmitter::SPIRV
+	void SPIRVCheck_EmitGLSLHeader(ZpIR::ZpIRFunction* irFunction, StringBuf& src)
+	{
+		std::set<uint32> attributes, parameters;
+		uint32 uniformVec4Count = 0;
+		ZpIR::ZpIRBasicBlock* basicBlock = irFunction->m_entryBlocks[0];
+		for (ZpIR::IR::__InsBase* instruction = basicBlock->m_instructionFirst; instruction; instruction = instruction->next)
+		{
+			if (auto ins = ZpIR::IR::InsIMPORT::getIfForm(instruction))
+			{
+				ZpIR::ShaderSubset::ShaderImportLocation loc(ins->importSymbol);
+				uint16 index, channelIndex;
+				if (loc.IsUniformRegister())
+				{
+					loc.GetUniformRegister(index);
+					uniformVec4Count = std::max<uint32>(uniformVec4Count, index / 4 + 1);
+				}
+				else if (loc.IsVertexAttribute())
+				{
+					loc.GetVertexAttribute(index, channelIndex);
+					attributes.emplace(index);
+				}
+			}
+			else if (auto ins = ZpIR::IR::InsEXPORT::getIfForm(instruction))
+			{
+				ZpIR::ShaderSubset::ShaderExportLocation loc(ins->exportSymbol);
+				uint16 index;
+				if (loc.IsOutputAttribute())
+				{
+					loc.GetOutputAttribute(index);
+					parameters.emplace(index);
+				}
+			}
+		}
+		src.add("#version 450\r\n");
+		if (uniformVec4Count > 0)
+			src.addFmt("layout(set = 0, binding = 0, std140) uniform ufBlock\r\n{{\r\n\tuvec4 uf_remappedVS[{}];\r\n}};\r\n", uniformVec4Count);
+		for (auto& attribute : attributes)
+			src.addFmt("layout(location = {0}) in uvec4 attrDataSem{0};\r\n", attribute);
+		for (auto& parameter : parameters)
+			src.addFmt("layout(location = {0}) out vec4 passParameterSem{0};\r\n", parameter);
+		src.add("#define SET_POSITION(_v) gl_Position = _v\r\n");
+	}
+
+	bool SPIRVCheck_IsValidatorAvailable()
+	{
+#if BOOST_OS_WINDOWS
+		return std::system("spirv-val --version > NUL 2>&1") == 0;
+#else
+		return std::system("spirv-val --version > /dev/null 2>&1") == 0;
+#endif
+	}
+
+	bool SPIRVCheck_WriteModule(const fs::path& path, std::span<const uint32> words)
+	{
+		std::unique_ptr<FileStream> file(FileStream::createFile2(path));
+		if (!file)
+			return false;
+		file->writeData(words.data(), (sint32)words.size_bytes());
+		return true;
+	}
+}
+
+bool LatteTC_RunSPIRVCheck(const fs::path& dumpPath)
+{
+	glslang::InitializeProcess();
+	const bool hasValidator = SPIRVCheck_IsValidatorAvailable();
+	if (!hasValidator)
+		fmt::print("spirv-val not found, SPIR-V modules are not validated\n");
+	const fs::path outputPath = dumpPath / "zir_spirv";
+	std::error_code ec;
+	fs::create_directories(outputPath, ec);
+
+	uint32 numShaders = 0, numEmitted = 0, numPassed = 0;
+	std::map<std::string, uint32> unsupportedReasons;
+	for (auto& entry : fs::directory_iterator(dumpPath, ec))
+	{
+		std::string fileName = _pathToUtf8(entry.path().filename());
+		if (!entry.is_regular_file() || !fileName.ends_with("_vs.bin"))
+			continue;
+		const std::string shaderName = fileName.substr(0, fileName.size() - 7);
+		auto vsData = FileStream::LoadIntoMemory(entry.path());
+		auto fsData = FileStream::LoadIntoMemory(dumpPath / (shaderName + "_fs.bin"));
+		if (!vsData || !fsData)
+			continue;
+		numShaders++;
+
+		std::vector<uint32> contextRegisters(LATTE_MAX_REGISTER);
+		LatteFetchShader* fetchShader = LatteShaderRecompiler_createFetchShader(std::hash<std::string>{}(shaderName), contextRegisters.data(), (uint32*)fsData->data(), (uint32)fsData->size());
+		uint32 semanticTable[32];
+		std::fill(std::begin(semanticTable), std::end(semanticTable), 0xFF);
+		uint32 attributeCount = 0;
+		for (auto& bufferGroup : fetchShader->bufferGroups)
+		{
+			for (sint32 i = 0; i < bufferGroup.attribCount && attributeCount < 32; i++)
+				semanticTable[attributeCount++] = bufferGroup.attrib[i].semanticId;
+		}
+
+		LatteTCGenIR genIR;
+		genIR.setVertexShaderContext(fetchShader, semanticTable);
+		ZpIR::ZpIRFunction* irFunction = genIR.transcompileLatteToIR(vsData->data(), (uint32)vsData->size(), LatteTCGenIR::VERTEX);
+		if (!irFunction)
+		{
+			unsupportedReasons[fmt::format("IR: {}", genIR.getErrorMessage())]++;
+			delete fetchShader;
+			continue;
+		}
+		std::vector<uint32> spirvFromIR;
+		ZirEmitter::SPIRV spirvEmitter;
+		if (!spirvEmitter.Emit(irFunction, spirvFromIR))
+		{
+			unsupportedReasons[fmt::format("SPIR-V: {}", spirvEmitter.GetErrorMessage())]++;
+			delete irFunction;
+			delete fetchShader;
+			continue;
+		}
+		numEmitted++;
+		bool passed = true;
+		const fs::path spirvPath = outputPath / (shaderName + "_vs.spv");
+		SPIRVCheck_WriteModule(spirvPath, spirvFromIR);
+		if (hasValidator && std::system(fmt::format("spirv-val --target-env vulkan1.1 \"{}\"", _pathToUtf8(spirvPath)).c_str()) != 0)
+		{
+			fmt::print("{}: spirv-val failed\n", shaderName);
+			passed = false;
+		}
+
+		// reference module via the GLSL emitter and glslang
+		ZirPass::RegisterAllocatorForGLSL ra(irFunction);
+		ra.applyPass();
+		StringBuf glslSource(64 * 1024);
+		SPIRVCheck_EmitGLSLHeader(irFunction, glslSource);
+		ZirEmitter::GLSL glslEmitter;
+		glslEmitter.Emit(irFunction, &glslSource);
+		std::string glslCode(glslSource.c_str(), glslSource.getLen());
+		std::vector<uint32> spirvFromGLSL;
+		std::string errorLog;
+		SPIRVInterface interfaceIR, interfaceGLSL;
+		if (!RendererShaderVk::CompileGLSLToSPIRV(RendererShader::ShaderType::kVertex, glslCode, spirvFromGLSL, errorLog))
+		{
+			fmt::print("{}: glslang failed: {}\n", shaderName, errorLog);
+			passed = false;
+		}
+		else if (!SPIRVCheck_ParseInterface(spirvFromIR, interfaceIR) || !SPIRVCheck_ParseInterface(spirvFromGLSL, interfaceGLSL))
+		{
+			fmt::print("{}: unable to parse module\n", shaderName);
+			passed = false;
+		}
+		else if (interfaceIR != interfaceGLSL)
+		{
+			fmt::print("{}: interface mismatch\n  IR:     {}\n  glslang: {}\n", shaderName, interfaceIR.ToString(), interfaceGLSL.ToString());
+			passed = false;
+		}
+		if (!passed)
+		{
+			if (FileStream* file = FileStream::createFile2(outputPath / (shaderName + "_vs.glsl")))
+			{
+				file->writeData(glslCode.data(), (sint32)glslCode.size());
+				delete file;
+			}
+			SPIRVCheck_WriteModule(outputPath / (shaderName + "_vs_glslang.spv"), spirvFromGLSL);
+		}
+		else
+			numPassed++;
+		delete irFunction;
+		delete fetchShader;
+	}
+
+	fmt::print("Vertex shaders: {} Emitted: {} Passed: {}\n", numShaders, numEmitted, numPassed);
+	std::vector<std::pair<std::string, uint32>> sortedReasons(unsupportedReasons.begin(), unsupportedReasons.end());
+	std::sort(sortedReasons.begin(), sortedReasons.end(), [](const auto& a, const auto& b) { return a.second > b.second; });
+	for (auto& [reason, count] : sortedReasons)
+		fmt::print("{:6} {}\n", count, reason);
+	glslang::FinalizeProcess();
+	return numEmitted == numPassed;
+}
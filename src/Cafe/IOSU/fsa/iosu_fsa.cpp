@@ -3,6 +3,8 @@
 #include "Cafe/IOSU/kernel/iosu_kernel.h"
 #include "Cafe/Filesystem/fsc.h"
 #include "util/helpers/helpers.h"
+#include "util/ThreadPool/ThreadPool.h"
+#include "util/TraceRecorder/TraceRecorder.h"
 
 #include "Cafe/OS/libs/coreinit/coreinit_FS.h"	 // get rid of this dependency, requires reworking some of the IPC stuff. See locations where we use coreinit::FSCmdBlockBody_t
 #include "Cafe/HW/Latte/Core/LatteBufferCache.h" // also remove this dependency
@@ -19,10 +21,24 @@ namespace iosu
 		SysAllocator<iosu::kernel::IOSMessage, 352> _m_sFSAIoMsgQueueMsgBuffer;
 		std::thread sFSAIoThread;
 
+		struct FSAOperationStats
+		{
+			std::atomic<uint64> count{};
+			std::atomic<uint64> totalTimeUs{};
+			std::atomic<uint64> maxTimeUs{};
+		};
+
+		std::atomic<uint32> sFSAQueueDepth{};
+		std::atomic<uint32> sFSAQueueDepthMax{};
+		std::array<FSAOperationStats, FSA_OPERATION_STATS_COUNT> sFSAOperationStats;
+
 		struct FSAClient // IOSU's counterpart to the coreinit FSClient struct
 		{
 			std::string workingDirectory;
-			bool isAllocated{false};
+			std::atomic_bool isAllocated{false};
+			// requests are processed on the high priority workers of the thread pool so that a large read from one client doesn't block other clients
+			// all requests of a client are handled in submission order
+			ThreadPool::SerialQueue requestQueue{ThreadPool::Priority::High};
 
 			void AllocateAndInitialize()
 			{
@@ -179,6 +195,7 @@ namespace iosu
 		public:
 			FSA_RESULT AllocateHandle(FSResHandle& handleOut, FSCVirtualFile* fscFile)
 			{
+				std::unique_lock _l(m_mutex);
 				for (size_t i = 0; i < m_handleTable.size(); i++)
 				{
 					auto& it = m_handleTable.at(i);
@@ -201,6 +218,7 @@ namespace iosu
 			{
 				uint16 index = (uint16)((uint32)handle >> 16);
 				uint16 checkValue = (uint16)(handle & 0xFFFF);
+				std::unique_lock _l(m_mutex);
 				if (index >= m_handleTable.size())
 					return FSA_RESULT::INVALID_FILE_HANDLE;
 				auto& it = m_handleTable.at(index);
@@ -217,6 +235,7 @@ namespace iosu
 			{
 				uint16 index = (uint16)((uint32)handle >> 16);
 				uint16 checkValue = (uint16)(handle & 0xFFFF);
+				std::unique_lock _l(m_mutex);
 				if (index >= m_handleTable.size())
 					return nullptr;
 				auto& it = m_handleTable.at(index);
@@ -228,6 +247,7 @@ namespace iosu
 			}
 
 		private:
+			std::mutex m_mutex; // handles are accessed from all worker threads
 			uint32 m_currentCounter = 1;
 			std::array<_FSAHandleResource, 0x3C0> m_handleTable;
 		};
@@ -469,6 +489,7 @@ namespace iosu
 			if ((flags & FSA_CMD_FLAG_SET_POS) != 0)
 				fsc_setFileSeek(fscFile, filePos);
 			// todo: File permissions
+			TraceRecorder::Scope traceScope("fs", "FSRead", "size", bytesToRead);
 			uint32 bytesSuccessfullyRead = fsc_readFile(fscFile, destPtr, bytesToRead);
 			if (transferElementSize == 0)
 				return FSA_RESULT::OK;
@@ -830,6 +851,58 @@ namespace iosu
 			IOS_ResourceReply(cmd, (IOS_ERROR)fsaResult);
 		}
 
+		void FSAProcessCommand(IPCCommandBody* cmd)
+		{
+			uint32 clientHandle = (uint32)cmd->devHandle;
+			if (cmd->cmdId == IPCCommandId::IOS_CLOSE)
+			{
+				cemu_assert(clientHandle < sFSAClientArray.size());
+				sFSAClientArray[clientHandle].ReleaseAndCleanup();
+				IOS_ResourceReply(cmd, IOS_ERROR_OK);
+			}
+			else if (cmd->cmdId == IPCCommandId::IOS_IOCTL)
+			{
+				cemu_assert(clientHandle < sFSAClientArray.size());
+				cemu_assert(sFSAClientArray[clientHandle].isAllocated);
+				FSAHandleCommandIoctl(sFSAClientArray.data() + clientHandle, cmd, (FSA_CMD_OPERATION_TYPE)cmd->args[0].value(), MEMPTR<void>(cmd->args[1]), MEMPTR<void>(cmd->args[3]));
+			}
+			else if (cmd->cmdId == IPCCommandId::IOS_IOCTLV)
+			{
+				cemu_assert(clientHandle < sFSAClientArray.size());
+				cemu_assert(sFSAClientArray[clientHandle].isAllocated);
+				FSA_CMD_OPERATION_TYPE requestId = (FSA_CMD_OPERATION_TYPE)cmd->args[0].value();
+				uint32 numIn = cmd->args[1];
+				uint32 numOut = cmd->args[2];
+				IPCIoctlVector* vec = MEMPTR<IPCIoctlVector>{cmd->args[3]}.GetPtr();
+				FSAHandleCommandIoctlv(sFSAClientArray.data() + clientHandle, cmd, requestId, numIn, numOut, vec);
+			}
+			else
+			{
+				cemuLog_log(LogType::Force, "/dev/fsa: Unsupported IPC cmdId");
+				cemu_assert_suspicious();
+				IOS_ResourceReply(cmd, IOS_ERROR_INVALID);
+			}
+		}
+
+		void FSAProcessQueuedCommand(IPCCommandBody* cmd)
+		{
+			uint32 operationId = 0;
+			if (cmd->cmdId == IPCCommandId::IOS_IOCTL || cmd->cmdId == IPCCommandId::IOS_IOCTLV)
+				operationId = cmd->args[0].value();
+			auto startTime = std::chrono::steady_clock::now();
+			FSAProcessCommand(cmd);
+			uint64 elapsedUs = (uint64)std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - startTime).count();
+			sFSAQueueDepth--;
+			if (operationId < sFSAOperationStats.size())
+			{
+				FSAOperationStats& stats = sFSAOperationStats[operationId];
+				stats.count++;
+				stats.totalTimeUs += elapsedUs;
+				uint64 prevMax = stats.maxTimeUs.load(std::memory_order_relaxed);
+				while (elapsedUs > prevMax && !stats.maxTimeUs.compare_exchange_weak(prevMax, elapsedUs, std::memory_order_relaxed)) {}
+			}
+		}
+
 		void FSAIoThread()
 		{
 			SetThreadName("IOSU-FSA");
@@ -841,7 +914,6 @@ namespace iosu
 				if (msg == 0)
 					return; // shutdown signaled
 				IPCCommandBody* cmd = MEMPTR<IPCCommandBody>(msg).GetPtr();
-				uint32 clientHandle = (uint32)cmd->devHandle;
 				if (cmd->cmdId == IPCCommandId::IOS_OPEN)
 				{
 					sint32 clientIndex = 0;
@@ -854,35 +926,50 @@ namespace iosu
 					IOS_ResourceReply(cmd, (IOS_ERROR)clientIndex);
 					continue;
 				}
-				else if (cmd->cmdId == IPCCommandId::IOS_CLOSE)
-				{
-					cemu_assert(clientHandle < sFSAClientArray.size());
-					sFSAClientArray[clientHandle].ReleaseAndCleanup();
-					IOS_ResourceReply(cmd, IOS_ERROR_OK);
+				// dispatch to the request queue of this client
+				uint32 queueDepth = ++sFSAQueueDepth;
+				uint32 prevMax = sFSAQueueDepthMax.load(std::memory_order_relaxed);
+				while (queueDepth > prevMax && !sFSAQueueDepthMax.compare_exchange_weak(prevMax, queueDepth, std::memory_order_relaxed)) {}
+				uint32 clientHandle = (uint32)cmd->devHandle;
+				cemu_assert(clientHandle < sFSAClientArray.size());
+				sFSAClientArray[clientHandle].requestQueue.Submit([cmd]() { FSAProcessQueuedCommand(cmd); });
+			}
+		}
+
+		void GetStatistics(FSAStatistics& statsOut)
+		{
+			statsOut.queueDepth = sFSAQueueDepth;
+			statsOut.queueDepthMax = sFSAQueueDepthMax;
+			for (size_t i = 0; i < sFSAOperationStats.size(); i++)
+			{
+				statsOut.operations[i].count = sFSAOperationStats[i].count;
+				statsOut.operations[i].totalTimeUs = sFSAOperationStats[i].totalTimeUs;
+				statsOut.operations[i].maxTimeUs = sFSAOperationStats[i].maxTimeUs;
+			}
+		}
+
+		void ResetStatistics()
+		{
+			sFSAQueueDepthMax = 0;
+			for (auto& it : sFSAOperationStats)
+			{
+				it.count = 0;
+				it.totalTimeUs = 0;
+				it.maxTimeUs = 0;
+			}
+		}
+
+		void LogStatistics()
+		{
+			FSAStatistics stats;
+			GetStatistics(stats);
+			cemuLog_log(LogType::CoreinitFile, "FSA: Max queue depth {}", stats.queueDepthMax);
+			for (size_t i = 0; i < FSA_OPERATION_STATS_COUNT; i++)
+			{
+				auto& op = stats.operations[i];
+				if (op.count == 0)
 					continue;
-				}
-				else if (cmd->cmdId == IPCCommandId::IOS_IOCTL)
-				{
-					cemu_assert(clientHandle < sFSAClientArray.size());
-					cemu_assert(sFSAClientArray[clientHandle].isAllocated);
-					FSAHandleCommandIoctl(sFSAClientArray.data() + clientHandle, cmd, (FSA_CMD_OPERATION_TYPE)cmd->args[0].value(), MEMPTR<void>(cmd->args[1]), MEMPTR<void>(cmd->args[3]));
-				}
-				else if (cmd->cmdId == IPCCommandId::IOS_IOCTLV)
-				{
-					cemu_assert(clientHandle < sFSAClientArray.size());
-					cemu_assert(sFSAClientArray[clientHandle].isAllocated);
-					FSA_CMD_OPERATION_TYPE requestId = (FSA_CMD_OPERATION_TYPE)cmd->args[0].value();
-					uint32 numIn = cmd->args[1];
-					uint32 numOut = cmd->args[2];
-					IPCIoctlVector* vec = MEMPTR<IPCIoctlVector>{cmd->args[3]}.GetPtr();
-					FSAHandleCommandIoctlv(sFSAClientArray.data() + clientHandle, cmd, requestId, numIn, numOut, vec);
-				}
-				else
-				{
-					cemuLog_log(LogType::Force, "/dev/fsa: Unsupported IPC cmdId");
-					cemu_assert_suspicious();
-					IOS_ResourceReply(cmd, IOS_ERROR_INVALID);
-				}
+				cemuLog_log(LogType::CoreinitFile, "FSA: Operation 0x{:02x} Count {} AvgTime {}us MaxTime {}us", i, op.count, op.totalTimeUs / op.count, op.maxTimeUs);
 			}
 		}
 
@@ -890,6 +977,7 @@ namespace iosu
 		{
 			for (auto& it : sFSAClientArray)
 				it.ReleaseAndCleanup();
+			ResetStatistics();
 			sFSAIoMsgQueue = (IOSMsgQueueId)IOS_CreateMessageQueue(_m_sFSAIoMsgQueueMsgBuffer.GetPtr(), _m_sFSAIoMsgQueueMsgBuffer.GetCount());
 			IOS_ERROR r = IOS_RegisterResourceManager("/dev/fsa", sFSAIoMsgQueue);
 			IOS_DeviceAssociateId("/dev/fsa", 11);
@@ -901,6 +989,11 @@ namespace iosu
 		{
 			IOS_SendMessage(sFSAIoMsgQueue, 0, 0);
 			sFSAIoThread.join();
+			for (auto& it : sFSAClientArray)
+				it.requestQueue.Wait();
+			if (cemuLog_isLoggingEnabled(LogType::CoreinitFile))
+				LogStatistics();
+			sFSAQueueDepth = 0;
 		}
 	} // namespace fsa
 } // namespace iosu
@@ -211,6 +211,24 @@ namespace iosu
 		};
 		static_assert(sizeof(FSAShimBuffer) == 0x938); // exact size of this is not known
 
+		// indexed by FSA_CMD_OPERATION_TYPE
+		constexpr size_t FSA_OPERATION_STATS_COUNT = 0x20;
+
+		struct FSAStatistics
+		{
+			uint32 queueDepth; // number of requests currently queued or in progress
+			uint32 queueDepthMax;
+			struct
+			{
+				uint64 count;
+				uint64 totalTimeUs;
+				uint64 maxTimeUs;
+			}operations[FSA_OPERATION_STATS_COUNT];
+		};
+
+		void GetStatistics(FSAStatistics& statsOut);
+		void ResetStatistics();
+
 		void Initialize();
 		void Shutdown();
 	} // namespace fsa
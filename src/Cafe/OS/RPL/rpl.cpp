@@ -10,6 +10,8 @@
 #include "Cafe/HW/Espresso/Debugger/Debugger.h"
 #include "Cafe/GraphicPack/GraphicPack2.h"
 #include "util/ChunkedHeap/ChunkedHeap.h"
+#include "util/ThreadPool/ThreadPool.h"
+#include "util/highresolutiontimer/HighResolutionTimer.h"
 
 #include "util/crypto/crc32.h"
 #include "config/ActiveSettings.h"
@@ -55,6 +57,7 @@ RPLModule* rplLoader_mainModule = nullptr;
 uint32 rplLoader_sdataAddr = MPTR_NULL; // r13
 uint32 rplLoader_sdata2Addr = MPTR_NULL; // r2
 uint32 rplLoader_currentDataAllocatorAddr = 0x10000000;
+HRTick rplLoader_inflateWaitTime = 0; // wall time the loading thread spent waiting for inflation tasks
 
 std::map<void(*)(PPCInterpreter_t* hCPU), uint32> g_map_callableExports;
 
@@ -319,12 +322,6 @@ bool RPLLoader_ProcessHeaders(std::string_view moduleName, uint8* rplData, uint3
 	return true;
 }
 
-class RPLUncompressedSection
-{
-public:
-	std::vector<uint8> sectionData;
-};
-
 rplSectionEntryNew_t* RPLLoader_GetSection(RPLModule* rplLoaderContext, sint32 sectionIndex)
 {
 	sint32 sectionCount = rplLoaderContext->rplHeader.sectionTableEntryCount;
@@ -338,12 +335,91 @@ rplSectionEntryNew_t* RPLLoader_GetSection(RPLModule* rplLoaderContext, sint32 s
 	return section;
 }
 
+// inflates compressed section data, which starts with the big-endian size of the uncompressed data followed by a zlib stream
+bool RPLLoader_InflateSectionData(const uint8* compressedData, uint32 compressedSize, std::vector<uint8>& dataOut)
+{
+	if (compressedSize < sizeof(uint32be))
+		return false;
+	uint32 uncompressedSize = *(uint32be*)compressedData;
+	if (uncompressedSize >= 1*1024*1024*1024) // sections bigger than 1GB not allowed
+		return false;
+	z_stream strm;
+	strm.zalloc = Z_NULL;
+	strm.zfree = Z_NULL;
+	strm.opaque = Z_NULL;
+	if (inflateInit(&strm) != Z_OK)
+		return false;
+	dataOut.resize(uncompressedSize);
+	strm.avail_in = compressedSize - 4;
+	strm.next_in = (Bytef*)compressedData + 4;
+	strm.avail_out = uncompressedSize;
+	strm.next_out = dataOut.data();
+	int ret = inflate(&strm, Z_FULL_FLUSH);
+	inflateEnd(&strm);
+	return (ret == Z_OK || ret == Z_STREAM_END) && strm.avail_in == 0 && strm.avail_out == 0;
+}
+
+// module file data together with its compressed sections, inflated before the module is mapped
+struct RPLPreloadedModule
+{
+	std::string path; // used to derive the module name
+	std::vector<uint8> fileData; // owned copy of the file, if it was read by the loader
+	std::span<uint8> rawData;
+	std::vector<std::unique_ptr<RPLUncompressedSection>> inflatedSections;
+	std::vector<HRTick> inflateTime;
+};
+
+// queues one inflate task per compressed section. Headers are only checked as far as needed to locate the sections, invalid files are rejected later by RPLLoader_ProcessHeaders()
+// sections which fail to inflate are left empty so that RPLLoader_LoadUncompressedSection() retries them and reports the error
+// safe to call from a task of the same group
+void RPLLoader_InflateSectionsAsync(RPLPreloadedModule& module, ThreadPool::TaskGroup& taskGroup)
+{
+	if (module.rawData.size() < sizeof(rplHeaderNew_t))
+		return;
+	rplHeaderNew_t* rplHeader = (rplHeaderNew_t*)module.rawData.data();
+	uint32 sectionCount = rplHeader->sectionTableEntryCount;
+	if ((uint32)rplHeader->sectionTableEntrySize != sizeof(rplSectionEntryNew_t))
+		return;
+	if ((uint64)(uint32)rplHeader->sectionTableOffset + (uint64)sectionCount * sizeof(rplSectionEntryNew_t) > module.rawData.size())
+		return;
+	rplSectionEntryNew_t* sectionTable = (rplSectionEntryNew_t*)(module.rawData.data() + (uint32)rplHeader->sectionTableOffset);
+	module.inflatedSections.resize(sectionCount);
+	module.inflateTime.resize(sectionCount);
+	std::vector<uint32> compressedSections;
+	for (uint32 i = 0; i < sectionCount; i++)
+	{
+		const rplSectionEntryNew_t& section = sectionTable[i];
+		if ((uint32)section.type == SHT_NOBITS || ((uint32)section.flags & SHF_RPL_COMPRESSED) == 0)
+			continue;
+		if ((uint64)(uint32)section.fileOffset + (uint32)section.sectionSize > module.rawData.size())
+			continue;
+		compressedSections.emplace_back(i);
+	}
+	// start with the largest sections since they determine how long the module takes
+	std::sort(compressedSections.begin(), compressedSections.end(), [&](uint32 a, uint32 b) { return (uint32)sectionTable[a].sectionSize > (uint32)sectionTable[b].sectionSize; });
+	for (uint32 sectionIndex : compressedSections)
+	{
+		const uint8* compressedData = module.rawData.data() + (uint32)sectionTable[sectionIndex].fileOffset;
+		uint32 compressedSize = sectionTable[sectionIndex].sectionSize;
+		ThreadPool::Submit(ThreadPool::Priority::High, [&module, sectionIndex, compressedData, compressedSize]() {
+			HRTick startTime = HighResolutionTimer::now().getTick();
+			auto uSection = std::make_unique<RPLUncompressedSection>();
+			if (RPLLoader_InflateSectionData(compressedData, compressedSize, uSection->sectionData))
+				module.inflatedSections[sectionIndex] = std::move(uSection);
+			module.inflateTime[sectionIndex] = HighResolutionTimer::now().getTick() - startTime;
+		}, &taskGroup);
+	}
+}
+
 RPLUncompressedSection* RPLLoader_LoadUncompressedSection(RPLModule* rplLoaderContext, sint32 sectionIndex)
 {
 	const rplSectionEntryNew_t* section = RPLLoader_GetSection(rplLoaderContext, sectionIndex);
 	if (section == nullptr)
 		return nullptr;
 
+	if (sectionIndex < rplLoaderContext->inflatedSections.size() && rplLoaderContext->inflatedSections[sectionIndex])
+		return rplLoaderContext->inflatedSections[sectionIndex].release();
+
 	RPLUncompressedSection* uSection = new RPLUncompressedSection();
 
 	if ((uint32)section->type == 0x8)
@@ -382,28 +458,12 @@ RPLUncompressedSection* RPLLoader_LoadUncompressedSection(RPLModule* rplLoaderCo
 			delete uSection;
 			return nullptr;
 		}
-		int ret;
-		z_stream strm;
-		strm.zalloc = Z_NULL;
-		strm.zfree = Z_NULL;
-		strm.opaque = Z_NULL;
-		ret = inflateInit(&strm);
-		if (ret == Z_OK)
+		if (!RPLLoader_InflateSectionData(rplLoaderContext->RPLRawData.data() + (uint32)section->fileOffset, section->sectionSize, uSection->sectionData))
 		{
-			strm.avail_in = (uint32)section->sectionSize - 4;
-			strm.next_in = rplLoaderContext->RPLRawData.data() + (uint32)section->fileOffset + 4;
-			strm.avail_out = uncompressedSize;
-			uSection->sectionData.resize(uncompressedSize);
-			strm.next_out = uSection->sectionData.data();
-			ret = inflate(&strm, Z_FULL_FLUSH);
-			inflateEnd(&strm);
-			if ((ret != Z_OK && ret != Z_STREAM_END) || strm.avail_in != 0 || strm.avail_out != 0)
-			{
-				cemuLog_log(LogType::Force, "RPLLoader: Error while inflating data for section {}", sectionIndex);
-				rplLoaderContext->hasError = true;
-				delete uSection;
-				return nullptr;
-			}
+			cemuLog_log(LogType::Force, "RPLLoader: Error while inflating data for section {}", sectionIndex);
+			rplLoaderContext->hasError = true;
+			delete uSection;
+			return nullptr;
 		}
 	}
 	else
@@ -1246,29 +1306,22 @@ bool RPLLoader_ApplyRelocs(RPLModule* rplLoaderContext, sint32 relaSectionIndex,
 	// decompress reloc section if needed
 	uint8* relocData;
 	uint32 relocSize;
+	std::vector<uint8> relocDataInflated;
 	if ((uint32)(section->flags) & SHF_RPL_COMPRESSED)
 	{
-		uint8* relocRawData = (uint8*)rplLoaderContext->sectionAddressTable2[relaSectionIndex].ptr;
-		uint32 relocUncompressedSize = *(uint32be*)relocRawData;
-		relocData = (uint8*)malloc(relocUncompressedSize);
-		relocSize = relocUncompressedSize;
-		// decompress
-		int ret;
-		z_stream strm;
-		strm.zalloc = Z_NULL;
-		strm.zfree = Z_NULL;
-		strm.opaque = Z_NULL;
-		ret = inflateInit(&strm);
-		if (ret == Z_OK)
+		if (relaSectionIndex < rplLoaderContext->inflatedSections.size() && rplLoaderContext->inflatedSections[relaSectionIndex])
 		{
-			strm.avail_in = (uint32)section->sectionSize - 4;
-			strm.next_in = relocRawData + 4;
-			strm.avail_out = relocUncompressedSize;
-			strm.next_out = relocData;
-			ret = inflate(&strm, Z_FULL_FLUSH);
-			cemu_assert_debug(ret == Z_OK || ret == Z_STREAM_END);
-			cemu_assert_debug(strm.avail_in == 0 && strm.avail_out == 0);
-			inflateEnd(&strm);
+			// inflated ahead of time, kept until the module is linked since relocations are applied in multiple passes
+			relocData = rplLoaderContext->inflatedSections[relaSectionIndex]->sectionData.data();
+			relocSize = (uint32)rplLoaderContext->inflatedSections[relaSectionIndex]->sectionData.size();
+		}
+		else
+		{
+			uint8* relocRawData = (uint8*)rplLoaderContext->sectionAddressTable2[relaSectionIndex].ptr;
+			bool isInflated = RPLLoader_InflateSectionData(relocRawData, section->sectionSize, relocDataInflated);
+			cemu_assert_debug(isInflated);
+			relocData = relocDataInflated.data();
+			relocSize = (uint32)relocDataInflated.size();
 		}
 	}
 	else
@@ -1350,14 +1403,13 @@ bool RPLLoader_ApplyRelocs(RPLModule* rplLoaderContext, sint32 relaSectionIndex,
 		reloc++;
 	}
 
-	if ((uint32)(section->flags) & SHF_RPL_COMPRESSED)
-		free(relocData);
 	return true;
 }
 
 bool RPLLoader_HandleRelocs(RPLModule* rplLoaderContext, std::span<RPLSharedImportTracking> sharedImportTracking, uint32 linkMode)
 {
 	// resolve relocs
+	HRTick startTime = HighResolutionTimer::now().getTick();
 	for (sint32 i = 0; i < (sint32)rplLoaderContext->rplHeader.sectionTableEntryCount; i++)
 	{
 		rplSectionEntryNew_t* section = rplLoaderContext->sectionTablePtr + i;
@@ -1366,6 +1418,8 @@ bool RPLLoader_HandleRelocs(RPLModule* rplLoaderContext, std::span<RPLSharedImpo
 			continue;
 		RPLLoader_FixImportSymbols(rplLoaderContext, i, section, sharedImportTracking, linkMode);
 	}
+	HRTick importsEndTime = HighResolutionTimer::now().getTick();
+	rplLoaderContext->loadTimings.imports += importsEndTime - startTime;
 
 	// apply relocs again after we have fixed the import section
 	for (sint32 i = 0; i < (sint32)rplLoaderContext->rplHeader.sectionTableEntryCount; i++)
@@ -1376,6 +1430,7 @@ bool RPLLoader_HandleRelocs(RPLModule* rplLoaderContext, std::span<RPLSharedImpo
 			continue;
 		RPLLoader_ApplyRelocs(rplLoaderContext, i, section, linkMode);
 	}
+	rplLoaderContext->loadTimings.relocation += HighResolutionTimer::now().getTick() - importsEndTime;
 	return true;
 }
 
@@ -1464,6 +1519,12 @@ void RPLLoader_BeginCemuhookCRC(RPLModule* rpl)
 			rawData = NULL;
 			rawSize = sectionCompressedSize;
 		}
+		else if ((flags&SHF_RPL_COMPRESSED) != 0 && i < rpl->inflatedSections.size() && rpl->inflatedSections[i])
+		{
+			// inflated ahead of time
+			rawData = rpl->inflatedSections[i]->sectionData.data();
+			rawSize = (uint32)rpl->inflatedSections[i]->sectionData.size();
+		}
 		else if ((flags&SHF_RPL_COMPRESSED) != 0)
 		{
 			uint32 decompressedSize = _swapEndianU32(*(uint32*)(rpl->RPLRawData.data() + sectionFileOffset));
@@ -1579,16 +1640,23 @@ void RPLLoader_InitModuleAllocator(RPLModule* rpl)
 }
 
 // map rpl into memory, but do not resolve relocs and imports yet
-RPLModule* RPLLoader_LoadFromMemory(uint8* rplData, sint32 size, std::string_view name)
+// compressed sections are taken from preloadedModule, sections missing there are inflated on the calling thread
+RPLModule* RPLLoader_LoadPreloaded(RPLPreloadedModule& preloadedModule, std::string_view name)
 {
 	char moduleName[RPL_MODULE_NAME_LENGTH];
 	_RPLLoader_ExtractModuleNameFromPath(moduleName, name);
 	RPLModule* rpl = nullptr;
-	if (RPLLoader_ProcessHeaders({ moduleName }, rplData, size, &rpl) == false)
+	HRTick startTime = HighResolutionTimer::now().getTick();
+	if (RPLLoader_ProcessHeaders({ moduleName }, preloadedModule.rawData.data(), (uint32)preloadedModule.rawData.size(), &rpl) == false)
 	{
 		delete rpl;
 		return nullptr;
 	}
+	HRTick headersEndTime = HighResolutionTimer::now().getTick();
+	rpl->loadTimings.headers = headersEndTime - startTime;
+	rpl->inflatedSections = std::move(preloadedModule.inflatedSections);
+	for (HRTick inflateTime : preloadedModule.inflateTime)
+		rpl->loadTimings.inflate += inflateTime;
 	RPLLoader_InitModuleAllocator(rpl);
 	RPLLoader_BeginCemuhookCRC(rpl);
 	if (RPLLoader_LoadSections(0, rpl) == false)
@@ -1596,6 +1664,13 @@ RPLModule* RPLLoader_LoadFromMemory(uint8* rplData, sint32 size, std::string_vie
 		delete rpl;
 		return nullptr;
 	}
+	// past this point only the relocation sections are still needed
+	for (size_t i = 0; i < rpl->inflatedSections.size(); i++)
+	{
+		if (rpl->inflatedSections[i] && (uint32)rpl->sectionTablePtr[i].type != SHT_RELA)
+			rpl->inflatedSections[i].reset();
+	}
+	rpl->loadTimings.mapping = HighResolutionTimer::now().getTick() - headersEndTime;
 
 	cemuLog_logDebug(LogType::Force, "Load {} Code-Offset: -0x{:x}", name, rpl->regionMappingBase_text.GetMPTR() - 0x02000000);
 
@@ -1668,6 +1743,18 @@ RPLModule* RPLLoader_LoadFromMemory(uint8* rplData, sint32 size, std::string_vie
 	return rpl;
 }
 
+RPLModule* RPLLoader_LoadFromMemory(uint8* rplData, sint32 size, std::string_view name)
+{
+	RPLPreloadedModule preloadedModule;
+	preloadedModule.rawData = std::span<uint8>(rplData, size);
+	HRTick startTime = HighResolutionTimer::now().getTick();
+	ThreadPool::TaskGroup taskGroup;
+	RPLLoader_InflateSectionsAsync(preloadedModule, taskGroup);
+	taskGroup.Wait();
+	rplLoader_inflateWaitTime += HighResolutionTimer::now().getTick() - startTime;
+	return RPLLoader_LoadPreloaded(preloadedModule, name);
+}
+
 void RPLLoader_FlushMemory(RPLModule* rpl)
 {
 	// invalidate recompiler cache
@@ -1892,8 +1979,11 @@ void RPLLoader_Link()
 		if (rplModuleList[i]->isLinked)
 			continue;
 		RPLLoader_LinkSingleModule(rplModuleList[i], true);
+		HRTick symbolsStartTime = HighResolutionTimer::now().getTick();
 		RPLLoader_LoadDebugSymbols(rplModuleList[i]);
+		rplModuleList[i]->loadTimings.symbols += HighResolutionTimer::now().getTick() - symbolsStartTime;
 		rplModuleList[i]->isLinked = true; // mark as linked
+		rplModuleList[i]->inflatedSections.clear(); // relocations are no longer needed
 		GraphicPack2::NotifyModuleLoaded(rplModuleList[i]);
 		g_debuggerDispatcher.NotifyModuleLoaded(rplModuleList[i]);
 	}
@@ -2084,14 +2174,16 @@ bool RPLLoader_GetTLSDataByTLSIndex(sint16 tlsModuleIndex, uint8** tlsData, sint
 	return true;
 }
 
-bool RPLLoader_LoadFromVirtualPath(RPLDependency* dependency, std::string_view filePath)
+bool RPLLoader_ReadFromVirtualPath(RPLPreloadedModule& preloadedModule, std::string_view filePath)
 {
 	uint32 rplSize = 0;
 	uint8* rplData = fsc_extractFile(std::string(filePath).c_str(), &rplSize);
 	if (rplData)
 	{
 		cemuLog_logDebug(LogType::Force, "Loading: {}", filePath);
-		dependency->rplLoaderContext = RPLLoader_LoadFromMemory(rplData, rplSize, filePath);
+		preloadedModule.path = filePath;
+		preloadedModule.fileData.assign(rplData, rplData + rplSize);
+		preloadedModule.rawData = preloadedModule.fileData;
 		free(rplData);
 		return true;
 	}
@@ -2100,35 +2192,17 @@ bool RPLLoader_LoadFromVirtualPath(RPLDependency* dependency, std::string_view f
 
 std::span<COSModule*> GetCOSModules();
 
-void RPLLoader_LoadDependency(RPLDependency* dependency)
+// locate the file of a dependency which is not HLE and read it into memory
+// only accesses the file system, so it can run on worker threads while the loading thread waits
+bool RPLLoader_ReadDependencyFile(RPLDependency* dependency, RPLPreloadedModule& preloadedModule)
 {
-	// if its a HLE module then notify that it has been mapped
-	if (dependency->rplHLEModule)
-	{
-		dependency->rplHLEModule->RPLMapped();
-		// load chained dependencies
-		// this is necessary for something like GX2.rpl which uses TCL.rpl functions
-		auto depList = dependency->rplHLEModule->GetDependencies();
-		for (const auto& dep : depList)
-			RPLLoader_AddDependency(dep);
-		return;
-	}
-	// check if module is already loaded
-	for (sint32 i = 0; i < rplModuleCount; i++)
-	{
-		if(!boost::iequals(rplModuleList[i]->moduleName2, dependency->modulename))
-			continue;
-		dependency->rplLoaderContext = rplModuleList[i];
-		return;
-	}
 	//char filePath[RPL_MODULE_PATH_LENGTH];
 	std::string rplPath;
 	// check if path is absolute
 	if (!dependency->filepath.empty() && dependency->filepath.front() == '/')
 	{
 		rplPath = dependency->filepath;
-		RPLLoader_LoadFromVirtualPath(dependency, rplPath);
-		return;
+		return RPLLoader_ReadFromVirtualPath(preloadedModule, rplPath);
 	}
 	// attempt to load rpl from code directory of current title
 	rplPath =  "/internal/current_title/code/";
@@ -2142,8 +2216,8 @@ void RPLLoader_LoadDependency(RPLDependency* dependency)
 	}
 	if (isBlacklisted)
 		cemuLog_log(LogType::Force, fmt::format("Game tried to load \"{}\" but it is blacklisted (using Cemu's implementation instead)", rplPath));
-	else if (RPLLoader_LoadFromVirtualPath(dependency, rplPath))
-		return;
+	else if (RPLLoader_ReadFromVirtualPath(preloadedModule, rplPath))
+		return true;
 	// attempt to load rpl from Cemu's /cafeLibs/ directory
 	if (ActiveSettings::LoadSharedLibrariesEnabled())
 	{
@@ -2152,19 +2226,106 @@ void RPLLoader_LoadDependency(RPLDependency* dependency)
 		if (fileData)
 		{
 			cemuLog_log(LogType::Force, "Loading RPL: /cafeLibs/{}", dependency->filepath);
-			dependency->rplLoaderContext = RPLLoader_LoadFromMemory(fileData->data(), fileData->size(), dependency->filepath);
-			return;
+			preloadedModule.path = dependency->filepath;
+			preloadedModule.fileData = std::move(*fileData);
+			preloadedModule.rawData = preloadedModule.fileData;
+			return true;
 		}
 	}
+	return false;
+}
+
+bool RPLLoader_IsModuleLoaded(std::string_view moduleName)
+{
+	for (sint32 i = 0; i < rplModuleCount; i++)
+	{
+		if (boost::iequals(rplModuleList[i]->moduleName2, moduleName))
+			return true;
+	}
+	return false;
+}
+
+// result of reading and inflating a dependency on the thread pool
+struct RPLPrefetchedDependency
+{
+	bool isFound{false};
+	RPLPreloadedModule preloadedModule;
+};
+
+// if prefetched is set the file lookup was already done by RPLLoader_PrefetchDependencies()
+void RPLLoader_LoadDependency(RPLDependency* dependency, RPLPrefetchedDependency* prefetched = nullptr)
+{
+	// if its a HLE module then notify that it has been mapped
+	if (dependency->rplHLEModule)
+	{
+		dependency->rplHLEModule->RPLMapped();
+		// load chained dependencies
+		// this is necessary for something like GX2.rpl which uses TCL.rpl functions
+		auto depList = dependency->rplHLEModule->GetDependencies();
+		for (const auto& dep : depList)
+			RPLLoader_AddDependency(dep);
+		return;
+	}
+	// check if module is already loaded
+	for (sint32 i = 0; i < rplModuleCount; i++)
+	{
+		if(!boost::iequals(rplModuleList[i]->moduleName2, dependency->modulename))
+			continue;
+		dependency->rplLoaderContext = rplModuleList[i];
+		return;
+	}
+	if (prefetched)
+	{
+		if (prefetched->isFound)
+			dependency->rplLoaderContext = RPLLoader_LoadPreloaded(prefetched->preloadedModule, prefetched->preloadedModule.path);
+		return;
+	}
+	RPLPreloadedModule preloadedModule;
+	if (!RPLLoader_ReadDependencyFile(dependency, preloadedModule))
+		return;
+	HRTick startTime = HighResolutionTimer::now().getTick();
+	ThreadPool::TaskGroup taskGroup;
+	RPLLoader_InflateSectionsAsync(preloadedModule, taskGroup);
+	taskGroup.Wait();
+	rplLoader_inflateWaitTime += HighResolutionTimer::now().getTick() - startTime;
+	dependency->rplLoaderContext = RPLLoader_LoadPreloaded(preloadedModule, preloadedModule.path);
+}
+
+// read and inflate all dependencies which are pending to be loaded at once, so independent modules are decompressed concurrently
+// mapping stays on the loading thread since it allocates from the shared loader heaps
+void RPLLoader_PrefetchDependencies(std::unordered_map<RPLDependency*, std::unique_ptr<RPLPrefetchedDependency>>& prefetchedDependencies)
+{
+	ThreadPool::TaskGroup taskGroup;
+	HRTick startTime = HighResolutionTimer::now().getTick();
+	for (RPLDependency* dependency : rplDependencyList)
+	{
+		if (dependency->referenceCount == 0 || dependency->loadAttempted || dependency->rplHLEModule)
+			continue;
+		if (prefetchedDependencies.find(dependency) != prefetchedDependencies.end())
+			continue;
+		if (RPLLoader_IsModuleLoaded(dependency->modulename))
+			continue;
+		RPLPrefetchedDependency* prefetched = prefetchedDependencies.emplace(dependency, std::make_unique<RPLPrefetchedDependency>()).first->second.get();
+		ThreadPool::Submit(ThreadPool::Priority::High, [dependency, prefetched, &taskGroup]() {
+			prefetched->isFound = RPLLoader_ReadDependencyFile(dependency, prefetched->preloadedModule);
+			if (prefetched->isFound)
+				RPLLoader_InflateSectionsAsync(prefetched->preloadedModule, taskGroup);
+		}, &taskGroup);
+	}
+	taskGroup.Wait();
+	rplLoader_inflateWaitTime += HighResolutionTimer::now().getTick() - startTime;
 }
 
 // loads and unloads modules based on the current dependency list
 void RPLLoader_UpdateDependencies()
 {
+	std::unordered_map<RPLDependency*, std::unique_ptr<RPLPrefetchedDependency>> prefetchedDependencies;
 	bool repeat = true;
 	while (repeat)
 	{
 		repeat = false;
+		// loading a module can add further dependencies, those are prefetched as a batch in the next iteration
+		RPLLoader_PrefetchDependencies(prefetchedDependencies);
 		for(auto idx = 0; idx<rplDependencyList.size(); )
 		{
 			auto dependency = rplDependencyList[idx];
@@ -2188,6 +2349,7 @@ void RPLLoader_UpdateDependencies()
 						RPLLoader_RemoveDependency(dep);
 				}
 				// remove from dependency list
+				prefetchedDependencies.erase(dependency);
 				rplDependencyList.erase(rplDependencyList.begin()+idx);
 				idx--;
 				repeat = true; // unload can effect reference count of other dependencies
@@ -2197,7 +2359,8 @@ void RPLLoader_UpdateDependencies()
 			{
 				// load
 				dependency->loadAttempted = true;
-				RPLLoader_LoadDependency(dependency);
+				auto prefetchedIt = prefetchedDependencies.find(dependency);
+				RPLLoader_LoadDependency(dependency, prefetchedIt != prefetchedDependencies.end() ? prefetchedIt->second.get() : nullptr);
 				repeat = true;
 				idx++;
 				break;
@@ -2324,9 +2487,33 @@ void RPLLoader_CallCoreinitEntrypoint()
 	cemu_assert_unimplemented(); // coreinit.rpl present in cafelibs? We currently do not support native coreinit and no thread context exists yet to do a PPC call
 }
 
+// log where the time went while loading and linking the modules required to boot
+void RPLLoader_LogBootTimeline()
+{
+	if (!cemuLog_isLoggingEnabled(LogType::RPLLoader))
+		return;
+	auto toMs = [](HRTick ticks) { return (double)HighResolutionTimer::ticksToMicroseconds(ticks) / 1000.0; };
+	cemuLog_log(LogType::RPLLoader, "RPL boot timeline (headers / inflate / map / relocs / imports / symbols):");
+	decltype(RPLModule::loadTimings) total{};
+	for (sint32 i = 0; i < rplModuleCount; i++)
+	{
+		auto& t = rplModuleList[i]->loadTimings;
+		cemuLog_log(LogType::RPLLoader, "  {:<24} {:>7.2f}ms {:>7.2f}ms {:>7.2f}ms {:>7.2f}ms {:>7.2f}ms {:>7.2f}ms", rplModuleList[i]->moduleName2, toMs(t.headers), toMs(t.inflate), toMs(t.mapping), toMs(t.relocation), toMs(t.imports), toMs(t.symbols));
+		total.headers += t.headers;
+		total.inflate += t.inflate;
+		total.mapping += t.mapping;
+		total.relocation += t.relocation;
+		total.imports += t.imports;
+		total.symbols += t.symbols;
+	}
+	cemuLog_log(LogType::RPLLoader, "  {:<24} {:>7.2f}ms {:>7.2f}ms {:>7.2f}ms {:>7.2f}ms {:>7.2f}ms {:>7.2f}ms", "total", toMs(total.headers), toMs(total.inflate), toMs(total.mapping), toMs(total.relocation), toMs(total.imports), toMs(total.symbols));
+	cemuLog_log(LogType::RPLLoader, "  inflation ran on {} threads, loading waited {:.2f}ms for it", ThreadPool::GetWorkerCount(ThreadPool::Priority::High), toMs(rplLoader_inflateWaitTime));
+}
+
 void RPLLoader_NotifyControlPassedToApplication()
 {
 	rplLoader_applicationHasMemoryControl = true;
+	RPLLoader_LogBootTimeline();
 }
 
 uint32 RPLLoader_FindModuleOrHLEExport(uint32 moduleHandle, bool isData, const char* exportName)
@@ -2496,6 +2683,7 @@ void RPLLoader_UnloadAll()
 	list_mappedFunctionImports.clear();
 	g_map_callableExports.clear();
 	rplLoader_applicationHasMemoryControl = false;
+	rplLoader_inflateWaitTime = 0;
 	rplLoader_maxCodeAddress = 0;
 	rplLoader_currentDataAllocatorAddr = 0x10000000;
 	rplLoader_currentTLSModuleIndex = 1;
@@ -140,6 +140,12 @@ typedef struct
 	uint32be nameOffset;
 }rplExportTableEntry_t;
 
+class RPLUncompressedSection
+{
+public:
+	std::vector<uint8> sectionData;
+};
+
 struct RPLModule
 {
 	uint32 ukn00; // pointer to shared memory region? (0xEFE01000)
@@ -204,6 +210,21 @@ struct RPLModule
 	// parsed CRC
 	std::vector<uint32> crcTable;
 
+	// compressed sections inflated ahead of time, indexed by section. Entries are nullptr if a section was not inflated or has been consumed
+	// mapped sections are released once copied, the remaining ones (relocations) once the module is linked
+	std::vector<std::unique_ptr<RPLUncompressedSection>> inflatedSections;
+
+	// time spent in each load stage, in HighResolutionTimer ticks
+	struct
+	{
+		uint64 headers;
+		uint64 inflate; // summed over all worker threads
+		uint64 mapping; // includes the patch CRC
+		uint64 relocation;
+		uint64 imports;
+		uint64 symbols;
+	}loadTimings{};
+
 	uint32 GetSectionCRC(size_t sectionIndex) const
 	{
 		if (sectionIndex >= crcTable.size())
@@ -5,6 +5,9 @@
 #include "Cafe/OS/libs/coreinit/coreinit_Alarm.h"
 #include "Cafe/HW/Espresso/Recompiler/PPCRecompiler.h"
 #include "Cafe/OS/RPL/rpl.h"
+#include "config/ActiveSettings.h"
+#include "util/containers/TimerWheel.h"
+#include "util/helpers/helpers.h"
 
 // #define ALARM_LOGGING
 
@@ -17,31 +20,45 @@ namespace coreinit
 	SysAllocator<char, 32> _g_alarmThreadName;
 
 
-	class OSHostAlarm 
+	// host thread which sleeps until the next host alarm is due
+	// this way alarms fire on time even while the main core is busy running guest code instead of idling in __OSCheckSystemEvents()
+	std::thread s_alarmTimerThread;
+	std::mutex s_alarmTimerMutex;
+	std::condition_variable s_alarmTimerCondVar;
+	bool s_alarmTimerThreadRunning{false};
+	std::atomic_uint64_t s_alarmTimerWakeupTick{std::numeric_limits<uint64>::max()}; // tick at which the timer thread will wake up next, max while awake
+
+	void _OSAlarmTimerThreadNotify(uint64 soonestAlarm)
+	{
+		if (soonestAlarm >= s_alarmTimerWakeupTick.load())
+			return;
+		std::unique_lock _l(s_alarmTimerMutex);
+		s_alarmTimerCondVar.notify_one();
+	}
+
+	class OSHostAlarm : public TimerWheelEntry
 	{
 	public:
-		OSHostAlarm(uint64 nextFire, uint64 period, void(*callbackFunc)(uint64 currentTick, void* context), void* context) : m_nextFire(nextFire), m_period(period), m_callbackFunc(callbackFunc), m_context(context)
+		OSHostAlarm(uint64 nextFire, uint64 period, void(*callbackFunc)(uint64 currentTick, void* context), void* context) : m_period(period), m_callbackFunc(callbackFunc), m_context(context)
 		{
 			cemu_assert_debug(__OSHasSchedulerLock()); // must hold lock
-			auto r = g_activeAlarmList.emplace(this);
-			cemu_assert_debug(r.second); // check if insertion was successful
-			m_isActive = true;
+			g_alarmWheel.Insert(this, nextFire);
 			updateEarliestAlarmAtomic();
 		}
 
 		~OSHostAlarm()
 		{
 			cemu_assert_debug(__OSHasSchedulerLock()); // must hold lock
-			if (m_isActive)
+			if (IsQueued())
 			{
-				g_activeAlarmList.erase(g_activeAlarmList.find(this));
+				g_alarmWheel.Remove(this);
 				updateEarliestAlarmAtomic();
 			}
 		}
 
 		uint64 getFireTick() const
 		{
-			return m_nextFire;
+			return GetDeadline();
 		}
 
 		void triggerAlarm(uint64 currentTick)
@@ -52,63 +69,32 @@ namespace coreinit
 		static void updateEarliestAlarmAtomic()
 		{
 			cemu_assert_debug(__OSHasSchedulerLock());
-			if (!g_activeAlarmList.empty())
-			{
-				auto firstAlarm = g_activeAlarmList.begin();
-				g_soonestAlarm = (*firstAlarm)->m_nextFire;
-			}
-			else
-			{
-				g_soonestAlarm = std::numeric_limits<uint64>::max();
-			}
+			uint64 soonestAlarm = g_alarmWheel.GetNextDeadline();
+			g_soonestAlarm = soonestAlarm;
+			_OSAlarmTimerThreadNotify(soonestAlarm);
 		}
 
 		static void updateAlarms(uint64 currentTick)
 		{
 			cemu_assert_debug(__OSHasSchedulerLock());
-			if (g_activeAlarmList.empty())
+			if (g_alarmWheel.IsEmpty())
 				return;
-
-			// debug begin
-#ifdef CEMU_DEBUG_ASSERT
-			uint64 prevTick = 0;
-			auto itr = g_activeAlarmList.begin();
-			while (itr != g_activeAlarmList.end())
+			// expired alarms are returned in order of their fire time
+			while (TimerWheelEntry* entry = g_alarmWheel.PopExpired(currentTick))
 			{
-				uint64 t = (*itr)->m_nextFire;
-				if (t < prevTick)
-					cemu_assert_suspicious();
-				prevTick = t;
-				++itr;
+				OSHostAlarm* alarm = static_cast<OSHostAlarm*>(entry);
+				uint64 fireTick = alarm->GetDeadline();
+				alarm->triggerAlarm(currentTick);
+				// if periodic alarm then requeue
+				if (alarm->m_period > 0)
+					g_alarmWheel.Insert(alarm, fireTick + alarm->m_period);
 			}
-#endif
-			// debug end
-			while (true)
-			{
-				auto firstAlarm = g_activeAlarmList.begin();
-				if (currentTick >= (*firstAlarm)->m_nextFire)
-				{
-					OSHostAlarm* alarm = *firstAlarm;
-					g_activeAlarmList.erase(firstAlarm);
-					alarm->triggerAlarm(currentTick);
-					// if periodic alarm then requeue
-					if (alarm->m_period > 0)
-					{
-						alarm->m_nextFire += alarm->m_period;
-						g_activeAlarmList.emplace(alarm);
-					}
-					else
-						alarm->m_isActive = false;
-					updateEarliestAlarmAtomic();
-				}
-				else
-					break;
-			}	
+			updateEarliestAlarmAtomic();
 		}
 
 		uint64 getNextFire() const 
 		{
-			return m_nextFire;
+			return GetDeadline();
 		}
 
 		static bool quickCheckForAlarm(uint64 currentTick)
@@ -117,40 +103,30 @@ namespace coreinit
 			return currentTick >= g_soonestAlarm;
 		}
 
+		static uint64 getSoonestAlarmTick()
+		{
+			return g_soonestAlarm;
+		}
+
         static void Reset()
         {
-            g_activeAlarmList.clear();
-            g_soonestAlarm = 0;
+            g_alarmWheel.Clear();
+            g_soonestAlarm = std::numeric_limits<uint64>::max();
         }
 
-	public:
-		struct ComparatorFireTime
-		{
-			bool operator ()(OSHostAlarm* const & p1, OSHostAlarm* const & p2) const
-			{
-				auto p1Fire = p1->getNextFire();
-				auto p2Fire = p2->getNextFire();
-				if (p1Fire == p2Fire)
-					return (uintptr_t)p1 < (uintptr_t)p2; // if time is equal, differ by pointer (to allow storing multiple alarms with same firing time)
-				return p1Fire < p2Fire;
-			}
-		};
-
-	private:	
-		uint64 m_nextFire;
+	private:
 		uint64 m_period; // if zero then repeat is disabled 
-		bool m_isActive{ false };
 
 		void (*m_callbackFunc)(uint64 currentTick, void* context);
 		void* m_context;
 
-		static std::set<class OSHostAlarm*, ComparatorFireTime> g_activeAlarmList;
+		// 64 timer ticks (~1us) resolution
+		static TimerWheel<6> g_alarmWheel;
 		static std::atomic_uint64_t g_soonestAlarm;
 	};
 
-
-	std::set<class OSHostAlarm*, OSHostAlarm::ComparatorFireTime> OSHostAlarm::g_activeAlarmList;
-	std::atomic_uint64_t OSHostAlarm::g_soonestAlarm{};
+	TimerWheel<6> OSHostAlarm::g_alarmWheel;
+	std::atomic_uint64_t OSHostAlarm::g_soonestAlarm{std::numeric_limits<uint64>::max()};
 
 	OSHostAlarm* OSHostAlarmCreate(uint64 nextFire, uint64 period, void(*callbackFunc)(uint64 currentTick, void* context), void* context)
 	{
@@ -174,6 +150,64 @@ namespace coreinit
 		__OSUnlockScheduler();
 	}
 
+	// convert guest timer ticks to host time. Takes the timer speed setting into account (see PPCTimer_getFromRDTSC)
+	std::chrono::nanoseconds _OSAlarmTicksToHostDuration(uint64 ticks)
+	{
+		// cap the wait so we regularly resync with the guest clock
+		ticks = std::min<uint64>(ticks, EspressoTime::ConvertMsToTimerTicks(100));
+		uint64 ns = ticks * 1000000000ULL / (uint64)EspressoTime::GetTimerClock();
+		ns = (ns << ActiveSettings::GetTimerShiftFactor()) >> 3;
+		return std::chrono::nanoseconds(ns);
+	}
+
+	void _OSAlarmTimerThread()
+	{
+		SetThreadName("OSAlarmTimer");
+		std::unique_lock _l(s_alarmTimerMutex);
+		while (s_alarmTimerThreadRunning)
+		{
+			s_alarmTimerWakeupTick = std::numeric_limits<uint64>::max();
+			uint64 soonestAlarm = OSHostAlarm::getSoonestAlarmTick();
+			if (soonestAlarm == std::numeric_limits<uint64>::max())
+			{
+				s_alarmTimerWakeupTick = soonestAlarm;
+				s_alarmTimerCondVar.wait(_l);
+				continue;
+			}
+			uint64 currentTick = OSGetTime();
+			if (currentTick >= soonestAlarm)
+			{
+				_l.unlock();
+				alarm_update();
+				__OSWakeMainCoreIdle();
+				_l.lock();
+				continue;
+			}
+			s_alarmTimerWakeupTick = soonestAlarm;
+			s_alarmTimerCondVar.wait_for(_l, _OSAlarmTicksToHostDuration(soonestAlarm - currentTick));
+		}
+	}
+
+	void _OSAlarmTimerThreadStart()
+	{
+		std::unique_lock _l(s_alarmTimerMutex);
+		if (s_alarmTimerThreadRunning)
+			return;
+		s_alarmTimerThreadRunning = true;
+		s_alarmTimerThread = std::thread(_OSAlarmTimerThread);
+	}
+
+	void _OSAlarmTimerThreadStop()
+	{
+		std::unique_lock _l(s_alarmTimerMutex);
+		if (!s_alarmTimerThreadRunning)
+			return;
+		s_alarmTimerThreadRunning = false;
+		s_alarmTimerCondVar.notify_one();
+		_l.unlock();
+		s_alarmTimerThread.join();
+	}
+
 	/* alarm API */
 
 	void OSCreateAlarm(OSAlarm_t* alarm)
@@ -290,12 +324,8 @@ namespace coreinit
 
 	void OSAlarm_Shutdown()
 	{
+		_OSAlarmTimerThreadStop();
         __OSLockScheduler();
-        if(g_activeAlarms.empty())
-        {
-            __OSUnlockScheduler();
-            return;
-        }
         for(auto& itr : g_activeAlarms)
         {
             OSHostAlarmDestroy(itr.second);
@@ -370,5 +400,7 @@ namespace coreinit
 		OSResumeThread(g_alarmThread.GetPtr());
 		strcpy(_g_alarmThreadName.GetPtr(), "Alarm Thread");
 		coreinit::OSSetThreadName(g_alarmThread.GetPtr(), _g_alarmThreadName.GetPtr());
+
+		_OSAlarmTimerThreadStart();
 	}
 }
@@ -14,6 +14,7 @@
 #include "util/Fiber/Fiber.h"
 
 #include "util/helpers/helpers.h"
+#include "util/TraceRecorder/TraceRecorder.h"
 
 #ifdef __arm64__
 #if defined(__clang__)
@@ -249,6 +250,7 @@ namespace coreinit
 
 	// thread
 	OSThread_t* __currentCoreThread[3] = {};
+	PPCInterpreter_t* __currentCoreInstance[3] = {};
 
 	void OSSetCurrentThread(uint32 coreIndex, OSThread_t* thread)
 	{
@@ -256,6 +258,16 @@ namespace coreinit
 			__currentCoreThread[coreIndex] = thread;
 	}
 
+	OSThread_t* __OSGetCoreThread(uint32 coreIndex)
+	{
+		return __currentCoreThread[coreIndex];
+	}
+
+	PPCInterpreter_t* __OSGetCoreInstance(uint32 coreIndex)
+	{
+		return __currentCoreInstance[coreIndex];
+	}
+
 	OSThread_t* OSGetCurrentThread()
 	{
 		PPCInterpreter_t* currentInstance = PPCInterpreter_getCurrentInstance();
@@ -1193,6 +1205,7 @@ namespace coreinit
 		thread->totalCycles += (uint64)executedCycles;
 		// store context and set current thread to null
 		__OSThreadStoreContext(hCPU, thread);
+		__currentCoreInstance[OSGetCoreId()] = nullptr;
 		OSSetCurrentThread(OSGetCoreId(), nullptr);
 		PPCInterpreter_setCurrentInstance(nullptr);
 	}
@@ -1207,6 +1220,7 @@ namespace coreinit
 		hCPU->coreInterruptMask = 1;
 		PPCInterpreter_setCurrentInstance(hCPU);
 		OSSetCurrentThread(OSGetCoreId(), thread);
+		__currentCoreInstance[coreIndex] = hCPU;
 		__OSThreadLoadContext(hCPU, thread);
 		thread->context.upir = coreIndex;
 		thread->quantumTicks = ppcThreadQuantum;
@@ -1216,10 +1230,13 @@ namespace coreinit
 	}
 
 	uint32 s_lehmer_lcg[PPC_CORE_COUNT] = { 0 };
+	HRTick s_traceTimesliceStart[PPC_CORE_COUNT] = { 0 };
 
 	void __OSThreadStartTimeslice(OSThread_t* thread, PPCInterpreter_t* hCPU)
 	{
 		uint32 coreIndex = PPCInterpreter_getCoreIndex(hCPU);
+		if (TraceRecorder::IsRecording())
+			s_traceTimesliceStart[coreIndex] = HighResolutionTimer::now().getTick();
 		// run one timeslice
 		hCPU->remainingCycles = ppcThreadQuantum;
 		hCPU->skippedCycles = 0;
@@ -1280,6 +1297,13 @@ namespace coreinit
 		nnNfp_update();
 	}
 
+	// called by the alarm timer thread after alarms expired, so the idle main core services system events right away
+	void __OSWakeMainCoreIdle()
+	{
+		if (g_isMulticoreMode)
+			g_coreRunQueueThreadCount[1].wakeup();
+	}
+
 	Fiber* g_idleLoopFiber[3]{};
 
 	// idle fiber per core if no thread is runnable
@@ -1307,6 +1331,15 @@ namespace coreinit
 				__OSCheckSystemEvents();
 				if(g_isMulticoreMode == false)
 					coreIndex = (coreIndex + 1) % 3;
+				else
+				{
+					// sleep until the next AX update is due or until a thread becomes runnable on this core
+					// the alarm timer thread wakes us up when alarms expire (see __OSWakeMainCoreIdle)
+					// in single-core mode threads can become runnable on any of the three run queues, so we keep polling there
+					auto waitDuration = snd_core::AXOut_getTimeUntilNextUpdate();
+					if (waitDuration >= std::chrono::microseconds(200))
+						g_coreRunQueueThreadCount[coreIndex].waitUntilNonZeroWithTimeout(waitDuration);
+				}
 			}
 			else
 			{
@@ -1325,6 +1358,15 @@ namespace coreinit
 		OSHostThread* hostThread = (OSHostThread*)Fiber::GetFiberPrivateData();
         cemu_assert_debug(hostThread);
 
+		// timeslices show up on the track of the host thread emulating the core, the guest thread is passed as argument
+		uint32 traceCoreIndex = PPCInterpreter_getCoreIndex(&hostThread->ppcInstance);
+		if (s_traceTimesliceStart[traceCoreIndex] != 0)
+		{
+			static constexpr const char* s_traceCoreNames[PPC_CORE_COUNT] = { "Core0", "Core1", "Core2" };
+			TraceRecorder::CompleteEvent("ppc", s_traceCoreNames[traceCoreIndex], s_traceTimesliceStart[traceCoreIndex], HighResolutionTimer::now().getTick(), "thread", memory_getVirtualOffsetFromPointer(hostThread->m_thread), TraceRecorder::ArgFormat::Hex);
+			s_traceTimesliceStart[traceCoreIndex] = 0;
+		}
+
 		//if (ppcInterpreterCurrentInstance)
 		//	debug_printf("Core %d store thread %08x (t = %d)\n", hostThread->ppcInstance.sprNew.UPIR, memory_getVirtualOffsetFromPointer(hostThread->thread), t_assignedCoreIndex);
 
@@ -1519,6 +1561,20 @@ namespace coreinit
 		s_threadToFiber.clear();
 	}
 
+	void __OSForEachSchedulerHostThread(const std::function<void(std::thread::native_handle_type handle, uint32 firstCoreIndex, uint32 coreCount)>& fn)
+	{
+		std::unique_lock _lock(sSchedulerStateMtx);
+		if (!sSchedulerActive.load())
+			return;
+		if (g_isMulticoreMode)
+		{
+			for (size_t i = 0; i < sSchedulerThreads.size(); i++)
+				fn(sSchedulerThreads[i].native_handle(), (uint32)i, 1);
+		}
+		else if (!sSchedulerThreads.empty())
+			fn(sSchedulerThreads[0].native_handle(), 0, PPC_CORE_COUNT);
+	}
+
 	SysAllocator<OSThread_t, PPC_CORE_COUNT> s_defaultThreads;
 	SysAllocator<uint8, PPC_CORE_COUNT * 1024 * 1024> s_stack;
 
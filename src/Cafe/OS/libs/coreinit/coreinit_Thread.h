@@ -526,6 +526,13 @@ namespace coreinit
 	OSThread_t* OSGetCurrentThread();
 	void OSSetCurrentThread(uint32 coreIndex, OSThread_t* thread);
 
+	// thread and ppc instance loaded on a core. Used by the sampling profiler, only consistent while the host thread emulating the core is interrupted
+	OSThread_t* __OSGetCoreThread(uint32 coreIndex);
+	PPCInterpreter_t* __OSGetCoreInstance(uint32 coreIndex);
+	// calls fn for every host thread emulating PPC cores, along with the range of cores it runs. The threads can't exit while fn runs
+	void __OSForEachSchedulerHostThread(const std::function<void(std::thread::native_handle_type handle, uint32 firstCoreIndex, uint32 coreCount)>& fn);
+	void __OSWakeMainCoreIdle();
+
 	void __OSSetThreadBasePriority(OSThread_t* thread, sint32 newPriority);
 	void __OSUpdateThreadEffectivePriority(OSThread_t* thread);
 
@@ -40,13 +40,21 @@ namespace coreinit
 
 		inline TimerTicks ConvertNsToTimerTicks(uint64 ns)
 		{
-			return static_cast<TimerTicks>((static_cast<uint64>(GetTimerClock()) / 31250ULL) * (ns) / 32000ULL);
+			// split into whole seconds and remainder so that the multiplication can't overflow for long timeouts
+			const uint64 timerClock = static_cast<uint64>(GetTimerClock());
+			return static_cast<TimerTicks>((ns / 1000000000ULL) * timerClock + (ns % 1000000000ULL) * timerClock / 1000000000ULL);
 		}
 
 		inline TimerTicks ConvertMsToTimerTicks(uint64 ms)
 		{
 			return static_cast<TimerTicks>(ms * static_cast<uint64>(GetTimerClock()) / 1000ULL);
 		}
+
+		inline uint64 ConvertTimerTicksToNs(uint64 ticks)
+		{
+			const uint64 timerClock = static_cast<uint64>(GetTimerClock());
+			return (ticks / timerClock) * 1000000000ULL + (ticks % timerClock) * 1000000000ULL / timerClock;
+		}
 	};
 
 	void OSTicksToCalendarTime(uint64 ticks, OSCalendarTime_t* calenderStruct);
@@ -1,5 +1,6 @@
 #include "Cafe/OS/common/OSCommon.h"
 #include "nsysnet.h"
+#include "nsysnet_Reactor.h"
 #include "Cafe/OS/libs/coreinit/coreinit_Thread.h"
 #include "Cafe/IOSU/legacy/iosu_crypto.h"
 #include "Cafe/OS/libs/coreinit/coreinit_Time.h"
@@ -74,6 +75,7 @@
 #define WU_SO_ECONNRESET	0x0008
 #define WU_SO_ENOTCONN		0x0009
 #define WU_SO_EINVAL		0x000B
+#define WU_SO_ENOTSOCK		0x0018
 #define WU_SO_EINPROGRESS	0x0016
 #define WU_SO_EAFNOSUPPORT  0x0021
 
@@ -191,6 +193,8 @@ typedef struct
 	SOCKET s;
 	// socket options
 	bool isNonBlocking;
+	// handles are reused after close, this identifies the socket instance
+	uint32 serial;
 }virtualSocket_t;
 
 typedef struct
@@ -231,6 +235,7 @@ struct wu_addrinfo
 #define WU_SOCKET_LIMIT			(32) // only 32 socket handles are supported per running process
 
 virtualSocket_t* virtualSocketTable[WU_SOCKET_LIMIT] = { 0 };
+uint32 virtualSocketSerialCounter = 0;
 
 sint32 _getFreeSocketHandle()
 {
@@ -260,6 +265,7 @@ WUSOCKET nsysnet_createVirtualSocket(sint32 family, sint32 type, sint32 protocol
 	vs->type = type;
 	vs->protocol = protocol;
 	vs->handle = s;
+	vs->serial = ++virtualSocketSerialCounter;
 	virtualSocketTable[s - 1] = vs;
 	// init host socket
 	vs->s = socket(family, type, protocol);
@@ -317,6 +323,7 @@ WUSOCKET nsysnet_createVirtualSocketFromExistingSocket(SOCKET existingSocket)
 #endif
 
 	vs->handle = s;
+	vs->serial = ++virtualSocketSerialCounter;
 	virtualSocketTable[s - 1] = vs;
 	vs->s = existingSocket;
 	return vs->handle;
@@ -452,6 +459,7 @@ void nsysnetExport_socketclose(PPCInterpreter_t* hCPU)
 	virtualSocket_t* vs = nsysnet_getVirtualSocketObject(s);
 	if (vs)
 	{
+		nsysnet::NetReactor::CancelSocket(vs->s); // wake up threads which are blocked on this socket
 		closesocket(vs->s);
 		free(vs);
 		virtualSocketTable[s - 1] = NULL;
@@ -893,6 +901,58 @@ void nsysnetExport_listen(PPCInterpreter_t* hCPU)
 	osLib_returnFromFunction(hCPU, r);
 }
 
+void _setSocketSendRecvNonBlockingMode(SOCKET s, bool isNonBlocking)
+{
+	u_long mode = isNonBlocking ? 1 : 0;
+	_socket_nonblock(s, mode);
+}
+
+#define _WAIT_INFINITE	(0xFFFFFFFFFFFFFFFFull)
+
+void _signalReactorWaiter(nsysnet::NetReactor::Waiter* waiter)
+{
+	coreinit::OSSignalEvent((coreinit::OSEvent*)waiter->userData);
+}
+
+// park the current guest thread until the reactor reports one of the sockets as ready or the timeout (in nanoseconds) expires
+// returns false on timeout. Readiness is only a hint, the caller has to retry the operation in non-blocking mode
+bool _waitForSockets(nsysnet::NetReactor::Waiter& waiter, uint64 timeoutNs)
+{
+	StackAllocator<coreinit::OSEvent> readyEvent;
+	coreinit::OSInitEvent(readyEvent.GetPointer(), coreinit::OSEvent::EVENT_STATE::STATE_NOT_SIGNALED, coreinit::OSEvent::EVENT_MODE::MODE_AUTO);
+	waiter.notify = _signalReactorWaiter;
+	waiter.userData = readyEvent.GetPointer();
+	nsysnet::NetReactor& reactor = nsysnet::NetReactor::GetInstance();
+	reactor.Register(&waiter);
+	bool isReady = true;
+	if (timeoutNs == _WAIT_INFINITE)
+		coreinit::OSWaitEvent(readyEvent.GetPointer());
+	else
+		isReady = coreinit::OSWaitEventWithTimeout(readyEvent.GetPointer(), timeoutNs);
+	reactor.Unregister(&waiter);
+	return isReady;
+}
+
+void _waitForSocket(SOCKET s, uint8 waitFlags)
+{
+	nsysnet::NetReactor::Waiter waiter;
+	waiter.entries.emplace_back(s, waitFlags);
+	_waitForSockets(waiter, _WAIT_INFINITE);
+}
+
+// park the current guest thread until the virtual socket is ready
+// another guest thread may close the socket in the meantime, which also wakes us up. In that case nullptr is returned and the old object must not be accessed anymore
+virtualSocket_t* _waitForVirtualSocket(virtualSocket_t* vs, uint8 waitFlags)
+{
+	WUSOCKET handle = vs->handle;
+	uint32 serial = vs->serial;
+	_waitForSocket(vs->s, waitFlags);
+	vs = nsysnet_getVirtualSocketObject(handle);
+	if (!vs || vs->serial != serial)
+		return nullptr;
+	return vs;
+}
+
 void nsysnetExport_accept(PPCInterpreter_t* hCPU)
 {
 	cemuLog_log(LogType::Socket, "accept({},0x{:08x},0x{:08x})", hCPU->gpr[3], hCPU->gpr[4], hCPU->gpr[5]);
@@ -917,28 +977,45 @@ void nsysnetExport_accept(PPCInterpreter_t* hCPU)
 		return;
 	}
 
-	if (vs->isNonBlocking)
+	// for blocking sockets the host socket is polled in non-blocking mode while the thread is parked until a connection is pending
+	if (!vs->isNonBlocking)
+		_setSocketSendRecvNonBlockingMode(vs->s, true);
+	sockaddr hostAddr;
+	socklen_t hostLen;
+	SOCKET hr;
+	sint32 wsaError;
+	while (true)
 	{
-		sockaddr hostAddr;
-		socklen_t hostLen = sizeof(sockaddr);
-		SOCKET hr = accept(vs->s, &hostAddr, &hostLen);
-		if (hr != SOCKET_ERROR)
-		{
-			r = nsysnet_createVirtualSocketFromExistingSocket(hr);
-			_setSockError(WU_SO_SUCCESS);
-		}
-		else
+		hostLen = sizeof(sockaddr);
+		hr = accept(vs->s, &hostAddr, &hostLen);
+		wsaError = GETLASTERR;
+		if (vs->isNonBlocking || hr != SOCKET_ERROR || wsaError != WSAEWOULDBLOCK)
+			break;
+		vs = _waitForVirtualSocket(vs, nsysnet::NetReactor::WAIT_READ);
+		if (!vs)
 		{
-			r = _translateError((sint32)hr, (sint32)GETLASTERR, _ERROR_MODE_ACCEPT);
+			_setSockError(WU_SO_ENOTSOCK);
+			osLib_returnFromFunction(hCPU, -1);
+			return;
 		}
-		sockaddr_host2guest(&hostAddr, addr);
+	}
+	if (!vs->isNonBlocking)
+	{
+		_setSocketSendRecvNonBlockingMode(vs->s, false);
+		// on some platforms accepted sockets inherit the non-blocking mode of the listening socket
+		if (hr != SOCKET_ERROR)
+			_setSocketSendRecvNonBlockingMode(hr, false);
+	}
+	if (hr != SOCKET_ERROR)
+	{
+		r = nsysnet_createVirtualSocketFromExistingSocket(hr);
+		_setSockError(WU_SO_SUCCESS);
 	}
 	else
 	{
-		// blocking accept is not supported yet
-		cemuLog_log(LogType::Force, "blocking accept() not supported");
-		cemu_assert_debug(false);
+		r = _translateError((sint32)hr, wsaError, _ERROR_MODE_ACCEPT);
 	}
+	sockaddr_host2guest(&hostAddr, addr);
 
 	osLib_returnFromFunction(hCPU, r);
 }
@@ -971,12 +1048,6 @@ void nsysnetExport_connect(PPCInterpreter_t* hCPU)
 	osLib_returnFromFunction(hCPU, r);
 }
 
-void _setSocketSendRecvNonBlockingMode(SOCKET s, bool isNonBlocking)
-{
-	u_long mode = isNonBlocking ? 1 : 0;
-	sint32 r = _socket_nonblock(s,  mode);
-}
-
 void nsysnetExport_send(PPCInterpreter_t* hCPU)
 {
 	cemuLog_log(LogType::Socket, "send({},0x{:08x},{},0x{:x})", hCPU->gpr[3], hCPU->gpr[4], hCPU->gpr[5], hCPU->gpr[6]);
@@ -1054,9 +1125,14 @@ void nsysnetExport_recv(PPCInterpreter_t* hCPU)
 				break; // connection closed
 			if (tr < 0 && GETLASTERR != WSAEWOULDBLOCK)
 				break;
-			// yield thread
-			coreinit::OSSleepTicks(coreinit::EspressoTime::GetTimerClock() / 5000); // let thread wait 0.2ms to give other threads CPU time
-			// todo - eventually we should find a way to asynchronously signal recv instead of busy-looping here
+			// park thread until data arrives
+			vs = _waitForVirtualSocket(vs, nsysnet::NetReactor::WAIT_READ);
+			if (!vs)
+			{
+				_setSockError(WU_SO_ENOTSOCK);
+				osLib_returnFromFunction(hCPU, -1);
+				return;
+			}
 		}
 		_setSocketSendRecvNonBlockingMode(vs->s, requestIsNonBlocking);
 	}
@@ -1139,6 +1215,22 @@ void _translateFDSetRev(struct wu_fd_set* fdset, fd_set* hostSet, sint32 nfds)
 
 }
 
+void _addFDSetToWaiter(nsysnet::NetReactor::Waiter& waiter, struct wu_fd_set* fdset, sint32 nfds, uint8 waitFlags)
+{
+	if (fdset == NULL)
+		return;
+	uint32 mask = fdset->mask;
+	for (sint32 i = 0; i < nfds; i++)
+	{
+		if (((mask >> i) & 1) == 0)
+			continue;
+		virtualSocket_t* vs = nsysnet_getVirtualSocketObject(i);
+		if (vs == NULL)
+			continue;
+		waiter.entries.emplace_back(vs->s, waitFlags);
+	}
+}
+
 void nsysnetExport_select(PPCInterpreter_t* hCPU)
 {
 	cemuLog_log(LogType::Socket, "select({},0x{:08x},0x{:08x},0x{:08x},0x{:08x})", hCPU->gpr[3], hCPU->gpr[4], hCPU->gpr[5], hCPU->gpr[6], hCPU->gpr[7]);
@@ -1175,10 +1267,9 @@ void nsysnetExport_select(PPCInterpreter_t* hCPU)
 			// when fd sets are empty but timeout is set, then just wait and do nothing?
 			// Lost Reavers seems to expect this case to return 0 (it hardcodes empty fd sets and timeout comes from curl_multi_timeout)
 
-			timeval tv;
-			tv.tv_sec = timeOut->tv_sec;
-			tv.tv_usec = timeOut->tv_usec;
-			select(0, nullptr, nullptr, nullptr, &tv);
+			// sleep on the guest side so other threads on this core keep running
+			uint64 timeoutNs = (uint64)_swapEndianU32(timeOut->tv_sec) * 1000000000ull + (uint64)_swapEndianU32(timeOut->tv_usec) * 1000ull;
+			coreinit::OSSleepTicks(coreinit::EspressoTime::ConvertNsToTimerTicks(timeoutNs));
 			cemuLog_log(LogType::Socket, "select returned 0 because of empty fdsets with timeout");
 			osLib_returnFromFunction(hCPU, 0);
 			
@@ -1198,8 +1289,8 @@ void nsysnetExport_select(PPCInterpreter_t* hCPU)
 		return;
 	}
 
-	uint64 msTimeout = (_swapEndianU32(timeOut->tv_usec) / 1000) + (_swapEndianU32(timeOut->tv_sec) * 1000);
-	uint32 startTime = GetTickCount();
+	uint64 timeoutNs = (uint64)_swapEndianU32(timeOut->tv_sec) * 1000000000ull + (uint64)_swapEndianU32(timeOut->tv_usec) * 1000ull;
+	uint64 deadline = coreinit::OSGetTime() + coreinit::EspressoTime::ConvertNsToTimerTicks(timeoutNs);
 	while (true)
 	{
 		int hostnfds = -1;
@@ -1225,7 +1316,8 @@ void nsysnetExport_select(PPCInterpreter_t* hCPU)
 		else if (r == 0)
 		{
 			// check for timeout
-			if ((GetTickCount() - startTime) >= msTimeout )
+			uint64 currentTime = coreinit::OSGetTime();
+			if (currentTime >= deadline)
 			{
 				// timeout
 				_setSockError(WU_SO_SUCCESS);
@@ -1239,8 +1331,19 @@ void nsysnetExport_select(PPCInterpreter_t* hCPU)
 					exceptfds->mask = 0;
 				break;
 			}
-			// yield thread
-			PPCCore_switchToScheduler();
+			// park thread until the reactor reports one of the sockets as ready or the timeout expires
+			nsysnet::NetReactor::Waiter waiter;
+			_addFDSetToWaiter(waiter, readfds, nfds, nsysnet::NetReactor::WAIT_READ);
+			_addFDSetToWaiter(waiter, writefds, nfds, nsysnet::NetReactor::WAIT_WRITE);
+			_addFDSetToWaiter(waiter, exceptfds, nfds, nsysnet::NetReactor::WAIT_EXCEPT);
+			if (waiter.entries.empty())
+			{
+				// none of the handles refers to a valid socket
+				PPCCore_switchToScheduler();
+				continue;
+			}
+			uint64 remainingTicks = deadline - currentTime;
+			_waitForSockets(waiter, coreinit::EspressoTime::ConvertTimerTicksToNs(remainingTicks));
 		}
 		else
 		{
@@ -1661,9 +1764,14 @@ void nsysnetExport_recvfrom(PPCInterpreter_t* hCPU)
 		}
 		else
 		{
-			// pause for a while and check again later
-			coreinit::OSSleepTicks(ESPRESSO_CORE_CLOCK / 1000); // pause for 1ms
-			PPCCore_switchToScheduler();
+			// park thread until data arrives
+			vs = _waitForVirtualSocket(vs, nsysnet::NetReactor::WAIT_READ | nsysnet::NetReactor::WAIT_EXCEPT);
+			if (!vs)
+			{
+				_setSockError(WU_SO_ENOTSOCK);
+				osLib_returnFromFunction(hCPU, -1);
+				return;
+			}
 		}
 	}
 	assert_dbg(); // should no longer be reached
@@ -1813,9 +1921,14 @@ void nsysnetExport_recvfrom_ex(PPCInterpreter_t* hCPU)
 		}
 		else
 		{
-			// pause for a while and check again later
-			coreinit::OSSleepTicks(ESPRESSO_CORE_CLOCK / 100); // pause for 10ms
-			PPCCore_switchToScheduler();
+			// park thread until data arrives
+			vs = _waitForVirtualSocket(vs, nsysnet::NetReactor::WAIT_READ | nsysnet::NetReactor::WAIT_EXCEPT);
+			if (!vs)
+			{
+				_setSockError(WU_SO_ENOTSOCK);
+				osLib_returnFromFunction(hCPU, -1);
+				return;
+			}
 		}
 	}
 	cemu_assert_debug(false); // should no longer be reached
@@ -1876,8 +1989,14 @@ void nsysnetExport_sendto(PPCInterpreter_t* hCPU)
 			{
 				if (wsaError != WSAEWOULDBLOCK)
 					break;
-				coreinit::OSSleepTicks(ESPRESSO_CORE_CLOCK / 100); // pause for 10ms
-				PPCCore_switchToScheduler();
+				// park thread until the send buffer has space again
+				vs = _waitForVirtualSocket(vs, nsysnet::NetReactor::WAIT_WRITE);
+				if (!vs)
+				{
+					_setSockError(WU_SO_ENOTSOCK);
+					osLib_returnFromFunction(hCPU, -1);
+					return;
+				}
 				continue;
 			}
 			break;
@@ -0,0 +1,215 @@
+#include "nsysnet_Reactor.h"
+#include "util/helpers/helpers.h"
+
+#if BOOST_OS_UNIX
+#include <poll.h>
+#include <arpa/inet.h>
+#endif
+
+#if BOOST_OS_WINDOWS
+#define poll WSAPoll
+#endif
+
+namespace nsysnet
+{
+	static std::atomic<NetReactor*> s_reactorInstance{nullptr};
+
+	NetReactor& NetReactor::GetInstance()
+	{
+		static NetReactor s_reactor;
+		return s_reactor;
+	}
+
+	void NetReactor::CancelSocket(SOCKET s)
+	{
+		NetReactor* reactor = s_reactorInstance.load();
+		if (!reactor)
+			return;
+		std::unique_lock _l(reactor->m_mutex);
+		for (size_t i = 0; i < reactor->m_waiters.size();)
+		{
+			Waiter* waiter = reactor->m_waiters[i];
+			bool isWatched = false;
+			for (auto& entry : waiter->entries)
+			{
+				if (entry.s != s)
+					continue;
+				entry.isReady = true;
+				isWatched = true;
+			}
+			if (isWatched)
+				reactor->NotifyAndRemove(i);
+			else
+				i++;
+		}
+		// the reactor may currently poll the socket, make it rebuild the poll list before the socket handle gets reused
+		reactor->Wakeup();
+	}
+
+	NetReactor::NetReactor()
+	{
+#if BOOST_OS_WINDOWS
+		// keep our own reference to winsock since the guest can call socket_lib_finish at any time
+		WSADATA wsa;
+		WSAStartup(MAKEWORD(2, 2), &wsa);
+#endif
+		// the reactor is woken up via a loopback UDP socket that is connected to itself
+		// unlike a pipe this can be polled on all platforms
+		m_wakeupSocket = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+		sockaddr_in addr{};
+		addr.sin_family = AF_INET;
+		addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+		addr.sin_port = 0;
+		socklen_t addrLen = sizeof(addr);
+		if (m_wakeupSocket == INVALID_SOCKET ||
+			bind(m_wakeupSocket, (sockaddr*)&addr, sizeof(addr)) != 0 ||
+			getsockname(m_wakeupSocket, (sockaddr*)&addr, &addrLen) != 0 ||
+			connect(m_wakeupSocket, (sockaddr*)&addr, sizeof(addr)) != 0)
+		{
+			cemuLog_log(LogType::Force, "nsysnet: Failed to create reactor wakeup socket (error {})", GETLASTERR);
+		}
+#if BOOST_OS_WINDOWS
+		u_long nonBlocking = 1;
+		ioctlsocket(m_wakeupSocket, FIONBIO, &nonBlocking);
+#else
+		fcntl(m_wakeupSocket, F_SETFL, fcntl(m_wakeupSocket, F_GETFL) | O_NONBLOCK);
+#endif
+		m_thread = std::thread(&NetReactor::ReactorThread, this);
+		s_reactorInstance = this;
+	}
+
+	NetReactor::~NetReactor()
+	{
+		s_reactorInstance = nullptr;
+		{
+			std::unique_lock _l(m_mutex);
+			m_isRunning = false;
+			Wakeup();
+		}
+		m_thread.join();
+		if (m_wakeupSocket != INVALID_SOCKET)
+			closesocket(m_wakeupSocket);
+#if BOOST_OS_WINDOWS
+		WSACleanup();
+#endif
+	}
+
+	void NetReactor::Register(Waiter* waiter)
+	{
+		cemu_assert_debug(!waiter->entries.empty());
+		for (auto& entry : waiter->entries)
+			entry.isReady = false;
+		std::unique_lock _l(m_mutex);
+		m_waiters.emplace_back(waiter);
+		Wakeup();
+	}
+
+	void NetReactor::Unregister(Waiter* waiter)
+	{
+		// no need to wake the reactor. If it still polls the sockets of this waiter it will rebuild the poll list on the next event
+		std::unique_lock _l(m_mutex);
+		auto it = std::find(m_waiters.begin(), m_waiters.end(), waiter);
+		if (it != m_waiters.end())
+			m_waiters.erase(it);
+	}
+
+	void NetReactor::Wakeup()
+	{
+		uint8 wakeupByte = 0;
+		send(m_wakeupSocket, (const char*)&wakeupByte, 1, 0);
+	}
+
+	void NetReactor::DrainWakeupSocket()
+	{
+		uint8 buffer[64];
+		while (recv(m_wakeupSocket, (char*)buffer, sizeof(buffer), 0) > 0) {};
+	}
+
+	void NetReactor::NotifyAndRemove(size_t waiterIndex)
+	{
+		Waiter* waiter = m_waiters[waiterIndex];
+		m_waiters.erase(m_waiters.begin() + waiterIndex);
+		waiter->notify(waiter);
+	}
+
+	void NetReactor::ReactorThread()
+	{
+		SetThreadName("NetReactor");
+		struct PollOwner
+		{
+			Waiter* waiter;
+			size_t entryIndex;
+		};
+		std::vector<pollfd> pollFds;
+		std::vector<PollOwner> pollOwners;
+		while (true)
+		{
+			pollFds.clear();
+			pollOwners.clear();
+			pollFds.push_back({m_wakeupSocket, POLLIN, 0});
+			pollOwners.push_back({nullptr, 0});
+			{
+				std::unique_lock _l(m_mutex);
+				if (!m_isRunning)
+					break;
+				for (Waiter* waiter : m_waiters)
+				{
+					for (size_t i = 0; i < waiter->entries.size(); i++)
+					{
+						const WaitEntry& entry = waiter->entries[i];
+						short events = 0;
+						if (entry.waitFlags & WAIT_READ)
+							events |= POLLIN;
+						if (entry.waitFlags & WAIT_WRITE)
+							events |= POLLOUT;
+#if BOOST_OS_UNIX
+						// WSAPoll rejects POLLPRI. Errors and hangups are always reported
+						if (entry.waitFlags & WAIT_EXCEPT)
+							events |= POLLPRI;
+#endif
+						pollFds.push_back({entry.s, events, 0});
+						pollOwners.push_back({waiter, i});
+					}
+				}
+			}
+#if BOOST_OS_WINDOWS
+			int r = poll(pollFds.data(), (ULONG)pollFds.size(), -1);
+#else
+			int r = poll(pollFds.data(), (nfds_t)pollFds.size(), -1);
+#endif
+			if (r < 0)
+			{
+#if BOOST_OS_UNIX
+				if (errno == EINTR)
+					continue;
+#endif
+				cemuLog_log(LogType::Socket, "NetReactor: poll() failed with error {}", GETLASTERR);
+				std::this_thread::sleep_for(std::chrono::milliseconds(1));
+				continue;
+			}
+			if (pollFds[0].revents != 0)
+				DrainWakeupSocket();
+			std::unique_lock _l(m_mutex);
+			for (size_t i = 1; i < pollFds.size(); i++)
+			{
+				if (pollFds[i].revents == 0)
+					continue;
+				// waiters can unregister while we poll, only touch those which are still registered
+				Waiter* waiter = pollOwners[i].waiter;
+				if (std::find(m_waiters.begin(), m_waiters.end(), waiter) == m_waiters.end())
+					continue;
+				const size_t entryIndex = pollOwners[i].entryIndex;
+				if (entryIndex < waiter->entries.size() && waiter->entries[entryIndex].s == pollFds[i].fd)
+					waiter->entries[entryIndex].isReady = true;
+			}
+			for (size_t i = 0; i < m_waiters.size();)
+			{
+				Waiter* waiter = m_waiters[i];
+				if (std::any_of(waiter->entries.begin(), waiter->entries.end(), [](const WaitEntry& entry) { return entry.isReady; }))
+					NotifyAndRemove(i);
+				else
+					i++;
+			}
+		}
+	}
+}
@@ -0,0 +1,59 @@
+#pragma once
+#include "Common/socket.h"
+
+namespace nsysnet
+{
+	// host thread which watches sockets on behalf of guest threads
+	// blocking socket calls park the guest thread and let the reactor wake it up once a socket becomes ready, instead of polling from the emulated core
+	class NetReactor
+	{
+	public:
+		enum WAIT_FLAG : uint8
+		{
+			WAIT_READ = 1,
+			WAIT_WRITE = 2,
+			WAIT_EXCEPT = 4,
+		};
+
+		struct WaitEntry
+		{
+			WaitEntry(SOCKET s, uint8 waitFlags) : s(s), waitFlags(waitFlags) {};
+
+			SOCKET s;
+			uint8 waitFlags;
+			bool isReady{false}; // set by the reactor
+		};
+
+		// set of sockets a single guest thread is waiting on
+		// notify is invoked once from the reactor thread when any of the sockets becomes ready, after which the waiter is no longer registered
+		struct Waiter
+		{
+			std::vector<WaitEntry> entries;
+			void (*notify)(Waiter* waiter){};
+			void* userData{};
+		};
+
+		static NetReactor& GetInstance();
+		// wake up all waiters which watch the socket. Needs to be called before a guest socket is closed since closing it does not interrupt poll()
+		static void CancelSocket(SOCKET s);
+
+		void Register(Waiter* waiter);
+		// after this returns the reactor will no longer access the waiter or invoke its notify callback
+		void Unregister(Waiter* waiter);
+
+		~NetReactor();
+
+	private:
+		NetReactor();
+		void ReactorThread();
+		void Wakeup();
+		void DrainWakeupSocket();
+		void NotifyAndRemove(size_t waiterIndex); // assumes lock is already held
+
+		std::thread m_thread;
+		std::mutex m_mutex;
+		std::vector<Waiter*> m_waiters;
+		SOCKET m_wakeupSocket{INVALID_SOCKET};
+		bool m_isRunning{true};
+	};
+}
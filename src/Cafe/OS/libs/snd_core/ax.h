@@ -328,6 +328,9 @@ namespace snd_core
 
 	void AXMix_process(struct AXVPBInternal_t* internalShadowCopyHead);
 
+	// runs the mixer on synthetic voices and compares the output against a golden file (written if it doesn't exist)
+	bool AXMix_RunBenchmark(const fs::path& goldenFilePath);
+
 	extern FSpinlock __AXVoiceListSpinlock;
 
 	// AX multi voice
@@ -390,6 +393,7 @@ namespace snd_core
 	void AXOut_init();
 	void AXOut_reset();
 	void AXOut_update();
+	std::chrono::nanoseconds AXOut_getTimeUntilNextUpdate();
 
 	COSModule* GetModuleSndCore1();
 	COSModule* GetModuleSndCore2();
@@ -0,0 +1,304 @@
+#include "Cafe/OS/libs/snd_core/ax.h"
+#include "Cafe/OS/libs/snd_core/ax_internal.h"
+#include "Cafe/HW/MMU/MMU.h"
+#include "Common/FileStream.h"
+
+/* AX mixer benchmark
+ * Runs the PPC mixing path (voice sync + AXMix_process) on synthetic voices without a running title. Every sample format is combined with every SRC filter mode at both renderer rates
+ * The final TV and DRC output of every frame is hashed. The hashes are compared against a golden file, or written to it if the file doesn't exist yet
+ * Voice setup only uses the AX voice API, so aux and frame callbacks are never registered and no guest code runs
+ */
+
+namespace snd_core
+{
+	constexpr sint32 AX_BENCHMARK_VOICE_COUNT = 48; // enough to use multiple mix batches
+	constexpr sint32 AX_BENCHMARK_FRAME_COUNT = 2000;
+
+	struct AXBenchmarkCase
+	{
+		std::string name;
+		uint32 rendererFreq;
+		uint16 format;
+		uint32 srcType;
+	};
+
+	struct AXBenchmarkResult
+	{
+		uint64 hash;
+		double elapsedMs;
+	};
+
+	class AXBenchmarkRNG
+	{
+	public:
+		AXBenchmarkRNG(uint32 seed) : m_state(seed * 0x9E3779B9u + 0x6D2B79F5u) {}
+
+		uint32 Next()
+		{
+			m_state ^= m_state << 13;
+			m_state ^= m_state >> 17;
+			m_state ^= m_state << 5;
+			return m_state;
+		}
+
+		uint32 Range(uint32 minValue, uint32 maxValue)
+		{
+			return minValue + Next() % (maxValue - minValue + 1);
+		}
+
+	private:
+		uint32 m_state;
+	};
+
+	// synthetic sample data is placed in MEM2 with a simple bump allocator
+	class AXBenchmarkSampleHeap
+	{
+	public:
+		AXBenchmarkSampleHeap() : m_current(mmuRange_MEM2.getBase()) {}
+
+		uint8* Alloc(uint32 size)
+		{
+			MPTR addr = m_current;
+			m_current = (m_current + size + 0x3F) & ~0x3F;
+			cemu_assert(m_current <= mmuRange_MEM2.getEnd());
+			return memory_getPointerFromVirtualOffset(addr);
+		}
+
+	private:
+		MPTR m_current;
+	};
+
+	// generates a triangle wave with some noise on top
+	sint16 AXBenchmark_GenerateSample(AXBenchmarkRNG& rng, uint32 index, uint32 period)
+	{
+		sint32 phase = (sint32)(index % period);
+		sint32 half = (sint32)period / 2;
+		sint32 v = (phase < half ? phase : (sint32)period - phase) * 40000 / (sint32)period - 10000;
+		v += (sint32)(rng.Next() & 0x3FF) - 0x200;
+		return (sint16)std::clamp(v, -32768, 32767);
+	}
+
+	void AXBenchmark_SetupVoice(AXVPB* vpb, const AXBenchmarkCase& benchmarkCase, AXBenchmarkRNG& rng, AXBenchmarkSampleHeap& sampleHeap, sint32 voiceIndex)
+	{
+		static constexpr sint16 s_adpcmCoefs[16] = {0, 0, 2048, 0, 3072, -1024, 3840, -1920, 1024, 512, 1536, -256, 2560, -768, 3584, -1664};
+
+		const bool isLooped = (voiceIndex % 3) != 0;
+		const uint32 period = rng.Range(24, 400);
+		AXPBOFFSET_t offsets{};
+		offsets.format = _swapEndianU16(benchmarkCase.format);
+		offsets.loopFlag = _swapEndianU16(isLooped ? 1 : 0);
+		uint8* sampleBase;
+		if (benchmarkCase.format == AX_FORMAT_ADPCM)
+		{
+			// 8 byte frames, each with a header byte followed by 14 nibbles
+			const uint32 frameCount = rng.Range(64, 2048);
+			sampleBase = sampleHeap.Alloc(frameCount * 8);
+			for (uint32 f = 0; f < frameCount; f++)
+			{
+				sampleBase[f * 8] = (uint8)((rng.Range(0, 7) << 4) | rng.Range(0, 11));
+				for (uint32 i = 1; i < 8; i++)
+					sampleBase[f * 8 + i] = (uint8)rng.Next();
+			}
+			const uint32 loopFrame = rng.Range(0, frameCount - 1);
+			offsets.loopOffset = _swapEndianU32(loopFrame * 16 + 2);
+			offsets.endOffset = _swapEndianU32(frameCount * 16 - 1);
+			offsets.currentOffset = _swapEndianU32(2);
+			AXSetVoiceOffsetsEx(vpb, &offsets, sampleBase);
+			AXPBADPCM_t adpcm{};
+			for (sint32 i = 0; i < 16; i++)
+				adpcm.a[i] = _swapEndianU16((uint16)s_adpcmCoefs[i]);
+			adpcm.scale = _swapEndianU16(sampleBase[0]);
+			AXSetVoiceAdpcm(vpb, &adpcm);
+			AXPBADPCMLOOP_t adpcmLoop{};
+			adpcmLoop.loopScale = _swapEndianU16(sampleBase[loopFrame * 8]);
+			AXSetVoiceAdpcmLoop(vpb, &adpcmLoop);
+		}
+		else
+		{
+			const uint32 sampleCount = rng.Range(512, 16384);
+			if (benchmarkCase.format == AX_FORMAT_PCM16)
+			{
+				sampleBase = sampleHeap.Alloc(sampleCount * 2);
+				uint16be* samples = (uint16be*)sampleBase;
+				for (uint32 i = 0; i < sampleCount; i++)
+					samples[i] = (uint16)AXBenchmark_GenerateSample(rng, i, period);
+			}
+			else
+			{
+				sampleBase = sampleHeap.Alloc(sampleCount);
+				for (uint32 i = 0; i < sampleCount; i++)
+					sampleBase[i] = (uint8)(AXBenchmark_GenerateSample(rng, i, period) >> 8);
+			}
+			offsets.loopOffset = _swapEndianU32(rng.Range(0, sampleCount - 1));
+			offsets.endOffset = _swapEndianU32(sampleCount - 1);
+			offsets.currentOffset = _swapEndianU32(0);
+			AXSetVoiceOffsetsEx(vpb, &offsets, sampleBase);
+		}
+		AXSetVoiceSrcType(vpb, benchmarkCase.srcType);
+		AXSetVoiceSrcRatio(vpb, (float)rng.Range(250, 2000) / 1000.0f);
+		AXPBVE ve;
+		ve.currentVolume = (voiceIndex % 2) ? 0x8000 : (uint16)rng.Range(0x1000, 0x7000);
+		ve.currentDelta = 0;
+		AXSetVoiceVe(vpb, &ve);
+		// every voice goes to the TV and DRC main bus, some also go to the surround channels or an aux bus
+		AXCHMIX_DEPR tvMix[AX_TV_CHANNEL_COUNT * AX_BUS_COUNT]{};
+		AXCHMIX_DEPR drcMix[AX_DRC_CHANNEL_COUNT * AX_BUS_COUNT]{};
+		for (sint32 channel = 0; channel < AX_TV_CHANNEL_COUNT; channel++)
+		{
+			if (channel >= 2 && (voiceIndex % 4) != 0)
+				continue;
+			tvMix[channel * AX_BUS_COUNT + 0].vol = _swapEndianU16((uint16)rng.Range(0x800, 0x8000));
+			if ((voiceIndex % 5) == 0)
+				tvMix[channel * AX_BUS_COUNT + 1].vol = _swapEndianU16((uint16)rng.Range(0x800, 0x4000));
+		}
+		for (sint32 channel = 0; channel < 2; channel++)
+			drcMix[channel * AX_BUS_COUNT + 0].vol = _swapEndianU16((uint16)rng.Range(0x800, 0x8000));
+		AXSetVoiceDeviceMix(vpb, AX_DEV_TV, 0, tvMix);
+		AXSetVoiceDeviceMix(vpb, AX_DEV_DRC, 0, drcMix);
+		AXSetVoiceState(vpb, 1);
+	}
+
+	uint64 AXBenchmark_HashData(uint64 hash, const void* data, size_t size)
+	{
+		// FNV-1a
+		const uint8* bytes = (const uint8*)data;
+		for (size_t i = 0; i < size; i++)
+		{
+			hash ^= bytes[i];
+			hash *= 0x100000001B3ull;
+		}
+		return hash;
+	}
+
+	AXBenchmarkResult AXBenchmark_RunCase(const AXBenchmarkCase& benchmarkCase, uint32 seed)
+	{
+		sndGeneric.initParam.rendererFreq = benchmarkCase.rendererFreq;
+		sndGeneric.initParam.frameLength = AX_FRAMELENGTH_3MS;
+		sndGeneric.initParam.pipelineMode = AX_PIPELINE_SINGLE;
+		AXIst_Init();
+		AXVBP_Reset();
+		AXVPB_Init();
+		AXAux_Init();
+		AXMix_Init();
+
+		AXBenchmarkRNG rng(seed);
+		AXBenchmarkSampleHeap sampleHeap;
+		std::vector<AXVPB*> voices;
+		for (sint32 i = 0; i < AX_BENCHMARK_VOICE_COUNT; i++)
+		{
+			AXVPB* vpb = AXAcquireVoiceEx(rng.Range(AX_PRIORITY_LOWEST, AX_PRIORITY_NODROP), MPTR_NULL, MPTR_NULL);
+			cemu_assert(vpb);
+			AXBenchmark_SetupVoice(vpb, benchmarkCase, rng, sampleHeap, i);
+			voices.emplace_back(vpb);
+		}
+
+		const sint32 sampleCount = AXGetInputSamplesPerFrame();
+		uint64 hash = 0xCBF29CE484222325ull;
+		std::chrono::steady_clock::duration elapsed{};
+		for (sint32 frame = 0; frame < AX_BENCHMARK_FRAME_COUNT; frame++)
+		{
+			// periodically ramp the volume of some voices up or down for a single frame
+			if ((frame % 200) < 2)
+			{
+				for (size_t i = 1; i < voices.size(); i += 4)
+				{
+					AXPBVE ve;
+					ve.currentVolume = 0x4000;
+					ve.currentDelta = (frame % 200) == 0 ? ((frame / 200) % 2 ? 4 : -4) : 0;
+					AXSetVoiceVe(voices[i], &ve);
+				}
+			}
+			memset(__AXTVOutputBuffer.GetPtr(), 0, AX_SAMPLES_MAX * AX_TV_CHANNEL_COUNT * sizeof(sint32));
+			memset(__AXDRCOutputBuffer.GetPtr(), 0, AX_SAMPLES_MAX * AX_DRC_CHANNEL_COUNT * sizeof(sint32));
+			auto startTime = std::chrono::steady_clock::now();
+			AXVPBInternal_t* internalShadowCopyDSPHead = nullptr;
+			AXVPBInternal_t* internalShadowCopyPPCHead = nullptr;
+			AXIst_SyncVPB(&internalShadowCopyDSPHead, &internalShadowCopyPPCHead);
+			AXMix_process(internalShadowCopyPPCHead);
+			elapsed += std::chrono::steady_clock::now() - startTime;
+			hash = AXBenchmark_HashData(hash, __AXTVOutputBuffer.GetPtr(), sampleCount * AX_TV_CHANNEL_COUNT * sizeof(sint32));
+			hash = AXBenchmark_HashData(hash, __AXDRCOutputBuffer.GetPtr(), sampleCount * AX_DRC_CHANNEL_COUNT * sizeof(sint32));
+		}
+		AXVBP_Reset();
+		return {hash, std::chrono::duration<double, std::milli>(elapsed).count()};
+	}
+
+	std::unordered_map<std::string, uint64> AXBenchmark_LoadGoldenFile(const fs::path& path)
+	{
+		std::unordered_map<std::string, uint64> hashes;
+		std::unique_ptr<FileStream> file(FileStream::openFile2(path));
+		if (!file)
+			return hashes;
+		std::string line;
+		while (file->readLine(line))
+		{
+			auto separator = line.find(' ');
+			if (separator == std::string::npos)
+				continue;
+			hashes.emplace(line.substr(0, separator), std::stoull(line.substr(separator + 1), nullptr, 16));
+		}
+		return hashes;
+	}
+
+	bool AXMix_RunBenchmark(const fs::path& goldenFilePath)
+	{
+		memory_init();
+		if (!mmuRange_MEM2.isMapped())
+			mmuRange_MEM2.mapMem();
+		SysAllocatorContainer::GetInstance().Initialize();
+
+		std::vector<AXBenchmarkCase> benchmarkCases;
+		for (uint32 rendererFreq : {AX_RENDERER_FREQ_32KHZ, AX_RENDERER_FREQ_48KHZ})
+		{
+			for (auto [formatName, format] : {std::pair{"adpcm", AX_FORMAT_ADPCM}, std::pair{"pcm8", AX_FORMAT_PCM8}, std::pair{"pcm16", AX_FORMAT_PCM16}})
+			{
+				for (auto [srcName, srcType] : {std::pair{"tap", AX_SRC_TYPE_LOWPASS1}, std::pair{"linear", AX_SRC_TYPE_LINEAR}, std::pair{"none", AX_SRC_TYPE_NONE}})
+					benchmarkCases.push_back({fmt::format("{}_{}_{}k", formatName, srcName, rendererFreq == AX_RENDERER_FREQ_48KHZ ? 48 : 32), rendererFreq, (uint16)format, (uint32)srcType});
+			}
+		}
+
+		const auto goldenHashes = AXBenchmark_LoadGoldenFile(goldenFilePath);
+		const bool writeGoldenFile = goldenHashes.empty();
+		std::string goldenFileContent;
+		bool allMatched = true;
+		double totalMs = 0.0;
+		fmt::print("AX mixer benchmark: {} voices, {} frames per case\n", AX_BENCHMARK_VOICE_COUNT, AX_BENCHMARK_FRAME_COUNT);
+		for (size_t i = 0; i < benchmarkCases.size(); i++)
+		{
+			const AXBenchmarkCase& benchmarkCase = benchmarkCases[i];
+			AXBenchmarkResult result = AXBenchmark_RunCase(benchmarkCase, (uint32)i + 1);
+			totalMs += result.elapsedMs;
+			const double audioMs = AX_BENCHMARK_FRAME_COUNT * 3.0;
+			const double voiceFramesPerSec = (double)AX_BENCHMARK_VOICE_COUNT * AX_BENCHMARK_FRAME_COUNT / (result.elapsedMs / 1000.0);
+			const char* status = "new";
+			if (!writeGoldenFile)
+			{
+				auto it = goldenHashes.find(benchmarkCase.name);
+				if (it == goldenHashes.end())
+					status = "missing";
+				else
+					status = it->second == result.hash ? "ok" : "MISMATCH";
+				if (it == goldenHashes.end() || it->second != result.hash)
+					allMatched = false;
+			}
+			fmt::print("{:<16} {:9.2f}ms {:8.1f}x realtime {:12.0f} voice-frames/s  {:016x} {}\n", benchmarkCase.name, result.elapsedMs, audioMs / result.elapsedMs, voiceFramesPerSec, result.hash, status);
+			goldenFileContent.append(fmt::format("{} {:016x}\n", benchmarkCase.name, result.hash));
+		}
+		fmt::print("Total: {:.2f}ms\n", totalMs);
+
+		if (writeGoldenFile)
+		{
+			std::unique_ptr<FileStream> file(FileStream::createFile2(goldenFilePath));
+			if (!file)
+			{
+				fmt::print("Unable to write golden file {}\n", _pathToUtf8(goldenFilePath));
+				return false;
+			}
+			file->writeString(goldenFileContent.c_str());
+			fmt::print("Wrote golden file {}\n", _pathToUtf8(goldenFilePath));
+			return true;
+		}
+		fmt::print("{}\n", allMatched ? "Output matches golden file" : "Output does NOT match golden file");
+		return allMatched;
+	}
+}
@@ -211,6 +211,7 @@ namespace snd_core
 	void AXIst_InitThread();
 	OSThread_t* AXIst_GetThread();
 	void AXIst_StopThread();
+	void AXIst_SyncVPB(AXVPBInternal_t** lastProcessedDSPShadowCopy, AXVPBInternal_t** lastProcessedPPCShadowCopy);
 
 	void AXIst_HandleFrameCallbacks();
 
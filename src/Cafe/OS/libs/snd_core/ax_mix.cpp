@@ -2,6 +2,11 @@
 #include "Cafe/OS/libs/snd_core/ax_internal.h"
 #include "Cafe/HW/MMU/MMU.h"
 #include "config/ActiveSettings.h"
+#include "util/ThreadPool/ThreadPool.h"
+
+#if defined(__aarch64__)
+#include <arm_neon.h>
+#endif
 
 void mic_updateOnAXFrame();
 
@@ -31,6 +36,128 @@ namespace snd_core
 		// todo
 	}
 
+	/* vectorized helpers. All of them produce the same results as a plain scalar loop */
+
+	// output[i] += input[i]
+	void AXMix_Add(const float* input, float* output, sint32 count)
+	{
+		sint32 i = 0;
+#if defined(ARCH_X86_64)
+		for (; (i + 4) <= count; i += 4)
+			_mm_storeu_ps(output + i, _mm_add_ps(_mm_loadu_ps(output + i), _mm_loadu_ps(input + i)));
+#elif defined(__aarch64__)
+		for (; (i + 4) <= count; i += 4)
+			vst1q_f32(output + i, vaddq_f32(vld1q_f32(output + i), vld1q_f32(input + i)));
+#endif
+		for (; i < count; i++)
+			output[i] += input[i];
+	}
+
+	// output[i] += input[i] * volume
+	void AXMix_MultiplyAdd(const float* input, float* output, float volume, sint32 count)
+	{
+		sint32 i = 0;
+#if defined(ARCH_X86_64)
+		__m128 volumeV = _mm_set1_ps(volume);
+		for (; (i + 4) <= count; i += 4)
+			_mm_storeu_ps(output + i, _mm_add_ps(_mm_loadu_ps(output + i), _mm_mul_ps(_mm_loadu_ps(input + i), volumeV)));
+#elif defined(__aarch64__)
+		float32x4_t volumeV = vdupq_n_f32(volume);
+		for (; (i + 4) <= count; i += 4)
+			vst1q_f32(output + i, vaddq_f32(vld1q_f32(output + i), vmulq_f32(vld1q_f32(input + i), volumeV)));
+#endif
+		for (; i < count; i++)
+			output[i] += input[i] * volume;
+	}
+
+	// output[i] += input[i] * volumeRamp[i]
+	void AXMix_MultiplyAddRamp(const float* input, float* output, const float* volumeRamp, sint32 count)
+	{
+		sint32 i = 0;
+#if defined(ARCH_X86_64)
+		for (; (i + 4) <= count; i += 4)
+			_mm_storeu_ps(output + i, _mm_add_ps(_mm_loadu_ps(output + i), _mm_mul_ps(_mm_loadu_ps(input + i), _mm_loadu_ps(volumeRamp + i))));
+#elif defined(__aarch64__)
+		for (; (i + 4) <= count; i += 4)
+			vst1q_f32(output + i, vaddq_f32(vld1q_f32(output + i), vmulq_f32(vld1q_f32(input + i), vld1q_f32(volumeRamp + i))));
+#endif
+		for (; i < count; i++)
+			output[i] += input[i] * volumeRamp[i];
+	}
+
+	// data[i] *= volume
+	void AXMix_Scale(float* data, float volume, sint32 count)
+	{
+		sint32 i = 0;
+#if defined(ARCH_X86_64)
+		__m128 volumeV = _mm_set1_ps(volume);
+		for (; (i + 4) <= count; i += 4)
+			_mm_storeu_ps(data + i, _mm_mul_ps(_mm_loadu_ps(data + i), volumeV));
+#elif defined(__aarch64__)
+		float32x4_t volumeV = vdupq_n_f32(volume);
+		for (; (i + 4) <= count; i += 4)
+			vst1q_f32(data + i, vmulq_f32(vld1q_f32(data + i), volumeV));
+#endif
+		for (; i < count; i++)
+			data[i] *= volume;
+	}
+
+	// data[i] *= volumeRamp[i]
+	void AXMix_ScaleRamp(float* data, const float* volumeRamp, sint32 count)
+	{
+		sint32 i = 0;
+#if defined(ARCH_X86_64)
+		for (; (i + 4) <= count; i += 4)
+			_mm_storeu_ps(data + i, _mm_mul_ps(_mm_loadu_ps(data + i), _mm_loadu_ps(volumeRamp + i)));
+#elif defined(__aarch64__)
+		for (; (i + 4) <= count; i += 4)
+			vst1q_f32(data + i, vmulq_f32(vld1q_f32(data + i), vld1q_f32(volumeRamp + i)));
+#endif
+		for (; i < count; i++)
+			data[i] *= volumeRamp[i];
+	}
+
+	// the volume is accumulated sequentially, exactly like the per-sample loop did, so the resulting ramp is bit-identical
+	float AXMix_GenerateVolumeRamp(float* volumeRamp, float volume, float delta, sint32 count)
+	{
+		for (sint32 i = 0; i < count; i++)
+		{
+			volume += delta;
+			volumeRamp[i] = volume;
+		}
+		return volume;
+	}
+
+	// converts big-endian PCM16 samples to float in the 24bit range used by the mixer
+	void AXMix_ConvertPCM16BEToFloat(const uint16* input, float* output, sint32 count)
+	{
+		sint32 i = 0;
+#if defined(ARCH_X86_64)
+		const __m128i zero = _mm_setzero_si128();
+		for (; (i + 8) <= count; i += 8)
+		{
+			__m128i samples = _mm_loadu_si128((const __m128i*)(input + i));
+			samples = _mm_or_si128(_mm_slli_epi16(samples, 8), _mm_srli_epi16(samples, 8));
+			// move each sample into the upper 16 bits of a 32bit lane, then an arithmetic shift sign-extends and applies the <<8
+			__m128i low = _mm_srai_epi32(_mm_unpacklo_epi16(zero, samples), 8);
+			__m128i high = _mm_srai_epi32(_mm_unpackhi_epi16(zero, samples), 8);
+			_mm_storeu_ps(output + i, _mm_cvtepi32_ps(low));
+			_mm_storeu_ps(output + i + 4, _mm_cvtepi32_ps(high));
+		}
+#elif defined(__aarch64__)
+		for (; (i + 8) <= count; i += 8)
+		{
+			int16x8_t samples = vreinterpretq_s16_u8(vrev16q_u8(vld1q_u8((const uint8*)(input + i))));
+			int32x4_t low = vshlq_n_s32(vmovl_s16(vget_low_s16(samples)), 8);
+			int32x4_t high = vshlq_n_s32(vmovl_s16(vget_high_s16(samples)), 8);
+			vst1q_f32(output + i, vcvtq_f32_s32(low));
+			vst1q_f32(output + i + 4, vcvtq_f32_s32(high));
+		}
+#endif
+		for (; i < count; i++)
+			output[i] = (float)((sint32)_swapEndianS16(input[i]) << 8);
+	}
+
 #define handleAdpcmDecodeLoop() \
 	if (internalShadowCopy->internalOffsets.loopFlag != 0) \
 	{	\
@@ -427,23 +554,44 @@ namespace snd_core
 	void AX_DecodeSamplesPCM8_NoSrc(AXVPBInternal_t* internalShadowCopy, float* output, sint32 sampleCount)
 	{
 		// get variables
-		uint32 currentFracPos = (uint32)_swapEndianU16(internalShadowCopy->src.currentFrac);
-		uint32 ratio = _swapEndianU32(*(uint32*)&internalShadowCopy->src.ratioHigh);
-
 		uint32 endOffsetPtr = _swapEndianU32(*(uint32*)&internalShadowCopy->internalOffsets.endOffsetPtrHigh);
 		uint32 currentOffsetPtr = _swapEndianU32(*(uint32*)&internalShadowCopy->internalOffsets.currentOffsetPtrHigh);
+		uint32 loopOffsetPtr = _swapEndianU32(*(uint32*)&internalShadowCopy->internalOffsets.loopOffsetPtrHigh);
 		uint32 ptrHighExtension = _swapEndianU16(internalShadowCopy->internalOffsets.ptrHighExtension);
 
 		uint8* endOffsetAddr = memory_base + (endOffsetPtr | (ptrHighExtension << 29));
 		uint8* currentOffsetAddr = memory_base + (currentOffsetPtr | (ptrHighExtension << 29));
 
-		sint16 historySamples[4];
-		historySamples[0] = _swapEndianS16(internalShadowCopy->src.historySamples[0]);
-		historySamples[1] = _swapEndianS16(internalShadowCopy->src.historySamples[1]);
-		historySamples[2] = _swapEndianS16(internalShadowCopy->src.historySamples[2]);
-		historySamples[3] = _swapEndianS16(internalShadowCopy->src.historySamples[3]);
+		if (internalShadowCopy->playbackState == 0)
+		{
+			memset(output, 0, sizeof(float)*sampleCount);
+			return;
+		}
 
-		cemu_assert_debug(false); // todo
+		// same behavior as AX_DecodeSamplesPCM16_NoSrc, 8 bit samples are scaled to the same range as the SRC variant outputs
+		for (sint32 i = 0; i < sampleCount; i++)
+		{
+			if (currentOffsetAddr != endOffsetAddr)
+			{
+				output[i] = (float)((sint32)(sint8)*currentOffsetAddr << 16);
+				currentOffsetAddr++;
+			}
+			else if (internalShadowCopy->internalOffsets.loopFlag)
+			{
+				output[i] = (float)((sint32)(sint8)*currentOffsetAddr << 16);
+				currentOffsetAddr = memory_base + (loopOffsetPtr | (ptrHighExtension << 29));
+			}
+			else
+			{
+				internalShadowCopy->playbackState = 0;
+				memset(output + i, 0, sizeof(float) * (sampleCount - i));
+				break;
+			}
+		}
+		// store current offset
+		currentOffsetPtr = (uint32)((uint8*)currentOffsetAddr - memory_base);
+		currentOffsetPtr &= 0x1FFFFFFF;
+		*(uint32*)&internalShadowCopy->internalOffsets.currentOffsetPtrHigh = _swapEndianU32(currentOffsetPtr);
 	}
 
 	void AX_DecodeSamplesPCM16_Linear(AXVPBInternal_t* internalShadowCopy, float* output, sint32 sampleCount)
@@ -559,29 +707,36 @@ namespace snd_core
 			return;
 		}
 
-		for (sint32 i = 0; i < sampleCount; i++)
+		sint32 i = 0;
+		while (i < sampleCount)
 		{
-			sint32 s = _swapEndianS16(*currentOffsetAddr);
-			s <<= 8;
-			output[i] = (float)s;
-			if (currentOffsetAddr == endOffsetAddr)
+			// convert all samples before the end offset in one go
+			ptrdiff_t runLength = sampleCount - i;
+			if (currentOffsetAddr <= endOffsetAddr)
+				runLength = std::min<ptrdiff_t>(runLength, endOffsetAddr - currentOffsetAddr);
+			AXMix_ConvertPCM16BEToFloat(currentOffsetAddr, output + i, (sint32)runLength);
+			currentOffsetAddr += runLength;
+			i += (sint32)runLength;
+			if (i >= sampleCount)
+				break;
+			// reached end offset. The end sample is only played if the voice loops
+			if (internalShadowCopy->internalOffsets.loopFlag)
 			{
-				if (internalShadowCopy->internalOffsets.loopFlag)
-				{
-					currentOffsetAddr = (uint16*)(memory_base + (loopOffsetPtr * 2 | (ptrHighExtension << 29)));
-				}
-				else
+				sint32 s = _swapEndianS16(*currentOffsetAddr);
+				s <<= 8;
+				output[i] = (float)s;
+				i++;
+				currentOffsetAddr = (uint16*)(memory_base + (loopOffsetPtr * 2 | (ptrHighExtension << 29)));
+			}
+			else
+			{
+				internalShadowCopy->playbackState = 0;
+				for (; i < sampleCount; i++)
 				{
-					internalShadowCopy->playbackState = 0;
-					for (; i < sampleCount; i++)
-					{
-						output[i] = 0.0f;
-					}
-					break;
+					output[i] = 0.0f;
 				}
+				break;
 			}
-			else
-				currentOffsetAddr++;
 		}
 		// store current offset
 		currentOffsetPtr = (uint32)((uint8*)currentOffsetAddr - memory_base);
@@ -637,19 +792,14 @@ namespace snd_core
 		if (deltaI != 0)
 		{
 			float delta = (float)deltaI / (float)0x8000;
-			for (sint32 i = 0; i < sampleCount; i++)
-			{
-				vol += delta;
-				outputSamples[i] += inputSamples[i] * vol;
-			}
+			float volumeRamp[AX_SAMPLES_MAX];
+			vol = AXMix_GenerateVolumeRamp(volumeRamp, vol, delta, sampleCount);
+			AXMix_MultiplyAddRamp(inputSamples, outputSamples, volumeRamp, sampleCount);
 		}
 		else
 		{
 			// optimized version for delta == 0.0
-			for (sint32 i = 0; i < sampleCount; i++)
-			{
-				outputSamples[i] += inputSamples[i] * vol;
-			}
+			AXMix_MultiplyAdd(inputSamples, outputSamples, vol, sampleCount);
 		}
 		uint16 volI = (uint16)(vol * 32768.0f);
 		mix->vol = _swapEndianU16(volI);
@@ -669,18 +819,15 @@ namespace snd_core
 		if (volumeDelta == 0)
 		{
 			// without delta
-			for (sint32 i = 0; i < sampleCount; i++)
-				sampleData[i] *= volumeScaler;
+			AXMix_Scale(sampleData, volumeScaler, sampleCount);
 			return;
 		}
 		// with delta
 		double volumeScalerDelta = (double)volumeDelta / 32768.0;
 		volumeScalerDelta = volumeScalerDelta + volumeScalerDelta;
-		for (sint32 i = 0; i < sampleCount; i++)
-		{
-			volumeScaler += (float)volumeScalerDelta;
-			sampleData[i] *= volumeScaler;
-		}
+		float volumeRamp[AX_SAMPLES_MAX];
+		volumeScaler = AXMix_GenerateVolumeRamp(volumeRamp, volumeScaler, (float)volumeScalerDelta, sampleCount);
+		AXMix_ScaleRamp(sampleData, volumeRamp, sampleCount);
 		if (volumeDelta != 0)
 		{
 			volume = (uint16)(volumeScaler * 32768.0);
@@ -762,8 +909,30 @@ namespace snd_core
 		internalShadowCopy->lpf.yn1 = (uint16)_swapEndianS16((sint16)(prevSample / 256.0f * 32767.0f));
 	}
 
+	// bus buffers which voices are mixed into
+	struct AXMixBusTarget
+	{
+		float* tv;
+		float* drc;
+		bool clearOnFirstUse; // if set, channel buffers are cleared the first time they are mixed into
+		uint32 tvChannelMask; // bit (busIndex * AX_TV_CHANNEL_COUNT + channel) is set if the channel buffer has been written
+		uint32 drcChannelMask; // bit (busIndex * AX_DRC_CHANNEL_COUNT + channel) is set if the channel buffer has been written
+	};
+
+	float* AXMix_GetBusChannelBuffer(float* buffer, uint32& channelMask, bool clearOnFirstUse, sint32 channelIndex, sint32 samplesPerFrame)
+	{
+		float* output = buffer + channelIndex * samplesPerFrame;
+		if ((channelMask & (1u << channelIndex)) == 0)
+		{
+			channelMask |= (1u << channelIndex);
+			if (clearOnFirstUse)
+				memset(output, 0, sizeof(float) * samplesPerFrame);
+		}
+		return output;
+	}
+
 	// mix audio generated from voice into main bus and aux buses
-	void AXVoiceMix_MixIntoBuses(AXVPBInternal_t* internalShadowCopy, float* sampleData, sint32 sampleCount, sint32 samplesPerFrame)
+	void AXVoiceMix_MixIntoBuses(AXVPBInternal_t* internalShadowCopy, float* sampleData, sint32 sampleCount, sint32 samplesPerFrame, AXMixBusTarget& target)
 	{
 		// TV mixing
 		for (sint32 busIndex = 0; busIndex < AX_BUS_COUNT; busIndex++)
@@ -777,7 +946,7 @@ namespace snd_core
 					continue;
 				}
 				AXCHMIX_DEPR* mix = internalShadowCopy->deviceMixTV + channel * 4 + busIndex;
-				float* output = __AXMixBufferTV + (busIndex * 6 + channel) * samplesPerFrame;
+				float* output = AXMix_GetBusChannelBuffer(target.tv, target.tvChannelMask, target.clearOnFirstUse, busIndex * AX_TV_CHANNEL_COUNT + channel, samplesPerFrame);
 				AXVoiceMix_MergeInto(sampleData, output, sampleCount, mix, _swapEndianS16(mix->delta));
 				internalShadowCopy->reserved1E8[busIndex*AX_TV_CHANNEL_COUNT + channel] = mix->vol;
 			}
@@ -795,7 +964,7 @@ namespace snd_core
 					continue;
 				}
 				AXCHMIX_DEPR* mix = internalShadowCopy->deviceMixDRC + channel * 4 + busIndex;
-				float* output = __AXMixBufferDRC + (busIndex * AX_DRC_CHANNEL_COUNT + channel) * samplesPerFrame;
+				float* output = AXMix_GetBusChannelBuffer(target.drc, target.drcChannelMask, target.clearOnFirstUse, busIndex * AX_DRC_CHANNEL_COUNT + channel, samplesPerFrame);
 				AXVoiceMix_MergeInto(sampleData, output, sampleCount, mix, _swapEndianS16(mix->delta));
 			}
 		}
@@ -804,23 +973,113 @@ namespace snd_core
 		// todo
 	}
 
+	void AXMix_ProcessVoice(AXVPBInternal_t* internalVoice, float* tmpSampleBuffer, sint32 sampleCount, AXMixBusTarget& target)
+	{
+		AXVoiceMix_DecodeSamples(internalVoice, tmpSampleBuffer, sampleCount);
+		AXVoiceMix_ApplyADSR(internalVoice, tmpSampleBuffer, sampleCount);
+		AXVoiceMix_ApplyBiquad(internalVoice, tmpSampleBuffer, sampleCount);
+		AXVoiceMix_ApplyLowPass(internalVoice, tmpSampleBuffer, sampleCount);
+		AXVoiceMix_MixIntoBuses(internalVoice, tmpSampleBuffer, sampleCount, sampleCount, target);
+	}
+
+	/* Parallel voice mixing
+	 * Voices are split into fixed size batches in processing order. Each batch is mixed into its own set of bus buffers and afterwards the batches are summed up in order
+	 * The first batch mixes directly into the main bus buffers. Since the batch layout doesn't depend on the number of worker threads the output is deterministic
+	 * Voice decoding only touches the voice's own shadow copy and guest sample memory, so batches can run on any thread
+	 */
+
+	constexpr sint32 AX_MIX_VOICES_PER_BATCH = 8;
+	constexpr sint32 AX_MIX_MAX_BATCHES = (AX_MAX_VOICES + AX_MIX_VOICES_PER_BATCH - 1) / AX_MIX_VOICES_PER_BATCH;
+
+	struct AXMixBatchBuffer
+	{
+		float tv[AX_SAMPLES_MAX * AX_TV_CHANNEL_COUNT * AX_BUS_COUNT];
+		float drc[AX_SAMPLES_MAX * AX_DRC_CHANNEL_COUNT * AX_BUS_COUNT];
+	};
+
+	struct
+	{
+		AXVPBInternal_t* voices[AX_MAX_VOICES];
+		sint32 voiceCount;
+		sint32 sampleCount;
+		AXMixBusTarget targets[AX_MIX_MAX_BATCHES];
+		AXMixBatchBuffer batchBuffers[AX_MIX_MAX_BATCHES - 1];
+	}sAXMixFrame;
+
+	void AXMix_ProcessVoiceBatch(sint32 batchIndex)
+	{
+		float tmpSampleBuffer[AX_SAMPLES_MAX];
+		AXMixBusTarget& target = sAXMixFrame.targets[batchIndex];
+		sint32 firstVoice = batchIndex * AX_MIX_VOICES_PER_BATCH;
+		sint32 lastVoice = std::min(firstVoice + AX_MIX_VOICES_PER_BATCH, sAXMixFrame.voiceCount);
+		for (sint32 i = firstVoice; i < lastVoice; i++)
+			AXMix_ProcessVoice(sAXMixFrame.voices[i], tmpSampleBuffer, sAXMixFrame.sampleCount, target);
+	}
+
+	// batches are handed out through an atomic counter, the calling thread and the pool workers pick them up until none are left
+	std::atomic<sint32> sAXMixNextBatch;
+
+	void AXMix_ProcessRemainingVoiceBatches(sint32 batchCount)
+	{
+		sint32 batchIndex;
+		while ((batchIndex = sAXMixNextBatch.fetch_add(1)) < batchCount)
+			AXMix_ProcessVoiceBatch(batchIndex);
+	}
+
 	void AXMix_ProcessVoices(AXVPBInternal_t* firstVoice)
 	{
 		if (firstVoice == nullptr)
 			return;
 		size_t sampleCount = AXGetInputSamplesPerFrame();
-		AXVPBInternal_t* internalVoice = firstVoice;
 		cemu_assert_debug(sndGeneric.initParam.frameLength == 0);
-		float tmpSampleBuffer[AX_SAMPLES_MAX];
-		while (internalVoice)
-		{
-			AXVoiceMix_DecodeSamples(internalVoice, tmpSampleBuffer, sampleCount);
-			AXVoiceMix_ApplyADSR(internalVoice, tmpSampleBuffer, sampleCount);
-			AXVoiceMix_ApplyBiquad(internalVoice, tmpSampleBuffer, sampleCount);
-			AXVoiceMix_ApplyLowPass(internalVoice, tmpSampleBuffer, sampleCount);
-			AXVoiceMix_MixIntoBuses(internalVoice, tmpSampleBuffer, sampleCount, sampleCount);
-			// next
-			internalVoice = internalVoice->nextToProcess.GetPtr();
+		// gather voices
+		sint32 voiceCount = 0;
+		for (AXVPBInternal_t* internalVoice = firstVoice; internalVoice; internalVoice = internalVoice->nextToProcess.GetPtr())
+		{
+			if (voiceCount >= AX_MAX_VOICES)
+			{
+				cemu_assert_suspicious();
+				break;
+			}
+			sAXMixFrame.voices[voiceCount] = internalVoice;
+			voiceCount++;
+		}
+		sAXMixFrame.voiceCount = voiceCount;
+		sAXMixFrame.sampleCount = (sint32)sampleCount;
+		sint32 batchCount = (voiceCount + AX_MIX_VOICES_PER_BATCH - 1) / AX_MIX_VOICES_PER_BATCH;
+		// the first batch mixes straight into the (already cleared) main buffers
+		sAXMixFrame.targets[0] = { __AXMixBufferTV, __AXMixBufferDRC, false, 0, 0 };
+		for (sint32 i = 1; i < batchCount; i++)
+			sAXMixFrame.targets[i] = { sAXMixFrame.batchBuffers[i - 1].tv, sAXMixFrame.batchBuffers[i - 1].drc, true, 0, 0 };
+		if (batchCount == 1)
+			AXMix_ProcessVoiceBatch(0);
+		else
+		{
+			sAXMixNextBatch = 0;
+			ThreadPool::TaskGroup taskGroup;
+			sint32 helperCount = std::min<sint32>(batchCount - 1, (sint32)ThreadPool::GetWorkerCount(ThreadPool::Priority::High));
+			for (sint32 i = 0; i < helperCount; i++)
+				ThreadPool::Submit(ThreadPool::Priority::High, [batchCount]() { AXMix_ProcessRemainingVoiceBatches(batchCount); }, &taskGroup);
+			// the main core claims batches like the helpers do, so it mixes every batch no helper got to in time
+			// once it runs out all batches are claimed. Helpers which haven't started are dropped and the wait only covers batches in flight
+			AXMix_ProcessRemainingVoiceBatches(batchCount);
+			taskGroup.Cancel();
+			taskGroup.Wait();
+		}
+		// reduce batch buffers in order
+		for (sint32 batchIndex = 1; batchIndex < batchCount; batchIndex++)
+		{
+			const AXMixBusTarget& target = sAXMixFrame.targets[batchIndex];
+			for (uint32 mask = target.tvChannelMask; mask != 0; mask &= (mask - 1))
+			{
+				sint32 channelIndex = std::countr_zero(mask);
+				AXMix_Add(target.tv + channelIndex * sampleCount, __AXMixBufferTV + channelIndex * sampleCount, (sint32)sampleCount);
+			}
+			for (uint32 mask = target.drcChannelMask; mask != 0; mask &= (mask - 1))
+			{
+				sint32 channelIndex = std::countr_zero(mask);
+				AXMix_Add(target.drc + channelIndex * sampleCount, __AXMixBufferDRC + channelIndex * sampleCount, (sint32)sampleCount);
+			}
 		}
 	}
 
@@ -474,14 +474,21 @@ namespace snd_core
 		}
 	}
 
+	constexpr static auto kAXOutTimeout = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::milliseconds(((IAudioAPI::kBlockCount * 3) / 4) * (AX_FRAMES_PER_GROUP * 3)));
+	constexpr static auto kAXOutWaitDuration = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::milliseconds(3));
+	constexpr static auto kAXOutWaitDurationFast = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::microseconds(2900));
+	constexpr static auto kAXOutWaitDurationMinimum = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::microseconds(1700));
+
+	// s_axIntervalTimer increases by the wait period
+	// it can lag behind by multiple periods (up to kAXOutTimeout) if there is minor stutter in the CPU thread
+	// s_axLastCheck is always set to the timestamp at the time of firing
+	// it's used to enforce the minimum wait delay (we want to avoid calling AX update in quick succession because other threads may need to do work first) 
+	static auto s_axIntervalTimer = now_cached() - kAXOutWaitDuration;
+	static auto s_axLastCheck = now_cached();
+
 	// called periodically to check for AX updates
 	void AXOut_update()
 	{
-		constexpr static auto kTimeout = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::milliseconds(((IAudioAPI::kBlockCount * 3) / 4) * (AX_FRAMES_PER_GROUP * 3)));
-		constexpr static auto kWaitDuration = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::milliseconds(3));
-		constexpr static auto kWaitDurationFast = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::microseconds(2900));
-		constexpr static auto kWaitDurationMinimum = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::microseconds(1700));
-
 		// if we haven't buffered any blocks, we will wait less time than usual
 		bool additional_blocks_required = false;
 		{
@@ -490,33 +497,24 @@ namespace snd_core
 				additional_blocks_required = (g_tvAudio && g_tvAudio->NeedAdditionalBlocks()) || (g_padAudio && g_padAudio->NeedAdditionalBlocks());
 		}
 
-		const auto wait_duration = additional_blocks_required ? kWaitDurationFast : kWaitDuration;
-
-		// s_ax_interval_timer increases by the wait period
-		// it can lag behind by multiple periods (up to kTimeout) if there is minor stutter in the CPU thread
-		// s_last_check is always set to the timestamp at the time of firing
-		// it's used to enforce the minimum wait delay (we want to avoid calling AX update in quick succession because other threads may need to do work first) 
-
-		static auto s_ax_interval_timer = now_cached() - kWaitDuration;
-		static auto s_last_check = now_cached();
+		const auto wait_duration = additional_blocks_required ? kAXOutWaitDurationFast : kAXOutWaitDuration;
 
 		const auto now = now_cached();
-		const auto diff = (now - s_ax_interval_timer);
+		const auto diff = (now - s_axIntervalTimer);
 
 		if (diff < wait_duration)
 			return;
 
 		// handle minimum wait time (1.7MS)
-		if ((now - s_last_check) < kWaitDurationMinimum)
+		if ((now - s_axLastCheck) < kAXOutWaitDurationMinimum)
 			return;
-		s_last_check = now;
+		s_axLastCheck = now;
 
 		// if we're too far behind, skip forward
-		if (diff >= kTimeout)
-			s_ax_interval_timer = (now - wait_duration);
+		if (diff >= kAXOutTimeout)
+			s_axIntervalTimer = (now - wait_duration);
 		else
-			s_ax_interval_timer += wait_duration;
-
+			s_axIntervalTimer += wait_duration;
 
 		if (snd_core::isInitialized())
 		{
@@ -529,4 +527,14 @@ namespace snd_core
 		}
 	}
 
+	// returns how long AXOut_update() can be delayed before it has work to do. Assumes the shorter wait period
+	std::chrono::nanoseconds AXOut_getTimeUntilNextUpdate()
+	{
+		const auto now = now_cached();
+		const auto nextUpdate = std::max(s_axIntervalTimer + kAXOutWaitDurationFast, s_axLastCheck + kAXOutWaitDurationMinimum);
+		if (nextUpdate <= now)
+			return std::chrono::nanoseconds(0);
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(nextUpdate - now);
+	}
+
 }
@@ -92,6 +92,20 @@ TitleInfo::TitleInfo(const fs::path& path, std::string_view subPath)
 		CalcUID();
 }
 
+TitleInfo::TitleInfo(TitleDataFormat format, const fs::path& path, std::string_view subPath, std::shared_ptr<const RawXmlFiles> rawXmlFiles)
+{
+	m_titleFormat = format;
+	m_fullPath = path;
+	m_subPath = subPath;
+	m_hasParsedXmlFiles = true;
+	m_isValid = ParseXmlFiles(*rawXmlFiles);
+	if (m_isValid)
+	{
+		m_rawXmlFiles = std::move(rawXmlFiles);
+		CalcUID();
+	}
+}
+
 TitleInfo::TitleInfo(const TitleInfo::CachedInfo& cachedInfo)
 {
 	m_cachedInfo = new CachedInfo(cachedInfo);
@@ -539,34 +553,64 @@ bool TitleInfo::ParseXmlInfo()
 	bool r = Mount(mountPath, "", FSC_PRIORITY_BASE);
 	if (!r)
 		return false;
+	auto rawXmlFiles = std::make_shared<RawXmlFiles>();
 	// meta/meta.xml
-	auto xmlData = fsc_extractFile(fmt::format("{}meta/meta.xml", mountPath).c_str());
-	if(xmlData)
-		m_parsedMetaXml = ParsedMetaXml::Parse(xmlData->data(), xmlData->size());
-
-	if(!m_parsedMetaXml)
+	auto fileData = fsc_extractFile(fmt::format("{}meta/meta.xml", mountPath).c_str());
+	if (fileData)
+		rawXmlFiles->metaXml = std::move(*fileData);
+	else
 	{
 		// meta/meta.ini (WUHB)
-		auto iniData = fsc_extractFile(fmt::format("{}meta/meta.ini", mountPath).c_str());
-		if (iniData)
-			m_parsedMetaXml = ParseAromaIni(*iniData);
+		fileData = fsc_extractFile(fmt::format("{}meta/meta.ini", mountPath).c_str());
+		if (fileData)
+			rawXmlFiles->metaIni = std::move(*fileData);
+	}
+	// code/app.xml
+	fileData = fsc_extractFile(fmt::format("{}code/app.xml", mountPath).c_str());
+	if (fileData)
+		rawXmlFiles->appXml = std::move(*fileData);
+	// code/cos.xml
+	fileData = fsc_extractFile(fmt::format("{}code/cos.xml", mountPath).c_str());
+	if (fileData)
+		rawXmlFiles->cosXml = std::move(*fileData);
+
+	Unmount(mountPath);
+
+	if (!ParseXmlFiles(*rawXmlFiles))
+		return false;
+	m_rawXmlFiles = std::move(rawXmlFiles);
+	return true;
+}
+
+bool TitleInfo::ParseXmlFiles(const RawXmlFiles& rawXmlFiles)
+{
+	// the parsers work in-place, so operate on copies of the data
+	std::vector<uint8> xmlData;
+	if (!rawXmlFiles.metaXml.empty())
+	{
+		xmlData = rawXmlFiles.metaXml;
+		m_parsedMetaXml = ParsedMetaXml::Parse(xmlData.data(), xmlData.size());
+	}
+	if (!m_parsedMetaXml && !rawXmlFiles.metaIni.empty())
+	{
+		xmlData = rawXmlFiles.metaIni;
+		m_parsedMetaXml = ParseAromaIni(xmlData);
 		if(m_parsedMetaXml)
 		{
 			m_parsedCosXml = new ParsedCosXml{.argstr = "root.rpx"};
 			m_parsedAppXml = new ParsedAppXml{m_parsedMetaXml->m_title_id, 0, 0, 0, 0};
 		}
 	}
-
-	// code/app.xml
-	xmlData = fsc_extractFile(fmt::format("{}code/app.xml", mountPath).c_str());
-	if(xmlData)
-		ParseAppXml(*xmlData);
-	// code/cos.xml
-	xmlData = fsc_extractFile(fmt::format("{}code/cos.xml", mountPath).c_str());
-	if (xmlData)
-		m_parsedCosXml = ParsedCosXml::Parse(xmlData->data(), xmlData->size());
-
-	Unmount(mountPath);
+	if (!rawXmlFiles.appXml.empty())
+	{
+		xmlData = rawXmlFiles.appXml;
+		ParseAppXml(xmlData);
+	}
+	if (!rawXmlFiles.cosXml.empty())
+	{
+		xmlData = rawXmlFiles.cosXml;
+		m_parsedCosXml = ParsedCosXml::Parse(xmlData.data(), xmlData.size());
+	}
 
 	// some system titles dont have a meta.xml file
 	bool allowMissingMetaXml = false;
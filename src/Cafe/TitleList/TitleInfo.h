@@ -156,10 +156,20 @@ public:
 		uint32 app_type;
 	};
 
+	// unparsed meta files as read from the title. Kept by the title list index so that unchanged containers don't need to be reopened
+	struct RawXmlFiles
+	{
+		std::vector<uint8> metaXml;
+		std::vector<uint8> metaIni; // WUHB
+		std::vector<uint8> appXml;
+		std::vector<uint8> cosXml;
+	};
+
 	TitleInfo() : m_isValid(false) {};
 	TitleInfo(const fs::path& path);
 	TitleInfo(const fs::path& path, std::string_view subPath);
 	TitleInfo(const CachedInfo& cachedInfo);
+	TitleInfo(TitleDataFormat format, const fs::path& path, std::string_view subPath, std::shared_ptr<const RawXmlFiles> rawXmlFiles); // parses the given meta files instead of reading them from the title
 	~TitleInfo();
 
 	TitleInfo(const TitleInfo& other)
@@ -190,6 +200,7 @@ public:
 	bool IsMounted() const { return !m_mountpoints.empty(); }
 
 	bool ParseXmlInfo();
+	std::shared_ptr<const RawXmlFiles> GetRawXmlFiles() const { return m_rawXmlFiles; }
 	bool HasValidXmlInfo() const { return m_parsedMetaXml && m_parsedAppXml && m_parsedCosXml; };
 
 	bool IsEqualByLocation(const TitleInfo& rhs) const
@@ -246,6 +257,7 @@ private:
 		m_fullPath = other.m_fullPath;
 		m_subPath = other.m_subPath;
 		m_hasParsedXmlFiles = other.m_hasParsedXmlFiles;
+		m_rawXmlFiles = other.m_rawXmlFiles;
 		m_parsedMetaXml = nullptr;
 		m_parsedAppXml = nullptr;
 
@@ -266,6 +278,7 @@ private:
 	bool DetectFormat(const fs::path& path, fs::path& pathOut, TitleDataFormat& formatOut);
 	void CalcUID();
 	void SetInvalidReason(InvalidReason reason);
+	bool ParseXmlFiles(const RawXmlFiles& rawXmlFiles);
 	ParsedMetaXml* ParseAromaIni(std::span<unsigned char> content);
 	bool ParseAppXml(std::vector<uint8>& appXmlData);
 
@@ -282,6 +295,7 @@ private:
 	class WUHBReader* m_wuhbreader{};
 	// xml info
 	bool m_hasParsedXmlFiles{ false };
+	std::shared_ptr<const RawXmlFiles> m_rawXmlFiles;
 	ParsedMetaXml* m_parsedMetaXml{};
 	ParsedAppXml* m_parsedAppXml{};
 	ParsedCosXml* m_parsedCosXml{};
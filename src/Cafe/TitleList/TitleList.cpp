@@ -1,8 +1,11 @@
 #include "TitleList.h"
+#include "TitleListWatcher.h"
 #include "Common/FileStream.h"
 
 #include "util/helpers/helpers.h"
+#include "util/helpers/Serializer.h"
 #include "util/helpers/ZArchiveHelpers.h"
+#include "util/ThreadPool/ThreadPool.h"
 
 
 #include <zarchive/zarchivereader.h>
@@ -22,11 +25,44 @@ bool sTLCacheDirty{false};
 fs::path sTLMLCPath;
 std::vector<fs::path> sTLScanPaths;
 
+// index of title files found by previous scans, stored next to the cache file
+// containers which did not change since they were indexed are not reopened. Their titles are recreated from the stored meta files instead
+struct TitleIndexEntry
+{
+	struct Title
+	{
+		TitleInfo::TitleDataFormat format;
+		fs::path path;
+		std::string subPath;
+		std::shared_ptr<const TitleInfo::RawXmlFiles> rawXmlFiles;
+	};
+
+	uint64 lastWriteTime{};
+	uint64 fileSize{};
+	std::vector<Title> titles;
+};
+
+constexpr uint32 TITLE_INDEX_MAGIC = 0x544C4958; // 'TLIX'
+constexpr uint32 TITLE_INDEX_VERSION = 1;
+
+fs::path sTLIndexFilePath;
+std::mutex sTLIndexMutex;
+std::unordered_map<std::string, TitleIndexEntry> sTLIndex; // key is the utf8 path of the title file
+std::unordered_map<std::string, TitleIndexEntry> sTLIndexScanned; // entries confirmed or added by the current scan
+bool sTLIndexDirty{false};
+
 // worker
+// the worker thread only coordinates, the directories and files are scanned in parallel on the thread pool
 std::thread sTLRefreshWorker;
 bool sTLRefreshWorkerActive{false};
 std::atomic_uint32_t sTLRefreshRequests{};
 std::atomic_bool sTLIsScanMandatory{ false };
+ThreadPool::TaskGroup sTLScanTaskGroup;
+
+// directories visited by the current scan, watched for changes once it finishes
+std::mutex sTLScannedDirectoriesMutex;
+std::vector<fs::path> sTLScannedDirectories;
+std::unique_ptr<TitleListWatcher> sTLWatcher;
 
 // callback list
 struct TitleListCallbackEntry 
@@ -45,7 +81,20 @@ void CafeTitleList::Initialize(const fs::path cacheXmlFile)
 	std::unique_lock _lock(sTLMutex);
 	sTLInitialized = true;
 	sTLCacheFilePath = cacheXmlFile;
+	sTLIndexFilePath = fs::path(cacheXmlFile).replace_extension(".bin");
 	LoadCacheFile();
+	LoadIndexFile();
+	sTLWatcher = std::make_unique<TitleListWatcher>([]() { Refresh(); });
+}
+
+void CafeTitleList::Shutdown()
+{
+	// the watcher thread calls back into the title list, so it has to be stopped before static destruction
+	// destroyed outside of the lock since the thread may be waiting on it in Refresh()
+	sTLMutex.lock();
+	std::unique_ptr<TitleListWatcher> watcher = std::move(sTLWatcher);
+	sTLMutex.unlock();
+	watcher.reset();
 }
 
 void CafeTitleList::LoadCacheFile()
@@ -145,6 +194,93 @@ void CafeTitleList::StoreCacheFile()
 	fs::rename(tmpPath, sTLCacheFilePath, ec);
 }
 
+void CafeTitleList::LoadIndexFile()
+{
+	std::unique_lock _lock(sTLIndexMutex);
+	sTLIndex.clear();
+	auto indexData = FileStream::LoadIntoMemory(sTLIndexFilePath);
+	if (!indexData)
+		return;
+	MemStreamReader reader(indexData->data(), (sint32)indexData->size());
+	if (reader.readBE<uint32>() != TITLE_INDEX_MAGIC || reader.readBE<uint32>() != TITLE_INDEX_VERSION)
+		return;
+	uint32 entryCount = reader.readBE<uint32>();
+	for (uint32 i = 0; i < entryCount && !reader.hasError(); i++)
+	{
+		std::string indexKey = reader.readBE<std::string>();
+		TitleIndexEntry entry;
+		entry.lastWriteTime = reader.readBE<uint64>();
+		entry.fileSize = reader.readBE<uint64>();
+		uint32 titleCount = reader.readBE<uint32>();
+		for (uint32 t = 0; t < titleCount && !reader.hasError(); t++)
+		{
+			TitleIndexEntry::Title title;
+			title.format = (TitleInfo::TitleDataFormat)reader.readBE<uint8>();
+			title.path = _utf8ToPath(reader.readBE<std::string>());
+			title.subPath = reader.readBE<std::string>();
+			auto rawXmlFiles = std::make_shared<TitleInfo::RawXmlFiles>();
+			rawXmlFiles->metaXml = reader.readPODVector<uint8>();
+			rawXmlFiles->metaIni = reader.readPODVector<uint8>();
+			rawXmlFiles->appXml = reader.readPODVector<uint8>();
+			rawXmlFiles->cosXml = reader.readPODVector<uint8>();
+			title.rawXmlFiles = std::move(rawXmlFiles);
+			entry.titles.emplace_back(std::move(title));
+		}
+		if (reader.hasError())
+			break;
+		sTLIndex.emplace(std::move(indexKey), std::move(entry));
+	}
+	if (reader.hasError())
+	{
+		cemuLog_log(LogType::Force, "Title list index is corrupted and will be rebuilt");
+		sTLIndex.clear();
+	}
+}
+
+void CafeTitleList::StoreIndexFile()
+{
+	if (sTLIndexFilePath.empty())
+		return;
+	MemStreamWriter writer(0);
+	std::unique_lock _lock(sTLIndexMutex);
+	writer.writeBE<uint32>(TITLE_INDEX_MAGIC);
+	writer.writeBE<uint32>(TITLE_INDEX_VERSION);
+	writer.writeBE<uint32>((uint32)sTLIndex.size());
+	for (auto& [indexKey, entry] : sTLIndex)
+	{
+		writer.writeBE<std::string>(indexKey);
+		writer.writeBE<uint64>(entry.lastWriteTime);
+		writer.writeBE<uint64>(entry.fileSize);
+		writer.writeBE<uint32>((uint32)entry.titles.size());
+		for (auto& title : entry.titles)
+		{
+			writer.writeBE<uint8>((uint8)title.format);
+			writer.writeBE<std::string>(_pathToUtf8(title.path));
+			writer.writeBE<std::string>(title.subPath);
+			writer.writePODVector(title.rawXmlFiles->metaXml);
+			writer.writePODVector(title.rawXmlFiles->metaIni);
+			writer.writePODVector(title.rawXmlFiles->appXml);
+			writer.writePODVector(title.rawXmlFiles->cosXml);
+		}
+	}
+	_lock.unlock();
+
+	fs::path tmpPath = fs::path(sTLIndexFilePath.parent_path()).append(fmt::format("{}__tmp", _pathToUtf8(sTLIndexFilePath.filename())));
+	std::ofstream fileOut(tmpPath, std::ios::out | std::ios::binary | std::ios::trunc);
+	if (!fileOut.is_open())
+	{
+		cemuLog_log(LogType::Force, "Unable to store title list index in {}", _pathToUtf8(tmpPath));
+		return;
+	}
+	auto indexData = writer.getResult();
+	fileOut.write((const char*)indexData.data(), indexData.size());
+	fileOut.flush();
+	fileOut.close();
+
+	std::error_code ec;
+	fs::rename(tmpPath, sTLIndexFilePath, ec);
+}
+
 void CafeTitleList::ClearScanPaths()
 {
 	std::unique_lock _lock(sTLMutex);
@@ -212,10 +348,11 @@ void _RemoveTitleFromMultimap(TitleInfo* titleInfo)
 	cemu_assert_suspicious();
 }
 
-// check if path is a valid title and if it is, permanently add it to the title list
-// in the special case that path points to a WUA file, all contained titles will be added
-void CafeTitleList::AddTitleFromPath(fs::path path)
+// open the title at path and return it if valid
+// in the special case that path points to a WUA file, all contained titles are returned
+std::vector<TitleInfo*> _ParseTitlesFromPath(const fs::path& path)
 {
+	std::vector<TitleInfo*> titles;
 	if (path.has_extension() && boost::iequals(_pathToUtf8(path.extension()), ".wua"))
 	{
 		ZArchiveReader* zar = ZArchiveHelpers::OpenReader(path);
@@ -223,7 +360,7 @@ void CafeTitleList::AddTitleFromPath(fs::path path)
 		if (!zar)
 		{
 			cemuLog_log(LogType::Force, "Found {} but it is not a valid Wii U archive file", _pathToUtf8(path));
-			return;
+			return titles;
 		}
 		// enumerate all contained titles
 		ZArchiveNodeHandle rootDir = zar->LookUp("", false, true);
@@ -245,18 +382,91 @@ void CafeTitleList::AddTitleFromPath(fs::path path)
 			// valid subdirectory
 			TitleInfo* titleInfo = new TitleInfo(path, dirEntry.name);
 			if (titleInfo->IsValid())
-				AddDiscoveredTitle(titleInfo);
+				titles.emplace_back(titleInfo);
 			else
 				delete titleInfo;
 		}
 		delete zar;
-		return;
+		return titles;
 	}
 	TitleInfo* titleInfo = new TitleInfo(path);
 	if (titleInfo->IsValid())
-		AddDiscoveredTitle(titleInfo);
+		titles.emplace_back(titleInfo);
 	else
 		delete titleInfo;
+	return titles;
+}
+
+// check if path is a valid title and if it is, permanently add it to the title list
+// in the special case that path points to a WUA file, all contained titles will be added
+void CafeTitleList::AddTitleFromPath(fs::path path)
+{
+	for (TitleInfo* titleInfo : _ParseTitlesFromPath(path))
+		AddDiscoveredTitle(titleInfo);
+}
+
+bool _GetTitleFileStamp(const fs::path& path, uint64& lastWriteTimeOut, uint64& fileSizeOut)
+{
+	std::error_code ec;
+	auto lastWriteTime = fs::last_write_time(path, ec);
+	if (ec)
+		return false;
+	uintmax_t fileSize = fs::file_size(path, ec);
+	if (ec)
+		return false;
+	lastWriteTimeOut = (uint64)lastWriteTime.time_since_epoch().count();
+	fileSizeOut = (uint64)fileSize;
+	return true;
+}
+
+// add the titles of a single title file (disc image, archive, tmd). Uses the index to avoid reopening files which did not change
+void CafeTitleList::ScanTitleFile(const fs::path& path)
+{
+	std::string indexKey = _pathToUtf8(path);
+	TitleIndexEntry entry;
+	bool hasStamp = _GetTitleFileStamp(path, entry.lastWriteTime, entry.fileSize);
+	if (hasStamp)
+	{
+		std::unique_lock _lock(sTLIndexMutex);
+		auto it = sTLIndex.find(indexKey);
+		if (it != sTLIndex.end() && it->second.lastWriteTime == entry.lastWriteTime && it->second.fileSize == entry.fileSize)
+		{
+			entry = it->second;
+			sTLIndexScanned.emplace(indexKey, entry);
+			_lock.unlock();
+			for (auto& title : entry.titles)
+			{
+				TitleInfo* titleInfo = new TitleInfo(title.format, title.path, title.subPath, title.rawXmlFiles);
+				if (titleInfo->IsValid())
+					AddDiscoveredTitle(titleInfo);
+				else
+					delete titleInfo;
+			}
+			return;
+		}
+	}
+	std::vector<TitleInfo*> titles = _ParseTitlesFromPath(path);
+	// files without any valid title are not indexed, they may become valid later (e.g. once the disc key is added)
+	bool canIndex = hasStamp && !titles.empty() && std::all_of(titles.cbegin(), titles.cend(), [](const TitleInfo* it) { return it->GetRawXmlFiles() != nullptr; });
+	if (canIndex)
+	{
+		for (TitleInfo* titleInfo : titles)
+		{
+			TitleInfo::CachedInfo cacheEntry = titleInfo->MakeCacheEntry();
+			entry.titles.push_back({cacheEntry.titleDataFormat, cacheEntry.path, cacheEntry.subPath, titleInfo->GetRawXmlFiles()});
+		}
+		std::unique_lock _lock(sTLIndexMutex);
+		sTLIndexScanned.insert_or_assign(indexKey, std::move(entry));
+		sTLIndexDirty = true;
+	}
+	for (TitleInfo* titleInfo : titles)
+		AddDiscoveredTitle(titleInfo);
+}
+
+void CafeTitleList::AddScannedDirectory(const fs::path& path)
+{
+	std::unique_lock _lock(sTLScannedDirectoriesMutex);
+	sTLScannedDirectories.emplace_back(path);
 }
 
 bool CafeTitleList::RefreshWorkerThread()
@@ -274,10 +484,13 @@ bool CafeTitleList::RefreshWorkerThread()
 		// at the end of scanning, we can then use this list to identify and remove any titles that are no longer discoverable
 		sTLListPending = sTLList;
 		sTLMutex.unlock();
+		sTLScannedDirectories.clear();
+		sTLIndexScanned.clear();
 		// scan game paths
 		for (auto& it : gamePaths)
-			ScanGamePath(it);
+			ThreadPool::Submit(ThreadPool::Priority::Normal, [it]() { ScanGamePath(it); }, &sTLScanTaskGroup);
 		// scan MLC
+		std::vector<fs::path> watchRoots = gamePaths;
 		if (!mlcPath.empty())
 		{
 			std::error_code ec;
@@ -285,12 +498,32 @@ bool CafeTitleList::RefreshWorkerThread()
 			{
 				if (!it.is_directory(ec))
 					continue;
-				ScanMLCPath(it.path());
+				fs::path titleGroupPath = it.path();
+				ThreadPool::Submit(ThreadPool::Priority::Normal, [titleGroupPath]() { ScanMLCPath(titleGroupPath); }, &sTLScanTaskGroup);
 			}
-			ScanMLCPath(mlcPath / "sys/title/00050010");
-			ScanMLCPath(mlcPath / "sys/title/00050030");
+			ThreadPool::Submit(ThreadPool::Priority::Normal, [mlcPath]() { ScanMLCPath(mlcPath / "sys/title/00050010"); }, &sTLScanTaskGroup);
+			ThreadPool::Submit(ThreadPool::Priority::Normal, [mlcPath]() { ScanMLCPath(mlcPath / "sys/title/00050030"); }, &sTLScanTaskGroup);
+			AddScannedDirectory(mlcPath / "usr/title");
+			watchRoots.emplace_back(mlcPath / "usr/title");
+			watchRoots.emplace_back(mlcPath / "sys/title/00050010");
+			watchRoots.emplace_back(mlcPath / "sys/title/00050030");
 		}
+		sTLScanTaskGroup.Wait();
+
+		// drop index entries of files which no longer exist
+		sTLIndexMutex.lock();
+		if (sTLIndexScanned.size() != sTLIndex.size())
+			sTLIndexDirty = true;
+		sTLIndex.swap(sTLIndexScanned);
+		sTLIndexScanned.clear();
+		sTLIndexMutex.unlock();
+		// watch the scanned directories so that later changes trigger a rescan
+		sTLMutex.lock();
+		if (sTLWatcher)
+			sTLWatcher->SetDirectories(watchRoots, sTLScannedDirectories);
+		sTLMutex.unlock();
 
+		sTLMutex.lock();
 		// remove any titles that are still pending
 		for (auto& itPending : sTLListPending)
 		{
@@ -310,6 +543,7 @@ bool CafeTitleList::RefreshWorkerThread()
 			delete itPending;
 		}
 		sTLListPending.clear();
+		sTLMutex.unlock();
 	}
 	sTLMutex.lock();
 	sTLRefreshWorkerActive = false;
@@ -325,6 +559,11 @@ bool CafeTitleList::RefreshWorkerThread()
 		StoreCacheFile();
 		sTLCacheDirty = false;
 	}
+	if (sTLIndexDirty)
+	{
+		StoreIndexFile();
+		sTLIndexDirty = false;
+	}
 	return true;
 }
 
@@ -400,7 +639,10 @@ void CafeTitleList::ScanGamePath(const fs::path& path)
 		}
 	}
 
+	AddScannedDirectory(path);
+
 	// always check individual files
+	// opening a file is slow, especially on network storage, so every file and subdirectory is handled by a separate task
 	for (auto& it : filesInDirectory)
 	{
 		// since checking individual files is slow, we limit it to known file names or extensions
@@ -408,7 +650,7 @@ void CafeTitleList::ScanGamePath(const fs::path& path)
 			continue;
 		if (!_IsKnownFileNameOrExtension(it))
 			continue;
-		AddTitleFromPath(it);
+		ThreadPool::Submit(ThreadPool::Priority::Normal, [it]() { ScanTitleFile(it); }, &sTLScanTaskGroup);
 	}
 	// is the current directory a title folder?
 	if (hasContentFolder && hasCodeFolder && hasMetaFolder)
@@ -428,7 +670,7 @@ void CafeTitleList::ScanGamePath(const fs::path& path)
 				if (!boost::iequals(dirName, "content") &&
 					!boost::iequals(dirName, "code") &&
 					!boost::iequals(dirName, "meta"))
-					ScanGamePath(it);
+					ThreadPool::Submit(ThreadPool::Priority::Normal, [it]() { ScanGamePath(it); }, &sTLScanTaskGroup);
 			}
 		}
 	}
@@ -436,13 +678,16 @@ void CafeTitleList::ScanGamePath(const fs::path& path)
 	{
 		// scan subdirectories
 		for (auto& it : dirsInDirectory)
-			ScanGamePath(it);
+			ThreadPool::Submit(ThreadPool::Priority::Normal, [it]() { ScanGamePath(it); }, &sTLScanTaskGroup);
 	}
 }
 
 void CafeTitleList::ScanMLCPath(const fs::path& path)
 {
 	std::error_code ec;
+	if (!fs::is_directory(path, ec))
+		return;
+	AddScannedDirectory(path);
 	for (auto& it : fs::directory_iterator(path, ec))
 	{
 		if (!it.is_directory())
@@ -464,16 +709,19 @@ void CafeTitleList::ScanMLCPath(const fs::path& path)
 		if(containsNoHexCharacter)
 			continue;
 
-		if (fs::is_directory(it.path() / "code", ec) &&
-			fs::is_directory(it.path() / "content", ec) &&
-			fs::is_directory(it.path() / "meta", ec))
-		{
-			TitleInfo* titleInfo = new TitleInfo(it);
+		fs::path titlePath = it.path();
+		ThreadPool::Submit(ThreadPool::Priority::Normal, [titlePath]() {
+			std::error_code ec;
+			if (!fs::is_directory(titlePath / "code", ec) ||
+				!fs::is_directory(titlePath / "content", ec) ||
+				!fs::is_directory(titlePath / "meta", ec))
+				return;
+			TitleInfo* titleInfo = new TitleInfo(titlePath);
 			if (titleInfo->IsValid() && titleInfo->ParseXmlInfo())
 				AddDiscoveredTitle(titleInfo);
 			else
 				delete titleInfo;
-		}
+		}, &sTLScanTaskGroup);
 	}
 }
 
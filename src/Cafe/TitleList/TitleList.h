@@ -20,6 +20,7 @@ class CafeTitleList
 public:
 
 	static void Initialize(const fs::path cacheXmlFile);
+	static void Shutdown(); // stops watching the scanned directories
 	static void LoadCacheFile();
 	static void StoreCacheFile();
 
@@ -48,9 +49,14 @@ public:
 	static TitleInfo GetTitleInfoByUID(uint64 uid);
 
 private:
+	static void LoadIndexFile();
+	static void StoreIndexFile();
+
 	static bool RefreshWorkerThread();
 	static void ScanGamePath(const fs::path& path);
+	static void ScanTitleFile(const fs::path& path);
 	static void ScanMLCPath(const fs::path& path);
+	static void AddScannedDirectory(const fs::path& path);
 
 	static void AddDiscoveredTitle(TitleInfo* titleInfo);
 	static void AddTitle(TitleInfo* titleInfo);
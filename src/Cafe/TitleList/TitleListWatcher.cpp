@@ -0,0 +1,191 @@
+#include "TitleListWatcher.h"
+#include "util/helpers/helpers.h"
+
+#if BOOST_OS_LINUX && !BOOST_PLAT_ANDROID
+#include <sys/inotify.h>
+#include <sys/eventfd.h>
+#include <poll.h>
+#include <unistd.h>
+#endif
+
+TitleListWatcher::TitleListWatcher(std::function<void()> onChange) : m_onChange(std::move(onChange))
+{
+#if BOOST_OS_WINDOWS
+	m_wakeEvent = CreateEventW(nullptr, FALSE, FALSE, nullptr);
+	m_thread = std::thread(&TitleListWatcher::WatcherThread, this);
+#elif BOOST_OS_LINUX && !BOOST_PLAT_ANDROID
+	m_inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+	m_wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+	if (m_inotifyFd < 0 || m_wakeFd < 0)
+	{
+		cemuLog_log(LogType::Force, "TitleList: Unable to create file system watcher, changes to game paths require a manual refresh");
+		return;
+	}
+	m_thread = std::thread(&TitleListWatcher::WatcherThread, this);
+#endif
+}
+
+TitleListWatcher::~TitleListWatcher()
+{
+	m_shutdown = true;
+#if BOOST_OS_WINDOWS
+	SetEvent(m_wakeEvent);
+#elif BOOST_OS_LINUX && !BOOST_PLAT_ANDROID
+	if (m_wakeFd >= 0)
+	{
+		uint64 v = 1;
+		write(m_wakeFd, &v, sizeof(v));
+	}
+#endif
+	if (m_thread.joinable())
+		m_thread.join();
+#if BOOST_OS_WINDOWS
+	CloseHandle(m_wakeEvent);
+#elif BOOST_OS_LINUX && !BOOST_PLAT_ANDROID
+	if (m_inotifyFd >= 0)
+		close(m_inotifyFd);
+	if (m_wakeFd >= 0)
+		close(m_wakeFd);
+#endif
+}
+
+void TitleListWatcher::SetDirectories(const std::vector<fs::path>& roots, const std::vector<fs::path>& directories)
+{
+#if BOOST_OS_WINDOWS
+	// change notification handles are waited on by the watcher thread, so it also has to be the one to replace them
+	std::unique_lock _l(m_mutex);
+	m_pendingRoots = roots;
+	m_hasPendingRoots = true;
+	_l.unlock();
+	SetEvent(m_wakeEvent);
+#elif BOOST_OS_LINUX && !BOOST_PLAT_ANDROID
+	if (m_inotifyFd < 0)
+		return;
+	std::unique_lock _l(m_mutex);
+	for (int wd : m_watchDescriptors)
+		inotify_rm_watch(m_inotifyFd, wd);
+	m_watchDescriptors.clear();
+	// inotify is not recursive, every directory needs its own watch
+	bool hasFailedWatch = false;
+	for (auto& it : directories)
+	{
+		int wd = inotify_add_watch(m_inotifyFd, it.c_str(), IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO | IN_CLOSE_WRITE | IN_DELETE_SELF | IN_MOVE_SELF | IN_ONLYDIR);
+		if (wd < 0)
+		{
+			hasFailedWatch = true;
+			continue;
+		}
+		m_watchDescriptors.emplace_back(wd);
+	}
+	if (hasFailedWatch)
+		cemuLog_log(LogType::Force, "TitleList: Unable to watch all game directories for changes ({} of {} watched)", m_watchDescriptors.size(), directories.size());
+#endif
+}
+
+#if BOOST_OS_WINDOWS
+void TitleListWatcher::WatcherThread()
+{
+	SetThreadName("TitleListWatch");
+	std::vector<HANDLE> waitHandles{m_wakeEvent};
+	bool hasUnsettledChanges = false;
+	while (!m_shutdown)
+	{
+		DWORD r = WaitForMultipleObjects((DWORD)waitHandles.size(), waitHandles.data(), FALSE, hasUnsettledChanges ? SETTLE_TIME_MS : INFINITE);
+		if (r == WAIT_TIMEOUT)
+		{
+			hasUnsettledChanges = false;
+			m_onChange();
+			continue;
+		}
+		if (r == WAIT_OBJECT_0)
+		{
+			// woken up for shutdown or to replace the watched directories
+			std::unique_lock _l(m_mutex);
+			if (!m_hasPendingRoots)
+				continue;
+			m_hasPendingRoots = false;
+			std::vector<fs::path> roots = std::move(m_pendingRoots);
+			_l.unlock();
+			for (size_t i = 1; i < waitHandles.size(); i++)
+				FindCloseChangeNotification(waitHandles[i]);
+			waitHandles.resize(1);
+			for (auto& it : roots)
+			{
+				if (waitHandles.size() >= MAXIMUM_WAIT_OBJECTS)
+				{
+					cemuLog_log(LogType::Force, "TitleList: Too many game paths, only the first {} are watched for changes", MAXIMUM_WAIT_OBJECTS - 1);
+					break;
+				}
+				HANDLE h = FindFirstChangeNotificationW(it.c_str(), TRUE, FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_DIR_NAME | FILE_NOTIFY_CHANGE_SIZE | FILE_NOTIFY_CHANGE_LAST_WRITE);
+				if (h != INVALID_HANDLE_VALUE)
+					waitHandles.emplace_back(h);
+			}
+			continue;
+		}
+		if (r > WAIT_OBJECT_0 && r < WAIT_OBJECT_0 + waitHandles.size())
+		{
+			FindNextChangeNotification(waitHandles[r - WAIT_OBJECT_0]);
+			hasUnsettledChanges = true;
+			continue;
+		}
+		cemuLog_log(LogType::Force, "TitleList: Waiting for directory changes failed");
+		break;
+	}
+	for (size_t i = 1; i < waitHandles.size(); i++)
+		FindCloseChangeNotification(waitHandles[i]);
+}
+#elif BOOST_OS_LINUX && !BOOST_PLAT_ANDROID
+void TitleListWatcher::WatcherThread()
+{
+	SetThreadName("TitleListWatch");
+	alignas(inotify_event) uint8 eventBuffer[4096];
+	bool hasUnsettledChanges = false;
+	while (!m_shutdown)
+	{
+		pollfd fds[2]{};
+		fds[0].fd = m_inotifyFd;
+		fds[0].events = POLLIN;
+		fds[1].fd = m_wakeFd;
+		fds[1].events = POLLIN;
+		int r = poll(fds, 2, hasUnsettledChanges ? (int)SETTLE_TIME_MS : -1);
+		if (r == 0)
+		{
+			hasUnsettledChanges = false;
+			m_onChange();
+			continue;
+		}
+		if (r < 0)
+		{
+			if (errno == EINTR)
+				continue;
+			cemuLog_log(LogType::Force, "TitleList: Waiting for directory changes failed");
+			break;
+		}
+		if (fds[1].revents & POLLIN)
+		{
+			uint64 v;
+			read(m_wakeFd, &v, sizeof(v));
+		}
+		if (!(fds[0].revents & POLLIN))
+			continue;
+		while (true)
+		{
+			ssize_t length = read(m_inotifyFd, eventBuffer, sizeof(eventBuffer));
+			if (length <= 0)
+				break;
+			for (ssize_t offset = 0; offset < length;)
+			{
+				inotify_event* evt = (inotify_event*)(eventBuffer + offset);
+				// removing watches when the directories are replaced generates IN_IGNORED, which must not trigger another refresh
+				if (!(evt->mask & IN_IGNORED))
+					hasUnsettledChanges = true;
+				offset += sizeof(inotify_event) + evt->len;
+			}
+		}
+	}
+}
+#else
+void TitleListWatcher::WatcherThread()
+{
+}
+#endif
@@ -0,0 +1,33 @@
+#pragma once
+
+// watches the game and MLC directories and invokes a callback once file changes settled down
+// used to refresh the title list without the user having to trigger a rescan. Only implemented for Windows and Linux
+class TitleListWatcher
+{
+public:
+	TitleListWatcher(std::function<void()> onChange);
+	~TitleListWatcher();
+
+	// replaces the set of watched directories
+	// roots are watched including all their subdirectories where the host supports it, otherwise every entry of directories is watched individually
+	void SetDirectories(const std::vector<fs::path>& roots, const std::vector<fs::path>& directories);
+
+private:
+	void WatcherThread();
+
+	static constexpr uint32 SETTLE_TIME_MS = 2000; // wait this long after the last change before notifying, so copying a large file only triggers one refresh
+
+	std::function<void()> m_onChange;
+	std::thread m_thread;
+	std::atomic_bool m_shutdown{false};
+	std::mutex m_mutex;
+#if BOOST_OS_WINDOWS
+	HANDLE m_wakeEvent{};
+	std::vector<fs::path> m_pendingRoots;
+	bool m_hasPendingRoots{false};
+#elif BOOST_OS_LINUX && !BOOST_PLAT_ANDROID
+	int m_inotifyFd{-1};
+	int m_wakeFd{-1};
+	std::vector<int> m_watchDescriptors;
+#endif
+};
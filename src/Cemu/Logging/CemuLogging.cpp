@@ -71,13 +71,115 @@ void cemuLog_clearCallbacks()
 	s_loggingDispatcher.clearCallbacks();
 }
 
+enum class LogRecordKind : uint8
+{
+	Text, // payload is the message
+	Deferred, // payload are the arguments for formatFunc
+	Padding, // skips the remaining space at the end of the buffer
+};
+
+struct LogRecordHeader
+{
+	// padding records only use the first two fields
+	uint32 recordSize; // including header, rounded up to 8 byte alignment
+	LogRecordKind kind;
+	LogType type;
+	uint32 payloadSize;
+	uint64 timestamp; // system clock in nanoseconds, used to restore the order of lines across threads
+	uint32 formatStrLength; // deferred records store the format string after the arguments
+	CemuLogDeferred::FormatFunc formatFunc;
+};
+
+// single producer single consumer ring buffer of log records
+// written by the owning thread without any locks, read by the log writer thread
+class LogThreadBuffer
+{
+public:
+	static constexpr uint32 CAPACITY = 256 * 1024; // must be a power of two
+	static constexpr uint32 MAX_PAYLOAD_SIZE = CAPACITY / 4; // larger messages take the locked path
+
+	LogThreadBuffer() : m_data(new uint8[CAPACITY]) {};
+
+	// producer side. Returns nullptr if there is not enough free space
+	LogRecordHeader* BeginRecord(uint32 payloadSize)
+	{
+		uint32 recordSize = (uint32)((sizeof(LogRecordHeader) + payloadSize + 7) & ~7);
+		uint64 writePos = m_writePos.load(std::memory_order::relaxed);
+		uint64 readPos = m_readPos.load(std::memory_order::acquire);
+		uint32 offset = (uint32)(writePos & (CAPACITY - 1));
+		// records are never split, if it doesn't fit into the end of the buffer the remaining space is skipped
+		uint32 paddingSize = (CAPACITY - offset) < recordSize ? (CAPACITY - offset) : 0;
+		if (writePos + paddingSize + recordSize - readPos > CAPACITY)
+			return nullptr;
+		if (paddingSize != 0)
+		{
+			LogRecordHeader* padding = (LogRecordHeader*)(m_data.get() + offset);
+			padding->recordSize = paddingSize;
+			padding->kind = LogRecordKind::Padding;
+			writePos += paddingSize;
+			offset = 0;
+		}
+		m_pendingWritePos = writePos + recordSize;
+		LogRecordHeader* header = (LogRecordHeader*)(m_data.get() + offset);
+		header->recordSize = recordSize;
+		header->payloadSize = payloadSize;
+		return header;
+	}
+
+	// returns true if the buffer is more than half full and the writer should be woken up early
+	bool CommitRecord()
+	{
+		m_writePos.store(m_pendingWritePos, std::memory_order::release);
+		return (m_pendingWritePos - m_readPos.load(std::memory_order::relaxed)) > CAPACITY / 2;
+	}
+
+	void CountDroppedRecord()
+	{
+		m_droppedCount.fetch_add(1, std::memory_order::relaxed);
+	}
+
+	// consumer side
+	uint64 GetReadPos() const { return m_readPos.load(std::memory_order::relaxed); }
+	uint64 GetWritePos() const { return m_writePos.load(std::memory_order::acquire); }
+	const LogRecordHeader* GetRecord(uint64 pos) const { return (const LogRecordHeader*)(m_data.get() + (pos & (CAPACITY - 1))); }
+	// hands the space up to pos back to the producer. Records must not be accessed afterwards
+	void Release(uint64 pos) { m_readPos.store(pos, std::memory_order::release); }
+	uint64 TakeDroppedCount() { return m_droppedCount.exchange(0, std::memory_order::relaxed); }
+
+	std::atomic<bool> isOrphaned{false}; // set when the owning thread exited, the buffer is deleted by the writer once drained
+
+private:
+	std::unique_ptr<uint8[]> m_data;
+	std::atomic<uint64> m_writePos{0};
+	std::atomic<uint64> m_readPos{0};
+	uint64 m_pendingWritePos{0};
+	std::atomic<uint64> m_droppedCount{0};
+};
+
+// lines which bypass the thread buffers. Written with cemuLog_writeLineToLog() or messages which did not fit into their thread's buffer
+struct LogLine
+{
+	uint64 timestamp;
+	LogType type;
+	bool isRawText; // raw text is only written to the log file. Otherwise it's a message which is handled like a record
+	std::string text;
+};
+
 struct _LogContext
 {
-	std::condition_variable_any log_condition;
-	std::recursive_mutex log_mutex;
+	std::recursive_mutex log_mutex; // protects text_cache
+	std::vector<LogLine> text_cache;
+	std::mutex file_mutex;
 	std::ofstream file_stream;
-	std::vector<std::string> text_cache;
+	std::string file_pending; // output from before the log file was created
+	std::mutex buffers_mutex;
+	std::vector<LogThreadBuffer*> thread_buffers;
+	std::mutex writer_mutex;
+	std::condition_variable writer_condition; // wakes up the writer thread
+	std::condition_variable flush_condition; // signaled after every pass of the writer thread
+	uint64 writer_passCount = 0;
 	std::thread log_writer;
+	std::once_flag writer_started;
 	std::atomic<bool> threadRunning = false;
 
 	~_LogContext()
@@ -86,7 +188,7 @@ struct _LogContext
 		threadRunning.store(false);
 		if (log_writer.joinable())
 		{
-			log_condition.notify_one();
+			writer_condition.notify_one();
 			log_writer.join();
 		}
 	}
@@ -116,6 +218,7 @@ const std::map<LogType, std::string> g_logging_window_mapping
 	{LogType::Patches,            "Graphic pack patches"},
 	{LogType::TextureCache,       "Texture cache"},
 	{LogType::TextureReadback,    "Texture readback"},
+	{LogType::RPLLoader,          "RPL loader"},
 	{LogType::OpenGLLogging,      "OpenGL debug output"},
 	{LogType::VulkanValidation,   "Vulkan validation layer"},
 };
@@ -125,28 +228,208 @@ bool cemuLog_advancedPPCLoggingEnabled()
 	return GetConfig().advanced_ppc_logging;
 }
 
+uint64 cemuLog_getTimestamp()
+{
+	return (uint64)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+void cemuLog_appendTime(std::string& out, uint64 timestamp)
+{
+	const auto timePoint = std::chrono::system_clock::time_point(std::chrono::duration_cast<std::chrono::system_clock::duration>(std::chrono::nanoseconds(timestamp)));
+	const auto temp_time = std::chrono::system_clock::to_time_t(timePoint);
+	const auto& time = *std::localtime(&temp_time);
+	fmt::format_to(std::back_inserter(out), "[{:02d}:{:02d}:{:02d}.{:03d}] ", time.tm_hour, time.tm_min, time.tm_sec, (timestamp / 1000000) % 1000);
+}
+
+void cemuLog_formatRecord(const LogRecordHeader* record, fmt::memory_buffer& out)
+{
+	const uint8* payload = (const uint8*)(record + 1);
+	if (record->kind == LogRecordKind::Text)
+	{
+		out.append((const char*)payload, (const char*)payload + record->payloadSize);
+		return;
+	}
+	std::string_view formatStr((const char*)payload + record->payloadSize - record->formatStrLength, record->formatStrLength);
+	try
+	{
+		record->formatFunc(formatStr, payload, out);
+	}
+	catch (const fmt::format_error& e)
+	{
+		out.clear();
+		fmt::format_to(fmt::appender(out), "Log: Unable to format \"{}\" ({})", formatStr, e.what());
+	}
+}
+
+// output a message to the log file, stdout and the registered callbacks
+void cemuLog_writeMessage(std::string& fileOutput, LogType type, uint64 timestamp, std::string_view text)
+{
+	cemuLog_appendTime(fileOutput, timestamp);
+	fileOutput.append(text);
+	fileOutput.push_back('\n');
+
+	if (LaunchSettings::Verbose())
+		std::cout << text << std::endl;
+
+	const auto it = std::find_if(g_logging_window_mapping.cbegin(), g_logging_window_mapping.cend(),
+		[type](const auto& entry) { return entry.first == type; });
+	if (it == g_logging_window_mapping.cend())
+		s_loggingDispatcher.Log(text);
+	else
+		s_loggingDispatcher.Log(it->second, text);
+}
+
 void cemuLog_thread()
 {
 	SetThreadName("cemuLog_thread");
+	struct PendingEntry
+	{
+		uint64 timestamp;
+		const LogRecordHeader* record;
+		const LogLine* line;
+	};
+	std::vector<PendingEntry> pendingEntries;
+	std::vector<LogLine> lines;
+	std::vector<std::pair<LogThreadBuffer*, uint64>> drainedBuffers;
+	std::string fileOutput;
+	fmt::memory_buffer formatBuffer;
 	while (true)
 	{
-		std::unique_lock lock(LogContext.log_mutex);
-		while (LogContext.text_cache.empty())
+		// a pass which starts after shutdown was requested still writes out everything
+		bool isRunning = LogContext.threadRunning.load();
+		// collect records of all threads and lines which took the locked path
+		std::unique_lock linesLock(LogContext.log_mutex);
+		lines.swap(LogContext.text_cache);
+		linesLock.unlock();
+		uint64 droppedCount = 0;
+		std::unique_lock buffersLock(LogContext.buffers_mutex);
+		for (LogThreadBuffer* buffer : LogContext.thread_buffers)
+		{
+			uint64 pos = buffer->GetReadPos();
+			uint64 endPos = buffer->GetWritePos();
+			while (pos < endPos)
+			{
+				const LogRecordHeader* record = buffer->GetRecord(pos);
+				if (record->kind != LogRecordKind::Padding)
+					pendingEntries.push_back({record->timestamp, record, nullptr});
+				pos += record->recordSize;
+			}
+			drainedBuffers.emplace_back(buffer, endPos);
+			droppedCount += buffer->TakeDroppedCount();
+		}
+		buffersLock.unlock();
+		for (const LogLine& line : lines)
+			pendingEntries.push_back({line.timestamp, nullptr, &line});
+		// each thread's records are already in order, merge them by time
+		std::stable_sort(pendingEntries.begin(), pendingEntries.end(), [](const PendingEntry& a, const PendingEntry& b) { return a.timestamp < b.timestamp; });
+		for (const PendingEntry& entry : pendingEntries)
 		{
-			LogContext.log_condition.wait(lock);
-			if (!LogContext.threadRunning.load(std::memory_order::relaxed))
-				return;
+			if (entry.record)
+			{
+				formatBuffer.clear();
+				cemuLog_formatRecord(entry.record, formatBuffer);
+				cemuLog_writeMessage(fileOutput, entry.record->type, entry.timestamp, std::string_view(formatBuffer.data(), formatBuffer.size()));
+			}
+			else if (entry.line->isRawText)
+				fileOutput.append(entry.line->text);
+			else
+				cemuLog_writeMessage(fileOutput, entry.line->type, entry.timestamp, entry.line->text);
 		}
+		if (droppedCount != 0)
+			cemuLog_writeMessage(fileOutput, LogType::Force, cemuLog_getTimestamp(), fmt::format("Log: Dropped {} messages because logging could not keep up", droppedCount));
+		// write to file, or keep the output until the log file is created
+		std::unique_lock fileLock(LogContext.file_mutex);
+		if (LogContext.file_stream.is_open())
+		{
+			if (!LogContext.file_pending.empty())
+			{
+				LogContext.file_stream.write(LogContext.file_pending.data(), LogContext.file_pending.size());
+				LogContext.file_pending = {};
+			}
+			if (!fileOutput.empty())
+			{
+				LogContext.file_stream.write(fileOutput.data(), fileOutput.size());
+				LogContext.file_stream.flush();
+			}
+		}
+		else
+			LogContext.file_pending.append(fileOutput);
+		fileLock.unlock();
+		fileOutput.clear();
+		pendingEntries.clear();
+		lines.clear();
+		for (auto& [buffer, pos] : drainedBuffers)
+			buffer->Release(pos);
+		drainedBuffers.clear();
+		// delete the buffers of exited threads once they are drained
+		buffersLock.lock();
+		std::erase_if(LogContext.thread_buffers, [](LogThreadBuffer* buffer) {
+			if (!buffer->isOrphaned.load(std::memory_order::acquire) || buffer->GetReadPos() != buffer->GetWritePos())
+				return false;
+			delete buffer;
+			return true;
+		});
+		buffersLock.unlock();
+
+		std::unique_lock writerLock(LogContext.writer_mutex);
+		LogContext.writer_passCount++;
+		LogContext.flush_condition.notify_all();
+		if (!isRunning)
+			return;
+		// producers only wake up the writer when their buffer runs full, otherwise it polls
+		LogContext.writer_condition.wait_for(writerLock, std::chrono::milliseconds(10));
+	}
+}
 
-		std::vector<std::string> cache_copy;
-		cache_copy.swap(LogContext.text_cache); // fast copy & clear
-		lock.unlock();
+void cemuLog_startWriter()
+{
+	std::call_once(LogContext.writer_started, []() {
+		LogContext.threadRunning.store(true);
+		LogContext.log_writer = std::thread(cemuLog_thread);
+	});
+}
 
-		for (const auto& entry : cache_copy)
-			LogContext.file_stream.write(entry.data(), entry.size());
+// the buffer is owned by the thread until it exits, afterwards by the writer thread
+struct LogThreadState
+{
+	LogThreadBuffer* buffer{};
 
-		LogContext.file_stream.flush();
+	~LogThreadState();
+};
+
+thread_local bool s_logThreadExited = false; // trivially destructible, so it can still be checked by destructors of other thread_local objects
+thread_local LogThreadState s_logThreadState;
+
+LogThreadState::~LogThreadState()
+{
+	s_logThreadExited = true;
+	if (buffer)
+		buffer->isOrphaned.store(true, std::memory_order::release);
+}
+
+// returns nullptr if the calling thread is exiting
+LogThreadBuffer* cemuLog_getThreadBuffer()
+{
+	if (s_logThreadExited)
+		return nullptr;
+	LogThreadState& state = s_logThreadState;
+	if (!state.buffer)
+	{
+		cemuLog_startWriter();
+		state.buffer = new LogThreadBuffer();
+		std::unique_lock _l(LogContext.buffers_mutex);
+		LogContext.thread_buffers.emplace_back(state.buffer);
 	}
+	return state.buffer;
+}
+
+void cemuLog_pushLine(LogLine&& line)
+{
+	cemuLog_startWriter();
+	std::unique_lock _l(LogContext.log_mutex);
+	LogContext.text_cache.emplace_back(std::move(line));
+	_l.unlock();
+	LogContext.writer_condition.notify_one();
 }
 
 fs::path cemuLog_GetLogFilePath()
@@ -156,7 +439,7 @@ fs::path cemuLog_GetLogFilePath()
 
 void cemuLog_createLogFile(bool triggeredByCrash)
 {
-	std::unique_lock lock(LogContext.log_mutex);
+	std::unique_lock lock(LogContext.file_mutex);
 	if (LogContext.file_stream.is_open())
 		return;
 
@@ -167,35 +450,54 @@ void cemuLog_createLogFile(bool triggeredByCrash)
 		cemu_assert_debug(false);
 		return;
 	}
-
-	LogContext.threadRunning.store(true);
-	LogContext.log_writer = std::thread(cemuLog_thread);
 	lock.unlock();
+
+	cemuLog_startWriter();
 }
 
 void cemuLog_writeLineToLog(std::string_view text, bool date, bool new_line)
 {
-	std::unique_lock lock(LogContext.log_mutex);
-
+	LogLine line{cemuLog_getTimestamp(), LogType::Force, true};
 	if (date)
-	{
-		const auto now = std::chrono::system_clock::now();
-		const auto temp_time = std::chrono::system_clock::to_time_t(now);
-		const auto& time = *std::localtime(&temp_time);
-
-		auto time_str = fmt::format("[{:02d}:{:02d}:{:02d}.{:03d}] ", time.tm_hour, time.tm_min, time.tm_sec,
-			std::chrono::duration_cast<std::chrono::milliseconds>(now - std::chrono::time_point_cast<std::chrono::seconds>(now)).count());
+		cemuLog_appendTime(line.text, line.timestamp);
+	line.text.append(text);
+	if (new_line)
+		line.text.push_back('\n');
+	cemuLog_pushLine(std::move(line));
+}
 
-		LogContext.text_cache.emplace_back(std::move(time_str));
+uint8* cemuLog_beginDeferredRecord(LogType type, fmt::string_view formatStr, CemuLogDeferred::FormatFunc formatFunc, size_t argsSize, bool& formatImmediately)
+{
+	LogThreadBuffer* buffer = cemuLog_getThreadBuffer();
+	// the format string is copied as well, fmt::runtime() allows passing strings which don't outlive the call
+	size_t payloadSize = argsSize + formatStr.size();
+	if (!buffer || payloadSize > LogThreadBuffer::MAX_PAYLOAD_SIZE)
+	{
+		formatImmediately = true;
+		return nullptr;
 	}
+	LogRecordHeader* record = buffer->BeginRecord((uint32)payloadSize);
+	if (!record)
+	{
+		if (type == LogType::Force)
+			formatImmediately = true;
+		else
+			buffer->CountDroppedRecord();
+		return nullptr;
+	}
+	record->kind = LogRecordKind::Deferred;
+	record->type = type;
+	record->timestamp = cemuLog_getTimestamp();
+	record->formatStrLength = (uint32)formatStr.size();
+	record->formatFunc = formatFunc;
+	memcpy((uint8*)(record + 1) + argsSize, formatStr.data(), formatStr.size());
+	return (uint8*)(record + 1);
+}
 
-	LogContext.text_cache.emplace_back(text);
-
-	if (new_line)
-		LogContext.text_cache.emplace_back("\n");
-
-	lock.unlock();
-	LogContext.log_condition.notify_one();
+void cemuLog_commitDeferredRecord()
+{
+	if (s_logThreadState.buffer->CommitRecord())
+		LogContext.writer_condition.notify_one();
 }
 
 bool cemuLog_log(LogType type, std::string_view text)
@@ -203,18 +505,26 @@ bool cemuLog_log(LogType type, std::string_view text)
 	if (!cemuLog_isLoggingEnabled(type))
 		return false;
 
-	if (LaunchSettings::Verbose())
-		std::cout << text << std::endl;
-
-	cemuLog_writeLineToLog(text);
-
-	const auto it = std::find_if(g_logging_window_mapping.cbegin(), g_logging_window_mapping.cend(),
-		[type](const auto& entry) { return entry.first == type; });
-	if (it == g_logging_window_mapping.cend())
-		s_loggingDispatcher.Log(text);
-	else
-		s_loggingDispatcher.Log(it->second, text);
-
+	LogThreadBuffer* buffer = cemuLog_getThreadBuffer();
+	bool fitsIntoBuffer = buffer && text.size() <= LogThreadBuffer::MAX_PAYLOAD_SIZE;
+	LogRecordHeader* record = fitsIntoBuffer ? buffer->BeginRecord((uint32)text.size()) : nullptr;
+	if (record)
+	{
+		record->kind = LogRecordKind::Text;
+		record->type = type;
+		record->timestamp = cemuLog_getTimestamp();
+		memcpy(record + 1, text.data(), text.size());
+		if (buffer->CommitRecord())
+			LogContext.writer_condition.notify_one();
+		return true;
+	}
+	if (fitsIntoBuffer && type != LogType::Force)
+	{
+		buffer->CountDroppedRecord();
+		return true;
+	}
+	// too large for the buffer, or a message which must not be dropped
+	cemuLog_pushLine({cemuLog_getTimestamp(), type, false, std::string(text)});
 	return true;
 }
 
@@ -245,13 +555,13 @@ void cemuLog_logHexDump(LogType type, const void* data, size_t size, size_t line
 void cemuLog_waitForFlush()
 {
 	cemuLog_createLogFile(false);
-	std::unique_lock lock(LogContext.log_mutex);
-	while(!LogContext.text_cache.empty())
+	std::unique_lock lock(LogContext.writer_mutex);
+	// a pass which is already in progress can miss lines logged before this call, so wait for one full pass after it
+	uint64 targetPassCount = LogContext.writer_passCount + 2;
+	while (LogContext.writer_passCount < targetPassCount && LogContext.threadRunning.load())
 	{
-		lock.unlock();
-		std::this_thread::sleep_for(std::chrono::milliseconds(1));
-		std::this_thread::yield();
-		lock.lock();
+		LogContext.writer_condition.notify_one();
+		LogContext.flush_condition.wait(lock);
 	}
 }
 
@@ -39,6 +39,7 @@ enum class LogType : sint32
 	NN_SL = 26,
 
 	TextureReadback = 29,
+	RPLLoader = 30, // module loading times at boot
 	ProcUi = 39,
 	nlibcurl = 41,
 
@@ -78,13 +79,108 @@ bool cemuLog_log(LogType type, std::string_view text);
 bool cemuLog_log(LogType type, std::u8string_view text);
 void cemuLog_waitForFlush(); // wait until all log lines are written
 
+// log messages are not written by the calling thread. They are stored as binary records in a lock-free buffer owned by the thread and formatted by the log writer thread
+// if the buffer of a thread is full, messages are dropped and counted instead of waiting for the writer. LogType::Force messages are never dropped
+namespace CemuLogDeferred
+{
+	using FormatFunc = void(*)(fmt::string_view formatStr, const uint8* args, fmt::memory_buffer& out);
+
+	template<typename T>
+	constexpr bool IsString = std::is_same_v<T, std::string> || std::is_same_v<T, std::string_view> || std::is_same_v<T, const char*> || std::is_same_v<T, char*>;
+
+	// argument types which can be copied into a record. Strings are copied by content, messages with any other argument type are formatted by the calling thread
+	template<typename T>
+	constexpr bool IsDeferrable = IsString<T> || std::is_arithmetic_v<T> || std::is_enum_v<T> || std::is_pointer_v<T>;
+
+	template<typename T>
+	using StorageType = std::conditional_t<IsString<T>, std::string_view, T>;
+
+	inline std::string_view ToStringView(std::string_view s) { return s; }
+	inline std::string_view ToStringView(const char* s) { return s ? std::string_view(s) : std::string_view("(null)"); }
+
+	template<typename T>
+	size_t GetSize(const T& arg)
+	{
+		if constexpr (IsString<T>)
+			return sizeof(uint32) + ToStringView(arg).size();
+		else
+			return sizeof(T);
+	}
+
+	template<typename T>
+	uint8* Write(uint8* p, const T& arg)
+	{
+		if constexpr (IsString<T>)
+		{
+			std::string_view s = ToStringView(arg);
+			uint32 length = (uint32)s.size();
+			memcpy(p, &length, sizeof(uint32));
+			memcpy(p + sizeof(uint32), s.data(), length);
+			return p + sizeof(uint32) + length;
+		}
+		else
+		{
+			memcpy(p, &arg, sizeof(T));
+			return p + sizeof(T);
+		}
+	}
+
+	template<typename T>
+	StorageType<T> Read(const uint8*& p)
+	{
+		if constexpr (IsString<T>)
+		{
+			uint32 length;
+			memcpy(&length, p, sizeof(uint32));
+			std::string_view s((const char*)p + sizeof(uint32), length);
+			p += sizeof(uint32) + length;
+			return s;
+		}
+		else
+		{
+			T arg;
+			memcpy(&arg, p, sizeof(T));
+			p += sizeof(T);
+			return arg;
+		}
+	}
+
+	template<typename... TArgs>
+	void Format(fmt::string_view formatStr, const uint8* args, fmt::memory_buffer& out)
+	{
+		// arguments in a braced initializer list are evaluated left to right
+		std::tuple<StorageType<TArgs>...> values{ Read<TArgs>(args)... };
+		std::apply([&](auto&... v) { fmt::vformat_to(fmt::appender(out), formatStr, fmt::make_format_args(v...)); }, values);
+	}
+}
+
+// returns the memory the arguments are written to, to be followed by cemuLog_commitDeferredRecord()
+// returns nullptr if the message was dropped or if formatImmediately is set, in which case the caller has to format the message itself
+uint8* cemuLog_beginDeferredRecord(LogType type, fmt::string_view formatStr, CemuLogDeferred::FormatFunc formatFunc, size_t argsSize, bool& formatImmediately);
+void cemuLog_commitDeferredRecord();
+
+// the format string and the arguments are copied into the record, so neither has to outlive the call
 template<typename... TArgs>
 bool cemuLog_log(LogType type, fmt::format_string<TArgs...> formatStr, TArgs&&... args)
 {
 	if (!cemuLog_isLoggingEnabled(type))
 		return false;
 
-	cemuLog_log(type, fmt::format(formatStr, std::forward<TArgs>(args)...));
+	if constexpr ((CemuLogDeferred::IsDeferrable<std::decay_t<TArgs>> && ...))
+	{
+		size_t argsSize = (CemuLogDeferred::GetSize<std::decay_t<TArgs>>(args) + ... + 0);
+		bool formatImmediately = false;
+		uint8* p = cemuLog_beginDeferredRecord(type, fmt::string_view(formatStr), &CemuLogDeferred::Format<std::decay_t<TArgs>...>, argsSize, formatImmediately);
+		if (p)
+		{
+			((p = CemuLogDeferred::Write<std::decay_t<TArgs>>(p, args)), ...);
+			cemuLog_commitDeferredRecord();
+		}
+		else if (formatImmediately)
+			cemuLog_log(type, fmt::format(formatStr, std::forward<TArgs>(args)...));
+	}
+	else
+		cemuLog_log(type, fmt::format(formatStr, std::forward<TArgs>(args)...));
 
 	return true;
 }
@@ -123,7 +219,7 @@ uint64 cemuLog_getFlag(LogType type);
 
 fs::path cemuLog_GetLogFilePath();
 void cemuLog_createLogFile(bool triggeredByCrash);
-[[nodiscard]] std::unique_lock<std::recursive_mutex> cemuLog_acquire(); // used for logging multiple lines at once
+[[nodiscard]] std::unique_lock<std::recursive_mutex> cemuLog_acquire(); // used for logging multiple lines at once. Lines of one thread always stay in order, but lines logged by other threads in the meantime can still be interleaved
 
 class LoggingCallbacks
 {
@@ -8,3 +8,6 @@ void CrashLog_WriteLine(std::string_view text, bool newLine = true);
 void CrashLog_WriteHeader(const char* header);
 
 void ExceptionHandler_LogGeneralInfo();
+
+// copies from a memory mapped file. Returns false instead of crashing if the underlying file can no longer be read (I/O error, removed media, truncated file)
+bool ExceptionHandler_CopyFromMappedFile(void* dst, const void* src, size_t size);
@@ -1,4 +1,5 @@
 #include <signal.h>
+#include <setjmp.h>
 #include <execinfo.h>
 #include <string.h>
 #include <string>
@@ -8,6 +9,7 @@
 
 #include "Cafe/HW/Espresso/Debugger/GDBStub.h"
 #include "Cafe/HW/Espresso/Debugger/GDBBreakpoints.h"
+#include "Cafe/HW/Espresso/Debugger/MemoryWatchpoints.h"
 
 #if BOOST_OS_LINUX
 #include "ELFSymbolTable.h"
@@ -65,9 +67,31 @@ void DemangleAndPrintBacktrace(char** backtrace, size_t size)
 }
 #endif
 
+// set while the current thread reads from a memory mapped file. Accessing a page that can't be read from the file raises SIGBUS
+static thread_local sigjmp_buf* s_mappedFileReadJmpBuf = nullptr;
+
+bool ExceptionHandler_CopyFromMappedFile(void* dst, const void* src, size_t size)
+{
+	sigjmp_buf jmpBuf;
+	if (sigsetjmp(jmpBuf, 1) != 0)
+	{
+		s_mappedFileReadJmpBuf = nullptr;
+		return false;
+	}
+	// the fences keep the compiler from moving the stores past the copy, it can't see that the signal handler reads them
+	s_mappedFileReadJmpBuf = &jmpBuf;
+	std::atomic_signal_fence(std::memory_order::seq_cst);
+	memcpy(dst, src, size);
+	std::atomic_signal_fence(std::memory_order::seq_cst);
+	s_mappedFileReadJmpBuf = nullptr;
+	return true;
+}
+
 // handle signals that would dump core, print stacktrace and then dump depending on config
 void handlerDumpingSignal(int sig, siginfo_t *info, void *context)
 {
+	if (sig == SIGBUS && s_mappedFileReadJmpBuf)
+		siglongjmp(*s_mappedFileReadJmpBuf, 1);
 #if defined(ARCH_X86_64) && BOOST_OS_LINUX
 	// Check for hardware breakpoints
 	if (info->si_signo == SIGTRAP && info->si_code == TRAP_HWBKPT)
@@ -76,6 +100,18 @@ void handlerDumpingSignal(int sig, siginfo_t *info, void *context)
 		g_gdbstub->HandleAccessException(dr6);
 		return;
 	}
+	// Check for page protection based watchpoints
+	greg_t* gregs = ((ucontext_t*)context)->uc_mcontext.gregs;
+	if (info->si_signo == SIGSEGV && MemoryWatchpoints::HandleAccessFault(info->si_addr, (gregs[REG_ERR] & 2) != 0, (const void*)gregs[REG_RIP]))
+	{
+		gregs[REG_EFL] |= 0x100; // set trap flag to single step the access
+		return;
+	}
+	if (info->si_signo == SIGTRAP && info->si_code == TRAP_TRACE && MemoryWatchpoints::HandleSingleStep())
+	{
+		gregs[REG_EFL] &= ~0x100; // clear trap flag
+		return;
+	}
 #endif
 
     if(!CrashLog_Create())
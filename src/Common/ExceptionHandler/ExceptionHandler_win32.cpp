@@ -11,9 +11,31 @@
 #include "Cafe/OS/libs/coreinit/coreinit_Thread.h"
 #include "Cafe/HW/Espresso/PPCState.h"
 #include "Cafe/HW/Espresso/Debugger/GDBStub.h"
+#include "Cafe/HW/Espresso/Debugger/MemoryWatchpoints.h"
 
 LONG handleException_SINGLE_STEP(PEXCEPTION_POINTERS pExceptionInfo)
 {
+#if defined(ARCH_X86_64)
+	if (MemoryWatchpoints::HandleSingleStep())
+	{
+		pExceptionInfo->ContextRecord->EFlags &= ~0x100; // clear trap flag
+		return EXCEPTION_CONTINUE_EXECUTION;
+	}
+#endif
+	return EXCEPTION_CONTINUE_SEARCH;
+}
+
+LONG handleException_ACCESS_VIOLATION(PEXCEPTION_POINTERS pExceptionInfo)
+{
+#if defined(ARCH_X86_64)
+	// ExceptionInformation[0] is 1 for write accesses, ExceptionInformation[1] holds the accessed address
+	bool isWrite = pExceptionInfo->ExceptionRecord->ExceptionInformation[0] == 1;
+	if (MemoryWatchpoints::HandleAccessFault((void*)pExceptionInfo->ExceptionRecord->ExceptionInformation[1], isWrite, (const void*)pExceptionInfo->ContextRecord->Rip))
+	{
+		pExceptionInfo->ContextRecord->EFlags |= 0x100; // set trap flag to single step the access
+		return EXCEPTION_CONTINUE_EXECUTION;
+	}
+#endif
 	return EXCEPTION_CONTINUE_SEARCH;
 }
 
@@ -253,9 +275,6 @@ int crashlogThread(void* exceptionInfoRawPtr)
 	return 0;
 }
 
-void debugger_handleSingleStepException(uint64 dr6);
-
-
 LONG WINAPI VectoredExceptionHandler(PEXCEPTION_POINTERS pExceptionInfo)
 {
 	if (pExceptionInfo->ExceptionRecord->ExceptionCode == EXCEPTION_SINGLE_STEP)
@@ -264,12 +283,12 @@ LONG WINAPI VectoredExceptionHandler(PEXCEPTION_POINTERS pExceptionInfo)
 		if (r != EXCEPTION_CONTINUE_SEARCH)
 			return r;
 
-		if (GetBits(pExceptionInfo->ContextRecord->Dr6, 0, 1) || GetBits(pExceptionInfo->ContextRecord->Dr6, 1, 1))
-			debugger_handleSingleStepException(pExceptionInfo->ContextRecord->Dr6);
-		else if (GetBits(pExceptionInfo->ContextRecord->Dr6, 2, 1) || GetBits(pExceptionInfo->ContextRecord->Dr6, 3, 1))
+		if (GetBits(pExceptionInfo->ContextRecord->Dr6, 2, 1) || GetBits(pExceptionInfo->ContextRecord->Dr6, 3, 1))
 			g_gdbstub->HandleAccessException(pExceptionInfo->ContextRecord->Dr6);
 		return EXCEPTION_CONTINUE_EXECUTION;
 	}
+	if (pExceptionInfo->ExceptionRecord->ExceptionCode == EXCEPTION_ACCESS_VIOLATION)
+		return handleException_ACCESS_VIOLATION(pExceptionInfo);
 	return EXCEPTION_CONTINUE_SEARCH;
 }
 
@@ -279,6 +298,23 @@ LONG WINAPI cemu_unhandledExceptionFilter(EXCEPTION_POINTERS* pExceptionInfo)
 	return EXCEPTION_NONCONTINUABLE_EXCEPTION;
 }
 
+bool ExceptionHandler_CopyFromMappedFile(void* dst, const void* src, size_t size)
+{
+#ifdef _MSC_VER
+	__try
+	{
+		memcpy(dst, src, size);
+	}
+	__except (GetExceptionCode() == EXCEPTION_IN_PAGE_ERROR ? EXCEPTION_EXECUTE_HANDLER : EXCEPTION_CONTINUE_SEARCH)
+	{
+		return false;
+	}
+#else
+	memcpy(dst, src, size);
+#endif
+	return true;
+}
+
 void ExceptionHandler_Init()
 {
 	SetUnhandledExceptionFilter(cemu_unhandledExceptionFilter);
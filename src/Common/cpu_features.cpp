@@ -5,6 +5,11 @@
 #include <sys/sysctl.h>
 #endif
 
+#if defined(__aarch64__) && BOOST_OS_LINUX
+#include <sys/auxv.h>
+#include <asm/hwcap.h>
+#endif
+
 // wrappers with uniform prototype for implementation-specific x86 CPU id
 #if defined(ARCH_X86_64)
 #ifdef __GNUC__
@@ -102,6 +107,13 @@ CPUFeaturesImpl::CPUFeaturesImpl()
 #elif BOOST_OS_LINUX
 	m_cpuBrandName = getCpuBrandNameLinux();
 #endif
+#if BOOST_OS_LINUX
+	arm64.aes = (getauxval(AT_HWCAP) & HWCAP_AES) != 0;
+#elif BOOST_OS_MACOS
+	arm64.aes = true; // all Apple Silicon CPUs support the crypto extensions
+#elif BOOST_OS_WINDOWS
+	arm64.aes = IsProcessorFeaturePresent(PF_ARM_V8_CRYPTO_INSTRUCTIONS_AVAILABLE) != 0;
+#endif
 #endif
 
 #if BOOST_OS_MACOS
@@ -187,6 +199,8 @@ std::string CPUFeaturesImpl::GetCommaSeparatedExtensionList()
 		appendExt("AES-NI");
 	if(x86.invariant_tsc)
 		appendExt("INVARIANT-TSC");
+	if (arm64.aes)
+		appendExt("AES");
 	return tmp;
 }
 
@@ -2,10 +2,16 @@
 #define ATTRIBUTE_AVX2 __attribute__((target("avx2")))
 #define ATTRIBUTE_SSE41 __attribute__((target("sse4.1")))
 #define ATTRIBUTE_AESNI __attribute__((target("aes")))
+#if defined(__clang__)
+#define ATTRIBUTE_ARM_AES __attribute__((target("aes")))
+#else
+#define ATTRIBUTE_ARM_AES __attribute__((target("+crypto")))
+#endif
 #else
 #define ATTRIBUTE_AVX2
 #define ATTRIBUTE_SSE41
 #define ATTRIBUTE_AESNI
+#define ATTRIBUTE_ARM_AES
 #endif
 
 #include <string>
@@ -30,6 +36,10 @@ public:
 		bool aesni{ false };
 		bool invariant_tsc{ false };
 	}x86;
+	struct
+	{
+		bool aes{ false };
+	}arm64;
 private:
 	std::string m_cpuBrandName;
 };
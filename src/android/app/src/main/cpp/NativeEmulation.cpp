@@ -40,6 +40,7 @@ namespace NativeEmulation
 			auto deviceDescriptionPtr = std::make_shared<CubebAPI::CubebDeviceDescription>(nullptr, std::string(), std::wstring());
 			audioDevice = IAudioAPI::CreateDevice(
 				IAudioAPI::AudioAPI::Cubeb,
+				isTV ? IAudioAPI::TV : IAudioAPI::Gamepad,
 				deviceDescriptionPtr,
 				48000,
 				CemuConfig::AudioChannelsToNChannels(channels),
@@ -9,6 +9,7 @@
 #if HAS_CUBEB
 #include "CubebAPI.h"
 #endif
+#include "NullAudioAPI.h"
 
 std::shared_mutex g_audioMutex;
 AudioAPIPtr g_tvAudio;
@@ -37,6 +38,7 @@ void IAudioAPI::PrintLogging()
 	}
 
 	cemuLog_log(LogType::Force, "Cubeb: {}", s_availableApis[Cubeb] ? "available" : "not supported");
+	cemuLog_log(LogType::Force, "Null: {}", s_availableApis[Null] ? "available" : "not supported");
 }
 
 void IAudioAPI::InitWFX(sint32 samplerate, sint32 channels, sint32 bits_per_sample)
@@ -87,6 +89,7 @@ void IAudioAPI::InitializeStatic()
 #if HAS_CUBEB
 	s_availableApis[Cubeb] = CubebAPI::InitializeStatic();
 #endif
+	s_availableApis[Null] = true;
 }
 
 bool IAudioAPI::IsAudioAPIAvailable(AudioAPI api)
@@ -127,13 +130,13 @@ AudioAPIPtr IAudioAPI::CreateDeviceFromConfig(AudioType type, sint32 rate, sint3
 	if (!device_description)
 		throw std::runtime_error("failed to find selected device while trying to create audio device");
 
-	audioAPIDev = CreateDevice(audio_api, device_description, rate, channels, samples_per_block, bits_per_sample);
+	audioAPIDev = CreateDevice(audio_api, type, device_description, rate, channels, samples_per_block, bits_per_sample);
 	audioAPIDev->SetVolume(GetVolumeFromType(type));
 
 	return audioAPIDev;
 }
 
-AudioAPIPtr IAudioAPI::CreateDevice(AudioAPI api, const DeviceDescriptionPtr& device, sint32 samplerate, sint32 channels, sint32 samples_per_block, sint32 bits_per_sample)
+AudioAPIPtr IAudioAPI::CreateDevice(AudioAPI api, AudioType type, const DeviceDescriptionPtr& device, sint32 samplerate, sint32 channels, sint32 samples_per_block, sint32 bits_per_sample)
 {
 	if (!IsAudioAPIAvailable(api))
 		return {};
@@ -164,6 +167,11 @@ AudioAPIPtr IAudioAPI::CreateDevice(AudioAPI api, const DeviceDescriptionPtr& de
 		return std::make_unique<CubebAPI>(tmp->GetDeviceId(), samplerate, channels, samples_per_block, bits_per_sample);
 	}
 #endif
+	case Null:
+	{
+		const auto tmp = std::dynamic_pointer_cast<NullAudioAPI::NullDeviceDescription>(device);
+		return std::make_unique<NullAudioAPI>(tmp->CaptureToFile(), tmp->IsPaced(), type, samplerate, channels, samples_per_block, bits_per_sample);
+	}
 	default:
 		throw std::runtime_error(fmt::format("invalid audio api: {}", api));
 	}
@@ -196,6 +204,10 @@ std::vector<IAudioAPI::DeviceDescriptionPtr> IAudioAPI::GetDevices(AudioAPI api)
 		return CubebAPI::GetDevices();
 	}
 #endif
+	case Null:
+	{
+		return NullAudioAPI::GetDevices();
+	}
 	default:
 		throw std::runtime_error(fmt::format("invalid audio api: {}", api));
 	}
@@ -0,0 +1,129 @@
+#include "NullAudioAPI.h"
+#include "config/ActiveSettings.h"
+
+NullAudioAPI::NullAudioAPI(bool captureToFile, bool paced, AudioType type, uint32 samplerate, uint32 channels, uint32 samples_per_block, uint32 bits_per_sample)
+	: IAudioAPI(samplerate, channels, samples_per_block, bits_per_sample), m_paced(paced)
+{
+	if (!captureToFile)
+		return;
+	const fs::path captureDir = ActiveSettings::GetUserDataPath("audio_captures");
+	std::error_code ec;
+	fs::create_directories(captureDir, ec);
+	const auto timestamp = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+	// TV and gamepad devices are created at the same time, the device type keeps their file names apart
+	const char* typeName = type == TV ? "tv" : (type == Gamepad ? "drc" : "portal");
+	const fs::path capturePath = captureDir / fmt::format("capture_{}_{}_{}ch.wav", typeName, timestamp, channels);
+	m_captureFile.reset(FileStream::createFile2(capturePath));
+	if (!m_captureFile)
+	{
+		cemuLog_log(LogType::Force, "NullAudioAPI: Failed to create audio capture file {}", _pathToUtf8(capturePath));
+		return;
+	}
+	WriteWAVHeader(0);
+	cemuLog_log(LogType::Force, "NullAudioAPI: Capturing audio to {}", _pathToUtf8(capturePath));
+}
+
+NullAudioAPI::~NullAudioAPI()
+{
+	if (m_captureFile)
+	{
+		// update the sizes in the header now that the length is known
+		m_captureFile->SetPosition(0);
+		WriteWAVHeader(m_captureDataSize);
+	}
+}
+
+void NullAudioAPI::WriteWAVHeader(uint32 dataSize)
+{
+	const uint32 bytesPerFrame = m_channels * (m_bitsPerSample / 8);
+	m_captureFile->writeData("RIFF", 4);
+	m_captureFile->writeU32(36 + dataSize);
+	m_captureFile->writeData("WAVE", 4);
+	// fmt chunk
+	m_captureFile->writeData("fmt ", 4);
+	m_captureFile->writeU32(16);
+	m_captureFile->writeU8(1); // PCM
+	m_captureFile->writeU8(0);
+	m_captureFile->writeU8((uint8)m_channels);
+	m_captureFile->writeU8(0);
+	m_captureFile->writeU32(m_samplerate);
+	m_captureFile->writeU32(m_samplerate * bytesPerFrame);
+	m_captureFile->writeU8((uint8)bytesPerFrame);
+	m_captureFile->writeU8(0);
+	m_captureFile->writeU8((uint8)m_bitsPerSample);
+	m_captureFile->writeU8(0);
+	// data chunk
+	m_captureFile->writeData("data", 4);
+	m_captureFile->writeU32(dataSize);
+}
+
+uint64 NullAudioAPI::GetConsumedBlockCount() const
+{
+	if (!m_playing)
+		return 0;
+	const auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - m_startTime).count();
+	return (uint64)elapsed * m_samplerate / (1000000ull * m_samplesPerBlock);
+}
+
+bool NullAudioAPI::NeedAdditionalBlocks() const
+{
+	if (!m_paced)
+		return true;
+	std::unique_lock lock(m_mutex);
+	const uint64 consumedBlocks = std::min(GetConsumedBlockCount(), m_feedBlockCount);
+	return (m_feedBlockCount - consumedBlocks) < GetAudioDelay();
+}
+
+bool NullAudioAPI::FeedBlock(sint16* data)
+{
+	std::unique_lock lock(m_mutex);
+	const uint64 consumedBlocks = m_paced ? GetConsumedBlockCount() : m_feedBlockCount;
+	if (consumedBlocks > m_feedBlockCount)
+	{
+		// buffer ran dry. Restart the clock so the time spent underrunning isn't credited to future blocks
+		m_startTime = std::chrono::steady_clock::now();
+		m_feedBlockCount = 0;
+	}
+	else if ((m_feedBlockCount - consumedBlocks) >= kBlockCount)
+	{
+		// like a real device, drop the block if the buffer is full
+		return false;
+	}
+	m_feedBlockCount++;
+	// every block that was accepted is captured, independent of playback timing
+	if (m_captureFile && m_captureDataSize <= (0xFFFFFFFFu - 36 - m_bytesPerBlock))
+	{
+		m_captureFile->writeData(data, (sint32)m_bytesPerBlock);
+		m_captureDataSize += m_bytesPerBlock;
+	}
+	return true;
+}
+
+bool NullAudioAPI::Play()
+{
+	std::unique_lock lock(m_mutex);
+	if (m_playing)
+		return true;
+	m_playing = true;
+	m_startTime = std::chrono::steady_clock::now(); // blocks fed while stopped are still buffered
+	return true;
+}
+
+bool NullAudioAPI::Stop()
+{
+	std::unique_lock lock(m_mutex);
+	// keep the blocks which haven't been consumed yet
+	m_feedBlockCount -= std::min(GetConsumedBlockCount(), m_feedBlockCount);
+	m_playing = false;
+	return true;
+}
+
+std::vector<IAudioAPI::DeviceDescriptionPtr> NullAudioAPI::GetDevices()
+{
+	std::vector<DeviceDescriptionPtr> result;
+	result.emplace_back(std::make_shared<NullDeviceDescription>(L"Discard output", false, true));
+	result.emplace_back(std::make_shared<NullDeviceDescription>(L"Capture to WAV file", true, true));
+	result.emplace_back(std::make_shared<NullDeviceDescription>(L"Discard output (unpaced)", false, false));
+	result.emplace_back(std::make_shared<NullDeviceDescription>(L"Capture to WAV file (unpaced)", true, false));
+	return result;
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include "IAudioAPI.h"
+#include "Common/FileStream.h"
+
+// audio backend without an output device. Either discards all samples or captures them to a WAV file
+// the paced variants consume blocks at the nominal sample rate so that code which waits on NeedAdditionalBlocks() behaves the same as with a real device
+// the unpaced variants accept every block immediately, the rate is then only limited by the producer
+class NullAudioAPI : public IAudioAPI
+{
+public:
+	class NullDeviceDescription : public DeviceDescription
+	{
+	public:
+		NullDeviceDescription(const std::wstring& name, bool captureToFile, bool paced)
+			: DeviceDescription(name), m_captureToFile(captureToFile), m_paced(paced) { }
+
+		std::wstring GetIdentifier() const override
+		{
+			std::wstring identifier = m_captureToFile ? L"null_wav" : L"null";
+			if (!m_paced)
+				identifier.append(L"_unpaced");
+			return identifier;
+		}
+		bool CaptureToFile() const { return m_captureToFile; }
+		bool IsPaced() const { return m_paced; }
+
+	private:
+		bool m_captureToFile;
+		bool m_paced;
+	};
+
+	using NullDeviceDescriptionPtr = std::shared_ptr<NullDeviceDescription>;
+
+	NullAudioAPI(bool captureToFile, bool paced, AudioType type, uint32 samplerate, uint32 channels, uint32 samples_per_block, uint32 bits_per_sample);
+	~NullAudioAPI();
+
+	AudioAPI GetType() const override { return Null; }
+	bool NeedAdditionalBlocks() const override;
+	bool FeedBlock(sint16* data) override;
+	bool Play() override;
+	bool Stop() override;
+
+	static std::vector<DeviceDescriptionPtr> GetDevices();
+
+private:
+	uint64 GetConsumedBlockCount() const;
+	void WriteWAVHeader(uint32 dataSize);
+
+	bool m_paced;
+	mutable std::mutex m_mutex;
+	std::chrono::steady_clock::time_point m_startTime;
+	uint64 m_feedBlockCount = 0;
+	std::unique_ptr<FileStream> m_captureFile;
+	uint32 m_captureDataSize = 0;
+};
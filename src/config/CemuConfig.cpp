@@ -30,6 +30,7 @@ XMLConfigParser CemuConfig::Load(XMLConfigParser& parser)
 	proxy_server = parser.get("proxy_server", "");
 	disable_screensaver = parser.get("disable_screensaver", disable_screensaver);
 	play_boot_sound = parser.get("play_boot_sound", play_boot_sound);
+	fst_cache_size = parser.get("fst_cache_size", fst_cache_size.GetInitValue());
 	console_language = parser.get("console_language", console_language.GetInitValue());
 
 	game_paths.clear();
@@ -143,6 +144,7 @@ XMLConfigParser CemuConfig::Load(XMLConfigParser& parser)
 	downscale_filter = graphic.get("DownscaleFilter", kLinearFilter);
 	fullscreen_scaling = graphic.get("FullscreenScaling", kKeepAspectRatio);
 	async_compile = graphic.get("AsyncCompile", async_compile);
+	texture_cache_budget = graphic.get("TextureCacheBudget", 0);
 	vk_accurate_barriers = graphic.get("vkAccurateBarriers", true); // this used to be "VulkanAccurateBarriers" but because we changed the default to true in 1.27.1 the option name had to be changed
 #if ENABLE_METAL
 	force_mesh_shaders = graphic.get("ForceMeshShaders", false);
@@ -265,6 +267,11 @@ XMLConfigParser CemuConfig::Load(XMLConfigParser& parser)
 		if(networkService == NetworkService::Offline || networkService == NetworkService::Nintendo || networkService == NetworkService::Pretendo || networkService == NetworkService::Custom)
 			account.service_select.emplace(persistentId, networkService);
 	}
+	// thread pool
+	auto threadPool = parser.get("ThreadPool");
+	thread_pool.high_workers = threadPool.get("HighWorkers", thread_pool.high_workers);
+	thread_pool.normal_workers = threadPool.get("NormalWorkers", thread_pool.normal_workers);
+	thread_pool.background_workers = threadPool.get("BackgroundWorkers", thread_pool.background_workers);
 	// debug
 	auto debug = parser.get("Debug");
 #if BOOST_OS_WINDOWS
@@ -308,6 +315,7 @@ XMLConfigParser CemuConfig::Save(XMLConfigParser& parser)
 	config.set<bool>("permanent_storage", permanent_storage);
 	config.set("proxy_server", proxy_server.GetValue().c_str());
 	config.set<bool>("play_boot_sound", play_boot_sound);
+	config.set<uint32>("fst_cache_size", fst_cache_size);
 
 	// config.set("cpu_mode", cpu_mode.GetValue());
 	//config.set("console_region", console_region.GetValue());
@@ -381,6 +389,7 @@ XMLConfigParser CemuConfig::Save(XMLConfigParser& parser)
 	graphic.set("DownscaleFilter", downscale_filter);
 	graphic.set("FullscreenScaling", fullscreen_scaling);
 	graphic.set("AsyncCompile", async_compile.GetValue());
+	graphic.set("TextureCacheBudget", texture_cache_budget.GetValue());
 	graphic.set("vkAccurateBarriers", vk_accurate_barriers);
 
 	auto overlay_node = graphic.set("Overlay");
@@ -434,6 +443,11 @@ XMLConfigParser CemuConfig::Save(XMLConfigParser& parser)
 		entry.set_attribute("PersistentId", it.first);
 		entry.set_attribute("Service", static_cast<sint32>(it.second));
 	}
+	// thread pool
+	auto threadPool = config.set("ThreadPool");
+	threadPool.set("HighWorkers", thread_pool.high_workers.GetValue());
+	threadPool.set("NormalWorkers", thread_pool.normal_workers.GetValue());
+	threadPool.set("BackgroundWorkers", thread_pool.background_workers.GetValue());
 	// debug
 	auto debug = config.set("Debug");
 #if BOOST_OS_WINDOWS
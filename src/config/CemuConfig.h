@@ -419,6 +419,7 @@ struct CemuConfig
 	ConfigValue<bool> disable_screensaver{DISABLE_SCREENSAVER_DEFAULT};
 #undef DISABLE_SCREENSAVER_DEFAULT
 	ConfigValue<bool> play_boot_sound{false};
+	ConfigValue<uint32> fst_cache_size{2}; // in MiB, per mounted disc image or title content
 
 #if BOOST_PLAT_ANDROID
 	ConfigValue<std::string> custom_driver_path{};
@@ -451,6 +452,7 @@ struct CemuConfig
 	ConfigValue<bool> gx2drawdone_sync { true };
 	ConfigValue<bool> render_upside_down{ false };
 	ConfigValue<bool> async_compile{ true };
+	ConfigValue<uint32> texture_cache_budget{ 0 }; // in MB, 0 = unlimited
 #if ENABLE_METAL
 	ConfigValue<bool> force_mesh_shaders{ false };
 #endif
@@ -514,6 +516,14 @@ struct CemuConfig
 		ConfigValue<uint16> port{ 26760 };
 	}dsu_client{};
 
+	// number of worker threads per priority class of the shared thread pool. 0 = based on host CPU
+	struct
+	{
+		ConfigValue<uint32> high_workers{0};
+		ConfigValue<uint32> normal_workers{0};
+		ConfigValue<uint32> background_workers{0};
+	}thread_pool{};
+
 	// debug
 	ConfigValueBounds<CrashDump> crash_dump{ CrashDump::Disabled };
 	ConfigValue<uint16> gdb_port{ 1337 };
@@ -12,6 +12,11 @@
 #include "util/crypto/aes128.h"
 
 #include "Cafe/Filesystem/FST/FST.h"
+#include "Cafe/Filesystem/WUD/wud.h"
+#include "Cafe/OS/libs/snd_core/ax.h"
+#include "Cafe/HW/Latte/Transcompiler/LatteTC.h"
+#include "Cafe/HW/Latte/Core/LatteTexture.h"
+#include "Cafe/HW/Latte/Core/LatteIndices.h"
 #include "util/helpers/StringHelpers.h"
 
 void requireConsole();
@@ -73,14 +78,26 @@ bool LaunchSettings::HandleCommandline(const std::vector<std::wstring>& args)
 
 		("force-interpreter", po::value<bool>()->implicit_value(true), "Force interpreter CPU emulation, disables recompiler. Useful for debugging purposes where you want to get accurate memory accesses and stack traces.")
 		("force-multicore-interpreter", po::value<bool>()->implicit_value(true), "Force multi-core interpreter CPU emulation, disables recompiler. Only useful for getting stack traces, but slightly faster than the single-core interpreter mode.")
-		("enable-gdbstub", po::value<bool>()->implicit_value(true), "Enable GDB stub to debug executables inside Cemu using an external debugger");
+		("enable-gdbstub", po::value<bool>()->implicit_value(true), "Enable GDB stub to debug executables inside Cemu using an external debugger")
+#if BOOST_OS_LINUX
+		("perf-map", po::value<bool>()->implicit_value(true), "Write recompiled PPC functions to /tmp/perf-<pid>.map so that Linux perf can symbolize them")
+#endif
+		;
 
 	po::options_description hidden{ "Hidden options" };
 	hidden.add_options()
 		("nsight", po::value<bool>()->implicit_value(true), "NSight debugging options")
 		("legacy", po::value<bool>()->implicit_value(true), "Intel legacy graphic mode")
 		("ppcrec-lower-addr", po::value<std::string>(), "For debugging: Lower address allowed for PPC recompilation")
-		("ppcrec-upper-addr", po::value<std::string>(), "For debugging: Upper address allowed for PPC recompilation");
+		("ppcrec-upper-addr", po::value<std::string>(), "For debugging: Upper address allowed for PPC recompilation")
+		("ax-mix-benchmark", po::wvalue<std::wstring>(), "Run the audio mixer on synthetic voices and compare the output against a golden file. The file is created if it doesn't exist")
+		("zir-spirv", po::value<bool>()->implicit_value(true), "Vulkan: Compile supported vertex shaders from the Zir IR to SPIR-V directly instead of going through GLSL. Unsupported shaders fall back to glslang")
+		("zir-spirv-check", po::wvalue<std::wstring>(), "Run the Zir SPIR-V emitter on a folder of raw shader dumps, validate the output with spirv-val and compare it against glslang")
+		("aes-check", po::value<bool>()->implicit_value(true), "Compare the pipelined AES-128-CBC decryption against single block and software decryption on random data and measure their throughput")
+		("wud-read-check", po::wvalue<std::wstring>()->implicit_value(L"", ""), "Compare coalesced WUD/WUX reads against per-sector reads on random ranges of an image. Uses a synthetic WUX image if no path is given")
+		("texmem-trace", po::wvalue<std::wstring>(), "Record all texture memory occupancy operations to a file, for use with --texmem-replay")
+		("texmem-replay", po::wvalue<std::wstring>(), "Replay a texture memory occupancy trace against the previous and the current interval tree and compare their results and timings")
+		("index-decode-check", po::value<bool>()->implicit_value(true), "Compare the SIMD index decoding kernels against the scalar loops for every primitive mode and index type and measure their throughput");
 
 	po::options_description extractor{ "Extractor tool" };
 	extractor.add_options()
@@ -189,6 +206,15 @@ bool LaunchSettings::HandleCommandline(const std::vector<std::wstring>& args)
 		if (vm.count("enable-gdbstub"))
 			s_enable_gdbstub = vm["enable-gdbstub"].as<bool>();
 
+		if (vm.count("perf-map"))
+			s_perf_map = vm["perf-map"].as<bool>();
+
+		if (vm.count("zir-spirv"))
+			s_zir_spirv = vm["zir-spirv"].as<bool>();
+
+		if (vm.count("texmem-trace"))
+			s_texmem_trace_path = fs::path(vm["texmem-trace"].as<std::wstring>());
+
 		std::wstring extract_path, log_path;
 		std::string output_path;
 		if (vm.count("extract"))
@@ -218,6 +244,48 @@ bool LaunchSettings::HandleCommandline(const std::vector<std::wstring>& args)
 			return false;
 		}
 
+		if (vm.count("ax-mix-benchmark"))
+		{
+			requireConsole();
+			snd_core::AXMix_RunBenchmark(fs::path(vm["ax-mix-benchmark"].as<std::wstring>()));
+			return false;
+		}
+
+		if (vm.count("zir-spirv-check"))
+		{
+			requireConsole();
+			LatteTC_RunSPIRVCheck(fs::path(vm["zir-spirv-check"].as<std::wstring>()));
+			return false;
+		}
+
+		if (vm.count("aes-check"))
+		{
+			requireConsole();
+			AES128_RunSelfCheck();
+			return false;
+		}
+
+		if (vm.count("wud-read-check"))
+		{
+			requireConsole();
+			wud_runReadCheck(fs::path(vm["wud-read-check"].as<std::wstring>()));
+			return false;
+		}
+
+		if (vm.count("texmem-replay"))
+		{
+			requireConsole();
+			LatteTexture_ReplayMemOccupancyTrace(fs::path(vm["texmem-replay"].as<std::wstring>()));
+			return false;
+		}
+
+		if (vm.count("index-decode-check"))
+		{
+			requireConsole();
+			LatteIndices_RunSelfCheck();
+			return false;
+		}
+
 		return true;
 	}
 	catch (const std::exception& ex)
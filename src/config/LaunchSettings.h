@@ -29,6 +29,9 @@ public:
 
 	static bool ForceInterpreter() { return s_force_interpreter; };
 	static bool ForceMultiCoreInterpreter() { return s_force_multicore_interpreter; }
+	static bool PerfMapEnabled() { return s_perf_map; }
+	static bool ZirSPIRVEnabled() { return s_zir_spirv; }
+	static std::optional<fs::path> GetTexMemTracePath() { return s_texmem_trace_path; }
 
 	static std::optional<uint32> GetPersistentId() { return s_persistent_id; }
 
@@ -50,6 +53,9 @@ private:
 
 	inline static bool s_force_interpreter = false;
 	inline static bool s_force_multicore_interpreter = false;
+	inline static bool s_perf_map = false;
+	inline static bool s_zir_spirv = false;
+	inline static std::optional<fs::path> s_texmem_trace_path{};
 	
 	inline static std::optional<uint32> s_persistent_id{};
 
@@ -59,6 +59,7 @@ const wxString kDirectSound("DirectSound");
 const wxString kXAudio27("XAudio2.7");
 const wxString kXAudio2("XAudio2");
 const wxString kCubeb("Cubeb");
+const wxString kNullAudio("Null");
 
 const wxString kPropertyPersistentId("PersistentId");
 const wxString kPropertyMiiName("MiiName");
@@ -388,6 +389,11 @@ wxPanel* GeneralSettings2::AddGraphicsPage(wxNotebook* notebook)
 		});
 		row->Add(m_vsync, 0, wxALL, 5);
 
+		row->Add(new wxStaticText(box, wxID_ANY, _("Texture cache budget (MB)")), 0, wxALIGN_CENTER_VERTICAL | wxALL, 5);
+		m_texture_cache_budget = new wxSpinCtrl(box, wxID_ANY, "0", wxDefaultPosition, { 230, -1 }, wxSP_ARROW_KEYS, 0, 65536, 0);
+		m_texture_cache_budget->SetToolTip(_("When the estimated memory used by cached textures exceeds this amount, the least recently used textures are removed from the cache.\nLowering this can help if long sessions run out of VRAM. 0 means unlimited"));
+		row->Add(m_texture_cache_budget, 0, wxALL, 5);
+
 		box_sizer->Add(row, 0, wxEXPAND, 5);
 
 		auto* graphic_misc_row = new wxFlexGridSizer(0, 2, 0, 0);
@@ -523,6 +529,8 @@ wxPanel* GeneralSettings2::AddAudioPage(wxNotebook* notebook)
 			m_audio_api->Append(kXAudio2);
 		if (IAudioAPI::IsAudioAPIAvailable(IAudioAPI::Cubeb))
 			m_audio_api->Append(kCubeb);
+		if (IAudioAPI::IsAudioAPIAvailable(IAudioAPI::Null))
+			m_audio_api->Append(kNullAudio);
 
 		m_audio_api->SetSelection(0);
 		m_audio_api->SetToolTip(_("Select one of the available audio back ends"));
@@ -1166,6 +1174,8 @@ void GeneralSettings2::StoreConfig()
 		config.audio_api = IAudioAPI::XAudio2;
 	else if (m_audio_api->GetStringSelection() == kCubeb)
 		config.audio_api = IAudioAPI::Cubeb;
+	else if (m_audio_api->GetStringSelection() == kNullAudio)
+		config.audio_api = IAudioAPI::Null;
 
 	config.audio_delay = m_audio_latency->GetValue();
 	config.tv_channels = (AudioChannels)m_tv_channels->GetSelection();
@@ -1254,6 +1264,7 @@ void GeneralSettings2::StoreConfig()
 	config.force_mesh_shaders = m_force_mesh_shaders->IsChecked();
 #endif
 	config.async_compile = m_async_compile->IsChecked();
+	config.texture_cache_budget = m_texture_cache_budget->GetValue();
 
 	config.overlay.position = (ScreenPosition)m_overlay_position->GetSelection(); wxASSERT((int)config.overlay.position <= (int)ScreenPosition::kBottomRight);
 	config.overlay.text_color = m_overlay_font_color->GetColour().GetRGBA();
@@ -1882,6 +1893,7 @@ void GeneralSettings2::ApplyConfig()
 		m_userDisplayGamma->SetValue(2.2f);
 	}
 	m_async_compile->SetValue(config.async_compile);
+	m_texture_cache_budget->SetValue((int)config.texture_cache_budget.GetValue());
 	m_gx2drawdone_sync->SetValue(config.gx2drawdone_sync);
 #if ENABLE_METAL
 	m_force_mesh_shaders->SetValue(config.force_mesh_shaders);
@@ -1928,6 +1940,8 @@ void GeneralSettings2::ApplyConfig()
 		m_audio_api->SetStringSelection(kXAudio2);
 	else if(config.audio_api == IAudioAPI::Cubeb)
 		m_audio_api->SetStringSelection(kCubeb);
+	else if(config.audio_api == IAudioAPI::Null)
+		m_audio_api->SetStringSelection(kNullAudio);
 
 	SendSliderEvent(m_audio_latency, config.audio_delay);
 
@@ -2039,6 +2053,8 @@ void GeneralSettings2::OnAudioAPISelected(wxCommandEvent& event)
 		api = IAudioAPI::XAudio2;
 	else if (m_audio_api->GetStringSelection() == kCubeb)
 		api = IAudioAPI::Cubeb;
+	else if (m_audio_api->GetStringSelection() == kNullAudio)
+		api = IAudioAPI::Null;
 	else
 	{
 		wxFAIL_MSG("invalid audio api selected!");
@@ -2083,7 +2099,7 @@ void GeneralSettings2::UpdateAudioDevice()
 
 				try
 				{
-					g_tvAudio = IAudioAPI::CreateDevice((IAudioAPI::AudioAPI)config.audio_api, description->GetDescription(), 48000, channels, snd_core::AX_SAMPLES_PER_3MS_48KHZ * AX_FRAMES_PER_GROUP, 16);
+					g_tvAudio = IAudioAPI::CreateDevice((IAudioAPI::AudioAPI)config.audio_api, IAudioAPI::TV, description->GetDescription(), 48000, channels, snd_core::AX_SAMPLES_PER_3MS_48KHZ * AX_FRAMES_PER_GROUP, 16);
 					g_tvAudio->SetVolume(m_tv_volume->GetValue());
 				}
 				catch (std::runtime_error& ex)
@@ -2120,7 +2136,7 @@ void GeneralSettings2::UpdateAudioDevice()
 
 				try
 				{
-					g_padAudio = IAudioAPI::CreateDevice((IAudioAPI::AudioAPI)config.audio_api, description->GetDescription(), 48000, channels, snd_core::AX_SAMPLES_PER_3MS_48KHZ * AX_FRAMES_PER_GROUP, 16);
+					g_padAudio = IAudioAPI::CreateDevice((IAudioAPI::AudioAPI)config.audio_api, IAudioAPI::Gamepad, description->GetDescription(), 48000, channels, snd_core::AX_SAMPLES_PER_3MS_48KHZ * AX_FRAMES_PER_GROUP, 16);
 					g_padAudio->SetVolume(m_pad_volume->GetValue());
 				}
 				catch (std::runtime_error& ex)
@@ -2190,7 +2206,7 @@ void GeneralSettings2::UpdateAudioDevice()
 
 				try
 				{
-					g_portalAudio = IAudioAPI::CreateDevice((IAudioAPI::AudioAPI)config.audio_api, description->GetDescription(), 8000, 1, 32, 16);
+					g_portalAudio = IAudioAPI::CreateDevice((IAudioAPI::AudioAPI)config.audio_api, IAudioAPI::Portal, description->GetDescription(), 8000, 1, 32, 16);
 					g_portalAudio->SetVolume(m_portal_volume->GetValue());
 				}
 				catch (std::runtime_error& ex)
@@ -65,6 +65,7 @@ private:
 	// Graphics
 	wxChoice* m_graphic_api, * m_graphic_device;
 	wxChoice* m_vsync;
+	wxSpinCtrl* m_texture_cache_budget;
 	wxCheckBox* m_overrideGamma;
 	wxSpinCtrlDouble* m_overrideGammaValue;
 	wxSpinCtrlDouble* m_userDisplayGamma;
@@ -20,6 +20,8 @@
 #include "Cafe/OS/libs/swkbd/swkbd.h"
 #include "wxgui/debugger/DebuggerWindow2.h"
 #include "util/helpers/helpers.h"
+#include "util/TraceRecorder/TraceRecorder.h"
+#include "Cafe/HW/Espresso/Debugger/PPCSamplingProfiler.h"
 #include "config/CemuConfig.h"
 #include "Cemu/DiscordPresence/DiscordPresence.h"
 #include "util/ScreenSaver/ScreenSaver.h"
@@ -150,6 +152,8 @@ enum
 	MAINFRAME_MENU_ID_DEBUG_AUDIO_AUX_ONLY,
 	MAINFRAME_MENU_ID_DEBUG_VK_ACCURATE_BARRIERS,
 	MAINFRAME_MENU_ID_DEBUG_GPU_CAPTURE,
+	MAINFRAME_MENU_ID_DEBUG_TRACE_RECORDING,
+	MAINFRAME_MENU_ID_DEBUG_PPC_PROFILER,
 
 	// debug->logging
 	MAINFRAME_MENU_ID_DEBUG_LOGGING_MESSAGE = 21499,
@@ -233,6 +237,8 @@ EVT_MENU(MAINFRAME_MENU_ID_DEBUG_RENDER_UPSIDE_DOWN, MainWindow::OnDebugSetting)
 EVT_MENU(MAINFRAME_MENU_ID_DEBUG_AUDIO_AUX_ONLY, MainWindow::OnDebugSetting)
 EVT_MENU(MAINFRAME_MENU_ID_DEBUG_VK_ACCURATE_BARRIERS, MainWindow::OnDebugSetting)
 EVT_MENU(MAINFRAME_MENU_ID_DEBUG_GPU_CAPTURE, MainWindow::OnDebugSetting)
+EVT_MENU(MAINFRAME_MENU_ID_DEBUG_TRACE_RECORDING, MainWindow::OnDebugSetting)
+EVT_MENU(MAINFRAME_MENU_ID_DEBUG_PPC_PROFILER, MainWindow::OnDebugSetting)
 EVT_MENU(MAINFRAME_MENU_ID_DEBUG_DUMP_RAM, MainWindow::OnDebugSetting)
 EVT_MENU(MAINFRAME_MENU_ID_DEBUG_DUMP_FST, MainWindow::OnDebugSetting)
 // debug -> View ...
@@ -1044,6 +1050,44 @@ void MainWindow::OnDebugSetting(wxCommandEvent& event)
 		static_cast<MetalRenderer*>(g_renderer.get())->CaptureFrame();
 	}
 #endif
+	else if (event.GetId() == MAINFRAME_MENU_ID_DEBUG_TRACE_RECORDING)
+	{
+		if (event.IsChecked())
+			TraceRecorder::Start();
+		else
+		{
+			const fs::path path = ActiveSettings::GetUserDataPath("traces");
+			std::error_code ec;
+			fs::create_directories(path, ec);
+			const std::time_t now = std::time(nullptr);
+			char timestamp[32];
+			std::strftime(timestamp, sizeof(timestamp), "%Y-%m-%d_%H-%M-%S", std::localtime(&now));
+			const fs::path tracePath = path / fmt::format("cemu_trace_{}.json", timestamp);
+			if (TraceRecorder::Stop(tracePath))
+				wxMessageBox(formatWxString(_("Trace written to:\n{}\n\nIt can be opened with Perfetto (ui.perfetto.dev) or chrome://tracing"), wxHelper::FromPath(tracePath)), _("Trace recording"), wxOK | wxCENTRE | wxICON_INFORMATION);
+			else
+				wxMessageBox(formatWxString(_("Unable to write the trace file:\n{}"), wxHelper::FromPath(tracePath)), _("Error"), wxOK | wxCENTRE | wxICON_ERROR);
+		}
+	}
+	else if (event.GetId() == MAINFRAME_MENU_ID_DEBUG_PPC_PROFILER)
+	{
+		if (event.IsChecked())
+			PPCSamplingProfiler::Start();
+		else
+		{
+			const fs::path path = ActiveSettings::GetUserDataPath("profiles");
+			std::error_code ec;
+			fs::create_directories(path, ec);
+			const std::time_t now = std::time(nullptr);
+			char timestamp[32];
+			std::strftime(timestamp, sizeof(timestamp), "%Y-%m-%d_%H-%M-%S", std::localtime(&now));
+			const fs::path profilePath = path / fmt::format("ppc_profile_{}", timestamp);
+			if (PPCSamplingProfiler::Stop(profilePath))
+				wxMessageBox(formatWxString(_("Profile written to:\n{}\n\nThe .folded file contains collapsed stacks which can be turned into a flame graph, the .txt file lists the hottest functions per thread"), wxHelper::FromPath(path)), _("PPC profiler"), wxOK | wxCENTRE | wxICON_INFORMATION);
+			else
+				wxMessageBox(formatWxString(_("Unable to write the profile:\n{}"), wxHelper::FromPath(profilePath)), _("Error"), wxOK | wxCENTRE | wxICON_ERROR);
+		}
+	}
 	else if (event.GetId() == MAINFRAME_MENU_ID_DEBUG_AUDIO_AUX_ONLY)
 		ActiveSettings::EnableAudioOnlyAux(event.IsChecked());
 	else if (event.GetId() == MAINFRAME_MENU_ID_DEBUG_DUMP_RAM)
@@ -2319,6 +2363,7 @@ void MainWindow::RecreateMenu()
 	debugLoggingMenu->AppendCheckItem(MAINFRAME_MENU_ID_DEBUG_LOGGING0 + stdx::to_underlying(LogType::Patches), _("&Graphic pack patches"))->Check(cemuLog_isLoggingEnabled(LogType::Patches));
 	debugLoggingMenu->AppendCheckItem(MAINFRAME_MENU_ID_DEBUG_LOGGING0 + stdx::to_underlying(LogType::TextureCache), _("&Texture cache warnings"))->Check(cemuLog_isLoggingEnabled(LogType::TextureCache));
 	debugLoggingMenu->AppendCheckItem(MAINFRAME_MENU_ID_DEBUG_LOGGING0 + stdx::to_underlying(LogType::TextureReadback), _("&Texture readback"))->Check(cemuLog_isLoggingEnabled(LogType::TextureReadback));
+	debugLoggingMenu->AppendCheckItem(MAINFRAME_MENU_ID_DEBUG_LOGGING0 + stdx::to_underlying(LogType::RPLLoader), _("&RPL loading times"))->Check(cemuLog_isLoggingEnabled(LogType::RPLLoader));
 	debugLoggingMenu->AppendSeparator();
 	debugLoggingMenu->AppendCheckItem(MAINFRAME_MENU_ID_DEBUG_LOGGING0 + stdx::to_underlying(LogType::OpenGLLogging), _("&OpenGL debug output"))->Check(cemuLog_isLoggingEnabled(LogType::OpenGLLogging));
 	debugLoggingMenu->AppendCheckItem(MAINFRAME_MENU_ID_DEBUG_LOGGING0 + stdx::to_underlying(LogType::VulkanValidation), _("&Vulkan validation layer (slow)"))->Check(cemuLog_isLoggingEnabled(LogType::VulkanValidation));
@@ -2350,6 +2395,11 @@ void MainWindow::RecreateMenu()
 	gpuCapture->Enable(m_game_launched && g_renderer->GetType() == RendererAPI::Metal);
 #endif
 
+	auto traceRecording = debugMenu->AppendCheckItem(MAINFRAME_MENU_ID_DEBUG_TRACE_RECORDING, _("&Record performance trace"));
+	traceRecording->Check(TraceRecorder::IsRecording());
+	auto ppcProfiler = debugMenu->AppendCheckItem(MAINFRAME_MENU_ID_DEBUG_PPC_PROFILER, _("&Profile PPC threads"));
+	ppcProfiler->Check(PPCSamplingProfiler::IsRunning());
+
 	debugMenu->AppendSeparator();
 
 #ifdef CEMU_DEBUG_ASSERT
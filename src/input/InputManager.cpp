@@ -58,6 +58,7 @@ InputManager::InputManager()
 InputManager::~InputManager()
 {
 	m_update_thread_shutdown.store(true);
+	wake_update_thread();
 	m_update_thread.join();
 }
 
@@ -945,26 +946,54 @@ std::optional<glm::ivec2> InputManager::get_right_down_mouse_info(bool* is_pad)
 	return {};
 }
 
+void InputManager::wake_update_thread()
+{
+	std::scoped_lock lock(m_update_thread_mutex);
+	m_update_thread_wakeup = true;
+	m_update_thread_cond.notify_one();
+}
+
 void InputManager::update_thread()
 {
 	SetThreadName("Input_update");
+	// controller state is pushed by the providers and sampled by the emulated controllers when the game reads input
+	// this thread only has work to do while a controller requests periodic updates, otherwise it sleeps until woken up
+	constexpr auto kPeriodicUpdateInterval = std::chrono::microseconds(1000000 / 60);
+	auto next_update = std::chrono::steady_clock::now();
 	while (!m_update_thread_shutdown.load(std::memory_order::relaxed))
 	{
+		bool needs_periodic_update = false;
 		std::shared_lock lock(m_mutex);
 		for (auto& pad : m_vpad)
 		{
 			if (pad)
+			{
 				pad->update();
+				needs_periodic_update |= pad->needs_periodic_update();
+			}
 		}
 
 		for (auto& pad : m_wpad)
 		{
 			if (pad)
+			{
 				pad->update();
+				needs_periodic_update |= pad->needs_periodic_update();
+			}
 		}
 		lock.unlock();
 
-		std::this_thread::sleep_for(std::chrono::milliseconds(1));
-		std::this_thread::yield();
+		std::unique_lock wait_lock(m_update_thread_mutex);
+		if (needs_periodic_update)
+		{
+			next_update = std::max(next_update + kPeriodicUpdateInterval, std::chrono::steady_clock::now());
+			m_update_thread_cond.wait_until(wait_lock, next_update, [this] { return m_update_thread_wakeup; });
+		}
+		else
+		{
+			m_update_thread_cond.wait(wait_lock, [this] { return m_update_thread_wakeup; });
+			next_update = std::chrono::steady_clock::now();
+		}
+		m_update_thread_wakeup = false;
 	}
 }
@@ -99,11 +99,16 @@ public:
 	std::optional<glm::ivec2> get_right_down_mouse_info(bool* is_pad);
 
 	std::atomic<float> m_mouse_wheel;
+	// makes the update thread run another update pass of all emulated controllers
+	void wake_update_thread();
 private:
 	void update_thread();
 
 	std::thread m_update_thread;
 	std::atomic<bool> m_update_thread_shutdown{false};
+	std::mutex m_update_thread_mutex;
+	std::condition_variable m_update_thread_cond;
+	bool m_update_thread_wakeup = false;
 
 	std::array<std::vector<ControllerProviderPtr>, InputAPI::MAX> m_api_available{ };
 
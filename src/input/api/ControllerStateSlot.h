@@ -0,0 +1,56 @@
+#pragma once
+
+// holds the latest state published by a controller provider
+// a single writer (usually the provider's event thread) stores new snapshots while any number of readers load them without taking a lock
+// readers which race with a store retry until they observe a consistent snapshot (seqlock)
+template<typename T>
+class ControllerStateSlot
+{
+	static_assert(std::is_trivially_copyable_v<T>);
+public:
+	ControllerStateSlot()
+	{
+		store(T{});
+	}
+
+	// concurrent stores must be serialized by the caller
+	void store(const T& value)
+	{
+		uint64 words[kWordCount]{};
+		memcpy(words, &value, sizeof(T));
+		const uint32 sequence = m_sequence.load(std::memory_order::relaxed);
+		m_sequence.store(sequence + 1, std::memory_order::relaxed);
+		std::atomic_thread_fence(std::memory_order::release);
+		for (size_t i = 0; i < kWordCount; i++)
+			m_words[i].store(words[i], std::memory_order::relaxed);
+		m_sequence.store(sequence + 2, std::memory_order::release);
+	}
+
+	T load() const
+	{
+		uint64 words[kWordCount];
+		while (true)
+		{
+			const uint32 sequence = m_sequence.load(std::memory_order::acquire);
+			if (sequence & 1)
+			{
+				_mm_pause();
+				continue;
+			}
+			for (size_t i = 0; i < kWordCount; i++)
+				words[i] = m_words[i].load(std::memory_order::relaxed);
+			std::atomic_thread_fence(std::memory_order::acquire);
+			if (m_sequence.load(std::memory_order::relaxed) == sequence)
+				break;
+		}
+		T result;
+		memcpy(&result, words, sizeof(T));
+		return result;
+	}
+
+private:
+	static constexpr size_t kWordCount = (sizeof(T) + sizeof(uint64) - 1) / sizeof(uint64);
+
+	std::atomic<uint32> m_sequence{0};
+	std::array<std::atomic<uint64>, kWordCount> m_words{};
+};
@@ -95,6 +95,11 @@ bool DSUControllerProvider::connect()
 		// reset data
 		m_state = {};
 		m_prev_state = {};
+		for (uint8_t i = 0; i < kMaxClients; ++i)
+		{
+			std::scoped_lock lock(m_mutex[i]);
+			publish_state(i);
+		}
 
 		// restart threads
 		return true;
@@ -111,8 +116,7 @@ bool DSUControllerProvider::is_connected(uint8_t index) const
 	if (index >= kMaxClients)
 		return false;
 
-	std::scoped_lock lock(m_mutex[index]);
-	return m_state[index].info.state == DsState::Connected;
+	return m_state_slot[index].load().info.state == DsState::Connected;
 }
 
 DSUControllerProvider::ControllerState DSUControllerProvider::get_state(uint8_t index) const
@@ -120,8 +124,7 @@ DSUControllerProvider::ControllerState DSUControllerProvider::get_state(uint8_t
 	if (index >= kMaxClients)
 		return {};
 
-	std::scoped_lock lock(m_mutex[index]);
-	return m_state[index];
+	return m_state_slot[index].load();
 }
 
 DSUControllerProvider::ControllerState DSUControllerProvider::get_prev_state(uint8_t index) const
@@ -129,8 +132,7 @@ DSUControllerProvider::ControllerState DSUControllerProvider::get_prev_state(uin
 	if (index >= kMaxClients)
 		return {};
 
-	std::scoped_lock lock(m_mutex[index]);
-	return m_prev_state[index];
+	return m_prev_state_slot[index].load();
 }
 
 std::array<bool, DSUControllerProvider::kMaxClients> DSUControllerProvider::wait_update(
@@ -241,8 +243,7 @@ MotionSample DSUControllerProvider::get_motion_sample(uint8_t index) const
 {
 	if (index >= kMaxClients)
 		return MotionSample();
-	std::scoped_lock lock(m_mutex[index]);
-	return m_state[index].motion_sample;
+	return m_state_slot[index].load().motion_sample;
 }
 
 
@@ -344,6 +345,7 @@ void DSUControllerProvider::reader_thread()
 				std::scoped_lock lock(mutex);
 				m_prev_state[index] = m_state[index];
 				m_state[index] = *info;
+				publish_state(index);
 				m_wait_cond[index].notify_all();
 				break;
 			}
@@ -367,9 +369,10 @@ void DSUControllerProvider::reader_thread()
 				std::scoped_lock lock(mutex);
 				m_prev_state[index] = m_state[index];
 				m_state[index] = *rsp;
-				m_wait_cond[index].notify_all();
 				// update motion info immediately, guaranteeing that we dont drop packets
 				integrate_motion(index, *rsp);
+				publish_state(index);
+				m_wait_cond[index].notify_all();
 				break;
 			}
 		}
@@ -443,6 +446,12 @@ void DSUControllerProvider::integrate_motion(uint8_t index, const DataResponse&
 	m_state[index].motion_sample = m_motion_handler[index].getMotionSample();
 }
 
+void DSUControllerProvider::publish_state(uint8_t index)
+{
+	m_state_slot[index].store(m_state[index]);
+	m_prev_state_slot[index].store(m_prev_state[index]);
+}
+
 DSUControllerProvider::ControllerState& DSUControllerProvider::ControllerState::operator=(const PortInfo& port_info)
 {
 	info = port_info.GetInfo();
@@ -4,6 +4,7 @@
 #include "input/api/DSU/DSUMessages.h"
 
 #include "input/api/ControllerProvider.h"
+#include "input/api/ControllerStateSlot.h"
 
 #include <boost/asio.hpp>
 
@@ -99,6 +100,8 @@ private:
 	void reader_thread();
 	void writer_thread();
 	void integrate_motion(uint8_t index, const DataResponse& data_response);
+	// makes the current state visible to lock-free readers, m_mutex[index] must be held
+	void publish_state(uint8_t index);
 
 	std::mutex m_writer_mutex;
 	std::condition_variable m_writer_cond;
@@ -110,6 +113,9 @@ private:
 
 	std::array<ControllerState, kMaxClients> m_state{};
 	std::array<ControllerState, kMaxClients> m_prev_state{};
+	// snapshots of m_state and m_prev_state which are read without locking when the emulated controllers sample input
+	std::array<ControllerStateSlot<ControllerState>, kMaxClients> m_state_slot;
+	std::array<ControllerStateSlot<ControllerState>, kMaxClients> m_prev_state_slot;
 	mutable std::array<std::mutex, kMaxClients> m_mutex;
 	mutable std::array<std::condition_variable, kMaxClients> m_wait_cond;
 
@@ -88,6 +88,7 @@ bool SDLController::connect()
 	}
 
 	m_has_rumble = SDL_GameControllerRumble(m_controller, 0, 0, 0) == 0;
+	m_state_slot = m_provider->get_state_slot(m_diid);
 	return true;
 }
 
@@ -135,33 +136,38 @@ ControllerState SDLController::raw_state()
 {
 	ControllerState result{};
 
+	// the state is pushed by the provider's event thread, sampling it doesn't need to go through SDL
 	std::scoped_lock lock(m_controller_mutex);
-	if (!is_connected())
+	if (!m_controller || !m_state_slot)
+		return result;
+
+	const auto state = m_state_slot->load();
+	if (!state.connected)
 		return result;
 
 	for (int i = 0; i < SDL_CONTROLLER_BUTTON_MAX; ++i)
 	{
-		if (m_buttons[i] && SDL_GameControllerGetButton(m_controller, (SDL_GameControllerButton)i))
+		if (m_buttons[i] && HAS_FLAG(state.buttons, 1u << i))
 			result.buttons.SetButtonState(i, true);
 	}
 
 	if (m_axis[SDL_CONTROLLER_AXIS_LEFTX])
-		result.axis.x = (float)SDL_GameControllerGetAxis(m_controller, SDL_CONTROLLER_AXIS_LEFTX) / 32767.0f;
+		result.axis.x = (float)state.axis[SDL_CONTROLLER_AXIS_LEFTX] / 32767.0f;
 
 	if (m_axis[SDL_CONTROLLER_AXIS_LEFTY])
-		result.axis.y = (float)SDL_GameControllerGetAxis(m_controller, SDL_CONTROLLER_AXIS_LEFTY) / 32767.0f;
+		result.axis.y = (float)state.axis[SDL_CONTROLLER_AXIS_LEFTY] / 32767.0f;
 
 	if (m_axis[SDL_CONTROLLER_AXIS_RIGHTX])
-		result.rotation.x = (float)SDL_GameControllerGetAxis(m_controller, SDL_CONTROLLER_AXIS_RIGHTX) / 32767.0f;
+		result.rotation.x = (float)state.axis[SDL_CONTROLLER_AXIS_RIGHTX] / 32767.0f;
 
 	if (m_axis[SDL_CONTROLLER_AXIS_RIGHTY])
-		result.rotation.y = (float)SDL_GameControllerGetAxis(m_controller, SDL_CONTROLLER_AXIS_RIGHTY) / 32767.0f;
+		result.rotation.y = (float)state.axis[SDL_CONTROLLER_AXIS_RIGHTY] / 32767.0f;
 
 	if (m_axis[SDL_CONTROLLER_AXIS_TRIGGERLEFT])
-		result.trigger.x = (float)SDL_GameControllerGetAxis(m_controller, SDL_CONTROLLER_AXIS_TRIGGERLEFT) / 32767.0f;
+		result.trigger.x = (float)state.axis[SDL_CONTROLLER_AXIS_TRIGGERLEFT] / 32767.0f;
 
 	if (m_axis[SDL_CONTROLLER_AXIS_TRIGGERRIGHT])
-		result.trigger.y = (float)SDL_GameControllerGetAxis(m_controller, SDL_CONTROLLER_AXIS_TRIGGERRIGHT) / 32767.0f;
+		result.trigger.y = (float)state.axis[SDL_CONTROLLER_AXIS_TRIGGERRIGHT] / 32767.0f;
 
 	return result;
 }
@@ -49,6 +49,7 @@ private:
 	std::recursive_mutex m_controller_mutex;
 	SDL_GameController* m_controller = nullptr;
 	SDL_JoystickID m_diid = -1;
+	std::shared_ptr<SDLControllerProvider::StateSlot> m_state_slot;
 
 	bool m_has_gyro = false;
 	bool m_has_accel = false;
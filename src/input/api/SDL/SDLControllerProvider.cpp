@@ -122,6 +122,42 @@ MotionSample SDLControllerProvider::motion_sample(int diid)
 	return m_motion_data[diid];
 }
 
+std::shared_ptr<SDLControllerProvider::StateSlot> SDLControllerProvider::get_state_slot(SDL_JoystickID diid)
+{
+	std::scoped_lock lock(m_state_slots_mutex);
+	auto [it, inserted] = m_state_slots.try_emplace(diid);
+	if (inserted)
+	{
+		it->second.slot = std::make_shared<StateSlot>();
+		seed_state_slot(diid);
+	}
+	return it->second.slot;
+}
+
+void SDLControllerProvider::seed_state_slot(SDL_JoystickID diid)
+{
+	const auto it = m_state_slots.find(diid);
+	if (it == m_state_slots.end())
+		return;
+
+	auto& state = it->second.state;
+	state = {};
+	SDL_GameController* controller = SDL_GameControllerFromInstanceID(diid);
+	if (controller)
+	{
+		state.connected = SDL_GameControllerGetAttached(controller) == SDL_TRUE;
+		for (int i = 0; i < SDL_CONTROLLER_BUTTON_MAX; ++i)
+		{
+			if (SDL_GameControllerGetButton(controller, (SDL_GameControllerButton)i))
+				state.buttons |= 1u << i;
+		}
+
+		for (int i = 0; i < SDL_CONTROLLER_AXIS_MAX; ++i)
+			state.axis[i] = SDL_GameControllerGetAxis(controller, (SDL_GameControllerAxis)i);
+	}
+	it->second.slot->store(state);
+}
+
 void SDLControllerProvider::event_thread()
 {
 	SetThreadName("SDL_events");
@@ -138,14 +174,34 @@ void SDLControllerProvider::event_thread()
 			
 		case SDL_CONTROLLERAXISMOTION: /**< Game controller axis motion */
 		{
+			if (event.caxis.axis >= SDL_CONTROLLER_AXIS_MAX)
+				break;
+
+			std::scoped_lock lock(m_state_slots_mutex);
+			const auto it = m_state_slots.find(event.caxis.which);
+			if (it == m_state_slots.end())
+				break;
+
+			it->second.state.axis[event.caxis.axis] = event.caxis.value;
+			it->second.slot->store(it->second.state);
 			break;
 		}
 		case SDL_CONTROLLERBUTTONDOWN: /**< Game controller button pressed */
-		{
-			break;
-		}
 		case SDL_CONTROLLERBUTTONUP: /**< Game controller button released */
 		{
+			if (event.cbutton.button >= SDL_CONTROLLER_BUTTON_MAX)
+				break;
+
+			std::scoped_lock lock(m_state_slots_mutex);
+			const auto it = m_state_slots.find(event.cbutton.which);
+			if (it == m_state_slots.end())
+				break;
+
+			if (event.cbutton.state == SDL_PRESSED)
+				it->second.state.buttons |= 1u << event.cbutton.button;
+			else
+				it->second.state.buttons &= ~(1u << event.cbutton.button);
+			it->second.slot->store(it->second.state);
 			break;
 		}
 		case SDL_CONTROLLERDEVICEADDED: /**< A new Game controller has been inserted into the system */
@@ -155,11 +211,23 @@ void SDLControllerProvider::event_thread()
 		}
 		case SDL_CONTROLLERDEVICEREMOVED: /**< An opened Game controller has been removed */
 		{
+			{
+				std::scoped_lock lock(m_state_slots_mutex);
+				const auto it = m_state_slots.find(event.cdevice.which);
+				if (it != m_state_slots.end())
+				{
+					it->second.state = {};
+					it->second.slot->store(it->second.state);
+					m_state_slots.erase(it);
+				}
+			}
 			InputManager::instance().on_device_changed();
 			break;
 		}
 		case SDL_CONTROLLERDEVICEREMAPPED: /**< The controller mapping was updated */
 		{
+			std::scoped_lock lock(m_state_slots_mutex);
+			seed_state_slot(event.cdevice.which);
 			break;
 		}
 		case SDL_CONTROLLERTOUCHPADDOWN:        /**< Game controller touchpad was touched */
@@ -1,8 +1,10 @@
 #pragma once
 #if HAS_SDL
 #include <SDL2/SDL_joystick.h>
+#include <SDL2/SDL_gamecontroller.h>
 #include "input/motion/MotionHandler.h"
 #include "input/api/ControllerProvider.h"
+#include "input/api/ControllerStateSlot.h"
 
 
 static bool operator==(const SDL_JoystickGUID& g1, const SDL_JoystickGUID& g2)
@@ -26,8 +28,23 @@ public:
 
 	MotionSample motion_sample(int diid);
 
+	// button and axis state as reported by the controller events, before any mapping is applied
+	struct RawState
+	{
+		bool connected;
+		uint32 buttons; // bit per SDL_GameControllerButton
+		std::array<sint16, SDL_CONTROLLER_AXIS_MAX> axis;
+	};
+	static_assert(SDL_CONTROLLER_BUTTON_MAX <= 32);
+	using StateSlot = ControllerStateSlot<RawState>;
+
+	// returns the slot the event thread publishes the state of the given controller to
+	std::shared_ptr<StateSlot> get_state_slot(SDL_JoystickID diid);
+
 private:
 	void event_thread();
+	// reads the current state from SDL, m_state_slots_mutex must be held
+	void seed_state_slot(SDL_JoystickID diid);
 	
 	std::atomic_bool m_running = false;
 	std::thread m_thread;
@@ -49,6 +66,15 @@ private:
 
 	std::array<MotionInfoTracking, 8> m_motion_tracking{};
 
+	struct StateSlotEntry
+	{
+		RawState state{};
+		std::shared_ptr<StateSlot> slot;
+	};
+	// writes from the event thread and from seeding are serialized by this mutex, readers only access the slots
+	std::mutex m_state_slots_mutex;
+	std::unordered_map<SDL_JoystickID, StateSlotEntry> m_state_slots;
+
 };
 
 #endif // HAS_SDL
@@ -46,6 +46,8 @@ public:
 
 	void connect();
 	virtual void update();
+	// whether update() has to be called again without waiting for an input event (e.g. to step a rumble pattern)
+	virtual bool needs_periodic_update() { return false; }
 	void controllers_update_states();
 
 	virtual glm::vec2 get_axis() const = 0;
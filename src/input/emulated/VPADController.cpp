@@ -184,6 +184,12 @@ void VPADController::update()
 	}
 }
 
+bool VPADController::needs_periodic_update()
+{
+	std::scoped_lock lock(m_rumble_mutex);
+	return !m_rumble_queue.empty() || m_rumble;
+}
+
 void VPADController::update_touch(VPADStatus_t& status)
 {
 	status.tpData.touch = kTpTouchOff;
@@ -406,7 +412,7 @@ bool VPADController::push_rumble(uint8* pattern, uint8 length)
 		return true;
 	}
 
-	std::scoped_lock lock(m_rumble_mutex);
+	std::unique_lock lock(m_rumble_mutex);
 	if (m_rumble_queue.size() >= 5)
 	{
 		cemuLog_logDebugOnce(LogType::Force, "VPADControlMotor(): Pattern too long");
@@ -434,6 +440,10 @@ bool VPADController::push_rumble(uint8* pattern, uint8 length)
 
 	m_rumble_queue.emplace(std::move(bitset));
 	m_last_rumble_check = {};
+	lock.unlock();
+
+	// the update thread only wakes up periodically while a pattern is playing
+	InputManager::instance().wake_update_thread();
 
 	return true;
 }
@@ -57,6 +57,7 @@ public:
 	void VPADRead(VPADStatus_t& status, const BtnRepeat& repeat);
 
 	void update() override;
+	bool needs_periodic_update() override;
 
 	uint32 get_emulated_button_flag(uint32 id) const override;
 
@@ -18,6 +18,7 @@
 #include "Common/cpu_features.h"
 
 #include "util/helpers/helpers.h"
+#include "util/ThreadPool/ThreadPool.h"
 #include "config/ActiveSettings.h"
 #include "Cafe/HW/Latte/Renderer/Vulkan/VsyncDriver.h"
 
@@ -125,6 +126,11 @@ void CemuCommonInit()
 	GetConfigHandle().Load();
 	if (NetworkConfig::XMLExists())
 		n_config.Load();
+	// must happen before the first task is submitted, the workers are spawned on first use
+	const auto& config = GetConfig();
+	ThreadPool::SetWorkerCount(ThreadPool::Priority::High, config.thread_pool.high_workers);
+	ThreadPool::SetWorkerCount(ThreadPool::Priority::Normal, config.thread_pool.normal_workers);
+	ThreadPool::SetWorkerCount(ThreadPool::Priority::Background, config.thread_pool.background_workers);
 	// parallelize expensive init code
 	std::future<int> futureInitAudioAPI = std::async(std::launch::async, []{ IAudioAPI::InitializeStatic(); IAudioInputAPI::InitializeStatic(); return 0; });
 	std::future<int> futureInitGraphicPacks = std::async(std::launch::async, []{ GraphicPack2::LoadAll(); return 0; });
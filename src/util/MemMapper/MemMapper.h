@@ -21,4 +21,7 @@ namespace MemMapper
 
 	void* AllocateMemory(void* baseAddr, size_t size, PAGE_PERMISSION permissionFlags, bool fromReservation = false);
 	void FreeMemory(void* baseAddr, size_t size, bool fromReservation = false);
+
+	// changes the permissions of already allocated pages, baseAddr and size must be page aligned
+	bool ProtectMemory(void* baseAddr, size_t size, PAGE_PERMISSION permissionFlags);
 };
\ No newline at end of file
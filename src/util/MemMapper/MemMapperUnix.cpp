@@ -25,6 +25,8 @@ namespace MemMapper
 			p = PROT_READ | PROT_WRITE;
 		else if (HAS_FLAG(permissionFlags, PAGE_PERMISSION::P_READ) && !HAS_FLAG(permissionFlags, PAGE_PERMISSION::P_WRITE) && !HAS_FLAG(permissionFlags, PAGE_PERMISSION::P_EXECUTE))
 			p = PROT_READ;
+		else if (permissionFlags == PAGE_PERMISSION::P_NONE)
+			p = PROT_NONE;
 		else
 			cemu_assert_unimplemented();
 		return p;
@@ -67,4 +69,9 @@ namespace MemMapper
 			munmap(baseAddr, size);
 	}
 
+	bool ProtectMemory(void* baseAddr, size_t size, PAGE_PERMISSION permissionFlags)
+	{
+		return mprotect(baseAddr, size, GetProt(permissionFlags)) == 0;
+	}
+
 };
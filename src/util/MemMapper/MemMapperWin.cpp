@@ -26,6 +26,8 @@ namespace MemMapper
 			p = PAGE_READWRITE;
 		else if (HAS_FLAG(permissionFlags, PAGE_PERMISSION::P_READ) && !HAS_FLAG(permissionFlags, PAGE_PERMISSION::P_WRITE) && !HAS_FLAG(permissionFlags, PAGE_PERMISSION::P_EXECUTE))
 			p = PAGE_READONLY;
+		else if (permissionFlags == PAGE_PERMISSION::P_NONE)
+			p = PAGE_NOACCESS;
 		else
 			cemu_assert_unimplemented();
 		return p;
@@ -60,4 +62,10 @@ namespace MemMapper
 			VirtualFree(baseAddr, size, MEM_RELEASE);
 	}
 
+	bool ProtectMemory(void* baseAddr, size_t size, PAGE_PERMISSION permissionFlags)
+	{
+		DWORD oldProtect;
+		return VirtualProtect(baseAddr, size, GetPageProtection(permissionFlags), &oldProtect) != FALSE;
+	}
+
 };
@@ -0,0 +1,320 @@
+#include "util/ThreadPool/ThreadPool.h"
+#include "util/helpers/helpers.h"
+#include "util/helpers/Semaphore.h"
+
+struct ThreadPoolWorker
+{
+	std::mutex mutex;
+	std::deque<std::unique_ptr<ThreadPool::Task>> tasks;
+	std::thread thread;
+};
+
+class ThreadPoolClass
+{
+public:
+	ThreadPoolClass(ThreadPool::Priority priority, const char* name) : m_priority(priority), m_name(name) {};
+
+	void SetWorkerCount(uint32 workerCount)
+	{
+		std::unique_lock _l(m_startMutex);
+		if (m_isStarted)
+		{
+			cemuLog_log(LogType::Force, "ThreadPool: Worker count of {} class is already fixed", m_name);
+			return;
+		}
+		m_configuredWorkerCount = workerCount;
+	}
+
+	uint32 GetWorkerCount()
+	{
+		std::unique_lock _l(m_startMutex);
+		if (m_isStarted)
+			return (uint32)m_workers.size();
+		return m_configuredWorkerCount != 0 ? m_configuredWorkerCount : GetDefaultWorkerCount();
+	}
+
+	void Push(std::unique_ptr<ThreadPool::Task> task);
+
+private:
+	uint32 GetDefaultWorkerCount() const
+	{
+		switch (m_priority)
+		{
+		case ThreadPool::Priority::High:
+			// enough to serve file I/O of several FSA clients alongside recompilation and parallel RPL inflation
+			return std::clamp<uint32>(std::thread::hardware_concurrency() / 2, 3, 8);
+		case ThreadPool::Priority::Normal:
+			return std::clamp<uint32>(std::thread::hardware_concurrency() / 2, 2, 8);
+		case ThreadPool::Priority::Background:
+		{
+			// leave one physical core to the emulated CPU and GPU threads
+			uint32 cpuCoreCount = GetPhysicalCoreCount();
+			return std::clamp<uint32>(cpuCoreCount > 2 ? cpuCoreCount - 1 : 1, 1, 8);
+		}
+		}
+		return 1;
+	}
+
+	void StartWorkers();
+	void WorkerThread(uint32 workerIndex);
+	bool TakeTask(uint32 workerIndex, std::unique_ptr<ThreadPool::Task>& taskOut);
+
+	ThreadPool::Priority m_priority;
+	const char* m_name;
+	uint32 m_configuredWorkerCount{0};
+	std::mutex m_startMutex;
+	std::atomic<bool> m_isStarted{false};
+	std::vector<std::unique_ptr<ThreadPoolWorker>> m_workers;
+	CounterSemaphore m_pendingTasks;
+	std::atomic<uint32> m_nextWorkerIndex{0};
+};
+
+// set for pool worker threads, used to push tasks submitted from within a task to the worker's own deque
+thread_local ThreadPoolClass* s_currentClass{};
+thread_local uint32 s_currentWorkerIndex{};
+
+void ThreadPoolClass::StartWorkers()
+{
+	std::unique_lock _l(m_startMutex);
+	if (m_isStarted)
+		return;
+	uint32 workerCount = m_configuredWorkerCount != 0 ? m_configuredWorkerCount : GetDefaultWorkerCount();
+	for (uint32 i = 0; i < workerCount; i++)
+		m_workers.emplace_back(std::make_unique<ThreadPoolWorker>());
+	for (uint32 i = 0; i < workerCount; i++)
+		m_workers[i]->thread = std::thread(&ThreadPoolClass::WorkerThread, this, i);
+	m_isStarted = true;
+}
+
+void ThreadPoolClass::Push(std::unique_ptr<ThreadPool::Task> task)
+{
+	if (!m_isStarted.load(std::memory_order::acquire))
+		StartWorkers();
+	// tasks spawned by a task stay on the same worker, others are distributed round-robin
+	uint32 workerIndex;
+	if (s_currentClass == this)
+		workerIndex = s_currentWorkerIndex;
+	else
+		workerIndex = m_nextWorkerIndex.fetch_add(1, std::memory_order::relaxed) % (uint32)m_workers.size();
+	ThreadPoolWorker& worker = *m_workers[workerIndex];
+	worker.mutex.lock();
+	worker.tasks.emplace_back(std::move(task));
+	worker.mutex.unlock();
+	m_pendingTasks.increment();
+}
+
+// a worker only gets here after it decremented m_pendingTasks, so at least one task is guaranteed to be queued in the class
+// returns false if it was missed because tasks moved around while scanning
+bool ThreadPoolClass::TakeTask(uint32 workerIndex, std::unique_ptr<ThreadPool::Task>& taskOut)
+{
+	// own deque is LIFO for cache locality
+	ThreadPoolWorker& ownWorker = *m_workers[workerIndex];
+	ownWorker.mutex.lock();
+	if (!ownWorker.tasks.empty())
+	{
+		taskOut = std::move(ownWorker.tasks.back());
+		ownWorker.tasks.pop_back();
+		ownWorker.mutex.unlock();
+		return true;
+	}
+	ownWorker.mutex.unlock();
+	// steal the oldest task from another worker
+	const uint32 workerCount = (uint32)m_workers.size();
+	for (uint32 i = 1; i < workerCount; i++)
+	{
+		ThreadPoolWorker& victim = *m_workers[(workerIndex + i) % workerCount];
+		victim.mutex.lock();
+		if (!victim.tasks.empty())
+		{
+			taskOut = std::move(victim.tasks.front());
+			victim.tasks.pop_front();
+			victim.mutex.unlock();
+			return true;
+		}
+		victim.mutex.unlock();
+	}
+	return false;
+}
+
+void ThreadPoolClass::WorkerThread(uint32 workerIndex)
+{
+	SetThreadName(fmt::format("Pool{}-{}", m_name, workerIndex).c_str());
+#if BOOST_OS_WINDOWS
+	// to avoid starving the main cpu and render threads background workers run at lower priority
+	// except for one thread which we always run at normal priority to prevent the opposite scenario where all background work is starved
+	if (m_priority == ThreadPool::Priority::Background && workerIndex != 0)
+		SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_BELOW_NORMAL);
+#endif
+	s_currentClass = this;
+	s_currentWorkerIndex = workerIndex;
+	// the pool lives until the process exits, same as the detached threads it replaces
+	while (true)
+	{
+		m_pendingTasks.decrementWithWait();
+		std::unique_ptr<ThreadPool::Task> task;
+		// the task we were counted for can be stolen while a concurrently submitted task lands in a deque we already scanned. Rescan until we get one
+		while (!TakeTask(workerIndex, task))
+			_mm_pause();
+		task->Run();
+	}
+}
+
+// hands delayed tasks to their class once they are due. The thread is only spawned on first use
+class ThreadPoolTimer
+{
+public:
+	void Schedule(ThreadPoolClass* poolClass, std::unique_ptr<ThreadPool::Task> task, std::chrono::milliseconds delay)
+	{
+		std::unique_lock _l(m_mutex);
+		if (!m_thread.joinable())
+			m_thread = std::thread(&ThreadPoolTimer::TimerThread, this);
+		m_scheduledTasks.emplace(std::chrono::steady_clock::now() + delay, ScheduledTask{poolClass, std::move(task)});
+		m_condition.notify_one();
+	}
+
+private:
+	struct ScheduledTask
+	{
+		ThreadPoolClass* poolClass;
+		std::unique_ptr<ThreadPool::Task> task;
+	};
+
+	void TimerThread()
+	{
+		SetThreadName("PoolTimer");
+		std::unique_lock _l(m_mutex);
+		while (true)
+		{
+			if (m_scheduledTasks.empty())
+			{
+				m_condition.wait(_l);
+				continue;
+			}
+			auto it = m_scheduledTasks.begin();
+			if (it->first > std::chrono::steady_clock::now())
+			{
+				m_condition.wait_until(_l, it->first);
+				continue;
+			}
+			ScheduledTask scheduledTask = std::move(it->second);
+			m_scheduledTasks.erase(it);
+			_l.unlock();
+			scheduledTask.poolClass->Push(std::move(scheduledTask.task));
+			_l.lock();
+		}
+	}
+
+	std::mutex m_mutex;
+	std::condition_variable m_condition;
+	std::multimap<std::chrono::steady_clock::time_point, ScheduledTask> m_scheduledTasks;
+	std::thread m_thread;
+};
+
+static ThreadPoolClass& GetPoolClass(ThreadPool::Priority priority)
+{
+	// intentionally leaked so that tasks still running during static destruction don't operate on destroyed queues
+	static ThreadPoolClass* s_classes[ThreadPool::PRIORITY_COUNT] = {
+		new ThreadPoolClass(ThreadPool::Priority::High, "High"),
+		new ThreadPoolClass(ThreadPool::Priority::Normal, "Normal"),
+		new ThreadPoolClass(ThreadPool::Priority::Background, "Bg"),
+	};
+	cemu_assert_debug((size_t)priority < ThreadPool::PRIORITY_COUNT);
+	return *s_classes[(size_t)priority];
+}
+
+// runs the oldest queued task of a group, see TaskGroup::SharedState
+class ThreadPoolGroupTask : public ThreadPool::Task
+{
+public:
+	ThreadPoolGroupTask(std::shared_ptr<ThreadPool::TaskGroup::SharedState> state) : m_state(std::move(state)) {};
+	void Run() override { ThreadPool::TaskGroup::RunNextTask(*m_state); }
+
+private:
+	std::shared_ptr<ThreadPool::TaskGroup::SharedState> m_state;
+};
+
+void ThreadPool::SubmitTask(Priority priority, std::unique_ptr<Task> task, TaskGroup* taskGroup, std::chrono::milliseconds delay)
+{
+	if (taskGroup)
+	{
+		TaskGroup::SharedState& state = *taskGroup->m_state;
+		std::unique_lock _l(state.mutex);
+		state.tasks.emplace_back(std::move(task));
+		state.pendingCount.fetch_add(1);
+		_l.unlock();
+		task = std::make_unique<ThreadPoolGroupTask>(taskGroup->m_state);
+	}
+	if (delay.count() > 0)
+	{
+		// intentionally leaked, same as the classes
+		static ThreadPoolTimer* s_timer = new ThreadPoolTimer();
+		s_timer->Schedule(&GetPoolClass(priority), std::move(task), delay);
+		return;
+	}
+	GetPoolClass(priority).Push(std::move(task));
+}
+
+void ThreadPool::SetWorkerCount(Priority priority, uint32 workerCount)
+{
+	GetPoolClass(priority).SetWorkerCount(workerCount);
+}
+
+uint32 ThreadPool::GetWorkerCount(Priority priority)
+{
+	return GetPoolClass(priority).GetWorkerCount();
+}
+
+// returns false if no task of the group is left in the queue
+bool ThreadPool::TaskGroup::RunNextTask(SharedState& state)
+{
+	std::unique_lock _l(state.mutex);
+	if (state.tasks.empty())
+		return false;
+	std::unique_ptr<Task> task = std::move(state.tasks.front());
+	state.tasks.pop_front();
+	_l.unlock();
+	if (!state.isCancelled.load(std::memory_order::relaxed))
+		task->Run();
+	task.reset(); // destroy captured state before the group is signaled
+	_l.lock();
+	if (state.pendingCount.fetch_sub(1) == 1)
+		state.condition.notify_all();
+	return true;
+}
+
+void ThreadPool::TaskGroup::Wait()
+{
+	SharedState& state = *m_state;
+	while (RunNextTask(state)) {}
+	std::unique_lock _l(state.mutex);
+	while (state.pendingCount.load() != 0)
+		state.condition.wait(_l);
+}
+
+void ThreadPool::SerialQueue::SubmitTask(std::unique_ptr<Task> task)
+{
+	std::unique_lock _l(m_mutex);
+	m_tasks.emplace_back(std::move(task));
+	if (m_isScheduled)
+		return;
+	m_isScheduled = true;
+	// submit while holding the lock so that Wait() can't observe the group as done in between
+	ThreadPool::Submit(m_priority, [this]() { Drain(); }, &m_taskGroup);
+}
+
+void ThreadPool::SerialQueue::Drain()
+{
+	while (true)
+	{
+		std::unique_lock _l(m_mutex);
+		if (m_tasks.empty())
+		{
+			m_isScheduled = false;
+			return;
+		}
+		std::unique_ptr<Task> task = std::move(m_tasks.front());
+		m_tasks.pop_front();
+		_l.unlock();
+		task->Run();
+	}
+}
@@ -1,15 +1,133 @@
+#pragma once
 #include <thread>
+#include <deque>
+#include <functional>
 
+// shared pool of worker threads
+// workers are split into priority classes which each own a fixed set of threads. Background work like shader compilation can never occupy the threads latency sensitive work relies on
+// within a class every worker has its own task deque. Workers run tasks from their own deque first and steal from the other workers of the same class once it runs empty
 class ThreadPool
 {
 public:
+	enum class Priority : uint8
+	{
+		High, // latency sensitive work the emulation is waiting on (file I/O, recompilation)
+		Normal, // general purpose asynchronous work
+		Background, // bulk work like shader and pipeline compilation. Runs at lower OS thread priority
+	};
+	static constexpr size_t PRIORITY_COUNT = 3;
+
+	class Task
+	{
+	public:
+		virtual ~Task() = default;
+		virtual void Run() = 0;
+	};
+
+	// tracks a set of tasks so they can be waited on or cancelled together
+	class TaskGroup
+	{
+	public:
+		TaskGroup() = default;
+		TaskGroup(const TaskGroup&) = delete;
+		TaskGroup& operator=(const TaskGroup&) = delete;
+		~TaskGroup() { Wait(); }
+
+		// tasks which have not started yet are dropped without running. Running tasks can poll IsCancelled() to exit early
+		void Cancel() { m_state->isCancelled.store(true); }
+		bool IsCancelled() const { return m_state->isCancelled.load(std::memory_order::relaxed); }
+		bool IsDone() const { return m_state->pendingCount.load() == 0; }
+		// runs the tasks of the group which no worker has picked up yet on the calling thread, then waits for the ones already in flight
+		// this way waiting never depends on free workers in the class. Must not be called from a task of the same group
+		void Wait();
+
+	private:
+		friend class ThreadPool;
+		friend class ThreadPoolGroupTask;
+
+		// tasks are queued here and the pool only receives a placeholder which runs the next one of them
+		// the state outlives the group since placeholders whose task was already run by Wait() can still be queued in the pool
+		struct SharedState
+		{
+			std::mutex mutex;
+			std::condition_variable condition;
+			std::deque<std::unique_ptr<Task>> tasks;
+			std::atomic<uint32> pendingCount{0};
+			std::atomic<bool> isCancelled{false};
+		};
+
+		static bool RunNextTask(SharedState& state);
+
+		std::shared_ptr<SharedState> m_state{std::make_shared<SharedState>()};
+	};
+
+	// runs tasks one at a time and in submission order, on the workers of the given priority class
+	class SerialQueue
+	{
+	public:
+		SerialQueue(Priority priority = Priority::Normal) : m_priority(priority) {};
+		SerialQueue(const SerialQueue&) = delete;
+		SerialQueue& operator=(const SerialQueue&) = delete;
+		~SerialQueue() { Wait(); }
+
+		template<class TFunction>
+		void Submit(TFunction&& f)
+		{
+			SubmitTask(std::make_unique<FunctionTask<std::decay_t<TFunction>>>(std::forward<TFunction>(f)));
+		}
+
+		// waits until all submitted tasks have run. If no worker has started on the queue yet it is drained on the calling thread
+		void Wait() { m_taskGroup.Wait(); }
+
+	private:
+		void SubmitTask(std::unique_ptr<Task> task);
+		void Drain();
+
+		Priority m_priority;
+		std::mutex m_mutex;
+		std::deque<std::unique_ptr<Task>> m_tasks;
+		bool m_isScheduled{false};
+		TaskGroup m_taskGroup;
+	};
+
+	template<class TFunction>
+	static void Submit(Priority priority, TFunction&& f, TaskGroup* taskGroup = nullptr)
+	{
+		SubmitTask(priority, std::make_unique<FunctionTask<std::decay_t<TFunction>>>(std::forward<TFunction>(f)), taskGroup, {});
+	}
+
+	// same as Submit() but the task is only handed to the workers once the delay has passed. Used instead of sleeping inside a task
+	template<class TFunction>
+	static void SubmitDelayed(Priority priority, std::chrono::milliseconds delay, TFunction&& f, TaskGroup* taskGroup = nullptr)
+	{
+		SubmitTask(priority, std::make_unique<FunctionTask<std::decay_t<TFunction>>>(std::forward<TFunction>(f)), taskGroup, delay);
+	}
+
+	// runs f on a dedicated detached thread. Meant for long running or blocking work (network transfers, waiting on debugger events) which would otherwise hold a pool worker indefinitely
 	template<class TFunction, class... TArgs>
 	static void FireAndForget(TFunction&& f, TArgs&&... args)
 	{
-		// todo - find a way to use std::async here so we can utilize thread pooling?
 		std::thread t(std::forward<TFunction>(f), std::forward<TArgs>(args)...);
 		t.detach();
 	}
 
+	// set the number of workers of a priority class. Zero selects a default based on the host CPU
+	// workers are spawned on first use of a class, changing the count afterwards has no effect until restart
+	static void SetWorkerCount(Priority priority, uint32 workerCount);
+	static uint32 GetWorkerCount(Priority priority);
+
+private:
+	template<class TFunction>
+	class FunctionTask : public Task
+	{
+	public:
+		template<class TArg>
+		FunctionTask(TArg&& f) : m_function(std::forward<TArg>(f)) {};
+		void Run() override { m_function(); }
+
+	private:
+		TFunction m_function;
+	};
 
-};
\ No newline at end of file
+	static void SubmitTask(Priority priority, std::unique_ptr<Task> task, TaskGroup* taskGroup, std::chrono::milliseconds delay);
+};
@@ -0,0 +1,200 @@
+#include "util/TraceRecorder/TraceRecorder.h"
+#include "util/helpers/fspinlock.h"
+#include "Common/FileStream.h"
+
+struct TraceEvent
+{
+	const char* category;
+	const char* name;
+	const char* argName;
+	uint64 argValue;
+	HRTick beginTick;
+	HRTick endTick;
+	TraceRecorder::ArgFormat argFormat;
+	bool isInstant;
+};
+
+struct TraceThreadBuffer
+{
+	FSpinlock spinlock;
+	std::vector<TraceEvent> events;
+	std::string threadName;
+	uint32 threadId;
+	uint32 droppedEventCount{0};
+};
+
+// caps memory usage of long recordings, events past this are dropped and reported when the trace is written
+static constexpr size_t TRACE_MAX_EVENTS_PER_THREAD = 1 << 19;
+
+static std::mutex s_traceBufferListMutex;
+// buffers stay registered after their thread exits so that its events still end up in the trace
+static std::vector<std::shared_ptr<TraceThreadBuffer>> s_traceBufferList;
+static std::atomic<HRTick> s_traceStartTick{0};
+
+thread_local std::shared_ptr<TraceThreadBuffer> t_traceBuffer;
+thread_local std::string t_traceThreadName;
+
+static TraceThreadBuffer& TraceRecorder_GetThreadBuffer()
+{
+	if (t_traceBuffer)
+		return *t_traceBuffer;
+	auto buffer = std::make_shared<TraceThreadBuffer>();
+	buffer->threadName = t_traceThreadName;
+	std::unique_lock _l(s_traceBufferListMutex);
+	buffer->threadId = (uint32)s_traceBufferList.size() + 1;
+	s_traceBufferList.emplace_back(buffer);
+	_l.unlock();
+	t_traceBuffer = std::move(buffer);
+	return *t_traceBuffer;
+}
+
+static void TraceRecorder_PushEvent(const TraceEvent& evt)
+{
+	TraceThreadBuffer& buffer = TraceRecorder_GetThreadBuffer();
+	std::unique_lock _l(buffer.spinlock);
+	if (buffer.events.size() >= TRACE_MAX_EVENTS_PER_THREAD)
+	{
+		buffer.droppedEventCount++;
+		return;
+	}
+	buffer.events.emplace_back(evt);
+}
+
+void TraceRecorder::Start()
+{
+	std::unique_lock _l(s_traceBufferListMutex);
+	s_isRecording.store(false);
+	for (auto& buffer : s_traceBufferList)
+	{
+		std::unique_lock _lb(buffer->spinlock);
+		buffer->events.clear();
+		buffer->droppedEventCount = 0;
+	}
+	s_traceStartTick.store(HighResolutionTimer::now().getTick());
+	s_isRecording.store(true);
+}
+
+void TraceRecorder::CompleteEvent(const char* category, const char* name, HRTick beginTick, HRTick endTick, const char* argName, uint64 argValue, ArgFormat argFormat)
+{
+	if (!IsRecording())
+		return;
+	TraceRecorder_PushEvent({category, name, argName, argValue, beginTick, endTick, argFormat, false});
+}
+
+void TraceRecorder::InstantEvent(const char* category, const char* name, const char* argName, uint64 argValue, ArgFormat argFormat)
+{
+	if (!IsRecording())
+		return;
+	HRTick tick = HighResolutionTimer::now().getTick();
+	TraceRecorder_PushEvent({category, name, argName, argValue, tick, tick, argFormat, true});
+}
+
+void TraceRecorder::SetCurrentThreadName(const char* name)
+{
+	t_traceThreadName = name;
+	if (t_traceBuffer)
+	{
+		std::unique_lock _l(t_traceBuffer->spinlock);
+		t_traceBuffer->threadName = name;
+	}
+}
+
+static void TraceRecorder_AppendJsonString(fmt::memory_buffer& buf, std::string_view str)
+{
+	buf.push_back('"');
+	for (char c : str)
+	{
+		if (c == '"' || c == '\\')
+		{
+			buf.push_back('\\');
+			buf.push_back(c);
+		}
+		else if ((uint8)c < 0x20)
+			fmt::format_to(std::back_inserter(buf), "\\u{:04x}", (uint32)(uint8)c);
+		else
+			buf.push_back(c);
+	}
+	buf.push_back('"');
+}
+
+bool TraceRecorder::Stop(const fs::path& outputPath)
+{
+	s_isRecording.store(false);
+	const HRTick startTick = s_traceStartTick.load();
+	const double ticksToMicroseconds = 1000000.0 / (double)HighResolutionTimer::getFrequency();
+
+	std::unique_ptr<FileStream> fs(FileStream::createFile2(outputPath));
+	if (!fs)
+	{
+		cemuLog_log(LogType::Force, "TraceRecorder: Unable to create {}", _pathToUtf8(outputPath));
+		return false;
+	}
+
+	// serialize one thread at a time and flush in chunks to keep the peak memory usage low
+	fmt::memory_buffer buf;
+	fmt::format_to(std::back_inserter(buf), "{{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+	bool isFirstEvent = true;
+	uint32 eventCount = 0;
+	uint32 droppedEventCount = 0;
+	std::unique_lock _l(s_traceBufferListMutex);
+	for (auto& buffer : s_traceBufferList)
+	{
+		std::unique_lock _lb(buffer->spinlock);
+		std::vector<TraceEvent> events = std::move(buffer->events);
+		buffer->events.clear();
+		droppedEventCount += buffer->droppedEventCount;
+		buffer->droppedEventCount = 0;
+		std::string threadName = buffer->threadName.empty() ? fmt::format("Thread {}", buffer->threadId) : buffer->threadName;
+		_lb.unlock();
+		if (events.empty())
+			continue;
+		if (!isFirstEvent)
+			buf.append(std::string_view(",\n"));
+		isFirstEvent = false;
+		fmt::format_to(std::back_inserter(buf), "{{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":{},\"args\":{{\"name\":", buffer->threadId);
+		TraceRecorder_AppendJsonString(buf, threadName);
+		buf.append(std::string_view("}}"));
+		for (auto& evt : events)
+		{
+			// events which started before the recording are clipped to its start
+			if (evt.endTick < startTick)
+				continue;
+			HRTick beginTick = std::max(evt.beginTick, startTick);
+			buf.append(std::string_view(",\n{\"name\":"));
+			TraceRecorder_AppendJsonString(buf, evt.name);
+			buf.append(std::string_view(",\"cat\":"));
+			TraceRecorder_AppendJsonString(buf, evt.category);
+			double ts = (double)(beginTick - startTick) * ticksToMicroseconds;
+			if (evt.isInstant)
+				fmt::format_to(std::back_inserter(buf), ",\"ph\":\"i\",\"s\":\"t\",\"ts\":{:.3f}", ts);
+			else
+				fmt::format_to(std::back_inserter(buf), ",\"ph\":\"X\",\"ts\":{:.3f},\"dur\":{:.3f}", ts, (double)(evt.endTick - beginTick) * ticksToMicroseconds);
+			fmt::format_to(std::back_inserter(buf), ",\"pid\":1,\"tid\":{}", buffer->threadId);
+			if (evt.argName)
+			{
+				buf.append(std::string_view(",\"args\":{"));
+				TraceRecorder_AppendJsonString(buf, evt.argName);
+				if (evt.argFormat == ArgFormat::Hex)
+					fmt::format_to(std::back_inserter(buf), ":\"0x{:x}\"}}", evt.argValue);
+				else
+					fmt::format_to(std::back_inserter(buf), ":{}}}", evt.argValue);
+			}
+			buf.push_back('}');
+			eventCount++;
+			if (buf.size() >= 1024 * 1024)
+			{
+				fs->writeData(buf.data(), (sint32)buf.size());
+				buf.clear();
+			}
+		}
+	}
+	_l.unlock();
+	buf.append(std::string_view("\n]}\n"));
+	fs->writeData(buf.data(), (sint32)buf.size());
+	fs.reset();
+
+	if (droppedEventCount > 0)
+		cemuLog_log(LogType::Force, "TraceRecorder: Dropped {} events because the per-thread limit was reached", droppedEventCount);
+	cemuLog_log(LogType::Force, "TraceRecorder: Wrote {} events to {}", eventCount, _pathToUtf8(outputPath));
+	return true;
+}
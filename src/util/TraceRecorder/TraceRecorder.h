@@ -0,0 +1,68 @@
+#pragma once
+#include "util/highresolutiontimer/HighResolutionTimer.h"
+
+// records timestamped events from any thread and writes them as a Chrome trace (JSON), which can be opened in Perfetto or chrome://tracing
+// events are collected in per-thread buffers. While not recording every entry point only costs a relaxed atomic load
+// category, name and argument name strings must be string literals or otherwise outlive the recording
+class TraceRecorder
+{
+public:
+	enum class ArgFormat : uint8
+	{
+		Decimal,
+		Hex, // used for guest addresses and hashes
+	};
+
+	static bool IsRecording()
+	{
+		return s_isRecording.load(std::memory_order::relaxed);
+	}
+
+	// discards previously recorded events and starts a new recording
+	static void Start();
+	// stops recording and writes all collected events to outputPath. Returns false if the file could not be written
+	static bool Stop(const fs::path& outputPath);
+
+	static void CompleteEvent(const char* category, const char* name, HRTick beginTick, HRTick endTick, const char* argName = nullptr, uint64 argValue = 0, ArgFormat argFormat = ArgFormat::Decimal);
+	static void InstantEvent(const char* category, const char* name, const char* argName = nullptr, uint64 argValue = 0, ArgFormat argFormat = ArgFormat::Decimal);
+
+	// called by SetThreadName(), the name is used for the thread's track in the trace
+	static void SetCurrentThreadName(const char* name);
+
+	// records a complete event spanning the lifetime of the scope
+	class Scope
+	{
+	public:
+		Scope(const char* category, const char* name, const char* argName = nullptr, uint64 argValue = 0, ArgFormat argFormat = ArgFormat::Decimal)
+		{
+			if (!IsRecording())
+				return;
+			m_category = category;
+			m_name = name;
+			m_argName = argName;
+			m_argValue = argValue;
+			m_argFormat = argFormat;
+			m_beginTick = HighResolutionTimer::now().getTick();
+		}
+
+		~Scope()
+		{
+			if (m_category)
+				CompleteEvent(m_category, m_name, m_beginTick, HighResolutionTimer::now().getTick(), m_argName, m_argValue, m_argFormat);
+		}
+
+		Scope(const Scope&) = delete;
+		Scope& operator=(const Scope&) = delete;
+
+	private:
+		const char* m_category{};
+		const char* m_name{};
+		const char* m_argName{};
+		uint64 m_argValue{};
+		ArgFormat m_argFormat{};
+		HRTick m_beginTick{};
+	};
+
+private:
+	inline static std::atomic_bool s_isRecording{false};
+};
@@ -124,6 +124,8 @@ namespace ZpIR
 		{
 		public:
 
+			virtual ~__InsBase() = default;
+
 			OpCode opcode;
 			OpForm opform;
 			__InsBase* next;
@@ -342,6 +344,21 @@ namespace ZpIR
 
 		void* m_workbuffer{}; // can be used as temporary storage for information
 
+		ZpIRBasicBlock() = default;
+		ZpIRBasicBlock(const ZpIRBasicBlock&) = delete;
+
+		~ZpIRBasicBlock()
+		{
+			// the block owns its instructions
+			IR::__InsBase* ins = m_instructionFirst;
+			while (ins)
+			{
+				IR::__InsBase* next = ins->next;
+				delete ins;
+				ins = next;
+			}
+		}
+
 		void appendInstruction(IR::__InsBase* ins)
 		{
 			if (m_instructionFirst == nullptr)
@@ -491,6 +508,13 @@ namespace ZpIR
 
 	struct ZpIRFunction
 	{
+		~ZpIRFunction()
+		{
+			// entry and exit lists only reference blocks from m_basicBlocks
+			for (auto& itr : m_basicBlocks)
+				delete itr;
+		}
+
 		std::vector<ZpIRBasicBlock*> m_basicBlocks;
 		std::vector<ZpIRBasicBlock*> m_entryBlocks;
 		std::vector<ZpIRBasicBlock*> m_exitBlocks;
@@ -170,6 +170,10 @@ namespace ZirEmitter
 				expressionBuf->append("floatBitsToUint(");
 			else if (srcType == ZpIR::DataType::F32 && dstType == ZpIR::DataType::S32)
 				expressionBuf->append("floatBitsToInt(");
+			else if (srcType == ZpIR::DataType::U32 && dstType == ZpIR::DataType::S32)
+				expressionBuf->append("int(");
+			else if (srcType == ZpIR::DataType::S32 && dstType == ZpIR::DataType::U32)
+				expressionBuf->append("uint(");
 			else
 				assert_dbg();
 			appendSourceString(expressionBuf, ins->rB);
@@ -261,6 +265,13 @@ namespace ZirEmitter
 			appendSourceString(expressionBuf, ins->rC);
 			break;
 		}
+		case ZpIR::IR::OpCode::SUB:
+		{
+			appendSourceString(expressionBuf, ins->rB);
+			expressionBuf->append(" - ");
+			appendSourceString(expressionBuf, ins->rC);
+			break;
+		}
 		case ZpIR::IR::OpCode::MUL:
 		{
 			appendSourceString(expressionBuf, ins->rB);
@@ -290,7 +301,14 @@ namespace ZirEmitter
 			uint16 index;
 			loc.GetUniformRegister(index);
 			// todo - this is complex. Solve via callback
-			buf->appendFmt("uf_remappedVS[{}].{}", index/4, g_idx_to_element[index&3]);
+			// uf_remappedVS is an uvec4 array, reinterpret to the register type
+			auto dstType = m_blockContext.currentBasicBlock->getRegType(ins->regArray[0]);
+			if (dstType == ZpIR::DataType::F32)
+				buf->appendFmt("uintBitsToFloat(uf_remappedVS[{}].{})", index/4, g_idx_to_element[index&3]);
+			else if (dstType == ZpIR::DataType::S32)
+				buf->appendFmt("int(uf_remappedVS[{}].{})", index/4, g_idx_to_element[index&3]);
+			else
+				buf->appendFmt("uf_remappedVS[{}].{}", index/4, g_idx_to_element[index&3]);
 			AssignResult(ins->regArray[0], buf);
 		}
 		else if (loc.IsVertexAttribute())
@@ -394,7 +412,7 @@ namespace ZirEmitter
 			ZpIR::IRRegConstDef* constDef = m_blockContext.currentBasicBlock->getConstant(irReg);
 			if (constDef->type == ZpIR::DataType::U32)
 			{
-				buf->appendFmt("{}", constDef->value_u32);
+				buf->appendFmt("{}u", constDef->value_u32);
 				return;
 			}
 			else if (constDef->type == ZpIR::DataType::S32)
@@ -404,7 +422,8 @@ namespace ZirEmitter
 			}
 			else if (constDef->type == ZpIR::DataType::F32)
 			{
-				buf->appendFmt("{}", constDef->value_f32);
+				// decimal output is not exact for every value (and not valid GLSL for inf/nan)
+				buf->appendFmt("uintBitsToFloat({}u)", constDef->value_u32);
 				return;
 			}
 			assert_dbg();
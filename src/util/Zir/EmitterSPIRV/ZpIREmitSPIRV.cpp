@@ -0,0 +1,730 @@
+#include "util/Zir/Core/IR.h"
+#include "util/Zir/Core/ZirUtility.h"
+#include "util/Zir/EmitterSPIRV/ZpIREmitSPIRV.h"
+
+// subset of the SPIR-V enums which are used by this emitter (see SPIR-V specification, section 3)
+namespace SpvConst
+{
+	constexpr uint32 MAGIC_NUMBER = 0x07230203;
+	constexpr uint32 VERSION_1_0 = 0x00010000;
+
+	constexpr uint32 CAPABILITY_SHADER = 1;
+	constexpr uint32 ADDRESSING_MODEL_LOGICAL = 0;
+	constexpr uint32 MEMORY_MODEL_GLSL450 = 1;
+	constexpr uint32 EXECUTION_MODEL_VERTEX = 0;
+	constexpr uint32 FUNCTION_CONTROL_NONE = 0;
+
+	constexpr uint32 STORAGE_CLASS_INPUT = 1;
+	constexpr uint32 STORAGE_CLASS_UNIFORM = 2;
+	constexpr uint32 STORAGE_CLASS_OUTPUT = 3;
+
+	constexpr uint32 DECORATION_BLOCK = 2;
+	constexpr uint32 DECORATION_ARRAY_STRIDE = 6;
+	constexpr uint32 DECORATION_BUILTIN = 11;
+	constexpr uint32 DECORATION_NO_PERSPECTIVE = 13;
+	constexpr uint32 DECORATION_FLAT = 14;
+	constexpr uint32 DECORATION_LOCATION = 30;
+	constexpr uint32 DECORATION_BINDING = 33;
+	constexpr uint32 DECORATION_DESCRIPTOR_SET = 34;
+	constexpr uint32 DECORATION_OFFSET = 35;
+
+	constexpr uint32 BUILTIN_POSITION = 0;
+}
+
+enum class SpvOp : uint16
+{
+	MemoryModel = 14,
+	EntryPoint = 15,
+	Capability = 17,
+	TypeVoid = 19,
+	TypeInt = 21,
+	TypeFloat = 22,
+	TypeVector = 23,
+	TypeArray = 28,
+	TypeStruct = 30,
+	TypePointer = 32,
+	TypeFunction = 33,
+	Constant = 43,
+	ConstantComposite = 44,
+	Function = 54,
+	FunctionEnd = 56,
+	Variable = 59,
+	Load = 61,
+	Store = 62,
+	AccessChain = 65,
+	Decorate = 71,
+	MemberDecorate = 72,
+	CompositeConstruct = 80,
+	CompositeExtract = 81,
+	ConvertFToU = 109,
+	ConvertFToS = 110,
+	ConvertSToF = 111,
+	ConvertUToF = 112,
+	Bitcast = 124,
+	IAdd = 128,
+	FAdd = 129,
+	ISub = 130,
+	FSub = 131,
+	IMul = 132,
+	FMul = 133,
+	UDiv = 134,
+	SDiv = 135,
+	FDiv = 136,
+	ShiftRightLogical = 194,
+	ShiftLeftLogical = 196,
+	BitwiseOr = 197,
+	BitwiseAnd = 199,
+	Label = 248,
+	Return = 253,
+};
+
+namespace ZirEmitter
+{
+	void SPIRV::EmitOp(std::vector<uint32>& buf, uint16 opcode, std::initializer_list<uint32> operands)
+	{
+		buf.emplace_back(((uint32)(operands.size() + 1) << 16) | opcode);
+		buf.insert(buf.end(), operands);
+	}
+
+	#define SPV_OP(__buf, __op, ...) EmitOp(__buf, (uint16)SpvOp::__op, { __VA_ARGS__ })
+
+	bool SPIRV::Emit(ZpIR::ZpIRFunction* irFunction, std::vector<uint32>& output)
+	{
+		cemu_assert_debug(m_nextId == 1); // emitter instances are not reusable
+		// reject the whole function up front so that we never hand out a partial module
+		if (!CheckSupported(irFunction))
+			return false;
+		m_irFunction = irFunction;
+		ZpIR::ZpIRBasicBlock& basicBlock = *m_irFunction->m_entryBlocks[0];
+
+		uint32 typeVoid = AllocId();
+		uint32 typeMainFunc = AllocId();
+		SPV_OP(m_globals, TypeVoid, typeVoid);
+		SPV_OP(m_globals, TypeFunction, typeMainFunc, typeVoid);
+
+		uint32 mainFunc = AllocId();
+		SPV_OP(m_functionBody, Function, typeVoid, mainFunc, SpvConst::FUNCTION_CONTROL_NONE, typeMainFunc);
+		SPV_OP(m_functionBody, Label, AllocId());
+		// locations which the next stage reads but which are not written by this shader are set to zero
+		uint32 writtenLocationMask = 0;
+		for (ZpIR::IR::__InsBase* instruction = basicBlock.m_instructionFirst; instruction; instruction = instruction->next)
+		{
+			auto ins = ZpIR::IR::InsEXPORT::getIfForm(instruction);
+			if (!ins)
+				continue;
+			ZpIR::ShaderSubset::ShaderExportLocation loc(ins->exportSymbol);
+			uint16 parameterIndex;
+			if (!loc.IsOutputAttribute())
+				continue;
+			loc.GetOutputAttribute(parameterIndex);
+			sint32 location = GetOutputLocation(parameterIndex).location;
+			if (location >= 0)
+				writtenLocationMask |= (1u << location);
+		}
+		uint32 zeroedLocationMask = m_interface.zeroedOutputLocationMask & ~writtenLocationMask;
+		if (zeroedLocationMask)
+		{
+			uint32 typeVec4 = GetTypeId(ZpIR::DataType::F32, 4);
+			uint32 zeroF32 = GetConstantRaw(ZpIR::DataType::F32, 0);
+			uint32 zeroVec4 = AllocId();
+			SPV_OP(m_globals, ConstantComposite, typeVec4, zeroVec4, zeroF32, zeroF32, zeroF32, zeroF32);
+			for (sint32 location = 0; location < 32; location++)
+			{
+				if ((zeroedLocationMask & (1u << location)) != 0)
+					SPV_OP(m_functionBody, Store, GetOutputVariable(location, false, false), zeroVec4);
+			}
+		}
+		GenerateBasicBlockCode(basicBlock);
+		SPV_OP(m_functionBody, Return);
+		SPV_OP(m_functionBody, FunctionEnd);
+
+		// header
+		output.emplace_back(SpvConst::MAGIC_NUMBER);
+		output.emplace_back(SpvConst::VERSION_1_0);
+		output.emplace_back(0); // generator
+		output.emplace_back(m_nextId); // bound
+		output.emplace_back(0); // schema
+		SPV_OP(output, Capability, SpvConst::CAPABILITY_SHADER);
+		SPV_OP(output, MemoryModel, SpvConst::ADDRESSING_MODEL_LOGICAL, SpvConst::MEMORY_MODEL_GLSL450);
+		// OpEntryPoint Vertex %main "main" <interface variables>
+		output.emplace_back(((uint32)(5 + m_interfaceVariables.size()) << 16) | (uint16)SpvOp::EntryPoint);
+		output.emplace_back(SpvConst::EXECUTION_MODEL_VERTEX);
+		output.emplace_back(mainFunc);
+		output.emplace_back('m' | ('a' << 8) | ('i' << 16) | ('n' << 24));
+		output.emplace_back(0); // null terminator + padding
+		output.insert(output.end(), m_interfaceVariables.begin(), m_interfaceVariables.end());
+		// remaining sections
+		output.insert(output.end(), m_annotations.begin(), m_annotations.end());
+		output.insert(output.end(), m_globals.begin(), m_globals.end());
+		output.insert(output.end(), m_functionBody.begin(), m_functionBody.end());
+		return true;
+	}
+
+	bool SPIRV::SetUnsupported(std::string message)
+	{
+		if (m_errorMessage.empty())
+			m_errorMessage = std::move(message);
+		return false;
+	}
+
+	bool SPIRV::CheckSupported(ZpIR::ZpIRFunction* irFunction)
+	{
+		if (irFunction->m_entryBlocks.size() != 1 || irFunction->m_basicBlocks.size() != 1)
+			return SetUnsupported("only functions with a single basic block are supported");
+		ZpIR::ZpIRBasicBlock& basicBlock = *irFunction->m_entryBlocks[0];
+		for (auto& regDef : basicBlock.m_regs)
+		{
+			if (regDef.elementCount != 1)
+				return SetUnsupported("vector registers are not supported");
+			if (regDef.type != ZpIR::DataType::U32 && regDef.type != ZpIR::DataType::S32 && regDef.type != ZpIR::DataType::F32)
+				return SetUnsupported(fmt::format("register type {}", (uint32)regDef.type));
+		}
+		for (auto& constDef : basicBlock.m_consts)
+		{
+			if (constDef.type != ZpIR::DataType::U32 && constDef.type != ZpIR::DataType::S32 && constDef.type != ZpIR::DataType::F32)
+				return SetUnsupported(fmt::format("constant type {}", (uint32)constDef.type));
+		}
+		for (uint32 i = 0; i < (uint32)m_interface.outputLocation.size(); i++)
+		{
+			if (m_interface.outputLocation[i].location >= 32)
+				return SetUnsupported(fmt::format("output location {} out of range", m_interface.outputLocation[i].location));
+		}
+		std::vector<bool> isRegWritten(basicBlock.m_regs.size());
+		uint32 highestUniformArrayIndex = 0;
+		bool hasUniformAccess = false;
+		for (ZpIR::IR::__InsBase* instruction = basicBlock.m_instructionFirst; instruction; instruction = instruction->next)
+		{
+			if (!CheckInstruction(basicBlock, instruction, isRegWritten))
+				return false;
+			auto ins = ZpIR::IR::InsIMPORT::getIfForm(instruction);
+			if (!ins)
+				continue;
+			ZpIR::ShaderSubset::ShaderImportLocation loc(ins->importSymbol);
+			if (!loc.IsUniformRegister())
+				continue;
+			uint16 index;
+			loc.GetUniformRegister(index);
+			highestUniformArrayIndex = std::max<uint32>(highestUniformArrayIndex, (uint32)GetUniformArrayIndex(index / 4));
+			hasUniformAccess = true;
+		}
+		// the size of the uniform array is part of its type, so it needs to be known before the first uniform access is emitted
+		if (hasUniformAccess)
+		{
+			if (m_interface.uniformArraySize == 0)
+				m_uniformVec4Count = highestUniformArrayIndex + 1;
+			else if (highestUniformArrayIndex >= m_interface.uniformArraySize)
+				return SetUnsupported(fmt::format("uniform index {} exceeds uniform array size {}", highestUniformArrayIndex, m_interface.uniformArraySize));
+			else
+				m_uniformVec4Count = m_interface.uniformArraySize;
+		}
+		return true;
+	}
+
+	bool SPIRV::CheckInstruction(ZpIR::ZpIRBasicBlock& basicBlock, ZpIR::IR::__InsBase* instruction, std::vector<bool>& isRegWritten)
+	{
+		auto checkRead = [&](ZpIR::IRReg r) -> bool
+		{
+			if (ZpIR::isConstVar(r))
+				return basicBlock.getConstant(r) != nullptr || SetUnsupported("invalid constant");
+			if (ZpIR::getRegIndex(r) >= isRegWritten.size() || !isRegWritten[ZpIR::getRegIndex(r)])
+				return SetUnsupported(fmt::format("register {} read before write", ZpIR::getRegIndex(r)));
+			return true;
+		};
+		auto checkWrite = [&](ZpIR::IRReg r) -> bool
+		{
+			if (!ZpIR::isRegVar(r) || ZpIR::getRegIndex(r) >= isRegWritten.size())
+				return SetUnsupported("invalid destination register");
+			if (isRegWritten[ZpIR::getRegIndex(r)])
+				return SetUnsupported(fmt::format("register {} written more than once", ZpIR::getRegIndex(r)));
+			isRegWritten[ZpIR::getRegIndex(r)] = true;
+			return true;
+		};
+
+		if (auto ins = ZpIR::IR::InsRR::getIfForm(instruction))
+		{
+			if (!checkRead(ins->rB))
+				return false;
+			auto srcType = basicBlock.getRegType(ins->rB);
+			auto dstType = basicBlock.getRegType(ins->rA);
+			switch (ins->opcode)
+			{
+			case ZpIR::IR::OpCode::MOV:
+				if (srcType != dstType)
+					return SetUnsupported("MOV with different source and destination type");
+				break;
+			case ZpIR::IR::OpCode::BITCAST:
+				if (srcType == dstType)
+					return SetUnsupported("BITCAST to the same type");
+				break;
+			case ZpIR::IR::OpCode::SWAP_ENDIAN:
+				if (srcType != ZpIR::DataType::U32 || dstType != ZpIR::DataType::U32)
+					return SetUnsupported("SWAP_ENDIAN on type other than U32");
+				break;
+			case ZpIR::IR::OpCode::CONVERT_FLOAT_TO_INT:
+				if (srcType != ZpIR::DataType::F32 || dstType == ZpIR::DataType::F32)
+					return SetUnsupported("CONVERT_FLOAT_TO_INT with invalid types");
+				break;
+			case ZpIR::IR::OpCode::CONVERT_INT_TO_FLOAT:
+				if (srcType == ZpIR::DataType::F32 || dstType != ZpIR::DataType::F32)
+					return SetUnsupported("CONVERT_INT_TO_FLOAT with invalid types");
+				break;
+			default:
+				return SetUnsupported(fmt::format("RR opcode {}", (uint32)ins->opcode));
+			}
+			return checkWrite(ins->rA);
+		}
+		else if (auto ins = ZpIR::IR::InsRRR::getIfForm(instruction))
+		{
+			switch (ins->opcode)
+			{
+			case ZpIR::IR::OpCode::ADD:
+			case ZpIR::IR::OpCode::SUB:
+			case ZpIR::IR::OpCode::MUL:
+			case ZpIR::IR::OpCode::DIV:
+				break;
+			default:
+				return SetUnsupported(fmt::format("RRR opcode {}", (uint32)ins->opcode));
+			}
+			if (!checkRead(ins->rB) || !checkRead(ins->rC))
+				return false;
+			auto dstType = basicBlock.getRegType(ins->rA);
+			if (basicBlock.getRegType(ins->rB) != dstType || basicBlock.getRegType(ins->rC) != dstType)
+				return SetUnsupported("RRR operation with mixed types");
+			return checkWrite(ins->rA);
+		}
+		else if (auto ins = ZpIR::IR::InsIMPORT::getIfForm(instruction))
+		{
+			if (ins->count != 1)
+				return SetUnsupported("IMPORT of multiple registers");
+			ZpIR::ShaderSubset::ShaderImportLocation loc(ins->importSymbol);
+			if (loc.IsUniformRegister())
+			{
+				uint16 index;
+				loc.GetUniformRegister(index);
+				if (GetUniformArrayIndex(index / 4) < 0)
+					return SetUnsupported(fmt::format("uniform register {} is not mapped", index / 4));
+			}
+			else if (loc.IsVertexAttribute())
+			{
+				uint16 attributeIndex;
+				uint16 channelIndex;
+				loc.GetVertexAttribute(attributeIndex, channelIndex);
+				if (channelIndex >= 4)
+					return SetUnsupported("attribute channel out of range");
+				if (GetAttributeLocation(attributeIndex) < 0)
+					return SetUnsupported(fmt::format("attribute {} is not mapped", attributeIndex));
+			}
+			else
+				return SetUnsupported("IMPORT from unknown location");
+			return checkWrite(ins->regArray[0]);
+		}
+		else if (auto ins = ZpIR::IR::InsEXPORT::getIfForm(instruction))
+		{
+			ZpIR::ShaderSubset::ShaderExportLocation loc(ins->exportSymbol);
+			if (!loc.IsPosition() && !loc.IsOutputAttribute())
+				return SetUnsupported("EXPORT to unknown location");
+			if (ins->count != 4)
+				return SetUnsupported("EXPORT with channel count other than 4");
+			for (uint16 i = 0; i < ins->count; i++)
+			{
+				if (!checkRead(ins->regArray[i]))
+					return false;
+			}
+			return true;
+		}
+		return SetUnsupported("unknown instruction form");
+	}
+
+	void SPIRV::GenerateBasicBlockCode(ZpIR::ZpIRBasicBlock& basicBlock)
+	{
+		// init context
+		m_blockContext.currentBasicBlock = &basicBlock;
+		m_blockContext.regIds.clear();
+		m_blockContext.regIds.resize(basicBlock.m_regs.size());
+		m_blockContext.loadedAttributes.clear();
+
+		ZpIR::IR::__InsBase* instruction = basicBlock.m_instructionFirst;
+		while (instruction)
+		{
+			if (auto ins = ZpIR::IR::InsRR::getIfForm(instruction))
+				HandleInstruction(ins);
+			else if (auto ins = ZpIR::IR::InsRRR::getIfForm(instruction))
+				HandleInstruction(ins);
+			else if (auto ins = ZpIR::IR::InsIMPORT::getIfForm(instruction))
+				HandleInstruction(ins);
+			else if (auto ins = ZpIR::IR::InsEXPORT::getIfForm(instruction))
+				HandleInstruction(ins);
+			else
+			{
+				cemu_assert_debug(false); // rejected by CheckSupported()
+			}
+
+			instruction = instruction->next;
+		}
+	}
+
+	// the handlers below only see IR which passed CheckSupported()
+
+	void SPIRV::HandleInstruction(ZpIR::IR::InsRR* ins)
+	{
+		auto srcType = m_blockContext.currentBasicBlock->getRegType(ins->rB);
+		auto dstType = m_blockContext.currentBasicBlock->getRegType(ins->rA);
+		uint32 srcId = GetRegId(ins->rB);
+		uint32 dstTypeId = GetTypeId(dstType);
+
+		switch (ins->opcode)
+		{
+		case ZpIR::IR::OpCode::MOV:
+		{
+			// values are immutable, the destination register can simply refer to the source id
+			SetRegId(ins->rA, srcId);
+			return;
+		}
+		case ZpIR::IR::OpCode::BITCAST:
+		{
+			uint32 resultId = AllocId();
+			SPV_OP(m_functionBody, Bitcast, dstTypeId, resultId, srcId);
+			SetRegId(ins->rA, resultId);
+			return;
+		}
+		case ZpIR::IR::OpCode::SWAP_ENDIAN:
+		{
+			// (v>>24)|((v>>8)&0xFF00)|((v<<8)&0xFF0000)|(v<<24)
+			uint32 shift8 = GetConstantU32(8);
+			uint32 shift24 = GetConstantU32(24);
+			uint32 t0 = AllocId(), t1 = AllocId(), t2 = AllocId(), t3 = AllocId();
+			uint32 t4 = AllocId(), t5 = AllocId(), t6 = AllocId(), t7 = AllocId(), t8 = AllocId();
+			SPV_OP(m_functionBody, ShiftRightLogical, dstTypeId, t0, srcId, shift24);
+			SPV_OP(m_functionBody, ShiftRightLogical, dstTypeId, t1, srcId, shift8);
+			SPV_OP(m_functionBody, BitwiseAnd, dstTypeId, t2, t1, GetConstantU32(0xFF00));
+			SPV_OP(m_functionBody, ShiftLeftLogical, dstTypeId, t3, srcId, shift8);
+			SPV_OP(m_functionBody, BitwiseAnd, dstTypeId, t4, t3, GetConstantU32(0xFF0000));
+			SPV_OP(m_functionBody, ShiftLeftLogical, dstTypeId, t5, srcId, shift24);
+			SPV_OP(m_functionBody, BitwiseOr, dstTypeId, t6, t0, t2);
+			SPV_OP(m_functionBody, BitwiseOr, dstTypeId, t7, t6, t4);
+			SPV_OP(m_functionBody, BitwiseOr, dstTypeId, t8, t7, t5);
+			SetRegId(ins->rA, t8);
+			return;
+		}
+		case ZpIR::IR::OpCode::CONVERT_FLOAT_TO_INT:
+		{
+			uint32 resultId = AllocId();
+			if (dstType == ZpIR::DataType::U32)
+				SPV_OP(m_functionBody, ConvertFToU, dstTypeId, resultId, srcId);
+			else
+				SPV_OP(m_functionBody, ConvertFToS, dstTypeId, resultId, srcId);
+			SetRegId(ins->rA, resultId);
+			return;
+		}
+		case ZpIR::IR::OpCode::CONVERT_INT_TO_FLOAT:
+		{
+			uint32 resultId = AllocId();
+			if (srcType == ZpIR::DataType::U32)
+				SPV_OP(m_functionBody, ConvertUToF, dstTypeId, resultId, srcId);
+			else
+				SPV_OP(m_functionBody, ConvertSToF, dstTypeId, resultId, srcId);
+			SetRegId(ins->rA, resultId);
+			return;
+		}
+		default:
+			cemu_assert_debug(false);
+		}
+	}
+
+	void SPIRV::HandleInstruction(ZpIR::IR::InsRRR* ins)
+	{
+		auto dstType = m_blockContext.currentBasicBlock->getRegType(ins->rA);
+		const bool isFloat = dstType == ZpIR::DataType::F32;
+		SpvOp op;
+		switch (ins->opcode)
+		{
+		case ZpIR::IR::OpCode::ADD:
+			op = isFloat ? SpvOp::FAdd : SpvOp::IAdd;
+			break;
+		case ZpIR::IR::OpCode::SUB:
+			op = isFloat ? SpvOp::FSub : SpvOp::ISub;
+			break;
+		case ZpIR::IR::OpCode::MUL:
+			op = isFloat ? SpvOp::FMul : SpvOp::IMul;
+			break;
+		case ZpIR::IR::OpCode::DIV:
+			if (isFloat)
+				op = SpvOp::FDiv;
+			else
+				op = dstType == ZpIR::DataType::S32 ? SpvOp::SDiv : SpvOp::UDiv;
+			break;
+		default:
+			cemu_assert_debug(false);
+			return;
+		}
+		uint32 resultId = AllocId();
+		EmitOp(m_functionBody, (uint16)op, { GetTypeId(dstType), resultId, GetRegId(ins->rB), GetRegId(ins->rC) });
+		SetRegId(ins->rA, resultId);
+	}
+
+	void SPIRV::HandleInstruction(ZpIR::IR::InsIMPORT* ins)
+	{
+		ZpIR::ShaderSubset::ShaderImportLocation loc(ins->importSymbol);
+		auto dstType = m_blockContext.currentBasicBlock->getRegType(ins->regArray[0]);
+		uint32 typeU32 = GetTypeId(ZpIR::DataType::U32);
+		uint32 valueId = AllocId();
+		if (loc.IsUniformRegister())
+		{
+			uint16 index;
+			loc.GetUniformRegister(index);
+			// uniforms are stored as uvec4 array and reinterpreted to the type of the register
+			uint32 ptrId = AllocId();
+			uint32 arrayIndex = (uint32)GetUniformArrayIndex(index / 4);
+			SPV_OP(m_functionBody, AccessChain, GetPointerTypeId(SpvConst::STORAGE_CLASS_UNIFORM, typeU32), ptrId, GetUniformBlockVariable(), GetConstantU32(0), GetConstantU32(arrayIndex), GetConstantU32(index & 3));
+			SPV_OP(m_functionBody, Load, typeU32, valueId, ptrId);
+		}
+		else
+		{
+			uint16 attributeIndex;
+			uint16 channelIndex;
+			loc.GetVertexAttribute(attributeIndex, channelIndex);
+			// load each attribute only once per block
+			auto it = m_blockContext.loadedAttributes.find(attributeIndex);
+			uint32 vectorId;
+			if (it != m_blockContext.loadedAttributes.end())
+				vectorId = it->second;
+			else
+			{
+				vectorId = AllocId();
+				SPV_OP(m_functionBody, Load, GetTypeId(ZpIR::DataType::U32, 4), vectorId, GetAttributeVariable(attributeIndex));
+				m_blockContext.loadedAttributes.emplace(attributeIndex, vectorId);
+			}
+			SPV_OP(m_functionBody, CompositeExtract, typeU32, valueId, vectorId, (uint32)channelIndex);
+		}
+		if (dstType != ZpIR::DataType::U32)
+		{
+			uint32 castId = AllocId();
+			SPV_OP(m_functionBody, Bitcast, GetTypeId(dstType), castId, valueId);
+			valueId = castId;
+		}
+		SetRegId(ins->regArray[0], valueId);
+	}
+
+	void SPIRV::HandleInstruction(ZpIR::IR::InsEXPORT* ins)
+	{
+		ZpIR::ShaderSubset::ShaderExportLocation loc(ins->exportSymbol);
+		if (loc.IsPosition())
+		{
+			// todo - support for output mask (e.g. xyzw, x_zw) ?
+			SPV_OP(m_functionBody, Store, GetPositionVariable(), EmitVec4(ins, true));
+		}
+		else
+		{
+			uint16 parameterIndex;
+			loc.GetOutputAttribute(parameterIndex);
+			auto outputLocation = GetOutputLocation(parameterIndex);
+			if (outputLocation.location < 0)
+				return; // not consumed by the next stage
+			SPV_OP(m_functionBody, Store, GetOutputVariable(outputLocation.location, outputLocation.isFlat, outputLocation.isNoPerspective), EmitVec4(ins, false));
+		}
+	}
+
+	// construct a vec4 from the exported registers. Integer registers are converted by value, same as vec4() in the GLSL emitter
+	uint32 SPIRV::EmitVec4(ZpIR::IR::InsEXPORT* ins, bool isPosition)
+	{
+		uint32 typeF32 = GetTypeId(ZpIR::DataType::F32);
+		uint32 elementIds[4];
+		for (uint32 i = 0; i < 4; i++)
+		{
+			ZpIR::IRReg reg = ins->regArray[i];
+			auto regType = m_blockContext.currentBasicBlock->getRegType(reg);
+			elementIds[i] = GetRegId(reg);
+			if (regType == ZpIR::DataType::F32)
+				continue;
+			uint32 convertedId = AllocId();
+			if (regType == ZpIR::DataType::U32)
+				SPV_OP(m_functionBody, ConvertUToF, typeF32, convertedId, elementIds[i]);
+			else
+				SPV_OP(m_functionBody, ConvertSToF, typeF32, convertedId, elementIds[i]);
+			elementIds[i] = convertedId;
+		}
+		if (isPosition && m_interface.remapDepthToVulkan)
+		{
+			// z = (z + w) / 2.0
+			uint32 sumId = AllocId();
+			uint32 depthId = AllocId();
+			SPV_OP(m_functionBody, FAdd, typeF32, sumId, elementIds[2], elementIds[3]);
+			SPV_OP(m_functionBody, FDiv, typeF32, depthId, sumId, GetConstantRaw(ZpIR::DataType::F32, 0x40000000));
+			elementIds[2] = depthId;
+		}
+		uint32 resultId = AllocId();
+		SPV_OP(m_functionBody, CompositeConstruct, GetTypeId(ZpIR::DataType::F32, 4), resultId, elementIds[0], elementIds[1], elementIds[2], elementIds[3]);
+		return resultId;
+	}
+
+	sint32 SPIRV::GetUniformArrayIndex(uint16 uniformRegister) const
+	{
+		if (m_interface.uniformRemap.empty())
+			return uniformRegister;
+		if (uniformRegister >= m_interface.uniformRemap.size())
+			return -1;
+		return m_interface.uniformRemap[uniformRegister];
+	}
+
+	sint32 SPIRV::GetAttributeLocation(uint16 attributeIndex) const
+	{
+		if (m_interface.attributeLocation.empty())
+			return attributeIndex;
+		if (attributeIndex >= m_interface.attributeLocation.size())
+			return -1;
+		return m_interface.attributeLocation[attributeIndex];
+	}
+
+	SPIRV::VertexShaderInterface::OutputLocation SPIRV::GetOutputLocation(uint16 parameterIndex) const
+	{
+		if (m_interface.outputLocation.empty())
+			return { (sint32)parameterIndex };
+		if (parameterIndex >= m_interface.outputLocation.size())
+			return {};
+		return m_interface.outputLocation[parameterIndex];
+	}
+
+	uint32 SPIRV::GetRegId(ZpIR::IRReg irReg)
+	{
+		if (ZpIR::isConstVar(irReg))
+		{
+			ZpIR::IRRegConstDef* constDef = m_blockContext.currentBasicBlock->getConstant(irReg);
+			return GetConstantRaw(constDef->type, constDef->value_u32);
+		}
+		uint32 id = m_blockContext.regIds[ZpIR::getRegIndex(irReg)];
+		cemu_assert_debug(id != 0); // read before write
+		return id;
+	}
+
+	void SPIRV::SetRegId(ZpIR::IRReg irReg, uint32 id)
+	{
+		uint32& entry = m_blockContext.regIds[ZpIR::getRegIndex(irReg)];
+		cemu_assert_debug(entry == 0); // registers are expected to be written only once
+		entry = id;
+	}
+
+	uint32 SPIRV::GetTypeId(ZpIR::DataType dataType, uint32 elementCount)
+	{
+		uint32 key = (uint32)dataType | (elementCount << 8);
+		auto it = m_typeIds.find(key);
+		if (it != m_typeIds.end())
+			return it->second;
+		uint32 typeId;
+		if (elementCount > 1)
+		{
+			uint32 scalarTypeId = GetTypeId(dataType);
+			typeId = AllocId();
+			SPV_OP(m_globals, TypeVector, typeId, scalarTypeId, elementCount);
+		}
+		else
+		{
+			typeId = AllocId();
+			if (dataType == ZpIR::DataType::U32)
+				SPV_OP(m_globals, TypeInt, typeId, 32, 0);
+			else if (dataType == ZpIR::DataType::S32)
+				SPV_OP(m_globals, TypeInt, typeId, 32, 1);
+			else
+			{
+				cemu_assert_debug(dataType == ZpIR::DataType::F32);
+				SPV_OP(m_globals, TypeFloat, typeId, 32);
+			}
+		}
+		m_typeIds.emplace(key, typeId);
+		return typeId;
+	}
+
+	uint32 SPIRV::GetPointerTypeId(uint32 storageClass, uint32 typeId)
+	{
+		uint64 key = (uint64)storageClass | ((uint64)typeId << 32);
+		auto it = m_pointerTypeIds.find(key);
+		if (it != m_pointerTypeIds.end())
+			return it->second;
+		uint32 ptrTypeId = AllocId();
+		SPV_OP(m_globals, TypePointer, ptrTypeId, storageClass, typeId);
+		m_pointerTypeIds.emplace(key, ptrTypeId);
+		return ptrTypeId;
+	}
+
+	uint32 SPIRV::GetConstantU32(uint32 value)
+	{
+		return GetConstantRaw(ZpIR::DataType::U32, value);
+	}
+
+	uint32 SPIRV::GetConstantRaw(ZpIR::DataType dataType, uint32 rawValue)
+	{
+		uint32 typeId = GetTypeId(dataType);
+		uint64 key = (uint64)typeId | ((uint64)rawValue << 32);
+		auto it = m_constantIds.find(key);
+		if (it != m_constantIds.end())
+			return it->second;
+		uint32 constId = AllocId();
+		SPV_OP(m_globals, Constant, typeId, constId, rawValue);
+		m_constantIds.emplace(key, constId);
+		return constId;
+	}
+
+	// layout(set = descriptorSet, binding = uniformBinding, std140) uniform ufBlock { layout(offset = uniformArrayOffset) uvec4 uf_remappedVS[N]; };
+	uint32 SPIRV::GetUniformBlockVariable()
+	{
+		if (m_uniformBlockVariable)
+			return m_uniformBlockVariable;
+		cemu_assert_debug(m_uniformVec4Count > 0);
+		uint32 typeArray = AllocId();
+		uint32 typeBlock = AllocId();
+		SPV_OP(m_globals, TypeArray, typeArray, GetTypeId(ZpIR::DataType::U32, 4), GetConstantU32(m_uniformVec4Count));
+		SPV_OP(m_globals, TypeStruct, typeBlock, typeArray);
+		m_uniformBlockVariable = AllocId();
+		SPV_OP(m_globals, Variable, GetPointerTypeId(SpvConst::STORAGE_CLASS_UNIFORM, typeBlock), m_uniformBlockVariable, SpvConst::STORAGE_CLASS_UNIFORM);
+		SPV_OP(m_annotations, Decorate, typeArray, SpvConst::DECORATION_ARRAY_STRIDE, 16);
+		SPV_OP(m_annotations, Decorate, typeBlock, SpvConst::DECORATION_BLOCK);
+		SPV_OP(m_annotations, MemberDecorate, typeBlock, 0, SpvConst::DECORATION_OFFSET, m_interface.uniformArrayOffset);
+		SPV_OP(m_annotations, Decorate, m_uniformBlockVariable, SpvConst::DECORATION_DESCRIPTOR_SET, m_interface.descriptorSet);
+		SPV_OP(m_annotations, Decorate, m_uniformBlockVariable, SpvConst::DECORATION_BINDING, m_interface.uniformBinding);
+		return m_uniformBlockVariable;
+	}
+
+	// layout(location = N) in uvec4 attrDataSem{attributeIndex};
+	uint32 SPIRV::GetAttributeVariable(uint16 attributeIndex)
+	{
+		auto it = m_attributeVariables.find(attributeIndex);
+		if (it != m_attributeVariables.end())
+			return it->second;
+		uint32 variableId = AllocId();
+		SPV_OP(m_globals, Variable, GetPointerTypeId(SpvConst::STORAGE_CLASS_INPUT, GetTypeId(ZpIR::DataType::U32, 4)), variableId, SpvConst::STORAGE_CLASS_INPUT);
+		SPV_OP(m_annotations, Decorate, variableId, SpvConst::DECORATION_LOCATION, (uint32)GetAttributeLocation(attributeIndex));
+		m_attributeVariables.emplace(attributeIndex, variableId);
+		m_interfaceVariables.emplace_back(variableId);
+		return variableId;
+	}
+
+	uint32 SPIRV::GetPositionVariable()
+	{
+		if (m_positionVariable)
+			return m_positionVariable;
+		m_positionVariable = AllocId();
+		SPV_OP(m_globals, Variable, GetPointerTypeId(SpvConst::STORAGE_CLASS_OUTPUT, GetTypeId(ZpIR::DataType::F32, 4)), m_positionVariable, SpvConst::STORAGE_CLASS_OUTPUT);
+		SPV_OP(m_annotations, Decorate, m_positionVariable, SpvConst::DECORATION_BUILTIN, SpvConst::BUILTIN_POSITION);
+		m_interfaceVariables.emplace_back(m_positionVariable);
+		return m_positionVariable;
+	}
+
+	// layout(location = N) [flat] [noperspective] out vec4 passParameterSem{N};
+	uint32 SPIRV::GetOutputVariable(sint32 location, bool isFlat, bool isNoPerspective)
+	{
+		auto it = m_outputVariables.find(location);
+		if (it != m_outputVariables.end())
+			return it->second;
+		uint32 variableId = AllocId();
+		SPV_OP(m_globals, Variable, GetPointerTypeId(SpvConst::STORAGE_CLASS_OUTPUT, GetTypeId(ZpIR::DataType::F32, 4)), variableId, SpvConst::STORAGE_CLASS_OUTPUT);
+		SPV_OP(m_annotations, Decorate, variableId, SpvConst::DECORATION_LOCATION, (uint32)location);
+		if (isFlat)
+			SPV_OP(m_annotations, Decorate, variableId, SpvConst::DECORATION_FLAT);
+		if (isNoPerspective)
+			SPV_OP(m_annotations, Decorate, variableId, SpvConst::DECORATION_NO_PERSPECTIVE);
+		m_outputVariables.emplace(location, variableId);
+		m_interfaceVariables.emplace_back(variableId);
+		return variableId;
+	}
+
+	#undef SPV_OP
+}
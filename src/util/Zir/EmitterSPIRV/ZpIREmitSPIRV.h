@@ -0,0 +1,108 @@
+#pragma once
+#include "util/Zir/Core/IR.h"
+
+namespace ZirEmitter
+{
+	// generates a SPIR-V module directly from the IR, without going through GLSL and glslang
+	// IR registers are SSA values within a basic block and map 1:1 to SPIR-V result ids, so no register allocation pass is required
+	// only single basic block vertex shaders and a subset of the opcodes are supported. Anything else is rejected before any code is emitted
+	class SPIRV
+	{
+	public:
+		// describes where the IR inputs and outputs live in the shader interface
+		// empty tables map everything 1:1 (uniform register N -> uf_remappedVS[N], attribute N -> location N, parameter N -> location N)
+		struct VertexShaderInterface
+		{
+			struct OutputLocation
+			{
+				sint32 location{ -1 }; // -1 if the parameter is not consumed by the next stage. Exports to it are dropped
+				bool isFlat{};
+				bool isNoPerspective{};
+			};
+
+			uint32 descriptorSet{ 0 };
+			uint32 uniformBinding{ 0 };
+			uint32 uniformArrayOffset{ 0 }; // byte offset of uf_remappedVS within the uniform block
+			uint32 uniformArraySize{ 0 }; // in uvec4. If zero the size is derived from the highest accessed uniform register
+			std::vector<sint32> uniformRemap; // uniform register (uvec4 index) -> index in uf_remappedVS, -1 if not available
+			std::vector<sint32> attributeLocation; // attribute semantic id -> input location, -1 if not available
+			std::vector<OutputLocation> outputLocation; // exported parameter index -> output location
+			uint32 zeroedOutputLocationMask{ 0 }; // output locations which are initialized to vec4(0.0) because the next stage reads them
+			bool remapDepthToVulkan{ false }; // gl_Position.z = (gl_Position.z + gl_Position.w) / 2.0
+		};
+
+		SPIRV() = default;
+		SPIRV(const VertexShaderInterface& shaderInterface) : m_interface(shaderInterface) {};
+
+		// emit vertex shader module and append the SPIR-V words to output. An emitter instance can only be used once
+		// returns false and leaves output untouched if the IR uses anything that is not supported, see GetErrorMessage()
+		bool Emit(ZpIR::ZpIRFunction* irFunction, std::vector<uint32>& output);
+
+		const std::string& GetErrorMessage() const { return m_errorMessage; }
+
+	private:
+		bool CheckSupported(ZpIR::ZpIRFunction* irFunction);
+		bool CheckInstruction(ZpIR::ZpIRBasicBlock& basicBlock, ZpIR::IR::__InsBase* instruction, std::vector<bool>& isRegWritten);
+		bool SetUnsupported(std::string message);
+
+		void GenerateBasicBlockCode(ZpIR::ZpIRBasicBlock& basicBlock);
+
+		void HandleInstruction(ZpIR::IR::InsRR* ins);
+		void HandleInstruction(ZpIR::IR::InsRRR* ins);
+		void HandleInstruction(ZpIR::IR::InsIMPORT* ins);
+		void HandleInstruction(ZpIR::IR::InsEXPORT* ins);
+
+		// interface lookups, return -1 if the table has no entry
+		sint32 GetUniformArrayIndex(uint16 uniformRegister) const;
+		sint32 GetAttributeLocation(uint16 attributeIndex) const;
+		VertexShaderInterface::OutputLocation GetOutputLocation(uint16 parameterIndex) const;
+
+		// result ids
+		uint32 AllocId() { return m_nextId++; };
+		uint32 GetRegId(ZpIR::IRReg irReg);
+		void SetRegId(ZpIR::IRReg irReg, uint32 id);
+
+		// types, constants and global variables. Created on first use
+		uint32 GetTypeId(ZpIR::DataType dataType, uint32 elementCount = 1);
+		uint32 GetPointerTypeId(uint32 storageClass, uint32 typeId);
+		uint32 GetConstantU32(uint32 value);
+		uint32 GetConstantRaw(ZpIR::DataType dataType, uint32 rawValue);
+		uint32 GetUniformBlockVariable();
+		uint32 GetAttributeVariable(uint16 attributeIndex);
+		uint32 GetPositionVariable();
+		uint32 GetOutputVariable(sint32 location, bool isFlat, bool isNoPerspective);
+
+		uint32 EmitVec4(ZpIR::IR::InsEXPORT* ins, bool isPosition);
+
+		static void EmitOp(std::vector<uint32>& buf, uint16 opcode, std::initializer_list<uint32> operands);
+
+	private:
+		ZpIR::ZpIRFunction* m_irFunction{};
+		VertexShaderInterface m_interface;
+		std::string m_errorMessage;
+		uint32 m_nextId{ 1 };
+
+		// module sections, concatenated in the order required by the SPIR-V spec once the function is complete
+		std::vector<uint32> m_annotations;
+		std::vector<uint32> m_globals; // types, constants and global variables
+		std::vector<uint32> m_functionBody;
+
+		std::vector<uint32> m_interfaceVariables; // input/output variables listed by OpEntryPoint
+		std::unordered_map<uint32, uint32> m_typeIds; // key: DataType | (elementCount << 8)
+		std::unordered_map<uint64, uint32> m_pointerTypeIds; // key: storageClass | (typeId << 32)
+		std::unordered_map<uint64, uint32> m_constantIds; // key: typeId | (rawValue << 32)
+		std::unordered_map<uint16, uint32> m_attributeVariables;
+		std::unordered_map<sint32, uint32> m_outputVariables; // key: location
+		uint32 m_uniformBlockVariable{};
+		uint32 m_uniformVec4Count{};
+		uint32 m_positionVariable{};
+
+		struct
+		{
+			ZpIR::ZpIRBasicBlock* currentBasicBlock{ nullptr };
+			std::vector<uint32> regIds;
+			std::unordered_map<uint16, uint32> loadedAttributes; // attribute index -> id of the loaded uvec4
+		}m_blockContext;
+	};
+
+}
@@ -0,0 +1,201 @@
+#pragma once
+
+// augmented interval tree with an implicit layout (as in cgranges)
+// intervals are stored in an array sorted by start which doubles as a complete binary search tree, every node additionally stores the max end of its subtree
+// rebuilding the augmentation is O(n), so modifications are batched:
+// - new intervals are collected in a small unsorted list which queries scan linearly. It is merged into the tree once it grows past ~sqrt(n) entries
+// - removed intervals are only flagged, the stale subtree max ends are still a valid upper bound. They are dropped on the next merge
+// overlap queries are O(log n + sqrt(n) + k). Intervals with the same start are visited in insertion order
+template<typename TAddr, typename TData>
+class IntervalTree
+{
+public:
+	struct Interval
+	{
+		TAddr start; // inclusive
+		TAddr end; // exclusive
+		TData data;
+	private:
+		friend class IntervalTree;
+		TAddr subtreeMaxEnd;
+		bool isRemoved;
+	};
+
+	IntervalTree() = default;
+
+	void Insert(TAddr start, TAddr end, TData data)
+	{
+		Interval interval;
+		interval.start = start;
+		interval.end = end;
+		interval.data = data;
+		interval.subtreeMaxEnd = end;
+		interval.isRemoved = false;
+		m_pendingIntervals.emplace_back(interval);
+		if (m_pendingIntervals.size() > GetPendingLimit())
+			Rebuild();
+	}
+
+	template<typename TPred>
+	size_t RemoveIf(TPred pred)
+	{
+		size_t removedCount = 0;
+		for (auto& interval : m_intervals)
+		{
+			if (!interval.isRemoved && pred(std::as_const(interval)))
+			{
+				interval.isRemoved = true;
+				removedCount++;
+			}
+		}
+		m_removedCount += removedCount;
+		removedCount += std::erase_if(m_pendingIntervals, [&](const Interval& interval) { return pred(interval); });
+		// flagged intervals still cost time during queries
+		if (m_removedCount > m_intervals.size() / 2)
+			Rebuild();
+		return removedCount;
+	}
+
+	// calls f(const Interval&) for every interval which overlaps with [start, end)
+	// the tree must not be modified from within the callback
+	template<typename TFunc>
+	void ForEachOverlap(TAddr start, TAddr end, TFunc f) const
+	{
+		if (start >= end)
+			return;
+		if (!m_intervals.empty())
+		{
+			struct StackEntry
+			{
+				sint64 index;
+				sint32 level;
+				bool isLeftVisited;
+			};
+			const sint64 count = (sint64)m_intervals.size();
+			StackEntry stack[64];
+			sint32 stackSize = 0;
+			stack[stackSize++] = {((sint64)1 << m_rootLevel) - 1, m_rootLevel, false};
+			while (stackSize > 0)
+			{
+				StackEntry node = stack[--stackSize];
+				if (node.level <= 3)
+				{
+					// small subtree, scanning it is faster than descending further
+					sint64 first = node.index >> node.level << node.level;
+					sint64 last = std::min(first + ((sint64)1 << (node.level + 1)) - 1, count);
+					for (sint64 i = first; i < last && m_intervals[i].start < end; i++)
+					{
+						if (m_intervals[i].end > start && !m_intervals[i].isRemoved)
+							f(m_intervals[i]);
+					}
+				}
+				else if (!node.isLeftVisited)
+				{
+					// the left child index can be out of range, its subtree may still contain valid nodes
+					sint64 leftIndex = node.index - ((sint64)1 << (node.level - 1));
+					stack[stackSize++] = {node.index, node.level, true};
+					if (leftIndex >= count || m_intervals[leftIndex].subtreeMaxEnd > start)
+						stack[stackSize++] = {leftIndex, node.level - 1, false};
+				}
+				else if (node.index < count && m_intervals[node.index].start < end)
+				{
+					if (m_intervals[node.index].end > start && !m_intervals[node.index].isRemoved)
+						f(m_intervals[node.index]);
+					stack[stackSize++] = {node.index + ((sint64)1 << (node.level - 1)), node.level - 1, false};
+				}
+			}
+		}
+		// pending intervals are newer than all intervals in the tree
+		for (auto& interval : m_pendingIntervals)
+		{
+			if (interval.start < end && interval.end > start)
+				f(interval);
+		}
+	}
+
+	// calls f(const Interval&) for every interval which starts exactly at addr, in insertion order
+	template<typename TFunc>
+	void ForEachStartingAt(TAddr addr, TFunc f) const
+	{
+		auto range = std::equal_range(m_intervals.begin(), m_intervals.end(), addr, IntervalStartCompare{});
+		for (auto it = range.first; it != range.second; ++it)
+		{
+			if (!it->isRemoved)
+				f(*it);
+		}
+		for (auto& interval : m_pendingIntervals)
+		{
+			if (interval.start == addr)
+				f(interval);
+		}
+	}
+
+	size_t Size() const
+	{
+		return m_intervals.size() - m_removedCount + m_pendingIntervals.size();
+	}
+
+private:
+	struct IntervalStartCompare
+	{
+		bool operator()(const Interval& a, const Interval& b) const { return a.start < b.start; }
+		bool operator()(const Interval& interval, TAddr addr) const { return interval.start < addr; }
+		bool operator()(TAddr addr, const Interval& interval) const { return addr < interval.start; }
+	};
+
+	size_t GetPendingLimit() const
+	{
+		// merging costs O(n), this keeps the amortized cost of an insert and the linear scan in queries at O(sqrt(n))
+		size_t limit = 32;
+		while (limit * limit < m_intervals.size())
+			limit *= 2;
+		return limit;
+	}
+
+	void Rebuild()
+	{
+		if (m_removedCount != 0)
+			std::erase_if(m_intervals, [](const Interval& interval) { return interval.isRemoved; });
+		m_removedCount = 0;
+		// the merge is stable, so intervals with the same start stay in insertion order
+		std::stable_sort(m_pendingIntervals.begin(), m_pendingIntervals.end(), IntervalStartCompare{});
+		size_t mergeOffset = m_intervals.size();
+		m_intervals.insert(m_intervals.end(), m_pendingIntervals.begin(), m_pendingIntervals.end());
+		std::inplace_merge(m_intervals.begin(), m_intervals.begin() + mergeOffset, m_intervals.end(), IntervalStartCompare{});
+		m_pendingIntervals.clear();
+		BuildIndex();
+	}
+
+	void BuildIndex()
+	{
+		// nodes at level k have the lowest k bits set and bit k cleared. Nodes whose right subtree is partially out of range inherit the max end of the last valid node
+		const sint64 count = (sint64)m_intervals.size();
+		sint64 lastIndex = 0;
+		TAddr lastMaxEnd{};
+		for (sint64 i = 0; i < count; i += 2)
+		{
+			lastIndex = i;
+			lastMaxEnd = m_intervals[i].subtreeMaxEnd = m_intervals[i].end;
+		}
+		sint32 level;
+		for (level = 1; ((sint64)1 << level) <= count; level++)
+		{
+			const sint64 childOffset = (sint64)1 << (level - 1);
+			for (sint64 i = (childOffset << 1) - 1; i < count; i += childOffset << 2)
+			{
+				TAddr maxEnd = std::max(m_intervals[i].end, m_intervals[i - childOffset].subtreeMaxEnd);
+				maxEnd = std::max(maxEnd, (i + childOffset) < count ? m_intervals[i + childOffset].subtreeMaxEnd : lastMaxEnd);
+				m_intervals[i].subtreeMaxEnd = maxEnd;
+			}
+			lastIndex = ((lastIndex >> level) & 1) ? (lastIndex - childOffset) : (lastIndex + childOffset);
+			if (lastIndex < count)
+				lastMaxEnd = std::max(lastMaxEnd, m_intervals[lastIndex].subtreeMaxEnd);
+		}
+		m_rootLevel = level - 1;
+	}
+
+	std::vector<Interval> m_intervals; // sorted by start and indexed
+	std::vector<Interval> m_pendingIntervals; // inserted since the last rebuild, in insertion order
+	size_t m_removedCount{0}; // flagged intervals in m_intervals
+	sint32 m_rootLevel{0};
+};
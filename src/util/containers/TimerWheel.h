@@ -0,0 +1,286 @@
+#pragma once
+
+// hierarchical timer wheel (Varghese & Lauck)
+// entries are intrusive, insertion and removal are O(1) and finding the next deadline only scans the per-level occupancy masks
+// due entries are expired one slot at a time
+// deadlines are rounded up to the wheel resolution of 2^TResolutionShift ticks, so an entry never expires early
+
+class TimerWheelEntry
+{
+	template<uint32 TResolutionShift>
+	friend class TimerWheel;
+public:
+	uint64 GetDeadline() const
+	{
+		return m_deadline;
+	}
+
+	bool IsQueued() const
+	{
+		return m_level != kNotQueued;
+	}
+
+private:
+	static constexpr uint8 kNotQueued = 0xFF;
+
+	TimerWheelEntry* m_prev{};
+	TimerWheelEntry* m_next{};
+	uint64 m_deadline{};
+	uint8 m_level{kNotQueued};
+	uint8 m_slot{};
+};
+
+template<uint32 TResolutionShift>
+class TimerWheel
+{
+	static constexpr uint32 kLevelBits = 8;
+	static constexpr uint32 kSlotsPerLevel = 1u << kLevelBits;
+	static constexpr uint32 kLevelCount = 5; // wheel covers 2^40 slots, entries beyond that are kept in the overflow list
+	static constexpr uint8 kLevelOverflow = kLevelCount;
+	static constexpr uint8 kLevelExpired = kLevelCount + 1;
+
+public:
+	TimerWheel() = default;
+	TimerWheel(const TimerWheel&) = delete;
+	TimerWheel& operator=(const TimerWheel&) = delete;
+
+	void Insert(TimerWheelEntry* entry, uint64 deadline)
+	{
+		cemu_assert_debug(!entry->IsQueued());
+		entry->m_deadline = deadline;
+		Enqueue(entry);
+		m_count++;
+	}
+
+	void Remove(TimerWheelEntry* entry)
+	{
+		cemu_assert_debug(entry->IsQueued());
+		Unlink(entry);
+		m_count--;
+	}
+
+	// returns an entry with a deadline at or before currentTick and removes it from the wheel, or nullptr if none is due
+	// entries are returned in order of their deadline. Only the earliest due slot is expired at a time, so this never scans more than a single slot
+	TimerWheelEntry* PopExpired(uint64 currentTick)
+	{
+		if (!m_expired)
+			ExpireNextSlot(currentTick >> TResolutionShift);
+		TimerWheelEntry* earliest = m_expired;
+		if (!earliest)
+			return nullptr;
+		for (TimerWheelEntry* itr = earliest->m_next; itr; itr = itr->m_next)
+		{
+			if (itr->m_deadline < earliest->m_deadline || (itr->m_deadline == earliest->m_deadline && (uintptr_t)itr < (uintptr_t)earliest))
+				earliest = itr;
+		}
+		Remove(earliest);
+		return earliest;
+	}
+
+	// returns the earliest tick at which PopExpired() can return an entry
+	// for entries on the lowest level this is their deadline rounded up to the wheel resolution (at or after the deadline)
+	// entries on higher levels are not cascaded yet, for them the start of their slot is returned which is at or before the deadline
+	uint64 GetNextDeadline() const
+	{
+		if (m_expired)
+			return 0;
+		uint8 level;
+		uint64 nextSlot = FindNextSlot(level);
+		if (nextSlot == std::numeric_limits<uint64>::max())
+			return std::numeric_limits<uint64>::max();
+		return nextSlot << TResolutionShift;
+	}
+
+	size_t Size() const
+	{
+		return m_count;
+	}
+
+	bool IsEmpty() const
+	{
+		return m_count == 0;
+	}
+
+	void Clear()
+	{
+		for (auto& level : m_levels)
+		{
+			for (auto& slot : level.slots)
+				slot = ClearList(slot);
+			std::fill(std::begin(level.occupancyMask), std::end(level.occupancyMask), 0);
+		}
+		m_overflow = ClearList(m_overflow);
+		m_expired = ClearList(m_expired);
+		m_currentSlot = 0;
+		m_count = 0;
+	}
+
+private:
+	struct Level
+	{
+		TimerWheelEntry* slots[kSlotsPerLevel]{};
+		uint64 occupancyMask[kSlotsPerLevel / 64]{};
+	};
+
+	static uint64 GetDeadlineSlot(uint64 deadline)
+	{
+		constexpr uint64 resolutionMask = (1ull << TResolutionShift) - 1;
+		return (deadline >> TResolutionShift) + ((deadline & resolutionMask) != 0 ? 1 : 0);
+	}
+
+	// returns index of first occupied slot with an index greater than startIndex or -1 if there is none
+	static sint32 FindOccupiedSlot(const Level& level, uint32 startIndex)
+	{
+		uint32 index = startIndex + 1;
+		while (index < kSlotsPerLevel)
+		{
+			uint64 mask = level.occupancyMask[index / 64] >> (index & 63);
+			if (mask != 0)
+				return (sint32)(index + std::countr_zero(mask));
+			index = (index & ~63u) + 64;
+		}
+		return -1;
+	}
+
+	// all entries on a level L share the digits above L with m_currentSlot and have a strictly larger digit L
+	// thus the first occupied slot on the lowest non-empty level holds the earliest entries
+	uint64 FindNextSlot(uint8& levelOut) const
+	{
+		for (uint32 level = 0; level < kLevelCount; level++)
+		{
+			uint32 shift = level * kLevelBits;
+			uint32 currentIndex = (uint32)(m_currentSlot >> shift) & (kSlotsPerLevel - 1);
+			sint32 slotIndex = FindOccupiedSlot(m_levels[level], currentIndex);
+			if (slotIndex < 0)
+				continue;
+			levelOut = (uint8)level;
+			uint64 baseSlot = m_currentSlot & ~((1ull << (shift + kLevelBits)) - 1);
+			return baseSlot | ((uint64)slotIndex << shift);
+		}
+		if (!m_overflow)
+			return std::numeric_limits<uint64>::max();
+		// overflow entries are rare, a linear scan is fine here
+		constexpr uint32 overflowShift = kLevelCount * kLevelBits;
+		uint64 nextSlot = std::numeric_limits<uint64>::max();
+		for (TimerWheelEntry* itr = m_overflow; itr; itr = itr->m_next)
+			nextSlot = std::min(nextSlot, (GetDeadlineSlot(itr->m_deadline) >> overflowShift) << overflowShift);
+		levelOut = kLevelOverflow;
+		return nextSlot;
+	}
+
+	// move the cursor forward to the next occupied slot up to targetSlot, cascading higher levels down
+	// stops as soon as there are expired entries or when no slot up to targetSlot is occupied
+	void ExpireNextSlot(uint64 targetSlot)
+	{
+		while (!m_expired)
+		{
+			uint8 level;
+			uint64 nextSlot = FindNextSlot(level);
+			if (nextSlot > targetSlot)
+			{
+				// no entry is due yet. Entries stay valid when moving the cursor forward as long as we don't pass the next occupied slot
+				if (targetSlot > m_currentSlot)
+					m_currentSlot = targetSlot;
+				return;
+			}
+			m_currentSlot = nextSlot;
+			TimerWheelEntry* entryList;
+			if (level == kLevelOverflow)
+			{
+				entryList = m_overflow;
+				m_overflow = nullptr;
+			}
+			else
+			{
+				uint32 slotIndex = (uint32)(nextSlot >> (level * kLevelBits)) & (kSlotsPerLevel - 1);
+				entryList = m_levels[level].slots[slotIndex];
+				m_levels[level].slots[slotIndex] = nullptr;
+				m_levels[level].occupancyMask[slotIndex / 64] &= ~(1ull << (slotIndex & 63));
+			}
+			// cascade entries down. Level 0 entries are always due at this point and end up in the expired list
+			while (entryList)
+			{
+				TimerWheelEntry* entry = entryList;
+				entryList = entry->m_next;
+				Enqueue(entry);
+			}
+		}
+	}
+
+	void Enqueue(TimerWheelEntry* entry)
+	{
+		uint64 deadlineSlot = GetDeadlineSlot(entry->m_deadline);
+		if (deadlineSlot <= m_currentSlot)
+		{
+			entry->m_level = kLevelExpired;
+			PushFront(m_expired, entry);
+			return;
+		}
+		uint32 level = (63 - std::countl_zero(deadlineSlot ^ m_currentSlot)) / kLevelBits;
+		if (level >= kLevelCount)
+		{
+			entry->m_level = kLevelOverflow;
+			PushFront(m_overflow, entry);
+			return;
+		}
+		uint32 slotIndex = (uint32)(deadlineSlot >> (level * kLevelBits)) & (kSlotsPerLevel - 1);
+		entry->m_level = (uint8)level;
+		entry->m_slot = (uint8)slotIndex;
+		PushFront(m_levels[level].slots[slotIndex], entry);
+		m_levels[level].occupancyMask[slotIndex / 64] |= (1ull << (slotIndex & 63));
+	}
+
+	void Unlink(TimerWheelEntry* entry)
+	{
+		TimerWheelEntry*& head = GetListHead(entry);
+		if (entry->m_prev)
+			entry->m_prev->m_next = entry->m_next;
+		else
+			head = entry->m_next;
+		if (entry->m_next)
+			entry->m_next->m_prev = entry->m_prev;
+		if (!head && entry->m_level < kLevelCount)
+			m_levels[entry->m_level].occupancyMask[entry->m_slot / 64] &= ~(1ull << (entry->m_slot & 63));
+		entry->m_prev = nullptr;
+		entry->m_next = nullptr;
+		entry->m_level = TimerWheelEntry::kNotQueued;
+	}
+
+	TimerWheelEntry*& GetListHead(TimerWheelEntry* entry)
+	{
+		if (entry->m_level == kLevelExpired)
+			return m_expired;
+		if (entry->m_level == kLevelOverflow)
+			return m_overflow;
+		cemu_assert_debug(entry->m_level < kLevelCount);
+		return m_levels[entry->m_level].slots[entry->m_slot];
+	}
+
+	static void PushFront(TimerWheelEntry*& head, TimerWheelEntry* entry)
+	{
+		entry->m_prev = nullptr;
+		entry->m_next = head;
+		if (head)
+			head->m_prev = entry;
+		head = entry;
+	}
+
+	static TimerWheelEntry* ClearList(TimerWheelEntry* head)
+	{
+		while (head)
+		{
+			TimerWheelEntry* next = head->m_next;
+			head->m_prev = nullptr;
+			head->m_next = nullptr;
+			head->m_level = TimerWheelEntry::kNotQueued;
+			head = next;
+		}
+		return nullptr;
+	}
+
+	Level m_levels[kLevelCount]{};
+	TimerWheelEntry* m_overflow{};
+	TimerWheelEntry* m_expired{};
+	uint64 m_currentSlot{}; // all slots up to and including this one have been processed
+	size_t m_count{};
+};
@@ -12,6 +12,10 @@
 #include "aes128.h"
 #include "Common/cpu_features.h"
 
+#if defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
 /*****************************************************************************/
 /* Defines:                                                                  */
 /*****************************************************************************/
@@ -563,6 +567,46 @@ void __soft__AES128_CBC_decrypt(uint8* output, uint8* input, uint32 length, cons
 	cemu_assert_debug(remainders == 0);
 }
 
+void __soft__AES128_CBC_decryptWithKey(uint8* output, uint8* input, uint32 length, const AES128DecryptionKey& key, const uint8* iv)
+{
+	aes128Ctx_t aesCtx;
+	memcpy(aesCtx.RoundKey, key.roundKeys, sizeof(aesCtx.RoundKey));
+
+	uint8 currentIv[KEYLEN];
+	uint8 nextIv[KEYLEN];
+	if (iv)
+		BlockCopy(currentIv, (uint8*)iv);
+	else
+		memset(currentIv, 0, sizeof(currentIv));
+
+	for (uint32 i = 0; i < length; i += KEYLEN)
+	{
+		aesCtx.state = (state_t*)output;
+		BlockCopy(output, input);
+		BlockCopy(nextIv, input);
+		InvCipher(&aesCtx);
+		XorWithIv(output, currentIv);
+		BlockCopy(currentIv, nextIv);
+		output += KEYLEN;
+		input += KEYLEN;
+	}
+	cemu_assert_debug((length % KEYLEN) == 0);
+}
+
+void AES128DecryptionKey::Expand(const uint8* key)
+{
+	aes128Ctx_t aesCtx;
+	KeyExpansion(&aesCtx, key);
+	memcpy(roundKeys, aesCtx.RoundKey, sizeof(roundKeys));
+	// the equivalent inverse cipher expects InvMixColumns to be applied to all round keys except the first and last
+	memcpy(invRoundKeys, aesCtx.RoundKey, sizeof(invRoundKeys));
+	for (sint32 i = 1; i < Nr; i++)
+	{
+		aesCtx.state = (state_t*)(invRoundKeys + i * KEYLEN);
+		InvMixColumns(&aesCtx);
+	}
+}
+
 void AES128_CBC_decrypt_buffer_depr(uint8* output, uint8* input, uint32 length, const uint8* key, const uint8* iv)
 {
 	aes128Ctx_t aesCtx;
@@ -730,29 +774,57 @@ ATTRIBUTE_AESNI void AESNI128_CBC_encrypt(const unsigned char *in,
 	}
 }
 
+// CBC decryption has no dependency between blocks, so we decrypt 8 blocks at a time to hide the latency of aesdec
 ATTRIBUTE_AESNI void AESNI128_CBC_decryptWithExpandedKey(const unsigned char *in,
 	unsigned char *out,
 	const unsigned char ivec[16],
 	unsigned long length,
-	unsigned char *key)
+	const unsigned char *key)
 {
+	const __m128i* roundKeys = (const __m128i*)key;
+	const __m128i* inBlocks = (const __m128i*)in;
+	__m128i* outBlocks = (__m128i*)out;
 	__m128i data, feedback, lastin;
 	int j;
 	if (length % 16)
 		length = length / 16 + 1;
 	else length /= 16;
 	feedback = _mm_loadu_si128((__m128i*)ivec);
-	for (unsigned long i = 0; i < length; i++)
+	unsigned long i = 0;
+	for (; (i + 8) <= length; i += 8)
+	{
+		// all input blocks are loaded before any output is written, so in-place decryption works
+		__m128i inData[8];
+		__m128i d[8];
+		for (int b = 0; b < 8; b++)
+		{
+			inData[b] = _mm_loadu_si128(inBlocks + i + b);
+			d[b] = _mm_xor_si128(inData[b], roundKeys[10]);
+		}
+		for (j = 9; j > 0; j--)
+		{
+			__m128i roundKey = roundKeys[j];
+			for (int b = 0; b < 8; b++)
+				d[b] = _mm_aesdec_si128(d[b], roundKey);
+		}
+		for (int b = 0; b < 8; b++)
+			d[b] = _mm_aesdeclast_si128(d[b], roundKeys[0]);
+		_mm_storeu_si128(outBlocks + i + 0, _mm_xor_si128(d[0], feedback));
+		for (int b = 1; b < 8; b++)
+			_mm_storeu_si128(outBlocks + i + b, _mm_xor_si128(d[b], inData[b - 1]));
+		feedback = inData[7];
+	}
+	for (; i < length; i++)
 	{
-		lastin = _mm_loadu_si128(&((__m128i*)in)[i]);
-		data = _mm_xor_si128(lastin, ((__m128i*)key)[10]);
+		lastin = _mm_loadu_si128(inBlocks + i);
+		data = _mm_xor_si128(lastin, roundKeys[10]);
 		for (j = 9; j > 0; j--)
 		{
-			data = _mm_aesdec_si128(data, ((__m128i*)key)[j]);
+			data = _mm_aesdec_si128(data, roundKeys[j]);
 		}
-		data = _mm_aesdeclast_si128(data, ((__m128i*)key)[0]);
+		data = _mm_aesdeclast_si128(data, roundKeys[0]);
 		data = _mm_xor_si128(data, feedback);
-		_mm_storeu_si128(&((__m128i*)out)[i], data);
+		_mm_storeu_si128(outBlocks + i, data);
 		feedback = lastin;
 	}
 }
@@ -772,6 +844,12 @@ ATTRIBUTE_AESNI void __aesni__AES128_CBC_decrypt(uint8* output, uint8* input, ui
 	}
 }
 
+void __aesni__AES128_CBC_decryptWithKey(uint8* output, uint8* input, uint32 length, const AES128DecryptionKey& key, const uint8* iv)
+{
+	uint8 zeroIv[16] = { 0 };
+	AESNI128_CBC_decryptWithExpandedKey(input, output, iv ? iv : zeroIv, length, key.invRoundKeys);
+}
+
 ATTRIBUTE_AESNI void __aesni__AES128_ECB_encrypt(uint8* input, const uint8* key, uint8* output)
 {
 	alignas(16) uint8 expandedKey[11 * 16];
@@ -794,8 +872,66 @@ ATTRIBUTE_AESNI void __aesni__AES128_ECB_encrypt(uint8* input, const uint8* key,
 }
 #endif
 
+#if defined(__aarch64__)
+// ARMv8 Crypto Extensions implementation, decrypts 8 blocks at a time like the AES-NI variant
+// aesd does AddRoundKey before InvShiftRows/InvSubBytes, thus the round key order is shifted by one compared to aesdec
+ATTRIBUTE_ARM_AES void ARMV8AES128_CBC_decryptWithExpandedKey(const uint8* in, uint8* out, const uint8* ivec, uint32 length, const uint8* key)
+{
+	uint8x16_t roundKeys[11];
+	for (sint32 r = 0; r < 11; r++)
+		roundKeys[r] = vld1q_u8(key + r * 16);
+	uint32 numBlocks = (length + 15) / 16;
+	uint8x16_t feedback = vld1q_u8(ivec);
+	uint32 i = 0;
+	for (; (i + 8) <= numBlocks; i += 8)
+	{
+		uint8x16_t inData[8];
+		uint8x16_t d[8];
+		for (sint32 b = 0; b < 8; b++)
+		{
+			inData[b] = vld1q_u8(in + (i + b) * 16);
+			d[b] = inData[b];
+		}
+		for (sint32 r = 10; r > 1; r--)
+		{
+			for (sint32 b = 0; b < 8; b++)
+				d[b] = vaesimcq_u8(vaesdq_u8(d[b], roundKeys[r]));
+		}
+		for (sint32 b = 0; b < 8; b++)
+			d[b] = veorq_u8(vaesdq_u8(d[b], roundKeys[1]), roundKeys[0]);
+		vst1q_u8(out + (i + 0) * 16, veorq_u8(d[0], feedback));
+		for (sint32 b = 1; b < 8; b++)
+			vst1q_u8(out + (i + b) * 16, veorq_u8(d[b], inData[b - 1]));
+		feedback = inData[7];
+	}
+	for (; i < numBlocks; i++)
+	{
+		uint8x16_t lastIn = vld1q_u8(in + i * 16);
+		uint8x16_t d = lastIn;
+		for (sint32 r = 10; r > 1; r--)
+			d = vaesimcq_u8(vaesdq_u8(d, roundKeys[r]));
+		d = veorq_u8(vaesdq_u8(d, roundKeys[1]), roundKeys[0]);
+		vst1q_u8(out + i * 16, veorq_u8(d, feedback));
+		feedback = lastIn;
+	}
+}
+
+void __armv8__AES128_CBC_decryptWithKey(uint8* output, uint8* input, uint32 length, const AES128DecryptionKey& key, const uint8* iv)
+{
+	uint8 zeroIv[16] = { 0 };
+	ARMV8AES128_CBC_decryptWithExpandedKey(input, output, iv ? iv : zeroIv, length, key.invRoundKeys);
+}
+
+void __armv8__AES128_CBC_decrypt(uint8* output, uint8* input, uint32 length, const uint8* key, const uint8* iv)
+{
+	AES128DecryptionKey expandedKey(key);
+	__armv8__AES128_CBC_decryptWithKey(output, input, length, expandedKey, iv);
+}
+#endif
+
 void(*AES128_ECB_encrypt)(uint8* input, const uint8* key, uint8* output);
 void (*AES128_CBC_decrypt)(uint8* output, uint8* input, uint32 length, const uint8* key, const uint8* iv) = nullptr;
+void (*AES128_CBC_decryptWithKey)(uint8* output, uint8* input, uint32 length, const AES128DecryptionKey& key, const uint8* iv) = nullptr;
 
 // AES128-CTR encrypt/decrypt
 void AES128CTR_transform(uint8* data, sint32 length, uint8* key, uint8* nonceIv)
@@ -842,16 +978,32 @@ void AES128_init()
 	{
 		// AES-NI implementation
 		AES128_CBC_decrypt = __aesni__AES128_CBC_decrypt;
+		AES128_CBC_decryptWithKey = __aesni__AES128_CBC_decryptWithKey;
 		AES128_ECB_encrypt = __aesni__AES128_ECB_encrypt;
 	}
 	else
 	{
 		// basic software implementation
 		AES128_CBC_decrypt = __soft__AES128_CBC_decrypt;
+		AES128_CBC_decryptWithKey = __soft__AES128_CBC_decryptWithKey;
 		AES128_ECB_encrypt = __soft__AES128_ECB_encrypt;
 	}
+	#elif defined(__aarch64__)
+	if (g_CPUFeatures.arm64.aes)
+	{
+		// ARMv8 Crypto Extensions implementation
+		AES128_CBC_decrypt = __armv8__AES128_CBC_decrypt;
+		AES128_CBC_decryptWithKey = __armv8__AES128_CBC_decryptWithKey;
+	}
+	else
+	{
+		AES128_CBC_decrypt = __soft__AES128_CBC_decrypt;
+		AES128_CBC_decryptWithKey = __soft__AES128_CBC_decryptWithKey;
+	}
+	AES128_ECB_encrypt = __soft__AES128_ECB_encrypt;
     #else
 	AES128_CBC_decrypt = __soft__AES128_CBC_decrypt;
+	AES128_CBC_decryptWithKey = __soft__AES128_CBC_decryptWithKey;
 	AES128_ECB_encrypt = __soft__AES128_ECB_encrypt;
     #endif
 }
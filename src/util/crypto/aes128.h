@@ -13,6 +13,26 @@ extern void(*AES128_CBC_decrypt)(uint8* output, uint8* input, uint32 length, con
 
 void AES128_CBC_decrypt_updateIV(uint8* output, uint8* input, uint32 length, const uint8* key, uint8* iv);
 
+// expanded key schedule for AES-128 decryption
+// callers which decrypt many buffers with the same key should keep this around instead of expanding the key on every call
+struct AES128DecryptionKey
+{
+	AES128DecryptionKey() = default;
+	explicit AES128DecryptionKey(const uint8* key)
+	{
+		Expand(key);
+	}
+
+	void Expand(const uint8* key);
+
+	alignas(16) uint8 roundKeys[11 * 16]; // regular key schedule, used by the software implementation
+	alignas(16) uint8 invRoundKeys[11 * 16]; // key schedule for the equivalent inverse cipher (InvMixColumns applied to round keys 1-9), used by AES-NI and ARMv8 Crypto Extensions
+};
+
+extern void(*AES128_CBC_decryptWithKey)(uint8* output, uint8* input, uint32 length, const AES128DecryptionKey& key, const uint8* iv);
+
 void AES128CTR_transform(uint8* data, sint32 length, uint8* key, uint8* nonceIv);
 
+bool AES128_RunSelfCheck();
+
 #endif //_AES_H_
@@ -0,0 +1,142 @@
+#include "util/crypto/aes128.h"
+
+/* AES-128-CBC self check
+ * Compares the active CBC decryption kernel (AES-NI or ARMv8 Crypto Extensions, which decrypt 8 blocks at a time) against the same kernel fed one block at a time and against the software implementation
+ * Keys, IVs, buffer lengths and alignments are random. Every block count up to 24 is covered, so all partial final batches are hit. Every length is also decrypted in-place
+ * Afterwards the throughput of all three paths is measured
+ */
+
+// software reference implementations, defined in aes128.cpp
+void __soft__AES128_CBC_decrypt(uint8* output, uint8* input, uint32 length, const uint8* key, const uint8* iv);
+void __soft__AES128_CBC_decryptWithKey(uint8* output, uint8* input, uint32 length, const AES128DecryptionKey& key, const uint8* iv);
+
+constexpr uint32 AES_CHECK_RANDOM_ITERATIONS = 2000;
+constexpr uint32 AES_CHECK_BENCHMARK_SIZE = 64 * 1024 * 1024;
+
+class AESCheckRNG
+{
+public:
+	AESCheckRNG(uint32 seed) : m_state(seed * 0x9E3779B9u + 0x6D2B79F5u) {}
+
+	uint32 Next()
+	{
+		m_state ^= m_state << 13;
+		m_state ^= m_state >> 17;
+		m_state ^= m_state << 5;
+		return m_state;
+	}
+
+	uint32 Range(uint32 minValue, uint32 maxValue)
+	{
+		return minValue + Next() % (maxValue - minValue + 1);
+	}
+
+	void Fill(uint8* data, size_t size)
+	{
+		for (size_t i = 0; i < size; i++)
+			data[i] = (uint8)Next();
+	}
+
+private:
+	uint32 m_state;
+};
+
+// decrypts one block per call so the kernels only ever run their single block loop
+static void AESCheck_decryptSingleBlocks(uint8* output, uint8* input, uint32 length, const AES128DecryptionKey& key, const uint8* iv)
+{
+	uint8 currentIv[16];
+	memcpy(currentIv, iv, 16);
+	for (uint32 i = 0; i < length; i += 16)
+	{
+		uint8 nextIv[16];
+		memcpy(nextIv, input + i, 16);
+		AES128_CBC_decryptWithKey(output + i, input + i, 16, key, currentIv);
+		memcpy(currentIv, nextIv, 16);
+	}
+}
+
+// returns false and prints the case if the outputs of any path differ
+static bool AESCheck_runCase(AESCheckRNG& rng, uint32 blockCount)
+{
+	const uint32 length = blockCount * 16;
+	const uint32 misalignment = rng.Range(0, 15);
+	uint8 key[16];
+	uint8 iv[16];
+	rng.Fill(key, sizeof(key));
+	rng.Fill(iv, sizeof(iv));
+	std::vector<uint8> inputStorage(length + 16);
+	uint8* input = inputStorage.data() + misalignment;
+	rng.Fill(input, length);
+	AES128DecryptionKey expandedKey(key);
+
+	std::vector<uint8> reference(length);
+	__soft__AES128_CBC_decrypt(reference.data(), input, length, key, iv);
+
+	std::vector<uint8> softWithKey(length);
+	__soft__AES128_CBC_decryptWithKey(softWithKey.data(), input, length, expandedKey, iv);
+	std::vector<uint8> pipelined(length);
+	AES128_CBC_decryptWithKey(pipelined.data(), input, length, expandedKey, iv);
+	std::vector<uint8> pipelinedRawKey(length);
+	AES128_CBC_decrypt(pipelinedRawKey.data(), input, length, key, iv);
+	std::vector<uint8> singleBlock(length);
+	AESCheck_decryptSingleBlocks(singleBlock.data(), input, length, expandedKey, iv);
+	std::vector<uint8> inPlaceStorage(inputStorage);
+	uint8* inPlace = inPlaceStorage.data() + misalignment;
+	AES128_CBC_decryptWithKey(inPlace, inPlace, length, expandedKey, iv);
+
+	const char* failedPath = nullptr;
+	if (softWithKey != reference)
+		failedPath = "software (expanded key)";
+	else if (pipelined != reference)
+		failedPath = "pipelined";
+	else if (pipelinedRawKey != reference)
+		failedPath = "pipelined (raw key)";
+	else if (singleBlock != reference)
+		failedPath = "single block";
+	else if (memcmp(inPlace, reference.data(), length) != 0)
+		failedPath = "pipelined in-place";
+	if (!failedPath)
+		return true;
+	fmt::print("MISMATCH: {} path, {} blocks, input misaligned by {}\n", failedPath, blockCount, misalignment);
+	return false;
+}
+
+static double AESCheck_measureThroughput(void(*decryptFunc)(uint8* output, uint8* input, uint32 length, const AES128DecryptionKey& key, const uint8* iv), std::vector<uint8>& buffer, const AES128DecryptionKey& key, const uint8* iv)
+{
+	// decrypt in 64KiB chunks, about the size the FST code passes in
+	constexpr uint32 CHUNK_SIZE = 0x10000;
+	auto startTime = std::chrono::steady_clock::now();
+	for (size_t offset = 0; offset < buffer.size(); offset += CHUNK_SIZE)
+		decryptFunc(buffer.data() + offset, buffer.data() + offset, CHUNK_SIZE, key, iv);
+	double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+	return (double)buffer.size() / (1024.0 * 1024.0) / seconds;
+}
+
+bool AES128_RunSelfCheck()
+{
+	AES128_init();
+	AESCheckRNG rng(1);
+	uint32 caseCount = 0;
+	uint32 failedCount = 0;
+	// every partial final batch, with multiple keys each
+	for (uint32 blockCount = 1; blockCount <= 24; blockCount++)
+	{
+		for (uint32 i = 0; i < 16; i++, caseCount++)
+			failedCount += AESCheck_runCase(rng, blockCount) ? 0 : 1;
+	}
+	for (uint32 i = 0; i < AES_CHECK_RANDOM_ITERATIONS; i++, caseCount++)
+		failedCount += AESCheck_runCase(rng, rng.Range(1, 4096)) ? 0 : 1;
+	fmt::print("AES-128-CBC self check: {} of {} cases passed\n", caseCount - failedCount, caseCount);
+
+	uint8 key[16];
+	uint8 iv[16];
+	rng.Fill(key, sizeof(key));
+	rng.Fill(iv, sizeof(iv));
+	AES128DecryptionKey expandedKey(key);
+	std::vector<uint8> buffer(AES_CHECK_BENCHMARK_SIZE);
+	rng.Fill(buffer.data(), buffer.size());
+	fmt::print("{:<14} {:10.1f} MiB/s\n", "software", AESCheck_measureThroughput(__soft__AES128_CBC_decryptWithKey, buffer, expandedKey, iv));
+	fmt::print("{:<14} {:10.1f} MiB/s\n", "single block", AESCheck_measureThroughput(AESCheck_decryptSingleBlocks, buffer, expandedKey, iv));
+	fmt::print("{:<14} {:10.1f} MiB/s\n", "pipelined", AESCheck_measureThroughput(AES128_CBC_decryptWithKey, buffer, expandedKey, iv));
+	return failedCount == 0;
+}
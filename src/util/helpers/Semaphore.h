@@ -112,6 +112,24 @@ public:
 			m_condition.wait(lock);
 	}
 
+	// may wake up spuriously
+	void waitUntilNonZeroWithTimeout(std::chrono::nanoseconds timeout)
+	{
+		std::unique_lock lock(m_mutex);
+		if (m_count == 0 && !m_wakeupPending)
+			m_condition.wait_for(lock, timeout);
+		m_wakeupPending = false;
+	}
+
+	// wakes up a waitUntilNonZeroWithTimeout() call without changing the count
+	// if no thread is waiting then the next wait returns immediately
+	void wakeup()
+	{
+		std::lock_guard lock(m_mutex);
+		m_wakeupPending = true;
+		m_condition.notify_all();
+	}
+
 	bool isZero() const
 	{
 		return m_count == 0;
@@ -121,6 +139,7 @@ private:
 	std::mutex m_mutex;
 	std::condition_variable m_condition;
 	sint64 m_count = 0;
+	bool m_wakeupPending = false;
 };
 
 template<typename T>
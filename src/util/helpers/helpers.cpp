@@ -6,6 +6,7 @@
 #include <random>
 
 #include "config/ActiveSettings.h"
+#include "util/TraceRecorder/TraceRecorder.h"
 
 #include <boost/random/uniform_int.hpp>
 
@@ -115,6 +116,7 @@ typedef struct tagTHREADNAME_INFO
 
 void SetThreadName(const char* name)
 {
+	TraceRecorder::SetCurrentThreadName(name);
 #if BOOST_OS_WINDOWS
 	using SetThreadDescription_t = HRESULT (*)(HANDLE hThread, PCWSTR lpThreadDescription);
 	static SetThreadDescription_t pSetThreadDescription = nullptr;